@@ -16,15 +16,21 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <absl/strings/str_cat.h>
 #include <benchmark/benchmark.h>
 
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/message.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "src/benchmarks/proto/benchmark.pb.h"
+#include "src/common/base/base.h"
 #include "src/common/grpcutils/service_descriptor_database.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/row_batch.h"
 
 const size_t kRangeMultiplier = 10;
 const size_t kRangeBegin = 1'000;
@@ -35,6 +41,12 @@ using ::google::protobuf::Message;
 using ::px::benchmarks::ChargeRequest;
 using ::px::grpc::MethodInputOutput;
 using ::px::grpc::ServiceDescriptorDatabase;
+using ::px::table_store::schema::RowBatch;
+using ::px::table_store::schema::RowDescriptor;
+using ::px::types::DataType;
+
+// The encodings a row batch can be transferred between agents with.
+enum RowBatchEncoding : int64_t { kRowBatchData = 0, kColumnar = 1, kColumnarCompressed = 2 };
 
 static ChargeRequest SampleChargeRequest() {
   ChargeRequest r;
@@ -48,6 +60,88 @@ static ChargeRequest SampleChargeRequest() {
   return r;
 }
 
+// A batch shaped like the http_events rows sent from PEMs to Kelvin: increasing timestamps, a
+// few distinct low-cardinality strings and a longer high-cardinality string.
+static std::unique_ptr<RowBatch> SampleRowBatch(int64_t num_rows) {
+  std::vector<px::types::Time64NSValue> times(num_rows);
+  std::vector<px::types::Int64Value> latencies(num_rows);
+  std::vector<px::types::Float64Value> ratios(num_rows);
+  std::vector<px::types::StringValue> methods(num_rows);
+  std::vector<px::types::StringValue> paths(num_rows);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times[i] = 1'600'000'000'000'000'000 + i * 1'000;
+    latencies[i] = (i * 7919) % 100'000;
+    ratios[i] = i / 3.0;
+    methods[i] = (i % 4 == 0) ? "POST" : "GET";
+    paths[i] = absl::StrCat("/api/v1/items/", i);
+  }
+  auto rb = std::make_unique<RowBatch>(
+      RowDescriptor({DataType::TIME64NS, DataType::INT64, DataType::FLOAT64, DataType::STRING,
+                     DataType::STRING}),
+      num_rows);
+  auto pool = arrow::default_memory_pool();
+  PL_CHECK_OK(rb->AddColumn(px::types::ToArrow(times, pool)));
+  PL_CHECK_OK(rb->AddColumn(px::types::ToArrow(latencies, pool)));
+  PL_CHECK_OK(rb->AddColumn(px::types::ToArrow(ratios, pool)));
+  PL_CHECK_OK(rb->AddColumn(px::types::ToArrow(methods, pool)));
+  PL_CHECK_OK(rb->AddColumn(px::types::ToArrow(paths, pool)));
+  return rb;
+}
+
+static std::string SerializeRowBatch(const RowBatch& rb, int64_t encoding) {
+  if (encoding == kRowBatchData) {
+    px::table_store::schemapb::RowBatchData proto;
+    PL_CHECK_OK(rb.ToProto(&proto));
+    return proto.SerializeAsString();
+  }
+  RowBatch::ColumnarEncodingOptions opts;
+  opts.compress = encoding == kColumnarCompressed;
+  px::table_store::schemapb::ColumnarRowBatchData proto;
+  PL_CHECK_OK(rb.ToColumnarProto(opts, &proto));
+  return proto.SerializeAsString();
+}
+
+static void RowBatchEncodingArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t num_rows : {1'024, 16'384}) {
+    for (int64_t encoding : {kRowBatchData, kColumnar, kColumnarCompressed}) {
+      b->Args({num_rows, encoding});
+    }
+  }
+}
+
+// Args: number of rows, RowBatchEncoding.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_row_batch_encode(benchmark::State& state) {
+  auto rb = SampleRowBatch(state.range(0));
+  size_t wire_bytes = 0;
+  for (auto _ : state) {
+    wire_bytes = SerializeRowBatch(*rb, state.range(1)).size();
+    benchmark::DoNotOptimize(wire_bytes);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["wire_bytes"] = wire_bytes;
+}
+
+// Args: number of rows, RowBatchEncoding.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_row_batch_decode(benchmark::State& state) {
+  auto rb = SampleRowBatch(state.range(0));
+  const std::string serialized = SerializeRowBatch(*rb, state.range(1));
+  for (auto _ : state) {
+    if (state.range(1) == kRowBatchData) {
+      px::table_store::schemapb::RowBatchData proto;
+      proto.ParseFromString(serialized);
+      benchmark::DoNotOptimize(RowBatch::FromProto(proto).ConsumeValueOrDie());
+    } else {
+      px::table_store::schemapb::ColumnarRowBatchData proto;
+      proto.ParseFromString(serialized);
+      benchmark::DoNotOptimize(RowBatch::FromColumnarProto(proto).ConsumeValueOrDie());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["wire_bytes"] = serialized.size();
+}
+
 // NOLINTNEXTLINE : runtime/references.
 static void BM_dynamic_message_parsing(benchmark::State& state) {
   const ChargeRequest sample_charge_req = SampleChargeRequest();
@@ -87,3 +181,6 @@ BENCHMARK(BM_dynamic_message_parsing)
 BENCHMARK(BM_compiled_message_parsing)
     ->RangeMultiplier(kRangeMultiplier)
     ->Range(kRangeBegin, kRangeEnd);
+
+BENCHMARK(BM_row_batch_encode)->Apply(RowBatchEncodingArgs);
+BENCHMARK(BM_row_batch_decode)->Apply(RowBatchEncodingArgs);
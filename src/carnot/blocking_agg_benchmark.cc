@@ -20,15 +20,21 @@
 #include <google/protobuf/text_format.h>
 
 #include <algorithm>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <sole.hpp>
 
 #include "src/carnot/carnot.h"
+#include "src/carnot/exec/agg_node.h"
 #include "src/carnot/exec/local_grpc_result_server.h"
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/funcs/funcs.h"
+#include "src/carnot/plan/operators.h"
+#include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/udf.h"
 #include "src/common/base/base.h"
 #include "src/common/benchmark/benchmark.h"
@@ -42,6 +48,7 @@ namespace carnot {
 namespace exec {
 
 using table_store::Table;
+using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
 constexpr char kGroupByNoneQuery[] = R"pxl(
@@ -65,6 +72,59 @@ df = df.groupby(['col0', 'col1']).agg(sum=('col2', px.sum))
 px.display(df, '$0')
 )pxl";
 
+constexpr char kGroupByOneAggOperator[] = R"proto(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "sum"
+    id: 0
+    args {
+      column {
+        node: 0
+        index: 1
+      }
+    }
+    args_data_types: INT64
+  }
+  groups {
+    node: 0
+    index: 0
+  }
+  group_names: "col0"
+  value_names: "sum"
+}
+)proto";
+
+constexpr char kGroupByTwoAggOperator[] = R"proto(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: false
+  values {
+    name: "sum"
+    id: 0
+    args {
+      column {
+        node: 0
+        index: 2
+      }
+    }
+    args_data_types: INT64
+  }
+  groups {
+    node: 0
+    index: 0
+  }
+  groups {
+    node: 0
+    index: 1
+  }
+  group_names: "col0"
+  group_names: "col1"
+  value_names: "sum"
+}
+)proto";
+
 std::unique_ptr<Carnot> SetUpCarnot(std::shared_ptr<table_store::TableStore> table_store,
                                     LocalGRPCResultSinkServer* server) {
   auto func_registry = std::make_unique<px::carnot::udf::Registry>("default_registry");
@@ -130,6 +190,131 @@ void BM_Query_Int(benchmark::State& state, std::vector<types::DataType> types,
   BM_Query(state, types, distribution_types, query, num_batches, default_params, default_params);
 }
 
+constexpr int64_t kRowsPerBatch = 8192;
+
+// Enough batches for every group to show up about twice, so that both inserts and lookups are
+// measured when there are millions of groups.
+int64_t NumBatchesForGroups(int64_t num_groups) {
+  constexpr int64_t kMinNumBatches = 64;
+  return std::max(kMinNumBatches, 2 * num_groups / kRowsPerBatch);
+}
+
+// Runs the aggregate operator directly on an AggNode over the given batches.
+// NOLINTNEXTLINE : runtime/references.
+void RunAggNode(benchmark::State& state, const char* agg_operator, int32_t num_threads,
+                const RowDescriptor& input_rd, const RowDescriptor& output_rd,
+                const std::vector<RowBatch>& batches) {
+  auto func_registry = std::make_unique<udf::Registry>("default_registry");
+  funcs::RegisterFuncsOrDie(func_registry.get());
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry.get(), std::make_shared<table_store::TableStore>(),
+      MockResultSinkStubGenerator, MockMetricsStubGenerator, MockTraceStubGenerator,
+      sole::uuid4(), nullptr);
+  PL_CHECK_OK(exec_state->AddUDA(0, "sum", {types::DataType::INT64}));
+  exec_state->set_num_exec_threads(num_threads);
+  // The AggNode runs on the worker pool that the execution graph would own.
+  std::unique_ptr<MorselWorkerPool> pool;
+  if (num_threads > 1) {
+    pool = std::make_unique<MorselWorkerPool>(num_threads);
+    exec_state->set_morsel_pool(pool.get());
+  }
+
+  planpb::Operator op_pb;
+  CHECK(google::protobuf::TextFormat::MergeFromString(agg_operator, &op_pb));
+  auto plan_node = plan::AggregateOperator::FromProto(op_pb, 1);
+
+  int64_t num_rows = 0;
+  for (const auto& rb : batches) {
+    num_rows += rb.num_rows();
+  }
+  for (auto _ : state) {
+    AggNode node;
+    PL_CHECK_OK(node.Init(*plan_node, output_rd, {input_rd}));
+    PL_CHECK_OK(node.Prepare(exec_state.get()));
+    PL_CHECK_OK(node.Open(exec_state.get()));
+    for (const auto& rb : batches) {
+      PL_CHECK_OK(node.ConsumeNext(exec_state.get(), rb, 0));
+    }
+    PL_CHECK_OK(node.Close(exec_state.get()));
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+}
+
+// Runs a blocking group by aggregate directly on an AggNode, so that the number of execution
+// threads can be varied. Range 0 is the number of distinct groups, range 1 the number of threads.
+// NOLINTNEXTLINE : runtime/references.
+void BM_GroupByOneThreads(benchmark::State& state) {
+  int64_t num_groups = state.range(0);
+  auto num_threads = static_cast<int32_t>(state.range(1));
+  int64_t num_batches = NumBatchesForGroups(num_groups);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> group_dist(0, num_groups - 1);
+  std::vector<RowBatch> batches;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    std::vector<types::Int64Value> groups(kRowsPerBatch);
+    std::vector<types::Int64Value> values(kRowsPerBatch);
+    for (int64_t row_idx = 0; row_idx < kRowsPerBatch; ++row_idx) {
+      groups[row_idx] = group_dist(gen);
+      values[row_idx] = row_idx;
+    }
+    bool last = i == num_batches - 1;
+    batches.push_back(RowBatchBuilder(input_rd, kRowsPerBatch, /*eow*/ last, /*eos*/ last)
+                          .AddColumn<types::Int64Value>(groups)
+                          .AddColumn<types::Int64Value>(values)
+                          .get());
+  }
+
+  RunAggNode(state, kGroupByOneAggOperator, num_threads, input_rd, output_rd, batches);
+}
+
+void GroupByOneThreadsArgs(benchmark::internal::Benchmark* b) {
+  for (int64_t num_groups : {1 << 4, 1 << 8, 1 << 12, 1 << 16, 1 << 20, 1 << 22}) {
+    for (int64_t num_threads : {1, 2, 4, 8}) {
+      b->Args({num_groups, num_threads});
+    }
+  }
+}
+
+// Group by a (string, int64) key on a single thread, the shape of most pod/service aggregates.
+// Range 0 is the number of distinct groups.
+// NOLINTNEXTLINE : runtime/references.
+void BM_GroupByStringInt(benchmark::State& state) {
+  // Each string is shared by this many groups, which differ by their int.
+  constexpr int64_t kGroupsPerString = 16;
+  int64_t num_groups = state.range(0);
+  int64_t num_batches = NumBatchesForGroups(num_groups);
+  RowDescriptor input_rd(
+      {types::DataType::STRING, types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd(
+      {types::DataType::STRING, types::DataType::INT64, types::DataType::INT64});
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> group_dist(0, num_groups - 1);
+  std::vector<RowBatch> batches;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    std::vector<types::StringValue> names(kRowsPerBatch);
+    std::vector<types::Int64Value> ids(kRowsPerBatch);
+    std::vector<types::Int64Value> values(kRowsPerBatch);
+    for (int64_t row_idx = 0; row_idx < kRowsPerBatch; ++row_idx) {
+      int64_t group = group_dist(gen);
+      names[row_idx] = absl::StrCat("pl/service-", group / kGroupsPerString);
+      ids[row_idx] = group % kGroupsPerString;
+      values[row_idx] = row_idx;
+    }
+    bool last = i == num_batches - 1;
+    batches.push_back(RowBatchBuilder(input_rd, kRowsPerBatch, /*eow*/ last, /*eos*/ last)
+                          .AddColumn<types::StringValue>(names)
+                          .AddColumn<types::Int64Value>(ids)
+                          .AddColumn<types::Int64Value>(values)
+                          .get());
+  }
+
+  RunAggNode(state, kGroupByTwoAggOperator, /*num_threads*/ 1, input_rd, output_rd, batches);
+}
+
 const std::unique_ptr<const datagen::DistributionParams> sample_selection_params =
     std::make_unique<const datagen::ZipfianParams>(2, 2, 999);
 const std::unique_ptr<const datagen::DistributionParams> sample_length_params =
@@ -198,6 +383,18 @@ BENCHMARK_CAPTURE(BM_Query_Int, eval_group_by_one_exponential_int,
     ->RangeMultiplier(2)
     ->Range(1, 1 << 16);
 
+BENCHMARK(BM_GroupByOneThreads)
+    ->Apply(GroupByOneThreadsArgs)
+    ->ArgNames({"groups", "threads"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_GroupByStringInt)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 22)
+    ->ArgName("groups")
+    ->Unit(benchmark::kMillisecond);
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
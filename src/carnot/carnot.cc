@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -170,6 +171,7 @@ Status CarnotImpl::RegisterUDFsInPlanFragment(exec::ExecState* exec_state, plan:
         return WalkExpression(exec_state, *filter.expression());
       })
       .OnLimit(no_op)
+      .OnTopK(no_op)
       .OnMemorySink(no_op)
       .OnMemorySource(no_op)
       .OnUnion(no_op)
@@ -340,6 +342,11 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
 
   PL_RETURN_IF_ERROR(RegisterUDFs(exec_state.get(), &plan));
 
+  table_store::schema::RowBatch::ColumnarEncodingOptions columnar_opts;
+  columnar_opts.compress = logical_plan.plan_options().compress_transfer();
+  exec_state->set_columnar_transfer(logical_plan.plan_options().columnar_transfer(),
+                                    columnar_opts);
+
   auto plan_state = engine_state_->CreatePlanState();
   int64_t bytes_processed = 0;
   int64_t rows_processed = 0;
@@ -354,8 +361,12 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
       plan::PlanWalker()
           .OnPlanFragment([&](auto* pf) {
             auto exec_graph = exec::ExecutionGraph();
+            int32_t num_exec_threads =
+                std::max(exec::kDefaultExecThreads, logical_plan.plan_options().exec_threads());
             PL_RETURN_IF_ERROR(exec_graph.Init(schema.get(), plan_state.get(), exec_state.get(), pf,
-                                               /* collect_exec_node_stats */ analyze));
+                                               /* collect_exec_node_stats */ analyze,
+                                               exec::kDefaultConsecutiveGenerateCallsPerSource,
+                                               num_exec_threads));
             PL_RETURN_IF_ERROR(exec_graph.Execute());
 
             // We must get this while exec_graph is alive. ExecutionGraph destructor calls
@@ -21,8 +21,10 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <pypa/parser/parser.hh>
@@ -193,6 +195,32 @@ px.display(df, 'test_output'))pxl";
       types::ToArrow(col1_in2, arrow::default_memory_pool())));
 }
 
+TEST_F(CarnotTest, map_after_filter_skips_filtered_rows) {
+  // The filter drops the rows where the divisor is 0. The modulo must not be evaluated on them.
+  std::vector<types::Int64Value> res_out1 = {0, 0};
+  std::vector<types::Int64Value> res_out2 = {2, 2};
+
+  auto query = R"pxl(
+import px
+df = px.DataFrame(table='test_table', select=['col2'])
+df.divisor = df.col2 - 2
+df = df[df.divisor != 0]
+df.res = df.col2 % df.divisor
+df = df[['res']]
+px.display(df, 'test_output'))pxl";
+
+  ASSERT_OK(carnot_->ExecuteQuery(query, sole::uuid4(), 0));
+
+  EXPECT_THAT(result_server_->output_tables(), UnorderedElementsAre("test_output"));
+  auto output_batches = result_server_->query_results("test_output");
+  EXPECT_EQ(3, output_batches.size());
+
+  EXPECT_TRUE(output_batches[1].ColumnAt(0)->Equals(
+      types::ToArrow(res_out1, arrow::default_memory_pool())));
+  EXPECT_TRUE(output_batches[2].ColumnAt(0)->Equals(
+      types::ToArrow(res_out2, arrow::default_memory_pool())));
+}
+
 TEST_F(CarnotTest, range_test_multiple_rbs) {
   auto query = R"pxl(
 import px
@@ -441,6 +469,48 @@ px.display(aggDF, 'test_output'))pxl";
   EXPECT_EQ(expected, actual);
 }
 
+// Runs a filter -> map -> agg query with the source pipeline split across several threads and
+// checks it agrees with the single threaded run.
+TEST_F(CarnotTest, group_by_with_exec_threads) {
+  std::string query = R"pxl(
+import px
+queryDF = px.DataFrame(table='big_test_table', select=['time_', 'col3', 'num_groups', 'string_groups'])
+queryDF = queryDF[queryDF['col3'] > 2]
+queryDF['col3_x2'] = queryDF['col3'] * 2
+aggDF = queryDF.groupby(['num_groups', 'string_groups']).agg(sum=('col3_x2', px.sum))
+px.display(aggDF, '$0'))pxl";
+  Compiler compiler;
+  std::unique_ptr<planner::RegistryInfo> registry_info =
+      udfexporter::ExportUDFInfo().ConsumeValueOrDie();
+  planner::CompilerState compiler_state(
+      table_store_->GetRelationMap(), planner::SensitiveColumnMap{}, registry_info.get(),
+      /* time_now */ 0,
+      /* max_output_rows_per_table */ 0, "result_addr", "result_ssl_targetname",
+      planner::RedactionOptions{}, nullptr, nullptr, planner::DebugInfo{});
+  planpb::Plan plan = compiler.Compile(absl::Substitute(query, "parallel"), &compiler_state)
+                          .ConsumeValueOrDie();
+  plan.mutable_plan_options()->set_exec_threads(4);
+
+  ASSERT_OK(carnot_->ExecutePlan(plan, sole::uuid4()));
+  ASSERT_OK(carnot_->ExecuteQuery(absl::Substitute(query, "serial"), sole::uuid4(), 0));
+
+  auto sums_by_group = [this](const std::string& table_name) {
+    std::map<std::pair<int64_t, std::string>, int64_t> sums;
+    for (const auto& rb : result_server_->query_results(table_name)) {
+      auto num_grp = static_cast<arrow::Int64Array*>(rb.ColumnAt(0).get());
+      auto str_grp = static_cast<arrow::StringArray*>(rb.ColumnAt(1).get());
+      auto sum = static_cast<arrow::Int64Array*>(rb.ColumnAt(2).get());
+      for (int i = 0; i < rb.num_rows(); ++i) {
+        sums[{num_grp->Value(i), str_grp->GetString(i)}] += sum->Value(i);
+      }
+    }
+    return sums;
+  };
+  auto serial = sums_by_group("serial");
+  EXPECT_FALSE(serial.empty());
+  EXPECT_EQ(serial, sums_by_group("parallel"));
+}
+
 TEST_F(CarnotTest, string_filter) {
   std::string query = R"pxl(
 import px
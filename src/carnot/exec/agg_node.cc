@@ -23,6 +23,7 @@
 #include <arrow/status.h>
 #include <algorithm>
 #include <cstdint>
+#include <numeric>
 
 #include <magic_enum.hpp>
 
@@ -46,34 +47,16 @@ using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
 namespace {
-template <types::DataType DT>
-void ExtractIntoGroupArgs(std::vector<GroupArgs>* group_args, arrow::Array* col, int rt_col_idx) {
-  auto num_rows = col->length();
-  for (auto row_idx = 0; row_idx < num_rows; ++row_idx) {
-    ExtractIntoRowTuple<DT>((*group_args)[row_idx].rt, col, rt_col_idx, row_idx);
-  }
-}
-
-template <types::DataType DT>
-void AppendToBuilder(arrow::ArrayBuilder* builder, RowTuple* rt, size_t rt_idx) {
-  using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
-  using ValueType = typename types::DataTypeTraits<DT>::value_type;
-  auto status =
-      static_cast<ArrowBuilder*>(builder)->Append(udf::UnWrap(rt->GetValue<ValueType>(rt_idx)));
-  PL_DCHECK_OK(status);
-  PL_UNUSED(status);
-}
-
 template <types::DataType DT>
 void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
+                            const std::vector<int64_t>& row_idxs,
                             const table_store::schema::RowBatch& rb, size_t col_idx,
                             size_t rb_col_idx) {
-  size_t num_rows = rb.num_rows();
-  DCHECK(num_rows <= group_args.size());
-  for (size_t row_idx = 0; row_idx < num_rows; ++row_idx) {
+  auto arr = rb.ColumnAt(rb_col_idx).get();
+  for (auto row_idx : row_idxs) {
+    DCHECK(static_cast<size_t>(row_idx) < group_args.size());
     DCHECK(group_args[row_idx].av != nullptr);
     auto col_wrapper = group_args[row_idx].av->agg_cols[col_idx].get();
-    auto arr = rb.ColumnAt(rb_col_idx).get();
     types::ExtractValueToColumnWrapper<DT>(col_wrapper, arr, row_idx);
   }
 }
@@ -126,7 +109,9 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
   for (const auto& group : plan_node_->groups()) {
     DCHECK(group.idx < input_descriptor_->size());
     group_data_types_.emplace_back(input_descriptor_->type(group.idx));
+    group_col_idxs_.push_back(group.idx);
   }
+  group_key_encoder_ = FlatKeyEncoder(group_data_types_);
 
   auto values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
@@ -140,28 +125,65 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
 
 Status AggNode::PrepareImpl(ExecState* exec_state) {
   function_ctx_ = exec_state->CreateFunctionContext();
+  // Look up the UDA definitions once, so that new groups can be created from any thread without
+  // touching the ExecState.
+  uda_defs_.clear();
+  for (const auto& value : plan_node_->values()) {
+    uda_defs_.push_back(exec_state->GetUDADefinition(value->uda_id()));
+  }
   return Status::OK();
 }
 
 Status AggNode::OpenImpl(ExecState* exec_state) {
+  int32_t num_threads = exec_state->num_exec_threads();
+  if (num_threads > 1) {
+    worker_pool_ = exec_state->morsel_pool();
+  }
+
   if (HasNoGroups()) {
-    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
+    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_));
+    // Every worker's UDAs would start from the init arguments, so merging them would apply the
+    // init arguments more than once. Those aggregates stay on the calling thread.
+    bool has_init_args = std::any_of(plan_node_->values().begin(), plan_node_->values().end(),
+                                     [](const auto& value) {
+                                       return !value->init_arguments().empty();
+                                     });
+    if (worker_pool_ != nullptr && !has_init_args) {
+      slice_udas_no_groups_.resize(num_threads);
+      for (auto& udas : slice_udas_no_groups_) {
+        PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas));
+      }
+    }
+    return Status::OK();
+  }
+
+  size_t num_partitions = std::max(1, num_threads);
+  for (size_t i = 0; i < num_partitions; ++i) {
+    partitions_.push_back(std::make_unique<AggPartition>());
   }
   return Status::OK();
 }
 
 Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
   if (HasNoGroups()) {
+    // UDAs are updated with whole arrays, so they need the selected rows to be contiguous.
+    if (rb.HasSelection()) {
+      PL_ASSIGN_OR_RETURN(auto materialized_rb, rb.Materialize());
+      return AggregateGroupByNone(exec_state, *materialized_rb);
+    }
     return AggregateGroupByNone(exec_state, rb);
   }
   return AggregateGroupByClause(exec_state, rb);
 }
 
 Status AggNode::CloseImpl(ExecState*) {
+  // The pool belongs to the execution graph, and none of its tasks use this node's state once
+  // a call into the node has returned.
+  worker_pool_ = nullptr;
   udas_no_groups_.clear();
+  slice_udas_no_groups_.clear();
   group_args_chunk_.clear();
-  group_args_pool_.Clear();
-  udas_pool_.Clear();
+  partitions_.clear();
 
   return Status::OK();
 }
@@ -171,22 +193,35 @@ bool AggNode::ReadyToEmitBatches(const RowBatch& rb) const {
 }
 
 Status AggNode::ClearAggState(ExecState* exec_state) {
+  PL_UNUSED(exec_state);
   if (HasNoGroups()) {
     udas_no_groups_.clear();
-    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
+    PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_));
+    for (auto& udas : slice_udas_no_groups_) {
+      udas.clear();
+      PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas));
+    }
+  }
+  for (auto& partition : partitions_) {
+    partition->agg_hash_map.clear();
+    partition->keys.Clear();
   }
-  agg_hash_map_.clear();
   return Status::OK();
 }
 
 Status AggNode::AggregateGroupByNone(ExecState* exec_state, const RowBatch& rb) {
   auto values = plan_node_->values();
-  for (size_t i = 0; i < values.size(); ++i) {
-    PL_RETURN_IF_ERROR(
-        EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+  if (!slice_udas_no_groups_.empty() && rb.num_rows() >= kMinRowsForParallelAgg) {
+    PL_RETURN_IF_ERROR(EvaluateWorkerSlicesNoGroups(exec_state, rb));
+  } else {
+    for (size_t i = 0; i < values.size(); ++i) {
+      PL_RETURN_IF_ERROR(
+          EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+    }
   }
 
   if (ReadyToEmitBatches(rb)) {
+    PL_RETURN_IF_ERROR(MergeSliceUDAs());
     RowBatch output_rb(*output_descriptor_, 1);
     for (size_t i = 0; i < values.size(); ++i) {
       const auto& uda_info = udas_no_groups_[i];
@@ -206,62 +241,115 @@ Status AggNode::AggregateGroupByNone(ExecState* exec_state, const RowBatch& rb)
   return Status::OK();
 }
 
-Status AggNode::ExtractRowTupleForBatch(const RowBatch& rb) {
+Status AggNode::EvaluateWorkerSlicesNoGroups(ExecState* exec_state, const RowBatch& rb) {
+  auto values = plan_node_->values();
+  int64_t num_slices = slice_udas_no_groups_.size();
+  int64_t slice_size = (rb.num_rows() + num_slices - 1) / num_slices;
+  // Each slice updates its own UDAs, so two threads never share a UDA.
+  return worker_pool_->ParallelFor(num_slices, [&](size_t slice_idx) -> Status {
+    int64_t offset = slice_idx * slice_size;
+    int64_t length = std::min(slice_size, rb.num_rows() - offset);
+    if (length <= 0) {
+      return Status::OK();
+    }
+    RowBatch slice(*input_descriptor_, length);
+    for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+      PL_RETURN_IF_ERROR(slice.AddColumn(rb.ColumnAt(col_idx)->Slice(offset, length)));
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      PL_RETURN_IF_ERROR(EvaluateSingleExpressionNoGroups(
+          exec_state, slice_udas_no_groups_[slice_idx][i], values[i].get(), slice));
+    }
+    return Status::OK();
+  });
+}
+
+Status AggNode::MergeSliceUDAs() {
+  for (const auto& udas : slice_udas_no_groups_) {
+    DCHECK_EQ(udas.size(), udas_no_groups_.size());
+    for (size_t i = 0; i < udas.size(); ++i) {
+      const auto& uda_info = udas_no_groups_[i];
+      PL_RETURN_IF_ERROR(
+          uda_info.def->Merge(uda_info.uda.get(), udas[i].uda.get(), function_ctx_.get()));
+    }
+  }
+  return Status::OK();
+}
+
+Status AggNode::ExtractGroupKeysForBatch(const RowBatch& rb) {
   // Grow the group_args_chunk_ to be the size of the RowBatch.
   size_t num_rows = rb.num_rows();
   if (group_args_chunk_.size() < num_rows) {
-    int prev_size = group_args_chunk_.size();
-    group_args_chunk_.reserve(num_rows);
-    for (size_t idx = prev_size; idx < num_rows; ++idx) {
-      group_args_chunk_.emplace_back(CreateGroupArgsRowTuple());
-    }
+    group_args_chunk_.resize(num_rows);
   }
+  // Encodes the group keys of the whole batch, column by column, into a single buffer.
+  group_key_encoder_.EncodeBatch(rb, group_col_idxs_);
+  return Status::OK();
+}
 
-  // Scan through all the group args in column order and extract the entire column.
-  for (size_t idx = 0; idx < plan_node_->groups().size(); idx++) {
-    auto grp = plan_node_->groups()[idx];
-    DCHECK(grp.idx < input_descriptor_->size());
-    DCHECK(idx < group_data_types_.size());
-    auto dt = group_data_types_[idx];
-    auto col = rb.ColumnAt(grp.idx).get();
+void AggNode::PartitionRowBatch(const RowBatch& rb) {
+  if (partitions_.size() == 1) {
+    auto& row_idxs = partitions_[0]->row_idxs;
+    if (rb.HasSelection()) {
+      row_idxs = *rb.selection();
+      return;
+    }
+    row_idxs.resize(rb.num_rows());
+    std::iota(row_idxs.begin(), row_idxs.end(), 0);
+    return;
+  }
+  for (auto& partition : partitions_) {
+    partition->row_idxs.clear();
+  }
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    // The hash map uses the low bits of the same hash, so partition on the high bits.
+    size_t hash = group_key_encoder_.key(row_idx).hash;
+    partitions_[(hash >> 32) % partitions_.size()]->row_idxs.push_back(row_idx);
+  }
+}
 
-#define TYPE_CASE(_dt_) ExtractIntoGroupArgs<_dt_>(&group_args_chunk_, col, idx);
-    PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
-#undef TYPE_CASE
+Status AggNode::ForEachPartition(int64_t num_rows, const std::function<Status(size_t)>& fn) {
+  if (worker_pool_ == nullptr || partitions_.size() == 1 || num_rows < kMinRowsForParallelAgg) {
+    for (size_t i = 0; i < partitions_.size(); ++i) {
+      PL_RETURN_IF_ERROR(fn(i));
+    }
+    return Status::OK();
   }
-  return Status::OK();
+  return worker_pool_->ParallelFor(partitions_.size(), fn);
 }
 
-Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
-  PL_UNUSED(exec_state);
+Status AggNode::HashRowBatch(const RowBatch& rb, AggPartition* partition) {
+  auto& agg_hash_map = partition->agg_hash_map;
   // Loop through all the row and basically store the values into column chunk based on which
   // group they belong to.
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+  for (auto row_idx : partition->row_idxs) {
     auto& ga = group_args_chunk_[row_idx];
+    auto key = group_key_encoder_.key(row_idx);
     AggHashValue* val = nullptr;
     // Check to see if in hash
     // TODO(zasgar): Change this to upsert.
-    auto it = agg_hash_map_.find(ga.rt);
+    auto it = agg_hash_map.find(key);
     // If not in hash then insert
-    if (it == agg_hash_map_.end()) {
+    if (it == agg_hash_map.end()) {
       // Create a val array.
-      val = CreateAggHashValue(exec_state);
-      agg_hash_map_[ga.rt] = val;
-      // We have inserted this, so the stored RowTuple is now in the table.
-      ga.rt = nullptr;
+      val = CreateAggHashValue(partition);
+      // The key only lives until the next batch is encoded, so the table stores a copy of it in
+      // the partition's arena.
+      agg_hash_map[partition->keys.Add(key)] = val;
     } else {
       val = it->second;
     }
     ga.av = val;
   }
 
-  auto values = plan_node_->values();
   // Now extract the values in the agg hash value.
   for (size_t i = 0; i < stored_cols_data_types_.size(); ++i) {
     const auto& rb_col_idx = stored_cols_to_plan_idx_[i];
     const auto& dt = input_descriptor_->type(rb_col_idx);
 
-#define TYPE_CASE(_dt_) ExtractToColumnWrapper<_dt_>(group_args_chunk_, rb, i, rb_col_idx);
+#define TYPE_CASE(_dt_) \
+  ExtractToColumnWrapper<_dt_>(group_args_chunk_, partition->row_idxs, rb, i, rb_col_idx);
 
     PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
 #undef TYPE_CASE
@@ -270,12 +358,11 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
   return Status::OK();
 }
 
-Status AggNode::EvaluatePartialAggregates(ExecState* exec_state, size_t num_records) {
-  PL_UNUSED(exec_state);
+Status AggNode::EvaluatePartialAggregates(ExecState* exec_state, const AggPartition& partition) {
   // TODO(zasgar): This only needs to run for unique groups. We should find
   // a way to optimize this.
-  for (size_t i = 0; i < num_records; ++i) {
-    DCHECK(i < group_args_chunk_.size());
+  for (auto i : partition.row_idxs) {
+    DCHECK(static_cast<size_t>(i) < group_args_chunk_.size());
     auto& ga = group_args_chunk_[i];
     DCHECK(ga.av != nullptr);
     if (ga.av->agg_cols[0]->Size() > kAggCompactionThreshold) {
@@ -286,21 +373,15 @@ Status AggNode::EvaluatePartialAggregates(ExecState* exec_state, size_t num_reco
 }
 
 Status AggNode::ResetGroupArgs() {
-  // Reset the group args. If the row tuple is null it has been consumed, so
-  // we can replace it with a new RowTuple. We also reset the
-  // agg hash value to nullptr.
-  for (size_t i = 0; i < group_args_chunk_.size(); ++i) {
-    group_args_chunk_[i].av = nullptr;
-    if (group_args_chunk_[i].rt == nullptr) {
-      group_args_chunk_[i].rt = CreateGroupArgsRowTuple();
-    } else {
-      group_args_chunk_[i].rt->Reset();
-    }
+  // Reset the agg hash value of the group args to nullptr.
+  for (auto& ga : group_args_chunk_) {
+    ga.av = nullptr;
   }
   return Status::OK();
 }
 
-Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* output_rb) {
+Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, const AggPartition& partition,
+                                            RowBatch* output_rb) {
   PL_UNUSED(exec_state);
   DCHECK(output_rb != nullptr);
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
@@ -313,16 +394,13 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
   }
 
   // Agg into agg values and emit!
-  for (const auto& kv : agg_hash_map_) {
-    auto* groups_rt = kv.first;
+  for (const auto& kv : partition.agg_hash_map) {
+    const auto& group_key = kv.first;
     auto* val = kv.second;
 
     for (size_t i = 0; i < group_data_types_.size(); ++i) {
       DCHECK(i < group_builders.size());
-
-#define TYPE_CASE(_dt_) AppendToBuilder<_dt_>(group_builders[i].get(), groups_rt, i);
-      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
-#undef TYPE_CASE
+      PL_RETURN_IF_ERROR(group_key_encoder_.AppendValue(group_key, i, group_builders[i].get()));
     }
     // Actually Finalize the UDA based on the column wrapper chunks.
     PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
@@ -349,31 +427,58 @@ Status AggNode::ConvertAggHashMapToRowBatch(ExecState* exec_state, RowBatch* out
 }
 
 Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb) {
-  // Extracts the row tuples (column wise).
-  // TODO(zasgar): PL-455 - Chunk this so we don't create a crazy number of row tuples if the batch
-  // is large. The process is as follows:
-  // 1. Extract each column into the appropriate part of the row tuple.
+  // The process is as follows:
+  // 1. Encode the group key columns of the batch into flat keys.
   // 2. Hash row batch and update agg values.
   // 3. If the agg values are large then run aggregate and compact.
   // 4. Reset state to prepare for next row batch.
   // 5. If it's the last batch then emit the values.
-  PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
-  PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
-  if (plan_node_->values().size() > 0) {
-    PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
-  }
+  // Steps 2 and 3 only touch the groups of a single partition, so they run on each partition in
+  // parallel when there are multiple execution threads.
+  PL_RETURN_IF_ERROR(ExtractGroupKeysForBatch(rb));
+  PartitionRowBatch(rb);
+  PL_RETURN_IF_ERROR(ForEachPartition(rb.num_selected_rows(), [&](size_t i) -> Status {
+    auto* partition = partitions_[i].get();
+    PL_RETURN_IF_ERROR(HashRowBatch(rb, partition));
+    if (plan_node_->values().size() > 0) {
+      PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, *partition));
+    }
+    return Status::OK();
+  }));
   PL_RETURN_IF_ERROR(ResetGroupArgs());
   if (ReadyToEmitBatches(rb)) {
-    RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
-    PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, &output_rb));
-    output_rb.set_eow(rb.eow());
-    output_rb.set_eos(rb.eos());
-    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
+    PL_RETURN_IF_ERROR(EmitPartitions(exec_state, rb));
     PL_RETURN_IF_ERROR(ClearAggState(exec_state));
   }
   return Status::OK();
 }
 
+Status AggNode::EmitPartitions(ExecState* exec_state, const RowBatch& rb) {
+  int64_t num_groups = 0;
+  for (const auto& partition : partitions_) {
+    num_groups += partition->agg_hash_map.size();
+  }
+  // Each partition is finalized into its own output batch, so that no partition has to wait for
+  // the others to be copied into a single batch.
+  std::vector<std::unique_ptr<RowBatch>> output_rbs(partitions_.size());
+  PL_RETURN_IF_ERROR(ForEachPartition(num_groups, [&](size_t i) -> Status {
+    const auto& partition = *partitions_[i];
+    output_rbs[i] = std::make_unique<RowBatch>(*output_descriptor_, partition.agg_hash_map.size());
+    return ConvertAggHashMapToRowBatch(exec_state, partition, output_rbs[i].get());
+  }));
+
+  for (size_t i = 0; i < output_rbs.size(); ++i) {
+    bool last = i == output_rbs.size() - 1;
+    if (!last && output_rbs[i]->num_rows() == 0) {
+      continue;
+    }
+    output_rbs[i]->set_eow(last && rb.eow());
+    output_rbs[i]->set_eos(last && rb.eos());
+    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *output_rbs[i]));
+  }
+  return Status::OK();
+}
+
 StatusOr<types::DataType> AggNode::GetTypeOfDep(const plan::ScalarExpression& expr) const {
   // Agg exprs can only be of type col, or  const.
   switch (expr.ExpressionType()) {
@@ -449,7 +554,7 @@ Status AggNode::EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val) {
                         const std::vector<StatusOr<types::SharedColumnWrapper>>& children)
                         -> types::SharedColumnWrapper {
       DCHECK_EQ(children.size(), 0ULL);
-      return val->agg_cols[plan_cols_to_stored_map_[col.Index()]];
+      return val->agg_cols[plan_cols_to_stored_map_.at(col.Index())];
     });
 
     walker.OnAggregateExpression(
@@ -506,27 +611,30 @@ Status AggNode::CreateColumnMapping() {
   return Status::OK();
 }
 
-AggHashValue* AggNode::CreateAggHashValue(ExecState* exec_state) {
-  auto* val = udas_pool_.Add(new AggHashValue);
-  PL_CHECK_OK(CreateUDAInfoValues(&(val->udas), exec_state));
+AggHashValue* AggNode::CreateAggHashValue(AggPartition* partition) {
+  auto* val = partition->udas_pool.Add(new AggHashValue);
+  PL_CHECK_OK(CreateUDAInfoValues(&(val->udas)));
   for (const auto& dt : stored_cols_data_types_) {
     val->agg_cols.emplace_back(types::ColumnWrapper::Make(dt, 0));
   }
   return val;
 }
 
-Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state) {
+Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val) {
   CHECK(val != nullptr);
   CHECK_EQ(val->size(), 0ULL);
 
-  for (const auto& value : plan_node_->values()) {
+  const auto& values = plan_node_->values();
+  DCHECK_EQ(values.size(), uda_defs_.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto& value = values[i];
     std::vector<types::DataType> types;
     types.reserve(value->Deps().size());
     for (auto* dep : value->Deps()) {
       PL_ASSIGN_OR_RETURN(auto type, GetTypeOfDep(*dep));
       types.push_back(type);
     }
-    auto def = exec_state->GetUDADefinition(value->uda_id());
+    auto def = uda_defs_[i];
     auto uda = def->Make();
 
     std::vector<std::shared_ptr<types::BaseValueType>> init_args;
@@ -18,6 +18,7 @@
 
 #pragma once
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -27,7 +28,8 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
-#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/flat_key.h"
+#include "src/carnot/exec/parallel_pipeline.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/udf/base.h"
@@ -58,18 +60,31 @@ struct AggHashValue {
 };
 
 struct GroupArgs {
-  explicit GroupArgs(RowTuple* rt) : rt(rt), av(nullptr) {}
-  RowTuple* rt;
-  AggHashValue* av;
+  AggHashValue* av = nullptr;
 };
 
-class AggNode : public ProcessingNode {
-  using AggHashMap = AbslRowTupleHashMap<AggHashValue*>;
+using AggHashMap = FlatKeyHashMap<AggHashValue*>;
 
+/**
+ * AggPartition holds the groups of an AggNode whose group key hashes to the same partition.
+ * Partitions never share groups, so each partition can be updated and finalized on its own thread.
+ */
+struct AggPartition {
+  AggHashMap agg_hash_map;
+  // The group keys of agg_hash_map.
+  FlatKeyArena keys;
+  ObjectPool udas_pool{"udas_pool"};
+  // The indexes of the rows of the current row batch that belong to this partition.
+  std::vector<int64_t> row_idxs;
+};
+
+class AggNode : public ProcessingNode {
  public:
   AggNode() = default;
   virtual ~AggNode() = default;
 
+  bool AcceptsSelectionVectors() const override { return true; }
+
  protected:
   Status AggregateGroupByNone(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status AggregateGroupByClause(ExecState* exec_state, const table_store::schema::RowBatch& rb);
@@ -83,7 +98,10 @@ class AggNode : public ProcessingNode {
                          size_t parent_index) override;
 
  private:
-  AggHashMap agg_hash_map_;
+  // Row batches (and sets of groups to finalize) smaller than this are aggregated on the calling
+  // thread, since handing them to the worker pool costs more than it saves.
+  static constexpr int64_t kMinRowsForParallelAgg = 1024;
+
   bool HasNoGroups() const { return plan_node_->groups().empty(); }
   // ReadyToEmitBatches returns true when the input stream has reached a point where output batches
   // can be emitted. In the windowed aggregate case, this happens whenever end of window (eow) is
@@ -95,6 +113,12 @@ class AggNode : public ProcessingNode {
   Status EvaluateSingleExpressionNoGroups(ExecState* exec_state, const UDAInfo& uda_info,
                                           plan::AggregateExpression* expr,
                                           const table_store::schema::RowBatch& rb);
+  // Splits the row batch into one slice per execution thread, and updates each slice's UDAs with
+  // it.
+  Status EvaluateWorkerSlicesNoGroups(ExecState* exec_state,
+                                      const table_store::schema::RowBatch& rb);
+  // Merges the UDA state of every slice into udas_no_groups_, using the UDAs' Merge functions.
+  Status MergeSliceUDAs();
   Status EvaluateAggHashValue(ExecState* exec_state, AggHashValue* val);
   StatusOr<types::DataType> GetTypeOfDep(const plan::ScalarExpression& expr) const;
 
@@ -104,8 +128,18 @@ class AggNode : public ProcessingNode {
 
   std::unique_ptr<udf::FunctionContext> function_ctx_;
 
+  // The definitions of the UDAs of each value expression, in the order of plan_node_->values().
+  std::vector<udf::UDADefinition*> uda_defs_;
+
+  // Runs the aggregation of large row batches on multiple threads. This is the worker pool of the
+  // execution graph, and is only set if the query has more than one execution thread.
+  MorselWorkerPool* worker_pool_ = nullptr;
+
   // Variables specific to GroupByNone Agg.
   std::vector<UDAInfo> udas_no_groups_;
+  // Partial UDA state for each slice of a row batch, merged into udas_no_groups_ on emit. Empty if
+  // the aggregate runs on a single thread.
+  std::vector<std::vector<UDAInfo>> slice_udas_no_groups_;
   // END: Variables specific to GroupByNone Agg.
 
   // Variables specific to GroupBy Agg.
@@ -121,34 +155,39 @@ class AggNode : public ProcessingNode {
   // 3. The data type of the stored colums, by the index they are stored at.
   std::vector<types::DataType> stored_cols_data_types_;
 
-  ObjectPool group_args_pool_{"group_args_pool"};
-  ObjectPool udas_pool_{"udas_pool"};
+  // The groups are hash partitioned by their group key, one partition per execution thread.
+  std::vector<std::unique_ptr<AggPartition>> partitions_;
 
   std::vector<types::DataType> group_data_types_;
   std::vector<types::DataType> value_data_types_;
 
-  // We construct row-tuples in a batch, chunked by each column.
-  // This vector holds pointers to the row_tuples which are managed by the group_args_pool_.
-
+  // Encodes the group keys of each row batch, a column at a time.
+  FlatKeyEncoder group_key_encoder_;
+  // The input column of each group key column.
+  std::vector<int64_t> group_col_idxs_;
+  // The agg hash value of each row of the current row batch.
   std::vector<GroupArgs> group_args_chunk_;
   // END: Variables specific to GroupBy Agg.
 
   // Creates a mapping between plan cols and stored cols (see above comment).
   Status CreateColumnMapping();
 
-  Status ExtractRowTupleForBatch(const table_store::schema::RowBatch& rb);
-  Status HashRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
-  Status EvaluatePartialAggregates(ExecState* exec_state, size_t num_records);
+  Status ExtractGroupKeysForBatch(const table_store::schema::RowBatch& rb);
+  // Assigns each row of the batch to the partition of its group.
+  void PartitionRowBatch(const table_store::schema::RowBatch& rb);
+  // Runs fn on every partition, in parallel if there is a worker pool and num_rows is large
+  // enough to be worth it.
+  Status ForEachPartition(int64_t num_rows, const std::function<Status(size_t)>& fn);
+  Status HashRowBatch(const table_store::schema::RowBatch& rb, AggPartition* partition);
+  Status EvaluatePartialAggregates(ExecState* exec_state, const AggPartition& partition);
   Status ResetGroupArgs();
-  Status ConvertAggHashMapToRowBatch(ExecState* exec_state,
+  Status ConvertAggHashMapToRowBatch(ExecState* exec_state, const AggPartition& partition,
                                      table_store::schema::RowBatch* output_rb);
+  Status EmitPartitions(ExecState* exec_state, const table_store::schema::RowBatch& rb);
 
-  AggHashValue* CreateAggHashValue(ExecState* exec_state);
-  RowTuple* CreateGroupArgsRowTuple() {
-    return group_args_pool_.Add(new RowTuple(&group_data_types_));
-  }
+  AggHashValue* CreateAggHashValue(AggPartition* partition);
 
-  Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
+  Status CreateUDAInfoValues(std::vector<UDAInfo>* val);
 };
 
 }  // namespace exec
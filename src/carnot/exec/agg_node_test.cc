@@ -19,6 +19,7 @@
 #include "src/carnot/exec/agg_node.h"
 
 #include <algorithm>
+#include <vector>
 
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
@@ -611,6 +612,98 @@ TEST_F(AggNodeTest, single_group_blocking_init_args) {
       .Close();
 }
 
+TEST_F(AggNodeTest, no_groups_blocking_multiple_threads) {
+  exec_state_->set_num_exec_threads(4);
+  MorselWorkerPool pool(4);
+  exec_state_->set_morsel_pool(&pool);
+  auto plan_node = PlanNodeFromPbtxt(kBlockingNoGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Large enough batches that the rows are split between the workers.
+  constexpr int64_t kNumRows = 4096;
+  std::vector<types::Int64Value> col1(kNumRows);
+  std::vector<types::Int64Value> col2(kNumRows);
+  int64_t expected = 0;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    col1[i] = i;
+    col2[i] = kNumRows - i;
+    expected += std::min(i, kNumRows - i);
+  }
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, kNumRows, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>(col1)
+                       .AddColumn<types::Int64Value>(col2)
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, kNumRows, true, true)
+                       .AddColumn<types::Int64Value>(col1)
+                       .AddColumn<types::Int64Value>(col2)
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::Int64Value>({Int64Value(2 * expected)})
+                          .get(),
+                      false)
+      .Close();
+}
+
+TEST_F(AggNodeTest, single_group_blocking_multiple_threads) {
+  constexpr int64_t kNumThreads = 4;
+  exec_state_->set_num_exec_threads(kNumThreads);
+  MorselWorkerPool pool(kNumThreads);
+  exec_state_->set_morsel_pool(&pool);
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  constexpr int64_t kNumRows = 4096;
+  constexpr int64_t kNumGroups = 100;
+  std::vector<types::Int64Value> groups(kNumRows);
+  std::vector<types::Int64Value> values(kNumRows);
+  std::vector<int64_t> expected_sums(kNumGroups, 0);
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    groups[i] = i % kNumGroups;
+    values[i] = i;
+    // Both batches contain the same rows.
+    expected_sums[i % kNumGroups] += 2 * std::min(i % kNumGroups, i);
+  }
+  std::vector<types::Int64Value> expected_groups;
+  std::vector<types::Int64Value> expected_values;
+  for (int64_t group = 0; group < kNumGroups; ++group) {
+    expected_groups.emplace_back(group);
+    expected_values.emplace_back(expected_sums[group]);
+  }
+
+  // Each partition of groups is emitted as its own row batch.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, kNumRows, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>(groups)
+                       .AddColumn<types::Int64Value>(values)
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, kNumRows, true, true)
+                       .AddColumn<types::Int64Value>(groups)
+                       .AddColumn<types::Int64Value>(values)
+                       .get(),
+                   0, kNumThreads)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, kNumGroups, true, true)
+                                .AddColumn<types::Int64Value>(expected_groups)
+                                .AddColumn<types::Int64Value>(expected_values)
+                                .get(),
+                            kNumThreads)
+      .Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
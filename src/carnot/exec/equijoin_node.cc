@@ -23,9 +23,13 @@
 #include <arrow/status.h>
 #include <algorithm>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 
+#include <absl/strings/str_cat.h>
 #include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 
@@ -34,6 +38,18 @@
 #include "src/common/base/base.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
+#include "src/table_store/schemapb/schema.pb.h"
+
+DEFINE_int64(equijoin_memory_budget_bytes,
+             gflags::Int64FromEnv("PL_EQUIJOIN_MEMORY_BUDGET_BYTES", 512 * 1024 * 1024),
+             "The bytes of input row batches a join may buffer before it switches to a grace hash "
+             "join.");
+DEFINE_int32(equijoin_grace_partitions, gflags::Int32FromEnv("PL_EQUIJOIN_GRACE_PARTITIONS", 16),
+             "The number of partitions a grace hash join splits its inputs into.");
+DEFINE_string(equijoin_spill_dir,
+              gflags::StringFromEnv("PL_EQUIJOIN_SPILL_DIR", ""),
+              "The local directory grace hash joins write their partitions to. If empty, the "
+              "partitions are kept in memory, so a join over the memory budget keeps growing.");
 
 namespace px {
 namespace carnot {
@@ -112,6 +128,13 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
     selected_spec.output_col_indices.emplace_back(i);
   }
 
+  memory_budget_bytes_ = FLAGS_equijoin_memory_budget_bytes;
+  // The first key orders the inputs, so it has to be read back as an integer.
+  sort_merge_ = plan_node_->inputs_sorted_by_key() && !key_data_types_.empty() &&
+                (key_data_types_[0] == types::DataType::TIME64NS ||
+                 key_data_types_[0] == types::DataType::INT64);
+  key_encoder_ = FlatKeyEncoder(key_data_types_);
+
   return Status::OK();
 }
 
@@ -134,57 +157,43 @@ Status EquijoinNode::PrepareImpl(ExecState* /*exec_state*/) {
 Status EquijoinNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
 
 Status EquijoinNode::CloseImpl(ExecState* /*exec_state*/) {
-  join_keys_chunk_.clear();
-  build_buffer_.clear();
-  probed_keys_.clear();
-  key_values_pool_.Clear();
+  ResetBuildTable();
+  for (auto& partition : partitions_) {
+    partition.build_spill.close();
+    partition.probe_spill.close();
+    for (const auto& path : {partition.build_spill_path, partition.probe_spill_path}) {
+      std::error_code ec;
+      if (!path.empty() && !std::filesystem::remove(path, ec) && ec) {
+        LOG(WARNING) << absl::Substitute("Failed to remove join spill file $0: $1", path,
+                                         ec.message());
+      }
+    }
+  }
+  partitions_.clear();
   return Status::OK();
 }
 
-template <types::DataType DT>
-void ExtractIntoRowTuples(std::vector<RowTuple*>* row_tuples, arrow::Array* input_col,
-                          int rt_col_idx) {
-  auto num_rows = input_col->length();
-  for (auto row_idx = 0; row_idx < num_rows; ++row_idx) {
-    ExtractIntoRowTuple<DT>((*row_tuples)[row_idx], input_col, rt_col_idx, row_idx);
-  }
+void EquijoinNode::ResetBuildTable() {
+  build_buffer_.clear();
+  build_buffer_rows_.clear();
+  probed_keys_.clear();
+  build_keys_by_sort_key_.clear();
+  build_wrappers_chunk_.clear();
+  probe_wrappers_chunk_.clear();
+  probe_rows_chunk_.clear();
+  evicted_build_wrappers_.clear();
+  free_build_wrappers_.clear();
+  build_keys_.Clear();
+  evicted_key_bytes_ = 0;
+  column_values_pool_.Clear();
 }
 
 Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb,
                                              bool is_probe) {
-  // Reset the row tuples
-  for (auto& rt : join_keys_chunk_) {
-    if (rt == nullptr) {
-      rt = key_values_pool_.Add(new RowTuple(&key_data_types_));
-    } else {
-      rt->Reset();
-    }
-  }
-
-  // Grow the join_keys_chunk_ to be the size of the RowBatch.
-  size_t num_rows = rb.num_rows();
-  if (join_keys_chunk_.size() < num_rows) {
-    int prev_size = join_keys_chunk_.size();
-    join_keys_chunk_.reserve(num_rows);
-    for (size_t idx = prev_size; idx < num_rows; ++idx) {
-      auto tuple_ptr = key_values_pool_.Add(new RowTuple(&key_data_types_));
-      join_keys_chunk_.emplace_back(tuple_ptr);
-    }
-  }
-
   const TableSpec& spec = is_probe ? probe_spec_ : build_spec_;
-
-  // Scan through all the group args in column order and extract the entire column.
-  for (size_t tuple_col_idx = 0; tuple_col_idx < spec.key_indices.size(); ++tuple_col_idx) {
-    auto input_col_idx = spec.key_indices[tuple_col_idx];
-    auto dt = key_data_types_[tuple_col_idx];
-    auto col = rb.ColumnAt(input_col_idx).get();
-
-#define TYPE_CASE(_dt_) ExtractIntoRowTuples<_dt_>(&join_keys_chunk_, col, tuple_col_idx);
-    PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
-#undef TYPE_CASE
-  }
-
+  // Encodes the keys of the whole batch, column by column. The keys are only valid until the next
+  // batch is encoded, so the build table stores copies of them in build_keys_.
+  key_encoder_.EncodeBatch(rb, spec.key_indices);
   return Status::OK();
 }
 
@@ -197,22 +206,56 @@ std::vector<types::SharedColumnWrapper>* CreateWrapper(ObjectPool* pool,
   return ptr;
 }
 
+std::vector<types::SharedColumnWrapper>* EquijoinNode::NewBuildWrapper() {
+  if (free_build_wrappers_.empty()) {
+    return CreateWrapper(&column_values_pool_, build_spec_.input_col_types);
+  }
+  auto wrapper = free_build_wrappers_.back();
+  free_build_wrappers_.pop_back();
+  for (auto& col : *wrapper) {
+    col->Clear();
+  }
+  return wrapper;
+}
+
+int64_t EquijoinNode::SortKeyAt(const RowBatch& rb, bool is_probe, int64_t row_idx) const {
+  const TableSpec& spec = is_probe ? probe_spec_ : build_spec_;
+  auto col = rb.ColumnAt(spec.key_indices[0]).get();
+  if (key_data_types_[0] == types::DataType::TIME64NS) {
+    return types::GetValueFromArrowArray<types::DataType::TIME64NS>(col, row_idx);
+  }
+  return types::GetValueFromArrowArray<types::DataType::INT64>(col, row_idx);
+}
+
 Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
   if (rb.num_rows() > static_cast<int64_t>(build_wrappers_chunk_.size())) {
     build_wrappers_chunk_.resize(rb.num_rows());
   }
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
     if (build_wrappers_chunk_[row_idx] == nullptr) {
-      build_wrappers_chunk_[row_idx] =
-          CreateWrapper(&column_values_pool_, build_spec_.input_col_types);
+      build_wrappers_chunk_[row_idx] = NewBuildWrapper();
     }
   }
 
   // Make sure the map has constructed the necessary column wrappers for all of the tuples.
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
-    auto& rt = join_keys_chunk_[row_idx];
-    auto& current = build_buffer_[rt];
-    auto wrappers_ptr = current != nullptr ? current : build_wrappers_chunk_[row_idx];
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    auto key = key_encoder_.key(row_idx);
+    auto it = build_buffer_.find(key);
+    std::vector<types::SharedColumnWrapper>* wrappers_ptr;
+    if (it == build_buffer_.end()) {
+      key = build_keys_.Add(key);
+      wrappers_ptr = build_wrappers_chunk_[row_idx];
+      build_wrappers_chunk_[row_idx] = nullptr;
+      build_buffer_[key] = wrappers_ptr;
+      if (sort_merge_) {
+        build_keys_by_sort_key_.emplace_back(SortKeyAt(rb, false, row_idx), key);
+      }
+    } else {
+      key = it->first;
+      wrappers_ptr = it->second;
+    }
 
     // Now extract the values into the corresponding column wrappers.
     for (size_t i = 0; i < build_spec_.input_col_indices.size(); ++i) {
@@ -226,13 +269,7 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
 #undef TYPE_CASE
     }
     // Keep track of the number of rows that the build buffer matches for each key.
-    build_buffer_rows_[rt]++;
-
-    if (current == nullptr) {
-      std::swap(build_wrappers_chunk_[row_idx], current);
-      // Reset the new tuples that we added
-      join_keys_chunk_[row_idx] = nullptr;
-    }
+    build_buffer_rows_[key]++;
   }
 
   return Status::OK();
@@ -321,6 +358,11 @@ Status EquijoinNode::FlushChunkedRows(ExecState* exec_state) {
   std::vector<EquijoinNode::OutputChunk> new_chunks(0);
   std::swap(chunks_, new_chunks);
   queued_rows_ = 0;
+
+  // No chunk references the evicted build values anymore, so they can be reused.
+  free_build_wrappers_.insert(free_build_wrappers_.end(), evicted_build_wrappers_.begin(),
+                              evicted_build_wrappers_.end());
+  evicted_build_wrappers_.clear();
   return NextOutputBatch(exec_state);
 }
 
@@ -347,20 +389,20 @@ Status EquijoinNode::MatchBuildValuesAndFlush(ExecState* exec_state,
 }
 
 Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::RowBatch& rb) {
-  if (rb.eos()) {
-    probe_eos_ = true;
-  }
-
   PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, true));
 
   if (rb.num_rows() > static_cast<int64_t>(probe_wrappers_chunk_.size())) {
     probe_wrappers_chunk_.resize(rb.num_rows());
+    probe_rows_chunk_.resize(rb.num_rows());
   }
 
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
-    auto it = build_buffer_.find(join_keys_chunk_[row_idx]);
+  // The probe keys are never inserted into the build table, only looked up.
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    auto it = build_buffer_.find(key_encoder_.key(row_idx));
     if (it != build_buffer_.end()) {
       probe_wrappers_chunk_[row_idx] = it->second;
+      probe_rows_chunk_[row_idx] = build_buffer_rows_.find(it->first)->second;
       probed_keys_.insert(it->first);
     } else {
       probe_wrappers_chunk_[row_idx] = nullptr;
@@ -369,7 +411,8 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
 
   auto rb_ptr = std::make_shared<RowBatch>(rb);
 
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
     if (queued_rows_ >= output_rows_per_batch_ - column_builders_[0]->length()) {
       PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
     }
@@ -384,12 +427,7 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
     }
 
     PL_RETURN_IF_ERROR(MatchBuildValuesAndFlush(exec_state, probe_wrappers_chunk_[row_idx], rb_ptr,
-                                                row_idx,
-                                                build_buffer_rows_[join_keys_chunk_[row_idx]]));
-  }
-
-  if (probe_eos_ && queued_rows_ > 0) {
-    PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+                                                row_idx, probe_rows_chunk_[row_idx]));
   }
 
   return Status::OK();
@@ -410,65 +448,477 @@ Status EquijoinNode::EmitUnmatchedBuildRows(ExecState* exec_state) {
   return Status::OK();
 }
 
+std::shared_ptr<const RowBatch::SelectionVector> SelectRows(const RowBatch& rb, int64_t begin,
+                                                            int64_t end) {
+  auto selection = std::make_shared<RowBatch::SelectionVector>();
+  selection->reserve(end - begin);
+  for (int64_t i = begin; i < end; ++i) {
+    selection->push_back(rb.selected_row(i));
+  }
+  return selection;
+}
+
+Status EquijoinNode::ProbeSortedBatches(ExecState* exec_state) {
+  while (!probe_batches_.empty()) {
+    auto& rb = probe_batches_.front();
+    int64_t num_rows = rb.num_selected_rows();
+    // A probe row can be joined once the build side has moved past its key, since the later build
+    // rows all have a key at least as large as the last one seen.
+    int64_t num_ready = build_eos_ ? num_rows : 0;
+    if (!build_eos_ && has_build_sort_key_) {
+      int64_t end = num_rows;
+      while (num_ready < end) {
+        int64_t mid = num_ready + (end - num_ready) / 2;
+        if (SortKeyAt(rb, true, rb.selected_row(mid)) < build_sort_key_) {
+          num_ready = mid + 1;
+        } else {
+          end = mid;
+        }
+      }
+    }
+
+    if (num_ready > 0) {
+      RowBatch ready_rb = rb;
+      if (num_ready < num_rows) {
+        ready_rb.SetSelection(SelectRows(rb, 0, num_ready));
+      }
+      PL_RETURN_IF_ERROR(DoProbe(exec_state, ready_rb));
+      probe_sort_key_ = SortKeyAt(rb, true, rb.selected_row(num_ready - 1));
+      has_probe_sort_key_ = true;
+    }
+
+    if (num_ready < num_rows) {
+      rb.SetSelection(SelectRows(rb, num_ready, num_rows));
+      break;
+    }
+    probe_batches_.pop();
+  }
+
+  if (!has_probe_sort_key_) {
+    return Status::OK();
+  }
+  return EvictBuildKeysBefore(exec_state, probe_sort_key_);
+}
+
+Status EquijoinNode::EvictBuildKeysBefore(ExecState* exec_state, int64_t sort_key) {
+  // The later probe rows all have a key at least as large as sort_key, so the build keys below it
+  // can't match anymore.
+  while (!build_keys_by_sort_key_.empty() && build_keys_by_sort_key_.front().first < sort_key) {
+    FlatKey key = build_keys_by_sort_key_.front().second;
+    build_keys_by_sort_key_.pop_front();
+
+    auto it = build_buffer_.find(key);
+    DCHECK(it != build_buffer_.end());
+    auto wrapper = it->second;
+    if (build_spec_.emit_unmatched_rows && !probed_keys_.contains(key)) {
+      PL_RETURN_IF_ERROR(
+          MatchBuildValuesAndFlush(exec_state, wrapper, nullptr, 0, build_buffer_rows_[key]));
+    }
+    probed_keys_.erase(key);
+    build_buffer_rows_.erase(key);
+    build_buffer_.erase(it);
+    evicted_key_bytes_ += key.size;
+    evicted_build_wrappers_.emplace_back(wrapper);
+  }
+
+  if (build_keys_.bytes() > kMinBuildKeyBytesToCompact &&
+      evicted_key_bytes_ > build_keys_.bytes() / 2) {
+    CompactBuildKeys();
+  }
+  return Status::OK();
+}
+
+bool EquijoinNode::SortedAfter(const RowBatch& rb, bool is_probe, bool has_sort_key,
+                               int64_t sort_key) const {
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    int64_t key = SortKeyAt(rb, is_probe, rb.selected_row(i));
+    if (has_sort_key && key < sort_key) {
+      return false;
+    }
+    sort_key = key;
+    has_sort_key = true;
+  }
+  return true;
+}
+
+Status EquijoinNode::FallBackToHashJoin(ExecState* exec_state) {
+  // Until a probe row is joined, the build table holds every build row and probe_batches_ every
+  // probe row, which is the state of the hash mode. After that, rows have been joined and evicted
+  // on the assumption that the inputs are sorted, so the result would be missing matches.
+  if (has_probe_sort_key_) {
+    return error::Internal(
+        "$0: the inputs are not sorted by the join key, after rows were already sort-merge joined",
+        DebugString());
+  }
+  LOG(WARNING) << absl::Substitute(
+      "$0: the inputs are not sorted by the join key, falling back to a hash join", DebugString());
+  sort_merge_ = false;
+  stats()->AddExtraInfo("join_mode", "hash");
+  build_keys_by_sort_key_.clear();
+  if (buffered_bytes_ > memory_budget_bytes_) {
+    return StartGraceJoin(exec_state);
+  }
+  return Status::OK();
+}
+
+void EquijoinNode::CompactBuildKeys() {
+  // Every live key is in build_keys_by_sort_key_, so copy those to a new arena and point the hash
+  // tables at the copies.
+  FlatKeyArena keys;
+  FlatKeyHashMap<std::vector<types::SharedColumnWrapper>*> build_buffer;
+  FlatKeyHashMap<int64_t> build_buffer_rows;
+  FlatKeyHashSet probed_keys;
+  build_buffer.reserve(build_buffer_.size());
+  build_buffer_rows.reserve(build_buffer_rows_.size());
+  for (auto& [sort_key, key] : build_keys_by_sort_key_) {
+    auto new_key = keys.Add(key);
+    build_buffer[new_key] = build_buffer_.find(key)->second;
+    build_buffer_rows[new_key] = build_buffer_rows_.find(key)->second;
+    if (probed_keys_.contains(key)) {
+      probed_keys.insert(new_key);
+    }
+    key = new_key;
+  }
+  build_buffer_ = std::move(build_buffer);
+  build_buffer_rows_ = std::move(build_buffer_rows);
+  probed_keys_ = std::move(probed_keys);
+  build_keys_ = std::move(keys);
+  evicted_key_bytes_ = 0;
+}
+
+Status SpillRowBatch(const RowBatch& rb, std::ofstream* out) {
+  table_store::schemapb::ColumnarRowBatchData rb_pb;
+  PL_RETURN_IF_ERROR(rb.ToColumnarProto(RowBatch::ColumnarEncodingOptions{}, &rb_pb));
+  std::string bytes = rb_pb.SerializeAsString();
+  uint64_t size = bytes.size();
+  out->write(reinterpret_cast<const char*>(&size), sizeof(size));
+  out->write(bytes.data(), bytes.size());
+  if (!*out) {
+    return error::Internal("Failed to write row batch to join spill file");
+  }
+  return Status::OK();
+}
+
+Status ForEachSpilledRowBatch(const std::string& path,
+                              const std::function<Status(const RowBatch&)>& fn) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return error::Internal("Failed to open join spill file $0", path);
+  }
+  uint64_t size;
+  std::string bytes;
+  while (in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    bytes.resize(size);
+    if (!in.read(bytes.data(), size)) {
+      return error::Internal("Join spill file $0 is truncated", path);
+    }
+    table_store::schemapb::ColumnarRowBatchData rb_pb;
+    if (!rb_pb.ParseFromString(bytes)) {
+      return error::Internal("Failed to parse row batch from join spill file $0", path);
+    }
+    PL_ASSIGN_OR_RETURN(auto rb, RowBatch::FromColumnarProto(rb_pb));
+    PL_RETURN_IF_ERROR(fn(*rb));
+  }
+  return Status::OK();
+}
+
+Status EquijoinNode::StartGraceJoin(ExecState* exec_state) {
+  VLOG(1) << absl::Substitute("$0 buffered $1 bytes, switching to a grace hash join",
+                              DebugString(), buffered_bytes_);
+  grace_mode_ = true;
+  stats()->AddExtraInfo("join_mode", "grace_hash");
+  partitions_.resize(std::max(FLAGS_equijoin_grace_partitions, 1));
+
+  if (FLAGS_equijoin_spill_dir.empty()) {
+    LOG(WARNING) << absl::Substitute(
+        "$0 is over --equijoin_memory_budget_bytes=$1, but --equijoin_spill_dir is empty, so its "
+        "grace partitions are kept in memory",
+        DebugString(), memory_budget_bytes_);
+  } else {
+    std::error_code ec;
+    std::filesystem::create_directories(FLAGS_equijoin_spill_dir, ec);
+    if (ec) {
+      return error::Internal("Failed to create join spill directory $0: $1",
+                             FLAGS_equijoin_spill_dir, ec.message());
+    }
+    for (size_t i = 0; i < partitions_.size(); ++i) {
+      auto& partition = partitions_[i];
+      auto prefix = absl::Substitute("$0/equijoin_$1_$2_$3", FLAGS_equijoin_spill_dir,
+                                     exec_state->query_id().str(), plan_node_->id(), i);
+      partition.build_spill_path = absl::StrCat(prefix, "_build");
+      partition.probe_spill_path = absl::StrCat(prefix, "_probe");
+      partition.build_spill.open(partition.build_spill_path, std::ios::binary | std::ios::trunc);
+      partition.probe_spill.open(partition.probe_spill_path, std::ios::binary | std::ios::trunc);
+      if (!partition.build_spill || !partition.probe_spill) {
+        return error::Internal("Failed to open join spill files $0_*", prefix);
+      }
+    }
+  }
+
+  PL_RETURN_IF_ERROR(PartitionBuildTable());
+  while (probe_batches_.size()) {
+    PL_RETURN_IF_ERROR(PartitionBatch(probe_batches_.front(), /* is_probe */ true));
+    probe_batches_.pop();
+  }
+  buffered_bytes_ = 0;
+  return Status::OK();
+}
+
+Status EquijoinNode::PartitionBuildTable() {
+  // The build table only holds the key and output columns of the build rows, so they are rebuilt
+  // in the layout of the build input, with zeroes in the columns that the join doesn't read.
+  const auto& build_desc = input_descriptors_[IsProbeTable(0) ? 1 : 0];
+  std::vector<int64_t> key_col_idx(build_desc.size(), -1);
+  std::vector<int64_t> value_col_idx(build_desc.size(), -1);
+  for (size_t i = 0; i < build_spec_.key_indices.size(); ++i) {
+    key_col_idx[build_spec_.key_indices[i]] = i;
+  }
+  for (size_t i = 0; i < build_spec_.input_col_indices.size(); ++i) {
+    value_col_idx[build_spec_.input_col_indices[i]] = i;
+  }
+
+  std::vector<std::vector<std::unique_ptr<arrow::ArrayBuilder>>> builders(partitions_.size());
+  for (const auto& [key, wrappers_ptr] : build_buffer_) {
+    auto& partition_builders = builders[(key.hash >> 32) % partitions_.size()];
+    if (partition_builders.empty()) {
+      for (size_t col = 0; col < build_desc.size(); ++col) {
+        partition_builders.push_back(
+            MakeArrowBuilder(build_desc.type(col), arrow::default_memory_pool()));
+      }
+    }
+    int64_t num_rows = build_buffer_rows_[key];
+    for (size_t col = 0; col < build_desc.size(); ++col) {
+      auto builder = partition_builders[col].get();
+      if (value_col_idx[col] >= 0) {
+#define TYPE_CASE(_dt_)                                                                           \
+  PL_RETURN_IF_ERROR(                                                                             \
+      AppendValuesFromWrapper<_dt_>(builder, wrappers_ptr->at(value_col_idx[col]), 0, num_rows))
+        PL_SWITCH_FOREACH_DATATYPE(build_desc.type(col), TYPE_CASE);
+#undef TYPE_CASE
+      } else if (key_col_idx[col] >= 0) {
+        for (int64_t i = 0; i < num_rows; ++i) {
+          PL_RETURN_IF_ERROR(key_encoder_.AppendValue(key, key_col_idx[col], builder));
+        }
+      } else {
+#define TYPE_CASE(_dt_) PL_RETURN_IF_ERROR(AppendColumnDefaultValue<_dt_>(builder, num_rows))
+        PL_SWITCH_FOREACH_DATATYPE(build_desc.type(col), TYPE_CASE);
+#undef TYPE_CASE
+      }
+    }
+  }
+  ResetBuildTable();
+
+  for (size_t i = 0; i < partitions_.size(); ++i) {
+    if (builders[i].empty()) {
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(auto rb, RowBatch::FromColumnBuilders(build_desc, /* eow */ false,
+                                                              /* eos */ false, &builders[i]));
+    PL_RETURN_IF_ERROR(AddToPartition(i, *rb, /* is_probe */ false));
+  }
+  return Status::OK();
+}
+
+Status EquijoinNode::PartitionBatch(const RowBatch& rb, bool is_probe) {
+  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, is_probe));
+
+  std::vector<std::shared_ptr<RowBatch::SelectionVector>> selections(partitions_.size());
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    // Partition on the upper bits of the hash, the hash table of a partition uses the lower ones.
+    auto partition_idx = (key_encoder_.key(row_idx).hash >> 32) % partitions_.size();
+    if (selections[partition_idx] == nullptr) {
+      selections[partition_idx] = std::make_shared<RowBatch::SelectionVector>();
+    }
+    selections[partition_idx]->emplace_back(row_idx);
+  }
+
+  for (size_t i = 0; i < partitions_.size(); ++i) {
+    if (selections[i] == nullptr) {
+      continue;
+    }
+    RowBatch partition_rb = rb;
+    partition_rb.SetSelection(std::move(selections[i]));
+    partition_rb.set_eow(false);
+    partition_rb.set_eos(false);
+    PL_RETURN_IF_ERROR(AddToPartition(i, partition_rb, is_probe));
+  }
+  return Status::OK();
+}
+
+Status EquijoinNode::AddToPartition(size_t partition_idx, const RowBatch& rb, bool is_probe) {
+  auto& partition = partitions_[partition_idx];
+  auto spill = is_probe ? &partition.probe_spill : &partition.build_spill;
+  if (spill->is_open()) {
+    return SpillRowBatch(rb, spill);
+  }
+  if (is_probe) {
+    partition.probe_batches.push_back(rb);
+  } else {
+    partition.build_batches.push_back(rb);
+  }
+  return Status::OK();
+}
+
+Status EquijoinNode::JoinGracePartitions(ExecState* exec_state) {
+  auto hash_batch = [this](const RowBatch& rb) -> Status {
+    PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, false));
+    return HashRowBatch(rb);
+  };
+  auto probe_batch = [this, exec_state](const RowBatch& rb) -> Status {
+    return DoProbe(exec_state, rb);
+  };
+
+  for (auto& partition : partitions_) {
+    if (partition.build_spill.is_open()) {
+      partition.build_spill.close();
+      partition.probe_spill.close();
+      PL_RETURN_IF_ERROR(ForEachSpilledRowBatch(partition.build_spill_path, hash_batch));
+      PL_RETURN_IF_ERROR(ForEachSpilledRowBatch(partition.probe_spill_path, probe_batch));
+    } else {
+      for (const auto& rb : partition.build_batches) {
+        PL_RETURN_IF_ERROR(hash_batch(rb));
+      }
+      for (const auto& rb : partition.probe_batches) {
+        PL_RETURN_IF_ERROR(probe_batch(rb));
+      }
+      partition.build_batches.clear();
+      partition.probe_batches.clear();
+    }
+
+    if (queued_rows_ > 0) {
+      PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+    }
+    if (build_spec_.emit_unmatched_rows) {
+      PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
+    }
+    // The next partition has a disjoint set of keys, so its build side starts from scratch.
+    ResetBuildTable();
+  }
+  return Status::OK();
+}
+
 Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
-  if (rb.eos()) {
-    build_eos_ = true;
+  if (grace_mode_) {
+    return PartitionBatch(rb, /* is_probe */ false);
+  }
+
+  if (sort_merge_ && !SortedAfter(rb, false, has_build_sort_key_, build_sort_key_)) {
+    PL_RETURN_IF_ERROR(FallBackToHashJoin(exec_state));
+    return ConsumeBuildBatch(exec_state, rb);
+  }
+  if (sort_merge_) {
+    PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, false));
+    PL_RETURN_IF_ERROR(HashRowBatch(rb));
+    // Counted in case the join falls back to the hash mode.
+    buffered_bytes_ += rb.NumBytes();
+    if (rb.num_selected_rows() > 0) {
+      build_sort_key_ = SortKeyAt(rb, false, rb.selected_row(rb.num_selected_rows() - 1));
+      has_build_sort_key_ = true;
+    }
+    return ProbeSortedBatches(exec_state);
   }
 
+  // The batch is hashed right away. If the join goes over the budget, the build table is split
+  // into the grace partitions.
   PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, false));
   PL_RETURN_IF_ERROR(HashRowBatch(rb));
+  buffered_bytes_ += rb.NumBytes();
+  if (buffered_bytes_ > memory_budget_bytes_) {
+    return StartGraceJoin(exec_state);
+  }
+  if (!build_eos_) {
+    return Status::OK();
+  }
 
-  if (build_eos_) {
-    while (probe_batches_.size()) {
-      PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
-      probe_batches_.pop();
-    }
+  while (probe_batches_.size()) {
+    PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
+    probe_batches_.pop();
   }
   return Status::OK();
 }
 
 Status EquijoinNode::ConsumeProbeBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
+  if (grace_mode_) {
+    return PartitionBatch(rb, /* is_probe */ true);
+  }
+
+  if (sort_merge_ && !SortedAfter(rb, true, has_probe_input_sort_key_, probe_input_sort_key_)) {
+    PL_RETURN_IF_ERROR(FallBackToHashJoin(exec_state));
+    // The probe batches queued so far go first, if the build side is already complete.
+    while (build_eos_ && !grace_mode_ && probe_batches_.size()) {
+      PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
+      probe_batches_.pop();
+    }
+    return ConsumeProbeBatch(exec_state, rb);
+  }
+  if (sort_merge_) {
+    buffered_bytes_ += rb.NumBytes();
+    probe_batches_.push(rb);
+    if (rb.num_selected_rows() > 0) {
+      probe_input_sort_key_ = SortKeyAt(rb, true, rb.selected_row(rb.num_selected_rows() - 1));
+      has_probe_input_sort_key_ = true;
+    }
+    return ProbeSortedBatches(exec_state);
+  }
+
   if (!build_eos_) {
+    buffered_bytes_ += rb.NumBytes();
     probe_batches_.push(rb);
+    if (buffered_bytes_ > memory_budget_bytes_) {
+      return StartGraceJoin(exec_state);
+    }
     return Status::OK();
   }
   return DoProbe(exec_state, rb);
 }
 
+Status EquijoinNode::FinishJoin(ExecState* exec_state) {
+  if (grace_mode_) {
+    PL_RETURN_IF_ERROR(JoinGracePartitions(exec_state));
+  } else {
+    // The remaining probe rows go out before the unmatched build rows.
+    if (queued_rows_ > 0) {
+      PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+    }
+    if (build_spec_.emit_unmatched_rows) {
+      PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
+    }
+  }
+
+  if (column_builders_[0]->length()) {
+    PL_RETURN_IF_ERROR(NextOutputBatch(exec_state));
+  }
+
+  // Now send the last row batch and we know it is EOS/EOW.
+  if (pending_output_batch_ == nullptr) {
+    // This should only happen when no join keys match up.
+    PL_ASSIGN_OR_RETURN(pending_output_batch_,
+                        RowBatch::WithZeroRows(*output_descriptor_, /* eow */ true, /* eos */ true));
+  } else {
+    pending_output_batch_->set_eos(true);
+    pending_output_batch_->set_eow(true);
+  }
+  return SendRowBatchToChildren(exec_state, *pending_output_batch_);
+}
+
 Status EquijoinNode::ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
                                      size_t parent_index) {
   if (IsProbeTable(parent_index)) {
     DCHECK(!probe_eos_);
+    probe_eos_ = rb.eos();
     PL_RETURN_IF_ERROR(ConsumeProbeBatch(exec_state, rb));
   } else {
     DCHECK(!build_eos_);
+    build_eos_ = rb.eos();
     PL_RETURN_IF_ERROR(ConsumeBuildBatch(exec_state, rb));
   }
 
   if (build_eos_ && probe_eos_) {
-    if (build_spec_.emit_unmatched_rows) {
-      PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
-    }
-
-    if (column_builders_[0]->length()) {
-      PL_RETURN_IF_ERROR(NextOutputBatch(exec_state));
-    }
-
-    // Now send the last row batch and we know it is EOS/EOW.
-    if (pending_output_batch_ == nullptr) {
-      // This should only happen when no join keys match up.
-      PL_ASSIGN_OR_RETURN(
-          pending_output_batch_,
-          RowBatch::WithZeroRows(*output_descriptor_, /* eow */ true, /* eos */ true));
-    } else {
-      pending_output_batch_->set_eos(true);
-      pending_output_batch_->set_eow(true);
-    }
-    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *pending_output_batch_));
+    return FinishJoin(exec_state);
   }
-
   return Status::OK();
 }
 
@@ -20,6 +20,8 @@
 
 #include <arrow/array/builder_base.h>
 #include <cstddef>
+#include <deque>
+#include <fstream>
 #include <memory>
 #include <queue>
 #include <string>
@@ -30,7 +32,7 @@
 
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
-#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/flat_key.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
@@ -44,7 +46,25 @@ namespace carnot {
 namespace exec {
 
 constexpr size_t kDefaultJoinRowBatchSize = 1024;
-
+// The sort-merge join doesn't compact the keys of its build table below this size.
+constexpr int64_t kMinBuildKeyBytesToCompact = 1024 * 1024;
+
+/**
+ * EquijoinNode joins its two inputs on the equality conditions of the plan. It runs in one of
+ * three modes:
+ *  - hash: the build side is hashed as it arrives, the probe side is buffered until the build eos
+ *    and then streams through.
+ *  - grace hash: once the hashed and buffered inputs exceed --equijoin_memory_budget_bytes, the
+ *    build table and both inputs are partitioned by the hash of their join keys into local spill
+ *    files under --equijoin_spill_dir (or in memory if it's empty), and the partitions are joined
+ *    one at a time at eos. The output preserves the probe order only within each partition.
+ *  - sort-merge: when the planner marks both inputs as sorted by the first join key, probe rows
+ *    are joined as soon as the build side has moved past their key, and build keys that the probe
+ *    side has moved past are evicted, so only the overlapping window of both inputs is held.
+ *    The order is checked as the batches arrive. If a key goes backwards before any row has been
+ *    joined, the join falls back to the hash mode; after that, the join fails rather than drop
+ *    matches.
+ */
 class EquijoinNode : public ProcessingNode {
   enum class JoinInputTable { kLeftTable, kRightTable };
 
@@ -64,6 +84,12 @@ class EquijoinNode : public ProcessingNode {
   EquijoinNode() = default;
   virtual ~EquijoinNode() = default;
 
+  bool AcceptsSelectionVectors() const override { return true; }
+
+  // Uses the hash mode even if the plan marks the inputs as sorted, for inputs that the execution
+  // graph reorders, such as the output of a parallelized pipeline.
+  void DisableSortMerge() { sort_merge_ = false; }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -89,6 +115,27 @@ class EquijoinNode : public ProcessingNode {
   Status NextOutputBatch(ExecState* exec_state);
   Status ConsumeBuildBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status ConsumeProbeBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status FinishJoin(ExecState* exec_state);
+
+  std::vector<types::SharedColumnWrapper>* NewBuildWrapper();
+  void ResetBuildTable();
+
+  // Sort-merge mode.
+  int64_t SortKeyAt(const table_store::schema::RowBatch& rb, bool is_probe, int64_t row_idx) const;
+  Status ProbeSortedBatches(ExecState* exec_state);
+  Status EvictBuildKeysBefore(ExecState* exec_state, int64_t sort_key);
+  bool SortedAfter(const table_store::schema::RowBatch& rb, bool is_probe, bool has_sort_key,
+                   int64_t sort_key) const;
+  Status FallBackToHashJoin(ExecState* exec_state);
+  void CompactBuildKeys();
+
+  // Grace hash mode.
+  Status StartGraceJoin(ExecState* exec_state);
+  Status PartitionBuildTable();
+  Status PartitionBatch(const table_store::schema::RowBatch& rb, bool is_probe);
+  Status AddToPartition(size_t partition_idx, const table_store::schema::RowBatch& rb,
+                        bool is_probe);
+  Status JoinGracePartitions(ExecState* exec_state);
 
   bool build_eos_ = false;
   bool probe_eos_ = false;
@@ -103,6 +150,8 @@ class EquijoinNode : public ProcessingNode {
   TableSpec probe_spec_;
 
   std::vector<types::DataType> key_data_types_;
+  // Encodes the join keys of each input batch, a column at a time.
+  FlatKeyEncoder key_encoder_;
 
   // Example of the above specs:
   // For input table A (build) which has [key_A_1, output_col_0, key_A_0/output_col_2]
@@ -129,27 +178,63 @@ class EquijoinNode : public ProcessingNode {
   std::queue<table_store::schema::RowBatch> probe_batches_;
   // Column builders will flush a batch once they hit output_rows_per_batch_ rows.
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> column_builders_;
-  // Manages the RowTuples containing the keys for the join.
-  ObjectPool key_values_pool_{"equijoin_kv_pool"};
+  // Holds the keys of build_buffer_.
+  FlatKeyArena build_keys_;
   ObjectPool column_values_pool_{"equijoin_col_vals_pool"};
 
-  // Chunk of data to use when extracting join keys.
-  std::vector<RowTuple*> join_keys_chunk_;
   // Chunk of data to use when performing the build stage of the join.
   std::vector<std::vector<types::SharedColumnWrapper>*> build_wrappers_chunk_;
 
   // Chunk of data to use when performing the probe stage of the join.
   // This will store build table data from `build_buffer_`.
   std::vector<std::vector<types::SharedColumnWrapper>*> probe_wrappers_chunk_;
-  AbslRowTupleHashMap<std::vector<types::SharedColumnWrapper>*> build_buffer_;
+  // The number of build rows matching each probe row, looked up along with its wrappers.
+  std::vector<int64_t> probe_rows_chunk_;
+  FlatKeyHashMap<std::vector<types::SharedColumnWrapper>*> build_buffer_;
   // Store the number of rows that match a given set of keys for the build buffer.
   // This is necessary to store in addition to the values in `build_buffer_` in
   // the event that no columns from the build side are emitted.
-  AbslRowTupleHashMap<int64_t> build_buffer_rows_;
+  FlatKeyHashMap<int64_t> build_buffer_rows_;
 
   // For joins where the build_buffer_ needs to emit any non-probed rows at the end of the join,
   // keep track of which ones they were.
-  AbslRowTupleHashSet probed_keys_;
+  FlatKeyHashSet probed_keys_;
+
+  // Bytes of the build batches hashed and the probe batches buffered by the hash mode.
+  int64_t buffered_bytes_ = 0;
+  int64_t memory_budget_bytes_;
+
+  // Sort-merge mode. The keys of build_buffer_ ordered by the first join key, along with the
+  // value of that key. Since the build side is sorted, new keys are always appended.
+  bool sort_merge_ = false;
+  std::deque<std::pair<int64_t, FlatKey>> build_keys_by_sort_key_;
+  // The last first join key seen on the build side and probed on the probe side.
+  bool has_build_sort_key_ = false;
+  int64_t build_sort_key_ = 0;
+  bool has_probe_sort_key_ = false;
+  int64_t probe_sort_key_ = 0;
+  // The last first join key that arrived on the probe side, to check the probe order.
+  bool has_probe_input_sort_key_ = false;
+  int64_t probe_input_sort_key_ = 0;
+  // Bytes of build_keys_ that belong to evicted keys. The live keys are copied to a new arena once
+  // they take up less than half of it.
+  int64_t evicted_key_bytes_ = 0;
+  // Evicted build values are only reused once the chunks that reference them have been flushed.
+  std::vector<std::vector<types::SharedColumnWrapper>*> evicted_build_wrappers_;
+  std::vector<std::vector<types::SharedColumnWrapper>*> free_build_wrappers_;
+
+  // Grace hash mode. Each partition holds views (selection vectors) of the input batches whose
+  // keys hash to it, or appends them to its spill files.
+  struct GracePartition {
+    std::vector<table_store::schema::RowBatch> build_batches;
+    std::vector<table_store::schema::RowBatch> probe_batches;
+    std::string build_spill_path;
+    std::string probe_spill_path;
+    std::ofstream build_spill;
+    std::ofstream probe_spill;
+  };
+  bool grace_mode_ = false;
+  std::vector<GracePartition> partitions_;
 
   // Handle on the most recent RowBatch (in case it's the final one).
   std::unique_ptr<table_store::schema::RowBatch> pending_output_batch_;
@@ -19,6 +19,7 @@
 #include "src/carnot/exec/equijoin_node.h"
 
 #include <absl/strings/substitute.h>
+#include <filesystem>
 #include <gmock/gmock.h>
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
@@ -29,6 +30,10 @@
 #include "src/carnot/planpb/test_proto.h"
 #include "src/carnot/udf/base.h"
 #include "src/carnot/udf/registry.h"
+#include "src/common/testing/testing.h"
+
+DECLARE_int64(equijoin_memory_budget_bytes);
+DECLARE_string(equijoin_spill_dir);
 
 namespace px {
 namespace carnot {
@@ -46,6 +51,11 @@ using udf::FunctionContext;
 // 3) non-time ordered full outer join (all batches from build first)
 // 4) non-time ordered no matches inner join
 // 5) non-time ordered many matches per key inner join
+// 6) grace hash join once over the memory budget, in memory and spilled to disk, including
+//    build rows that were hashed before the switch
+// 7) sort-merge left join over inputs sorted by time
+// 8) sort-merge join over unsorted inputs, which falls back to a hash join, or fails once rows have
+//    been joined
 
 class JoinNodeTest : public ::testing::Test {
  public:
@@ -686,6 +696,314 @@ TEST_F(JoinNodeTest, unordered_many_matches) {
       .Close();
 }
 
+// Inner join on a single key, so that all the output rows come from the same grace partition.
+constexpr char kGraceJoinProto[] = R"(
+  type: INNER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 0
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 1
+  }
+  column_names: "left_1"
+  column_names: "right_1"
+  rows_per_batch: 10
+)";
+
+void RunGraceJoin(ExecState* exec_state) {
+  // Left table input: [left_0:Int64, left_1:Int64]
+  // Right table input: [right_0:Int64, right_1:Int64]
+  // Output table: [left_1:Int64, right_1:Int64]
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(kGraceJoinProto);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd, input_rd}, exec_state);
+
+  tester
+      // Build(left) table, goes over the budget.
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .AddColumn<types::Int64Value>({10, 20, 30})
+                       .get(),
+                   0, 0)
+      // Probe(right) table
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1})
+                       .AddColumn<types::Int64Value>({100, 101})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 4})
+                       .AddColumn<types::Int64Value>({11, 40})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 1})
+                       .AddColumn<types::Int64Value>({500, 102})
+                       .get(),
+                   1, 1)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, 6, true, true)
+                                .AddColumn<types::Int64Value>({10, 11, 10, 11, 10, 11})
+                                .AddColumn<types::Int64Value>({100, 100, 101, 101, 102, 102})
+                                .get(),
+                            1)
+      .Close();
+}
+
+TEST_F(JoinNodeTest, grace_hash_join_in_memory) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_equijoin_memory_budget_bytes = 1;
+  FLAGS_equijoin_spill_dir = "";
+  RunGraceJoin(exec_state_.get());
+}
+
+TEST_F(JoinNodeTest, grace_hash_join_spilled) {
+  gflags::FlagSaver flag_saver;
+  px::testing::TempDir spill_dir;
+  FLAGS_equijoin_memory_budget_bytes = 1;
+  FLAGS_equijoin_spill_dir = spill_dir.path().string();
+  RunGraceJoin(exec_state_.get());
+  // The spill files are removed once the join is closed.
+  EXPECT_TRUE(std::filesystem::is_empty(spill_dir.path()));
+}
+
+TEST_F(JoinNodeTest, grace_hash_join_rebuilds_hashed_build_rows) {
+  gflags::FlagSaver flag_saver;
+  px::testing::TempDir spill_dir;
+  FLAGS_equijoin_spill_dir = spill_dir.path().string();
+  // The first build batch is hashed under the budget, the second one pushes the join over it, so
+  // the rows of the build table are rebuilt into the grace partitions.
+  FLAGS_equijoin_memory_budget_bytes = 20;
+
+  // Left table input: [left_0:String (not read), left_1:Int64 (key and output)]
+  // Right table input: [right_0:Int64, right_1:Int64]
+  // Output table: [left_1:Int64, right_1:Int64]
+  RowDescriptor left_rd({types::DataType::STRING, types::DataType::INT64});
+  RowDescriptor right_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(R"(
+    type: INNER
+    equality_conditions {
+      left_column_index: 1
+      right_column_index: 0
+    }
+    output_columns: {
+      parent_index: 0
+      column_index: 1
+    }
+    output_columns: {
+      parent_index: 1
+      column_index: 1
+    }
+    column_names: "left_1"
+    column_names: "right_1"
+  )");
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {left_rd, right_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(left_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"a", "b"})
+                       .AddColumn<types::Int64Value>({7, 7})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(left_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::StringValue>({"c", "d"})
+                       .AddColumn<types::Int64Value>({8, 7})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(right_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({7, 9})
+                       .AddColumn<types::Int64Value>({70, 90})
+                       .get(),
+                   1, 1)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, 3, true, true)
+                                .AddColumn<types::Int64Value>({7, 7, 7})
+                                .AddColumn<types::Int64Value>({70, 70, 70})
+                                .get(),
+                            1)
+      .Close();
+}
+
+TEST_F(JoinNodeTest, sort_merge_left_join) {
+  // Both inputs are sorted by time, the build side emits its unmatched rows as soon as the probe
+  // side has moved past them.
+  // Left table input: [time_:Time64NS, left_1:Int64]
+  // Right table input: [time_:Time64NS, right_1:Int64]
+  // Output table: [left_1:Int64, right_1:Int64]
+  const char* proto = R"(
+  type: LEFT_OUTER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 0
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 1
+  }
+  column_names: "left_1"
+  column_names: "right_1"
+  rows_per_batch: 2
+  inputs_sorted_by_key: true
+)";
+
+  RowDescriptor input_rd({types::DataType::TIME64NS, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(proto);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd, input_rd}, exec_state_.get());
+
+  tester
+      // Build(left) table
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({10, 20, 30})
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .get(),
+                   0, 0)
+      // Probe(right) table, only the rows before the last build key are joined.
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({10, 10, 30, 40})
+                       .AddColumn<types::Int64Value>({100, 101, 102, 103})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({40, 50})
+                       .AddColumn<types::Int64Value>({4, 5})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<types::Int64Value>({1, 1})
+                          .AddColumn<types::Int64Value>({100, 101})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Time64NSValue>({50, 60})
+                       .AddColumn<types::Int64Value>({104, 105})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Time64NSValue>({60, 70})
+                       .AddColumn<types::Int64Value>({6, 7})
+                       .get(),
+                   0, 4)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<types::Int64Value>({3, 4})
+                          .AddColumn<types::Int64Value>({102, 103})
+                          .get())
+      // Build row 20 was evicted with no match once the probe side reached 40.
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<types::Int64Value>({2, 5})
+                          .AddColumn<types::Int64Value>({0, 104})
+                          .get())
+      // The last probe rows are flushed before the remaining unmatched build rows.
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, false, false)
+                          .AddColumn<types::Int64Value>({6})
+                          .AddColumn<types::Int64Value>({105})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::Int64Value>({7})
+                          .AddColumn<types::Int64Value>({0})
+                          .get())
+      .Close();
+}
+
+constexpr char kSortMergeInnerJoin[] = R"(
+  type: INNER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 0
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 1
+  }
+  column_names: "left_1"
+  column_names: "right_1"
+  rows_per_batch: 10
+  inputs_sorted_by_key: true
+)";
+
+TEST_F(JoinNodeTest, sort_merge_falls_back_to_hash_join) {
+  // The build (left) side goes backwards before any row is joined, so the join switches to the
+  // hash mode and still finds every match.
+  RowDescriptor input_rd({types::DataType::TIME64NS, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(kSortMergeInnerJoin);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd, input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({10, 30})
+                       .AddColumn<types::Int64Value>({1, 3})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Time64NSValue>({20, 40})
+                       .AddColumn<types::Int64Value>({2, 4})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Time64NSValue>({10, 20, 30, 40})
+                       .AddColumn<types::Int64Value>({100, 101, 102, 103})
+                       .get(),
+                   1, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                          .AddColumn<types::Int64Value>({100, 101, 102, 103})
+                          .get(),
+                      true)
+      .Close();
+}
+
+TEST_F(JoinNodeTest, sort_merge_fails_on_unsorted_input_after_joining) {
+  // Once probe rows have been joined, a build key going backwards could have matched them, so the
+  // join fails rather than drop the matches.
+  RowDescriptor input_rd({types::DataType::TIME64NS, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(kSortMergeInnerJoin);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd, input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({10, 20})
+                       .AddColumn<types::Int64Value>({1, 2})
+                       .get(),
+                   0, 0)
+      // Probe row 10 is joined, since the build side has moved past it.
+      .ConsumeNext(RowBatchBuilder(input_rd, 1, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({10})
+                       .AddColumn<types::Int64Value>({100})
+                       .get(),
+                   1, 0);
+  auto unsorted_rb = RowBatchBuilder(input_rd, 1, /*eow*/ false, /*eos*/ false)
+                         .AddColumn<types::Time64NSValue>({10})
+                         .AddColumn<types::Int64Value>({5})
+                         .get();
+  EXPECT_NOT_OK(tester.node()->ConsumeNext(exec_state_.get(), unsorted_rb, 0));
+  tester.Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -22,6 +22,8 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "src/carnot/exec/agg_node.h"
 #include "src/carnot/exec/empty_source_node.h"
@@ -36,6 +38,8 @@
 #include "src/carnot/exec/memory_sink_node.h"
 #include "src/carnot/exec/memory_source_node.h"
 #include "src/carnot/exec/otel_export_sink_node.h"
+#include "src/carnot/exec/parallel_pipeline.h"
+#include "src/carnot/exec/topk_node.h"
 #include "src/carnot/exec/udtf_source_node.h"
 #include "src/carnot/exec/union_node.h"
 #include "src/carnot/plan/operators.h"
@@ -52,17 +56,20 @@ using table_store::schema::RowDescriptor;
 Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
                             ExecState* exec_state, plan::PlanFragment* pf,
                             bool collect_exec_node_stats,
-                            int32_t consecutive_generate_calls_per_source) {
+                            int32_t consecutive_generate_calls_per_source,
+                            int32_t num_exec_threads) {
   plan_state_ = plan_state;
   schema_ = schema;
   pf_ = pf;
   exec_state_ = exec_state;
   collect_exec_node_stats_ = collect_exec_node_stats;
   consecutive_generate_calls_per_source_ = consecutive_generate_calls_per_source;
+  num_exec_threads_ = num_exec_threads;
+  exec_state_->set_num_exec_threads(num_exec_threads);
 
   std::unordered_map<int64_t, ExecNode*> nodes;
   std::unordered_map<int64_t, RowDescriptor> descriptors;
-  return plan::PlanFragmentWalker()
+  PL_RETURN_IF_ERROR(plan::PlanFragmentWalker()
       .OnMap([&](auto& node) {
         return OnOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
       })
@@ -81,6 +88,9 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
       .OnLimit([&](auto& node) {
         return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
       })
+      .OnTopK([&](auto& node) {
+        return OnOperatorImpl<plan::TopKOperator, TopKNode>(node, &descriptors);
+      })
       .OnUnion([&](auto& node) {
         return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
       })
@@ -108,7 +118,129 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
       .OnOTelSink([&](auto& node) {
         return OnOperatorImpl<plan::OTelExportSinkOperator, OTelExportSinkNode>(node, &descriptors);
       })
-      .Walk(pf_);
+      .Walk(pf_));
+
+  if (num_exec_threads_ > 1) {
+    morsel_pool_ = std::make_unique<MorselWorkerPool>(num_exec_threads_);
+    exec_state_->set_morsel_pool(morsel_pool_.get());
+    PL_RETURN_IF_ERROR(ParallelizePipelines(descriptors));
+  }
+  return Status::OK();
+}
+
+StatusOr<ExecNode*> ExecutionGraph::CreateReplica(
+    int64_t node_id, const std::unordered_map<int64_t, RowDescriptor>& descriptors) {
+  const plan::Operator* op = pf_->nodes().at(node_id).get();
+  ExecNode* replica;
+  switch (op->op_type()) {
+    case planpb::MAP_OPERATOR:
+      replica = pool_.Add(new MapNode());
+      break;
+    case planpb::FILTER_OPERATOR:
+      replica = pool_.Add(new FilterNode());
+      break;
+    default:
+      return error::Internal("Can't replicate $0 for parallel execution", op->DebugString());
+  }
+  std::vector<RowDescriptor> input_descriptors;
+  for (int64_t parent_id : pf_->dag().ParentsOf(node_id)) {
+    input_descriptors.push_back(descriptors.at(parent_id));
+  }
+  PL_RETURN_IF_ERROR(replica->Init(*op, descriptors.at(node_id), std::move(input_descriptors),
+                                   collect_exec_node_stats_));
+  replica_nodes_.emplace_back(node_id, replica);
+  return replica;
+}
+
+Status ExecutionGraph::ParallelizePipelines(
+    const std::unordered_map<int64_t, RowDescriptor>& descriptors) {
+  const auto& dag = pf_->dag();
+  auto is_stateless = [this](int64_t node_id) {
+    auto op_type = pf_->nodes().at(node_id)->op_type();
+    return op_type == planpb::MAP_OPERATOR || op_type == planpb::FILTER_OPERATOR;
+  };
+  auto is_breaker = [this](int64_t node_id) {
+    auto op_type = pf_->nodes().at(node_id)->op_type();
+    return op_type == planpb::AGGREGATE_OPERATOR || op_type == planpb::JOIN_OPERATOR;
+  };
+
+  for (int64_t source_id : sources_) {
+    // Follow the chain of stateless nodes below the source, stopping at any fan-out.
+    std::vector<int64_t> chain;
+    auto children = dag.DependenciesOf(source_id);
+    while (children.size() == 1 && is_stateless(children[0]) &&
+           dag.ParentsOf(children[0]).size() == 1) {
+      chain.push_back(children[0]);
+      children = dag.DependenciesOf(children[0]);
+    }
+    if (chain.empty() || children.size() != 1 || !is_breaker(children[0])) {
+      continue;
+    }
+    ExecNode* source = nodes_.at(source_id);
+    ExecNode* breaker = nodes_.at(children[0]);
+    auto breaker_parents = dag.ParentsOf(children[0]);
+    size_t breaker_parent_idx =
+        std::find(breaker_parents.begin(), breaker_parents.end(), chain.back()) -
+        breaker_parents.begin();
+    const auto& tail_descriptor = descriptors.at(chain.back());
+
+    if (pf_->nodes().at(children[0])->op_type() == planpb::JOIN_OPERATOR) {
+      // The morsels are merged in the order they finish, so the join input is no longer sorted.
+      static_cast<EquijoinNode*>(breaker)->DisableSortMerge();
+    }
+
+    // The first replica is made of the original nodes, so that they still hold the stats of the
+    // pipeline, and the rest are copies.
+    std::vector<ExecNode*> replica_heads;
+    for (int32_t worker = 0; worker < num_exec_threads_; ++worker) {
+      ExecNode* head = nullptr;
+      ExecNode* tail = nullptr;
+      for (int64_t node_id : chain) {
+        ExecNode* node = nodes_.at(node_id);
+        if (worker > 0) {
+          PL_ASSIGN_OR_RETURN(node, CreateReplica(node_id, descriptors));
+          if (tail != nullptr) {
+            tail->AddChild(node, 0);
+          }
+        }
+        if (head == nullptr) {
+          head = node;
+        }
+        tail = node;
+      }
+
+      auto merge = pool_.Add(new MorselMergeNode(&merge_lock_));
+      merge->Init(tail_descriptor, {tail_descriptor}, collect_exec_node_stats_);
+      merge->AddChild(breaker, breaker_parent_idx);
+      pipeline_nodes_.push_back(merge);
+      if (worker == 0) {
+        if (!tail->ReplaceChild(breaker, merge)) {
+          return error::Internal("Node $0 is not a child of node $1", children[0], chain.back());
+        }
+      } else {
+        tail->AddChild(merge, 0);
+      }
+      replica_heads.push_back(head);
+    }
+
+    const auto& source_descriptor = descriptors.at(source_id);
+    auto dispatch = pool_.Add(new MorselDispatchNode(morsel_pool_.get(), replica_heads));
+    dispatch->Init(source_descriptor, {source_descriptor}, collect_exec_node_stats_);
+    pipeline_nodes_.push_back(dispatch);
+    if (!source->ReplaceChild(replica_heads[0], dispatch)) {
+      return error::Internal("Node $0 is not a child of node $1", chain.front(), source_id);
+    }
+    VLOG(1) << absl::Substitute("Running $0 nodes below source $1 on $2 threads", chain.size(),
+                                source_id, num_exec_threads_);
+  }
+  return Status::OK();
+}
+
+Status ExecutionGraph::WaitForMorsels() {
+  if (morsel_pool_ == nullptr) {
+    return Status::OK();
+  }
+  return morsel_pool_->Wait();
 }
 
 bool ExecutionGraph::YieldWithTimeout() {
@@ -214,6 +346,9 @@ Status ExecutionGraph::ExecuteSources() {
         }
         PL_RETURN_IF_ERROR(source->GenerateNext(exec_state_));
       }
+      // Finish this source's morsels before running anything else, so that the rest of the graph
+      // is only run by the workers while they're being processed.
+      PL_RETURN_IF_ERROR(WaitForMorsels());
 
       // keep_running will be set to false when a downstream limit for this particular
       // source (set in exec_state) has been reached.
@@ -298,6 +433,10 @@ Status ExecutionGraph::Execute() {
   // Get vector of nodes.
   std::vector<ExecNode*> nodes(nodes_.size());
   transform(nodes_.begin(), nodes_.end(), nodes.begin(), [](auto pair) { return pair.second; });
+  for (const auto& [node_id, replica] : replica_nodes_) {
+    nodes.push_back(replica);
+  }
+  nodes.insert(nodes.end(), pipeline_nodes_.begin(), pipeline_nodes_.end());
 
   for (auto node : nodes) {
     PL_RETURN_IF_ERROR(node->Prepare(exec_state_));
@@ -310,6 +449,11 @@ Status ExecutionGraph::Execute() {
   // We don't PL_RETURN_IF_ERROR here because we want to make sure we close all of our
   // nodes, even if there was an error during execution.
   Status source_status = ExecuteSources();
+  // Make sure no morsels are still running if execution stopped early.
+  Status morsel_status = WaitForMorsels();
+  if (source_status.ok()) {
+    source_status = morsel_status;
+  }
   Status close_status = Status::OK();
 
   for (auto node : nodes) {
@@ -324,6 +468,11 @@ Status ExecutionGraph::Execute() {
     }
   }
 
+  // Report the replicas of parallel pipelines as part of the nodes they were copied from.
+  for (const auto& [node_id, replica] : replica_nodes_) {
+    nodes_.at(node_id)->stats()->AddCounts(*replica->stats());
+  }
+
   if (!source_status.ok()) {
     return source_status;
   }
@@ -32,6 +32,7 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/memory_source_node.h"
+#include "src/carnot/exec/parallel_pipeline.h"
 #include "src/carnot/plan/plan_fragment.h"
 #include "src/carnot/plan/plan_state.h"
 #include "src/common/base/base.h"
@@ -51,6 +52,7 @@ struct ExecutionStats {
 constexpr std::chrono::milliseconds kDefaultYieldTimeoutMS{1000};
 constexpr std::chrono::milliseconds kDefaultUpstreamResultConnectionTimeout{5000};
 constexpr int32_t kDefaultConsecutiveGenerateCallsPerSource = 10;
+constexpr int32_t kDefaultExecThreads = 1;
 using SystemTimePoint = std::chrono::time_point<std::chrono::system_clock>;
 
 /**
@@ -83,11 +85,20 @@ class ExecutionGraph {
    * @param collect_exec_node_stats Whether or not to collect exec node stats.
    * @param consecutive_generate_calls_per_source how many times in a row to call GenerateNext
    * before switching to another available source.
+   * @param num_exec_threads the number of threads to run the stateless operators below each source
+   * on (see ParallelizePipelines). With 1 thread, the whole graph runs on the calling thread.
    * @return The status of whether initialization succeeded.
    */
   Status Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
               ExecState* exec_state, plan::PlanFragment* pf, bool collect_exec_node_stats,
-              int32_t consecutive_generate_calls_per_source);
+              int32_t consecutive_generate_calls_per_source, int32_t num_exec_threads);
+
+  Status Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
+              ExecState* exec_state, plan::PlanFragment* pf, bool collect_exec_node_stats,
+              int32_t consecutive_generate_calls_per_source) {
+    return Init(schema, plan_state, exec_state, pf, collect_exec_node_stats,
+                consecutive_generate_calls_per_source, kDefaultExecThreads);
+  }
 
   Status Init(table_store::schema::Schema* schema, plan::PlanState* plan_state,
               ExecState* exec_state, plan::PlanFragment* pf, bool collect_exec_node_stats) {
@@ -96,6 +107,10 @@ class ExecutionGraph {
   }
 
   ~ExecutionGraph() {
+    // The ExecState may outlive this graph (eg. it is shared by the plan fragments of a query).
+    if (morsel_pool_ != nullptr && exec_state_->morsel_pool() == morsel_pool_.get()) {
+      exec_state_->set_morsel_pool(nullptr);
+    }
     // We need to remove these GRPC source nodes from the GRPC router because the exec graph
     // gets destructed so that the GRPC router doesn't have stale pointers to those nodes.
     if (exec_state_->grpc_router() != nullptr) {
@@ -209,6 +224,21 @@ class ExecutionGraph {
 
   Status ExecuteSources();
 
+  /**
+   * Splits the graph into pipelines that can run on multiple threads. A pipeline is a chain of
+   * stateless operators (Map and Filter) between a source and a pipeline breaker (Agg or Join),
+   * whose result doesn't depend on the order of its input batches. Each pipeline is replicated
+   * once per thread, and the source's row batches (morsels) are spread over the replicas. The
+   * breaker and everything below it still run on a single thread at a time.
+   */
+  Status ParallelizePipelines(
+      const std::unordered_map<int64_t, table_store::schema::RowDescriptor>& descriptors);
+  StatusOr<ExecNode*> CreateReplica(
+      int64_t node_id,
+      const std::unordered_map<int64_t, table_store::schema::RowDescriptor>& descriptors);
+  // Waits for the morsels of all parallel pipelines to be processed.
+  Status WaitForMorsels();
+
   ExecState* exec_state_;
   ObjectPool pool_{"exec_graph_pool"};
   table_store::schema::Schema* schema_;
@@ -240,6 +270,16 @@ class ExecutionGraph {
   std::condition_variable execution_cv_;
   // Whether to collect stats on exec nodes.
   bool collect_exec_node_stats_;
+
+  int32_t num_exec_threads_ = kDefaultExecThreads;
+  // Nodes added by ParallelizePipelines, which aren't part of the plan fragment: replicas of plan
+  // nodes, keyed by the id of the replicated node, and the nodes splicing the replicas in.
+  std::vector<std::pair<int64_t, ExecNode*>> replica_nodes_;
+  std::vector<ExecNode*> pipeline_nodes_;
+  // Serializes the nodes below the parallel pipelines.
+  absl::Mutex merge_lock_;
+  // Declared after pool_, so that the workers are stopped before the nodes are destroyed.
+  std::unique_ptr<MorselWorkerPool> morsel_pool_;
 };
 
 }  // namespace exec
@@ -20,8 +20,10 @@
 
 #include <arrow/array.h>
 #include <arrow/memory_pool.h>
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -66,12 +68,23 @@ class MultiplyUDF : public udf::ScalarUDF {
   }
 };
 
+class SumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Float64Value arg) { sum_ = sum_.val + arg.val; }
+  void Merge(udf::FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
+  types::Float64Value Finalize(udf::FunctionContext*) { return sum_; }
+
+ protected:
+  types::Float64Value sum_ = 0;
+};
+
 class BaseExecGraphTest : public ::testing::Test {
  protected:
   void SetUpExecState() {
     func_registry_ = std::make_unique<udf::Registry>("test_registry");
     func_registry_->RegisterOrDie<AddUDF>("add");
     func_registry_->RegisterOrDie<MultiplyUDF>("multiply");
+    func_registry_->RegisterOrDie<SumUDA>("sum");
 
     auto table_store = std::make_shared<table_store::TableStore>();
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
@@ -208,6 +221,149 @@ std::vector<std::tuple<int32_t>> calls_to_execute = {
 INSTANTIATE_TEST_SUITE_P(ExecGraphExecuteTestSuite, ExecGraphExecuteTest,
                          ::testing::ValuesIn(calls_to_execute));
 
+class ParallelExecGraphTest : public ExecGraphTest,
+                              public ::testing::WithParamInterface<int32_t> {};
+
+TEST_P(ParallelExecGraphTest, filter_map_agg) {
+  int32_t num_threads = GetParam();
+
+  planpb::PlanFragment pf_pb;
+  ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kFilterMapAggPlanFragment, &pf_pb));
+  auto plan_fragment = std::make_shared<plan::PlanFragment>(1);
+  ASSERT_OK(plan_fragment->Init(pf_pb));
+  auto plan_state = std::make_unique<plan::PlanState>(func_registry_.get());
+  auto schema = std::make_shared<table_store::schema::Schema>();
+
+  table_store::schema::Relation rel(
+      {types::DataType::INT64, types::DataType::BOOLEAN, types::DataType::FLOAT64},
+      {"col1", "col2", "col3"});
+  auto table = Table::Create("test", rel);
+  // Enough batches to keep every worker busy. Values are whole numbers, so that the sum is exact
+  // in whatever order the batches are aggregated.
+  int64_t num_batches = 64;
+  int64_t rows_per_batch = 16;
+  double expected_sum = 0;
+  int64_t expected_rows = 0;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    std::vector<types::Int64Value> col1;
+    std::vector<types::BoolValue> col2;
+    std::vector<types::Float64Value> col3;
+    for (int64_t i = 0; i < rows_per_batch; ++i) {
+      int64_t row = batch * rows_per_batch + i;
+      col1.push_back(row);
+      col2.push_back(row % 3 == 0);
+      col3.push_back(2.0 * row);
+      if (row % 3 == 0) {
+        expected_sum += 3.0 * row;
+        ++expected_rows;
+      }
+    }
+    auto rb = RowBatch(RowDescriptor(rel.col_types()), rows_per_batch);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(col1, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(col2, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(col3, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+  }
+
+  auto table_store = std::make_shared<table_store::TableStore>();
+  table_store->AddTable("numbers", table);
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry_.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+  EXPECT_OK(exec_state->AddScalarUDF(
+      0, "add", std::vector<types::DataType>({types::DataType::INT64, types::DataType::FLOAT64})));
+  EXPECT_OK(exec_state->AddUDA(2, "sum", std::vector<types::DataType>({types::DataType::FLOAT64})));
+
+  ExecutionGraph e;
+  ASSERT_OK(e.Init(schema.get(), plan_state.get(), exec_state.get(), plan_fragment.get(),
+                   /* collect_exec_node_stats */ true, kDefaultConsecutiveGenerateCallsPerSource,
+                   num_threads));
+  ASSERT_OK(e.Execute());
+
+  auto output_table = exec_state->table_store()->GetTable("output");
+  table_store::Table::Cursor cursor(output_table);
+  std::vector<types::Float64Value> expected_out = {expected_sum};
+  EXPECT_TRUE(cursor.GetNextRowBatch({0}).ConsumeValueOrDie()->ColumnAt(0)->Equals(
+      types::ToArrow(expected_out, arrow::default_memory_pool())));
+
+  // The stats of all the replicas of the map are reported on the map node.
+  ASSERT_OK_AND_ASSIGN(auto map_node, e.node(3));
+  EXPECT_EQ(expected_rows, map_node->stats()->rows_output);
+  ASSERT_OK_AND_ASSIGN(auto filter_node, e.node(2));
+  EXPECT_EQ(num_batches * rows_per_batch, filter_node->stats()->rows_input);
+}
+
+TEST_P(ParallelExecGraphTest, filter_sort_merge_join) {
+  int32_t num_threads = GetParam();
+
+  planpb::PlanFragment pf_pb;
+  ASSERT_TRUE(
+      TextFormat::MergeFromString(planpb::testutils::kSortedFilterJoinPlanFragment, &pf_pb));
+  auto plan_fragment = std::make_shared<plan::PlanFragment>(1);
+  ASSERT_OK(plan_fragment->Init(pf_pb));
+  auto plan_state = std::make_unique<plan::PlanState>(func_registry_.get());
+  auto schema = std::make_shared<table_store::schema::Schema>();
+
+  // Both tables are sorted by time_, which the plan marks the join inputs as. With more than one
+  // thread, the filtered batches reach the join in the order the morsels finish.
+  table_store::schema::Relation rel({types::DataType::TIME64NS, types::DataType::BOOLEAN},
+                                    {"time_", "keep"});
+  int64_t num_batches = 64;
+  int64_t rows_per_batch = 16;
+  auto table_store = std::make_shared<table_store::TableStore>();
+  for (std::string_view name : {"left", "right"}) {
+    auto table = Table::Create(std::string(name), rel);
+    for (int64_t batch = 0; batch < num_batches; ++batch) {
+      std::vector<types::Time64NSValue> times;
+      std::vector<types::BoolValue> keep;
+      for (int64_t i = 0; i < rows_per_batch; ++i) {
+        int64_t row = batch * rows_per_batch + i;
+        times.push_back(row);
+        // The left side drops every third row.
+        keep.push_back(name == "right" || row % 3 != 0);
+      }
+      auto rb = RowBatch(RowDescriptor(rel.col_types()), rows_per_batch);
+      EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+      EXPECT_OK(rb.AddColumn(types::ToArrow(keep, arrow::default_memory_pool())));
+      EXPECT_OK(table->WriteRowBatch(rb));
+    }
+    table_store->AddTable(std::string(name), table);
+  }
+  std::vector<int64_t> expected_times;
+  for (int64_t row = 0; row < num_batches * rows_per_batch; ++row) {
+    if (row % 3 != 0) {
+      expected_times.push_back(row);
+    }
+  }
+
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry_.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
+      MockTraceStubGenerator, sole::uuid4(), nullptr);
+
+  ExecutionGraph e;
+  ASSERT_OK(e.Init(schema.get(), plan_state.get(), exec_state.get(), plan_fragment.get(),
+                   /* collect_exec_node_stats */ true, kDefaultConsecutiveGenerateCallsPerSource,
+                   num_threads));
+  ASSERT_OK(e.Execute());
+
+  auto output_table = exec_state->table_store()->GetTable("output");
+  table_store::Table::Cursor cursor(output_table);
+  std::vector<int64_t> times;
+  while (!cursor.Done()) {
+    auto rb = cursor.GetNextRowBatch({0}).ConsumeValueOrDie();
+    for (int64_t i = 0; i < rb->num_rows(); ++i) {
+      times.push_back(
+          types::GetValueFromArrowArray<types::DataType::TIME64NS>(rb->ColumnAt(0).get(), i));
+    }
+  }
+  // The join no longer relies on the input order, so every match is found.
+  std::sort(times.begin(), times.end());
+  EXPECT_EQ(expected_times, times);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelExecGraphTestSuite, ParallelExecGraphTest,
+                         ::testing::Values(1, 2, 4));
+
 TEST_F(ExecGraphTest, execute_time) {
   planpb::PlanFragment pf_pb;
   ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kLinearPlanFragment, &pf_pb));
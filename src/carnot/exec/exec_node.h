@@ -20,6 +20,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/exec/exec_state.h"
@@ -46,7 +47,7 @@ struct ExecNodeStats {
     }
     ++batches_output;
     bytes_output += rb.NumBytes();
-    rows_output += rb.num_rows();
+    rows_output += rb.num_selected_rows();
   }
 
   void AddInputStats(const table_store::schema::RowBatch& rb) {
@@ -55,7 +56,7 @@ struct ExecNodeStats {
     }
     ++batches_input;
     bytes_input += rb.NumBytes();
-    rows_input += rb.num_rows();
+    rows_input += rb.num_selected_rows();
   }
 
   void ResumeChildTimer() {
@@ -99,6 +100,19 @@ struct ExecNodeStats {
     extra_info[key] = value;
   }
 
+  /**
+   * Adds the input and output counts of another node's stats to these, eg. to report the replicas
+   * of a node run in parallel as a single node.
+   */
+  void AddCounts(const ExecNodeStats& other) {
+    bytes_input += other.bytes_input;
+    rows_input += other.rows_input;
+    batches_input += other.batches_input;
+    bytes_output += other.bytes_output;
+    rows_output += other.rows_output;
+    batches_output += other.batches_output;
+  }
+
   int64_t ChildExecTime() const { return children_timer.ElapsedTime_us() * 1000; }
   int64_t TotalExecTime() const { return total_timer.ElapsedTime_us() * 1000; }
   int64_t SelfExecTime() const { return TotalExecTime() - ChildExecTime(); }
@@ -146,11 +160,23 @@ class ExecNode {
               const table_store::schema::RowDescriptor& output_descriptor,
               std::vector<table_store::schema::RowDescriptor> input_descriptors,
               bool collect_exec_stats = false) {
+    Init(output_descriptor, std::move(input_descriptors), collect_exec_stats);
+    return InitImpl(plan_node);
+  }
+
+  /**
+   * Init for nodes that aren't created from a plan operator, such as the nodes that the
+   * ExecutionGraph adds to run pipelines in parallel. InitImpl is not called.
+   * @param output_descriptor The output column schema of row batches.
+   * @param input_descriptors The input column schema of row batches.
+   */
+  void Init(const table_store::schema::RowDescriptor& output_descriptor,
+            std::vector<table_store::schema::RowDescriptor> input_descriptors,
+            bool collect_exec_stats = false) {
     is_initialized_ = true;
     output_descriptor_ = std::make_unique<table_store::schema::RowDescriptor>(output_descriptor);
-    input_descriptors_ = input_descriptors;
+    input_descriptors_ = std::move(input_descriptors);
     stats_ = std::make_unique<ExecNodeStats>(collect_exec_stats);
-    return InitImpl(plan_node);
   }
 
   /**
@@ -262,6 +288,22 @@ class ExecNode {
     parent_ids_for_children_.emplace_back(parent_index);
   }
 
+  /**
+   * Replace a child node with another node, which receives the same parent index.
+   * @param child The current child.
+   * @param new_child The node to forward data to instead.
+   * @return whether `child` was found.
+   */
+  bool ReplaceChild(ExecNode* child, ExecNode* new_child) {
+    for (auto& c : children_) {
+      if (c == child) {
+        c = new_child;
+        return true;
+      }
+    }
+    return false;
+  }
+
   /**
    * Get the type of the execution node.
    * @return the ExecNodeType.
@@ -275,6 +317,12 @@ class ExecNode {
 
   ExecNodeStats* stats() const { return stats_.get(); }
 
+  /**
+   * Whether the node can consume row batches that have a selection vector. Other nodes are sent
+   * a copy of the batch with only the selected rows.
+   */
+  virtual bool AcceptsSelectionVectors() const { return false; }
+
  protected:
   /**
    * Send data to children row batches.
@@ -284,8 +332,18 @@ class ExecNode {
    */
   Status SendRowBatchToChildren(ExecState* exec_state, const table_store::schema::RowBatch& rb) {
     stats_->ResumeChildTimer();
+    // Children that don't accept selection vectors get a materialized copy, made at most once.
+    std::unique_ptr<table_store::schema::RowBatch> materialized_rb;
     for (size_t i = 0; i < children_.size(); ++i) {
-      PL_RETURN_IF_ERROR(children_[i]->ConsumeNext(exec_state, rb, parent_ids_for_children_[i]));
+      const table_store::schema::RowBatch* child_rb = &rb;
+      if (rb.HasSelection() && !children_[i]->AcceptsSelectionVectors()) {
+        if (materialized_rb == nullptr) {
+          PL_ASSIGN_OR_RETURN(materialized_rb, rb.Materialize());
+        }
+        child_rb = materialized_rb.get();
+      }
+      PL_RETURN_IF_ERROR(
+          children_[i]->ConsumeNext(exec_state, *child_rb, parent_ids_for_children_[i]));
     }
     stats_->StopChildTimer();
     stats_->AddOutputStats(rb);
@@ -26,6 +26,7 @@
 #include <utility>
 #include <vector>
 
+#include <absl/synchronization/mutex.h>
 #include <sole.hpp>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
@@ -34,6 +35,7 @@
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
 #include "src/shared/metadata/metadata_state.h"
+#include "src/table_store/schema/row_batch.h"
 #include "src/table_store/table/table_store.h"
 
 #include "opentelemetry/proto/collector/metrics/v1/metrics_service.grpc.pb.h"
@@ -44,6 +46,8 @@ namespace px {
 namespace carnot {
 namespace exec {
 
+class MorselWorkerPool;
+
 using ResultSinkStubGenerator =
     std::function<std::unique_ptr<carnotpb::ResultSinkService::StubInterface>(
         const std::string& address, const std::string& ssl_targetname)>;
@@ -170,14 +174,21 @@ class ExecState {
 
   // A node (ie. Limit) can call this method to say no more records will be processed for this
   // source. That node is responsible for setting eos.
-  void StopSource(int64_t src_id) { source_id_to_keep_running_map_[src_id] = false; }
+  // This can be called from the worker threads of parallel pipelines, while the execution graph
+  // checks keep_running().
+  void StopSource(int64_t src_id) {
+    absl::MutexLock lock(&keep_running_lock_);
+    source_id_to_keep_running_map_[src_id] = false;
+  }
 
   bool keep_running() {
     DCHECK(current_source_set_);
+    absl::MutexLock lock(&keep_running_lock_);
     return source_id_to_keep_running_map_[current_source_];
   }
 
   void SetCurrentSource(int64_t source_id) {
+    absl::MutexLock lock(&keep_running_lock_);
     current_source_ = source_id;
     current_source_set_ = true;
     if (source_id_to_keep_running_map_.find(current_source_) ==
@@ -192,6 +203,29 @@ class ExecState {
 
   GRPCRouter* grpc_router() { return grpc_router_; }
 
+  // The number of threads the query may use to execute a plan fragment. Nodes that split up their
+  // own work (eg. AggNode) partition it by this.
+  int32_t num_exec_threads() const { return num_exec_threads_; }
+  void set_num_exec_threads(int32_t num_exec_threads) { num_exec_threads_ = num_exec_threads; }
+
+  // The worker pool of the ExecutionGraph, shared by the parallel pipelines and the nodes that
+  // split up their own work, so that a query never runs more than num_exec_threads workers. Null
+  // if the query runs on a single thread.
+  MorselWorkerPool* morsel_pool() const { return morsel_pool_; }
+  void set_morsel_pool(MorselWorkerPool* morsel_pool) { morsel_pool_ = morsel_pool; }
+
+  // Whether GRPCSinkNodes send row batches to other agents in the columnar format, and how they
+  // encode them. Sinks that send results to the query broker always use RowBatchData.
+  bool columnar_transfer() const { return columnar_transfer_; }
+  const table_store::schema::RowBatch::ColumnarEncodingOptions& columnar_encoding_opts() const {
+    return columnar_encoding_opts_;
+  }
+  void set_columnar_transfer(bool columnar_transfer,
+                             table_store::schema::RowBatch::ColumnarEncodingOptions opts) {
+    columnar_transfer_ = columnar_transfer;
+    columnar_encoding_opts_ = opts;
+  }
+
   void AddAuthToGRPCClientContext(grpc::ClientContext* ctx) {
     CHECK(add_auth_to_grpc_client_context_func_);
     add_auth_to_grpc_client_context_func_(ctx);
@@ -210,10 +244,15 @@ class ExecState {
   ml::ModelPool* model_pool_;
   GRPCRouter* grpc_router_ = nullptr;
   std::function<void(grpc::ClientContext*)> add_auth_to_grpc_client_context_func_;
+  int32_t num_exec_threads_ = 1;
+  MorselWorkerPool* morsel_pool_ = nullptr;
+  bool columnar_transfer_ = false;
+  table_store::schema::RowBatch::ColumnarEncodingOptions columnar_encoding_opts_;
 
+  absl::Mutex keep_running_lock_;
   int64_t current_source_ = 0;
   bool current_source_set_ = false;
-  std::map<int64_t, bool> source_id_to_keep_running_map_;
+  std::map<int64_t, bool> source_id_to_keep_running_map_ ABSL_GUARDED_BY(keep_running_lock_);
 
   std::vector<std::unique_ptr<carnotpb::ResultSinkService::StubInterface>> result_sink_stubs_pool_;
   // Mapping of remote address to stub that serves that address.
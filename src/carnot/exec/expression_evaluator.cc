@@ -26,6 +26,7 @@
 #include <iterator>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <vector>
 
 #include <absl/strings/str_join.h>
@@ -53,7 +54,6 @@ using types::DataTypeTraits;
 using types::Float64ValueColumnWrapper;
 using types::GetArrowBuilder;
 using types::Int64ValueColumnWrapper;
-using types::MakeArrowBuilder;
 using types::SharedColumnWrapper;
 using types::StringValueColumnWrapper;
 using types::Time64NSValueColumnWrapper;
@@ -133,6 +133,21 @@ std::shared_ptr<ColumnWrapper> EvalScalarToColumnWrapper(ExecState*, const plan:
   }
 }
 
+StatusOr<std::vector<int64_t>> InputColumnsOf(const plan::ConstScalarExpressionVector& exprs) {
+  std::set<int64_t> col_idxs;
+  plan::ExpressionWalker<int> walker;
+  walker.OnColumn([&](const plan::Column& col, const std::vector<int>&) -> int {
+    col_idxs.insert(col.Index());
+    return 0;
+  });
+  walker.OnScalarValue([](const plan::ScalarValue&, const std::vector<int>&) -> int { return 0; });
+  walker.OnScalarFunc([](const plan::ScalarFunc&, const std::vector<int>&) -> int { return 0; });
+  for (const auto& expr : exprs) {
+    PL_RETURN_IF_ERROR(walker.Walk(*expr));
+  }
+  return std::vector<int64_t>(col_idxs.begin(), col_idxs.end());
+}
+
 Status ScalarExpressionEvaluator::Evaluate(ExecState* exec_state, const RowBatch& input,
                                            RowBatch* output) {
   CHECK(exec_state != nullptr);
@@ -320,18 +335,14 @@ Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
         auto def = exec_state->GetScalarUDFDefinition(fn.udf_id());
         auto udf = id_to_udf_map_[fn.udf_id()].get();
 
-        auto output = MakeArrowBuilder(def->exec_return_type(), arrow::default_memory_pool());
-
         std::vector<arrow::Array*> raw_children;
         raw_children.reserve(children.size());
         for (const auto& child : children) {
           raw_children.push_back(child.get());
         }
 
-        PL_CHECK_OK(def->ExecBatchArrow(udf, function_ctx_, raw_children, output.get(), num_rows));
-
         std::shared_ptr<arrow::Array> output_array;
-        PL_CHECK_OK(output->Finish(&output_array));
+        PL_CHECK_OK(def->ExecBatchArrow(udf, function_ctx_, raw_children, &output_array, num_rows));
         return output_array;
       });
 
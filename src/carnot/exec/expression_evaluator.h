@@ -45,6 +45,11 @@ std::shared_ptr<types::ColumnWrapper> EvalScalarToColumnWrapper(ExecState*,
                                                                 const plan::ScalarValue& val,
                                                                 size_t count);
 
+/**
+ * @return the indexes of the input columns read by the expressions, in increasing order.
+ */
+StatusOr<std::vector<int64_t>> InputColumnsOf(const plan::ConstScalarExpressionVector& exprs);
+
 /**
  * Base expression evaluator class.
  */
@@ -29,6 +29,7 @@
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
 #include "src/carnot/exec/test_utils.h"
+#include "src/carnot/funcs/builtins/math_ops.h"
 #include "src/carnot/plan/plan_state.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/planpb/plan.pb.h"
@@ -69,9 +70,12 @@ class AddUDF : public ScalarUDF {
   Int64Value Exec(FunctionContext*, Int64Value v1, Int64Value v2) { return v1.val + v2.val; }
 };
 
+// When batch_udf is set, add is the builtin add which is evaluated a batch at a time, instead of
+// the AddUDF above which is evaluated a row at a time.
 // NOLINTNEXTLINE : runtime/references.
 void BM_ScalarExpressionTwoCols(benchmark::State& state,
-                                const ScalarExpressionEvaluatorType& eval_type, const char* pbtxt) {
+                                const ScalarExpressionEvaluatorType& eval_type, const char* pbtxt,
+                                bool batch_udf = false) {
   px::carnot::planpb::ScalarExpression se_pb;
   size_t data_size = state.range(0);
 
@@ -82,7 +86,11 @@ void BM_ScalarExpressionTwoCols(benchmark::State& state,
 
   auto func_registry = std::make_unique<Registry>("test_registry");
   auto table_store = std::make_shared<px::table_store::TableStore>();
-  PL_CHECK_OK(func_registry->Register<AddUDF>("add"));
+  if (batch_udf) {
+    PL_CHECK_OK(func_registry->Register<px::carnot::builtins::AddUDF<Int64Value>>("add"));
+  } else {
+    PL_CHECK_OK(func_registry->Register<AddUDF>("add"));
+  }
   auto exec_state = std::make_unique<ExecState>(
       func_registry.get(), table_store, MockResultSinkStubGenerator, MockMetricsStubGenerator,
       MockTraceStubGenerator, sole::uuid4(), nullptr);
@@ -149,3 +157,12 @@ BENCHMARK_CAPTURE(BM_ScalarExpressionTwoCols, two_cols_simple_add_vector,
                   ScalarExpressionEvaluatorType::kVectorNative, kAddScalarFuncNestedPbtxt)
     ->RangeMultiplier(2)
     ->Range(1, 1 << 16);
+
+BENCHMARK_CAPTURE(BM_ScalarExpressionTwoCols, two_cols_add_nested_batch_udf_arrow,
+                  ScalarExpressionEvaluatorType::kArrowNative, kAddScalarFuncNestedPbtxt, true)
+    ->RangeMultiplier(2)
+    ->Range(1, 1 << 16);
+BENCHMARK_CAPTURE(BM_ScalarExpressionTwoCols, two_cols_add_nested_batch_udf_native,
+                  ScalarExpressionEvaluatorType::kVectorNative, kAddScalarFuncNestedPbtxt, true)
+    ->RangeMultiplier(2)
+    ->Range(1, 1 << 16);
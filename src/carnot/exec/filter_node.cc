@@ -22,6 +22,7 @@
 #include <arrow/array/builder_binary.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -55,6 +56,7 @@ Status FilterNode::InitImpl(const plan::Operator& plan_node) {
   const auto* filter_plan_node = static_cast<const plan::FilterOperator*>(&plan_node);
   // copy the plan node to local object;
   plan_node_ = std::make_unique<plan::FilterOperator>(*filter_plan_node);
+  PL_ASSIGN_OR_RETURN(predicate_cols_, InputColumnsOf({plan_node_->expression()}));
   return Status::OK();
 }
 
@@ -75,95 +77,48 @@ Status FilterNode::CloseImpl(ExecState* exec_state) {
   return Status::OK();
 }
 
-template <types::DataType T>
-Status PredicateCopyValues(const types::BoolValueColumnWrapper& pred, const arrow::Array* input_col,
-                           RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
-  auto output_col_builder_generic = MakeArrowBuilder(T, arrow::default_memory_pool());
-  auto* output_col_builder = static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(
-      output_col_builder_generic.get());
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, idx));
-    }
-  }
-  std::shared_ptr<arrow::Array> output_array;
-  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
-  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
-  return Status::OK();
-}
-
-template <>
-Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& pred,
-                                          const arrow::Array* input_col, RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
-  size_t reserved =
-      100;  // This can be an arbritrary number, since we do exponential doubling below.
-  size_t total_size = 0;
-
-  auto output_col_builder_generic = MakeArrowBuilder(types::STRING, arrow::default_memory_pool());
-  auto* output_col_builder = static_cast<types::DataTypeTraits<types::STRING>::arrow_builder_type*>(
-      output_col_builder_generic.get());
-
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      auto res = types::GetValueFromArrowArray<types::STRING>(input_col, idx);
-      total_size += res.size();
-      while (total_size >= reserved) {
-        reserved *= 2;
-      }
-      PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-      output_col_builder->UnsafeAppend(std::move(res));
-    }
-  }
-  std::shared_ptr<arrow::Array> output_array;
-  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
-  PL_RETURN_IF_ERROR(output_rb->AddColumn(output_array));
-  return Status::OK();
-}
-
 Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
   // Current implementation does not merge across row batches, we should
   // consider this for cases where the filter has really low selectivity.
+  const RowBatch* pred_rb = &rb;
+  std::unique_ptr<RowBatch> gathered_rb;
+  // The predicate is evaluated on every row of the input's arrays, so a function must only see
+  // the rows selected by an earlier filter (see MapNode::ConsumeNextImpl). Only the columns the
+  // predicate reads are gathered, the output still shares all of the input's arrays.
+  bool gathered = rb.HasSelection() &&
+                  plan_node_->expression()->ExpressionType() == plan::Expression::kFunc;
+  if (gathered) {
+    PL_ASSIGN_OR_RETURN(gathered_rb, rb.Materialize(predicate_cols_));
+    pred_rb = gathered_rb.get();
+  }
   PL_ASSIGN_OR_RETURN(auto pred_col, evaluator_->EvaluateSingleExpression(
-                                         exec_state, rb, *plan_node_->expression()));
+                                         exec_state, *pred_rb, *plan_node_->expression()));
 
   // Verify that the type of the column is boolean.
   DCHECK_EQ(pred_col->data_type(), types::BOOLEAN) << "Predicate expression must be a boolean";
 
   const types::BoolValueColumnWrapper& pred_col_wrapper =
       *static_cast<types::BoolValueColumnWrapper*>(pred_col.get());
-  size_t num_pred = pred_col_wrapper.Size();
-
-  DCHECK_EQ(static_cast<size_t>(rb.num_rows()), num_pred);
-
-  // Find out how many of them returned true;
-  size_t num_output_records = 0;
-  for (size_t i = 0; i < num_pred; ++i) {
-    if (pred_col_wrapper[i].val) {
-      ++num_output_records;
+  DCHECK_EQ(static_cast<size_t>(pred_rb->num_rows()), pred_col_wrapper.Size());
+
+  // The output shares the input's arrays, and selects the rows that pass the predicate instead of
+  // copying them. If the input already has a selection, only its rows can be selected.
+  auto selection = std::make_shared<RowBatch::SelectionVector>();
+  selection->reserve(rb.num_selected_rows());
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    // The gathered predicate has one value per selected row.
+    if (pred_col_wrapper[gathered ? i : row_idx].val) {
+      selection->push_back(row_idx);
     }
   }
 
-  RowBatch output_rb(*output_descriptor_, num_output_records);
+  RowBatch output_rb(*output_descriptor_, rb.num_rows());
   DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
-
-  for (const auto& [output_col_idx, input_col_idx] : Enumerate(plan_node_->selected_cols())) {
-    auto input_col = rb.ColumnAt(input_col_idx);
-    auto col_type = output_descriptor_->type(output_col_idx);
-#define TYPE_CASE(_dt_) \
-  PL_RETURN_IF_ERROR(PredicateCopyValues<_dt_>(pred_col_wrapper, input_col.get(), &output_rb));
-    PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
-#undef TYPE_CASE
+  for (auto input_col_idx : plan_node_->selected_cols()) {
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
   }
-
+  output_rb.SetSelection(std::move(selection));
   output_rb.set_eow(rb.eow());
   output_rb.set_eos(rb.eos());
   PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
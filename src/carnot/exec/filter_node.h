@@ -41,6 +41,8 @@ class FilterNode : public ProcessingNode {
   FilterNode() = default;
   virtual ~FilterNode() = default;
 
+  bool AcceptsSelectionVectors() const override { return true; }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -54,6 +56,8 @@ class FilterNode : public ProcessingNode {
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  // The input columns read by the predicate.
+  std::vector<int64_t> predicate_cols_;
 };
 
 }  // namespace exec
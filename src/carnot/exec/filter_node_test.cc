@@ -140,6 +140,77 @@ TEST_F(FilterNodeTest, column_selection) {
       .Close();
 }
 
+TEST_F(FilterNodeTest, input_selection) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  RowBatchBuilder input_builder(input_rd, 4, /*eow*/ true, /*eos*/ true);
+  auto& input_rb = input_builder.AddColumn<types::Int64Value>({1, 1, 3, 4})
+                       .AddColumn<types::Int64Value>({1, 3, 6, 9})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get();
+  // Row 0 passes the filter but isn't part of the input's selection.
+  input_rb.SetSelection(std::make_shared<const RowBatch::SelectionVector>(
+      RowBatch::SelectionVector{1, 2, 3}));
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  tester.ConsumeNext(input_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::Int64Value>({1})
+                          .AddColumn<types::Int64Value>({3})
+                          .AddColumn<types::StringValue>({"DEF"})
+                          .get())
+      .Close();
+}
+
+// A child that accepts selection vectors, so that it sees the filter's output as is.
+class SelectionAcceptingMockNode : public MockExecNode {
+ public:
+  bool AcceptsSelectionVectors() const override { return true; }
+};
+
+TEST_F(FilterNodeTest, func_predicate_on_selection_shares_input_columns) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowBatchBuilder input_builder(rd, 4, /*eow*/ true, /*eos*/ true);
+  auto& input_rb = input_builder.AddColumn<types::Int64Value>({1, 1, 3, 4})
+                       .AddColumn<types::Int64Value>({1, 3, 6, 9})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get();
+  input_rb.SetSelection(std::make_shared<const RowBatch::SelectionVector>(
+      RowBatch::SelectionVector{1, 2, 3}));
+
+  FilterNode node;
+  SelectionAcceptingMockNode child;
+  node.AddChild(&child, 0);
+  ASSERT_OK(node.Init(*plan_node_, rd, {rd}));
+  ASSERT_OK(node.Prepare(exec_state_.get()));
+  ASSERT_OK(node.Open(exec_state_.get()));
+  EXPECT_CALL(child, InitImpl(_));
+  ASSERT_OK(child.Init(FakePlanNode(123), RowDescriptor({}), {rd}));
+
+  // Only the predicate's column is gathered to evaluate it on the selected rows. The output
+  // selects rows of the input's own arrays, rather than of gathered copies.
+  EXPECT_CALL(child, ConsumeNextImpl(_, _, _))
+      .WillOnce([&](ExecState*, const RowBatch& output_rb, size_t) {
+        for (int64_t i = 0; i < input_rb.num_columns(); ++i) {
+          EXPECT_EQ(input_rb.ColumnAt(i), output_rb.ColumnAt(i));
+        }
+        EXPECT_TRUE(output_rb.HasSelection());
+        EXPECT_EQ(RowBatch::SelectionVector{1}, *output_rb.selection());
+        return Status::OK();
+      });
+  ASSERT_OK(node.ConsumeNext(exec_state_.get(), input_rb, 0));
+  EXPECT_OK(node.Close(exec_state_.get()));
+}
+
 TEST_F(FilterNodeTest, zero_row_row_batch) {
   auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
   plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/flat_key.h"
+
+#include <farmhash.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "src/common/base/hash_utils.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+template <types::DataType DT>
+uint32_t FixedWidth() {
+  if constexpr (DT == types::DataType::STRING) {
+    // Strings store their length in the prefix.
+    return sizeof(uint32_t);
+  } else {
+    return sizeof(types::DataTypeTraits<DT>::value_type::val);
+  }
+}
+
+}  // namespace
+
+FlatKey FlatKeyArena::Add(const FlatKey& key) {
+  if (block_offset_ + key.size > block_size_) {
+    block_size_ = std::max<size_t>(kBlockSize, key.size);
+    blocks_.push_back(std::unique_ptr<char[]>(new char[block_size_]));
+    block_offset_ = 0;
+  }
+  char* data = blocks_.back().get() + block_offset_;
+  memcpy(data, key.data, key.size);
+  block_offset_ += key.size;
+  bytes_ += key.size;
+  return FlatKey{data, key.size, key.hash};
+}
+
+void FlatKeyArena::Clear() {
+  blocks_.clear();
+  block_offset_ = 0;
+  block_size_ = 0;
+  bytes_ = 0;
+}
+
+FlatKeyEncoder::FlatKeyEncoder(std::vector<types::DataType> types) : types_(std::move(types)) {
+  for (auto dt : types_) {
+    fixed_offsets_.push_back(fixed_size_);
+#define TYPE_CASE(_dt_) fixed_size_ += FixedWidth<_dt_>();
+    PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
+#undef TYPE_CASE
+  }
+}
+
+void FlatKeyEncoder::EncodeBatch(const RowBatch& rb, const std::vector<int64_t>& col_idxs) {
+  DCHECK_EQ(col_idxs.size(), types_.size());
+  size_t num_rows = rb.num_rows();
+  offsets_.resize(num_rows);
+  sizes_.resize(num_rows);
+  hashes_.resize(num_rows);
+  string_offsets_.resize(num_rows);
+
+  // Size every key first, so that the keys of the batch can be laid out in a single buffer.
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    sizes_[rb.selected_row(i)] = fixed_size_;
+  }
+  for (size_t col_idx = 0; col_idx < types_.size(); ++col_idx) {
+    if (types_[col_idx] != types::DataType::STRING) {
+      continue;
+    }
+    auto arr = static_cast<const arrow::StringArray*>(rb.ColumnAt(col_idxs[col_idx]).get());
+    for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+      auto row_idx = rb.selected_row(i);
+      sizes_[row_idx] += arr->value_length(row_idx);
+    }
+  }
+  size_t total_size = 0;
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    auto row_idx = rb.selected_row(i);
+    offsets_[row_idx] = total_size;
+    string_offsets_[row_idx] = fixed_size_;
+    hashes_[row_idx] = 0;
+    total_size += sizes_[row_idx];
+  }
+  buffer_.resize(total_size);
+
+  for (size_t col_idx = 0; col_idx < types_.size(); ++col_idx) {
+    auto col = rb.ColumnAt(col_idxs[col_idx]).get();
+#define TYPE_CASE(_dt_) EncodeColumn<_dt_>(rb, col, col_idx);
+    PL_SWITCH_FOREACH_DATATYPE(types_[col_idx], TYPE_CASE);
+#undef TYPE_CASE
+  }
+}
+
+template <types::DataType DT>
+void FlatKeyEncoder::EncodeColumn(const RowBatch& rb, const arrow::Array* col, size_t col_idx) {
+  uint32_t fixed_offset = fixed_offsets_[col_idx];
+  if constexpr (DT == types::DataType::STRING) {
+    for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+      auto row_idx = rb.selected_row(i);
+      auto value = types::GetStringViewFromArrowArray(col, row_idx);
+      uint32_t length = value.size();
+      char* key = buffer_.data() + offsets_[row_idx];
+      memcpy(key + fixed_offset, &length, sizeof(length));
+      memcpy(key + string_offsets_[row_idx], value.data(), length);
+      string_offsets_[row_idx] += length;
+      hashes_[row_idx] = HashCombine(hashes_[row_idx], ::util::Hash64(value.data(), length));
+    }
+  } else {
+    using ArrowArrayType = typename types::DataTypeTraits<DT>::arrow_array_type;
+    using ValueType = typename types::DataTypeTraits<DT>::value_type;
+    auto arr = static_cast<const ArrowArrayType*>(col);
+    for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+      auto row_idx = rb.selected_row(i);
+      ValueType value = types::GetValue(arr, row_idx);
+      char* key = buffer_.data() + offsets_[row_idx];
+      memcpy(key + fixed_offset, &value.val, sizeof(value.val));
+      hashes_[row_idx] = HashCombine(
+          hashes_[row_idx],
+          ::util::Hash64(reinterpret_cast<const char*>(&value.val), sizeof(value.val)));
+    }
+  }
+}
+
+Status FlatKeyEncoder::AppendValue(const FlatKey& key, size_t col_idx,
+                                   arrow::ArrayBuilder* builder) const {
+  DCHECK_LT(col_idx, types_.size());
+#define TYPE_CASE(_dt_) return AppendColumnValue<_dt_>(key, col_idx, builder);
+  PL_SWITCH_FOREACH_DATATYPE(types_[col_idx], TYPE_CASE);
+#undef TYPE_CASE
+  return error::Internal("Unknown key type: $0", types::ToString(types_[col_idx]));
+}
+
+template <types::DataType DT>
+Status FlatKeyEncoder::AppendColumnValue(const FlatKey& key, size_t col_idx,
+                                         arrow::ArrayBuilder* builder) const {
+  using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
+  auto typed_builder = static_cast<ArrowBuilder*>(builder);
+  if constexpr (DT == types::DataType::STRING) {
+    // The strings are stored in column order after the prefix, so skip the strings of the
+    // earlier columns.
+    uint32_t string_offset = fixed_size_;
+    for (size_t i = 0; i < col_idx; ++i) {
+      if (types_[i] == types::DataType::STRING) {
+        uint32_t length;
+        memcpy(&length, key.data + fixed_offsets_[i], sizeof(length));
+        string_offset += length;
+      }
+    }
+    uint32_t length;
+    memcpy(&length, key.data + fixed_offsets_[col_idx], sizeof(length));
+    DCHECK_LE(string_offset + length, key.size);
+    PL_RETURN_IF_ERROR(typed_builder->Append(key.data + string_offset, length));
+  } else {
+    typename types::DataTypeTraits<DT>::value_type value;
+    memcpy(&value.val, key.data + fixed_offsets_[col_idx], sizeof(value.val));
+    PL_RETURN_IF_ERROR(typed_builder->Append(value.val));
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
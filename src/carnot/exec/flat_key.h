@@ -0,0 +1,155 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * FlatKey is a hash table key serialized into a single contiguous buffer by a FlatKeyEncoder.
+ *
+ * The key starts with a fixed-width prefix, with one slot per key column: the value itself for
+ * fixed size types and the length for strings. The bytes of the strings follow the prefix, in
+ * column order. Two keys of the same encoder are equal iff their bytes are equal, so comparing
+ * keys is a single memcmp. The hash of the key is computed once by the encoder and carried along
+ * with it, so the hash tables never rehash the key bytes.
+ *
+ * FlatKey does not own its bytes. They either live in the encoder's per-batch buffer or in a
+ * FlatKeyArena.
+ */
+struct FlatKey {
+  const char* data = nullptr;
+  uint32_t size = 0;
+  uint64_t hash = 0;
+};
+
+struct FlatKeyHasher {
+  size_t operator()(const FlatKey& k) const { return k.hash; }
+};
+
+struct FlatKeyEq {
+  bool operator()(const FlatKey& k1, const FlatKey& k2) const {
+    return k1.hash == k2.hash && k1.size == k2.size && memcmp(k1.data, k2.data, k1.size) == 0;
+  }
+};
+
+template <class T>
+using FlatKeyHashMap = absl::flat_hash_map<FlatKey, T, FlatKeyHasher, FlatKeyEq>;
+using FlatKeyHashSet = absl::flat_hash_set<FlatKey, FlatKeyHasher, FlatKeyEq>;
+
+/**
+ * FlatKeyArena stores the keys of a hash table back to back in large blocks, instead of making an
+ * allocation (or several, for strings) per key. Blocks are never moved, so the keys returned by
+ * Add stay valid until Clear is called.
+ */
+class FlatKeyArena {
+ public:
+  /**
+   * Copies the bytes of the key into the arena, and returns the copy.
+   */
+  FlatKey Add(const FlatKey& key);
+
+  /**
+   * Frees all the keys of the arena.
+   */
+  void Clear();
+
+  /**
+   * The number of key bytes stored in the arena.
+   */
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  static constexpr size_t kBlockSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // The write position and capacity of the last block.
+  size_t block_offset_ = 0;
+  size_t block_size_ = 0;
+  int64_t bytes_ = 0;
+};
+
+/**
+ * FlatKeyEncoder encodes the key columns of a row batch into FlatKeys, a column at a time.
+ */
+class FlatKeyEncoder {
+ public:
+  FlatKeyEncoder() = default;
+  explicit FlatKeyEncoder(std::vector<types::DataType> types);
+
+  /**
+   * Encodes the key of every selected row of the row batch. Key column i is read from
+   * rb.ColumnAt(col_idxs[i]). The keys are indexed by their row index in the batch, and stay valid
+   * until the next call to EncodeBatch.
+   */
+  void EncodeBatch(const table_store::schema::RowBatch& rb, const std::vector<int64_t>& col_idxs);
+
+  FlatKey key(int64_t row_idx) const {
+    DCHECK_LT(static_cast<size_t>(row_idx), offsets_.size());
+    return FlatKey{buffer_.data() + offsets_[row_idx], sizes_[row_idx], hashes_[row_idx]};
+  }
+
+  /**
+   * Appends the value of column col_idx of the key to the builder, which must be a builder of the
+   * type of the column.
+   */
+  Status AppendValue(const FlatKey& key, size_t col_idx, arrow::ArrayBuilder* builder) const;
+
+  const std::vector<types::DataType>& types() const { return types_; }
+
+ private:
+  template <types::DataType DT>
+  void EncodeColumn(const table_store::schema::RowBatch& rb, const arrow::Array* col,
+                    size_t col_idx);
+  template <types::DataType DT>
+  Status AppendColumnValue(const FlatKey& key, size_t col_idx, arrow::ArrayBuilder* builder) const;
+
+  std::vector<types::DataType> types_;
+  // The offset of each column's slot in the fixed-width prefix, and the size of the prefix.
+  std::vector<uint32_t> fixed_offsets_;
+  uint32_t fixed_size_ = 0;
+
+  // The keys of the current batch, indexed by row.
+  std::vector<char> buffer_;
+  std::vector<uint32_t> offsets_;
+  std::vector<uint32_t> sizes_;
+  std::vector<uint64_t> hashes_;
+  // The write position of the next string of each key, while the batch is encoded.
+  std::vector<uint32_t> string_offsets_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/flat_key.h"
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+class FlatKeyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    RowDescriptor rd({types::DataType::BOOLEAN, types::DataType::INT64, types::DataType::STRING,
+                      types::DataType::FLOAT64, types::DataType::STRING});
+    rb_ = std::make_unique<RowBatch>(RowBatchBuilder(rd, 4, false, false)
+                                         .AddColumn<types::BoolValue>({true, true, false, true})
+                                         .AddColumn<types::Int64Value>({1, 1, 1, 2})
+                                         .AddColumn<types::StringValue>({"abc", "abc", "abc", ""})
+                                         .AddColumn<types::Float64Value>({0.5, 0.5, 0.5, 1.5})
+                                         .AddColumn<types::StringValue>({"de", "de", "d", "xyz"})
+                                         .get());
+  }
+
+  std::unique_ptr<RowBatch> rb_;
+  FlatKeyEncoder encoder_{{types::DataType::BOOLEAN, types::DataType::INT64,
+                           types::DataType::STRING, types::DataType::FLOAT64,
+                           types::DataType::STRING}};
+  std::vector<int64_t> col_idxs_{0, 1, 2, 3, 4};
+};
+
+TEST_F(FlatKeyTest, equality_and_hash) {
+  encoder_.EncodeBatch(*rb_, col_idxs_);
+  FlatKeyEq eq;
+  FlatKeyHasher hasher;
+
+  EXPECT_TRUE(eq(encoder_.key(0), encoder_.key(1)));
+  EXPECT_EQ(hasher(encoder_.key(0)), hasher(encoder_.key(1)));
+  // Rows 1 and 2 only differ by the length of their last string.
+  EXPECT_FALSE(eq(encoder_.key(1), encoder_.key(2)));
+  EXPECT_FALSE(eq(encoder_.key(0), encoder_.key(3)));
+}
+
+TEST_F(FlatKeyTest, hash_map_with_arena) {
+  FlatKeyArena arena;
+  FlatKeyHashMap<int64_t> map;
+  encoder_.EncodeBatch(*rb_, col_idxs_);
+  for (int64_t i = 0; i < rb_->num_rows(); ++i) {
+    auto key = encoder_.key(i);
+    if (!map.contains(key)) {
+      map[arena.Add(key)] = i;
+    }
+  }
+  EXPECT_EQ(3, map.size());
+
+  // The keys in the arena must outlive the batch buffer of the encoder.
+  encoder_.EncodeBatch(*rb_, col_idxs_);
+  EXPECT_EQ(0, map[encoder_.key(1)]);
+  EXPECT_EQ(2, map[encoder_.key(2)]);
+  EXPECT_EQ(3, map[encoder_.key(3)]);
+
+  arena.Clear();
+  EXPECT_EQ(0, arena.bytes());
+}
+
+TEST_F(FlatKeyTest, decode_values) {
+  encoder_.EncodeBatch(*rb_, col_idxs_);
+  auto key = encoder_.key(3);
+
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders;
+  for (const auto& dt : encoder_.types()) {
+    builders.push_back(types::MakeArrowBuilder(dt, arrow::default_memory_pool()));
+  }
+  for (size_t i = 0; i < builders.size(); ++i) {
+    EXPECT_OK(encoder_.AppendValue(key, i, builders[i].get()));
+  }
+  std::vector<std::shared_ptr<arrow::Array>> arrs(builders.size());
+  for (size_t i = 0; i < builders.size(); ++i) {
+    EXPECT_TRUE(builders[i]->Finish(&arrs[i]).ok());
+  }
+
+  EXPECT_EQ(true, types::GetValueFromArrowArray<types::DataType::BOOLEAN>(arrs[0].get(), 0));
+  EXPECT_EQ(2, types::GetValueFromArrowArray<types::DataType::INT64>(arrs[1].get(), 0));
+  EXPECT_EQ("", types::GetValueFromArrowArray<types::DataType::STRING>(arrs[2].get(), 0));
+  EXPECT_EQ(1.5, types::GetValueFromArrowArray<types::DataType::FLOAT64>(arrs[3].get(), 0));
+  EXPECT_EQ("xyz", types::GetValueFromArrowArray<types::DataType::STRING>(arrs[4].get(), 0));
+}
+
+TEST_F(FlatKeyTest, selected_rows_only) {
+  rb_->SetSelection(std::make_shared<const RowBatch::SelectionVector>(
+      RowBatch::SelectionVector{1, 3}));
+  encoder_.EncodeBatch(*rb_, col_idxs_);
+
+  // A single int64 column is encoded into an 8 byte key.
+  FlatKeyEncoder int_encoder({types::DataType::INT64});
+  int_encoder.EncodeBatch(*rb_, {1});
+  EXPECT_EQ(sizeof(int64_t), int_encoder.key(1).size);
+  EXPECT_FALSE(FlatKeyEq()(encoder_.key(1), encoder_.key(3)));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -19,9 +19,11 @@
 #include "src/carnot/exec/grpc_router.h"
 
 #include <algorithm>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <absl/base/internal/spinlock.h>
 #include <absl/container/flat_hash_map.h>
@@ -31,19 +33,102 @@
 #include "src/common/base/base.h"
 #include "src/common/uuid/uuid.h"
 
+DEFINE_int64(grpc_source_window_bytes,
+             gflags::Int64FromEnv("PL_GRPC_SOURCE_WINDOW_BYTES", 64 * 1024 * 1024),
+             "The bytes of row batches that may be buffered for each GRPC source of a query "
+             "before the sending agents are paused.");
+
 namespace px {
 namespace carnot {
 namespace exec {
 
+void GRPCSourceWindow::Acquire(int64_t bytes) {
+  absl::MutexLock lock(&mu_);
+  backlog_bytes_ += bytes;
+  if (query_backlog_bytes_ != nullptr) {
+    query_backlog_bytes_->Increment(bytes);
+  }
+}
+
+void GRPCSourceWindow::Release(int64_t bytes) {
+  absl::MutexLock lock(&mu_);
+  backlog_bytes_ -= bytes;
+  if (query_backlog_bytes_ != nullptr) {
+    query_backlog_bytes_->Decrement(bytes);
+  }
+}
+
+bool GRPCSourceWindow::WaitForCredits() {
+  absl::MutexLock lock(&mu_);
+  if (HasCredits()) {
+    return false;
+  }
+  mu_.Await(absl::Condition(this, &GRPCSourceWindow::HasCredits));
+  return true;
+}
+
+void GRPCSourceWindow::Close() {
+  absl::MutexLock lock(&mu_);
+  closed_ = true;
+  if (query_backlog_bytes_ != nullptr) {
+    query_backlog_bytes_->Decrement(backlog_bytes_);
+    query_backlog_bytes_ = nullptr;
+  }
+}
+
+int64_t GRPCSourceWindow::backlog_bytes() const {
+  absl::MutexLock lock(&mu_);
+  return backlog_bytes_;
+}
+
+int64_t GRPCRouter::DefaultSourceWindowBytes() { return FLAGS_grpc_source_window_bytes; }
+
+GRPCRouter::GRPCRouter(int64_t source_window_bytes, prometheus::Registry* registry)
+    : source_window_bytes_(source_window_bytes),
+      backlog_bytes_family_(
+          prometheus::BuildGauge()
+              .Name("carnot_grpc_router_backlog_bytes")
+              .Help("Bytes of row batches received for a query that haven't been consumed yet")
+              .Register(*registry)),
+      flow_control_waits_counter_(
+          prometheus::BuildCounter()
+              .Name("carnot_grpc_router_flow_control_waits")
+              .Help("Number of times a result stream was paused because its source's window was "
+                    "full")
+              .Register(*registry)
+              .Add({})) {}
+
+std::shared_ptr<GRPCRouter::QueryTracker> GRPCRouter::CreateQueryTracker(
+    const sole::uuid& query_id) {
+  auto query_tracker = std::make_shared<QueryTracker>();
+  query_tracker->backlog_bytes_gauge = &backlog_bytes_family_.Add({{"query_id", query_id.str()}});
+  id_to_query_tracker_map_[query_id] = query_tracker;
+  return query_tracker;
+}
+
 GRPCRouter::SourceNodeTracker* GRPCRouter::GetSourceNodeTracker(QueryTracker* query_tracker,
                                                                 int64_t source_id) {
   absl::base_internal::SpinLockHolder query_lock(&query_tracker->query_lock);
-  return &query_tracker->source_node_trackers[source_id];
+  auto* snt = &query_tracker->source_node_trackers[source_id];
+  if (snt->window == nullptr) {
+    snt->window = std::make_shared<GRPCSourceWindow>(source_window_bytes_,
+                                                     query_tracker->backlog_bytes_gauge);
+  }
+  return snt;
+}
+
+void GRPCRouter::WaitForSourceWindow(GRPCSourceWindow* window) {
+  if (window->WaitForCredits()) {
+    flow_control_waits_counter_.Increment();
+  }
 }
 
 Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
-                                   std::unique_ptr<carnotpb::TransferResultChunkRequest> req) {
-  if (!req->has_query_result() || !req->query_result().has_row_batch() ||
+                                   std::unique_ptr<carnotpb::TransferResultChunkRequest> req,
+                                   std::shared_ptr<GRPCSourceWindow>* window) {
+  if (!req->has_query_result() ||
+      req->query_result().result_contents_case() ==
+          carnotpb::TransferResultChunkRequest_SinkResult::RESULT_CONTENTS_NOT_SET ||
       req->query_result().destination_case() !=
           carnotpb::TransferResultChunkRequest_SinkResult::DestinationCase::kGrpcSourceId) {
     return error::Internal(
@@ -52,6 +137,8 @@ Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
   }
 
   auto snt = GetSourceNodeTracker(query_tracker, req->query_result().grpc_source_id());
+  *window = snt->window;
+  (*window)->Acquire(req->ByteSizeLong());
   {
     absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
     // It's possible that we see row batches before we have gotten information about the query. To
@@ -112,7 +199,7 @@ void GRPCRouter::MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
             grpc::StatusCode::INVALID_ARGUMENT,
             "Attempting to TransferResultChunk for uninitiated or completed query.");
       }
-      id_to_query_tracker_map_[query_id] = std::make_shared<QueryTracker>();
+      CreateQueryTracker(query_id);
     }
     state->query_tracker = id_to_query_tracker_map_[query_id];
   }
@@ -138,10 +225,12 @@ void GRPCRouter::MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
     }
     return ::grpc::Status::OK;
   }
-  if (req->has_query_result() && req->query_result().has_row_batch()) {
+  if (req->has_query_result() &&
+      req->query_result().result_contents_case() !=
+          carnotpb::TransferResultChunkRequest_SinkResult::RESULT_CONTENTS_NOT_SET) {
     state->stream_has_query_results = true;
     state->source_node_id = req->query_result().grpc_source_id();
-    auto s = EnqueueRowBatch(state->query_tracker.get(), std::move(req));
+    auto s = EnqueueRowBatch(state->query_tracker.get(), std::move(req), &state->window);
     if (!s.ok()) {
       return ::grpc::Status(grpc::StatusCode::INTERNAL, "failed to enqueue batch");
     }
@@ -179,6 +268,10 @@ std::vector<statuspb::Status> GRPCRouter::GetIncomingWorkerErrors(const sole::uu
     if (!result_status.ok()) {
       break;
     }
+    // Hold off reading the next request until the source has consumed enough of its backlog.
+    if (state.window != nullptr) {
+      WaitForSourceWindow(state.window.get());
+    }
     req = std::make_unique<carnotpb::TransferResultChunkRequest>();
   }
 
@@ -211,7 +304,7 @@ Status GRPCRouter::AddGRPCSourceNode(sole::uuid query_id, int64_t source_id,
   {
     absl::base_internal::SpinLockHolder lock(&id_to_query_tracker_map_lock_);
     if (!id_to_query_tracker_map_.contains(query_id)) {
-      id_to_query_tracker_map_[query_id] = std::make_shared<QueryTracker>();
+      CreateQueryTracker(query_id);
     }
     query_tracker = id_to_query_tracker_map_[query_id];
   }
@@ -224,6 +317,7 @@ Status GRPCRouter::AddGRPCSourceNode(sole::uuid query_id, int64_t source_id,
 
   absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
   snt->source_node = source_node;
+  source_node->set_window(snt->window);
   if (snt->connection_initiated_by_sink) {
     source_node->set_upstream_initiated_connection();
   }
@@ -269,13 +363,19 @@ Status GRPCRouter::DeleteGRPCSourceNode(sole::uuid query_id, int64_t source_id)
     query_tracker = id_to_query_tracker_map_[query_id];
   }
 
-  absl::base_internal::SpinLockHolder lock(&query_tracker->query_lock);
-  auto it = query_tracker->source_node_trackers.find(source_id);
-  if (it == query_tracker->source_node_trackers.end()) {
-    return error::Internal("Query map for query ID $0 does not contain GRPC source $1",
-                           query_id.str(), source_id);
+  std::shared_ptr<GRPCSourceWindow> window;
+  {
+    absl::base_internal::SpinLockHolder lock(&query_tracker->query_lock);
+    auto it = query_tracker->source_node_trackers.find(source_id);
+    if (it == query_tracker->source_node_trackers.end()) {
+      return error::Internal("Query map for query ID $0 does not contain GRPC source $1",
+                             query_id.str(), source_id);
+    }
+    window = std::move(it->second.window);
+    query_tracker->source_node_trackers.erase(it);
   }
-  query_tracker->source_node_trackers.erase(it);
+  // Closing the window wakes up the streams that wait on it, so it's done outside of the spinlock.
+  window->Close();
   return Status::OK();
 }
 
@@ -293,12 +393,46 @@ void GRPCRouter::DeleteQuery(sole::uuid query_id) {
     query_tracker = it->second;
     id_to_query_tracker_map_.erase(it);
   }
+  std::vector<std::shared_ptr<GRPCSourceWindow>> windows;
+  prometheus::Gauge* backlog_bytes_gauge;
+  {
+    absl::base_internal::SpinLockHolder lock(&query_tracker->query_lock);
+    query_tracker->ResetRestartExecutionFunc();
+    // For any active input streams for this query, mark their context as cancelled.
+    for (auto ctx : query_tracker->active_agent_contexts) {
+      ctx->TryCancel();
+    }
+    for (const auto& [source_id, snt] : query_tracker->source_node_trackers) {
+      windows.push_back(snt.window);
+    }
+    // Windows created from now on aren't tracked by the query's backlog metric.
+    backlog_bytes_gauge = query_tracker->backlog_bytes_gauge;
+    query_tracker->backlog_bytes_gauge = nullptr;
+  }
+  // Release the streams that wait for credits, outside of the spinlock since it wakes them up.
+  // The windows detach from the backlog metric when closed, so it's only dropped afterwards.
+  for (const auto& window : windows) {
+    window->Close();
+  }
+  backlog_bytes_family_.Remove(backlog_bytes_gauge);
+}
+
+int64_t GRPCRouter::QueryBacklogBytes(const sole::uuid& query_id) {
+  std::shared_ptr<QueryTracker> query_tracker;
+  {
+    absl::base_internal::SpinLockHolder lock(&id_to_query_tracker_map_lock_);
+    auto it = id_to_query_tracker_map_.find(query_id);
+    if (it == id_to_query_tracker_map_.end()) {
+      return 0;
+    }
+    query_tracker = it->second;
+  }
   absl::base_internal::SpinLockHolder lock(&query_tracker->query_lock);
-  query_tracker->ResetRestartExecutionFunc();
-  // For any active input streams for this query, mark their context as cancelled.
-  for (auto ctx : query_tracker->active_agent_contexts) {
-    ctx->TryCancel();
+  int64_t backlog_bytes = 0;
+  for (const auto& [source_id, snt] : query_tracker->source_node_trackers) {
+    backlog_bytes += snt.window->backlog_bytes();
   }
+  return backlog_bytes;
 }
 
 size_t GRPCRouter::NumQueriesTracking() const {
@@ -30,13 +30,19 @@
 #include <absl/container/flat_hash_set.h>
 #include <absl/container/node_hash_map.h>
 #include <absl/hash/hash.h>
+#include <absl/synchronization/mutex.h>
 #include <grpcpp/grpcpp.h>
+#include <prometheus/counter.h>
+#include <prometheus/family.h>
+#include <prometheus/gauge.h>
+#include <prometheus/registry.h>
 #include <sole.hpp>
 
 #include "src/carnot/carnotpb/carnot.grpc.pb.h"
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/common/base/base.h"
 #include "src/common/base/statuspb/status.pb.h"
+#include "src/common/metrics/metrics.h"
 #include "src/common/uuid/uuid.h"
 
 namespace px {
@@ -46,12 +52,72 @@ namespace exec {
 // Forward declaration needed to break circular dependency.
 class GRPCSourceNode;
 
+/**
+ * GRPCSourceWindow is the credit based flow control between the GRPCSinkNodes that send to a
+ * GRPCSourceNode and that source node. Every received row batch takes credits for its size, which
+ * are returned once the source node has consumed it. The router stops reading from the streams of
+ * a source whose credits are used up, so the sinks' writes block (through the HTTP/2 flow control
+ * of the streams) and pause their pipelines until the source node catches up. This bounds the
+ * memory used for a source by the window size, independently of the number of sending agents.
+ */
+class GRPCSourceWindow {
+ public:
+  GRPCSourceWindow(int64_t max_bytes, prometheus::Gauge* query_backlog_bytes)
+      : max_bytes_(max_bytes), query_backlog_bytes_(query_backlog_bytes) {}
+
+  /**
+   * Takes credits for a received request. Never blocks, requests that have been read off a stream
+   * are always accepted, so each stream can overrun the window by one request.
+   */
+  void Acquire(int64_t bytes);
+
+  /**
+   * Returns the credits of a request once it has been consumed.
+   */
+  void Release(int64_t bytes);
+
+  /**
+   * Blocks until the window has credits left or is closed. The waiting stream is woken up by
+   * Release or Close, so a stream that gets cancelled while it waits stays blocked until its
+   * source consumes some of the backlog or the query is deleted.
+   * @return whether the stream had to wait.
+   */
+  bool WaitForCredits();
+
+  /**
+   * Stops flow control for the window, eg. once its source node or query is deleted. Releases
+   * the waiting streams and detaches the window from the query's backlog metric.
+   */
+  void Close();
+
+  int64_t backlog_bytes() const;
+
+ private:
+  bool HasCredits() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return closed_ || backlog_bytes_ < max_bytes_;
+  }
+
+  const int64_t max_bytes_;
+  mutable absl::Mutex mu_;
+  int64_t backlog_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  bool closed_ ABSL_GUARDED_BY(mu_) = false;
+  prometheus::Gauge* query_backlog_bytes_ ABSL_GUARDED_BY(mu_);
+};
+
 /**
  * GRPCRouter tracks incoming Kelvin connections and routes them to the appropriate Carnot source
  * node.
  */
 class GRPCRouter final : public carnotpb::ResultSinkService::Service {
  public:
+  /**
+   * @param source_window_bytes the number of bytes of row batches that may be buffered for a
+   * single GRPC source of a query before the router stops reading from the sinks sending to it.
+   * @param registry the registry of the router's metrics.
+   */
+  explicit GRPCRouter(int64_t source_window_bytes = DefaultSourceWindowBytes(),
+                      prometheus::Registry* registry = &GetMetricsRegistry());
+
   /**
    * TransferResultChunk implements the RPC method.
    */
@@ -103,6 +169,13 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
    */
   size_t NumQueriesTracking() const;
 
+  /**
+   * @brief Bytes of row batches received for the query that its source nodes haven't consumed.
+   */
+  int64_t QueryBacklogBytes(const sole::uuid& query_id);
+
+  static int64_t DefaultSourceWindowBytes();
+
  private:
   /**
    * SourceNodeTracker is responsible for tracking a single source node and the backlog of messages
@@ -118,6 +191,8 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
     bool connection_closed_by_sink GUARDED_BY(node_lock) = false;
     std::vector<std::unique_ptr<::px::carnotpb::TransferResultChunkRequest>> response_backlog
         GUARDED_BY(node_lock);
+    // Shared with the source node, which returns the credits, and the streams sending to it.
+    std::shared_ptr<GRPCSourceWindow> window;
     absl::base_internal::SpinLock node_lock;
   };
 
@@ -137,6 +212,8 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
 
     // Errors that occur during execution from parent_agents.
     std::vector<statuspb::Status> upstream_exec_errors GUARDED_BY(query_lock);
+    // Sum of the backlogs of the query's source windows. Reset to null once the query is deleted.
+    prometheus::Gauge* backlog_bytes_gauge GUARDED_BY(query_lock) = nullptr;
     absl::base_internal::SpinLock query_lock;
 
     void ResetRestartExecutionFunc() ABSL_EXCLUSIVE_LOCKS_REQUIRED(query_lock) {
@@ -157,10 +234,13 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
   };
 
   Status EnqueueRowBatch(QueryTracker* query_tracker,
-                         std::unique_ptr<carnotpb::TransferResultChunkRequest> req);
+                         std::unique_ptr<carnotpb::TransferResultChunkRequest> req,
+                         std::shared_ptr<GRPCSourceWindow>* window);
 
   struct TransferResultChunkState {
     int64_t source_node_id = 0;
+    // The flow control window of the source that the stream sends row batches to.
+    std::shared_ptr<GRPCSourceWindow> window = nullptr;
     bool registered_server_context = false;
     // stream_has_query_results informs downstream source nodes about the health of the stream.
     // When true, the particular TransferResultChunk call has initiated the query stream.
@@ -176,6 +256,14 @@ class GRPCRouter final : public carnotpb::ResultSinkService::Service {
   void MarkResultStreamContextAsComplete(QueryTracker* query_tracker,
                                          ::grpc::ServerContext* context);
   SourceNodeTracker* GetSourceNodeTracker(QueryTracker* query_tracker, int64_t source_id);
+  std::shared_ptr<QueryTracker> CreateQueryTracker(const sole::uuid& query_id)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(id_to_query_tracker_map_lock_);
+  // Blocks the stream until the window of its source has credits left or is closed.
+  void WaitForSourceWindow(GRPCSourceWindow* window);
+
+  const int64_t source_window_bytes_;
+  prometheus::Family<prometheus::Gauge>& backlog_bytes_family_;
+  prometheus::Counter& flow_control_waits_counter_;
 
   absl::node_hash_map<sole::uuid, std::shared_ptr<QueryTracker>> id_to_query_tracker_map_
       GUARDED_BY(id_to_query_tracker_map_lock_);
@@ -308,6 +308,121 @@ TEST_F(GRPCRouterTest, router_and_stats_test) {
   EXPECT_EQ(exec_stats.size(), 1);
 }
 
+class GRPCRouterFlowControlTest : public GRPCRouterTest {
+ protected:
+  // Any row batch uses up the whole window.
+  GRPCRouterFlowControlTest() {
+    service_ = std::make_unique<GRPCRouter>(/*source_window_bytes*/ 1);
+  }
+};
+
+TEST_F(GRPCRouterFlowControlTest, pauses_stream_until_batches_are_consumed) {
+  int64_t grpc_source_node_id = 1;
+  auto query_id = sole::uuid4();
+  RowDescriptor input_rd({types::DataType::INT64});
+
+  auto func_registry = std::make_unique<udf::Registry>("test_registry");
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry.get(), std::make_shared<table_store::TableStore>(),
+      MockResultSinkStubGenerator, MockMetricsStubGenerator, MockTraceStubGenerator, query_id,
+      nullptr, service_.get());
+  auto op_proto = planpb::testutils::CreateTestGRPCSource1PB();
+  std::unique_ptr<plan::Operator> plan_node =
+      plan::GRPCSourceOperator::FromProto(op_proto, grpc_source_node_id);
+  auto tester = ExecNodeTester<GRPCSourceNode, plan::GRPCSourceOperator>(
+      *plan_node, input_rd, std::vector<RowDescriptor>({}), exec_state.get());
+  ASSERT_OK(service_->AddGRPCSourceNode(query_id, grpc_source_node_id, tester.node(), [] {}));
+
+  carnotpb::TransferResultChunkRequest initiate_stream_req;
+  ToProto(query_id, initiate_stream_req.mutable_query_id());
+  *initiate_stream_req.mutable_initiate_conn() =
+      carnotpb::TransferResultChunkRequest::InitiateConnection();
+
+  std::vector<table_store::schema::RowBatch> rbs;
+  std::vector<carnotpb::TransferResultChunkRequest> rb_reqs(3);
+  for (int64_t i = 0; i < 3; ++i) {
+    rbs.push_back(RowBatchBuilder(input_rd, 2, /*eow*/ i == 2, /*eos*/ i == 2)
+                      .AddColumn<types::Int64Value>({i, i + 1})
+                      .get());
+    EXPECT_OK(rbs[i].ToProto(rb_reqs[i].mutable_query_result()->mutable_row_batch()));
+    rb_reqs[i].mutable_query_result()->set_grpc_source_id(grpc_source_node_id);
+    ToProto(query_id, rb_reqs[i].mutable_query_id());
+  }
+
+  carnotpb::TransferResultChunkResponse response;
+  grpc::ClientContext context;
+  auto writer = stub_->TransferResultChunk(&context, &response);
+  std::thread sender([&] {
+    writer->Write(initiate_stream_req);
+    for (const auto& req : rb_reqs) {
+      writer->Write(req);
+    }
+    writer->WritesDone();
+    EXPECT_TRUE(writer->Finish().ok());
+  });
+
+  for (int64_t i = 0; i < 3; ++i) {
+    for (int attempt = 0; attempt < 100 && !tester.node()->NextBatchReady(); ++attempt) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_TRUE(tester.node()->NextBatchReady());
+    // The router doesn't read the next batch until this one has been consumed.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(static_cast<int64_t>(rb_reqs[i].ByteSizeLong()),
+              service_->QueryBacklogBytes(query_id));
+    tester.GenerateNextResult().ExpectRowBatch(rbs[i]);
+  }
+  sender.join();
+  EXPECT_EQ(0, service_->QueryBacklogBytes(query_id));
+}
+
+TEST_F(GRPCRouterFlowControlTest, delete_query_releases_paused_stream) {
+  int64_t grpc_source_node_id = 1;
+  auto query_id = sole::uuid4();
+  RowDescriptor input_rd({types::DataType::INT64});
+
+  auto op_proto = planpb::testutils::CreateTestGRPCSource1PB();
+  std::unique_ptr<plan::Operator> plan_node =
+      plan::GRPCSourceOperator::FromProto(op_proto, grpc_source_node_id);
+  // The fake source node never consumes its batches, so the stream stays paused.
+  auto source_node = FakeGRPCSourceNode();
+  ASSERT_OK(source_node.Init(*plan_node, input_rd, {}));
+  ASSERT_OK(service_->AddGRPCSourceNode(query_id, grpc_source_node_id, &source_node, [] {}));
+
+  carnotpb::TransferResultChunkRequest initiate_stream_req;
+  ToProto(query_id, initiate_stream_req.mutable_query_id());
+  *initiate_stream_req.mutable_initiate_conn() =
+      carnotpb::TransferResultChunkRequest::InitiateConnection();
+  auto rb = RowBatchBuilder(input_rd, 2, /*eow*/ false, /*eos*/ false)
+                .AddColumn<types::Int64Value>({1, 2})
+                .get();
+  carnotpb::TransferResultChunkRequest rb_req;
+  EXPECT_OK(rb.ToProto(rb_req.mutable_query_result()->mutable_row_batch()));
+  rb_req.mutable_query_result()->set_grpc_source_id(grpc_source_node_id);
+  ToProto(query_id, rb_req.mutable_query_id());
+
+  carnotpb::TransferResultChunkResponse response;
+  grpc::ClientContext context;
+  auto writer = stub_->TransferResultChunk(&context, &response);
+  std::thread sender([&] {
+    writer->Write(initiate_stream_req);
+    writer->Write(rb_req);
+    writer->Write(rb_req);
+    writer->WritesDone();
+    writer->Finish();
+  });
+
+  for (int attempt = 0; attempt < 100 && service_->QueryBacklogBytes(query_id) == 0; ++attempt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(static_cast<int64_t>(rb_req.ByteSizeLong()), service_->QueryBacklogBytes(query_id));
+
+  // Deleting the query closes the window, which wakes up the paused stream so that it can finish.
+  service_->DeleteQuery(query_id);
+  sender.join();
+  EXPECT_EQ(0, service_->NumQueriesTracking());
+}
+
 TEST_F(GRPCRouterTest, delete_node_router_test) {
   int64_t grpc_source_node_id = 1;
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::BOOLEAN});
@@ -21,16 +21,25 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <absl/strings/str_join.h>
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/hash_utils.h"
 #include "src/common/base/macros.h"
 #include "src/common/uuid/uuid_utils.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
 #include "src/table_store/table_store.h"
 
+// NOLINTNEXTLINE: build/include_subdir
+#include "xxhash.h"
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -44,6 +53,10 @@ std::string GRPCSinkNode::DebugStringImpl() {
     destination = absl::Substitute("table_name: $0", plan_node_->table_name());
   } else if (plan_node_->has_grpc_source_id()) {
     destination = absl::Substitute("source_id: $0", plan_node_->grpc_source_id());
+  } else if (plan_node_->is_shuffle()) {
+    destination = absl::Substitute("shuffle_destinations: $0, partition_cols: [$1]",
+                                   partition_sinks_.size(),
+                                   absl::StrJoin(plan_node_->partition_column_idxs(), ", "));
   }
   return absl::Substitute("Exec::GRPCSinkNode: {address: $0, $1, output: $2}",
                           plan_node_->address(), destination, input_descriptor_->DebugString());
@@ -67,10 +80,27 @@ StatusOr<carnotpb::TransferResultChunkRequest> RequestWithMetadata(
   return req;
 }
 
+// Serializes the row batch into the request. Row batches sent to other Carnot instances use the
+// columnar format if the query enables it, the query broker only reads RowBatchData.
+Status SerializeRowBatch(plan::GRPCSinkOperator* plan_node, ExecState* exec_state,
+                         const RowBatch& rb, carnotpb::TransferResultChunkRequest* req) {
+  if (plan_node->has_grpc_source_id() && exec_state->columnar_transfer()) {
+    return rb.ToColumnarProto(exec_state->columnar_encoding_opts(),
+                              req->mutable_query_result()->mutable_columnar_row_batch());
+  }
+  return rb.ToProto(req->mutable_query_result()->mutable_row_batch());
+}
+
 Status GRPCSinkNode::OptionallyCheckConnection(ExecState* exec_state) {
   if (sent_eos_ || cancelled_) {
     return Status::OK();
   }
+  for (const auto& sink : partition_sinks_) {
+    PL_RETURN_IF_ERROR(sink->OptionallyCheckConnection(exec_state));
+  }
+  if (plan_node_->is_shuffle()) {
+    return Status::OK();
+  }
 
   auto time_now = std::chrono::system_clock::now();
   auto since_last_flush =
@@ -83,7 +113,7 @@ Status GRPCSinkNode::OptionallyCheckConnection(ExecState* exec_state) {
   PL_ASSIGN_OR_RETURN(auto req, RequestWithMetadata(plan_node_.get(), exec_state));
   PL_ASSIGN_OR_RETURN(auto rb,
                       RowBatch::WithZeroRows(*input_descriptor_, /* eow */ false, /* eos */ false));
-  PL_RETURN_IF_ERROR(rb->ToProto(req.mutable_query_result()->mutable_row_batch()));
+  PL_RETURN_IF_ERROR(SerializeRowBatch(plan_node_.get(), exec_state, *rb, &req));
 
   PL_RETURN_IF_ERROR(TryWriteRequest(exec_state, req));
   return Status::OK();
@@ -99,10 +129,45 @@ Status GRPCSinkNode::InitImpl(const plan::Operator& plan_node) {
   input_descriptor_ = std::make_unique<RowDescriptor>(input_descriptors_[0]);
   const auto* sink_plan_node = static_cast<const plan::GRPCSinkOperator*>(&plan_node);
   plan_node_ = std::make_unique<plan::GRPCSinkOperator>(*sink_plan_node);
+  if (plan_node_->is_shuffle()) {
+    return InitShuffle();
+  }
+  return Status::OK();
+}
+
+Status GRPCSinkNode::InitShuffle() {
+  auto partition_cols = plan_node_->partition_column_idxs();
+  if (partition_cols.empty()) {
+    return error::InvalidArgument("GRPCSink with shuffle destinations needs partition columns");
+  }
+  for (int64_t col_idx : partition_cols) {
+    if (col_idx < 0 || col_idx >= static_cast<int64_t>(input_descriptor_->size())) {
+      return error::InvalidArgument("GRPCSink partition column $0 is out of range for $1 columns",
+                                    col_idx, input_descriptor_->size());
+    }
+  }
+  for (const auto& dest : plan_node_->shuffle_destinations()) {
+    planpb::GRPCSinkOperator pb;
+    pb.set_address(dest.address());
+    pb.set_grpc_source_id(dest.grpc_source_id());
+    *pb.mutable_connection_options() = dest.connection_options();
+    plan::GRPCSinkOperator dest_plan_node(plan_node_->id());
+    PL_RETURN_IF_ERROR(dest_plan_node.Init(pb));
+
+    auto sink = std::make_unique<GRPCSinkNode>(max_batch_size_, batch_size_factor_);
+    PL_RETURN_IF_ERROR(sink->Init(dest_plan_node, *output_descriptor_, input_descriptors_));
+    sink->testing_set_connection_check_timeout(connection_check_timeout_);
+    partition_sinks_.push_back(std::move(sink));
+  }
   return Status::OK();
 }
 
-Status GRPCSinkNode::PrepareImpl(ExecState*) { return Status::OK(); }
+Status GRPCSinkNode::PrepareImpl(ExecState* exec_state) {
+  for (const auto& sink : partition_sinks_) {
+    PL_RETURN_IF_ERROR(sink->Prepare(exec_state));
+  }
+  return Status::OK();
+}
 
 Status GRPCSinkNode::StartConnection(ExecState* exec_state) {
   return StartConnectionWithRetries(exec_state, kGRPCRetries);
@@ -135,7 +200,7 @@ Status GRPCSinkNode::StartConnectionWithRetries(ExecState* exec_state, size_t n_
   // initiate_result_stream request.
   PL_ASSIGN_OR_RETURN(auto rb,
                       RowBatch::WithZeroRows(*input_descriptor_, /* eow */ false, /* eos */ false));
-  PL_RETURN_IF_ERROR(rb->ToProto(req.mutable_query_result()->mutable_row_batch()));
+  PL_RETURN_IF_ERROR(SerializeRowBatch(plan_node_.get(), exec_state, *rb, &req));
 
   if (!writer_->Write(req)) {
     return StartConnectionWithRetries(exec_state, n_retries - 1);
@@ -155,6 +220,8 @@ Status GRPCSinkNode::CancelledByServer(ExecState* exec_state) {
 
 Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
                                      const carnotpb::TransferResultChunkRequest& req) {
+  // Write blocks while the receiving GRPCRouter holds back the stream because the destination
+  // source has used up its flow control window, which pauses this node's pipeline.
   if (writer_->Write(req)) {
     last_send_time_ = std::chrono::system_clock::now();
     return Status::OK();
@@ -183,7 +250,15 @@ Status GRPCSinkNode::TryWriteRequest(ExecState* exec_state,
   return Status::OK();
 }
 
-Status GRPCSinkNode::OpenImpl(ExecState* exec_state) { return StartConnection(exec_state); }
+Status GRPCSinkNode::OpenImpl(ExecState* exec_state) {
+  if (plan_node_->is_shuffle()) {
+    for (const auto& sink : partition_sinks_) {
+      PL_RETURN_IF_ERROR(sink->Open(exec_state));
+    }
+    return Status::OK();
+  }
+  return StartConnection(exec_state);
+}
 
 Status GRPCSinkNode::CloseWriter(ExecState* exec_state) {
   if (writer_ == nullptr) {
@@ -200,6 +275,9 @@ Status GRPCSinkNode::CloseWriter(ExecState* exec_state) {
 }
 
 Status GRPCSinkNode::CloseImpl(ExecState* exec_state) {
+  for (const auto& sink : partition_sinks_) {
+    PL_RETURN_IF_ERROR(sink->Close(exec_state));
+  }
   if (sent_eos_ || cancelled_) {
     return Status::OK();
   }
@@ -302,7 +380,79 @@ Status GRPCSinkNode::SplitAndSendBatch(ExecState* exec_state, const RowBatch& rb
   return ConsumeNextImplNoSplit(exec_state, *output_rb, parent_idx);
 }
 
+namespace {
+
+// Partitions are picked with XXH64 rather than std::hash or absl::Hash, because the sinks on
+// every agent have to send a key to the same partition.
+template <typename T>
+uint64_t HashPartitionValue(T val) {
+  if constexpr (std::is_floating_point_v<T>) {
+    // 0.0 and -0.0 are equal keys, so they have to hash the same.
+    if (val == 0) {
+      val = 0;
+    }
+  }
+  return XXH64(&val, sizeof(val), /*seed*/ 0);
+}
+
+template <types::DataType T>
+void HashPartitionColumn(const RowBatch& rb, int64_t col_idx, std::vector<uint64_t>* hashes) {
+  const arrow::Array* col = rb.ColumnAt(col_idx).get();
+  for (int64_t i = 0; i < rb.num_selected_rows(); ++i) {
+    int64_t row = rb.selected_row(i);
+    uint64_t hash;
+    if constexpr (T == types::DataType::STRING) {
+      std::string_view val = types::GetStringViewFromArrowArray(col, row);
+      hash = XXH64(val.data(), val.size(), /*seed*/ 0);
+    } else {
+      hash = HashPartitionValue(types::GetValueFromArrowArray<T>(col, row));
+    }
+    (*hashes)[i] = HashCombine((*hashes)[i], hash);
+  }
+}
+
+}  // namespace
+
+Status GRPCSinkNode::ShuffleBatch(ExecState* exec_state, const RowBatch& rb) {
+  std::vector<uint64_t> hashes(rb.num_selected_rows(), 0);
+  for (int64_t col_idx : plan_node_->partition_column_idxs()) {
+#define TYPE_CASE(_dt_) HashPartitionColumn<_dt_>(rb, col_idx, &hashes)
+    PL_SWITCH_FOREACH_DATATYPE(rb.desc().type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  std::vector<RowBatch::SelectionVector> partition_rows(partition_sinks_.size());
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    partition_rows[hashes[i] % partition_sinks_.size()].push_back(rb.selected_row(i));
+  }
+
+  for (size_t partition = 0; partition < partition_sinks_.size(); ++partition) {
+    // Empty partitions are only sent when they have to carry the end of a window or stream.
+    if (partition_rows[partition].empty() && !rb.eow() && !rb.eos()) {
+      continue;
+    }
+    RowBatch partition_rb(rb.desc(), rb.num_rows());
+    for (int64_t col_idx = 0; col_idx < rb.num_columns(); ++col_idx) {
+      PL_RETURN_IF_ERROR(partition_rb.AddColumn(rb.ColumnAt(col_idx)));
+    }
+    partition_rb.SetSelection(
+        std::make_shared<RowBatch::SelectionVector>(std::move(partition_rows[partition])));
+    partition_rb.set_eow(rb.eow());
+    partition_rb.set_eos(rb.eos());
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<RowBatch> output_rb, partition_rb.Materialize());
+    PL_RETURN_IF_ERROR(partition_sinks_[partition]->ConsumeNext(exec_state, *output_rb, 0));
+  }
+
+  if (rb.eos()) {
+    sent_eos_ = true;
+  }
+  return Status::OK();
+}
+
 Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t parent_idx) {
+  if (plan_node_->is_shuffle()) {
+    return ShuffleBatch(exec_state, rb);
+  }
   if (rb.NumBytes() > (max_batch_size_ * batch_size_factor_)) {
     return SplitAndSendBatch(exec_state, rb, parent_idx);
   }
@@ -312,7 +462,7 @@ Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb,
 Status GRPCSinkNode::ConsumeNextImplNoSplit(ExecState* exec_state, const RowBatch& rb, size_t) {
   PL_ASSIGN_OR_RETURN(auto req, RequestWithMetadata(plan_node_.get(), exec_state));
   // Serialize the RowBatch.
-  PL_RETURN_IF_ERROR(rb.ToProto(req.mutable_query_result()->mutable_row_batch()));
+  PL_RETURN_IF_ERROR(SerializeRowBatch(plan_node_.get(), exec_state, rb, &req));
 
   PL_RETURN_IF_ERROR(TryWriteRequest(exec_state, req));
 
@@ -63,11 +63,17 @@ class GRPCSinkNode : public SinkNode {
 
   void testing_set_connection_check_timeout(const std::chrono::milliseconds& timeout) {
     connection_check_timeout_ = timeout;
+    for (const auto& sink : partition_sinks_) {
+      sink->testing_set_connection_check_timeout(timeout);
+    }
   }
   const std::chrono::time_point<std::chrono::system_clock>& testing_last_send_time() const {
     return last_send_time_;
   }
 
+  // Shuffle sinks read the selected rows of their input directly when partitioning it.
+  bool AcceptsSelectionVectors() const override { return !partition_sinks_.empty(); }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -90,6 +96,8 @@ class GRPCSinkNode : public SinkNode {
   Status StartConnectionWithRetries(ExecState* exec_state, size_t n_retries);
   Status CancelledByServer(ExecState* exec_state);
   Status TryWriteRequest(ExecState* exec_state, const carnotpb::TransferResultChunkRequest& req);
+  Status InitShuffle();
+  Status ShuffleBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
 
   bool cancelled_ = false;
 
@@ -100,6 +108,9 @@ class GRPCSinkNode : public SinkNode {
   std::unique_ptr<grpc::ClientWriterInterface<carnotpb::TransferResultChunkRequest>> writer_;
 
   std::unique_ptr<plan::GRPCSinkOperator> plan_node_;
+  // For shuffle sinks, the sink of each shuffle destination. Partition i of the rows is sent
+  // through partition_sinks_[i], which handles the connection just like a regular sink.
+  std::vector<std::unique_ptr<GRPCSinkNode>> partition_sinks_;
   std::unique_ptr<table_store::schema::RowDescriptor> input_descriptor_;
 
   std::chrono::milliseconds connection_check_timeout_ = kDefaultConnectionCheckTimeoutMS;
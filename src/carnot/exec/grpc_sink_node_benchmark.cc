@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include <absl/strings/str_cat.h>
 #include <benchmark/benchmark.h>
 #include <grpcpp/test/mock_stream.h>
 #include <gtest/gtest.h>
@@ -104,3 +105,79 @@ void BM_GRPCSinkNodeSplitting(benchmark::State& state) {
 }
 
 BENCHMARK(BM_GRPCSinkNodeSplitting)->Unit(benchmark::kMillisecond);
+
+// Measures the cost of serializing row batches sent to another agent, with the row-wise
+// RowBatchData (arg 0), the columnar format (arg 1) and the compressed columnar format (arg 2).
+// NOLINTNEXTLINE : runtime/references.
+void BM_GRPCSinkNodeEncoding(benchmark::State& state) {
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+
+  auto mock_unique = std::make_unique<::testing::NiceMock<MockResultSinkServiceStub>>();
+  auto mock = mock_unique.get();
+
+  auto exec_state = std::make_unique<px::carnot::exec::ExecState>(
+      func_registry.get(), table_store,
+      [&](const std::string&, const std::string&)
+          -> std::unique_ptr<ResultSinkService::StubInterface> { return std::move(mock_unique); },
+      MockMetricsStubGenerator, MockTraceStubGenerator, sole::uuid4(), nullptr, nullptr,
+      [&](grpc::ClientContext*) {});
+  RowBatch::ColumnarEncodingOptions opts;
+  opts.compress = state.range(0) == 2;
+  exec_state->set_columnar_transfer(state.range(0) > 0, opts);
+
+  TransferResultChunkResponse resp;
+  resp.set_success(true);
+  size_t wire_bytes = 0;
+  auto writer =
+      new ::testing::NiceMock<grpc::testing::MockClientWriter<TransferResultChunkRequest>>();
+  ON_CALL(*writer, Write(_, _))
+      .WillByDefault(
+          ::testing::Invoke([&](const TransferResultChunkRequest& req, grpc::WriteOptions) {
+            wire_bytes += req.ByteSizeLong();
+            return true;
+          }));
+  ON_CALL(*writer, WritesDone()).WillByDefault(Return(true));
+  ON_CALL(*writer, Finish()).WillByDefault(Return(grpc::Status::OK));
+  ON_CALL(*mock, TransferResultChunkRaw(_, _))
+      .WillByDefault(DoAll(SetArgPointee<1>(resp), Return(writer)));
+
+  px::carnot::exec::GRPCSinkNode node;
+  // Sends to a GRPC source, ie. another agent.
+  auto op_proto = px::carnot::planpb::testutils::CreateTestGRPCSink1PB();
+  auto plan_node = std::make_unique<px::carnot::plan::GRPCSinkOperator>(1);
+  PL_CHECK_OK(plan_node->Init(op_proto.grpc_sink_op()));
+
+  auto num_rows = 1024;
+  RowDescriptor rd({DataType::TIME64NS, DataType::INT64, DataType::STRING, DataType::STRING});
+  PL_CHECK_OK(node.Init(*plan_node, rd, {rd}));
+  PL_CHECK_OK(node.Prepare(exec_state.get()));
+  PL_CHECK_OK(node.Open(exec_state.get()));
+
+  std::vector<px::types::Time64NSValue> times(num_rows);
+  std::vector<px::types::Int64Value> latencies(num_rows);
+  std::vector<px::types::StringValue> methods(num_rows);
+  std::vector<px::types::StringValue> paths(num_rows);
+  for (int i = 0; i < num_rows; ++i) {
+    times[i] = 1'600'000'000'000'000'000 + i * 1'000;
+    latencies[i] = (i * 7919) % 100'000;
+    methods[i] = (i % 4 == 0) ? "POST" : "GET";
+    paths[i] = absl::StrCat("/api/v1/items/", i);
+  }
+  auto row_batch_builder =
+      px::carnot::exec::RowBatchBuilder(rd, num_rows, /*eow*/ false, /*eos*/ false);
+  row_batch_builder.AddColumn<px::types::Time64NSValue>(times);
+  row_batch_builder.AddColumn<px::types::Int64Value>(latencies);
+  row_batch_builder.AddColumn<px::types::StringValue>(methods);
+  row_batch_builder.AddColumn<px::types::StringValue>(paths);
+  auto rb = row_batch_builder.get();
+
+  for (auto _ : state) {
+    PL_CHECK_OK(node.ConsumeNext(exec_state.get(), rb, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+  state.counters["wire_bytes_per_batch"] =
+      benchmark::Counter(wire_bytes, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_GRPCSinkNodeEncoding)->DenseRange(0, 2);
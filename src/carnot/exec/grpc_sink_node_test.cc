@@ -18,9 +18,13 @@
 
 #include "src/carnot/exec/grpc_sink_node.h"
 
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+#include <google/protobuf/text_format.h>
 #include <grpcpp/test/mock_stream.h>
 #include <gtest/gtest.h>
 #include <sole.hpp>
@@ -763,6 +767,96 @@ TEST_F(GRPCSinkNodeTest, check_connection_after_eos) {
   tester.Close();
 }
 
+constexpr char kShuffleGRPCSink[] = R"proto(
+shuffle_destinations {
+  address: "kelvin1:1234"
+  grpc_source_id: 5
+}
+shuffle_destinations {
+  address: "kelvin2:1234"
+  grpc_source_id: 6
+}
+partition_column_idxs: 0
+)proto";
+
+TEST(GRPCSinkNodeShuffleTest, partitions_rows_by_key) {
+  planpb::GRPCSinkOperator op_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kShuffleGRPCSink, &op_proto));
+  plan::GRPCSinkOperator plan_node(1);
+  ASSERT_OK(plan_node.Init(op_proto));
+
+  // Each destination gets its own stub and writer, which record the requests sent to it.
+  TransferResultChunkResponse resp;
+  resp.set_success(true);
+  absl::flat_hash_map<std::string, std::unique_ptr<MockResultSinkServiceStub>> stubs;
+  absl::flat_hash_map<std::string, std::vector<TransferResultChunkRequest>> requests;
+  for (const auto& dest : op_proto.shuffle_destinations()) {
+    auto stub = std::make_unique<MockResultSinkServiceStub>();
+    auto writer = new grpc::testing::MockClientWriter<TransferResultChunkRequest>();
+    auto* dest_requests = &requests[dest.address()];
+    EXPECT_CALL(*writer, Write(_, _))
+        .WillRepeatedly(Invoke([dest_requests](const TransferResultChunkRequest& req,
+                                               grpc::WriteOptions) {
+          dest_requests->push_back(req);
+          return true;
+        }));
+    EXPECT_CALL(*writer, WritesDone());
+    EXPECT_CALL(*writer, Finish()).WillOnce(Return(grpc::Status::OK));
+    EXPECT_CALL(*stub, TransferResultChunkRaw(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(resp), Return(writer)));
+    stubs[dest.address()] = std::move(stub);
+  }
+
+  auto func_registry = std::make_unique<udf::Registry>("test_registry");
+  auto exec_state = std::make_unique<ExecState>(
+      func_registry.get(), std::make_shared<table_store::TableStore>(),
+      [&stubs](const std::string& address,
+               const std::string&) -> std::unique_ptr<ResultSinkService::StubInterface> {
+        return std::move(stubs[address]);
+      },
+      MockMetricsStubGenerator, MockTraceStubGenerator, sole::uuid4(), nullptr, nullptr,
+      [](grpc::ClientContext*) {});
+
+  RowDescriptor rd({types::DataType::INT64, types::DataType::STRING});
+  auto tester = exec::ExecNodeTester<GRPCSinkNode, plan::GRPCSinkOperator>(plan_node, rd, {rd},
+                                                                          exec_state.get());
+  std::vector<types::Int64Value> keys = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<types::StringValue> values = {"a", "b", "c", "d", "e", "f", "g", "h"};
+  for (int i = 0; i < 2; ++i) {
+    auto rb = RowBatchBuilder(rd, keys.size(), /*eow*/ i == 1, /*eos*/ i == 1)
+                  .AddColumn<types::Int64Value>(keys)
+                  .AddColumn<types::StringValue>(values)
+                  .get();
+    tester.ConsumeNext(rb, 0, 0);
+  }
+  tester.Close();
+
+  // Every key is sent to exactly one destination, the same one for both batches, along with the
+  // rest of its row.
+  absl::flat_hash_map<int64_t, std::string> key_to_dest;
+  int64_t num_rows = 0;
+  for (const auto& dest : op_proto.shuffle_destinations()) {
+    const auto& dest_requests = requests[dest.address()];
+    ASSERT_GE(dest_requests.size(), 2);
+    for (const auto& req : dest_requests) {
+      EXPECT_EQ(dest.address(), req.address());
+      EXPECT_EQ(dest.grpc_source_id(), req.query_result().grpc_source_id());
+      const auto& rb = req.query_result().row_batch();
+      num_rows += rb.num_rows();
+      for (int64_t row = 0; row < rb.num_rows(); ++row) {
+        int64_t key = rb.cols(0).int64_data().data(row);
+        EXPECT_EQ(std::string(values[key - 1]), rb.cols(1).string_data().data(row));
+        auto [it, inserted] = key_to_dest.try_emplace(key, dest.address());
+        EXPECT_EQ(dest.address(), it->second) << "key " << key << " sent to both destinations";
+      }
+    }
+    // Each destination receives the end of the stream.
+    EXPECT_TRUE(dest_requests.back().query_result().row_batch().eos());
+  }
+  EXPECT_EQ(2 * keys.size(), num_rows);
+  EXPECT_EQ(keys.size(), key_to_dest.size());
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
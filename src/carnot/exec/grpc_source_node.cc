@@ -72,14 +72,28 @@ Status GRPCSourceNode::PopRowBatch() {
         "Called GRPCSourceNode::OptionallyPopRowBatch but there was no available row batch in the "
         "queue.");
   }
-  if (!rb_request->has_query_result() || !rb_request->query_result().has_row_batch()) {
+  if (window_ != nullptr) {
+    window_->Release(rb_request->ByteSizeLong());
+  }
+  if (!rb_request->has_query_result()) {
     return error::Internal(
         "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
         "message.");
   }
 
-  PL_ASSIGN_OR_RETURN(rb_, RowBatch::FromProto(rb_request->query_result().row_batch()));
-  return Status::OK();
+  const auto& query_result = rb_request->query_result();
+  switch (query_result.result_contents_case()) {
+    case carnotpb::TransferResultChunkRequest::SinkResult::kRowBatch:
+      PL_ASSIGN_OR_RETURN(rb_, RowBatch::FromProto(query_result.row_batch()));
+      return Status::OK();
+    case carnotpb::TransferResultChunkRequest::SinkResult::kColumnarRowBatch:
+      PL_ASSIGN_OR_RETURN(rb_, RowBatch::FromColumnarProto(query_result.columnar_row_batch()));
+      return Status::OK();
+    default:
+      return error::Internal(
+          "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
+          "message.");
+  }
 }
 
 bool GRPCSourceNode::NextBatchReady() {
@@ -21,6 +21,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/carnotpb/carnot.pb.h"
@@ -56,6 +57,10 @@ class GRPCSourceNode : public SourceNode {
   void set_upstream_closed_connection() { upstream_closed_connection_ = true; }
   bool upstream_closed_connection() const { return upstream_closed_connection_; }
 
+  // The flow control window of this source. The credits of each row batch are returned to it
+  // once the batch is popped off the queue.
+  void set_window(std::shared_ptr<GRPCSourceWindow> window) { window_ = std::move(window); }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -74,6 +79,7 @@ class GRPCSourceNode : public SourceNode {
   std::unique_ptr<plan::GRPCSourceOperator> plan_node_;
   bool upstream_initiated_connection_ = false;
   bool upstream_closed_connection_ = false;
+  std::shared_ptr<GRPCSourceWindow> window_;
 };
 
 }  // namespace exec
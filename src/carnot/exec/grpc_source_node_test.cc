@@ -87,6 +87,34 @@ TEST_F(GRPCSourceNodeTest, basic) {
   EXPECT_FALSE(tester.node()->HasBatchesRemaining());
 }
 
+TEST_F(GRPCSourceNodeTest, columnar_row_batches) {
+  auto op_proto = planpb::testutils::CreateTestGRPCSource1PB();
+  std::unique_ptr<plan::Operator> plan_node = plan::GRPCSourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::STRING});
+
+  auto tester = exec::ExecNodeTester<GRPCSourceNode, plan::GRPCSourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+
+  for (auto i = 0; i < 2; ++i) {
+    auto rb = RowBatchBuilder(output_rd, 3, /*eow*/ i == 1, /*eos*/ i == 1)
+                  .AddColumn<types::Int64Value>({i, -5, 100})
+                  .AddColumn<types::StringValue>({"abc", "abc", ""})
+                  .get();
+
+    table_store::schema::RowBatch::ColumnarEncodingOptions opts;
+    opts.compress = i == 1;
+    auto rb_wrapper = std::make_unique<carnotpb::TransferResultChunkRequest>();
+    EXPECT_OK(
+        rb.ToColumnarProto(opts, rb_wrapper->mutable_query_result()->mutable_columnar_row_batch()));
+    EXPECT_OK(tester.node()->EnqueueRowBatch(std::move(rb_wrapper)));
+
+    EXPECT_TRUE(tester.node()->NextBatchReady());
+    tester.GenerateNextResult().ExpectRowBatch(rb);
+  }
+
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/map_node.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,12 @@ Status MapNode::InitImpl(const plan::Operator& plan_node) {
   const auto* map_plan_node = static_cast<const plan::MapOperator*>(&plan_node);
   // copy the plan node to local object;
   plan_node_ = std::make_unique<plan::MapOperator>(*map_plan_node);
+  for (const auto& expr : plan_node_->expressions()) {
+    if (expr->ExpressionType() == plan::Expression::kFunc) {
+      has_func_exprs_ = true;
+    }
+  }
+  PL_ASSIGN_OR_RETURN(input_cols_, InputColumnsOf(plan_node_->expressions()));
   return Status::OK();
 }
 Status MapNode::PrepareImpl(ExecState* exec_state) {
@@ -62,8 +69,19 @@ Status MapNode::CloseImpl(ExecState* exec_state) {
   return Status::OK();
 }
 Status MapNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
-  RowBatch output_rb(*output_descriptor_, rb.num_rows());
-  PL_RETURN_IF_ERROR(evaluator_->Evaluate(exec_state, rb, &output_rb));
+  const RowBatch* input_rb = &rb;
+  std::unique_ptr<RowBatch> materialized_rb;
+  // Functions are evaluated on every row of the input's arrays, so they must only see the selected
+  // rows: an earlier filter may have dropped the others because the function isn't defined on
+  // them (eg. a modulo by zero). Only the columns the expressions read are gathered.
+  if (has_func_exprs_ && rb.HasSelection()) {
+    PL_ASSIGN_OR_RETURN(materialized_rb, rb.Materialize(input_cols_));
+    input_rb = materialized_rb.get();
+  }
+  // Column expressions share the input's arrays, so the output keeps the input's selection.
+  RowBatch output_rb(*output_descriptor_, input_rb->num_rows());
+  PL_RETURN_IF_ERROR(evaluator_->Evaluate(exec_state, *input_rb, &output_rb));
+  output_rb.SetSelection(input_rb->selection());
   output_rb.set_eow(rb.eow());
   output_rb.set_eos(rb.eos());
   PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
@@ -41,6 +41,8 @@ class MapNode : public ProcessingNode {
   MapNode() = default;
   virtual ~MapNode() = default;
 
+  bool AcceptsSelectionVectors() const override { return true; }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -54,6 +56,12 @@ class MapNode : public ProcessingNode {
   std::unique_ptr<ExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::MapOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  // Whether any of the expressions call a function, rather than only passing through columns
+  // and constants.
+  bool has_func_exprs_ = false;
+  // The input columns read by the expressions. Only these are gathered when the expressions must
+  // be evaluated on the selected rows alone.
+  std::vector<int64_t> input_cols_;
 };
 
 }  // namespace exec
@@ -19,14 +19,21 @@
 #include "src/carnot/exec/memory_source_node.h"
 #include "src/table_store/table/table.h"
 
+#include <algorithm>
 #include <limits>
+#include <numeric>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
 
 namespace px {
 namespace carnot {
@@ -34,6 +41,135 @@ namespace exec {
 
 using StartSpec = Table::Cursor::StartSpec;
 using StopSpec = Table::Cursor::StopSpec;
+using ColumnPredicate = Table::ColumnPredicate;
+
+namespace {
+
+using PredicateLiteral = Table::PredicateLiteral;
+
+StatusOr<PredicateLiteral> PredicateLiteralFromProto(const planpb::ScalarValue& value,
+                                                     int64_t column_idx) {
+  switch (value.value_case()) {
+    case planpb::ScalarValue::kBoolValue:
+      return PredicateLiteral(value.bool_value());
+    case planpb::ScalarValue::kInt64Value:
+      return PredicateLiteral(value.int64_value());
+    case planpb::ScalarValue::kFloat64Value:
+      return PredicateLiteral(value.float64_value());
+    case planpb::ScalarValue::kStringValue:
+      return PredicateLiteral(value.string_value());
+    case planpb::ScalarValue::kTime64NsValue:
+      return PredicateLiteral(value.time64_ns_value());
+    case planpb::ScalarValue::kUint128Value:
+      return PredicateLiteral(
+          absl::MakeUint128(value.uint128_value().high(), value.uint128_value().low()));
+    default:
+      return error::InvalidArgument("Scan predicate on column $0 has no value", column_idx);
+  }
+}
+
+// Returns the cursor predicate for the given scan predicate, or std::nullopt if the cursor can't
+// use it to skip data.
+StatusOr<std::optional<ColumnPredicate>> ColumnPredicateFromProto(
+    const planpb::ScanPredicate& pb) {
+  ColumnPredicate pred;
+  pred.col_idx = pb.column_idx();
+  switch (pb.op()) {
+    case planpb::ScanPredicate::EQUAL:
+      pred.op = ColumnPredicate::Op::kEqual;
+      break;
+    case planpb::ScanPredicate::NOT_EQUAL:
+      pred.op = ColumnPredicate::Op::kNotEqual;
+      break;
+    case planpb::ScanPredicate::LESS_THAN:
+      pred.op = ColumnPredicate::Op::kLessThan;
+      break;
+    case planpb::ScanPredicate::LESS_THAN_EQUAL:
+      pred.op = ColumnPredicate::Op::kLessThanEqual;
+      break;
+    case planpb::ScanPredicate::GREATER_THAN:
+      pred.op = ColumnPredicate::Op::kGreaterThan;
+      break;
+    case planpb::ScanPredicate::GREATER_THAN_EQUAL:
+      pred.op = ColumnPredicate::Op::kGreaterThanEqual;
+      break;
+    case planpb::ScanPredicate::IN:
+      return std::optional<ColumnPredicate>();
+    default:
+      return error::InvalidArgument("Unknown scan predicate op $0", pb.op());
+  }
+  PL_ASSIGN_OR_RETURN(pred.literal, PredicateLiteralFromProto(pb.value(), pb.column_idx()));
+  return std::optional<ColumnPredicate>(std::move(pred));
+}
+
+template <types::DataType T>
+bool LiteralMatchesType(const PredicateLiteral& literal) {
+  using TNative = typename types::DataTypeTraits<T>::native_type;
+  return std::holds_alternative<TNative>(literal);
+}
+
+// Removes the rows for which cmp returns false from the selection.
+template <types::DataType T, typename TCmp>
+void RetainRows(const arrow::Array* arr, TCmp cmp, std::vector<int64_t>* selection) {
+  size_t num_selected = 0;
+  for (auto row_idx : *selection) {
+    bool match;
+    // Strings are compared as views into the arrow array, to avoid copying every value.
+    if constexpr (T == types::DataType::STRING) {
+      match = cmp(types::GetStringViewFromArrowArray(arr, row_idx));
+    } else {
+      match = cmp(types::GetValueFromArrowArray<T>(arr, row_idx));
+    }
+    if (match) {
+      (*selection)[num_selected++] = row_idx;
+    }
+  }
+  selection->resize(num_selected);
+}
+
+template <types::DataType T>
+void RetainMatchingRows(planpb::ScanPredicate::Op op,
+                        const std::vector<PredicateLiteral>& literals, const arrow::Array* arr,
+                        std::vector<int64_t>* selection) {
+  using TNative = typename types::DataTypeTraits<T>::native_type;
+  if (op == planpb::ScanPredicate::IN) {
+    RetainRows<T>(
+        arr,
+        [&](const auto& val) {
+          return std::any_of(literals.begin(), literals.end(), [&](const auto& literal) {
+            return val == std::get<TNative>(literal);
+          });
+        },
+        selection);
+    return;
+  }
+  DCHECK_EQ(literals.size(), 1U);
+  const TNative& literal = std::get<TNative>(literals[0]);
+  switch (op) {
+    case planpb::ScanPredicate::EQUAL:
+      RetainRows<T>(arr, [&](const auto& val) { return val == literal; }, selection);
+      return;
+    case planpb::ScanPredicate::NOT_EQUAL:
+      RetainRows<T>(arr, [&](const auto& val) { return !(val == literal); }, selection);
+      return;
+    case planpb::ScanPredicate::LESS_THAN:
+      RetainRows<T>(arr, [&](const auto& val) { return val < literal; }, selection);
+      return;
+    case planpb::ScanPredicate::LESS_THAN_EQUAL:
+      RetainRows<T>(arr, [&](const auto& val) { return val <= literal; }, selection);
+      return;
+    case planpb::ScanPredicate::GREATER_THAN:
+      RetainRows<T>(arr, [&](const auto& val) { return literal < val; }, selection);
+      return;
+    case planpb::ScanPredicate::GREATER_THAN_EQUAL:
+      RetainRows<T>(arr, [&](const auto& val) { return literal <= val; }, selection);
+      return;
+    default:
+      DCHECK(false) << "Unexpected scan predicate op " << op;
+  }
+}
+
+}  // namespace
 
 std::string MemorySourceNode::DebugStringImpl() {
   return absl::Substitute("Exec::MemorySourceNode: <name: $0, output: $1>", plan_node_->TableName(),
@@ -79,16 +215,95 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
     // Determine table_end at Open() time because Stirling may be pushing to the table
     stop_spec.type = StopSpec::StopType::CurrentEndOfTable;
   }
-  cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec);
+  PL_RETURN_IF_ERROR(InitRowPredicates());
+  // The cursor uses the predicates to skip data that can't match, the rows it does return are
+  // filtered by ApplyRowPredicates.
+  std::vector<ColumnPredicate> predicates;
+  for (const auto& pred_pb : plan_node_->predicates()) {
+    PL_ASSIGN_OR_RETURN(auto pred, ColumnPredicateFromProto(pred_pb));
+    if (pred.has_value()) {
+      predicates.push_back(std::move(pred.value()));
+    }
+  }
+  cursor_ = std::make_unique<Table::Cursor>(table_, start_spec, stop_spec, std::move(predicates));
 
   return Status::OK();
 }
 
-Status MemorySourceNode::CloseImpl(ExecState*) {
-  stats()->AddExtraInfo("infinite_stream", infinite_stream_ ? "true" : "false");
+Status MemorySourceNode::InitRowPredicates() {
+  scan_cols_ = plan_node_->Columns();
+  row_predicates_.clear();
+  const auto& rel = table_->GetRelation();
+  auto num_table_cols = static_cast<int64_t>(rel.NumColumns());
+  for (const auto& pred_pb : plan_node_->predicates()) {
+    auto col_idx = pred_pb.column_idx();
+    if (col_idx < 0 || col_idx >= num_table_cols) {
+      return error::InvalidArgument("Scan predicate column $0 is not in table '$1'", col_idx,
+                                    plan_node_->TableName());
+    }
+    RowPredicate pred;
+    pred.op = pred_pb.op();
+    pred.data_type = rel.GetColumnType(col_idx);
+    if (pred.op == planpb::ScanPredicate::IN) {
+      for (const auto& value : pred_pb.in_values()) {
+        PL_ASSIGN_OR_RETURN(auto literal, PredicateLiteralFromProto(value, col_idx));
+        pred.literals.push_back(std::move(literal));
+      }
+    } else {
+      PL_ASSIGN_OR_RETURN(auto literal, PredicateLiteralFromProto(pred_pb.value(), col_idx));
+      pred.literals.push_back(std::move(literal));
+    }
+    for (const auto& literal : pred.literals) {
+      bool matches_type = false;
+#define TYPE_CASE(_dt_) matches_type = LiteralMatchesType<_dt_>(literal);
+      PL_SWITCH_FOREACH_DATATYPE(pred.data_type, TYPE_CASE);
+#undef TYPE_CASE
+      if (!matches_type) {
+        return error::InvalidArgument("Scan predicate value doesn't match the type of column $0",
+                                      rel.GetColumnName(col_idx));
+      }
+    }
+
+    // Columns that are only read by the predicates are scanned after the output columns, and
+    // dropped once the predicates are applied.
+    auto it = std::find(scan_cols_.begin(), scan_cols_.end(), col_idx);
+    pred.scan_col_idx = std::distance(scan_cols_.begin(), it);
+    if (it == scan_cols_.end()) {
+      scan_cols_.push_back(col_idx);
+    }
+    row_predicates_.push_back(std::move(pred));
+  }
   return Status::OK();
 }
 
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::ApplyRowPredicates(
+    std::unique_ptr<RowBatch> scanned) {
+  if (row_predicates_.empty()) {
+    return scanned;
+  }
+  RowBatch::SelectionVector selection(scanned->num_rows());
+  std::iota(selection.begin(), selection.end(), 0);
+  for (const auto& pred : row_predicates_) {
+    if (selection.empty()) {
+      break;
+    }
+    auto arr = scanned->ColumnAt(pred.scan_col_idx).get();
+#define TYPE_CASE(_dt_) RetainMatchingRows<_dt_>(pred.op, pred.literals, arr, &selection);
+    PL_SWITCH_FOREACH_DATATYPE(pred.data_type, TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  // The output shares the scanned arrays and selects the matching rows, rather than copying them.
+  auto output_rb = std::make_unique<RowBatch>(*output_descriptor_, scanned->num_rows());
+  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(scanned->ColumnAt(i)));
+  }
+  if (static_cast<int64_t>(selection.size()) != scanned->num_rows()) {
+    output_rb->SetSelection(std::make_shared<RowBatch::SelectionVector>(std::move(selection)));
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*) {
   DCHECK(table_ != nullptr);
 
@@ -102,10 +317,14 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
                                   /* eos */ cursor_->Done());
   }
 
-  PL_ASSIGN_OR_RETURN(auto row_batch, cursor_->GetNextRowBatch(plan_node_->Columns()));
-
-  rows_processed_ += row_batch->num_rows();
-  bytes_processed_ += row_batch->NumBytes();
+  std::unique_ptr<RowBatch> row_batch;
+  do {
+    PL_ASSIGN_OR_RETURN(auto scanned, cursor_->GetNextRowBatch(scan_cols_));
+    rows_processed_ += scanned->num_rows();
+    bytes_processed_ += scanned->NumBytes();
+    PL_ASSIGN_OR_RETURN(row_batch, ApplyRowPredicates(std::move(scanned)));
+    // Batches without any matching rows aren't worth sending, as long as there is more to read.
+  } while (row_batch->num_selected_rows() == 0 && cursor_->NextBatchReady());
 
   // If infinite stream is set, we don't send Eow or Eos. Infinite streams therefore never cause
   // HasBatchesRemaining to be false. Instead the outer loop that calls GenerateNext() is
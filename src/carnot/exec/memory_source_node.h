@@ -26,6 +26,7 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/plan/operators.h"
+#include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
 #include "src/table_store/schema/row_batch.h"
@@ -55,7 +56,23 @@ class MemorySourceNode : public SourceNode {
   Status GenerateNextImpl(ExecState* exec_state) override;
 
  private:
+  // RowPredicate is a scan predicate resolved against the batches read from the cursor.
+  struct RowPredicate {
+    planpb::ScanPredicate::Op op;
+    // The index of the predicate's column in scan_cols_.
+    int64_t scan_col_idx;
+    types::DataType data_type;
+    // The values to compare against. IN predicates have one per value, other ops have one.
+    std::vector<Table::PredicateLiteral> literals;
+  };
+
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
+  // Creates the RowPredicates for the plan's scan predicates, and adds the columns they read to
+  // scan_cols_.
+  Status InitRowPredicates();
+  // Returns a row batch of the output columns of the scanned batch, with a selection of the rows
+  // that match all of row_predicates_.
+  StatusOr<std::unique_ptr<RowBatch>> ApplyRowPredicates(std::unique_ptr<RowBatch> scanned);
   bool InfiniteStreamNextBatchReady();
   // Whether this memory source will stream infinitely. Can be stopped by the
   // exec_state_->keep_running() call in exec_graph.
@@ -63,6 +80,11 @@ class MemorySourceNode : public SourceNode {
 
   std::unique_ptr<Table::Cursor> cursor_;
 
+  // The table columns read from the cursor: the output columns, followed by any columns that are
+  // only read by the scan predicates.
+  std::vector<int64_t> scan_cols_;
+  std::vector<RowPredicate> row_predicates_;
+
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
   table_store::Table* table_ = nullptr;
 };
@@ -223,6 +223,104 @@ TEST_F(MemorySourceNodeTest, all_range) {
   tester.Close();
 }
 
+TEST_F(MemorySourceNodeTest, scan_predicates_skip_cold_batches) {
+  // Compacts the table into cold batches with times {1, 2} and {3, 5}, leaving {6} in hot.
+  EXPECT_OK(cpu_table_->CompactHotToCold(arrow::default_memory_pool()));
+
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* pred = op_proto.mutable_mem_source_op()->add_predicates();
+  pred->set_column_idx(1);
+  pred->set_op(planpb::ScanPredicate::GREATER_THAN_EQUAL);
+  pred->mutable_value()->set_data_type(types::DataType::TIME64NS);
+  pred->mutable_value()->set_time64_ns_value(5);
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  // The first cold batch can't match and is skipped, the rows of the others are filtered.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({5})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  EXPECT_EQ(3, tester.node()->RowsProcessed());
+}
+
+TEST_F(MemorySourceNodeTest, scan_predicate_in) {
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* pred = op_proto.mutable_mem_source_op()->add_predicates();
+  pred->set_column_idx(1);
+  pred->set_op(planpb::ScanPredicate::IN);
+  for (int64_t val : {2, 6}) {
+    auto* in_value = pred->add_in_values();
+    in_value->set_data_type(types::DataType::TIME64NS);
+    in_value->set_time64_ns_value(val);
+  }
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({2})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 1, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({6})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+  EXPECT_EQ(5, tester.node()->RowsProcessed());
+}
+
+TEST_F(MemorySourceNodeTest, scan_predicate_on_column_not_in_output) {
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* pred = op_proto.mutable_mem_source_op()->add_predicates();
+  pred->set_column_idx(0);
+  pred->set_op(planpb::ScanPredicate::EQUAL);
+  pred->mutable_value()->set_data_type(types::DataType::BOOLEAN);
+  pred->mutable_value()->set_bool_value(true);
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  // The second batch has no matching rows, so it's folded into the final zero row batch.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 2, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({1, 3})
+          .get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 0, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+}
+
+TEST_F(MemorySourceNodeTest, scan_predicate_type_mismatch) {
+  auto op_proto = planpb::testutils::CreateTestSource1PB();
+  auto* pred = op_proto.mutable_mem_source_op()->add_predicates();
+  pred->set_column_idx(1);
+  pred->set_op(planpb::ScanPredicate::EQUAL);
+  pred->mutable_value()->set_data_type(types::DataType::STRING);
+  pred->mutable_value()->set_string_value("abc");
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  MemorySourceNode node;
+  ASSERT_OK(node.Init(*plan_node, output_rd, std::vector<RowDescriptor>({})));
+  ASSERT_OK(node.Prepare(exec_state_.get()));
+  EXPECT_NOT_OK(node.Open(exec_state_.get()));
+}
+
 class MemorySourceNodeTabletTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/parallel_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include <absl/strings/substitute.h>
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+MorselWorkerPool::MorselWorkerPool(size_t num_workers) {
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&MorselWorkerPool::WorkerLoop, this, i);
+  }
+}
+
+MorselWorkerPool::~MorselWorkerPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    stopped_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void MorselWorkerPool::WorkerLoop(size_t worker_idx) {
+  while (true) {
+    Task task;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(this, &MorselWorkerPool::HasWorkOrStopped));
+      if (tasks_.empty()) {
+        // Stopped, and there is no work left.
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    auto s = task(worker_idx);
+    absl::MutexLock lock(&mu_);
+    if (!s.ok() && status_.ok()) {
+      status_ = s;
+    }
+    --num_pending_;
+  }
+}
+
+Status MorselWorkerPool::Submit(Task task) {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(this, &MorselWorkerPool::HasCapacity));
+  PL_RETURN_IF_ERROR(status_);
+  tasks_.push_back(std::move(task));
+  ++num_pending_;
+  return Status::OK();
+}
+
+Status MorselWorkerPool::Wait() {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(this, &MorselWorkerPool::Idle));
+  return status_;
+}
+
+bool MorselWorkerPool::TrySubmit(Task task) {
+  absl::MutexLock lock(&mu_);
+  if (!HasCapacity()) {
+    return false;
+  }
+  tasks_.push_back(std::move(task));
+  ++num_pending_;
+  return true;
+}
+
+namespace {
+
+// The tasks of a single ParallelFor call. Helpers queued on the pool may only start after the call
+// returned, so they share ownership of this, and only touch fn once they have claimed a task.
+struct ParallelForState {
+  ParallelForState(size_t num_tasks, const std::function<Status(size_t)>* fn)
+      : num_tasks(num_tasks), fn(fn) {}
+
+  const size_t num_tasks;
+  const std::function<Status(size_t)>* fn;
+  std::atomic<size_t> next_task{0};
+
+  absl::Mutex mu;
+  size_t num_done ABSL_GUARDED_BY(mu) = 0;
+  Status status ABSL_GUARDED_BY(mu);
+
+  bool Done() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu) { return num_done == num_tasks; }
+
+  void RunTasks() {
+    for (size_t i = next_task++; i < num_tasks; i = next_task++) {
+      auto s = (*fn)(i);
+      absl::MutexLock lock(&mu);
+      if (!s.ok() && status.ok()) {
+        status = s;
+      }
+      ++num_done;
+    }
+  }
+};
+
+}  // namespace
+
+Status MorselWorkerPool::ParallelFor(size_t num_tasks,
+                                     const std::function<Status(size_t task_idx)>& fn) {
+  if (num_tasks == 0) {
+    return Status::OK();
+  }
+  auto state = std::make_shared<ParallelForState>(num_tasks, &fn);
+  size_t num_helpers = std::min(num_tasks, workers_.size() + 1) - 1;
+  for (size_t i = 0; i < num_helpers; ++i) {
+    if (!TrySubmit([state](size_t) {
+          state->RunTasks();
+          return Status::OK();
+        })) {
+      break;
+    }
+  }
+  state->RunTasks();
+
+  absl::MutexLock lock(&state->mu);
+  state->mu.Await(absl::Condition(state.get(), &ParallelForState::Done));
+  return state->status;
+}
+
+std::string MorselDispatchNode::DebugStringImpl() {
+  return absl::Substitute("Exec::MorselDispatchNode<workers: $0>", replica_heads_.size());
+}
+
+Status MorselDispatchNode::InitImpl(const plan::Operator&) {
+  return error::Internal("MorselDispatchNode is not created from a plan operator");
+}
+
+Status MorselDispatchNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  // The replicas are all copies of the same node.
+  std::shared_ptr<RowBatch> morsel;
+  if (rb.HasSelection() && !replica_heads_[0]->AcceptsSelectionVectors()) {
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<RowBatch> materialized_rb, rb.Materialize());
+    morsel = std::move(materialized_rb);
+  } else {
+    // Row batches only share their columns, so copying one for the worker is cheap.
+    morsel = std::make_shared<RowBatch>(rb);
+  }
+  if (rb.eow() || rb.eos()) {
+    PL_RETURN_IF_ERROR(pool_->Wait());
+    return replica_heads_[0]->ConsumeNext(exec_state, *morsel, 0);
+  }
+  return pool_->Submit([this, exec_state, morsel](size_t worker_idx) {
+    return replica_heads_[worker_idx]->ConsumeNext(exec_state, *morsel, 0);
+  });
+}
+
+std::string MorselMergeNode::DebugStringImpl() { return "Exec::MorselMergeNode"; }
+
+Status MorselMergeNode::InitImpl(const plan::Operator&) {
+  return error::Internal("MorselMergeNode is not created from a plan operator");
+}
+
+Status MorselMergeNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  absl::MutexLock lock(merge_lock_);
+  return SendRowBatchToChildren(exec_state, rb);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
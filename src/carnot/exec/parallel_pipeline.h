@@ -0,0 +1,158 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/common/base/base.h"
+#include "src/table_store/schema/row_batch.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * MorselWorkerPool runs the parallel pipelines of a single execution graph on a fixed set of
+ * worker threads. Each task (a morsel, ie. a single row batch from a source) is handed the index
+ * of the worker running it, and each worker owns its own replica of every parallel pipeline, so
+ * the nodes of a replica are never run by two threads at once.
+ */
+class MorselWorkerPool : public NotCopyable {
+ public:
+  using Task = std::function<Status(size_t worker_idx)>;
+
+  // The number of tasks that may be queued or running per worker. Submit blocks beyond this, so
+  // that a fast source can't buffer an unbounded amount of data ahead of the workers.
+  static constexpr size_t kMaxTasksPerWorker = 2;
+
+  explicit MorselWorkerPool(size_t num_workers);
+  ~MorselWorkerPool();
+
+  size_t num_workers() const { return workers_.size(); }
+
+  /**
+   * Submit queues a task to run on the next free worker, blocking while the pool is full.
+   * @return the first error returned by a previous task, in which case the task is not queued.
+   */
+  Status Submit(Task task);
+
+  /**
+   * Wait blocks until all submitted tasks have finished.
+   * @return the first error returned by any task.
+   */
+  Status Wait();
+
+  /**
+   * ParallelFor runs fn(i) for every i in [0, num_tasks) on the idle workers and the calling
+   * thread, and returns once they have all finished. The calling thread runs every task that no
+   * worker has picked up, so it never waits on a busy worker, and it is safe to call from a task
+   * (eg. by an AggNode fed by a parallel pipeline). Errors don't fail the pool's other tasks.
+   * @return the first error returned by fn.
+   */
+  Status ParallelFor(size_t num_tasks, const std::function<Status(size_t task_idx)>& fn);
+
+ private:
+  // Queues a task if the pool has room for it, without blocking.
+  bool TrySubmit(Task task);
+  void WorkerLoop(size_t worker_idx);
+  bool HasWorkOrStopped() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return stopped_ || !tasks_.empty();
+  }
+  bool HasCapacity() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return num_pending_ < kMaxTasksPerWorker * workers_.size();
+  }
+  bool Idle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return num_pending_ == 0; }
+
+  absl::Mutex mu_;
+  std::deque<Task> tasks_ ABSL_GUARDED_BY(mu_);
+  // Tasks that are queued or running.
+  size_t num_pending_ ABSL_GUARDED_BY(mu_) = 0;
+  Status status_ ABSL_GUARDED_BY(mu_);
+  bool stopped_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<std::thread> workers_;
+};
+
+/**
+ * MorselDispatchNode is spliced by the ExecutionGraph between a source and the first node of a
+ * parallel pipeline. Each row batch from the source is run through the replica of the pipeline
+ * owned by whichever worker picks it up. Row batches that end a window (or the stream) wait for
+ * all of the in-flight batches, and then run through the first replica on the calling thread, so
+ * that they still reach the end of the pipeline last.
+ */
+class MorselDispatchNode : public ProcessingNode {
+ public:
+  MorselDispatchNode(MorselWorkerPool* pool, std::vector<ExecNode*> replica_heads)
+      : pool_(pool), replica_heads_(std::move(replica_heads)) {}
+
+  // Selections are materialized for the replicas if they don't accept them.
+  bool AcceptsSelectionVectors() const override { return true; }
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState*) override { return Status::OK(); }
+  Status OpenImpl(ExecState*) override { return Status::OK(); }
+  Status CloseImpl(ExecState*) override { return Status::OK(); }
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  MorselWorkerPool* pool_;
+  // The first node of each replica of the pipeline, indexed by worker.
+  std::vector<ExecNode*> replica_heads_;
+};
+
+/**
+ * MorselMergeNode is spliced by the ExecutionGraph after the last node of each replica of a
+ * parallel pipeline. It forwards row batches to the node ending the pipeline (eg. an AggNode),
+ * holding a lock shared by all replicas so that the rest of the graph only ever runs on one
+ * thread at a time.
+ */
+class MorselMergeNode : public ProcessingNode {
+ public:
+  explicit MorselMergeNode(absl::Mutex* merge_lock) : merge_lock_(merge_lock) {}
+
+  bool AcceptsSelectionVectors() const override { return true; }
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState*) override { return Status::OK(); }
+  Status OpenImpl(ExecState*) override { return Status::OK(); }
+  Status CloseImpl(ExecState*) override { return Status::OK(); }
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  absl::Mutex* merge_lock_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <absl/synchronization/blocking_counter.h>
+#include <absl/synchronization/notification.h>
+
+#include "src/carnot/exec/parallel_pipeline.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+TEST(MorselWorkerPoolTest, parallel_for_runs_every_task) {
+  MorselWorkerPool pool(4);
+  std::vector<std::atomic<int>> runs(100);
+  ASSERT_OK(pool.ParallelFor(runs.size(), [&](size_t i) {
+    ++runs[i];
+    return Status::OK();
+  }));
+  for (const auto& num_runs : runs) {
+    EXPECT_EQ(1, num_runs);
+  }
+  EXPECT_OK(pool.ParallelFor(0, [](size_t) { return error::Internal("no tasks to run"); }));
+}
+
+TEST(MorselWorkerPoolTest, parallel_for_returns_task_error) {
+  MorselWorkerPool pool(2);
+  auto s = pool.ParallelFor(8, [](size_t i) {
+    return i == 5 ? error::Internal("task $0 failed", i) : Status::OK();
+  });
+  EXPECT_NOT_OK(s);
+  EXPECT_EQ("task 5 failed", s.msg());
+  // The error belongs to the call, not to the pool.
+  EXPECT_OK(pool.Wait());
+}
+
+// An AggNode below a parallel pipeline calls ParallelFor from a worker, while the other workers
+// may be blocked on that same AggNode (ie. on the merge lock).
+TEST(MorselWorkerPoolTest, parallel_for_from_worker_with_blocked_workers) {
+  constexpr size_t kNumWorkers = 3;
+  MorselWorkerPool pool(kNumWorkers);
+  absl::Notification done;
+  absl::BlockingCounter blocked(kNumWorkers - 1);
+  for (size_t i = 0; i < kNumWorkers - 1; ++i) {
+    ASSERT_OK(pool.Submit([&](size_t) {
+      blocked.DecrementCount();
+      done.WaitForNotification();
+      return Status::OK();
+    }));
+  }
+  std::atomic<int> sum = 0;
+  ASSERT_OK(pool.Submit([&](size_t) {
+    blocked.Wait();
+    auto s = pool.ParallelFor(16, [&](size_t i) {
+      sum += i;
+      return Status::OK();
+    });
+    done.Notify();
+    return s;
+  }));
+  ASSERT_OK(pool.Wait());
+  EXPECT_EQ(120, sum);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/carnot/exec/topk_node.h"
+
+#include <arrow/array.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/type_utils.h"
+
+DEFINE_int64(topk_max_unbounded_rows,
+             gflags::Int64FromEnv("PL_TOPK_MAX_UNBOUNDED_ROWS", 1000 * 1000),
+             "The number of rows that a sort without a limit keeps per window. Rows past it, in "
+             "sort order, are dropped.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+namespace {
+template <types::DataType DT>
+int CompareTupleValues(const RowTuple& a, const RowTuple& b, size_t idx) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  const auto& va = a.GetValue<ValueType>(idx);
+  const auto& vb = b.GetValue<ValueType>(idx);
+  if (va < vb) {
+    return -1;
+  }
+  if (vb < va) {
+    return 1;
+  }
+  return 0;
+}
+
+template <types::DataType DT>
+void AppendTupleValue(arrow::ArrayBuilder* builder, const RowTuple& rt, size_t idx) {
+  using ArrowBuilder = typename types::DataTypeTraits<DT>::arrow_builder_type;
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  auto status =
+      static_cast<ArrowBuilder*>(builder)->Append(udf::UnWrap(rt.GetValue<ValueType>(idx)));
+  PL_DCHECK_OK(status);
+  PL_UNUSED(status);
+}
+}  // namespace
+
+std::string TopKNode::DebugStringImpl() {
+  return absl::Substitute("Exec::TopKNode<$0>", plan_node_->DebugString());
+}
+
+Status TopKNode::InitImpl(const plan::Operator& plan_node) {
+  CHECK(plan_node.op_type() == planpb::OperatorType::TOPK_OPERATOR);
+  const auto* topk_plan_node = static_cast<const plan::TopKOperator*>(&plan_node);
+  // copy the plan node to local object;
+  plan_node_ = std::make_unique<plan::TopKOperator>(*topk_plan_node);
+  limit_ = plan_node_->record_limit();
+  // A sort without a limit would buffer its entire input, so it's capped like a TopK.
+  unbounded_ = limit_ < 0;
+  if (unbounded_) {
+    limit_ = FLAGS_topk_max_unbounded_rows;
+  }
+
+  if (input_descriptors_.size() != 1) {
+    return error::InvalidArgument("TopK operator expects a single input relation, got $0",
+                                  input_descriptors_.size());
+  }
+  const auto& input_descriptor = input_descriptors_[0];
+  num_sort_cols_ = plan_node_->sort_cols().size();
+  tuple_input_cols_ = plan_node_->sort_cols();
+  tuple_input_cols_.insert(tuple_input_cols_.end(), plan_node_->selected_cols().begin(),
+                           plan_node_->selected_cols().end());
+
+  for (int64_t input_col : tuple_input_cols_) {
+    auto dt = input_descriptor.type(input_col);
+    tuple_types_.push_back(dt);
+#define TYPE_CASE(_dt_)                               \
+  extract_fns_.push_back(&ExtractIntoRowTuple<_dt_>); \
+  compare_fns_.push_back(&CompareTupleValues<_dt_>);  \
+  append_fns_.push_back(&AppendTupleValue<_dt_>);
+    PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return Status::OK();
+}
+
+Status TopKNode::PrepareImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status TopKNode::OpenImpl(ExecState* /*exec_state*/) {
+  candidate_ = std::make_unique<RowTuple>(&tuple_types_);
+  if (!unbounded_) {
+    heap_.reserve(limit_);
+  }
+  return Status::OK();
+}
+
+Status TopKNode::CloseImpl(ExecState* /*exec_state*/) {
+  heap_.clear();
+  candidate_.reset();
+  return Status::OK();
+}
+
+bool TopKNode::RowLess(const RowTuple& a, const RowTuple& b) const {
+  const auto& ascending = plan_node_->ascending();
+  for (size_t i = 0; i < num_sort_cols_; ++i) {
+    int cmp = compare_fns_[i](a, b, i);
+    if (cmp != 0) {
+      return ascending[i] ? cmp < 0 : cmp > 0;
+    }
+  }
+  return false;
+}
+
+Status TopKNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  auto heap_less = [this](const auto& a, const auto& b) { return HeapLess(a, b); };
+
+  for (int64_t i = 0; i < rb.num_selected_rows() && limit_ != 0; ++i) {
+    auto row_idx = rb.selected_row(i);
+    candidate_->Reset();
+    // Only the sort columns are needed to decide whether the row is kept.
+    for (size_t col = 0; col < num_sort_cols_; ++col) {
+      extract_fns_[col](candidate_.get(), rb.ColumnAt(tuple_input_cols_[col]).get(), col,
+                        row_idx);
+    }
+    bool full = static_cast<int64_t>(heap_.size()) >= limit_;
+    if (full && unbounded_ && !dropped_rows_) {
+      LOG(WARNING) << absl::Substitute(
+          "Sort without a limit reached $0 rows, the last rows in sort order are dropped.",
+          limit_);
+      dropped_rows_ = true;
+    }
+    if (full && !RowLess(*candidate_, *heap_.front())) {
+      continue;
+    }
+    for (size_t col = num_sort_cols_; col < tuple_input_cols_.size(); ++col) {
+      extract_fns_[col](candidate_.get(), rb.ColumnAt(tuple_input_cols_[col]).get(), col,
+                        row_idx);
+    }
+    if (full) {
+      // Reuse the evicted row as the next candidate.
+      std::pop_heap(heap_.begin(), heap_.end(), heap_less);
+      std::swap(heap_.back(), candidate_);
+    } else {
+      heap_.push_back(std::move(candidate_));
+      candidate_ = std::make_unique<RowTuple>(&tuple_types_);
+    }
+    std::push_heap(heap_.begin(), heap_.end(), heap_less);
+  }
+
+  // Each window is sorted on its own, so the heap is emitted and cleared at the end of it.
+  if (rb.eow() || rb.eos()) {
+    return EmitRows(exec_state, rb.eos());
+  }
+  return Status::OK();
+}
+
+Status TopKNode::EmitRows(ExecState* exec_state, bool eos) {
+  std::sort_heap(heap_.begin(), heap_.end(),
+                 [this](const auto& a, const auto& b) { return HeapLess(a, b); });
+
+  RowBatch output_rb(*output_descriptor_, heap_.size());
+  for (size_t col = num_sort_cols_; col < tuple_input_cols_.size(); ++col) {
+    auto builder = types::MakeArrowBuilder(tuple_types_[col], exec_state->exec_mem_pool());
+    PL_RETURN_IF_ERROR(builder->Reserve(heap_.size()));
+    for (const auto& rt : heap_) {
+      append_fns_[col](builder.get(), *rt, col);
+    }
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  heap_.clear();
+  output_rb.set_eow(true);
+  output_rb.set_eos(eos);
+  return SendRowBatchToChildren(exec_state, output_rb);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <arrow/builder.h>
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * TopKNode outputs the first `limit` rows of its input according to the sort columns. It keeps a
+ * bounded heap of RowTuples whose root is the worst row kept so far, so each input row costs one
+ * comparison against the root unless it displaces it. The rows are emitted in sorted order at the
+ * end of each window (eow or eos). A negative limit sorts the entire window, up to
+ * --topk_max_unbounded_rows rows.
+ */
+class TopKNode : public ProcessingNode {
+ public:
+  TopKNode() = default;
+  virtual ~TopKNode() = default;
+
+  bool AcceptsSelectionVectors() const override { return true; }
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  using ExtractFn = void (*)(RowTuple*, arrow::Array*, int, int);
+  using CompareFn = int (*)(const RowTuple&, const RowTuple&, size_t);
+  using AppendFn = void (*)(arrow::ArrayBuilder*, const RowTuple&, size_t);
+
+  // Returns true if the row `a` comes before the row `b` in the output.
+  bool RowLess(const RowTuple& a, const RowTuple& b) const;
+  // Comparator for the heap, which keeps the last row of the output at its root.
+  bool HeapLess(const std::unique_ptr<RowTuple>& a, const std::unique_ptr<RowTuple>& b) const {
+    return RowLess(*a, *b);
+  }
+  Status EmitRows(ExecState* exec_state, bool eos);
+
+  std::unique_ptr<plan::TopKOperator> plan_node_;
+  int64_t limit_ = -1;
+  // Whether the plan has no limit, in which case limit_ is the cap on the rows of a sort.
+  bool unbounded_ = false;
+  // Whether the cap has dropped any rows, which is only logged once.
+  bool dropped_rows_ = false;
+
+  // The RowTuples hold the sort columns followed by the output columns.
+  std::vector<types::DataType> tuple_types_;
+  std::vector<ExtractFn> extract_fns_;
+  std::vector<CompareFn> compare_fns_;
+  std::vector<AppendFn> append_fns_;
+  // The input column for each entry of the RowTuples.
+  std::vector<int64_t> tuple_input_cols_;
+  size_t num_sort_cols_ = 0;
+
+  std::vector<std::unique_ptr<RowTuple>> heap_;
+  // Row that is being considered for the heap, swapped into the heap when it is kept.
+  std::unique_ptr<RowTuple> candidate_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/topk_node.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/base.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+DECLARE_int64(topk_max_unbounded_rows);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+class TopKNodeTest : public ::testing::Test {
+ public:
+  TopKNodeTest() {
+    auto op_proto = planpb::testutils::CreateTestTopK1PB();
+    plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+
+    auto table_store = std::make_shared<table_store::TableStore>();
+
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, MockMetricsStubGenerator,
+                                              MockTraceStubGenerator, sole::uuid4(), nullptr);
+  }
+
+ protected:
+  RowDescriptor input_rd_{
+      {types::DataType::INT64, types::DataType::FLOAT64, types::DataType::STRING}};
+  RowDescriptor output_rd_{{types::DataType::INT64, types::DataType::STRING}};
+  std::unique_ptr<plan::Operator> plan_node_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(TopKNodeTest, multiple_batches) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({1.0, 5.0, 3.0, 5.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({0, 6, 7})
+                       .AddColumn<types::Float64Value>({5.0, 0.5, 4.0})
+                       .AddColumn<types::StringValue>({"e", "f", "g"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, true, true)
+                          .AddColumn<types::Int64Value>({0, 2, 4})
+                          .AddColumn<types::StringValue>({"e", "b", "d"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, fewer_rows_than_limit) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 2})
+                       .AddColumn<types::Float64Value>({1.0, 5.0})
+                       .AddColumn<types::StringValue>({"a", "b"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, true, true)
+                          .AddColumn<types::Int64Value>({2, 1})
+                          .AddColumn<types::StringValue>({"b", "a"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, unbounded_sorts_entire_input) {
+  auto op_proto = planpb::testutils::CreateTestTopK1PB();
+  op_proto.mutable_topk_op()->set_limit(-1);
+  plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({1.0, 5.0, 3.0, 5.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d"})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({0, 6, 7})
+                       .AddColumn<types::Float64Value>({5.0, 0.5, 4.0})
+                       .AddColumn<types::StringValue>({"e", "f", "g"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 7, true, true)
+                          .AddColumn<types::Int64Value>({0, 2, 4, 7, 3, 1, 6})
+                          .AddColumn<types::StringValue>({"e", "b", "d", "g", "c", "a", "f"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, emits_each_window) {
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({1.0, 5.0, 3.0, 5.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d"})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, /*eow*/ true, /*eos*/ false)
+                          .AddColumn<types::Int64Value>({2, 4, 3})
+                          .AddColumn<types::StringValue>({"b", "d", "c"})
+                          .get())
+      // The rows of the first window don't carry over to the second.
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({6, 7})
+                       .AddColumn<types::Float64Value>({0.5, 4.0})
+                       .AddColumn<types::StringValue>({"f", "g"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, /*eow*/ true, /*eos*/ true)
+                          .AddColumn<types::Int64Value>({7, 6})
+                          .AddColumn<types::StringValue>({"g", "f"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, unbounded_is_capped) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_topk_max_unbounded_rows = 2;
+  auto op_proto = planpb::testutils::CreateTestTopK1PB();
+  op_proto.mutable_topk_op()->set_limit(-1);
+  plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Float64Value>({1.0, 5.0, 3.0, 6.0})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, true, true)
+                          .AddColumn<types::Int64Value>({4, 2})
+                          .AddColumn<types::StringValue>({"d", "b"})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, limit_zero) {
+  auto op_proto = planpb::testutils::CreateTestTopK1PB();
+  op_proto.mutable_topk_op()->set_limit(0);
+  plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(
+      *plan_node_, output_rd_, {input_rd_}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 2})
+                       .AddColumn<types::Float64Value>({1.0, 5.0})
+                       .AddColumn<types::StringValue>({"a", "b"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 0, true, true)
+                          .AddColumn<types::Int64Value>({})
+                          .AddColumn<types::StringValue>({})
+                          .get())
+      .Close();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
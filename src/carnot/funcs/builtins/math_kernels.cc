@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/builtins/math_kernels.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace kernels {
+
+#if defined(__x86_64__)
+
+bool CPUSupportsAVX2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+namespace avx2 {
+
+// The functions in this namespace are compiled for AVX2 regardless of the target of the rest of
+// the build, so that a single binary can still run on older CPUs.
+#define PX_AVX2 __attribute__((target("avx2")))
+
+namespace {
+
+// Number of 64-bit lanes in a 256-bit register.
+constexpr size_t kLanes64 = 4;
+// Number of 8-bit lanes in a 256-bit register.
+constexpr size_t kLanes8 = 32;
+
+PX_AVX2 inline __m256i Load(const int64_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+PX_AVX2 inline __m256d Load(const double* p) { return _mm256_loadu_pd(p); }
+PX_AVX2 inline __m256i Load(const bool* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+PX_AVX2 inline void Store(int64_t* p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+PX_AVX2 inline void Store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+PX_AVX2 inline void Store(bool* p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// Writes the results of a 4 lane comparison as 4 bools. Comparisons set every bit of a lane that
+// compares true, so taking one bit per lane gives the bools.
+PX_AVX2 inline void StoreMask(bool* p, __m256d mask) {
+  int bits = _mm256_movemask_pd(mask);
+  for (size_t lane = 0; lane < kLanes64; ++lane) {
+    p[lane] = (bits >> lane) & 1;
+  }
+}
+PX_AVX2 inline void StoreMask(bool* p, __m256i mask) { StoreMask(p, _mm256_castsi256_pd(mask)); }
+
+PX_AVX2 inline __m256i CmpEq(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+PX_AVX2 inline __m256i CmpLt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(b, a); }
+PX_AVX2 inline __m256i CmpGt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(a, b); }
+// The ordered predicates are false if either side is NaN, which matches the C++ operators.
+PX_AVX2 inline __m256d CmpEq(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+PX_AVX2 inline __m256d CmpLt(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+PX_AVX2 inline __m256d CmpGt(__m256d a, __m256d b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+
+}  // namespace
+
+// Each kernel runs the vector instructions on every full register of input, and the op's scalar
+// Apply on the remainder.
+#define PX_AVX2_ARITHMETIC_KERNEL(_op_, _type_, _lanes_, _intrinsic_)                          \
+  PX_AVX2 void Binary(_op_, size_t count, const _type_* in1, const _type_* in2, _type_* out) { \
+    size_t i = 0;                                                                              \
+    for (; i + (_lanes_) <= count; i += (_lanes_)) {                                           \
+      Store(out + i, _intrinsic_(Load(in1 + i), Load(in2 + i)));                               \
+    }                                                                                          \
+    ScalarBinaryKernel<_op_>(count - i, in1 + i, in2 + i, out + i);                            \
+  }
+
+PX_AVX2_ARITHMETIC_KERNEL(AddOp, int64_t, kLanes64, _mm256_add_epi64)
+PX_AVX2_ARITHMETIC_KERNEL(AddOp, double, kLanes64, _mm256_add_pd)
+PX_AVX2_ARITHMETIC_KERNEL(SubtractOp, int64_t, kLanes64, _mm256_sub_epi64)
+PX_AVX2_ARITHMETIC_KERNEL(SubtractOp, double, kLanes64, _mm256_sub_pd)
+PX_AVX2_ARITHMETIC_KERNEL(MultiplyOp, double, kLanes64, _mm256_mul_pd)
+PX_AVX2_ARITHMETIC_KERNEL(DivideOp, double, kLanes64, _mm256_div_pd)
+// Bools are stored as bytes that are either 0 or 1, so bitwise and/or gives the logical result.
+PX_AVX2_ARITHMETIC_KERNEL(LogicalAndOp, bool, kLanes8, _mm256_and_si256)
+PX_AVX2_ARITHMETIC_KERNEL(LogicalOrOp, bool, kLanes8, _mm256_or_si256)
+
+#undef PX_AVX2_ARITHMETIC_KERNEL
+
+// _cmp_ is a function of two registers `a` and `b`.
+#define PX_AVX2_COMPARISON_KERNEL(_op_, _type_, _cmp_)                                      \
+  PX_AVX2 void Binary(_op_, size_t count, const _type_* in1, const _type_* in2, bool* out) { \
+    size_t i = 0;                                                                           \
+    for (; i + kLanes64 <= count; i += kLanes64) {                                          \
+      StoreMask(out + i, _cmp_(Load(in1 + i), Load(in2 + i)));                              \
+    }                                                                                       \
+    ScalarBinaryKernel<_op_>(count - i, in1 + i, in2 + i, out + i);                         \
+  }
+
+PX_AVX2_COMPARISON_KERNEL(EqualOp, int64_t, CmpEq)
+PX_AVX2_COMPARISON_KERNEL(LessThanOp, int64_t, CmpLt)
+PX_AVX2_COMPARISON_KERNEL(GreaterThanOp, int64_t, CmpGt)
+PX_AVX2_COMPARISON_KERNEL(EqualOp, double, CmpEq)
+PX_AVX2_COMPARISON_KERNEL(LessThanOp, double, CmpLt)
+PX_AVX2_COMPARISON_KERNEL(GreaterThanOp, double, CmpGt)
+
+#undef PX_AVX2_COMPARISON_KERNEL
+
+PX_AVX2 void Unary(LogicalNotOp, size_t count, const bool* in, bool* out) {
+  const __m256i ones = _mm256_set1_epi8(1);
+  size_t i = 0;
+  for (; i + kLanes8 <= count; i += kLanes8) {
+    Store(out + i, _mm256_xor_si256(Load(in + i), ones));
+  }
+  ScalarUnaryKernel<LogicalNotOp>(count - i, in + i, out + i);
+}
+
+#undef PX_AVX2
+
+}  // namespace avx2
+
+#else
+
+bool CPUSupportsAVX2() { return false; }
+
+#endif
+
+}  // namespace kernels
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace kernels {
+
+/**
+ * The kernels in this file implement the ExecBatch functions of the hot math and comparison
+ * builtins. Each op is a tag type with an Apply function that defines its result for a single
+ * row. Ops also have AVX2 implementations for the common native types, which are used when the
+ * CPU supports AVX2. Everything else falls back to a loop over Apply.
+ */
+struct AddOp {
+  template <typename T1, typename T2>
+  static auto Apply(T1 a, T2 b) {
+    return a + b;
+  }
+};
+
+struct SubtractOp {
+  template <typename T1, typename T2>
+  static auto Apply(T1 a, T2 b) {
+    return a - b;
+  }
+};
+
+struct MultiplyOp {
+  template <typename T1, typename T2>
+  static auto Apply(T1 a, T2 b) {
+    return a * b;
+  }
+};
+
+struct DivideOp {
+  template <typename T1, typename T2>
+  static double Apply(T1 a, T2 b) {
+    return static_cast<double>(a) / static_cast<double>(b);
+  }
+};
+
+struct EqualOp {
+  template <typename T1, typename T2>
+  static bool Apply(const T1& a, const T2& b) {
+    return a == b;
+  }
+};
+
+struct LessThanOp {
+  template <typename T1, typename T2>
+  static bool Apply(const T1& a, const T2& b) {
+    return a < b;
+  }
+};
+
+struct GreaterThanOp {
+  template <typename T1, typename T2>
+  static bool Apply(const T1& a, const T2& b) {
+    return a > b;
+  }
+};
+
+struct LogicalAndOp {
+  template <typename T1, typename T2>
+  static bool Apply(T1 a, T2 b) {
+    return a && b;
+  }
+};
+
+struct LogicalOrOp {
+  template <typename T1, typename T2>
+  static bool Apply(T1 a, T2 b) {
+    return a || b;
+  }
+};
+
+struct LogicalNotOp {
+  template <typename T>
+  static bool Apply(T a) {
+    return !a;
+  }
+};
+
+/**
+ * @return whether the CPU we are running on supports AVX2. The result is computed once.
+ */
+bool CPUSupportsAVX2();
+
+#if defined(__x86_64__)
+/**
+ * AVX2 implementations of the kernels. These must only be called if CPUSupportsAVX2() is true.
+ */
+namespace avx2 {
+void Binary(AddOp, size_t count, const int64_t* in1, const int64_t* in2, int64_t* out);
+void Binary(AddOp, size_t count, const double* in1, const double* in2, double* out);
+void Binary(SubtractOp, size_t count, const int64_t* in1, const int64_t* in2, int64_t* out);
+void Binary(SubtractOp, size_t count, const double* in1, const double* in2, double* out);
+void Binary(MultiplyOp, size_t count, const double* in1, const double* in2, double* out);
+void Binary(DivideOp, size_t count, const double* in1, const double* in2, double* out);
+void Binary(EqualOp, size_t count, const int64_t* in1, const int64_t* in2, bool* out);
+void Binary(EqualOp, size_t count, const double* in1, const double* in2, bool* out);
+void Binary(LessThanOp, size_t count, const int64_t* in1, const int64_t* in2, bool* out);
+void Binary(LessThanOp, size_t count, const double* in1, const double* in2, bool* out);
+void Binary(GreaterThanOp, size_t count, const int64_t* in1, const int64_t* in2, bool* out);
+void Binary(GreaterThanOp, size_t count, const double* in1, const double* in2, bool* out);
+void Binary(LogicalAndOp, size_t count, const bool* in1, const bool* in2, bool* out);
+void Binary(LogicalOrOp, size_t count, const bool* in1, const bool* in2, bool* out);
+void Unary(LogicalNotOp, size_t count, const bool* in, bool* out);
+}  // namespace avx2
+
+template <typename TOp, typename TIn1, typename TIn2, typename TOut, typename = void>
+struct has_avx2_binary_kernel : std::false_type {};
+
+template <typename TOp, typename TIn1, typename TIn2, typename TOut>
+struct has_avx2_binary_kernel<
+    TOp, TIn1, TIn2, TOut,
+    std::void_t<decltype(avx2::Binary(TOp{}, size_t{}, std::declval<const TIn1*>(),
+                                      std::declval<const TIn2*>(), std::declval<TOut*>()))>>
+    : std::true_type {};
+
+template <typename TOp, typename TIn, typename TOut, typename = void>
+struct has_avx2_unary_kernel : std::false_type {};
+
+template <typename TOp, typename TIn, typename TOut>
+struct has_avx2_unary_kernel<TOp, TIn, TOut,
+                             std::void_t<decltype(avx2::Unary(TOp{}, size_t{},
+                                                              std::declval<const TIn*>(),
+                                                              std::declval<TOut*>()))>>
+    : std::true_type {};
+#else
+template <typename TOp, typename TIn1, typename TIn2, typename TOut>
+struct has_avx2_binary_kernel : std::false_type {};
+
+template <typename TOp, typename TIn, typename TOut>
+struct has_avx2_unary_kernel : std::false_type {};
+#endif
+
+/**
+ * Applies the op to each pair of values of the native input arrays.
+ */
+template <typename TOp, typename TIn1, typename TIn2, typename TOut>
+void ScalarBinaryKernel(size_t count, const TIn1* in1, const TIn2* in2, TOut* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<TOut>(TOp::Apply(in1[i], in2[i]));
+  }
+}
+
+template <typename TOp, typename TIn, typename TOut>
+void ScalarUnaryKernel(size_t count, const TIn* in, TOut* out) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = static_cast<TOut>(TOp::Apply(in[i]));
+  }
+}
+
+template <typename TOp, typename TIn1, typename TIn2, typename TOut>
+void BinaryKernel(size_t count, const TIn1* in1, const TIn2* in2, TOut* out) {
+#if defined(__x86_64__)
+  if constexpr (has_avx2_binary_kernel<TOp, TIn1, TIn2, TOut>::value) {
+    if (CPUSupportsAVX2()) {
+      avx2::Binary(TOp{}, count, in1, in2, out);
+      return;
+    }
+  }
+#endif
+  ScalarBinaryKernel<TOp>(count, in1, in2, out);
+}
+
+template <typename TOp, typename TIn, typename TOut>
+void UnaryKernel(size_t count, const TIn* in, TOut* out) {
+#if defined(__x86_64__)
+  if constexpr (has_avx2_unary_kernel<TOp, TIn, TOut>::value) {
+    if (CPUSupportsAVX2()) {
+      avx2::Unary(TOp{}, count, in, out);
+      return;
+    }
+  }
+#endif
+  ScalarUnaryKernel<TOp>(count, in, out);
+}
+
+template <typename TValue>
+using NativeType = typename types::ValueTypeTraits<TValue>::native_type;
+
+// Whether an array of the value type can be read as an array of its native type. This holds for
+// all of the fixed size value types with an arithmetic native type.
+template <typename TValue>
+inline constexpr bool kHasNativeLayout =
+    std::is_arithmetic_v<NativeType<TValue>> && std::is_standard_layout_v<TValue> &&
+    sizeof(TValue) == sizeof(NativeType<TValue>);
+
+template <typename TValue>
+const NativeType<TValue>* NativeValues(const TValue* values) {
+  static_assert(kHasNativeLayout<TValue>);
+  return reinterpret_cast<const NativeType<TValue>*>(values);
+}
+
+template <typename TValue>
+NativeType<TValue>* NativeValues(TValue* values) {
+  static_assert(kHasNativeLayout<TValue>);
+  return reinterpret_cast<NativeType<TValue>*>(values);
+}
+
+/**
+ * ExecBinary applies the op to `count` pairs of UDF values. Arrays of fixed size values are
+ * evaluated by the native kernels above, other types (eg. strings) apply the op to the values
+ * directly.
+ */
+template <typename TOp, typename TIn1, typename TIn2, typename TOut>
+void ExecBinary(size_t count, const TIn1* in1, const TIn2* in2, TOut* out) {
+  if constexpr (kHasNativeLayout<TIn1> && kHasNativeLayout<TIn2> && kHasNativeLayout<TOut>) {
+    BinaryKernel<TOp>(count, NativeValues(in1), NativeValues(in2), NativeValues(out));
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = TOp::Apply(in1[i], in2[i]);
+    }
+  }
+}
+
+template <typename TOp, typename TIn, typename TOut>
+void ExecUnary(size_t count, const TIn* in, TOut* out) {
+  static_assert(kHasNativeLayout<TIn> && kHasNativeLayout<TOut>);
+  UnaryKernel<TOp>(count, NativeValues(in), NativeValues(out));
+}
+
+}  // namespace kernels
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "src/carnot/funcs/builtins/math_kernels.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+namespace kernels {
+
+// Sizes around the width of a register, so that both the vector loop and the scalar remainder
+// get exercised.
+constexpr size_t kMaxSize = 100;
+const std::vector<size_t> kSizes = {0, 1, 3, 4, 5, 31, 32, 33, kMaxSize};
+
+class MathKernelsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::mt19937 gen(42);
+    // Pick from a small range so that the comparisons have plenty of equal values.
+    std::uniform_int_distribution<int64_t> dist(-2, 2);
+    for (size_t i = 0; i < kMaxSize; ++i) {
+      ints1_.push_back(dist(gen));
+      ints2_.push_back(dist(gen));
+      doubles1_.push_back(static_cast<double>(dist(gen)) / 2);
+      doubles2_.push_back(static_cast<double>(dist(gen)) / 2);
+      bools1_[i] = dist(gen) > 0;
+      bools2_[i] = dist(gen) > 0;
+    }
+    doubles1_[7] = std::numeric_limits<double>::quiet_NaN();
+    doubles2_[40] = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  // Checks that the dispatched kernel (which uses AVX2 when available) matches the scalar one.
+  template <typename TOp, typename TIn, typename TOut>
+  void ExpectMatchesScalar(const std::vector<TIn>& in1, const std::vector<TIn>& in2) {
+    for (size_t size : kSizes) {
+      auto out = std::make_unique<TOut[]>(size);
+      auto expected = std::make_unique<TOut[]>(size);
+      BinaryKernel<TOp>(size, in1.data(), in2.data(), out.get());
+      ScalarBinaryKernel<TOp>(size, in1.data(), in2.data(), expected.get());
+      for (size_t i = 0; i < size; ++i) {
+        if constexpr (std::is_floating_point_v<TOut>) {
+          if (std::isnan(expected[i])) {
+            EXPECT_TRUE(std::isnan(out[i])) << "size " << size << " row " << i;
+            continue;
+          }
+        }
+        EXPECT_EQ(expected[i], out[i]) << "size " << size << " row " << i;
+      }
+    }
+  }
+
+  std::vector<int64_t> ints1_;
+  std::vector<int64_t> ints2_;
+  std::vector<double> doubles1_;
+  std::vector<double> doubles2_;
+  bool bools1_[kMaxSize];
+  bool bools2_[kMaxSize];
+};
+
+TEST_F(MathKernelsTest, arithmetic) {
+  ExpectMatchesScalar<AddOp, int64_t, int64_t>(ints1_, ints2_);
+  ExpectMatchesScalar<AddOp, double, double>(doubles1_, doubles2_);
+  ExpectMatchesScalar<SubtractOp, int64_t, int64_t>(ints1_, ints2_);
+  ExpectMatchesScalar<SubtractOp, double, double>(doubles1_, doubles2_);
+  ExpectMatchesScalar<MultiplyOp, int64_t, int64_t>(ints1_, ints2_);
+  ExpectMatchesScalar<MultiplyOp, double, double>(doubles1_, doubles2_);
+  ExpectMatchesScalar<DivideOp, double, double>(doubles1_, doubles2_);
+}
+
+TEST_F(MathKernelsTest, comparisons) {
+  ExpectMatchesScalar<EqualOp, int64_t, bool>(ints1_, ints2_);
+  ExpectMatchesScalar<EqualOp, double, bool>(doubles1_, doubles2_);
+  ExpectMatchesScalar<LessThanOp, int64_t, bool>(ints1_, ints2_);
+  ExpectMatchesScalar<LessThanOp, double, bool>(doubles1_, doubles2_);
+  ExpectMatchesScalar<GreaterThanOp, int64_t, bool>(ints1_, ints2_);
+  ExpectMatchesScalar<GreaterThanOp, double, bool>(doubles1_, doubles2_);
+}
+
+TEST_F(MathKernelsTest, logical) {
+  for (size_t size : kSizes) {
+    bool out[kMaxSize];
+    BinaryKernel<LogicalAndOp>(size, bools1_, bools2_, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(bools1_[i] && bools2_[i], out[i]);
+    }
+    BinaryKernel<LogicalOrOp>(size, bools1_, bools2_, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(bools1_[i] || bools2_[i], out[i]);
+    }
+    UnaryKernel<LogicalNotOp>(size, bools1_, out);
+    for (size_t i = 0; i < size; ++i) {
+      EXPECT_EQ(!bools1_[i], out[i]);
+    }
+  }
+}
+
+TEST(ExecBinary, value_types) {
+  std::vector<types::Time64NSValue> times = {1, 5, 10, 15, 20};
+  std::vector<types::Int64Value> ints = {10, 10, 10, 10, 10};
+  std::vector<types::BoolValue> out(times.size());
+  ExecBinary<LessThanOp>(times.size(), times.data(), ints.data(), out.data());
+  std::vector<bool> expected = {true, true, false, false, false};
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], out[i].val);
+  }
+
+  std::vector<types::StringValue> strs1 = {"abc", "def"};
+  std::vector<types::StringValue> strs2 = {"abc", "abc"};
+  ExecBinary<EqualOp>(strs1.size(), strs1.data(), strs2.data(), out.data());
+  EXPECT_TRUE(out[0].val);
+  EXPECT_FALSE(out[1].val);
+}
+
+}  // namespace kernels
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
@@ -21,6 +21,7 @@
 #include <cmath>
 #include <limits>
 
+#include "src/carnot/funcs/builtins/math_kernels.h"
 #include "src/carnot/udf/registry.h"
 #include "src/carnot/udf/type_inference.h"
 #include "src/shared/types/types.h"
@@ -35,6 +36,10 @@ template <typename TReturn, typename TArg1 = TReturn, typename TArg2 = TReturn>
 class AddUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val + b2.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        TReturn* out) {
+    kernels::ExecBinary<kernels::AddOp>(count, b1, b2, out);
+  }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::InheritTypeFromArgs<AddUDF>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -60,6 +65,10 @@ template <typename TReturn, typename TArg1 = TReturn, typename TArg2 = TReturn>
 class SubtractUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val - b2.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        TReturn* out) {
+    kernels::ExecBinary<kernels::SubtractOp>(count, b1, b2, out);
+  }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::InheritTypeFromArgs<SubtractUDF>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -88,6 +97,10 @@ class DivideUDF : public udf::ScalarUDF {
   types::Float64Value Exec(FunctionContext*, TArg1 b1, TArg2 b2) {
     return static_cast<double>(b1.val) / static_cast<double>(b2.val);
   }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        types::Float64Value* out) {
+    kernels::ExecBinary<kernels::DivideOp>(count, b1, b2, out);
+  }
 
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<DivideUDF>(types::ST_THROUGHPUT_PER_NS,
@@ -113,6 +126,10 @@ template <typename TReturn, typename TArg1 = TReturn, typename TArg2 = TReturn>
 class MultiplyUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val * b2.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        TReturn* out) {
+    kernels::ExecBinary<kernels::MultiplyOp>(count, b1, b2, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Multiplies the arguments.")
         .Details("Multiplies the two values together. Accessible using the `*` operator syntax.")
@@ -266,6 +283,10 @@ template <typename TArg1, typename TArg2 = TArg1>
 class LogicalOrUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val || b2.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        BoolValue* out) {
+    kernels::ExecBinary<kernels::LogicalOrOp>(count, b1, b2, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Boolean ORs the passed in values.")
         .Example(R"doc(# Implicit call.
@@ -285,6 +306,10 @@ template <typename TArg1, typename TArg2 = TArg1>
 class LogicalAndUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val && b2.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        BoolValue* out) {
+    kernels::ExecBinary<kernels::LogicalAndOp>(count, b1, b2, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Boolean ANDs the passed in values.")
         .Example(R"doc(# Implicit call.
@@ -302,6 +327,9 @@ template <typename TArg1>
 class LogicalNotUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1) { return !b1.val; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, BoolValue* out) {
+    kernels::ExecUnary<kernels::LogicalNotOp>(count, b1, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Boolean NOTs the passed in value.")
         .Example(R"doc(# Implicit call.
@@ -374,6 +402,10 @@ template <typename TArg1, typename TArg2 = TArg1>
 class EqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 == b2; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        BoolValue* out) {
+    kernels::ExecBinary<kernels::EqualOp>(count, b1, b2, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the values are equal.")
         .Details(
@@ -439,6 +471,10 @@ template <typename TArg1, typename TArg2 = TArg1>
 class GreaterThanUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 > b2; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        BoolValue* out) {
+    kernels::ExecBinary<kernels::GreaterThanOp>(count, b1, b2, out);
+  }
 
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -478,6 +514,10 @@ template <typename TArg1, typename TArg2 = TArg1>
 class LessThanUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 < b2; }
+  static void ExecBatch(FunctionContext*, size_t count, const TArg1* b1, const TArg2* b2,
+                        BoolValue* out) {
+    kernels::ExecBinary<kernels::LessThanOp>(count, b1, b2, out);
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns which value is less than the other.")
         .Example(R"doc(# Implict call.
@@ -74,6 +74,8 @@ std::unique_ptr<Operator> Operator::FromProto(const planpb::Operator& pb, int64_
       return CreateOperator<FilterOperator>(id, pb.filter_op());
     case planpb::LIMIT_OPERATOR:
       return CreateOperator<LimitOperator>(id, pb.limit_op());
+    case planpb::TOPK_OPERATOR:
+      return CreateOperator<TopKOperator>(id, pb.topk_op());
     case planpb::UNION_OPERATOR:
       return CreateOperator<UnionOperator>(id, pb.union_op());
     case planpb::JOIN_OPERATOR:
@@ -321,6 +323,14 @@ std::string GRPCSinkOperator::DebugString() const {
     destination = absl::Substitute("table_name=$0", table_name());
   } else if (has_grpc_source_id()) {
     destination = absl::Substitute("source_id=$0", grpc_source_id());
+  } else if (is_shuffle()) {
+    std::vector<std::string> destinations;
+    for (const auto& dest : shuffle_destinations()) {
+      destinations.push_back(absl::Substitute("$0/$1", dest.address(), dest.grpc_source_id()));
+    }
+    destination = absl::Substitute("shuffle=[$0], partition_cols=[$1]",
+                                   absl::StrJoin(destinations, ", "),
+                                   absl::StrJoin(partition_column_idxs(), ", "));
   }
   return absl::Substitute("Op:GRPCSink($0, $1)", address(), destination);
 }
@@ -450,6 +460,74 @@ StatusOr<table_store::schema::Relation> LimitOperator::OutputRelation(
   return output_relation;
 }
 
+/**
+ * TopK Operator Implementation.
+ */
+std::string TopKOperator::DebugString() const {
+  std::vector<std::string> sort_strs;
+  for (size_t i = 0; i < sort_cols_.size(); ++i) {
+    sort_strs.push_back(absl::Substitute("$0 $1", sort_cols_[i], ascending_[i] ? "asc" : "desc"));
+  }
+  return absl::Substitute("Op:TopK($0, sort: [$1], cols: [$2])", record_limit_,
+                          absl::StrJoin(sort_strs, ","), absl::StrJoin(selected_cols_, ","));
+}
+
+Status TopKOperator::Init(const planpb::TopKOperator& pb) {
+  pb_ = pb;
+  record_limit_ = pb_.limit();
+  if (pb_.sort_columns_size() != pb_.ascending_size()) {
+    return error::InvalidArgument("TopK has $0 sort columns but $1 sort directions",
+                                  pb_.sort_columns_size(), pb_.ascending_size());
+  }
+
+  selected_cols_.reserve(pb_.columns_size());
+  for (auto i = 0; i < pb_.columns_size(); ++i) {
+    selected_cols_.push_back(pb_.columns(i).index());
+  }
+  sort_cols_.reserve(pb_.sort_columns_size());
+  for (auto i = 0; i < pb_.sort_columns_size(); ++i) {
+    sort_cols_.push_back(pb_.sort_columns(i).index());
+    ascending_.push_back(pb_.ascending(i));
+  }
+
+  is_initialized_ = true;
+  return Status::OK();
+}
+
+StatusOr<table_store::schema::Relation> TopKOperator::OutputRelation(
+    const table_store::schema::Schema& schema, const PlanState& /*state*/,
+    const std::vector<int64_t>& input_ids) const {
+  DCHECK(is_initialized_) << "Not initialized";
+
+  if (input_ids.size() != 1) {
+    return error::InvalidArgument("TopK operator must have exactly one input");
+  }
+  if (!schema.HasRelation(input_ids[0])) {
+    return error::NotFound("Missing relation ($0) for input of TopKOperator", input_ids[0]);
+  }
+
+  PL_ASSIGN_OR_RETURN(const table_store::schema::Relation& input_relation,
+                      schema.GetRelation(input_ids[0]));
+  for (auto sort_col_idx : sort_cols_) {
+    if (sort_col_idx >= static_cast<int64_t>(input_relation.NumColumns())) {
+      return error::InvalidArgument(
+          "Sort column index $0 is out of bounds, number of columns is $1", sort_col_idx,
+          input_relation.NumColumns());
+    }
+  }
+  table_store::schema::Relation output_relation;
+  for (auto selected_col_idx : selected_cols_) {
+    CHECK_LT(selected_col_idx, static_cast<int64_t>(input_relation.NumColumns()))
+        << absl::Substitute("Column index $0 is out of bounds, number of columns is $1",
+                            selected_col_idx, input_relation.NumColumns());
+
+    output_relation.AddColumn(input_relation.GetColumnType(selected_col_idx),
+                              input_relation.GetColumnName(selected_col_idx),
+                              input_relation.GetColumnDesc(selected_col_idx));
+  }
+  return output_relation;
+}
+
 /**
  * Zip Operator Implementation.
  */
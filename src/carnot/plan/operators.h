@@ -97,6 +97,9 @@ class MemorySourceOperator : public Operator {
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
   bool infinite_stream() const { return pb_.streaming(); }
+  const google::protobuf::RepeatedPtrField<planpb::ScanPredicate>& predicates() const {
+    return pb_.predicates();
+  }
 
  private:
   planpb::MemorySourceOperator pb_;
@@ -215,6 +218,17 @@ class GRPCSinkOperator : public Operator {
   }
   std::string table_name() const { return pb_.output_table().table_name(); }
 
+  // Shuffle sinks partition their rows on the partition columns and send each partition to one
+  // of the shuffle destinations.
+  bool is_shuffle() const { return pb_.shuffle_destinations_size() > 0; }
+  const google::protobuf::RepeatedPtrField<planpb::GRPCSinkOperator::ShuffleDestination>&
+  shuffle_destinations() const {
+    return pb_.shuffle_destinations();
+  }
+  std::vector<int64_t> partition_column_idxs() const {
+    return {pb_.partition_column_idxs().begin(), pb_.partition_column_idxs().end()};
+  }
+
  private:
   planpb::GRPCSinkOperator pb_;
 };
@@ -262,6 +276,30 @@ class LimitOperator : public Operator {
   planpb::LimitOperator pb_;
 };
 
+class TopKOperator : public Operator {
+ public:
+  explicit TopKOperator(int64_t id) : Operator(id, planpb::TOPK_OPERATOR) {}
+  ~TopKOperator() override = default;
+
+  StatusOr<table_store::schema::Relation> OutputRelation(
+      const table_store::schema::Schema& schema, const PlanState& state,
+      const std::vector<int64_t>& input_ids) const override;
+  Status Init(const planpb::TopKOperator& pb);
+  std::string DebugString() const override;
+
+  int64_t record_limit() const { return record_limit_; }
+  const std::vector<int64_t>& selected_cols() const { return selected_cols_; }
+  const std::vector<int64_t>& sort_cols() const { return sort_cols_; }
+  const std::vector<bool>& ascending() const { return ascending_; }
+
+ private:
+  int64_t record_limit_ = 0;
+  std::vector<int64_t> selected_cols_;
+  std::vector<int64_t> sort_cols_;
+  std::vector<bool> ascending_;
+  planpb::TopKOperator pb_;
+};
+
 class UnionOperator : public Operator {
  public:
   explicit UnionOperator(int64_t id) : Operator(id, planpb::UNION_OPERATOR) {}
@@ -281,6 +319,7 @@ class UnionOperator : public Operator {
     return column_mappings_.at(parent_index);
   }
   size_t rows_per_batch() const { return pb_.rows_per_batch(); }
+  bool inputs_sorted_by_key() const { return pb_.inputs_sorted_by_key(); }
 
  private:
   std::vector<std::string> column_names_;
@@ -313,6 +352,7 @@ class JoinOperator : public Operator {
   }
   std::vector<planpb::JoinOperator::ParentColumn> output_columns() const { return output_columns_; }
   size_t rows_per_batch() const { return pb_.rows_per_batch(); }
+  bool inputs_sorted_by_key() const { return pb_.inputs_sorted_by_key(); }
 
   bool order_by_time() const;
   planpb::JoinOperator::ParentColumn time_column() const;
@@ -100,7 +100,7 @@ StatusOr<bool> PropagateExpressionAnnotationsRule::Apply(IRNode* ir_node) {
     for (const ColumnExpression& expr : agg->aggregate_expressions()) {
       operator_output_annotations_[op][expr.name] = expr.node->annotations();
     }
-  } else if (Match(op, Filter()) || Match(op, Limit())) {
+  } else if (Match(op, Filter()) || Match(op, Limit()) || Match(op, TopK())) {
     DCHECK_EQ(1, op->parents().size());
     operator_output_annotations_[op] = operator_output_annotations_.at(op->parents()[0]);
   }
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/carnot/planner/compiler/optimizer/merge_limit_into_topk_rule.h"
+
+#include <algorithm>
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> MergeLimitIntoTopKRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Limit())) {
+    return false;
+  }
+  LimitIR* limit = static_cast<LimitIR*>(ir_node);
+  DCHECK_EQ(1U, limit->parents().size());
+  OperatorIR* parent = limit->parents()[0];
+  // PEM-only limits are a sampling hint, not a bound on the sorted output. The TopK can't take
+  // the limit when another operator also reads its full output.
+  if (limit->pem_only() || !Match(parent, TopK()) || parent->Children().size() != 1) {
+    return false;
+  }
+
+  TopKIR* topk = static_cast<TopKIR*>(parent);
+  int64_t limit_value = limit->limit_value();
+  if (topk->limit_value_set()) {
+    limit_value = std::min(limit_value, topk->limit_value());
+  }
+  topk->SetLimitValue(limit_value);
+
+  for (OperatorIR* child : limit->Children()) {
+    PL_RETURN_IF_ERROR(child->ReplaceParent(limit, topk));
+  }
+  PL_RETURN_IF_ERROR(limit->RemoveParent(topk));
+  PL_RETURN_IF_ERROR(ir_node->graph()->DeleteNode(limit->id()));
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
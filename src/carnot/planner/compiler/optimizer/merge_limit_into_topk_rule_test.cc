@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/optimizer/merge_limit_into_topk_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using ::testing::ElementsAre;
+
+using MergeLimitIntoTopKRuleTest = RulesTest;
+
+TEST_F(MergeLimitIntoTopKRuleTest, sort_then_head) {
+  MemorySourceIR* src = MakeMemSource(MakeRelation());
+  TopKIR* topk = MakeTopK(src, {"cpu0", "count"}, {false, true});
+  LimitIR* limit = MakeLimit(topk, 10);
+  int64_t limit_id = limit->id();
+  MemorySinkIR* sink = MakeMemSink(limit, "foo", {});
+
+  MergeLimitIntoTopKRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_FALSE(graph->HasNode(limit_id));
+  EXPECT_THAT(sink->parents(), ElementsAre(topk));
+  EXPECT_TRUE(topk->limit_value_set());
+  EXPECT_EQ(10, topk->limit_value());
+}
+
+TEST_F(MergeLimitIntoTopKRuleTest, keeps_smallest_limit) {
+  MemorySourceIR* src = MakeMemSource(MakeRelation());
+  TopKIR* topk = MakeTopK(src, {"cpu0"}, {true}, 5);
+  LimitIR* limit = MakeLimit(topk, 10);
+  MemorySinkIR* sink = MakeMemSink(limit, "foo", {});
+
+  MergeLimitIntoTopKRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_THAT(sink->parents(), ElementsAre(topk));
+  EXPECT_EQ(5, topk->limit_value());
+}
+
+TEST_F(MergeLimitIntoTopKRuleTest, topk_with_other_children) {
+  MemorySourceIR* src = MakeMemSource(MakeRelation());
+  TopKIR* topk = MakeTopK(src, {"cpu0"}, {true});
+  LimitIR* limit = MakeLimit(topk, 10);
+  MakeMemSink(limit, "foo", {});
+  MakeMemSink(topk, "bar", {});
+
+  MergeLimitIntoTopKRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_FALSE(topk->limit_value_set());
+}
+
+TEST_F(MergeLimitIntoTopKRuleTest, pem_only_limit) {
+  MemorySourceIR* src = MakeMemSource(MakeRelation());
+  TopKIR* topk = MakeTopK(src, {"cpu0"}, {true});
+  LimitIR* limit = MakeLimit(topk, 10, /* pem_only */ true);
+  MakeMemSink(limit, "foo", {});
+
+  MergeLimitIntoTopKRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -23,6 +23,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "src/carnot/planner/compiler/optimizer/merge_limit_into_topk_rule.h"
 #include "src/carnot/planner/compiler/optimizer/merge_nodes_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unconnected_operators_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
@@ -52,6 +53,11 @@ class Optimizer : public RuleExecutor<IR> {
     prune_ops_batch->AddRule<PruneUnconnectedOperatorsRule>();
   }
 
+  void CreateMergeLimitIntoTopKBatch() {
+    RuleBatch* merge_limit_batch = CreateRuleBatch<TryUntilMax>("MergeLimitIntoTopK", 2);
+    merge_limit_batch->AddRule<MergeLimitIntoTopKRule>();
+  }
+
   void CreateMergeNodesBatch() {
     RuleBatch* merge_nodes_batch = CreateRuleBatch<TryUntilMax>("MergeNodes", 1);
     merge_nodes_batch->AddRule<MergeNodesRule>(compiler_state_);
@@ -64,6 +70,7 @@ class Optimizer : public RuleExecutor<IR> {
 
   Status Init() {
     CreatePruneUnconnectedOpsBatch();
+    CreateMergeLimitIntoTopKBatch();
     CreateMergeNodesBatch();
     CreatePruneUnusedColumnsBatch();
     return Status::OK();
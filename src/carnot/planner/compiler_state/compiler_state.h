@@ -169,6 +169,11 @@ class CompilerState : public NotCopyable {
   int64_t max_output_rows_per_table() { return max_output_rows_per_table_; }
   bool has_max_output_rows_per_table() { return max_output_rows_per_table_ > 0; }
 
+  // The number of Kelvins that the distributed planner hash partitions grouped aggregates and
+  // joins over. If 0, the planner picks it from the agents' table stats.
+  int64_t num_kelvins() const { return num_kelvins_; }
+  void set_num_kelvins(int64_t num_kelvins) { num_kelvins_ = num_kelvins; }
+
   const RedactionOptions& redaction_options() { return redaction_options_; }
   void set_redaction_options(const RedactionOptions& options) { redaction_options_ = options; }
 
@@ -185,6 +190,7 @@ class CompilerState : public NotCopyable {
   std::map<IDRegistryKey, int64_t> uda_to_id_map_;
 
   int64_t max_output_rows_per_table_ = 0;
+  int64_t num_kelvins_ = 0;
   const std::string result_address_;
   const std::string result_ssl_targetname_;
   RedactionOptions redaction_options_;
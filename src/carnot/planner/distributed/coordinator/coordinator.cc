@@ -29,6 +29,7 @@
 #include "src/carnot/planner/distributed/coordinator/prune_unavailable_sources_rule.h"
 #include "src/carnot/planner/distributed/coordinator/removable_ops_rule.h"
 #include "src/carnot/planner/distributed/splitter/splitter.h"
+#include "src/carnot/planner/ir/grpc_source_group_ir.h"
 #include "src/carnot/planner/rules/rules.h"
 #include "src/carnot/udfspb/udfs.pb.h"
 #include "src/common/uuid/uuid.h"
@@ -63,6 +64,7 @@ Status CoordinatorImpl::InitImpl(CompilerState* compiler_state,
                                  const distributedpb::DistributedState& distributed_state) {
   compiler_state_ = compiler_state;
   distributed_state_ = &distributed_state;
+  cost_model_ = CostModel::Create(distributed_state);
   for (int64_t i = 0; i < distributed_state.carnot_info_size(); ++i) {
     PL_RETURN_IF_ERROR(ProcessConfig(distributed_state.carnot_info()[i]));
   }
@@ -236,16 +238,77 @@ StatusOr<SchemaToAgentsMap> LoadSchemaMap(
   return agent_schema_map;
 }
 
+StatusOr<std::unique_ptr<IR>> CreateShufflePlan(const IR* kelvin_plan) {
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> shuffle_plan, kelvin_plan->Clone());
+  absl::flat_hash_set<int64_t> nodes_to_prune;
+  bool has_shuffle_stage = false;
+  for (auto& node_set : shuffle_plan->IndependentGraphs()) {
+    bool is_shuffle_stage = false;
+    for (int64_t node : node_set) {
+      IRNode* ir_node = shuffle_plan->Get(node);
+      if (Match(ir_node, GRPCSourceGroup()) &&
+          static_cast<GRPCSourceGroupIR*>(ir_node)->shuffled()) {
+        is_shuffle_stage = true;
+        break;
+      }
+    }
+    if (is_shuffle_stage) {
+      has_shuffle_stage = true;
+    } else {
+      nodes_to_prune.merge(node_set);
+    }
+  }
+  if (!has_shuffle_stage) {
+    return std::unique_ptr<IR>(nullptr);
+  }
+  PL_RETURN_IF_ERROR(shuffle_plan->Prune(nodes_to_prune));
+  return shuffle_plan;
+}
+
+Status CoordinatorImpl::AddShuffleKelvins(const IR* kelvin_plan, int64_t num_kelvins,
+                                          int64_t remote_node_id,
+                                          const std::vector<int64_t>& source_node_ids,
+                                          DistributedPlan* distributed_plan) {
+  // The main Kelvin runs the first partition of the shuffle stages as part of its plan.
+  for (int64_t i = 1; i < num_kelvins; ++i) {
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> shuffle_plan_uptr, CreateShufflePlan(kelvin_plan));
+    if (shuffle_plan_uptr == nullptr) {
+      return Status::OK();
+    }
+    PL_ASSIGN_OR_RETURN(int64_t shuffle_node_id,
+                        distributed_plan->AddCarnot(remote_processor_nodes_[i]));
+    CarnotInstance* shuffle_carnot = distributed_plan->Get(shuffle_node_id);
+    shuffle_carnot->AddPlan(shuffle_plan_uptr.get());
+    distributed_plan->AddPlan(std::move(shuffle_plan_uptr));
+    for (int64_t source_node_id : source_node_ids) {
+      if (distributed_plan->HasNode(source_node_id)) {
+        distributed_plan->AddEdge(source_node_id, shuffle_node_id);
+      }
+    }
+    distributed_plan->AddEdge(shuffle_node_id, remote_node_id);
+    distributed_plan->AddShuffleKelvin(shuffle_carnot);
+  }
+  return Status::OK();
+}
+
 StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const IR* logical_plan) {
-  // TODO(zasgar) set support_partial_agg to true to enable partial aggs.
+  // Grouped aggregates and joins that process more data than one Kelvin can handle are hash
+  // partitioned over several Kelvins. The query can also ask for a number of Kelvins.
+  auto max_kelvins = static_cast<int64_t>(remote_processor_nodes_.size());
+  int64_t num_kelvins = compiler_state_->num_kelvins() > 0
+                            ? std::min(compiler_state_->num_kelvins(), max_kelvins)
+                            : cost_model_->NumKelvins(logical_plan, max_kelvins);
+  // Aggregates are only split into partial aggregates when the agents' table stats show that the
+  // partial aggregates shrink the data sent to the Kelvin.
   PL_ASSIGN_OR_RETURN(std::unique_ptr<Splitter> splitter,
-                      Splitter::Create(compiler_state_, /* support_partial_agg */ false));
+                      Splitter::Create(compiler_state_,
+                                       /* support_partial_agg */ cost_model_->HasStats(),
+                                       cost_model_.get(), /* support_shuffle */ num_kelvins > 1));
   PL_ASSIGN_OR_RETURN(std::unique_ptr<BlockingSplitPlan> split_plan,
                       splitter->SplitKelvinAndAgents(logical_plan));
   auto distributed_plan = std::make_unique<DistributedPlan>();
   PL_ASSIGN_OR_RETURN(int64_t remote_node_id, distributed_plan->AddCarnot(GetRemoteProcessor()));
   // TODO(philkuz) Need to update the Blocking Split Plan to better represent what we expect.
-  // TODO(philkuz) (PL-1469) Future support for grabbing data from multiple Kelvin nodes.
 
   PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> remote_plan_uptr, split_plan->original_plan->Clone());
   CarnotInstance* remote_carnot = distributed_plan->Get(remote_node_id);
@@ -281,6 +344,9 @@ StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const
     distributed_plan->AddPlan(std::move(agent_to_plan_map.plan_pool[i]));
   }
 
+  PL_RETURN_IF_ERROR(AddShuffleKelvins(split_plan->after_blocking.get(), num_kelvins,
+                                       remote_node_id, source_node_ids, distributed_plan.get()));
+
   // Prune unnecessary sources from the Kelvin plan.
   DistributedPruneUnavailableSourcesRule prune_sources_rule(agent_schema_map);
   PL_RETURN_IF_ERROR(prune_sources_rule.Apply(remote_carnot));
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include "src/carnot/planner/distributed/cost_model/cost_model.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
@@ -82,6 +83,8 @@ class Coordinator : public NotCopyable {
  * @brief This coordinator creates a plan layout with 1 remote processor getting data
  * from N sources. If the passed in plan has special conditions, it will split differntly.
  *
+ * When the cost model estimates that the plan needs more than one Kelvin, the shuffle stages of the
+ * plan also run on additional Kelvins, which each receive a hash partition of the data.
  */
 class CoordinatorImpl : public Coordinator {
  protected:
@@ -94,6 +97,15 @@ class CoordinatorImpl : public Coordinator {
   const distributedpb::CarnotInfo& GetRemoteProcessor() const;
   bool HasExecutableNodes(const IR* plan);
 
+  /**
+   * @brief Adds num_kelvins - 1 Kelvins that each run a copy of the shuffle stages of the Kelvin
+   * plan. Every data store node sends a partition of its data to each of them, and they send their
+   * output to the main Kelvin. Does nothing if the plan has no shuffle stages.
+   */
+  Status AddShuffleKelvins(const IR* kelvin_plan, int64_t num_kelvins, int64_t remote_node_id,
+                           const std::vector<int64_t>& source_node_ids,
+                           DistributedPlan* distributed_plan);
+
   /**
    * @brief Removes the sources and any operators depending on that source. Operators that depend on
    * the source not only means the Transitive dependents, but also any parents of those Transitive
@@ -129,6 +141,8 @@ class CoordinatorImpl : public Coordinator {
   const distributedpb::DistributedState* distributed_state_ = nullptr;
   // The compiler state.
   CompilerState* compiler_state_ = nullptr;
+  // Estimates the cost of plans from the table stats in the distributed state.
+  std::unique_ptr<CostModel> cost_model_;
 };
 
 /**
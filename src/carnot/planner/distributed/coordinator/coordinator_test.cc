@@ -115,6 +115,40 @@ TEST_F(CoordinatorTest, one_pem_one_kelvin) {
   }
 }
 
+TEST_F(CoordinatorTest, partial_agg_from_table_stats) {
+  auto mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  auto agg = MakeBlockingAgg(mem_src, {MakeColumn("count", 0)},
+                             {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+  MakeMemSink(agg, "out");
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  auto pem_has_partial_agg = [this](const distributedpb::DistributedState& ps) {
+    auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
+    auto physical_plan = coordinator->Coordinate(graph.get()).ConsumeValueOrDie();
+    auto pem_instance = physical_plan->Get(1);
+    EXPECT_THAT(pem_instance->carnot_info().query_broker_address(), ContainsRegex("pem"));
+    return !pem_instance->plan()->FindNodesThatMatch(PartialAgg()).empty();
+  };
+  auto ps_with_stats = [](int64_t count_ndv) {
+    auto ps = LoadDistributedStatePb(kOnePEMOneKelvinDistributedState);
+    auto table_stats = ps.mutable_carnot_info(0)->add_table_stats();
+    table_stats->set_table("table");
+    table_stats->set_num_rows(1000 * 1000);
+    table_stats->set_num_bytes(32 * 1000 * 1000);
+    (*table_stats->mutable_column_ndv())["count"] = count_ndv;
+    return ps;
+  };
+
+  // Without stats the aggregate runs entirely on the Kelvin.
+  EXPECT_FALSE(pem_has_partial_agg(LoadDistributedStatePb(kOnePEMOneKelvinDistributedState)));
+  // A handful of groups is aggregated on the PEM first.
+  EXPECT_TRUE(pem_has_partial_agg(ps_with_stats(10)));
+  // Partial aggregates of a group per row would only add work.
+  EXPECT_FALSE(pem_has_partial_agg(ps_with_stats(1000 * 1000)));
+}
+
 TEST_F(CoordinatorTest, three_pems_one_kelvin) {
   auto ps = LoadDistributedStatePb(kThreePEMsOneKelvinDistributedState);
   auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
@@ -169,6 +203,83 @@ TEST_F(CoordinatorTest, one_pem_three_kelvin) {
   }
 }
 
+TEST_F(CoordinatorTest, one_pem_three_kelvin_shuffle_agg) {
+  auto mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  auto agg = MakeBlockingAgg(mem_src, {MakeColumn("count", 0)},
+                             {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+  MakeMemSink(agg, "out");
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  // More data than two Kelvins can handle, with a group per row so there's no partial aggregate.
+  auto ps = LoadDistributedStatePb(kOnePEMThreeKelvinsDistributedState);
+  auto table_stats = ps.mutable_carnot_info(0)->add_table_stats();
+  table_stats->set_table("table");
+  table_stats->set_num_rows(1000 * 1000);
+  table_stats->set_num_bytes(static_cast<int64_t>(2.5 * CostModel::kBytesPerKelvin));
+  (*table_stats->mutable_column_ndv())["count"] = 1000 * 1000;
+
+  auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
+  auto physical_plan = coordinator->Coordinate(graph.get()).ConsumeValueOrDie();
+  ASSERT_EQ(physical_plan->dag().nodes().size(), 4UL);
+  EXPECT_EQ(physical_plan->kelvin()->id(), 0);
+
+  auto pem_instance = physical_plan->Get(1);
+  EXPECT_THAT(pem_instance->carnot_info().query_broker_address(), ContainsRegex("pem"));
+  auto pem_sinks = pem_instance->plan()->FindNodesThatMatch(GRPCSink());
+  ASSERT_EQ(pem_sinks.size(), 1);
+  auto pem_sink = static_cast<GRPCSinkIR*>(pem_sinks[0]);
+  EXPECT_THAT(pem_sink->partition_columns(), ElementsAre("count"));
+
+  // The shuffle Kelvins aggregate their partition and send it to the main Kelvin.
+  ASSERT_EQ(physical_plan->shuffle_kelvins().size(), 2);
+  for (CarnotInstance* shuffle_kelvin : physical_plan->shuffle_kelvins()) {
+    SCOPED_TRACE(shuffle_kelvin->carnot_info().query_broker_address());
+    EXPECT_THAT(physical_plan->dag().ParentsOf(shuffle_kelvin->id()), ElementsAre(1));
+    EXPECT_THAT(physical_plan->dag().DependenciesOf(shuffle_kelvin->id()), ElementsAre(0));
+
+    IR* plan = shuffle_kelvin->plan();
+    EXPECT_EQ(plan->FindNodesThatMatch(Operator()).size(), 3);
+    auto grpc_src_nodes = plan->FindNodesThatMatch(GRPCSourceGroup());
+    ASSERT_EQ(grpc_src_nodes.size(), 1);
+    auto grpc_src = static_cast<GRPCSourceGroupIR*>(grpc_src_nodes[0]);
+    EXPECT_TRUE(grpc_src->shuffled());
+    EXPECT_EQ(grpc_src->source_id(), pem_sink->destination_id());
+    ASSERT_EQ(grpc_src->Children().size(), 1);
+    ASSERT_MATCH(grpc_src->Children()[0], BlockingAgg());
+    ASSERT_EQ(grpc_src->Children()[0]->Children().size(), 1);
+    EXPECT_MATCH(grpc_src->Children()[0]->Children()[0], GRPCSink());
+  }
+
+  // The main Kelvin runs the first partition and writes the gathered output.
+  IR* kelvin_plan = physical_plan->kelvin()->plan();
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(MemorySink()).size(), 1);
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(GRPCSourceGroup()).size(), 2);
+}
+
+TEST_F(CoordinatorTest, one_pem_three_kelvin_shuffle_agg_num_kelvins_option) {
+  auto mem_src = MakeMemSource(MakeRelation());
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  auto agg = MakeBlockingAgg(mem_src, {MakeColumn("count", 0)},
+                             {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+  MakeMemSink(agg, "out");
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  // Without table stats the cost model uses a single Kelvin, unless the query asks for more.
+  compiler_state_->set_num_kelvins(2);
+  auto ps = LoadDistributedStatePb(kOnePEMThreeKelvinsDistributedState);
+  auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
+  auto physical_plan = coordinator->Coordinate(graph.get()).ConsumeValueOrDie();
+  ASSERT_EQ(physical_plan->dag().nodes().size(), 3UL);
+  ASSERT_EQ(physical_plan->shuffle_kelvins().size(), 1);
+
+  auto pem_sinks = physical_plan->Get(1)->plan()->FindNodesThatMatch(GRPCSink());
+  ASSERT_EQ(pem_sinks.size(), 1);
+  EXPECT_THAT(static_cast<GRPCSinkIR*>(pem_sinks[0])->partition_columns(), ElementsAre("count"));
+}
+
 constexpr char kBadAgentSpecificationState[] = R"proto(
 carnot_info {
   query_broker_address: "pem"
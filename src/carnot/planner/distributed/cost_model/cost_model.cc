@@ -0,0 +1,292 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include "src/carnot/planner/distributed/cost_model/cost_model.h"
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+std::unique_ptr<CostModel> CostModel::Create(const distributedpb::DistributedState& state) {
+  std::unique_ptr<CostModel> model(new CostModel());
+  for (const auto& carnot_info : state.carnot_info()) {
+    for (const auto& table_stats : carnot_info.table_stats()) {
+      TableStatistics& stats = model->table_stats_[table_stats.table()];
+      stats.num_rows += table_stats.num_rows();
+      stats.num_bytes += table_stats.num_bytes();
+      ++stats.num_agents;
+      for (const auto& col_ndv : table_stats.column_ndv()) {
+        int64_t& ndv = stats.column_ndv[col_ndv.first];
+        ndv = std::max(ndv, col_ndv.second);
+      }
+    }
+  }
+  return model;
+}
+
+const TableStatistics* CostModel::GetTableStatistics(const std::string& table) const {
+  auto it = table_stats_.find(table);
+  if (it == table_stats_.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+std::optional<double> CostModel::EstimateRows(OperatorIR* op) const {
+  if (Match(op, MemorySource())) {
+    const TableStatistics* stats =
+        GetTableStatistics(static_cast<MemorySourceIR*>(op)->table_name());
+    if (stats == nullptr) {
+      return std::nullopt;
+    }
+    return static_cast<double>(stats->num_rows);
+  }
+  // We don't have stats for any other kind of source.
+  if (op->parents().empty()) {
+    return std::nullopt;
+  }
+  if (Match(op, BlockingAgg())) {
+    return EstimateGroups(static_cast<BlockingAggIR*>(op));
+  }
+  if (Match(op, Join()) || Match(op, Union())) {
+    // Joins are assumed to output about as many rows as their larger input, which holds for the
+    // common case of joining on a key of the smaller side.
+    double rows = 0;
+    for (OperatorIR* parent : op->parents()) {
+      std::optional<double> parent_rows = EstimateRows(parent);
+      if (!parent_rows.has_value()) {
+        return std::nullopt;
+      }
+      rows = Match(op, Join()) ? std::max(rows, *parent_rows) : rows + *parent_rows;
+    }
+    return rows;
+  }
+
+  std::optional<double> parent_rows = EstimateRows(op->parents()[0]);
+  if (!parent_rows.has_value()) {
+    return std::nullopt;
+  }
+  if (Match(op, Filter())) {
+    return *parent_rows * kFilterSelectivity;
+  }
+  if (Match(op, Limit())) {
+    return std::min(static_cast<double>(static_cast<LimitIR*>(op)->limit_value()), *parent_rows);
+  }
+  if (Match(op, TopK()) && static_cast<TopKIR*>(op)->limit_value_set()) {
+    return std::min(static_cast<double>(static_cast<TopKIR*>(op)->limit_value()), *parent_rows);
+  }
+  return parent_rows;
+}
+
+std::optional<double> CostModel::EstimateRowBytes(OperatorIR* op) const {
+  if (Match(op, MemorySource())) {
+    const TableStatistics* stats =
+        GetTableStatistics(static_cast<MemorySourceIR*>(op)->table_name());
+    if (stats == nullptr) {
+      return std::nullopt;
+    }
+    if (stats->num_rows == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(stats->num_bytes) / static_cast<double>(stats->num_rows);
+  }
+  if (op->parents().empty()) {
+    return std::nullopt;
+  }
+  if (Match(op, Join()) || Match(op, Union())) {
+    // Joined rows hold the columns of both sides, unioned rows are as wide as either side.
+    double row_bytes = 0;
+    for (OperatorIR* parent : op->parents()) {
+      std::optional<double> parent_row_bytes = EstimateRowBytes(parent);
+      if (!parent_row_bytes.has_value()) {
+        return std::nullopt;
+      }
+      row_bytes = Match(op, Join()) ? row_bytes + *parent_row_bytes
+                                    : std::max(row_bytes, *parent_row_bytes);
+    }
+    return row_bytes;
+  }
+  return EstimateRowBytes(op->parents()[0]);
+}
+
+std::optional<double> CostModel::EstimateBytes(OperatorIR* op) const {
+  std::optional<double> rows = EstimateRows(op);
+  std::optional<double> row_bytes = EstimateRowBytes(op);
+  if (!rows.has_value() || !row_bytes.has_value()) {
+    return std::nullopt;
+  }
+  return *rows * *row_bytes;
+}
+
+std::optional<double> CostModel::EstimateNDV(OperatorIR* op, const std::string& col_name) const {
+  std::optional<double> ndv;
+  if (Match(op, MemorySource())) {
+    const TableStatistics* stats =
+        GetTableStatistics(static_cast<MemorySourceIR*>(op)->table_name());
+    if (stats != nullptr) {
+      auto it = stats->column_ndv.find(col_name);
+      if (it != stats->column_ndv.end()) {
+        ndv = static_cast<double>(it->second);
+      }
+    }
+  } else if (Match(op, Map())) {
+    // Only columns that are copied from the input keep its distinct values.
+    for (const ColumnExpression& col_expr : static_cast<MapIR*>(op)->col_exprs()) {
+      if (col_expr.name == col_name && Match(col_expr.node, ColumnNode())) {
+        ndv = EstimateNDV(op->parents()[0], static_cast<ColumnIR*>(col_expr.node)->col_name());
+        break;
+      }
+    }
+  } else if (Match(op, Filter()) || Match(op, Limit()) || Match(op, TopK())) {
+    ndv = EstimateNDV(op->parents()[0], col_name);
+  } else if (Match(op, BlockingAgg())) {
+    for (ColumnIR* group : static_cast<BlockingAggIR*>(op)->groups()) {
+      if (group->col_name() == col_name) {
+        ndv = EstimateNDV(op->parents()[0], col_name);
+        break;
+      }
+    }
+  } else if (Match(op, Join())) {
+    auto join = static_cast<JoinIR*>(op);
+    for (const auto& [i, output_name] : Enumerate(join->column_names())) {
+      if (output_name == col_name) {
+        ColumnIR* input_col = join->output_columns()[i];
+        ndv = EstimateNDV(op->parents()[input_col->container_op_parent_idx()],
+                          input_col->col_name());
+        break;
+      }
+    }
+  }
+  if (!ndv.has_value()) {
+    return std::nullopt;
+  }
+  // There can't be more distinct values than rows.
+  std::optional<double> rows = EstimateRows(op);
+  if (rows.has_value()) {
+    return std::min(*ndv, *rows);
+  }
+  return ndv;
+}
+
+std::optional<double> CostModel::EstimateGroups(BlockingAggIR* agg) const {
+  OperatorIR* parent = agg->parents()[0];
+  std::optional<double> input_rows = EstimateRows(parent);
+  if (!input_rows.has_value()) {
+    return std::nullopt;
+  }
+  // Assume the group columns are independent, so the groups are every combination of their values.
+  double groups = 1;
+  for (ColumnIR* group : agg->groups()) {
+    // Agents only report distinct values for indexed columns. For the others, guess a value between
+    // a handful of groups and one group per row.
+    std::optional<double> ndv = EstimateNDV(parent, group->col_name());
+    groups *= ndv.value_or(std::sqrt(*input_rows));
+  }
+  return std::min(groups, *input_rows);
+}
+
+int64_t CostModel::NumSourceAgents(OperatorIR* op) const {
+  if (Match(op, MemorySource())) {
+    const TableStatistics* stats =
+        GetTableStatistics(static_cast<MemorySourceIR*>(op)->table_name());
+    return stats == nullptr ? 0 : stats->num_agents;
+  }
+  int64_t num_agents = 0;
+  for (OperatorIR* parent : op->parents()) {
+    num_agents = std::max(num_agents, NumSourceAgents(parent));
+  }
+  return num_agents;
+}
+
+bool CostModel::ShouldPartialAgg(BlockingAggIR* agg) const {
+  std::optional<double> input_rows = EstimateRows(agg->parents()[0]);
+  std::optional<double> groups = EstimateGroups(agg);
+  if (!input_rows.has_value() || !groups.has_value()) {
+    return false;
+  }
+  // Each agent outputs a partial row for each group in its data, and at most one per input row.
+  auto num_agents = static_cast<double>(std::max<int64_t>(1, NumSourceAgents(agg)));
+  double partial_rows = std::min(*groups * num_agents, *input_rows);
+  return partial_rows <= kPartialAggMaxOutputRatio * *input_rows;
+}
+
+JoinStrategy CostModel::ChooseJoinStrategy(JoinIR* join) const {
+  std::optional<double> left_bytes = EstimateBytes(join->parents()[0]);
+  std::optional<double> right_bytes = EstimateBytes(join->parents()[1]);
+  if (!left_bytes.has_value() || !right_bytes.has_value()) {
+    return JoinStrategy::kShuffle;
+  }
+  if (std::min(*left_bytes, *right_bytes) <= kSingleKelvinJoinMaxBytes) {
+    return JoinStrategy::kSingleKelvin;
+  }
+  return JoinStrategy::kShuffle;
+}
+
+std::optional<double> CostModel::EstimateKelvinInputBytes(OperatorIR* op) const {
+  if (Match(op, BlockingAgg())) {
+    auto agg = static_cast<BlockingAggIR*>(op);
+    OperatorIR* parent = agg->parents()[0];
+    if (!ShouldPartialAgg(agg)) {
+      return EstimateBytes(parent);
+    }
+    // Only the partial aggregates reach the Kelvin.
+    std::optional<double> row_bytes = EstimateRowBytes(parent);
+    std::optional<double> input_rows = EstimateRows(parent);
+    if (!row_bytes.has_value() || !input_rows.has_value()) {
+      return std::nullopt;
+    }
+    auto num_agents = static_cast<double>(std::max<int64_t>(1, NumSourceAgents(agg)));
+    return std::min(*EstimateGroups(agg) * num_agents, *input_rows) * *row_bytes;
+  }
+  if (Match(op, Join())) {
+    auto join = static_cast<JoinIR*>(op);
+    std::optional<double> left_bytes = EstimateBytes(join->parents()[0]);
+    std::optional<double> right_bytes = EstimateBytes(join->parents()[1]);
+    if (!left_bytes.has_value() || !right_bytes.has_value()) {
+      return std::nullopt;
+    }
+    // Both sides reach the Kelvins whether the join is shuffled or not.
+    return *left_bytes + *right_bytes;
+  }
+  return std::nullopt;
+}
+
+int64_t CostModel::NumKelvins(const IR* plan, int64_t max_kelvins) const {
+  max_kelvins = std::max<int64_t>(1, max_kelvins);
+  double kelvin_bytes = 0;
+  for (IRNode* node : plan->FindNodesThatMatch(Operator())) {
+    std::optional<double> bytes = EstimateKelvinInputBytes(static_cast<OperatorIR*>(node));
+    if (bytes.has_value()) {
+      kelvin_bytes += *bytes;
+    }
+  }
+  auto num_kelvins = static_cast<int64_t>(std::ceil(kelvin_bytes / kBytesPerKelvin));
+  return std::clamp<int64_t>(num_kelvins, 1, max_kelvins);
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/ir/ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief Rough statistics about a table, combined over all of the agents that reported it.
+ */
+struct TableStatistics {
+  int64_t num_rows = 0;
+  int64_t num_bytes = 0;
+  // Estimated number of distinct values per column. The values of different agents overlap by an
+  // unknown amount, so this is the largest estimate reported by any one agent.
+  absl::flat_hash_map<std::string, int64_t> column_ndv;
+  // The number of agents that reported the table.
+  int64_t num_agents = 0;
+};
+
+/**
+ * @brief The strategy used to execute a join across the cluster.
+ */
+enum class JoinStrategy {
+  // Gather both sides onto a single Kelvin and join them there.
+  kSingleKelvin,
+  // Partition both sides by the join keys, and join each partition on a different node.
+  kShuffle,
+};
+
+/**
+ * @brief CostModel estimates the size of the data that flows through a plan from the table stats
+ * that agents report in the DistributedState. The distributed planner uses the estimates to decide
+ * where and how to run blocking operators.
+ *
+ * The estimates are deliberately rough: they only need to be good enough to tell apart a handful of
+ * rows from millions of them. Every estimate is std::nullopt when the stats needed for it are
+ * missing, and callers should then fall back to the decision they'd make without a cost model.
+ */
+class CostModel : public NotCopyable {
+ public:
+  static std::unique_ptr<CostModel> Create(const distributedpb::DistributedState& state);
+
+  /**
+   * @return whether any agent reported table stats.
+   */
+  bool HasStats() const { return !table_stats_.empty(); }
+
+  /**
+   * @return the stats of the table, or nullptr if no agent reported any.
+   */
+  const TableStatistics* GetTableStatistics(const std::string& table) const;
+
+  /**
+   * @return the estimated number of rows output by the operator across the cluster.
+   */
+  std::optional<double> EstimateRows(OperatorIR* op) const;
+
+  /**
+   * @return the estimated number of bytes output by the operator across the cluster.
+   */
+  std::optional<double> EstimateBytes(OperatorIR* op) const;
+
+  /**
+   * @return the estimated number of distinct values of the named output column of the operator,
+   * for columns that can be traced back to a column with stats in a source table.
+   */
+  std::optional<double> EstimateNDV(OperatorIR* op, const std::string& col_name) const;
+
+  /**
+   * @brief Returns whether the aggregate should be split into a partial aggregate on each agent and
+   * a merge on the Kelvin. Partial aggregates pay off when they shrink the data each agent sends,
+   * ie. when there are few groups relative to the rows on each agent.
+   */
+  bool ShouldPartialAgg(BlockingAggIR* agg) const;
+
+  /**
+   * @brief Picks the join strategy from the estimated size of each side. The join runs on a single
+   * Kelvin if the smaller side, which the join holds in memory, is small enough, otherwise both
+   * sides are shuffled. Joins with unknown sizes are shuffled, which works for any size.
+   */
+  JoinStrategy ChooseJoinStrategy(JoinIR* join) const;
+
+  /**
+   * @brief Estimates how many Kelvins the blocking operators of the plan should be spread over,
+   * from the bytes each one has to process.
+   *
+   * @param plan the plan, before it is split.
+   * @param max_kelvins the number of available Kelvins.
+   * @return the number of Kelvins, between 1 and max_kelvins.
+   */
+  int64_t NumKelvins(const IR* plan, int64_t max_kelvins) const;
+
+  // The fraction of rows that are assumed to pass a filter.
+  static constexpr double kFilterSelectivity = 0.5;
+  // Aggregates are split if the partial aggregates output at most this fraction of their input.
+  static constexpr double kPartialAggMaxOutputRatio = 0.5;
+  // The largest smaller side of a join that runs on a single Kelvin.
+  static constexpr double kSingleKelvinJoinMaxBytes = 64.0 * 1024 * 1024;
+  // The number of bytes that a single Kelvin is assumed to process in a reasonable time.
+  static constexpr double kBytesPerKelvin = 1024.0 * 1024 * 1024;
+
+ private:
+  CostModel() = default;
+
+  // The number of distinct groups output by the aggregate. Group columns without an NDV estimate
+  // are assumed to have sqrt(input rows) distinct values.
+  std::optional<double> EstimateGroups(BlockingAggIR* agg) const;
+  // The average size of a row output by the operator.
+  std::optional<double> EstimateRowBytes(OperatorIR* op) const;
+  // The largest number of agents that hold any of the source tables of the operator.
+  int64_t NumSourceAgents(OperatorIR* op) const;
+  // The number of bytes that reach the Kelvin for the blocking operator.
+  std::optional<double> EstimateKelvinInputBytes(OperatorIR* op) const;
+
+  absl::flat_hash_map<std::string, TableStatistics> table_stats_;
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
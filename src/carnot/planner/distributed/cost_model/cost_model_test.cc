@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/cost_model/cost_model.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using ::testing::DoubleEq;
+using ::testing::Optional;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+constexpr int64_t kMB = 1024 * 1024;
+
+class CostModelTest : public OperatorTests {
+ protected:
+  void SetUpImpl() override {
+    // Two agents hold a large table of requests and a small table of services.
+    for (int64_t agent = 0; agent < 2; ++agent) {
+      auto carnot_info = state_.add_carnot_info();
+      carnot_info->set_has_data_store(true);
+      AddTableStats(carnot_info, "requests", 1000 * 1000, 100 * kMB, {{"svc", 10 + agent}});
+      AddTableStats(carnot_info, "services", 100, kMB / 100, {});
+    }
+    // The Kelvin doesn't report any stats.
+    state_.add_carnot_info()->set_accepts_remote_sources(true);
+    cost_model_ = CostModel::Create(state_);
+  }
+
+  void AddTableStats(distributedpb::CarnotInfo* carnot_info, const std::string& table,
+                     int64_t num_rows, int64_t num_bytes,
+                     const absl::flat_hash_map<std::string, int64_t>& column_ndv) {
+    auto table_stats = carnot_info->add_table_stats();
+    table_stats->set_table(table);
+    table_stats->set_num_rows(num_rows);
+    table_stats->set_num_bytes(num_bytes);
+    for (const auto& [col, ndv] : column_ndv) {
+      (*table_stats->mutable_column_ndv())[col] = ndv;
+    }
+  }
+
+  BlockingAggIR* MakeAgg(OperatorIR* parent, const std::string& group_col) {
+    return MakeBlockingAgg(parent, {MakeColumn(group_col, 0)},
+                           {{"mean", MakeMeanFunc(MakeColumn("latency", 0))}});
+  }
+
+  JoinIR* MakeJoinOnSvc(OperatorIR* left, OperatorIR* right) {
+    return MakeJoin({left, right}, "inner", {MakeColumn("svc", 0)}, {MakeColumn("svc", 1)});
+  }
+
+  distributedpb::DistributedState state_;
+  std::unique_ptr<CostModel> cost_model_;
+};
+
+TEST_F(CostModelTest, combines_agent_stats) {
+  const TableStatistics* stats = cost_model_->GetTableStatistics("requests");
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(2 * 1000 * 1000, stats->num_rows);
+  EXPECT_EQ(200 * kMB, stats->num_bytes);
+  EXPECT_EQ(2, stats->num_agents);
+  // The distinct values of the agents may overlap, so the largest estimate is kept.
+  EXPECT_THAT(stats->column_ndv, UnorderedElementsAre(Pair("svc", 11)));
+
+  EXPECT_EQ(nullptr, cost_model_->GetTableStatistics("missing"));
+  EXPECT_TRUE(cost_model_->HasStats());
+  EXPECT_FALSE(CostModel::Create(distributedpb::DistributedState{})->HasStats());
+}
+
+TEST_F(CostModelTest, estimate_rows) {
+  auto requests = MakeMemSource("requests");
+  EXPECT_THAT(cost_model_->EstimateRows(requests), Optional(2e6));
+  EXPECT_THAT(cost_model_->EstimateBytes(requests), Optional(DoubleEq(200.0 * kMB)));
+
+  auto filter = MakeFilter(requests, MakeEqualsFunc(MakeColumn("svc", 0), MakeInt(1)));
+  EXPECT_THAT(cost_model_->EstimateRows(filter), Optional(2e6 * CostModel::kFilterSelectivity));
+  EXPECT_THAT(cost_model_->EstimateRows(MakeLimit(filter, 10)), Optional(10.0));
+  // Renamed columns keep the distinct values of the source column.
+  auto map = MakeMap(filter, {{"service", MakeColumn("svc", 0)}});
+  EXPECT_THAT(cost_model_->EstimateNDV(map, "service"), Optional(11.0));
+  EXPECT_FALSE(cost_model_->EstimateNDV(map, "svc").has_value());
+  EXPECT_THAT(cost_model_->EstimateRows(MakeAgg(map, "service")), Optional(11.0));
+
+  auto join = MakeJoinOnSvc(requests, MakeMemSource("services"));
+  EXPECT_THAT(cost_model_->EstimateRows(join), Optional(2e6));
+
+  EXPECT_FALSE(cost_model_->EstimateRows(MakeMemSource("missing")).has_value());
+}
+
+TEST_F(CostModelTest, partial_agg) {
+  auto requests = MakeMemSource("requests");
+  // 11 groups on each of the 2 agents is far less than the rows.
+  EXPECT_TRUE(cost_model_->ShouldPartialAgg(MakeAgg(requests, "svc")));
+  // There is no estimate for the distinct values of the column, so it's assumed to have
+  // sqrt(rows) of them, which still makes for few groups.
+  auto latency_agg = MakeAgg(requests, "latency");
+  EXPECT_THAT(cost_model_->EstimateRows(latency_agg), Optional(DoubleEq(std::sqrt(2e6))));
+  EXPECT_TRUE(cost_model_->ShouldPartialAgg(latency_agg));
+  // Two such columns make as many groups as there are rows.
+  auto two_col_agg =
+      MakeBlockingAgg(requests, {MakeColumn("latency", 0), MakeColumn("resp_size", 0)},
+                      {{"mean", MakeMeanFunc(MakeColumn("latency", 0))}});
+  EXPECT_FALSE(cost_model_->ShouldPartialAgg(two_col_agg));
+  // Each of the 200 service rows could be its own group.
+  auto services = MakeMemSource("services");
+  (*state_.mutable_carnot_info(0)->mutable_table_stats(1)->mutable_column_ndv())["svc"] = 200;
+  cost_model_ = CostModel::Create(state_);
+  EXPECT_FALSE(cost_model_->ShouldPartialAgg(MakeAgg(services, "svc")));
+}
+
+TEST_F(CostModelTest, join_strategy) {
+  auto requests = MakeMemSource("requests");
+  EXPECT_EQ(JoinStrategy::kSingleKelvin,
+            cost_model_->ChooseJoinStrategy(MakeJoinOnSvc(requests, MakeMemSource("services"))));
+  EXPECT_EQ(JoinStrategy::kShuffle,
+            cost_model_->ChooseJoinStrategy(MakeJoinOnSvc(requests, MakeMemSource("requests"))));
+  EXPECT_EQ(JoinStrategy::kShuffle,
+            cost_model_->ChooseJoinStrategy(MakeJoinOnSvc(requests, MakeMemSource("missing"))));
+}
+
+TEST_F(CostModelTest, num_kelvins) {
+  auto requests = MakeMemSource("requests");
+  MakeMemSink(MakeJoinOnSvc(requests, MakeMemSource("requests")), "out");
+  // The shuffle join has to process 400MB, which fits on a single Kelvin.
+  EXPECT_EQ(1, cost_model_->NumKelvins(graph.get(), 8));
+
+  for (int64_t agent = 0; agent < 2; ++agent) {
+    state_.mutable_carnot_info(agent)->mutable_table_stats(0)->set_num_bytes(10 * 1024 * kMB);
+  }
+  cost_model_ = CostModel::Create(state_);
+  // Now each side is about 20GB, which is spread over as many Kelvins as are available.
+  EXPECT_EQ(8, cost_model_->NumKelvins(graph.get(), 8));
+  EXPECT_EQ(1, cost_model_->NumKelvins(graph.get(), 0));
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
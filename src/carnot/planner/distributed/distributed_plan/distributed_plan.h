@@ -164,11 +164,22 @@ class DistributedPlan {
 
   CarnotInstance* kelvin() const { return kelvin_; }
 
+  /**
+   * @brief Adds a Kelvin that runs the shuffle stages of the plan next to the main Kelvin, on its
+   * own partition of the data. Shuffle Kelvins send their results to the main Kelvin.
+   */
+  void AddShuffleKelvin(CarnotInstance* kelvin) {
+    DCHECK(id_to_node_map_.contains(kelvin->id()));
+    shuffle_kelvins_.push_back(kelvin);
+  }
+  const std::vector<CarnotInstance*>& shuffle_kelvins() const { return shuffle_kelvins_; }
+
  private:
   plan::DAG dag_;
   absl::flat_hash_map<int64_t, std::unique_ptr<CarnotInstance>> id_to_node_map_;
   absl::flat_hash_map<IR*, absl::flat_hash_set<int64_t>> plan_to_agent_map_;
   CarnotInstance* kelvin_ = nullptr;
+  std::vector<CarnotInstance*> shuffle_kelvins_;
   std::vector<std::unique_ptr<IR>> plan_pool_;
   absl::flat_hash_map<int64_t, IR*> agent_to_plan_map_;
   absl::flat_hash_map<sole::uuid, int64_t> uuid_to_id_map_;
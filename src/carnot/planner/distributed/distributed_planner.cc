@@ -49,23 +49,40 @@ Status StitchPlan(DistributedPlan* distributed_plan) {
   IR* remote_plan = remote_carnot->plan();
   DCHECK(remote_plan);
 
+  // The Kelvins that receive data from the agents. Shuffle sinks assign partitions to the Kelvins in
+  // this order.
+  std::vector<CarnotInstance*> kelvins{remote_carnot};
+  kelvins.insert(kelvins.end(), distributed_plan->shuffle_kelvins().begin(),
+                 distributed_plan->shuffle_kelvins().end());
+
   DistributedSetSourceGroupGRPCAddressRule set_grpc_address_rule;
-  PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(remote_carnot));
+  for (CarnotInstance* kelvin : kelvins) {
+    PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(kelvin));
+  }
 
   // Connect the plans.
-  for (const auto& [plan, agents] : distributed_plan->plan_to_agent_map()) {
-    PL_ASSIGN_OR_RETURN(auto did_connect_plan, AssociateDistributedPlanEdgesRule::ConnectGraphs(
-                                                   plan, agents, remote_plan));
-    DCHECK(did_connect_plan);
+  for (CarnotInstance* kelvin : kelvins) {
+    for (const auto& [plan, agents] : distributed_plan->plan_to_agent_map()) {
+      PL_ASSIGN_OR_RETURN(auto did_connect_plan, AssociateDistributedPlanEdgesRule::ConnectGraphs(
+                                                     plan, agents, kelvin->plan()));
+      // Shuffle Kelvins only receive data for the shuffle stages.
+      DCHECK(did_connect_plan || kelvin != remote_carnot);
+    }
+    // TODO(philkuz) make this connect to self without a grpc bridge.
+    PL_RETURN_IF_ERROR(AssociateDistributedPlanEdgesRule::ConnectGraphs(
+        remote_plan, {remote_node_id}, kelvin->plan()));
+  }
+  // The shuffle Kelvins send their partition of the output back to the main Kelvin.
+  for (CarnotInstance* shuffle_kelvin : distributed_plan->shuffle_kelvins()) {
+    PL_RETURN_IF_ERROR(AssociateDistributedPlanEdgesRule::ConnectGraphs(
+        shuffle_kelvin->plan(), {shuffle_kelvin->id()}, remote_plan));
   }
 
-  // TODO(philkuz) make this connect to self without a grpc bridge.
-  PL_RETURN_IF_ERROR(
-      AssociateDistributedPlanEdgesRule::ConnectGraphs(remote_plan, {remote_node_id}, remote_plan));
-
-  // Expand GRPCSourceGroups in the remote_plan.
+  // Expand GRPCSourceGroups in the Kelvin plans.
   GRPCSourceGroupConversionRule conversion_rule;
-  PL_RETURN_IF_ERROR(conversion_rule.Execute(remote_plan));
+  for (CarnotInstance* kelvin : kelvins) {
+    PL_RETURN_IF_ERROR(conversion_rule.Execute(kelvin->plan()));
+  }
   return MergeSameNodeGRPCBridgeRule(remote_node_id).Execute(remote_plan).status();
 }
 
@@ -63,7 +63,13 @@ StatusOr<GRPCSourceIR*> GRPCSourceGroupConversionRule::CreateGRPCSource(
 
 // Have to get rid of this function. Instead, need to associate (agent_id, sink_id) ->
 // source_id/destination_id.
-Status UpdateSink(GRPCSourceIR* source, GRPCSinkIR* sink, int64_t agent_id) {
+Status UpdateSink(GRPCSourceGroupIR* group_ir, GRPCSourceIR* source, GRPCSinkIR* sink,
+                  int64_t agent_id) {
+  if (sink->is_shuffle()) {
+    sink->AddShuffleDestination(agent_id, source->id(), group_ir->grpc_address(),
+                                group_ir->ssl_targetname());
+    return Status::OK();
+  }
   sink->AddDestinationIDMap(source->id(), agent_id);
   return Status::OK();
 }
@@ -83,7 +89,8 @@ StatusOr<OperatorIR*> GRPCSourceGroupConversionRule::ConvertGRPCSourceGroup(
   // Don't add an unnecessary union node if there is only one sink.
   if (sinks.size() == 1 && sinks[0].second.size() == 1) {
     PL_ASSIGN_OR_RETURN(auto new_grpc_source, CreateGRPCSource(group_ir));
-    PL_RETURN_IF_ERROR(UpdateSink(new_grpc_source, sinks[0].first, *(sinks[0].second.begin())));
+    PL_RETURN_IF_ERROR(
+        UpdateSink(group_ir, new_grpc_source, sinks[0].first, *(sinks[0].second.begin())));
     return new_grpc_source;
   }
 
@@ -92,7 +99,7 @@ StatusOr<OperatorIR*> GRPCSourceGroupConversionRule::ConvertGRPCSourceGroup(
     DCHECK_GE(sinks[0].second.size(), 1);
     for (int64_t agent_id : sink.second) {
       PL_ASSIGN_OR_RETURN(GRPCSourceIR * new_grpc_source, CreateGRPCSource(group_ir));
-      PL_RETURN_IF_ERROR(UpdateSink(new_grpc_source, sink.first, agent_id));
+      PL_RETURN_IF_ERROR(UpdateSink(group_ir, new_grpc_source, sink.first, agent_id));
       grpc_sources.push_back(new_grpc_source);
     }
   }
@@ -109,6 +116,10 @@ StatusOr<bool> MergeSameNodeGRPCBridgeRule::Apply(IRNode* ir_node) {
     return false;
   }
   GRPCSinkIR* grpc_sink = static_cast<GRPCSinkIR*>(ir_node);
+  // Shuffle sinks also send partitions to other Kelvins, so they keep their GRPC bridge.
+  if (grpc_sink->is_shuffle()) {
+    return false;
+  }
   DCHECK(grpc_sink->agent_id_to_destination_id().contains(current_agent_id_))
       << "Expected the grpc sink to contain this current agent ID as a a target";
   int64_t dest_id = grpc_sink->agent_id_to_destination_id().at(current_agent_id_);
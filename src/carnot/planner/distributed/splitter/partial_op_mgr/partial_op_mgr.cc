@@ -44,6 +44,36 @@ StatusOr<OperatorIR*> LimitOperatorMgr::CreateMergeOperator(IR* plan, OperatorIR
   return new_limit;
 }
 
+StatusOr<OperatorIR*> TopKOperatorMgr::CreatePrepareOperator(IR* plan, OperatorIR* op) const {
+  DCHECK(Matches(op));
+  TopKIR* topk = static_cast<TopKIR*>(op);
+  PL_ASSIGN_OR_RETURN(TopKIR * new_topk, plan->CopyNode(topk));
+  PL_RETURN_IF_ERROR(new_topk->CopyParentsFrom(topk));
+
+  // The merging TopK sorts on the same columns, so the local TopK has to send them along even
+  // when they were pruned from the output of the original TopK.
+  auto new_type = std::static_pointer_cast<TableType>(topk->resolved_table_type()->Copy());
+  auto parent_type = topk->parents()[0]->resolved_table_type();
+  for (const auto& sort_col : topk->sort_cols()) {
+    if (new_type->HasColumn(sort_col)) {
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(auto col_type, parent_type->GetColumnType(sort_col));
+    new_type->AddColumn(sort_col, col_type);
+  }
+  PL_RETURN_IF_ERROR(new_topk->SetResolvedType(new_type));
+  return new_topk;
+}
+
+StatusOr<OperatorIR*> TopKOperatorMgr::CreateMergeOperator(IR* plan, OperatorIR* new_parent,
+                                                           OperatorIR* op) const {
+  DCHECK(Matches(op));
+  TopKIR* topk = static_cast<TopKIR*>(op);
+  PL_ASSIGN_OR_RETURN(TopKIR * new_topk, plan->CopyNode(topk));
+  PL_RETURN_IF_ERROR(new_topk->AddParent(new_parent));
+  return new_topk;
+}
+
 StatusOr<OperatorIR*> AggOperatorMgr::CreatePrepareOperator(IR* plan, OperatorIR* op) const {
   DCHECK(Matches(op));
   BlockingAggIR* agg = static_cast<BlockingAggIR*>(op);
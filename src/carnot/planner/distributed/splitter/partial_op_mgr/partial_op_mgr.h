@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "src/carnot/planner/distributed/cost_model/cost_model.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
 
@@ -87,12 +88,36 @@ class LimitOperatorMgr : public PartialOperatorMgr {
                                             OperatorIR* op) const override;
 };
 
+/**
+ * @brief TopKOperatorMgr splits a bounded TopK into a local TopK on each data source and a TopK
+ * that merges their results, so only `limit` rows per source cross the network.
+ */
+class TopKOperatorMgr : public PartialOperatorMgr {
+ public:
+  bool Matches(OperatorIR* op) const override {
+    if (!Match(op, TopK())) {
+      return false;
+    }
+    return static_cast<TopKIR*>(op)->limit_value_set();
+  }
+  StatusOr<OperatorIR*> CreatePrepareOperator(IR* plan, OperatorIR* op) const override;
+  StatusOr<OperatorIR*> CreateMergeOperator(IR* plan, OperatorIR* new_parent,
+                                            OperatorIR* op) const override;
+};
+
 /**
  * @brief AggOperatorMgr manages splitting aggregates into partial aggregate and the merging node
  * over a network boundary.
  */
 class AggOperatorMgr : public PartialOperatorMgr {
  public:
+  AggOperatorMgr() = default;
+  /**
+   * @param cost_model only aggregates that the cost model says benefit from partial aggregation are
+   * split.
+   */
+  explicit AggOperatorMgr(const CostModel* cost_model) : cost_model_(cost_model) {}
+
   bool Matches(OperatorIR* op) const override {
     if (!Match(op, BlockingAgg())) {
       return false;
@@ -103,11 +128,14 @@ class AggOperatorMgr : public PartialOperatorMgr {
         return false;
       }
     }
-    return true;
+    return cost_model_ == nullptr || cost_model_->ShouldPartialAgg(agg);
   }
   StatusOr<OperatorIR*> CreatePrepareOperator(IR* plan, OperatorIR* op) const override;
   StatusOr<OperatorIR*> CreateMergeOperator(IR* plan, OperatorIR* new_parent,
                                             OperatorIR* op) const override;
+
+ private:
+  const CostModel* cost_model_ = nullptr;
 };
 }  // namespace distributed
 }  // namespace planner
@@ -68,6 +68,45 @@ TEST_F(PartialOpMgrTest, limit_test) {
   EXPECT_NE(merge_limit, limit);
 }
 
+TEST_F(PartialOpMgrTest, topk_test) {
+  auto mem_src = MakeMemSource("source", MakeRelation());
+  compiler_state_->relation_map()->emplace("source", MakeRelation());
+  auto unbounded_topk = MakeTopK(mem_src, {"cpu0"}, {false});
+  auto topk = MakeTopK(mem_src, {"cpu0"}, {false}, 10);
+  MakeMemSink(unbounded_topk, "unbounded");
+  MakeMemSink(topk, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+  // Prune the sort column from the output, the local TopK still needs to send it along.
+  ASSERT_OK(topk->PruneOutputColumnsTo({"count"}));
+
+  TopKOperatorMgr mgr;
+  EXPECT_FALSE(mgr.Matches(unbounded_topk));
+  EXPECT_TRUE(mgr.Matches(topk));
+  auto prepare_topk_or_s = mgr.CreatePrepareOperator(graph.get(), topk);
+  ASSERT_OK(prepare_topk_or_s);
+  OperatorIR* prepare_topk_uncasted = prepare_topk_or_s.ConsumeValueOrDie();
+  ASSERT_MATCH(prepare_topk_uncasted, TopK());
+  TopKIR* prepare_topk = static_cast<TopKIR*>(prepare_topk_uncasted);
+  EXPECT_EQ(prepare_topk->limit_value(), 10);
+  EXPECT_EQ(prepare_topk->sort_cols(), topk->sort_cols());
+  EXPECT_EQ(prepare_topk->parents(), topk->parents());
+  EXPECT_THAT(*prepare_topk->resolved_table_type(),
+              IsTableType(Relation({types::INT64, types::FLOAT64}, {"count", "cpu0"})));
+
+  auto mem_src2 = MakeMemSource(MakeRelation());
+  auto merge_topk_or_s = mgr.CreateMergeOperator(graph.get(), mem_src2, topk);
+  ASSERT_OK(merge_topk_or_s);
+  OperatorIR* merge_topk_uncasted = merge_topk_or_s.ConsumeValueOrDie();
+  ASSERT_MATCH(merge_topk_uncasted, TopK());
+  TopKIR* merge_topk = static_cast<TopKIR*>(merge_topk_uncasted);
+  EXPECT_EQ(merge_topk->limit_value(), 10);
+  EXPECT_EQ(merge_topk->parents()[0], mem_src2);
+  EXPECT_THAT(*merge_topk->resolved_table_type(),
+              IsTableType(Relation({types::INT64}, {"count"})));
+}
+
 TEST_F(PartialOpMgrTest, agg_test) {
   auto relation = MakeRelation();
   relation.AddColumn(types::STRING, "service");
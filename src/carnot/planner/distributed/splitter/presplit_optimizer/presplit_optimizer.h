@@ -22,6 +22,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/filter_push_down_rule.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/limit_push_down_rule.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/scan_predicate_push_down_rule.h"
 #include "src/carnot/planner/rules/rule_executor.h"
 
 namespace px {
@@ -59,9 +60,16 @@ class PreSplitOptimizer : public RuleExecutor<IR> {
     filter_pushdown->AddRule<FilterPushdownRule>(compiler_state_);
   }
 
+  void CreateScanPredicatePushdownBatch() {
+    // Runs after filter pushdown so that filters have already been moved next to their sources.
+    RuleBatch* scan_predicate_pushdown = CreateRuleBatch<TryUntilMax>("ScanPredicatePushdown", 1);
+    scan_predicate_pushdown->AddRule<ScanPredicatePushdownRule>(compiler_state_);
+  }
+
   Status Init() {
     CreateLimitPushdownBatch();
     CreateFilterPushdownBatch();
+    CreateScanPredicatePushdownBatch();
     return Status::OK();
   }
 
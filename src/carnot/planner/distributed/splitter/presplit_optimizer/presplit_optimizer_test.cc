@@ -74,6 +74,7 @@ TEST_F(PreSplitOptimizerTest, filter_pushdown) {
   auto col = MakeColumn("abc", 0);
   auto eq_func = MakeEqualsFunc(col, MakeInt(2));
   FilterIR* filter = MakeFilter(map, eq_func);
+  auto filter_id = filter->id();
   MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
 
   ResolveTypesRule type_rule(compiler_state_.get());
@@ -82,10 +83,14 @@ TEST_F(PreSplitOptimizerTest, filter_pushdown) {
   auto optimizer = PreSplitOptimizer::Create(compiler_state_.get()).ConsumeValueOrDie();
   ASSERT_OK(optimizer->Execute(graph.get()));
 
+  // The filter is pushed up to the source, where it's evaluated as a scan predicate.
+  EXPECT_FALSE(graph->HasNode(filter_id));
   EXPECT_THAT(sink->parents(), ElementsAre(map));
-  EXPECT_THAT(map->parents(), ElementsAre(filter));
-  EXPECT_THAT(filter->parents(), ElementsAre(src));
-  EXPECT_MATCH(filter->filter_expr(), Equals(ColumnNode("abc"), Int(2)));
+  EXPECT_THAT(map->parents(), ElementsAre(src));
+  ASSERT_EQ(1, src->scan_predicates().size());
+  EXPECT_EQ(0, src->scan_predicates()[0].column_idx());
+  EXPECT_EQ(planpb::ScanPredicate::EQUAL, src->scan_predicates()[0].op());
+  EXPECT_EQ(2, src->scan_predicates()[0].value().int64_value());
 }
 
 }  // namespace distributed
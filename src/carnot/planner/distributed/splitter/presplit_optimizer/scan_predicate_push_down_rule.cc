@@ -0,0 +1,252 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/scan_predicate_push_down_rule.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+
+using OptionalScanPredicate = std::optional<planpb::ScanPredicate>;
+
+// Appends the operands of a (possibly nested) `and` expression to conjuncts.
+void SplitConjuncts(ExpressionIR* expr, std::vector<ExpressionIR*>* conjuncts) {
+  if (Match(expr, Func()) && static_cast<FuncIR*>(expr)->opcode() == FuncIR::logand) {
+    for (ExpressionIR* arg : static_cast<FuncIR*>(expr)->all_args()) {
+      SplitConjuncts(arg, conjuncts);
+    }
+    return;
+  }
+  conjuncts->push_back(expr);
+}
+
+// Appends the operands of a (possibly nested) `or` expression to disjuncts.
+void SplitDisjuncts(ExpressionIR* expr, std::vector<ExpressionIR*>* disjuncts) {
+  if (Match(expr, Func()) && static_cast<FuncIR*>(expr)->opcode() == FuncIR::logor) {
+    for (ExpressionIR* arg : static_cast<FuncIR*>(expr)->all_args()) {
+      SplitDisjuncts(arg, disjuncts);
+    }
+    return;
+  }
+  disjuncts->push_back(expr);
+}
+
+// Returns the index of the column in the source's table, or std::nullopt if the column isn't
+// output by the source.
+std::optional<int64_t> TableColumnIndex(MemorySourceIR* src, ColumnIR* col) {
+  if (!src->is_type_resolved() || !src->column_index_map_set() || !col->is_type_resolved()) {
+    return std::nullopt;
+  }
+  const auto& col_names = src->resolved_table_type()->ColumnNames();
+  auto it = std::find(col_names.begin(), col_names.end(), col->col_name());
+  if (it == col_names.end()) {
+    return std::nullopt;
+  }
+  return src->column_index_map()[std::distance(col_names.begin(), it)];
+}
+
+// Writes the literal as a value of the column's type. Returns false if the literal can't be
+// compared to the column without a conversion the memory source doesn't support.
+StatusOr<bool> LiteralToColumnValue(types::DataType col_type, DataIR* literal,
+                                    planpb::ScalarValue* value) {
+  auto literal_type = literal->EvaluatedDataType();
+  if (literal_type == col_type) {
+    PL_RETURN_IF_ERROR(literal->ToProto(value));
+    return true;
+  }
+  if (literal_type != types::INT64) {
+    return false;
+  }
+  auto int_val = static_cast<IntIR*>(literal)->val();
+  switch (col_type) {
+    case types::TIME64NS:
+      value->set_data_type(types::TIME64NS);
+      value->set_time64_ns_value(int_val);
+      return true;
+    case types::FLOAT64:
+      value->set_data_type(types::FLOAT64);
+      value->set_float64_value(static_cast<double>(int_val));
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the scan predicate op for `col <opcode> literal`. If the literal is on the left hand
+// side, the op is flipped so that the column is always on the left.
+std::optional<planpb::ScanPredicate::Op> ScanPredicateOp(FuncIR::Opcode opcode,
+                                                         bool literal_on_left) {
+  switch (opcode) {
+    case FuncIR::eq:
+      return planpb::ScanPredicate::EQUAL;
+    case FuncIR::neq:
+      return planpb::ScanPredicate::NOT_EQUAL;
+    case FuncIR::lt:
+      return literal_on_left ? planpb::ScanPredicate::GREATER_THAN
+                             : planpb::ScanPredicate::LESS_THAN;
+    case FuncIR::lteq:
+      return literal_on_left ? planpb::ScanPredicate::GREATER_THAN_EQUAL
+                             : planpb::ScanPredicate::LESS_THAN_EQUAL;
+    case FuncIR::gt:
+      return literal_on_left ? planpb::ScanPredicate::LESS_THAN
+                             : planpb::ScanPredicate::GREATER_THAN;
+    case FuncIR::gteq:
+      return literal_on_left ? planpb::ScanPredicate::LESS_THAN_EQUAL
+                             : planpb::ScanPredicate::GREATER_THAN_EQUAL;
+    default:
+      return std::nullopt;
+  }
+}
+
+}  // namespace
+
+StatusOr<OptionalScanPredicate> ScanPredicatePushdownRule::ComparisonToScanPredicate(
+    MemorySourceIR* src, FuncIR* func) {
+  const auto& args = func->all_args();
+  if (args.size() != 2) {
+    return OptionalScanPredicate();
+  }
+  bool literal_on_left = Match(args[0], DataNode()) && Match(args[1], ColumnNode());
+  if (!literal_on_left && !(Match(args[0], ColumnNode()) && Match(args[1], DataNode()))) {
+    return OptionalScanPredicate();
+  }
+  auto col = static_cast<ColumnIR*>(literal_on_left ? args[1] : args[0]);
+  auto literal = static_cast<DataIR*>(literal_on_left ? args[0] : args[1]);
+
+  auto op = ScanPredicateOp(func->opcode(), literal_on_left);
+  auto col_idx = TableColumnIndex(src, col);
+  if (!op.has_value() || !col_idx.has_value()) {
+    return OptionalScanPredicate();
+  }
+  planpb::ScanPredicate pred;
+  pred.set_column_idx(col_idx.value());
+  pred.set_op(op.value());
+  auto value = pred.mutable_value();
+  PL_ASSIGN_OR_RETURN(bool converted,
+                      LiteralToColumnValue(col->EvaluatedDataType(), literal, value));
+  if (!converted) {
+    return OptionalScanPredicate();
+  }
+  return OptionalScanPredicate(std::move(pred));
+}
+
+StatusOr<OptionalScanPredicate> ScanPredicatePushdownRule::EqualsAnyToScanPredicate(
+    MemorySourceIR* src, FuncIR* func) {
+  std::vector<ExpressionIR*> disjuncts;
+  SplitDisjuncts(func, &disjuncts);
+
+  planpb::ScanPredicate pred;
+  pred.set_op(planpb::ScanPredicate::IN);
+  for (const auto& [idx, disjunct] : Enumerate(disjuncts)) {
+    if (!Match(disjunct, Func()) || static_cast<FuncIR*>(disjunct)->opcode() != FuncIR::eq) {
+      return OptionalScanPredicate();
+    }
+    PL_ASSIGN_OR_RETURN(auto eq_pred,
+                        ComparisonToScanPredicate(src, static_cast<FuncIR*>(disjunct)));
+    // All of the comparisons have to be on the same column.
+    if (!eq_pred.has_value() || (idx > 0 && eq_pred->column_idx() != pred.column_idx())) {
+      return OptionalScanPredicate();
+    }
+    pred.set_column_idx(eq_pred->column_idx());
+    *pred.add_in_values() = eq_pred->value();
+  }
+  return OptionalScanPredicate(std::move(pred));
+}
+
+StatusOr<OptionalScanPredicate> ScanPredicatePushdownRule::ToScanPredicate(
+    MemorySourceIR* src, ExpressionIR* expr) {
+  if (Match(expr, ColumnNode())) {
+    // A boolean column used directly as the filter condition.
+    auto col = static_cast<ColumnIR*>(expr);
+    auto col_idx = TableColumnIndex(src, col);
+    if (!col_idx.has_value() || col->EvaluatedDataType() != types::BOOLEAN) {
+      return OptionalScanPredicate();
+    }
+    planpb::ScanPredicate pred;
+    pred.set_column_idx(col_idx.value());
+    pred.set_op(planpb::ScanPredicate::EQUAL);
+    pred.mutable_value()->set_data_type(types::BOOLEAN);
+    pred.mutable_value()->set_bool_value(true);
+    return OptionalScanPredicate(std::move(pred));
+  }
+  if (!Match(expr, Func())) {
+    return OptionalScanPredicate();
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  if (func->opcode() == FuncIR::logor) {
+    return EqualsAnyToScanPredicate(src, func);
+  }
+  return ComparisonToScanPredicate(src, func);
+}
+
+Status ScanPredicatePushdownRule::RemoveFilter(FilterIR* filter, MemorySourceIR* src) {
+  for (OperatorIR* child : filter->Children()) {
+    PL_RETURN_IF_ERROR(child->ReplaceParent(filter, src));
+  }
+  PL_RETURN_IF_ERROR(filter->RemoveParent(src));
+  return filter->graph()->DeleteSubtree(filter->id());
+}
+
+StatusOr<bool> ScanPredicatePushdownRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Filter())) {
+    return false;
+  }
+  auto filter = static_cast<FilterIR*>(ir_node);
+  if (filter->parents().size() != 1 || !Match(filter->parents()[0], MemorySource())) {
+    return false;
+  }
+  auto src = static_cast<MemorySourceIR*>(filter->parents()[0]);
+  // Predicates apply to everything the source returns, so it can't be shared with other
+  // operators.
+  if (src->Children().size() != 1) {
+    return false;
+  }
+
+  std::vector<ExpressionIR*> conjuncts;
+  SplitConjuncts(filter->filter_expr(), &conjuncts);
+  std::vector<planpb::ScanPredicate> preds;
+  for (ExpressionIR* conjunct : conjuncts) {
+    PL_ASSIGN_OR_RETURN(auto pred, ToScanPredicate(src, conjunct));
+    if (pred.has_value()) {
+      preds.push_back(std::move(pred.value()));
+    }
+  }
+  if (preds.empty()) {
+    return false;
+  }
+  for (const auto& pred : preds) {
+    src->AddScanPredicate(pred);
+  }
+  // The filter still has to evaluate the conjuncts that couldn't be pushed. It keeps the pushed
+  // ones as well, which is cheap since they match every row the source returns.
+  if (preds.size() == conjuncts.size()) {
+    PL_RETURN_IF_ERROR(RemoveFilter(filter, src));
+  }
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "src/carnot/planner/ir/filter_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/rules/rules.h"
+#include "src/carnot/planpb/plan.pb.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief This rule moves the comparisons of a Filter that directly follows a MemorySource into
+ * the MemorySource's scan predicates, so that the source can skip data that can't match instead
+ * of reading it and sending it to the filter.
+ *
+ * Each conjunct of the filter expression that compares a column to a literal, checks a column
+ * against a list of literals with `==` and `or` (eg. `px.equals_any`), or is a boolean column is
+ * pushed. If every conjunct is pushed, the Filter is removed from the plan. It must run after
+ * FilterPushdownRule, which moves filters up to their sources.
+ */
+class ScanPredicatePushdownRule : public Rule {
+ public:
+  explicit ScanPredicatePushdownRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ true, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode*) override;
+
+ private:
+  /**
+   * @brief Returns the scan predicate equivalent to the expression, or std::nullopt if the
+   * expression can't be evaluated by the memory source.
+   */
+  StatusOr<std::optional<planpb::ScanPredicate>> ToScanPredicate(MemorySourceIR* src,
+                                                                ExpressionIR* expr);
+  StatusOr<std::optional<planpb::ScanPredicate>> ComparisonToScanPredicate(MemorySourceIR* src,
+                                                                          FuncIR* func);
+  StatusOr<std::optional<planpb::ScanPredicate>> EqualsAnyToScanPredicate(MemorySourceIR* src,
+                                                                         FuncIR* func);
+  Status RemoveFilter(FilterIR* filter, MemorySourceIR* src);
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/scan_predicate_push_down_rule.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using compiler::ResolveTypesRule;
+using ::px::testing::proto::EqualsProto;
+using ::testing::ElementsAre;
+
+class ScanPredicatePushdownTest : public testutils::DistributedRulesTest {
+ protected:
+  MemorySourceIR* MakeSource() {
+    Relation relation({types::DataType::INT64, types::DataType::FLOAT64, types::DataType::STRING},
+                      {"abc", "xyz", "req_path"});
+    compiler_state_->relation_map()->emplace("source", relation);
+    return MakeMemSource("source", relation);
+  }
+
+  FuncIR* MakeComparison(const std::string& op, ExpressionIR* left, ExpressionIR* right) {
+    return graph
+        ->CreateNode<FuncIR>(ast, FuncIR::op_map.find(op)->second,
+                             std::vector<ExpressionIR*>({left, right}))
+        .ConsumeValueOrDie();
+  }
+
+  StatusOr<bool> ResolveTypesAndApply() {
+    ResolveTypesRule type_rule(compiler_state_.get());
+    PL_RETURN_IF_ERROR(type_rule.Execute(graph.get()));
+    ScanPredicatePushdownRule rule(compiler_state_.get());
+    return rule.Execute(graph.get());
+  }
+};
+
+constexpr char kXyzLessThanPredicate[] = R"proto(
+  column_idx: 1
+  op: LESS_THAN
+  value { data_type: FLOAT64 float64_value: 10 }
+)proto";
+
+constexpr char kReqPathEqualsPredicate[] = R"proto(
+  column_idx: 2
+  op: EQUAL
+  value { data_type: STRING string_value: "/healthz" }
+)proto";
+
+TEST_F(ScanPredicatePushdownTest, filter_removed_when_fully_pushed) {
+  MemorySourceIR* src = MakeSource();
+  // 10.0 > xyz and req_path == "/healthz"
+  auto and_func = MakeAndFunc(MakeComparison(">", MakeFloat(10), MakeColumn("xyz", 0)),
+                              MakeEqualsFunc(MakeColumn("req_path", 0), MakeString("/healthz")));
+  FilterIR* filter = MakeFilter(src, and_func);
+  auto filter_id = filter->id();
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+
+  auto result = ResolveTypesAndApply();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_FALSE(graph->HasNode(filter_id));
+  EXPECT_THAT(sink->parents(), ElementsAre(src));
+  // The literal is on the left of the first comparison, so its op is flipped.
+  EXPECT_THAT(src->scan_predicates(), ElementsAre(EqualsProto(kXyzLessThanPredicate),
+                                                  EqualsProto(kReqPathEqualsPredicate)));
+}
+
+TEST_F(ScanPredicatePushdownTest, equals_any_pushed_as_in) {
+  MemorySourceIR* src = MakeSource();
+  auto or_func = MakeOrFunc(MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(1)),
+                            MakeEqualsFunc(MakeInt(2), MakeColumn("abc", 0)));
+  FilterIR* filter = MakeFilter(src, or_func);
+  MakeMemSink(filter, "foo", {});
+
+  auto result = ResolveTypesAndApply();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_THAT(src->scan_predicates(), ElementsAre(EqualsProto(R"proto(
+    column_idx: 0
+    op: IN
+    in_values { data_type: INT64 int64_value: 1 }
+    in_values { data_type: INT64 int64_value: 2 }
+  )proto")));
+}
+
+TEST_F(ScanPredicatePushdownTest, filter_kept_when_partially_pushed) {
+  MemorySourceIR* src = MakeSource();
+  // abc == 2 and abc == xyz, only the first conjunct can be evaluated by the source.
+  auto and_func = MakeAndFunc(MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(2)),
+                              MakeEqualsFunc(MakeColumn("abc", 0), MakeColumn("xyz", 0)));
+  FilterIR* filter = MakeFilter(src, and_func);
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+
+  auto result = ResolveTypesAndApply();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_THAT(sink->parents(), ElementsAre(filter));
+  EXPECT_THAT(filter->parents(), ElementsAre(src));
+  EXPECT_THAT(src->scan_predicates(), ElementsAre(EqualsProto(R"proto(
+    column_idx: 0
+    op: EQUAL
+    value { data_type: INT64 int64_value: 2 }
+  )proto")));
+}
+
+TEST_F(ScanPredicatePushdownTest, source_with_multiple_children_no_op) {
+  MemorySourceIR* src = MakeSource();
+  FilterIR* filter = MakeFilter(src, MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(2)));
+  MemorySinkIR* sink = MakeMemSink(filter, "foo", {});
+  MakeMemSink(src, "bar", {});
+
+  auto result = ResolveTypesAndApply();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(sink->parents(), ElementsAre(filter));
+  EXPECT_TRUE(src->scan_predicates().empty());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
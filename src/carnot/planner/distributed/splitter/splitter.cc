@@ -458,6 +458,19 @@ StatusOr<std::unique_ptr<IR>> Splitter::CreateGRPCBridgePlan(
     const IR* logical_plan, const absl::flat_hash_map<int64_t, bool>& on_kelvin,
     const std::vector<int64_t>& sources) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> grpc_bridge_plan, logical_plan->Clone());
+  // The join strategy is picked before the bridges are inserted, while the cost model can still
+  // trace the join inputs back to their sources.
+  absl::flat_hash_set<int64_t> shuffle_join_ids;
+  if (support_shuffle_) {
+    for (IRNode* node : grpc_bridge_plan->FindNodesThatMatch(Join())) {
+      auto join = static_cast<JoinIR*>(node);
+      if (cost_model_ == nullptr ||
+          cost_model_->ChooseJoinStrategy(join) == JoinStrategy::kShuffle) {
+        shuffle_join_ids.insert(join->id());
+      }
+    }
+  }
+
   absl::flat_hash_map<OperatorIR*, std::vector<OperatorIR*>> edges_to_break =
       GetEdgesToBreak(grpc_bridge_plan.get(), on_kelvin, sources);
 
@@ -465,9 +478,97 @@ StatusOr<std::unique_ptr<IR>> Splitter::CreateGRPCBridgePlan(
   for (const auto& [parent, children] : edges_to_break) {
     PL_RETURN_IF_ERROR(InsertGRPCBridge(grpc_bridge_plan.get(), parent, children));
   }
+  if (support_shuffle_) {
+    PL_RETURN_IF_ERROR(InsertShuffleStages(grpc_bridge_plan.get(), shuffle_join_ids));
+  }
   return grpc_bridge_plan;
 }
 
+std::vector<GRPCSourceGroupIR*> Splitter::ShuffleableParents(OperatorIR* op) const {
+  std::vector<GRPCSourceGroupIR*> groups;
+  for (OperatorIR* parent : op->parents()) {
+    if (!Match(parent, GRPCSourceGroup()) || parent->Children().size() != 1) {
+      return {};
+    }
+    groups.push_back(static_cast<GRPCSourceGroupIR*>(parent));
+  }
+  return groups;
+}
+
+Status Splitter::InsertShuffleStage(OperatorIR* op, const std::vector<GRPCSourceGroupIR*>& parents,
+                                    const std::vector<std::vector<std::string>>& partition_columns,
+                                    const absl::flat_hash_map<int64_t, GRPCSinkIR*>& sinks) {
+  DCHECK_EQ(parents.size(), partition_columns.size());
+  std::vector<GRPCSinkIR*> parent_sinks;
+  for (GRPCSourceGroupIR* group : parents) {
+    auto sink_iter = sinks.find(group->source_id());
+    if (sink_iter == sinks.end()) {
+      return group->CreateIRNodeError("No GRPCSink found for '$0'", group->DebugString());
+    }
+    parent_sinks.push_back(sink_iter->second);
+  }
+  for (const auto& [i, group] : Enumerate(parents)) {
+    parent_sinks[i]->SetPartitionColumns(partition_columns[i]);
+    group->SetShuffled(true);
+  }
+
+  // Gather the partitions of the output back on one Kelvin.
+  std::vector<OperatorIR*> children = op->Children();
+  PL_ASSIGN_OR_RETURN(GRPCSinkIR * grpc_sink, CreateGRPCSink(op, grpc_id_counter_));
+  PL_ASSIGN_OR_RETURN(GRPCSourceGroupIR * grpc_source_group,
+                      CreateGRPCSourceGroup(op, grpc_id_counter_));
+  DCHECK_EQ(grpc_sink->destination_id(), grpc_source_group->source_id());
+  for (OperatorIR* child : children) {
+    PL_RETURN_IF_ERROR(child->ReplaceParent(op, grpc_source_group));
+  }
+  ++grpc_id_counter_;
+  return Status::OK();
+}
+
+Status Splitter::InsertShuffleStages(IR* plan,
+                                     const absl::flat_hash_set<int64_t>& shuffle_join_ids) {
+  absl::flat_hash_map<int64_t, GRPCSinkIR*> sinks;
+  for (IRNode* node : plan->FindNodesThatMatch(InternalGRPCSink())) {
+    auto sink = static_cast<GRPCSinkIR*>(node);
+    sinks[sink->destination_id()] = sink;
+  }
+
+  // Aggregates without groups have a single output row, so there's nothing to partition.
+  for (IRNode* node : plan->FindNodesThatMatch(BlockingAgg())) {
+    auto agg = static_cast<BlockingAggIR*>(node);
+    if (!agg->finalize_results() || agg->groups().empty()) {
+      continue;
+    }
+    std::vector<GRPCSourceGroupIR*> parents = ShuffleableParents(agg);
+    if (parents.empty()) {
+      continue;
+    }
+    std::vector<std::string> group_cols;
+    for (ColumnIR* group : agg->groups()) {
+      group_cols.push_back(group->col_name());
+    }
+    PL_RETURN_IF_ERROR(InsertShuffleStage(agg, parents, {group_cols}, sinks));
+  }
+
+  // Both sides of a join are partitioned on their join keys, in the same order, so that matching
+  // rows meet on the same Kelvin.
+  for (int64_t join_id : shuffle_join_ids) {
+    auto join = static_cast<JoinIR*>(plan->Get(join_id));
+    std::vector<GRPCSourceGroupIR*> parents = ShuffleableParents(join);
+    if (parents.size() != 2 || parents[0] == parents[1]) {
+      continue;
+    }
+    std::vector<std::vector<std::string>> partition_columns(2);
+    for (size_t i = 0; i < join->left_on_columns().size(); ++i) {
+      for (ColumnIR* col : {join->left_on_columns()[i], join->right_on_columns()[i]}) {
+        partition_columns[col->container_op_parent_idx()].push_back(col->col_name());
+      }
+    }
+    PL_RETURN_IF_ERROR(InsertShuffleStage(join, parents, partition_columns, sinks));
+  }
+  return Status::OK();
+}
+
 StatusOr<GRPCSinkIR*> Splitter::CreateGRPCSink(OperatorIR* parent_op, int64_t grpc_id) {
   DCHECK(parent_op->is_type_resolved()) << parent_op->DebugString();
   IR* graph = parent_op->graph();
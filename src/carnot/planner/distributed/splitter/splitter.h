@@ -26,6 +26,7 @@
 #include <absl/container/flat_hash_map.h>
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/compiler_state/registry_info.h"
+#include "src/carnot/planner/distributed/cost_model/cost_model.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/splitter/partial_op_mgr/partial_op_mgr.h"
 #include "src/carnot/planner/ir/grpc_sink_ir.h"
@@ -110,20 +111,32 @@ class Splitter : public NotCopyable {
    */
   StatusOr<std::unique_ptr<BlockingSplitPlan>> SplitKelvinAndAgents(const IR* logical_plan);
 
+  /**
+   * @param support_partial_agg whether aggregates can be split into partial aggregates.
+   * @param cost_model if set, only the aggregates that the cost model picks are split, and only the
+   * joins that it picks are shuffled.
+   * @param support_shuffle whether the grouped aggregates and joins that read directly from PEMs
+   * can be hash partitioned over several Kelvins.
+   */
   static StatusOr<std::unique_ptr<Splitter>> Create(CompilerState* compiler_state,
-                                                    bool support_partial_agg) {
+                                                    bool support_partial_agg,
+                                                    const CostModel* cost_model = nullptr,
+                                                    bool support_shuffle = false) {
     std::unique_ptr<Splitter> splitter = std::unique_ptr<Splitter>(new Splitter(compiler_state));
-    PL_RETURN_IF_ERROR(splitter->Init(support_partial_agg));
+    PL_RETURN_IF_ERROR(splitter->Init(support_partial_agg, cost_model, support_shuffle));
     return splitter;
   }
 
  private:
   explicit Splitter(CompilerState* compiler_state) : compiler_state_(compiler_state) {}
-  Status Init(bool support_partial_agg) {
+  Status Init(bool support_partial_agg, const CostModel* cost_model, bool support_shuffle) {
+    cost_model_ = cost_model;
+    support_shuffle_ = support_shuffle;
     if (support_partial_agg) {
-      partial_operator_mgrs_.push_back(std::make_unique<AggOperatorMgr>());
+      partial_operator_mgrs_.push_back(std::make_unique<AggOperatorMgr>(cost_model));
     }
     partial_operator_mgrs_.push_back(std::make_unique<LimitOperatorMgr>());
+    partial_operator_mgrs_.push_back(std::make_unique<TopKOperatorMgr>());
     return Status::OK();
   }
   /**
@@ -310,7 +323,38 @@ class Splitter : public NotCopyable {
    */
   bool AllHavePartialMgr(std::vector<OperatorIR*> children) const;
 
+  /**
+   * @brief Turns the blocking operators that read all of their input from GRPCBridges into shuffle
+   * stages, which can run on several Kelvins at once. The GRPCSinks that feed the operator are
+   * partitioned on its group or join keys, and a new GRPCBridge gathers the output of the operator
+   * back on a single Kelvin:
+   *
+   * GRPCSink(1, partition=[key])
+   *
+   * GRPCSourceGroup(1, shuffled)
+   *  |
+   * Agg(by=key)
+   *  |
+   * GRPCSink(2)
+   *
+   * GRPCSourceGroup(2)
+   *  |
+   * Sink
+   *
+   * @param plan the plan, after the GRPCBridges are inserted.
+   * @param shuffle_join_ids the ids of the joins that the cost model picked for a shuffle.
+   */
+  Status InsertShuffleStages(IR* plan, const absl::flat_hash_set<int64_t>& shuffle_join_ids);
+  // Returns the GRPCSourceGroup parents of op, or an empty vector if any parent is not a
+  // GRPCSourceGroup that feeds only op.
+  std::vector<GRPCSourceGroupIR*> ShuffleableParents(OperatorIR* op) const;
+  Status InsertShuffleStage(OperatorIR* op, const std::vector<GRPCSourceGroupIR*>& parents,
+                            const std::vector<std::vector<std::string>>& partition_columns,
+                            const absl::flat_hash_map<int64_t, GRPCSinkIR*>& sinks);
+
   int64_t grpc_id_counter_ = 0;
+  const CostModel* cost_model_ = nullptr;
+  bool support_shuffle_ = false;
   std::vector<std::unique_ptr<PartialOperatorMgr>> partial_operator_mgrs_;
   CompilerState* compiler_state_ = nullptr;
 };
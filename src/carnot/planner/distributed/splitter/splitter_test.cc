@@ -195,6 +195,103 @@ TEST_F(SplitterTest, partial_agg_test) {
   }
 }
 
+TEST_F(SplitterTest, shuffle_partial_agg_test) {
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  auto count_col = MakeColumn("count", 0, types::DataType::INT64);
+  EXPECT_OK(count_col->SetResolvedType(ValueType::Create(types::INT64, types::ST_NONE)));
+  auto mean_func = MakeMeanFuncWithFloatType(MakeColumn("count", 0, types::DataType::INT64));
+  ASSERT_OK(AddUDAToRegistry("mean", types::FLOAT64, {types::INT64}, /*supports_partial*/ true));
+  auto agg = MakeBlockingAgg(mem_src, {count_col}, {{"mean", mean_func}});
+  auto mem_sink = MakeMemSink(agg, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  auto splitter_or_s = Splitter::Create(compiler_state_.get(), /* perform_partial_agg */ true,
+                                        /* cost_model */ nullptr, /* support_shuffle */ true);
+  ASSERT_OK(splitter_or_s);
+  std::unique_ptr<Splitter> splitter = splitter_or_s.ConsumeValueOrDie();
+  std::unique_ptr<BlockingSplitPlan> split_plan =
+      splitter->SplitKelvinAndAgents(graph.get()).ConsumeValueOrDie();
+
+  auto before_blocking = split_plan->before_blocking.get();
+  auto after_blocking = split_plan->after_blocking.get();
+
+  // The partial aggregates are partitioned on the group column.
+  MemorySourceIR* new_mem_src = GetEquivalentInNewPlan(before_blocking, mem_src);
+  ASSERT_EQ(new_mem_src->Children().size(), 1UL);
+  auto partial_agg = new_mem_src->Children()[0];
+  ASSERT_MATCH(partial_agg, PartialAgg());
+  ASSERT_EQ(partial_agg->Children().size(), 1UL);
+  ASSERT_MATCH(partial_agg->Children()[0], GRPCSink());
+  auto shuffle_sink = static_cast<GRPCSinkIR*>(partial_agg->Children()[0]);
+  EXPECT_TRUE(shuffle_sink->is_shuffle());
+  EXPECT_THAT(shuffle_sink->partition_columns(), ElementsAre("count"));
+
+  // The finalize aggregate reads the partitions, and its output is gathered before the sink.
+  auto new_mem_sink = GetEquivalentInNewPlan(after_blocking, mem_sink);
+  ASSERT_EQ(new_mem_sink->parents().size(), 1UL);
+  ASSERT_MATCH(new_mem_sink->parents()[0], GRPCSourceGroup());
+  auto gather_source = static_cast<GRPCSourceGroupIR*>(new_mem_sink->parents()[0]);
+  EXPECT_FALSE(gather_source->shuffled());
+
+  GRPCSourceGroupIR* shuffle_source = nullptr;
+  for (IRNode* node : after_blocking->FindNodesThatMatch(GRPCSourceGroup())) {
+    if (node != gather_source) {
+      shuffle_source = static_cast<GRPCSourceGroupIR*>(node);
+    }
+  }
+  ASSERT_NE(shuffle_source, nullptr);
+  EXPECT_TRUE(shuffle_source->shuffled());
+  EXPECT_EQ(shuffle_sink->destination_id(), shuffle_source->source_id());
+  ASSERT_EQ(shuffle_source->Children().size(), 1UL);
+  auto finalize_agg = shuffle_source->Children()[0];
+  ASSERT_MATCH(finalize_agg, FinalizeAgg());
+  ASSERT_EQ(finalize_agg->Children().size(), 1UL);
+  ASSERT_MATCH(finalize_agg->Children()[0], GRPCSink());
+  auto gather_sink = static_cast<GRPCSinkIR*>(finalize_agg->Children()[0]);
+  EXPECT_FALSE(gather_sink->is_shuffle());
+  EXPECT_EQ(gather_sink->destination_id(), gather_source->source_id());
+}
+
+TEST_F(SplitterTest, shuffle_join_test) {
+  auto mem_src1 = MakeMemSource("cpu", cpu_relation);
+  auto mem_src2 = MakeMemSource("cpu", cpu_relation);
+  auto join = MakeJoin({mem_src1, mem_src2}, "inner", cpu_relation, cpu_relation, {"count"},
+                       {"count"}, {"", "_right"});
+  MakeMemSink(join, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  auto splitter_or_s = Splitter::Create(compiler_state_.get(), /* perform_partial_agg */ false,
+                                        /* cost_model */ nullptr, /* support_shuffle */ true);
+  ASSERT_OK(splitter_or_s);
+  std::unique_ptr<Splitter> splitter = splitter_or_s.ConsumeValueOrDie();
+  std::unique_ptr<BlockingSplitPlan> split_plan =
+      splitter->SplitKelvinAndAgents(graph.get()).ConsumeValueOrDie();
+
+  auto before_blocking = split_plan->before_blocking.get();
+  auto after_blocking = split_plan->after_blocking.get();
+
+  // Both sides of the join are partitioned on the join key.
+  for (MemorySourceIR* mem_src : {mem_src1, mem_src2}) {
+    auto children = GetEquivalentInNewPlan(before_blocking, mem_src)->Children();
+    ASSERT_EQ(children.size(), 1UL);
+    ASSERT_MATCH(children[0], GRPCSink());
+    EXPECT_THAT(static_cast<GRPCSinkIR*>(children[0])->partition_columns(), ElementsAre("count"));
+  }
+
+  auto new_join = GetEquivalentInNewPlan(after_blocking, join);
+  ASSERT_EQ(new_join->parents().size(), 2UL);
+  for (OperatorIR* parent : new_join->parents()) {
+    ASSERT_MATCH(parent, GRPCSourceGroup());
+    EXPECT_TRUE(static_cast<GRPCSourceGroupIR*>(parent)->shuffled());
+  }
+  ASSERT_EQ(new_join->Children().size(), 1UL);
+  EXPECT_MATCH(new_join->Children()[0], GRPCSink());
+}
+
 TEST_F(SplitterTest, limit_test) {
   auto mem_src = MakeMemSource("cpu", cpu_relation);
   auto limit = MakeLimit(mem_src, 10);
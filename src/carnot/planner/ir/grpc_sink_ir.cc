@@ -18,6 +18,8 @@
 
 #include "src/carnot/planner/ir/grpc_sink_ir.h"
 
+#include <algorithm>
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -31,6 +33,7 @@ Status GRPCSinkIR::CopyFromNodeImpl(const IRNode* node,
   destination_ssl_targetname_ = grpc_sink->destination_ssl_targetname_;
   name_ = grpc_sink->name_;
   out_columns_ = grpc_sink->out_columns_;
+  partition_columns_ = grpc_sink->partition_columns_;
   return Status::OK();
 }
 
@@ -56,6 +59,9 @@ Status GRPCSinkIR::ToProto(planpb::Operator* op) const {
 Status GRPCSinkIR::ToProto(planpb::Operator* op, int64_t agent_id) const {
   auto pb = op->mutable_grpc_sink_op();
   op->set_op_type(planpb::GRPC_SINK_OPERATOR);
+  if (is_shuffle()) {
+    return ShuffleToProto(pb, agent_id);
+  }
   pb->set_address(destination_address());
   pb->mutable_connection_options()->set_ssl_targetname(destination_ssl_targetname());
   if (!agent_id_to_destination_id_.contains(agent_id)) {
@@ -65,6 +71,32 @@ Status GRPCSinkIR::ToProto(planpb::Operator* op, int64_t agent_id) const {
   return Status::OK();
 }
 
+Status GRPCSinkIR::ShuffleToProto(planpb::GRPCSinkOperator* pb, int64_t agent_id) const {
+  auto dests_iter = agent_id_to_shuffle_destinations_.find(agent_id);
+  if (dests_iter == agent_id_to_shuffle_destinations_.end()) {
+    return CreateIRNodeError("No agent ID '$0' found in shuffle grpc sink '$1'", agent_id,
+                             DebugString());
+  }
+  for (const auto& dest : dests_iter->second) {
+    auto dest_pb = pb->add_shuffle_destinations();
+    dest_pb->set_address(dest.address);
+    dest_pb->set_grpc_source_id(dest.destination_id);
+    dest_pb->mutable_connection_options()->set_ssl_targetname(dest.ssl_targetname);
+  }
+
+  DCHECK(is_type_resolved());
+  std::vector<std::string> col_names = resolved_table_type()->ColumnNames();
+  for (const auto& col_name : partition_columns_) {
+    auto col_iter = std::find(col_names.begin(), col_names.end(), col_name);
+    if (col_iter == col_names.end()) {
+      return CreateIRNodeError("Partition column '$0' not found in grpc sink '$1'", col_name,
+                               DebugString());
+    }
+    pb->add_partition_column_idxs(col_iter - col_names.begin());
+  }
+  return Status::OK();
+}
+
 Status GRPCSinkIR::ResolveType(CompilerState* /* compiler_state */) {
   DCHECK_EQ(1, parent_types().size());
   // When out_columns_ is empty, the GRPCSink just copies the parent type.
@@ -138,6 +138,27 @@ class GRPCSinkIR : public OperatorIR {
     return agent_id_to_destination_id_;
   }
 
+  /**
+   * @brief Makes this a shuffle sink, which hash partitions its rows on the partition columns and
+   * sends each partition to a different Kelvin, instead of sending all rows to one destination.
+   */
+  void SetPartitionColumns(const std::vector<std::string>& partition_columns) {
+    partition_columns_ = partition_columns;
+  }
+  const std::vector<std::string>& partition_columns() const { return partition_columns_; }
+  bool is_shuffle() const { return !partition_columns_.empty(); }
+
+  /**
+   * @brief Adds a destination of the shuffle sink on the agent. Every agent must add the
+   * destinations of the Kelvins in the same order, so that they agree on which Kelvin gets which
+   * partition.
+   */
+  void AddShuffleDestination(int64_t agent_id, int64_t destination_id, const std::string& address,
+                             const std::string& ssl_targetname) {
+    agent_id_to_shuffle_destinations_[agent_id].push_back(
+        {destination_id, address, ssl_targetname});
+  }
+
  protected:
   Status CopyFromNodeImpl(const IRNode* node,
                           absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
@@ -147,6 +168,8 @@ class GRPCSinkIR : public OperatorIR {
   }
 
  private:
+  Status ShuffleToProto(planpb::GRPCSinkOperator* pb, int64_t agent_id) const;
+
   std::string destination_address_ = "";
   std::string destination_ssl_targetname_ = "";
   GRPCSinkType sink_type_ = GRPCSinkType::kTypeNotSet;
@@ -156,6 +179,15 @@ class GRPCSinkIR : public OperatorIR {
   std::string name_;
   std::vector<std::string> out_columns_;
   absl::flat_hash_map<int64_t, int64_t> agent_id_to_destination_id_;
+
+  struct ShuffleDestination {
+    int64_t destination_id;
+    std::string address;
+    std::string ssl_targetname;
+  };
+  // Used when the sink is a shuffle sink.
+  std::vector<std::string> partition_columns_;
+  absl::flat_hash_map<int64_t, std::vector<ShuffleDestination>> agent_id_to_shuffle_destinations_;
 };
 
 }  // namespace planner
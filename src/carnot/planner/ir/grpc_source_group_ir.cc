@@ -27,6 +27,7 @@ Status GRPCSourceGroupIR::CopyFromNodeImpl(const IRNode* node,
   const GRPCSourceGroupIR* grpc_source_group = static_cast<const GRPCSourceGroupIR*>(node);
   source_id_ = grpc_source_group->source_id_;
   grpc_address_ = grpc_source_group->grpc_address_;
+  shuffled_ = grpc_source_group->shuffled_;
   if (grpc_source_group->dependent_sinks_.size()) {
     return error::Unimplemented("Cannot clone GRPCSourceGroupIR with dependent_sinks_");
   }
@@ -58,8 +59,12 @@ Status GRPCSourceGroupIR::AddGRPCSink(GRPCSinkIR* sink_op,
     return DExitOrIRNodeError("$0 doesn't have a physical agent associated with it.",
                               DebugString());
   }
-  sink_op->SetDestinationAddress(grpc_address_);
-  sink_op->SetDestinationSSLTargetName(ssl_targetname_);
+  // Shuffle sinks send to several source groups, so their destinations are set per source when the
+  // group is converted into GRPCSources.
+  if (!sink_op->is_shuffle()) {
+    sink_op->SetDestinationAddress(grpc_address_);
+    sink_op->SetDestinationSSLTargetName(ssl_targetname_);
+  }
   dependent_sinks_.emplace_back(sink_op, agents);
   return Status::OK();
 }
@@ -73,6 +73,11 @@ class GRPCSourceGroupIR : public OperatorIR {
   Status AddGRPCSink(GRPCSinkIR* sink_op, const absl::flat_hash_set<int64_t>& agents);
   bool GRPCAddressSet() const { return grpc_address_ != ""; }
   const std::string& grpc_address() const { return grpc_address_; }
+  const std::string& ssl_targetname() const { return ssl_targetname_; }
+  // Shuffled source groups receive one hash partition of the rows of their shuffle sinks, see
+  // GRPCSinkIR::SetPartitionColumns. The operators that read them can run on several Kelvins.
+  void SetShuffled(bool shuffled) { shuffled_ = shuffled; }
+  bool shuffled() const { return shuffled_; }
   int64_t source_id() const { return source_id_; }
   const std::vector<std::pair<GRPCSinkIR*, absl::flat_hash_set<int64_t>>>& dependent_sinks() {
     return dependent_sinks_;
@@ -99,6 +104,7 @@ class GRPCSourceGroupIR : public OperatorIR {
   int64_t source_id_ = -1;
   std::string grpc_address_ = "";
   std::string ssl_targetname_ = "";
+  bool shuffled_ = false;
   std::vector<std::pair<GRPCSinkIR*, absl::flat_hash_set<int64_t>>> dependent_sinks_;
 };
 }  // namespace planner
@@ -1530,6 +1530,35 @@ TEST_F(ToProtoTests, full_outer) {
   EXPECT_THAT(pb, EqualsProto(absl::Substitute(kExpectedJoinOpPb, "FULL_OUTER")));
 }
 
+TEST_F(ToProtoTests, join_on_time_sorted_inputs) {
+  Relation relation0({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "col1"});
+  auto mem_src1 = MakeMemSource("source0", relation0);
+  compiler_state_->relation_map()->emplace("source0", relation0);
+
+  Relation relation1({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "col2"});
+  auto mem_src2 = MakeMemSource("source1", relation1);
+  compiler_state_->relation_map()->emplace("source1", relation1);
+  auto limit = MakeLimit(mem_src2, 10);
+
+  auto sorted_join = MakeJoin({mem_src1, limit}, "inner", relation0, relation1,
+                              std::vector<std::string>{"time_", "col1"},
+                              std::vector<std::string>{"time_", "col2"}, {"", "_right"});
+  auto unsorted_join = MakeJoin({mem_src1, mem_src2}, "inner", relation0, relation1,
+                                std::vector<std::string>{"col1", "time_"},
+                                std::vector<std::string>{"col2", "time_"}, {"", "_right"});
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  planpb::Operator pb;
+  EXPECT_OK(sorted_join->ToProto(&pb));
+  EXPECT_TRUE(pb.join_op().inputs_sorted_by_key());
+
+  pb.Clear();
+  EXPECT_OK(unsorted_join->ToProto(&pb));
+  EXPECT_FALSE(pb.join_op().inputs_sorted_by_key());
+}
+
 TEST_F(ToProtoTests, join_wrong_join_type) {
   Relation relation0({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64,
                       types::DataType::INT64},
@@ -21,6 +21,8 @@
 #include "src/carnot/planner/ir/column_ir.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/join_ir.h"
+#include "src/carnot/planner/ir/map_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
 
 namespace px {
 namespace carnot {
@@ -75,6 +77,34 @@ StatusOr<JoinIR::JoinType> JoinIR::GetJoinEnum(const std::string& join_type_str)
   return iter->second;
 }
 
+namespace {
+// Returns whether op emits its rows sorted by the column col_name. MemorySources emit their rows
+// sorted by time_, and Filters, Limits and the columns that Maps pass through keep that order.
+bool IsSortedByColumn(OperatorIR* op, const std::string& col_name) {
+  switch (op->type()) {
+    case IRNodeType::kMemorySource:
+      return col_name == "time_" && !static_cast<MemorySourceIR*>(op)->streaming();
+    case IRNodeType::kFilter:
+    case IRNodeType::kLimit:
+      return IsSortedByColumn(op->parents()[0], col_name);
+    case IRNodeType::kMap:
+      for (const auto& col_expr : static_cast<MapIR*>(op)->col_exprs()) {
+        if (col_expr.name != col_name) {
+          continue;
+        }
+        if (col_expr.node->type() != IRNodeType::kColumn) {
+          return false;
+        }
+        return IsSortedByColumn(op->parents()[0],
+                                static_cast<ColumnIR*>(col_expr.node)->col_name());
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
 planpb::JoinOperator::JoinType JoinIR::GetPbJoinEnum(JoinType join_type) {
   absl::flat_hash_map<JoinType, planpb::JoinOperator::JoinType> join_key_mapping = {
       {JoinType::kInner, planpb::JoinOperator_JoinType_INNER},
@@ -112,6 +142,11 @@ Status JoinIR::ToProto(planpb::Operator* op) const {
   for (const auto& col_name : column_names_) {
     *(pb->add_column_names()) = col_name;
   }
+  if (!left_on_columns_.empty() &&
+      IsSortedByColumn(parents()[0], left_on_columns_[0]->col_name()) &&
+      IsSortedByColumn(parents()[1], right_on_columns_[0]->col_name())) {
+    pb->set_inputs_sorted_by_key(true);
+  }
   // NOTE: not setting value as this is set in the execution engine. Keeping this here in case it
   // needs to be modified in the future.
   // pb->set_rows_per_batch(1024);
@@ -60,6 +60,10 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
     pb->set_tablet(tablet_value());
   }
 
+  for (const auto& pred : scan_predicates_) {
+    *pb->add_predicates() = pred;
+  }
+
   pb->set_streaming(streaming());
   return Status::OK();
 }
@@ -104,6 +108,7 @@ Status MemorySourceIR::CopyFromNodeImpl(const IRNode* node,
   column_index_map_set_ = source_ir->column_index_map_set_;
   column_index_map_ = source_ir->column_index_map_;
   streaming_ = source_ir->streaming_;
+  scan_predicates_ = source_ir->scan_predicates_;
 
   return Status::OK();
 }
@@ -27,6 +27,7 @@
 #include "src/carnot/planner/ir/expression_ir.h"
 #include "src/carnot/planner/ir/operator_ir.h"
 #include "src/carnot/planner/types/types.h"
+#include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udfspb/udfs.pb.h"
 #include "src/common/base/base.h"
 #include "src/shared/types/column_wrapper.h"
@@ -86,6 +87,13 @@ class MemorySourceIR : public OperatorIR {
     column_index_map_ = column_index_map;
   }
 
+  /**
+   * @brief Scan predicates are evaluated by the memory source as it reads the table, so that
+   * only rows matching all of them are returned.
+   */
+  const std::vector<planpb::ScanPredicate>& scan_predicates() const { return scan_predicates_; }
+  void AddScanPredicate(const planpb::ScanPredicate& pred) { scan_predicates_.push_back(pred); }
+
   Status ToProto(planpb::Operator*) const override;
 
   bool select_all() const { return column_names_.size() == 0; }
@@ -135,6 +143,9 @@ class MemorySourceIR : public OperatorIR {
 
   types::TabletID tablet_value_;
   bool has_tablet_value_ = false;
+
+  // Predicates on the table's columns, see scan_predicates().
+  std::vector<planpb::ScanPredicate> scan_predicates_;
 };
 
 }  // namespace planner
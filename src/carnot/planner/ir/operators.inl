@@ -25,6 +25,7 @@ PL_IR_NODE(Drop)
 PL_IR_NODE(BlockingAgg)
 PL_IR_NODE(Filter)
 PL_IR_NODE(Limit)
+PL_IR_NODE(TopK)
 PL_IR_NODE(GRPCSourceGroup)
 PL_IR_NODE(GRPCSource)
 PL_IR_NODE(GRPCSink)
@@ -279,6 +279,34 @@ StatusOr<QLObjectPtr> LimitHandler(CompilerState* compiler_state, IR* graph, Ope
   return Dataframe::Create(compiler_state, limit_op, visitor);
 }
 
+// Handles the sort() DataFrame logic.
+StatusOr<QLObjectPtr> SortHandler(CompilerState* compiler_state, IR* graph, OperatorIR* op,
+                                  const pypa::AstPtr& ast, const ParsedArgs& args,
+                                  ASTVisitor* visitor) {
+  PL_ASSIGN_OR_RETURN(std::vector<std::string> sort_cols,
+                      ParseAsListOfStrings(args.GetArg("by"), "by"));
+  if (sort_cols.empty()) {
+    return CreateAstError(ast, "'by' must contain at least one column");
+  }
+  PL_ASSIGN_OR_RETURN(std::vector<BoolIR*> ascending_irs,
+                      ParseAsListOf<BoolIR>(args.GetArg("ascending"), "ascending"));
+  // A single direction applies to every sort column.
+  if (ascending_irs.size() == 1) {
+    ascending_irs.resize(sort_cols.size(), ascending_irs[0]);
+  }
+  if (ascending_irs.size() != sort_cols.size()) {
+    return CreateAstError(ast, "'ascending' has $0 elements, expected 1 or $1",
+                          ascending_irs.size(), sort_cols.size());
+  }
+  std::vector<bool> ascending;
+  for (BoolIR* ascending_ir : ascending_irs) {
+    ascending.push_back(ascending_ir->val());
+  }
+
+  PL_ASSIGN_OR_RETURN(TopKIR * topk_op, graph->CreateNode<TopKIR>(ast, op, sort_cols, ascending));
+  return Dataframe::Create(compiler_state, topk_op, visitor);
+}
+
 class SubscriptHandler {
  public:
   /**
@@ -527,6 +555,23 @@ Status Dataframe::Init() {
   PL_RETURN_IF_ERROR(limitfn->SetDocString(kLimitOpDocstring));
   AddMethod(kLimitOpID, limitfn);
 
+  /**
+   * # Equivalent to the python method method syntax:
+   * def sort(self, by, ascending=True):
+   *     ...
+   */
+  PL_ASSIGN_OR_RETURN(
+      std::shared_ptr<FuncObject> sortfn,
+      FuncObject::Create(
+          kSortOpID, {"by", "ascending"}, {{"ascending", "True"}},
+          /* has_variable_len_args */ false,
+          /* has_variable_len_kwargs */ false,
+          std::bind(&SortHandler, compiler_state_, graph(), op(), std::placeholders::_1,
+                    std::placeholders::_2, std::placeholders::_3),
+          ast_visitor()));
+  PL_RETURN_IF_ERROR(sortfn->SetDocString(kSortOpDocstring));
+  AddMethod(kSortOpID, sortfn);
+
   /**
    *
    * # Equivalent to the python method method syntax:
@@ -277,6 +277,31 @@ class Dataframe : public QLObject {
     px.DataFrame: DataFrame with the first n rows.
   )doc";
 
+  inline static constexpr char kSortOpID[] = "sort";
+  inline static constexpr char kSortOpDocstring[] = R"doc(
+  Sorts the DataFrame by the specified columns.
+
+  Returns a DataFrame sorted by the values of the `by` columns, the first column
+  taking precedence. Sorting is blocking, so it's best combined with `head()`, which
+  only keeps the top rows of the sort instead of the entire DataFrame.
+
+  :topic: dataframe_ops
+  :opname: Sort
+
+  Examples:
+    df = px.DataFrame('http_events', select=['req_path', 'latency'])
+    # Keep the 10 slowest requests.
+    df = df.sort('latency', ascending=False).head(10)
+
+  Args:
+    by (Union[str,List[str]]): The columns to sort by, either as a string or a list.
+    ascending (Union[bool,List[bool]]): Whether to sort in ascending order, either one
+      value for all columns or one per column. If not set, default is True.
+
+  Returns:
+    px.DataFrame: DataFrame sorted by the specified columns.
+  )doc";
+
   inline static constexpr char kMergeOpID[] = "merge";
   inline static constexpr char kMergeOpDocstring[] = R"doc(
   Merges the input DataFrame with this one using a database-style join.
@@ -234,6 +234,32 @@ TEST_F(DataframeTest, LimitNonIntArgument) {
               HasCompilerError("Expected arg 'n' as type 'Int', received 'String'"));
 }
 
+TEST_F(DataframeTest, CreateSort) {
+  ASSERT_OK(ParseScript(var_table, "sorted = df.sort(['foo', 'bar'], ascending=[False, True])"));
+  auto var = var_table->Lookup("sorted");
+  ASSERT_EQ(var->type_descriptor().type(), QLObjectType::kDataframe);
+  auto sort_obj = std::static_pointer_cast<Dataframe>(var);
+
+  ASSERT_MATCH(sort_obj->op(), TopK());
+  TopKIR* topk = static_cast<TopKIR*>(sort_obj->op());
+  EXPECT_EQ(topk->sort_cols(), std::vector<std::string>({"foo", "bar"}));
+  EXPECT_EQ(topk->ascending(), std::vector<bool>({false, true}));
+  EXPECT_FALSE(topk->limit_value_set());
+}
+
+TEST_F(DataframeTest, SortDefaultsToAscending) {
+  ASSERT_OK(ParseScript(var_table, "sorted = df.sort(['foo', 'bar'])"));
+  auto sort_obj = std::static_pointer_cast<Dataframe>(var_table->Lookup("sorted"));
+  ASSERT_MATCH(sort_obj->op(), TopK());
+  TopKIR* topk = static_cast<TopKIR*>(sort_obj->op());
+  EXPECT_EQ(topk->ascending(), std::vector<bool>({true, true}));
+}
+
+TEST_F(DataframeTest, SortMismatchedAscending) {
+  EXPECT_THAT(ParseScript(var_table, "df.sort(['foo', 'bar'], ascending=[True, False, True])"),
+              HasCompilerError("'ascending' has 3 elements, expected 1 or 2"));
+}
+
 TEST_F(DataframeTest, SubscriptFilterRows) {
   ASSERT_OK(ParseScript(var_table, "filter = df[df.service == 'blah']"));
   auto var = var_table->Lookup("filter");
@@ -335,6 +335,28 @@ columns {
   index: 2
 }
 )";
+
+constexpr char kTopKOperator1[] = R"(
+limit: 3
+columns {
+  node: 1
+  index: 0
+}
+columns {
+  node: 1
+  index: 2
+}
+sort_columns {
+  node: 1
+  index: 1
+}
+sort_columns {
+  node: 1
+  index: 0
+}
+ascending: false
+ascending: true
+)";
 // relation 1: [abc, time_]
 // relation 2: [time_, abc]
 // maps to output relation:
@@ -833,6 +855,278 @@ constexpr char kLinearPlanFragment[] = R"(
   }
 )";
 
+// numbers -> filter(b) -> map(add(a, c)) -> blocking sum -> output
+constexpr char kFilterMapAggPlanFragment[] = R"(
+  id: 1,
+  dag {
+    nodes {
+      id: 1
+      sorted_children: 2
+    }
+    nodes {
+      id: 2
+      sorted_children: 3
+      sorted_parents: 1
+    }
+    nodes {
+      id: 3
+      sorted_children: 4
+      sorted_parents: 2
+    }
+    nodes {
+      id: 4
+      sorted_children: 5
+      sorted_parents: 3
+    }
+    nodes {
+      id: 5
+      sorted_parents: 4
+    }
+  }
+  nodes {
+    id: 1
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "numbers"
+        column_idxs: 0
+        column_types: INT64
+        column_names: "a"
+        column_idxs: 1
+        column_types: BOOLEAN
+        column_names: "b"
+        column_idxs: 2
+        column_types: FLOAT64
+        column_names: "c"
+      }
+    }
+  }
+  nodes {
+    id: 2
+    op {
+      op_type: FILTER_OPERATOR
+      filter_op {
+        expression {
+          column {
+            node: 1
+            index: 1
+          }
+        }
+        columns {
+          node: 1
+          index: 0
+        }
+        columns {
+          node: 1
+          index: 2
+        }
+      }
+    }
+  }
+  nodes {
+    id: 3
+    op {
+      op_type: MAP_OPERATOR
+      map_op {
+        expressions {
+          func {
+            name: "add"
+            id: 0
+            args {
+              column {
+                node: 2
+                index: 0
+              }
+            }
+            args {
+              column {
+                node: 2
+                index: 1
+              }
+            }
+            args_data_types: INT64
+            args_data_types: FLOAT64
+          }
+        }
+        column_names: "summed"
+      }
+    }
+  }
+  nodes {
+    id: 4
+    op {
+      op_type: AGGREGATE_OPERATOR
+      agg_op {
+        windowed: false
+        values {
+          name: "sum"
+          id: 2
+          args {
+            column {
+              node: 3
+              index: 0
+            }
+          }
+          args_data_types: FLOAT64
+        }
+        value_names: "total"
+      }
+    }
+  }
+  nodes {
+    id: 5
+    op {
+      op_type: MEMORY_SINK_OPERATOR
+      mem_sink_op {
+        name: "output"
+        column_types: FLOAT64
+        column_names: "total"
+      }
+    }
+  }
+)";
+
+// left -> filter(keep) -> sort-merge join on time_ -> output, with right -> filter(keep) as its
+// other input
+constexpr char kSortedFilterJoinPlanFragment[] = R"(
+  id: 1,
+  dag {
+    nodes {
+      id: 1
+      sorted_children: 2
+    }
+    nodes {
+      id: 2
+      sorted_children: 5
+      sorted_parents: 1
+    }
+    nodes {
+      id: 3
+      sorted_children: 4
+    }
+    nodes {
+      id: 4
+      sorted_children: 5
+      sorted_parents: 3
+    }
+    nodes {
+      id: 5
+      sorted_children: 6
+      sorted_parents: 2
+      sorted_parents: 4
+    }
+    nodes {
+      id: 6
+      sorted_parents: 5
+    }
+  }
+  nodes {
+    id: 1
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "left"
+        column_idxs: 0
+        column_types: TIME64NS
+        column_names: "time_"
+        column_idxs: 1
+        column_types: BOOLEAN
+        column_names: "keep"
+      }
+    }
+  }
+  nodes {
+    id: 2
+    op {
+      op_type: FILTER_OPERATOR
+      filter_op {
+        expression {
+          column {
+            node: 1
+            index: 1
+          }
+        }
+        columns {
+          node: 1
+          index: 0
+        }
+        columns {
+          node: 1
+          index: 1
+        }
+      }
+    }
+  }
+  nodes {
+    id: 3
+    op {
+      op_type: MEMORY_SOURCE_OPERATOR
+      mem_source_op {
+        name: "right"
+        column_idxs: 0
+        column_types: TIME64NS
+        column_names: "time_"
+        column_idxs: 1
+        column_types: BOOLEAN
+        column_names: "keep"
+      }
+    }
+  }
+  nodes {
+    id: 4
+    op {
+      op_type: FILTER_OPERATOR
+      filter_op {
+        expression {
+          column {
+            node: 3
+            index: 1
+          }
+        }
+        columns {
+          node: 3
+          index: 0
+        }
+        columns {
+          node: 3
+          index: 1
+        }
+      }
+    }
+  }
+  nodes {
+    id: 5
+    op {
+      op_type: JOIN_OPERATOR
+      join_op {
+        type: INNER
+        equality_conditions {
+          left_column_index: 0
+          right_column_index: 0
+        }
+        output_columns {
+          parent_index: 0
+          column_index: 0
+        }
+        column_names: "t"
+        rows_per_batch: 1024
+        inputs_sorted_by_key: true
+      }
+    }
+  }
+  nodes {
+    id: 6
+    op {
+      op_type: MEMORY_SINK_OPERATOR
+      mem_sink_op {
+        name: "output"
+        column_types: TIME64NS
+        column_names: "t"
+      }
+    }
+  }
+)";
+
 constexpr char kPlanWithFiveNodes[] = R"(
   dag {
     nodes {
@@ -1478,6 +1772,13 @@ planpb::Operator CreateTestDropLimit1PB() {
   return op;
 }
 
+planpb::Operator CreateTestTopK1PB() {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "TOPK_OPERATOR", "topk_op", kTopKOperator1);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  return op;
+}
+
 planpb::Operator CreateTestJoinWithTimePB() {
   planpb::Operator op;
   auto op_proto = absl::Substitute(kOperatorProtoTmpl, "JOIN_OPERATOR", "join_op", kJoinOperator1);
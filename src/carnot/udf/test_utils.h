@@ -24,6 +24,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -91,6 +92,9 @@ class UDFTester {
   template <typename... Args>
   UDFTester& ForInput(Args... args) {
     res_ = udf_.Exec(function_ctx_.get(), args...);
+    if constexpr (ScalarUDFTraits<TUDF>::HasExecBatch()) {
+      ExpectExecBatchMatches(std::index_sequence_for<Args...>{}, args...);
+    }
 
     return *this;
   }
@@ -108,6 +112,17 @@ class UDFTester {
   typename types::DataTypeTraits<udf_data_type>::value_type Result() { return res_; }
 
  private:
+  // Checks that the ExecBatch function of the UDF gives the same result as Exec.
+  template <typename... Args, std::size_t... I>
+  void ExpectExecBatchMatches(std::index_sequence<I...>, Args... args) {
+    std::tuple<typename types::DataTypeTraits<
+        ScalarUDFTraits<TUDF>::ExecArguments()[I]>::value_type...>
+        batch_args(args...);
+    typename types::DataTypeTraits<udf_data_type>::value_type batch_res;
+    TUDF::ExecBatch(function_ctx_.get(), 1, &std::get<I>(batch_args)..., &batch_res);
+    internal::ExpectEquality(batch_res, res_);
+  }
+
   TUDF udf_;
   std::unique_ptr<udf::FunctionContext> function_ctx_ = nullptr;
   typename types::DataTypeTraits<udf_data_type>::value_type res_;
@@ -74,6 +74,13 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * It can also _optionally_ implement a batch version of Exec:
+ *      static void ExecBatch(FunctionContext *ctx, size_t count, const UDFValue*... values,
+ *                            UDFValue* out) {}
+ *  When present, this function is called instead of Exec when a whole column is evaluated. Each
+ *  argument points to `count` contiguous values, and `out` to `count` values to be filled in. It
+ *  must give the same results as calling Exec on each row.
  */
 class ScalarUDF : public AnyUDF {
  public:
@@ -117,6 +124,13 @@ struct has_udf_init_fn<T, std::void_t<decltype(&T::Init)>> : std::true_type {
       "If an init function exists, it must have the form: Status Init(FunctionContext*, ...)");
 };
 
+// SFINAE test for batch exec fn.
+template <typename T, typename = void>
+struct has_udf_exec_batch_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_exec_batch_fn<T, std::void_t<decltype(&T::ExecBatch)>> : std::true_type {};
+
 /**
  * Checks to see if a valid looking Init Function exists.
  */
@@ -228,6 +242,12 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Checks if the UDF has a batch version of Exec.
+   * @return true if it has an ExecBatch function.
+   */
+  static constexpr bool HasExecBatch() { return has_udf_exec_batch_fn<T>::value; }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
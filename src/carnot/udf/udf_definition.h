@@ -126,8 +126,8 @@ class ScalarUDFDefinition : public UDFDefinition {
   }
 
   Status ExecBatchArrow(ScalarUDF* udf, FunctionContext* ctx,
-                        const std::vector<arrow::Array*>& inputs, arrow::ArrayBuilder* output,
-                        int count) {
+                        const std::vector<arrow::Array*>& inputs,
+                        std::shared_ptr<arrow::Array>* output, int count) {
     return exec_wrapper_arrow_fn_(udf, ctx, inputs, output, count);
   }
 
@@ -162,8 +162,8 @@ class ScalarUDFDefinition : public UDFDefinition {
       exec_wrapper_fn_;
 
   std::function<Status(ScalarUDF* udf, FunctionContext* ctx,
-                       const std::vector<arrow::Array*>& inputs, arrow::ArrayBuilder* output,
-                       int count)>
+                       const std::vector<arrow::Array*>& inputs,
+                       std::shared_ptr<arrow::Array>* output, int count)>
       exec_wrapper_arrow_fn_;
 
   std::function<Status(ScalarUDF* udf, FunctionContext* ctx,
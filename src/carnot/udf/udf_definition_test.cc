@@ -123,14 +123,12 @@ TEST(UDFDefinition, arrow_write) {
   auto v1a = ToArrow(v1, arrow::default_memory_pool());
   auto v2a = ToArrow(v2, arrow::default_memory_pool());
 
-  auto output_builder = std::make_shared<arrow::Int64Builder>();
   auto u = std::make_shared<AddUDF>();
-  EXPECT_TRUE(ScalarUDFWrapper<AddUDF>::ExecBatchArrow(u.get(), &ctx, {v1a.get(), v2a.get()},
-                                                       output_builder.get(), 3)
-                  .ok());
-
   std::shared_ptr<arrow::Array> res;
-  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  EXPECT_TRUE(
+      ScalarUDFWrapper<AddUDF>::ExecBatchArrow(u.get(), &ctx, {v1a.get(), v2a.get()}, &res, 3)
+          .ok());
+
   auto* resArr = static_cast<arrow::Int64Array*>(res.get());
   EXPECT_EQ(4, resArr->Value(0));
   EXPECT_EQ(6, resArr->Value(1));
@@ -20,6 +20,7 @@
 
 #include <arrow/array.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -53,7 +54,8 @@ constexpr auto CastToUDFValueType(const types::BaseValueType* arg) {
  * based on the type and arity of the input arguments.
  *
  * This function takes calls the Exec function of the UDF after type casting all the
- * input values. The function is called once for each row of the input batch.
+ * input values. The function is called once for each row of the input batch, unless the UDF
+ * has an ExecBatch function, which is called once for the whole batch.
  *
  * @return Status of execution.
  */
@@ -62,8 +64,12 @@ Status ExecWrapper(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
                    const std::vector<const types::BaseValueType*>& args,
                    std::index_sequence<I...>) {
   [[maybe_unused]] constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
-  for (size_t idx = 0; idx < count; ++idx) {
-    out[idx] = udf->Exec(ctx, CastToUDFValueType<exec_argument_types[I]>(args[I])[idx]...);
+  if constexpr (ScalarUDFTraits<TUDF>::HasExecBatch()) {
+    TUDF::ExecBatch(ctx, count, CastToUDFValueType<exec_argument_types[I]>(args[I])..., out);
+  } else {
+    for (size_t idx = 0; idx < count; ++idx) {
+      out[idx] = udf->Exec(ctx, CastToUDFValueType<exec_argument_types[I]>(args[I])[idx]...);
+    }
   }
   return Status::OK();
 }
@@ -132,6 +138,47 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
   return Status::OK();
 }
 
+/**
+ * Whether arrow arrays of the data type hold their values contiguously, in the same layout as an
+ * array of the UDF value type. Arrow packs booleans into bits, so they don't.
+ */
+constexpr bool HasContiguousArrowValues(types::DataType data_type) {
+  return data_type == types::DataType::INT64 || data_type == types::DataType::TIME64NS ||
+         data_type == types::DataType::FLOAT64;
+}
+
+template <types::DataType T>
+const typename types::DataTypeTraits<T>::value_type* ArrowValues(const arrow::Array* arr) {
+  using value_type = typename types::DataTypeTraits<T>::value_type;
+  using native_type = typename types::DataTypeTraits<T>::native_type;
+  static_assert(HasContiguousArrowValues(T));
+  static_assert(sizeof(value_type) == sizeof(native_type));
+  return reinterpret_cast<const value_type*>(
+      static_cast<const typename types::DataTypeTraits<T>::arrow_array_type*>(arr)->raw_values());
+}
+
+/**
+ * This is the inner wrapper for calling the ExecBatch function of a UDF on arrow arrays. The
+ * inputs are read in place, so they must all have contiguous values and no nulls. The results are
+ * written straight into a column that the output array shares (see types::ShareAsArrow).
+ */
+template <typename TUDF, std::size_t... I>
+Status ExecBatchWrapperArrow(FunctionContext* ctx, size_t count,
+                             const std::vector<arrow::Array*>& args,
+                             std::shared_ptr<arrow::Array>* out, std::index_sequence<I...>) {
+  [[maybe_unused]] static constexpr auto exec_argument_types =
+      ScalarUDFTraits<TUDF>::ExecArguments();
+  constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+  using return_value_type = typename types::DataTypeTraits<return_type>::value_type;
+
+  auto results = types::ColumnWrapper::Make(return_type, count);
+  TUDF::ExecBatch(
+      ctx, count, ArrowValues<exec_argument_types[I]>(args[I])...,
+      static_cast<types::ColumnWrapperTmpl<return_value_type>*>(results.get())->UnsafeRawData());
+  *out = types::ShareAsArrow(results, arrow::default_memory_pool());
+  return Status::OK();
+}
+
 /**
  * Checks types between column wrapper and array of types::UDFDataTypes.
  * @return true if all types match.
@@ -173,7 +220,7 @@ struct ScalarUDFWrapper {
    * Provides a method that executes the tempalated UDF on a batch of inputs.
    * The input batches are represented as vector of arrow:array pointers.
    *
-   * This expects all the inputs and outputs to be allocated and of the appropriate
+   * This expects all the inputs to be allocated and of the appropriate
    * type. This function is unsafe and will perform unsafe casts and using an incorrect
    * type will result in a crash!
    *
@@ -182,28 +229,58 @@ struct ScalarUDFWrapper {
    * @param udf a pointer to the UDF.
    * @param ctx The function context.
    * @param inputs A vector of arrow::array* of inputs to the udf.
-   * @param output The output builder.
+   * @param output The output array.
    * @param count The number of elements in the input and out (these need to be the same).
    * @return Status of execution.
    */
   static Status ExecBatchArrow(ScalarUDF* udf, FunctionContext* ctx,
                                const std::vector<arrow::Array*>& inputs,
-                               arrow::ArrayBuilder* output, int count) {
+                               std::shared_ptr<arrow::Array>* output, int count) {
     constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
-    auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+    constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+    using output_builder_type = typename types::DataTypeTraits<return_type>::arrow_builder_type;
 
     // Check that output is allocated.
     DCHECK(output != nullptr);
     // Check that the arity is correct.
     DCHECK(inputs.size() == ScalarUDFTraits<TUDF>::ExecArguments().size());
 
+    // UDFs with an ExecBatch function can read the input arrays in place, as long as the arrays
+    // hold their values contiguously and have no nulls to skip over.
+    if constexpr (ScalarUDFTraits<TUDF>::HasExecBatch() && CanExecBatchArrow()) {
+      bool has_nulls = std::any_of(inputs.begin(), inputs.end(),
+                                   [](const arrow::Array* arr) { return arr->null_count() > 0; });
+      if (!has_nulls) {
+        return ExecBatchWrapperArrow<TUDF>(ctx, count, inputs, output,
+                                           std::make_index_sequence<exec_argument_types.size()>{});
+      }
+    }
+
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
-    return ExecWrapperArrow<TUDF>(
-        static_cast<TUDF*>(udf), ctx, count,
-        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
-        inputs, std::make_index_sequence<exec_argument_types.size()>{});
+    auto builder = types::MakeArrowBuilder(return_type, arrow::default_memory_pool());
+    PL_RETURN_IF_ERROR(ExecWrapperArrow<TUDF>(
+        static_cast<TUDF*>(udf), ctx, count, static_cast<output_builder_type*>(builder.get()),
+        inputs, std::make_index_sequence<exec_argument_types.size()>{}));
+    PL_RETURN_IF_ERROR(builder->Finish(output));
+    return Status::OK();
+  }
+
+  /**
+   * @return whether the ExecBatch function of the UDF can be called on arrow arrays in place.
+   */
+  static constexpr bool CanExecBatchArrow() {
+    constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+    if (return_type != types::DataType::BOOLEAN && !HasContiguousArrowValues(return_type)) {
+      return false;
+    }
+    for (auto arg_type : ScalarUDFTraits<TUDF>::ExecArguments()) {
+      if (!HasContiguousArrowValues(arg_type)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   /**
@@ -171,6 +171,14 @@ TEST(IntOps, IntRoundUpToPow2) {
   EXPECT_EQ(IntRoundUpToPow2(9), 16);
 }
 
+TEST(IntOps, IntRoundDownToPow2) {
+  EXPECT_EQ(IntRoundDownToPow2(1), 1);
+  EXPECT_EQ(IntRoundDownToPow2(5), 4);
+  EXPECT_EQ(IntRoundDownToPow2(7), 4);
+  EXPECT_EQ(IntRoundDownToPow2(8), 8);
+  EXPECT_EQ(IntRoundDownToPow2(9), 8);
+}
+
 TEST(CaseInsensitiveCompare, BasicsWithString) {
   CaseInsensitiveLess str_compare;
 
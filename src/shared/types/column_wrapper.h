@@ -204,6 +204,73 @@ using Float64ValueColumnWrapper = ColumnWrapperTmpl<Float64Value>;
 using StringValueColumnWrapper = ColumnWrapperTmpl<StringValue>;
 using Time64NSValueColumnWrapper = ColumnWrapperTmpl<Time64NSValue>;
 
+/**
+ * ColumnWrapperBuffer is an arrow::Buffer over the memory of a ColumnWrapper. It holds a reference
+ * to the ColumnWrapper to keep the memory alive for the lifetime of the buffer.
+ */
+class ColumnWrapperBuffer : public arrow::Buffer {
+ public:
+  ColumnWrapperBuffer(SharedColumnWrapper col, const uint8_t* data, int64_t size)
+      : arrow::Buffer(data, size), col_(std::move(col)) {}
+
+ private:
+  SharedColumnWrapper col_;
+};
+
+static_assert(sizeof(Int64Value) == sizeof(int64_t));
+static_assert(sizeof(UInt128Value) == sizeof(absl::uint128));
+static_assert(sizeof(Float64Value) == sizeof(double));
+static_assert(sizeof(Time64NSValue) == sizeof(int64_t));
+
+/**
+ * ShareAsArrow returns an arrow array over the given column, sharing the column's memory rather
+ * than copying it when the memory layouts match (INT64, UINT128, FLOAT64 and TIME64NS columns).
+ * BOOLEAN and STRING columns are converted with ConvertToArrow, which copies them once.
+ * The column must not be modified for the lifetime of the returned array.
+ *
+ * Strings are out of scope: each StringValue owns a separate heap (or inline) buffer, so there are
+ * no contiguous bytes for Arrow's data buffer to point at. Sharing them would need
+ * ColumnWrapperTmpl<StringValue> to store Arrow's offsets + data layout, and Get<StringValue>()
+ * returns references into the current layout throughout Stirling. The copy is a single memcpy per
+ * string into a presized buffer (see BM_ShareAsArrowString), done once per hot batch column since
+ * the hot store caches the converted arrays.
+ * @param col the column to convert.
+ * @param mem_pool the memory pool to use if the column has to be copied.
+ * @return the arrow array.
+ */
+inline std::shared_ptr<arrow::Array> ShareAsArrow(const SharedColumnWrapper& col,
+                                                  arrow::MemoryPool* mem_pool) {
+  std::shared_ptr<arrow::DataType> arrow_type;
+  int64_t value_bytes = 0;
+  switch (col->data_type()) {
+    case DataType::INT64:
+      arrow_type = arrow::int64();
+      value_bytes = sizeof(int64_t);
+      break;
+    case DataType::UINT128:
+      arrow_type = std::make_shared<arrow::UInt128Type>();
+      value_bytes = sizeof(absl::uint128);
+      break;
+    case DataType::FLOAT64:
+      arrow_type = arrow::float64();
+      value_bytes = sizeof(double);
+      break;
+    case DataType::TIME64NS:
+      arrow_type = arrow::time64(arrow::TimeUnit::NANO);
+      value_bytes = sizeof(int64_t);
+      break;
+    default:
+      // Booleans are bit packed and strings are offset + data buffers in arrow, so they have to be
+      // copied.
+      return col->ConvertToArrow(mem_pool);
+  }
+  int64_t length = col->Size();
+  auto buffer = std::make_shared<ColumnWrapperBuffer>(
+      col, reinterpret_cast<const uint8_t*>(col->UnsafeRawData()), length * value_bytes);
+  return arrow::MakeArray(arrow::ArrayData::Make(std::move(arrow_type), length,
+                                                 {nullptr, std::move(buffer)}, /*null_count*/ 0));
+}
+
 template <typename TColumnWrapper, types::DataType DType>
 inline SharedColumnWrapper FromArrowImpl(const std::shared_ptr<arrow::Array>& arr) {
   CHECK_EQ(arr->type_id(), DataTypeTraits<DType>::arrow_type_id);
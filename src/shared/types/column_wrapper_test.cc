@@ -283,5 +283,37 @@ TEST(ColumnWrapperTest, MoveIndexes) {
   }
 }
 
+TEST(ColumnWrapperTest, share_as_arrow_fixed_size) {
+  auto wrapper = std::make_shared<Time64NSValueColumnWrapper>(
+      std::vector<Time64NSValue>{1, 2, 3});
+  auto arrow_arr = ShareAsArrow(wrapper, arrow::default_memory_pool());
+  ASSERT_EQ(arrow::Type::TIME64, arrow_arr->type_id());
+  EXPECT_TRUE(arrow_arr->Equals(ToArrow(std::vector<Time64NSValue>{1, 2, 3},
+                                        arrow::default_memory_pool())));
+  // The array shares the wrapper's memory, and keeps it alive.
+  auto arr_casted = static_cast<arrow::Time64Array*>(arrow_arr.get());
+  EXPECT_EQ(reinterpret_cast<const int64_t*>(wrapper->UnsafeRawData()),
+            arr_casted->raw_values());
+  wrapper.reset();
+  EXPECT_EQ(3, arr_casted->Value(2));
+}
+
+TEST(ColumnWrapperTest, share_as_arrow_uint128) {
+  std::vector<UInt128Value> vals = {UInt128Value(1, 2), UInt128Value(3, 4)};
+  auto wrapper = std::make_shared<UInt128ValueColumnWrapper>(vals);
+  auto arrow_arr = ShareAsArrow(wrapper, arrow::default_memory_pool());
+  ASSERT_EQ(arrow::Type::UINT128, arrow_arr->type_id());
+  EXPECT_TRUE(arrow_arr->Equals(ToArrow(vals, arrow::default_memory_pool())));
+  EXPECT_EQ(UInt128Value(3, 4), GetValueFromArrowArray<DataType::UINT128>(arrow_arr.get(), 1));
+}
+
+TEST(ColumnWrapperTest, share_as_arrow_string) {
+  auto wrapper = std::make_shared<StringValueColumnWrapper>(
+      std::vector<StringValue>{"abc", "def"});
+  auto arrow_arr = ShareAsArrow(wrapper, arrow::default_memory_pool());
+  EXPECT_TRUE(arrow_arr->Equals(ToArrow(std::vector<StringValue>{"abc", "def"},
+                                        arrow::default_memory_pool())));
+}
+
 }  // namespace types
 }  // namespace px
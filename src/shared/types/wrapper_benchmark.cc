@@ -19,9 +19,11 @@
 #include <benchmark/benchmark.h>
 
 #include <random>
+#include <string>
 #include <vector>
 #include "src/common/benchmark/benchmark.h"
 #include "src/datagen/datagen.h"
+#include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/types.h"
 
 using px::types::Int64Value;
@@ -65,3 +67,32 @@ static void BM_Int64Vector(benchmark::State& state) {  // NOLINT
 
 BENCHMARK_TEMPLATE(BM_Int64Vector, int64_t)->Arg(10000);
 BENCHMARK_TEMPLATE(BM_Int64Vector, Int64Value)->Arg(10000);
+
+// Hot reads hand each Stirling column to Arrow once per batch. Fixed-size columns are shared,
+// strings are copied into Arrow's offsets + data layout.
+static void BM_ShareAsArrowInt64(benchmark::State& state) {  // NOLINT
+  auto col = px::types::ColumnWrapper::Make(px::types::DataType::INT64, state.range(0));
+  for (auto _ : state) {
+    auto arr = px::types::ShareAsArrow(col, arrow::default_memory_pool());
+    benchmark::DoNotOptimize(arr);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void BM_ShareAsArrowString(benchmark::State& state) {  // NOLINT
+  size_t num_rows = state.range(0);
+  size_t str_len = state.range(1);
+  auto col = px::types::ColumnWrapper::Make(px::types::DataType::STRING, 0);
+  for (size_t i = 0; i < num_rows; ++i) {
+    col->Append<px::types::StringValue>(std::string(str_len, 'a' + i % 26));
+  }
+  for (auto _ : state) {
+    auto arr = px::types::ShareAsArrow(col, arrow::default_memory_pool());
+    benchmark::DoNotOptimize(arr);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * num_rows);
+  state.SetBytesProcessed(int64_t(state.iterations()) * num_rows * str_len);
+}
+
+BENCHMARK(BM_ShareAsArrowInt64)->Arg(1024);
+BENCHMARK(BM_ShareAsArrowString)->ArgPair(1024, 8)->ArgPair(1024, 32)->ArgPair(1024, 256);
@@ -18,8 +18,10 @@
 
 #include "src/stirling/bpf_tools/bcc_wrapper.h"
 
+#include <bcc/libbpf.h>
 #include <linux/perf_event.h>
 #include <sys/mount.h>
+#include <unistd.h>
 
 #include <iostream>
 #include <string>
@@ -417,6 +419,69 @@ std::string BCCWrapper::GetKProbeTargetName(const KProbeSpec& probe) {
   return target;
 }
 
+namespace {
+
+// Adapts the libbpf ring buffer callback to the perf buffer one, so the same handlers serve both.
+template <typename TRingBuffer>
+int HandleRingBufferEvent(void* ctx, void* data, size_t size) {
+  auto* ring_buffer = static_cast<TRingBuffer*>(ctx);
+  ring_buffer->spec.probe_output_fn(ring_buffer->cb_cookie, data, static_cast<int>(size));
+  return 0;
+}
+
+}  // namespace
+
+bool BCCWrapper::SupportsRingBuffers() {
+  // BPF_MAP_TYPE_RINGBUF was added in Linux 5.8, but some distributions backport it, so probe for
+  // it by creating a one page ring buffer rather than checking the kernel version.
+  static const bool kSupported = []() {
+    const int page_size = system::Config::GetInstance().PageSizeBytes();
+    int map_fd = bcc_create_map(BPF_MAP_TYPE_RINGBUF, "ringbuf_probe", /* key_size */ 0,
+                                /* value_size */ 0, /* max_entries */ page_size, /* flags */ 0);
+    if (map_fd < 0) {
+      LOG(INFO) << absl::Substitute("BPF ring buffers are not supported, errno=$0", errno);
+      return false;
+    }
+    close(map_fd);
+    return true;
+  }();
+  return kSupported;
+}
+
+Status BCCWrapper::OpenRingBuffer(const RingBufferSpec& ring_buffer, void* cb_cookie) {
+  LOG(INFO) << absl::Substitute("Opening ring buffer: $0", ring_buffer.name);
+  int map_fd = bpf_.get_table(ring_buffer.name).get_fd();
+  if (map_fd < 0) {
+    return error::Internal("Could not find ring buffer $0", ring_buffer.name);
+  }
+
+  auto rb = std::make_unique<RingBuffer>();
+  rb->spec = ring_buffer;
+  rb->cb_cookie = cb_cookie;
+  rb->reader = bpf_new_ringbuf(map_fd, HandleRingBufferEvent<RingBuffer>, rb.get());
+  if (rb->reader == nullptr) {
+    return error::Internal("Failed to open ring buffer $0", ring_buffer.name);
+  }
+  ring_buffers_.push_back(std::move(rb));
+  ++num_open_ring_buffers_;
+  return Status::OK();
+}
+
+void BCCWrapper::CloseRingBuffers() {
+  for (const auto& rb : ring_buffers_) {
+    VLOG(1) << "Closing ring buffer: " << rb->spec.name;
+    bpf_free_ringbuf(static_cast<struct ring_buffer*>(rb->reader));
+    --num_open_ring_buffers_;
+  }
+  ring_buffers_.clear();
+}
+
+void BCCWrapper::PollRingBuffers(int timeout_ms) {
+  for (const auto& rb : ring_buffers_) {
+    bpf_poll_ringbuf(static_cast<struct ring_buffer*>(rb->reader), timeout_ms);
+  }
+}
+
 void BCCWrapper::PollPerfBuffer(std::string_view perf_buffer_name, int timeout_ms) {
   auto perf_buffer = bpf_.get_perf_buffer(std::string(perf_buffer_name));
   if (perf_buffer != nullptr) {
@@ -433,6 +498,7 @@ void BCCWrapper::PollPerfBuffers(int timeout_ms) {
 void BCCWrapper::Close() {
   DetachPerfEvents();
   ClosePerfBuffers();
+  CloseRingBuffers();
   DetachKProbes();
   DetachUProbes();
   DetachTracepoints();
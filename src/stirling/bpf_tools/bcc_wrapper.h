@@ -196,6 +196,22 @@ struct PerfBufferSpec {
   PerfBufferSizeCategory size_category = PerfBufferSizeCategory::kUncategorized;
 };
 
+/**
+ * Describes a BPF ring buffer (BPF_MAP_TYPE_RINGBUF), through which data is returned to
+ * user-space. Unlike a perf buffer, a ring buffer is shared by all CPUs, so events come out in the
+ * order they were committed. Requires Linux 5.8+.
+ */
+struct RingBufferSpec {
+  // Name of the ring buffer.
+  // Must be the same as the ring buffer name declared in the probe code with BPF_RINGBUF_OUTPUT.
+  // Its size is set in the probe code.
+  std::string name;
+
+  // Function that will be called for every event in the ring buffer, when the ring buffer is
+  // polled. Same as for perf buffers, so that the same handlers can serve both.
+  perf_reader_raw_cb probe_output_fn;
+};
+
 /**
  * Describes a perf event to attach.
  * This can be run stand-alone and is not dependent on kProbes.
@@ -295,6 +311,15 @@ class BCCWrapper {
    */
   Status OpenPerfBuffer(const PerfBufferSpec& perf_buffer, void* cb_cookie = nullptr);
 
+  /**
+   * Open a ring buffer for reading events.
+   * @param ring_buffer Specifications of the ring buffer (name and callback function).
+   * @param cb_cookie A pointer that is sent to the callback function when triggered by
+   * PollRingBuffers().
+   * @return Error if ring buffer cannot be opened (e.g. ring buffer does not exist).
+   */
+  Status OpenRingBuffer(const RingBufferSpec& ring_buffer, void* cb_cookie = nullptr);
+
   /**
    * Attach a perf event, which runs a probe every time a perf counter reaches a threshold
    * condition.
@@ -378,6 +403,26 @@ class BCCWrapper {
    */
   void PollPerfBuffers(int timeout_ms = 0);
 
+  /**
+   * Drains a single perf buffer. Used when the perf buffers are drained by different threads.
+   *
+   * @param timeout_ms Same as for PollPerfBuffers().
+   */
+  void PollPerfBuffer(std::string_view perf_buffer_name, int timeout_ms = 0);
+
+  /**
+   * Drains all of the opened ring buffers, calling the handle function that was
+   * specified in the RingBufferSpec when OpenRingBuffer was called.
+   *
+   * @param timeout_ms Same as for PollPerfBuffers().
+   */
+  void PollRingBuffers(int timeout_ms = 0);
+
+  /**
+   * Returns true if the running kernel supports BPF ring buffers. Probed once, by creating one.
+   */
+  static bool SupportsRingBuffers();
+
   /**
    * Detaches all probes, and closes all perf buffers that are open.
    */
@@ -415,6 +460,7 @@ class BCCWrapper {
   // It is meant for verification that we have cleaned-up all resources in tests.
   static size_t num_attached_probes() { return num_attached_kprobes_ + num_attached_uprobes_; }
   static size_t num_open_perf_buffers() { return num_open_perf_buffers_; }
+  static size_t num_open_ring_buffers() { return num_open_ring_buffers_; }
   static size_t num_attached_perf_events() { return num_attached_perf_events_; }
 
  private:
@@ -425,7 +471,6 @@ class BCCWrapper {
   Status DetachTracepoint(const TracepointSpec& probe);
   Status ClosePerfBuffer(const PerfBufferSpec& perf_buffer);
   Status DetachPerfEvent(const PerfEventSpec& perf_event);
-  void PollPerfBuffer(std::string_view perf_buffer_name, int timeout_ms);
 
   // Detaches all kprobes/uprobes/perf buffers/perf events that were attached by the wrapper.
   // If any fails to detach, an error is logged, and the function continues.
@@ -433,6 +478,7 @@ class BCCWrapper {
   void DetachUProbes();
   void DetachTracepoints();
   void ClosePerfBuffers();
+  void CloseRingBuffers();
   void DetachPerfEvents();
 
   // Returns the name that identifies the target to attach this k-probe.
@@ -444,6 +490,16 @@ class BCCWrapper {
   std::vector<PerfBufferSpec> perf_buffers_;
   std::vector<PerfEventSpec> perf_events_;
 
+  // An open ring buffer. The callback and its cookie are kept here, since libbpf calls back with a
+  // single context pointer.
+  struct RingBuffer {
+    RingBufferSpec spec;
+    void* cb_cookie = nullptr;
+    // Opaque libbpf ring_buffer.
+    void* reader = nullptr;
+  };
+  std::vector<std::unique_ptr<RingBuffer>> ring_buffers_;
+
   std::string system_headers_include_dir_;
 
   // Initialize this with one of the below bitmask flags to turn on different debug output.
@@ -466,6 +522,7 @@ class BCCWrapper {
   inline static size_t num_attached_uprobes_;
   inline static size_t num_attached_tracepoints_;
   inline static size_t num_open_perf_buffers_;
+  inline static size_t num_open_ring_buffers_;
   inline static size_t num_attached_perf_events_;
 
  private:
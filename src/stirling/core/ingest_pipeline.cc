@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/core/ingest_pipeline.h"
+
+#include <memory>
+#include <unordered_map>
+
+#include "src/common/base/base.h"
+
+DEFINE_int32(stirling_ingest_worker_threads,
+             gflags::Int32FromEnv("PL_STIRLING_INGEST_WORKER_THREADS", 0),
+             "If greater than 0, Stirling ingests events in a pipeline: a dedicated thread drains "
+             "the socket tracer's BPF buffers, this many worker threads parse the connections, "
+             "and a separate thread pushes the data to the table store. If 0, all of it runs "
+             "serially on the main Stirling thread.");
+
+namespace px {
+namespace stirling {
+
+IngestStageMetrics::IngestStageMetrics(prometheus::Registry* registry, const std::string& stage)
+    : queue_depth(prometheus::BuildGauge()
+                      .Name("stirling_ingest_queue_depth")
+                      .Help("Number of items waiting in the queue in front of this stage of the "
+                            "pipelined ingest.")
+                      .Register(*registry)
+                      .Add({{"stage", stage}})),
+      dropped(prometheus::BuildCounter()
+                  .Name("stirling_ingest_dropped")
+                  .Help("Total number of items dropped because the queue in front of this stage "
+                        "of the pipelined ingest was full.")
+                  .Register(*registry)
+                  .Add({{"stage", stage}})) {}
+
+IngestStageMetrics& IngestStageMetrics::GetStageMetrics(const std::string& stage) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::unique_ptr<IngestStageMetrics>> stage_metrics;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& metrics = stage_metrics[stage];
+  if (metrics == nullptr) {
+    metrics = std::make_unique<IngestStageMetrics>(&GetMetricsRegistry(), stage);
+  }
+  return *metrics;
+}
+
+WorkerPool::WorkerPool(int num_threads) {
+  DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this, i);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::RunShards(const std::function<void(int)>& fn) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  fn_ = &fn;
+  num_running_ = threads_.size();
+  ++round_;
+  work_cv_.notify_all();
+  done_cv_.wait(lock, [this]() { return num_running_ == 0; });
+  fn_ = nullptr;
+}
+
+void WorkerPool::WorkerLoop(int shard) {
+  uint64_t last_round = 0;
+  while (true) {
+    const std::function<void(int)>* fn = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock, [&]() { return stop_ || round_ != last_round; });
+      if (stop_) {
+        return;
+      }
+      last_round = round_;
+      fn = fn_;
+    }
+
+    (*fn)(shard);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --num_running_;
+    }
+    done_cv_.notify_one();
+  }
+}
+
+}  // namespace stirling
+}  // namespace px
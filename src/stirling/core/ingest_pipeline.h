@@ -0,0 +1,199 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <prometheus/counter.h>
+#include <prometheus/gauge.h>
+#include <prometheus/registry.h>
+
+#include "src/common/metrics/metrics.h"
+
+DECLARE_int32(stirling_ingest_worker_threads);
+
+namespace px {
+namespace stirling {
+
+/**
+ * The metrics of one stage of the pipelined ingest: how many items wait in the queue in front of
+ * the stage, and how many items were dropped because that queue was full.
+ */
+struct IngestStageMetrics {
+  IngestStageMetrics(prometheus::Registry* registry, const std::string& stage);
+  prometheus::Gauge& queue_depth;
+  prometheus::Counter& dropped;
+
+  static IngestStageMetrics& GetStageMetrics(const std::string& stage);
+};
+
+/**
+ * A FIFO queue between two stages of the pipelined ingest, bounded so that a slow consumer cannot
+ * make the producer grow memory without limit. A full queue either drops the pushed item
+ * (TryPush) or blocks the producer until there is room (Push).
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  BoundedQueue(size_t capacity, IngestStageMetrics* metrics)
+      : capacity_(capacity), metrics_(metrics) {}
+
+  /**
+   * Appends the item to the queue. Returns false, and drops the item, if the queue is full or
+   * closed.
+   */
+  bool TryPush(T item) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_ || items_.size() >= capacity_) {
+        metrics_->dropped.Increment();
+        return false;
+      }
+      items_.push_back(std::move(item));
+    }
+    metrics_->queue_depth.Increment();
+    cv_.notify_one();
+    return true;
+  }
+
+  /**
+   * Appends the item to the queue, waiting for room if the queue is full. Returns false, and
+   * drops the item, if the queue is closed.
+   */
+  bool Push(T item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_cv_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+      if (closed_) {
+        metrics_->dropped.Increment();
+        return false;
+      }
+      items_.push_back(std::move(item));
+    }
+    metrics_->queue_depth.Increment();
+    cv_.notify_one();
+    return true;
+  }
+
+  /**
+   * Removes the item at the head of the queue, waiting up to timeout for one to arrive.
+   * Returns std::nullopt if there is none by then, or if the queue is closed and empty.
+   */
+  std::optional<T> Pop(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, timeout, [this]() { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return std::nullopt;
+    }
+    T item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    metrics_->queue_depth.Decrement();
+    not_full_cv_.notify_one();
+    return item;
+  }
+
+  /**
+   * Removes all the items of the queue, without waiting.
+   */
+  std::deque<T> PopAll() {
+    std::deque<T> items;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      items.swap(items_);
+    }
+    metrics_->queue_depth.Decrement(items.size());
+    not_full_cv_.notify_all();
+    return items;
+  }
+
+  /**
+   * Rejects all future pushes, and wakes up any waiting Push() or Pop().
+   */
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+    not_full_cv_.notify_all();
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+ private:
+  const size_t capacity_;
+  IngestStageMetrics* metrics_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable not_full_cv_;
+  std::deque<T> items_;
+  bool closed_ = false;
+};
+
+/**
+ * A fixed set of worker threads, one per shard. Work is handed out a round at a time: RunShards()
+ * calls a function once for every shard, each on the shard's own thread, so the work of a shard
+ * never runs concurrently with itself.
+ */
+class WorkerPool {
+ public:
+  explicit WorkerPool(int num_threads);
+  ~WorkerPool();
+
+  /**
+   * Calls fn(shard) for every shard in [0, num_threads()), and returns once all of the calls
+   * have returned.
+   */
+  void RunShards(const std::function<void(int)>& fn);
+
+  int num_threads() const { return threads_.size(); }
+
+ private:
+  void WorkerLoop(int shard);
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  // The function of the current round, and the round's number, which wakes up the workers.
+  const std::function<void(int)>* fn_ = nullptr;
+  uint64_t round_ = 0;
+  int num_running_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace stirling
+}  // namespace px
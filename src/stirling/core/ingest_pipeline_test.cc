@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/core/ingest_pipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace px {
+namespace stirling {
+
+TEST(BoundedQueueTest, DropsWhenFull) {
+  auto& metrics = IngestStageMetrics::GetStageMetrics("bounded_queue_test");
+  double dropped_before = metrics.dropped.Value();
+
+  BoundedQueue<std::unique_ptr<int>> queue(2, &metrics);
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(1)));
+  EXPECT_TRUE(queue.TryPush(std::make_unique<int>(2)));
+  EXPECT_FALSE(queue.TryPush(std::make_unique<int>(3)));
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_EQ(metrics.queue_depth.Value(), 2);
+  EXPECT_EQ(metrics.dropped.Value() - dropped_before, 1);
+
+  auto item = queue.Pop(std::chrono::milliseconds{0});
+  ASSERT_TRUE(item.has_value());
+  EXPECT_EQ(**item, 1);
+
+  auto items = queue.PopAll();
+  ASSERT_EQ(items.size(), 1);
+  EXPECT_EQ(*items[0], 2);
+  EXPECT_EQ(metrics.queue_depth.Value(), 0);
+  EXPECT_FALSE(queue.Pop(std::chrono::milliseconds{0}).has_value());
+}
+
+TEST(BoundedQueueTest, CloseWakesUpPop) {
+  BoundedQueue<int> queue(2, &IngestStageMetrics::GetStageMetrics("bounded_queue_test"));
+  std::thread consumer([&queue]() { EXPECT_FALSE(queue.Pop(std::chrono::hours{1}).has_value()); });
+  queue.Close();
+  consumer.join();
+  EXPECT_FALSE(queue.TryPush(1));
+}
+
+TEST(BoundedQueueTest, PushWaitsForRoom) {
+  auto& metrics = IngestStageMetrics::GetStageMetrics("bounded_queue_test");
+  double dropped_before = metrics.dropped.Value();
+
+  BoundedQueue<int> queue(1, &metrics);
+  EXPECT_TRUE(queue.Push(1));
+  std::atomic<bool> pushed = false;
+  std::thread producer([&]() {
+    EXPECT_TRUE(queue.Push(2));
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  EXPECT_FALSE(pushed);
+
+  EXPECT_EQ(queue.Pop(std::chrono::milliseconds{0}), 1);
+  producer.join();
+  EXPECT_EQ(queue.Pop(std::chrono::milliseconds{0}), 2);
+  EXPECT_EQ(metrics.dropped.Value() - dropped_before, 0);
+
+  // A closed queue wakes up the producer, which drops its item.
+  EXPECT_TRUE(queue.Push(3));
+  std::thread blocked_producer([&queue]() { EXPECT_FALSE(queue.Push(4)); });
+  queue.Close();
+  blocked_producer.join();
+  EXPECT_EQ(metrics.dropped.Value() - dropped_before, 1);
+}
+
+TEST(WorkerPoolTest, RunsEveryShardOncePerRound) {
+  constexpr int kNumThreads = 4;
+  WorkerPool pool(kNumThreads);
+  EXPECT_EQ(pool.num_threads(), kNumThreads);
+
+  std::atomic<int> shard_counts[kNumThreads] = {};
+  for (int round = 0; round < 100; ++round) {
+    pool.RunShards([&](int shard) { ++shard_counts[shard]; });
+    // RunShards() returns only once every shard of the round is done.
+    for (int shard = 0; shard < kNumThreads; ++shard) {
+      EXPECT_EQ(shard_counts[shard], round + 1);
+    }
+  }
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -44,9 +44,24 @@ const int32_t kInvalidFD = -1;
 // is reported to user-space. It applies to read and write traffic combined.
 const int kConnStatsDataThreshold = 65536;
 
+// Data and control events are sent either through per-CPU perf buffers, or, on kernels that
+// support them (5.8+), through ring buffers shared by all CPUs. User-space selects the transport.
+#ifndef USE_RINGBUF
+#define USE_RINGBUF 0
+#endif
+
+#if USE_RINGBUF
+// The sizes are in pages, and must be powers of 2.
+BPF_RINGBUF_OUTPUT(socket_data_events, SOCKET_DATA_EVENTS_RINGBUF_PAGES);
+BPF_RINGBUF_OUTPUT(socket_control_events, SOCKET_CONTROL_EVENTS_RINGBUF_PAGES);
+
+// Counts the events that didn't fit in the ring buffers, indexed by ringbuf_loss_idx_t.
+BPF_PERCPU_ARRAY(ringbuf_loss_counts, uint64_t, kNumRingBufLossCounters);
+#else
 // This is the perf buffer for BPF program to export data from kernel to user space.
 BPF_PERF_OUTPUT(socket_data_events);
 BPF_PERF_OUTPUT(socket_control_events);
+#endif
 BPF_PERF_OUTPUT(conn_stats_events);
 
 // This output is used to export notification of processes that have performed an mmap.
@@ -321,6 +336,57 @@ static __inline void read_sockaddr_kernel(struct conn_info_t* conn_info,
   }
 }
 
+#if USE_RINGBUF
+static __inline void count_ringbuf_loss(uint32_t idx) {
+  uint64_t* count = ringbuf_loss_counts.lookup(&idx);
+  if (count != NULL) {
+    *count += 1;
+  }
+}
+#endif
+
+// Returns the control event to fill in. With ring buffers the event is reserved in the ring buffer
+// itself, so that submitting it doesn't copy it; otherwise it is the zeroed storage. Returns NULL
+// if the ring buffer is full.
+static __inline struct socket_control_event_t* reserve_control_event(
+    struct socket_control_event_t* storage) {
+#if USE_RINGBUF
+  struct socket_control_event_t* event =
+      socket_control_events.ringbuf_reserve(sizeof(struct socket_control_event_t));
+  if (event == NULL) {
+    count_ringbuf_loss(kSocketControlEventsLossIdx);
+    return NULL;
+  }
+  __builtin_memset(event, 0, sizeof(struct socket_control_event_t));
+  return event;
+#else
+  __builtin_memset(storage, 0, sizeof(struct socket_control_event_t));
+  return storage;
+#endif
+}
+
+static __inline void submit_control_event(struct pt_regs* ctx,
+                                          struct socket_control_event_t* event) {
+#if USE_RINGBUF
+  socket_control_events.ringbuf_submit(event, 0);
+#else
+  socket_control_events.perf_submit(ctx, event, sizeof(struct socket_control_event_t));
+#endif
+}
+
+// Data events are built in a per-CPU scratch buffer of the maximum event size, so they are copied
+// out with their actual size rather than reserved.
+static __inline void submit_data_event(struct pt_regs* ctx, struct socket_data_event_t* event,
+                                       size_t size) {
+#if USE_RINGBUF
+  if (socket_data_events.ringbuf_output(event, size, 0) != 0) {
+    count_ringbuf_loss(kSocketDataEventsLossIdx);
+  }
+#else
+  socket_data_events.perf_submit(ctx, event, size);
+#endif
+}
+
 static __inline void submit_new_conn(struct pt_regs* ctx, uint32_t tgid, int32_t fd,
                                      const struct sockaddr* addr, const struct socket* socket,
                                      enum endpoint_role_t role, enum source_function_t source_fn) {
@@ -343,28 +409,36 @@ static __inline void submit_new_conn(struct pt_regs* ctx, uint32_t tgid, int32_t
     return;
   }
 
-  struct socket_control_event_t control_event = {};
-  control_event.type = kConnOpen;
-  control_event.timestamp_ns = bpf_ktime_get_ns();
-  control_event.conn_id = conn_info.conn_id;
-  control_event.source_fn = source_fn;
-  control_event.open.addr = conn_info.addr;
-  control_event.open.role = conn_info.role;
+  struct socket_control_event_t storage;
+  struct socket_control_event_t* control_event = reserve_control_event(&storage);
+  if (control_event == NULL) {
+    return;
+  }
+  control_event->type = kConnOpen;
+  control_event->timestamp_ns = bpf_ktime_get_ns();
+  control_event->conn_id = conn_info.conn_id;
+  control_event->source_fn = source_fn;
+  control_event->open.addr = conn_info.addr;
+  control_event->open.role = conn_info.role;
 
-  socket_control_events.perf_submit(ctx, &control_event, sizeof(struct socket_control_event_t));
+  submit_control_event(ctx, control_event);
 }
 
 static __inline void submit_close_event(struct pt_regs* ctx, struct conn_info_t* conn_info,
                                         enum source_function_t source_fn) {
-  struct socket_control_event_t control_event = {};
-  control_event.type = kConnClose;
-  control_event.timestamp_ns = bpf_ktime_get_ns();
-  control_event.conn_id = conn_info->conn_id;
-  control_event.source_fn = source_fn;
-  control_event.close.rd_bytes = conn_info->rd_bytes;
-  control_event.close.wr_bytes = conn_info->wr_bytes;
+  struct socket_control_event_t storage;
+  struct socket_control_event_t* control_event = reserve_control_event(&storage);
+  if (control_event == NULL) {
+    return;
+  }
+  control_event->type = kConnClose;
+  control_event->timestamp_ns = bpf_ktime_get_ns();
+  control_event->conn_id = conn_info->conn_id;
+  control_event->source_fn = source_fn;
+  control_event->close.rd_bytes = conn_info->rd_bytes;
+  control_event->close.wr_bytes = conn_info->wr_bytes;
 
-  socket_control_events.perf_submit(ctx, &control_event, sizeof(struct socket_control_event_t));
+  submit_control_event(ctx, control_event);
 }
 
 // Writes the input buf to event, and submits the event to the corresponding perf buffer.
@@ -437,7 +511,7 @@ static __inline void perf_submit_buf(struct pt_regs* ctx, const enum traffic_dir
   // If-statement is redundant, but is required to keep the 4.14 verifier happy.
   if (amount_copied > 0) {
     event->attr.msg_buf_size = amount_copied;
-    socket_data_events.perf_submit(ctx, event, sizeof(event->attr) + amount_copied);
+    submit_data_event(ctx, event, sizeof(event->attr) + amount_copied);
   }
 }
 
@@ -843,7 +917,7 @@ static __inline void process_syscall_sendfile(struct pt_regs* ctx, uint64_t id,
     event->attr.pos = conn_info->wr_bytes;
     event->attr.msg_size = bytes_count;
     event->attr.msg_buf_size = 0;
-    socket_data_events.perf_submit(ctx, event, sizeof(event->attr));
+    submit_data_event(ctx, event, sizeof(event->attr));
   }
 
   update_conn_stats(ctx, conn_info, kEgress, bytes_count);
@@ -252,6 +252,14 @@ struct socket_control_event_t {
   };
 };
 
+// When the socket tracer sends its events through BPF ring buffers, the events that don't fit are
+// counted in a per-CPU array, at these indexes, since ring buffers have no loss notifications.
+enum ringbuf_loss_idx_t {
+  kSocketDataEventsLossIdx = 0,
+  kSocketControlEventsLossIdx = 1,
+  kNumRingBufLossCounters = 2,
+};
+
 struct connect_args_t {
   const struct sockaddr* addr;
   int32_t fd;
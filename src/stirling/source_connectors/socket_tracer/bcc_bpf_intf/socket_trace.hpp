@@ -91,34 +91,36 @@ struct SocketDataEvent {
   // from the payload. In these cases, the protocol inference misses the header of the first frame.
   // This header is encoded in the attributes instead.
   // We account for this with a separate header event.
-  std::unique_ptr<SocketDataEvent> ExtractHeaderEvent() {
-    std::unique_ptr<SocketDataEvent> header_event_ptr;
+  // Returns false if there is no header event. Otherwise, the header event is written to
+  // *header_event, and its msg points into the header event itself.
+  bool ExtractHeaderEvent(SocketDataEvent* header_event) {
+    if (!attr.prepend_length_header) {
+      return false;
+    }
 
-    if (attr.prepend_length_header) {
-      VLOG(1) << "Adding header event";
+    VLOG(1) << "Adding header event";
 
-      constexpr int kHeaderBufSize = 4;
+    constexpr int kHeaderBufSize = 4;
 
-      header_event_ptr = std::make_unique<SocketDataEvent>();
-      header_event_ptr->attr = attr;
-      header_event_ptr->attr.pos = attr.pos - kHeaderBufSize;
-      header_event_ptr->attr.msg_buf_size = kHeaderBufSize;
-      header_event_ptr->attr.msg_size = kHeaderBufSize;
+    header_event->attr = attr;
+    header_event->attr.pos = attr.pos - kHeaderBufSize;
+    header_event->attr.msg_buf_size = kHeaderBufSize;
+    header_event->attr.msg_size = kHeaderBufSize;
 
-      // Take the length_header from the original, fix byte ordering, and place
-      // into length_header of the header_event.
-      char header[kHeaderBufSize];
-      px::utils::IntToLEndianBytes(attr.length_header, header);
-      memcpy(&header_event_ptr->attr.length_header, header, kHeaderBufSize);
+    // Take the length_header from the original, fix byte ordering, and place
+    // into length_header of the header_event.
+    char header[kHeaderBufSize];
+    px::utils::IntToLEndianBytes(attr.length_header, header);
+    memcpy(&header_event->attr.length_header, header, kHeaderBufSize);
 
-      header_event_ptr->msg = std::string_view(reinterpret_cast<char*>(&header_event_ptr->attr.length_header), kHeaderBufSize);
+    header_event->msg = std::string_view(
+        reinterpret_cast<char*>(&header_event->attr.length_header), kHeaderBufSize);
 
-      // We've extracted the header event, so remove these attributes from the original event.
-      attr.prepend_length_header = false;
-      attr.length_header = 0;
-    }
+    // We've extracted the header event, so remove these attributes from the original event.
+    attr.prepend_length_header = false;
+    attr.length_header = 0;
 
-    return header_event_ptr;
+    return true;
   }
 
   // For events that which couldn't transfer all its data, we have two options:
@@ -129,37 +131,38 @@ struct SocketDataEvent {
   // A filler event is used in particular for sendfile data.
   // We need a better long-term solution for this,
   // since we aren't able to directly trace the data.
-  std::unique_ptr<SocketDataEvent> ExtractFillerEvent() {
-    std::unique_ptr<SocketDataEvent> filler_event_ptr;
-
+  // Returns false if there is no filler event. Otherwise, the filler event is written to
+  // *filler_event.
+  bool ExtractFillerEvent(SocketDataEvent* filler_event) {
     DCHECK_GE(attr.msg_size, attr.msg_buf_size);
 
-    if (attr.msg_size > attr.msg_buf_size) {
-      VLOG(1) << "Adding filler to event";
-
-      // Limit the size so we don't have huge allocations.
-      constexpr uint32_t kMaxFilledSizeBytes = 1 * 1024 * 1024;
-      static char kZeros[kMaxFilledSizeBytes] = {0};
-
-      size_t filler_size = attr.msg_size - attr.msg_buf_size;
-      if (filler_size > kMaxFilledSizeBytes) {
-        VLOG(1) << absl::Substitute("Truncating filler event: $0->$1", filler_size,
-                                    kMaxFilledSizeBytes);
-        filler_size = kMaxFilledSizeBytes;
-      }
-
-      filler_event_ptr = std::make_unique<SocketDataEvent>();
-      filler_event_ptr->attr = attr;
-      filler_event_ptr->attr.pos = attr.pos + attr.msg_buf_size;
-      filler_event_ptr->attr.msg_buf_size = filler_size;
-      filler_event_ptr->attr.msg_size = filler_size;
-      filler_event_ptr->msg = std::string_view(kZeros, filler_size);
-
-      // We've created the filler event, so adjust the original event accordingly.
-      attr.msg_size = attr.msg_buf_size;
+    if (attr.msg_size <= attr.msg_buf_size) {
+      return false;
     }
 
-    return filler_event_ptr;
+    VLOG(1) << "Adding filler to event";
+
+    // Limit the size so we don't have huge allocations.
+    constexpr uint32_t kMaxFilledSizeBytes = 1 * 1024 * 1024;
+    static char kZeros[kMaxFilledSizeBytes] = {0};
+
+    size_t filler_size = attr.msg_size - attr.msg_buf_size;
+    if (filler_size > kMaxFilledSizeBytes) {
+      VLOG(1) << absl::Substitute("Truncating filler event: $0->$1", filler_size,
+                                  kMaxFilledSizeBytes);
+      filler_size = kMaxFilledSizeBytes;
+    }
+
+    filler_event->attr = attr;
+    filler_event->attr.pos = attr.pos + attr.msg_buf_size;
+    filler_event->attr.msg_buf_size = filler_size;
+    filler_event->attr.msg_size = filler_size;
+    filler_event->msg = std::string_view(kZeros, filler_size);
+
+    // We've created the filler event, so adjust the original event accordingly.
+    attr.msg_size = attr.msg_buf_size;
+
+    return true;
   }
 
   std::string ToString() const {
@@ -208,9 +208,10 @@ class ConnTracker : NotCopyMoveable {
   /**
    * Registers a BPF data event into the tracker.
    *
-   * @param event The data event from BPF.
+   * @param event The data event from BPF. Its msg is copied, so it only needs to outlive the call.
    */
-  void AddDataEvent(std::unique_ptr<SocketDataEvent> event);
+  void AddDataEvent(const SocketDataEvent& event);
+  void AddDataEvent(std::unique_ptr<SocketDataEvent> event) { AddDataEvent(*event); }
 
   /**
    * Registers a BPF connection stats event into the tracker.
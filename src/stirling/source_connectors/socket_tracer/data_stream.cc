@@ -46,12 +46,12 @@ DEFINE_uint32(
 namespace px {
 namespace stirling {
 
-void DataStream::AddData(std::unique_ptr<SocketDataEvent> event) {
-  LOG_IF(WARNING, event->attr.msg_size > event->msg.size() && !event->msg.empty())
+void DataStream::AddData(const SocketDataEvent& event) {
+  LOG_IF(WARNING, event.attr.msg_size > event.msg.size() && !event.msg.empty())
       << absl::Substitute("Message truncated, original size: $0, transferred size: $1",
-                          event->attr.msg_size, event->msg.size());
+                          event.attr.msg_size, event.msg.size());
 
-  data_buffer_.Add(event->attr.pos, event->msg, event->attr.timestamp_ns);
+  data_buffer_.Add(event.attr.pos, event.msg, event.attr.timestamp_ns);
 
   has_new_events_ = true;
 }
@@ -110,7 +110,11 @@ void DataStream::ProcessBytesToFrames(message_type_t type, TStateType* state) {
   size_t frame_bytes = 0;
 
   while (keep_processing && !data_buffer_.empty()) {
-    size_t contiguous_bytes = data_buffer_.Head().size();
+    // Sum the chunks rather than calling Head(), which would make the head contiguous.
+    size_t contiguous_bytes = 0;
+    for (std::string_view chunk : data_buffer_.HeadChunks()) {
+      contiguous_bytes += chunk.size();
+    }
 
     // Now parse the raw data.
     parse_result =
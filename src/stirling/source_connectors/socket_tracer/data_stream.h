@@ -57,8 +57,10 @@ class DataStream : NotCopyMoveable {
 
   /**
    * Adds a raw (unparsed) chunk of data into the stream.
+   * The data is copied, so the event's msg only needs to outlive the call.
    */
-  void AddData(std::unique_ptr<SocketDataEvent> event);
+  void AddData(const SocketDataEvent& event);
+  void AddData(std::unique_ptr<SocketDataEvent> event) { AddData(*event); }
 
   /**
    * Parses as many messages as it can from the raw events into the messages container.
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <random>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -425,6 +426,34 @@ TEST_F(DataStreamTest, SpikeCapacityWithLargeDataChunk) {
             SocketTracerMetrics::GetProtocolMetrics(kProtocolHTTP).data_loss_bytes.Value());
 }
 
+// A large HTTP response arrives over many events, and is parsed after each one. With the chunked
+// buffer, its bytes are only made contiguous once, when the whole response has arrived.
+TEST_F(DataStreamTest, LargeMessageCoalescedOnce) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_stirling_data_stream_buffer_chunked_buffer = true;
+
+  constexpr int kNumBodyEvents = 64;
+  const std::string kBodyPart(1024, 'x');
+  const std::string kHeaders = absl::StrCat("HTTP/1.1 200 OK\r\nContent-Length: ",
+                                            kNumBodyEvents * kBodyPart.size(), "\r\n\r\n");
+
+  DataStream stream;
+  stream.set_protocol(kProtocolHTTP);
+  protocols::http::StateWrapper state{};
+
+  stream.AddData(event_gen_.InitRecvEvent<kProtocolHTTP>(kHeaders));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kResponse, &state);
+  for (int i = 0; i < kNumBodyEvents; ++i) {
+    EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+    stream.AddData(event_gen_.InitRecvEvent<kProtocolHTTP>(kBodyPart));
+    stream.ProcessBytesToFrames<http::Message>(message_type_t::kResponse, &state);
+  }
+
+  EXPECT_THAT(stream.Frames<http::Message>(), SizeIs(1));
+  EXPECT_EQ(stream.data_buffer().coalesced_bytes(),
+            kHeaders.size() + kNumBodyEvents * kBodyPart.size());
+}
+
 TEST_F(DataStreamTest, ResyncCausesDuplicateEventBug) {
   // Test to catch regression on a bug. The bug occured when a resync occurs in ParseFrames, leading
   // to an invalid state where the data stream buffer still had data that had already been
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/protocols/common/chunked_data_stream_buffer_impl.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/substitute.h>
+
+#include "src/common/base/utils.h"
+
+namespace px {
+namespace stirling {
+namespace protocols {
+
+void ChunkedDataStreamBufferImpl::Add(size_t pos, std::string_view data, uint64_t timestamp) {
+  if (data.empty()) {
+    return;
+  }
+  if (data.size() > capacity_) {
+    pos += data.size() - capacity_;
+    data.remove_prefix(data.size() - capacity_);
+  }
+
+  // Expire the data that falls out of the window of the last capacity_ positions.
+  size_t end = pos + data.size();
+  if (end > capacity_) {
+    DropBefore(end - capacity_);
+  }
+
+  // Ignore the part of the event that is older than the head.
+  if (end <= head_position_) {
+    return;
+  }
+  if (pos < head_position_) {
+    data.remove_prefix(head_position_ - pos);
+    pos = head_position_;
+  }
+
+  // Copy the event into a single block, and add a chunk for every part of it that fills a gap in
+  // the rope. Overlapping bytes are assumed to be retransmissions, and the existing ones are kept.
+  Block block = std::make_shared<const std::string>(data);
+  size_t offset = 0;
+  while (offset < data.size()) {
+    size_t chunk_pos = pos + offset;
+    auto next = chunks_.upper_bound(chunk_pos);
+    if (next != chunks_.begin()) {
+      auto prev = std::prev(next);
+      size_t prev_end = prev->first + prev->second.size;
+      if (prev_end > chunk_pos) {
+        offset = std::min(data.size(), prev_end - pos);
+        continue;
+      }
+    }
+    size_t chunk_size = data.size() - offset;
+    if (next != chunks_.end()) {
+      chunk_size = std::min(chunk_size, next->first - chunk_pos);
+    }
+    chunks_.emplace_hint(next, chunk_pos, Chunk{block, offset, chunk_size});
+    timestamps_.emplace(chunk_pos, timestamp);
+    size_ += chunk_size;
+    offset += chunk_size;
+  }
+}
+
+void ChunkedDataStreamBufferImpl::DropBefore(size_t pos) {
+  if (pos <= head_position_) {
+    return;
+  }
+  head_position_ = pos;
+
+  auto it = chunks_.begin();
+  while (it != chunks_.end() && it->first < pos) {
+    size_t chunk_end = it->first + it->second.size;
+    if (chunk_end <= pos) {
+      size_ -= it->second.size;
+      it = chunks_.erase(it);
+      continue;
+    }
+    // The chunk straddles pos, so only drop its prefix. The block is shared, so this is just a
+    // change of the view.
+    size_t n = pos - it->first;
+    auto node_handle = chunks_.extract(it);
+    node_handle.key() = pos;
+    node_handle.mapped().offset += n;
+    node_handle.mapped().size -= n;
+    chunks_.insert(std::move(node_handle));
+    size_ -= n;
+    break;
+  }
+
+  // Keep the timestamp of the event that pos falls into, but move it up to pos.
+  auto ts_it = timestamps_.upper_bound(pos);
+  if (ts_it == timestamps_.begin()) {
+    return;
+  }
+  ts_it--;
+  timestamps_.erase(timestamps_.begin(), ts_it);
+  if (ts_it->first < pos) {
+    auto node_handle = timestamps_.extract(ts_it);
+    node_handle.key() = pos;
+    timestamps_.insert(std::move(node_handle));
+  }
+}
+
+size_t ChunkedDataStreamBufferImpl::FirstChunkPos() const {
+  // This is unsafe, caller must check that there are chunks.
+  DCHECK(!chunks_.empty());
+  return chunks_.begin()->first;
+}
+
+std::map<size_t, ChunkedDataStreamBufferImpl::Chunk>::iterator
+ChunkedDataStreamBufferImpl::ContiguousEnd() {
+  auto it = chunks_.begin();
+  size_t end_pos = it->first;
+  while (it != chunks_.end() && it->first == end_pos) {
+    end_pos += it->second.size;
+    ++it;
+  }
+  return it;
+}
+
+std::vector<std::string_view> ChunkedDataStreamBufferImpl::HeadChunks() {
+  Trim();
+  std::vector<std::string_view> views;
+  if (chunks_.empty()) {
+    return views;
+  }
+  auto end = ContiguousEnd();
+  for (auto it = chunks_.begin(); it != end; ++it) {
+    views.push_back(it->second.View());
+  }
+  return views;
+}
+
+std::string_view ChunkedDataStreamBufferImpl::Head() {
+  Trim();
+  if (chunks_.empty()) {
+    return {};
+  }
+  auto end = ContiguousEnd();
+  if (std::next(chunks_.begin()) != end) {
+    // The caller needs the head as one string_view, so coalesce the contiguous chunks into a new
+    // block. This is the only place where bytes are copied after Add().
+    size_t merged_size = 0;
+    for (auto it = chunks_.begin(); it != end; ++it) {
+      merged_size += it->second.size;
+    }
+    auto merged = std::make_shared<std::string>();
+    merged->reserve(merged_size);
+    for (auto it = chunks_.begin(); it != end; ++it) {
+      merged->append(it->second.View());
+    }
+    coalesced_bytes_ += merged_size;
+    size_t first_pos = FirstChunkPos();
+    chunks_.erase(chunks_.begin(), end);
+    chunks_.emplace(first_pos, Chunk{std::move(merged), 0, merged_size});
+  }
+  return chunks_.begin()->second.View();
+}
+
+StatusOr<uint64_t> ChunkedDataStreamBufferImpl::GetTimestamp(size_t pos) const {
+  auto chunk_it = Floor(chunks_, pos);
+  if (chunk_it == chunks_.end() || pos >= chunk_it->first + chunk_it->second.size) {
+    return error::Internal("Specified position not found");
+  }
+  auto ts_it = Floor(timestamps_, pos);
+  if (ts_it == timestamps_.end()) {
+    return error::Internal("Specified position not found");
+  }
+  return ts_it->second;
+}
+
+void ChunkedDataStreamBufferImpl::RemovePrefix(ssize_t n) {
+  DCHECK_GE(n, 0);
+  if (n <= 0) {
+    return;
+  }
+  DropBefore(head_position_ + n);
+}
+
+void ChunkedDataStreamBufferImpl::Trim() {
+  if (chunks_.empty()) {
+    return;
+  }
+  DropBefore(FirstChunkPos());
+}
+
+size_t ChunkedDataStreamBufferImpl::capacity() const {
+  // Blocks stay allocated as long as any of their bytes are in the rope.
+  absl::flat_hash_set<const std::string*> blocks;
+  size_t allocated = 0;
+  for (const auto& [pos, chunk] : chunks_) {
+    if (blocks.insert(chunk.block.get()).second) {
+      allocated += chunk.block->size();
+    }
+  }
+  return allocated;
+}
+
+void ChunkedDataStreamBufferImpl::ShrinkToFit() {
+  for (auto& [pos, chunk] : chunks_) {
+    if (chunk.size == chunk.block->size()) {
+      continue;
+    }
+    chunk.block = std::make_shared<const std::string>(chunk.View());
+    chunk.offset = 0;
+  }
+}
+
+void ChunkedDataStreamBufferImpl::Reset() {
+  chunks_.clear();
+  timestamps_.clear();
+  size_ = 0;
+}
+
+std::string ChunkedDataStreamBufferImpl::DebugInfo() const {
+  return absl::Substitute("position=$0 size=$1 num_chunks=$2", head_position_, size_,
+                          chunks_.size());
+}
+
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
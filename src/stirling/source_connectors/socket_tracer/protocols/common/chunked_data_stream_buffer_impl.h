@@ -0,0 +1,126 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/stirling/source_connectors/socket_tracer/protocols/common/data_stream_buffer.h"
+
+namespace px {
+namespace stirling {
+namespace protocols {
+
+/**
+ * This version of the DataStreamBuffer stores the data as a rope of chunks. Each added event is
+ * copied once into a refcounted block, and every chunk is a view into a block, so adding
+ * out-of-order events, evicting and removing prefixes never move any bytes.
+ *
+ * HeadChunks() returns the contiguous data at the head as a list of chunks, for parsers that decode
+ * across chunk boundaries (see ChunkedBinaryDecoder). Head() still returns a single string_view;
+ * it is free if the head is a single chunk, and otherwise coalesces the contiguous chunks at the
+ * head into one block.
+ *
+ * Like the AlwaysContiguousDataStreamBufferImpl, the buffer is a rolling window of the last
+ * max_capacity positions, but gaps don't take up any memory.
+ */
+class ChunkedDataStreamBufferImpl : public DataStreamBufferImpl {
+ public:
+  // Support the same constructor signature as the AlwaysContiguousDataStreamBufferImpl.
+  ChunkedDataStreamBufferImpl(size_t max_capacity, size_t, size_t) : capacity_(max_capacity) {}
+  explicit ChunkedDataStreamBufferImpl(size_t max_capacity)
+      : ChunkedDataStreamBufferImpl(max_capacity, 0, 0) {}
+
+  void Add(size_t pos, std::string_view data, uint64_t timestamp) override;
+
+  std::string_view Head() override;
+
+  std::vector<std::string_view> HeadChunks() override;
+
+  StatusOr<uint64_t> GetTimestamp(size_t pos) const override;
+
+  void RemovePrefix(ssize_t n) override;
+
+  void Trim() override;
+
+  size_t size() const override { return size_; }
+
+  size_t capacity() const override;
+
+  bool empty() const override { return size_ == 0; }
+
+  size_t position() const override { return head_position_; }
+
+  std::string DebugInfo() const override;
+
+  void Reset() override;
+
+  void ShrinkToFit() override;
+
+  size_t coalesced_bytes() const override { return coalesced_bytes_; }
+
+  // The number of chunks in the rope.
+  size_t num_chunks() const { return chunks_.size(); }
+
+ private:
+  using Block = std::shared_ptr<const std::string>;
+
+  // A view of `size` bytes of `block`, starting at `offset`. Chunks that came from the same event
+  // (e.g. because the event overlapped data already in the buffer) share the block.
+  struct Chunk {
+    Block block;
+    size_t offset;
+    size_t size;
+
+    std::string_view View() const { return std::string_view(*block).substr(offset, size); }
+  };
+
+  // Remove all the chunks and timestamps before `pos`, trim the chunk that straddles it, and move
+  // the head up to `pos`.
+  void DropBefore(size_t pos);
+
+  // Return the end (exclusive) of the contiguous chunks that start at the first chunk.
+  std::map<size_t, Chunk>::iterator ContiguousEnd();
+
+  // Position of the first byte in the rope. The rope must not be empty.
+  size_t FirstChunkPos() const;
+
+  const size_t capacity_;
+
+  // Logical position of the head of the buffer.
+  size_t head_position_ = 0;
+
+  // Map of chunk start positions to chunks. Chunks never overlap, but adjacent chunks are only
+  // fused when Head() is called.
+  std::map<size_t, Chunk> chunks_;
+  size_t size_ = 0;
+
+  // Map of event start positions to timestamps.
+  std::map<size_t, uint64_t> timestamps_;
+
+  // Total bytes copied by Head().
+  size_t coalesced_bytes_ = 0;
+};
+
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
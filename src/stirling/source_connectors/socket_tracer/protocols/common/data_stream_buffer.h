@@ -23,10 +23,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "src/common/base/base.h"
 
 DECLARE_bool(stirling_data_stream_buffer_always_contiguous_buffer);
+DECLARE_bool(stirling_data_stream_buffer_chunked_buffer);
 
 namespace px {
 namespace stirling {
@@ -39,6 +41,14 @@ class DataStreamBufferImpl {
   virtual ~DataStreamBufferImpl() = default;
   virtual void Add(size_t pos, std::string_view data, uint64_t timestamp) = 0;
   virtual std::string_view Head() = 0;
+  // Implementations that don't store the data in chunks return Head() as a single chunk.
+  virtual std::vector<std::string_view> HeadChunks() {
+    std::string_view head = Head();
+    if (head.empty()) {
+      return {};
+    }
+    return {head};
+  }
   virtual StatusOr<uint64_t> GetTimestamp(size_t pos) const = 0;
   virtual void RemovePrefix(ssize_t n) = 0;
   virtual void Trim() = 0;
@@ -49,6 +59,8 @@ class DataStreamBufferImpl {
   virtual std::string DebugInfo() const = 0;
   virtual void Reset() = 0;
   virtual void ShrinkToFit() = 0;
+  // Bytes copied by Head() to make chunks contiguous. Only the chunked implementation counts them.
+  virtual size_t coalesced_bytes() const { return 0; }
 };
 
 /**
@@ -64,8 +76,9 @@ class DataStreamBufferImpl {
  * DataStreamBuffer supports data arriving out-of-order such that they are slotted into the middle
  * of the buffer.
  *
- * The underlying implementation is currently a simple string buffer, but this could be changed
- * in the future, as long as the data is maintained in a contiguous buffer.
+ * The underlying implementation is selected by flags: a single string buffer that is always
+ * contiguous, a buffer that is made contiguous lazily on Head(), or a rope of chunks that is only
+ * made contiguous when Head() (rather than HeadChunks()) is called.
  */
 class DataStreamBuffer {
  public:
@@ -90,6 +103,15 @@ class DataStreamBuffer {
    */
   std::string_view Head() { return impl_->Head(); }
 
+  /**
+   * Get all the contiguous data at the head of the buffer, as a list of chunks in position order.
+   * With the chunked implementation, this doesn't copy the data to make it contiguous, unlike
+   * Head(); use a ChunkedBinaryDecoder to parse it. The views are valid until the next call that
+   * modifies the buffer.
+   * @return The string_views of the chunks.
+   */
+  std::vector<std::string_view> HeadChunks() { return impl_->HeadChunks(); }
+
   /**
    * Get timestamp recorded for the data at the specified position.
    * @param pos The logical position of the data.
@@ -146,6 +168,12 @@ class DataStreamBuffer {
    */
   void ShrinkToFit() { impl_->ShrinkToFit(); }
 
+  /**
+   * Total bytes that Head() has copied to make the head contiguous, with the chunked
+   * implementation. Always 0 with the others.
+   */
+  size_t coalesced_bytes() const { return impl_->coalesced_bytes(); }
+
  private:
   std::unique_ptr<DataStreamBufferImpl> impl_;
 };
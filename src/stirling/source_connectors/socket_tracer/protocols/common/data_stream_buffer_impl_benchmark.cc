@@ -18,12 +18,18 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <numeric>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "src/common/base/base.h"
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/always_contiguous_data_stream_buffer_impl.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/common/chunked_data_stream_buffer_impl.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/lazy_contiguous_data_stream_buffer_impl.h"
+#include "src/stirling/utils/binary_decoder.h"
 
 template <typename TDataStreamBufferImpl>
 // NOLINTNEXTLINE : runtime/references.
@@ -229,7 +235,108 @@ static void BM_RemovePrefix(benchmark::State& state) {
   }
 }
 
+// Generate a stream of length-prefixed frames (a 4 byte big-endian length, followed by the body),
+// like the ones of Kafka, split into BPF sized events.
+static std::vector<std::string> GenFrameStreamEvents(size_t frame_size, size_t stream_size,
+                                                     size_t event_size) {
+  std::string frame(4, '\0');
+  uint32_t body_size = frame_size - 4;
+  for (int i = 0; i < 4; ++i) {
+    frame[i] = static_cast<char>(body_size >> (8 * (3 - i)));
+  }
+  frame.append(body_size, 'x');
+
+  std::string stream;
+  while (stream.size() + frame.size() <= stream_size) {
+    stream.append(frame);
+  }
+
+  std::vector<std::string> events;
+  for (size_t pos = 0; pos < stream.size(); pos += event_size) {
+    events.push_back(stream.substr(pos, event_size));
+  }
+  return events;
+}
+
+// Parse and remove all the complete frames at the head of the buffer. If kUseHeadChunks, the
+// frames are parsed in place with a ChunkedBinaryDecoder, instead of from a contiguous Head().
+template <bool kUseHeadChunks, typename TDataStreamBufferImpl>
+static size_t ConsumeFrames(TDataStreamBufferImpl* stream_buffer) {
+  size_t consumed = 0;
+  if constexpr (kUseHeadChunks) {
+    px::stirling::ChunkedBinaryDecoder decoder(stream_buffer->HeadChunks());
+    while (decoder.BufSize() >= 4) {
+      uint32_t body_size = decoder.ExtractInt<uint32_t>().ValueOrDie();
+      auto body = decoder.ExtractChunks(body_size);
+      if (!body.ok()) {
+        break;
+      }
+      benchmark::DoNotOptimize(body.ValueOrDie());
+      consumed += 4 + body_size;
+    }
+  } else {
+    px::stirling::BinaryDecoder decoder(stream_buffer->Head());
+    while (decoder.BufSize() >= 4) {
+      uint32_t body_size = decoder.ExtractInt<uint32_t>().ValueOrDie();
+      auto body = decoder.ExtractString(body_size);
+      if (!body.ok()) {
+        break;
+      }
+      benchmark::DoNotOptimize(body.ValueOrDie());
+      consumed += 4 + body_size;
+    }
+  }
+  stream_buffer->RemovePrefix(consumed);
+  return consumed;
+}
+
+// A large stream of frames, whose events arrive in polling iterations, and are parsed after each
+// iteration. Within an iteration, the events arrive out-of-order if state.range(1) is non-zero:
+// they are shuffled within windows of that many events, like the events of different CPUs.
+// state.range(0) is the frame size.
+template <typename TDataStreamBufferImpl, bool kUseHeadChunks = false>
+// NOLINTNEXTLINE : runtime/references.
+static void BM_LargeStreamFrames(benchmark::State& state) {
+  size_t capacity = 50 * 1024 * 1024;
+  size_t max_gap_size = 10 * 1024 * 1024;
+  size_t allow_before_gap_size = 1 * 1024 * 1024;
+
+  const size_t kEventSize = 30 * 1024;
+  const size_t kStreamSize = 200 * 1024 * 1024;
+  const size_t kEventsPerIteration = 64;
+  const size_t reorder_window = state.range(1);
+
+  std::vector<std::string> events = GenFrameStreamEvents(state.range(0), kStreamSize, kEventSize);
+  std::vector<size_t> order(events.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (reorder_window > 1) {
+    std::minstd_rand0 gen(0);
+    for (size_t i = 0; i < order.size(); i += reorder_window) {
+      std::shuffle(order.begin() + i, order.begin() + std::min(i + reorder_window, order.size()),
+                   gen);
+    }
+  }
+
+  size_t consumed = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    TDataStreamBufferImpl stream_buffer(capacity, max_gap_size, allow_before_gap_size);
+    state.ResumeTiming();
+
+    for (size_t i = 0; i < order.size(); ++i) {
+      size_t idx = order[i];
+      stream_buffer.Add(idx * kEventSize, events[idx], idx);
+      if ((i + 1) % kEventsPerIteration == 0) {
+        consumed += ConsumeFrames<kUseHeadChunks>(&stream_buffer);
+      }
+    }
+    consumed += ConsumeFrames<kUseHeadChunks>(&stream_buffer);
+  }
+  state.SetBytesProcessed(consumed);
+}
+
 using px::stirling::protocols::AlwaysContiguousDataStreamBufferImpl;
+using px::stirling::protocols::ChunkedDataStreamBufferImpl;
 using px::stirling::protocols::LazyContiguousDataStreamBufferImpl;
 
 BENCHMARK_TEMPLATE(BM_ContiguousBytes, LazyContiguousDataStreamBufferImpl)
@@ -238,9 +345,13 @@ BENCHMARK_TEMPLATE(BM_ContiguousBytes, LazyContiguousDataStreamBufferImpl)
 BENCHMARK_TEMPLATE(BM_ContiguousBytes, AlwaysContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ContiguousBytes, ChunkedDataStreamBufferImpl)
+    ->Range(1024, 32 * 1024)
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_TEMPLATE(BM_SingleAdd, LazyContiguousDataStreamBufferImpl)->Range(1024, 32 * 1024);
 BENCHMARK_TEMPLATE(BM_SingleAdd, AlwaysContiguousDataStreamBufferImpl)->Range(1024, 32 * 1024);
+BENCHMARK_TEMPLATE(BM_SingleAdd, ChunkedDataStreamBufferImpl)->Range(1024, 32 * 1024);
 
 BENCHMARK_TEMPLATE(BM_OoOBytes, LazyContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
@@ -248,6 +359,9 @@ BENCHMARK_TEMPLATE(BM_OoOBytes, LazyContiguousDataStreamBufferImpl)
 BENCHMARK_TEMPLATE(BM_OoOBytes, AlwaysContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OoOBytes, ChunkedDataStreamBufferImpl)
+    ->Range(1024, 32 * 1024)
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_TEMPLATE(BM_OverrunCapacity, LazyContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
@@ -255,6 +369,9 @@ BENCHMARK_TEMPLATE(BM_OverrunCapacity, LazyContiguousDataStreamBufferImpl)
 BENCHMARK_TEMPLATE(BM_OverrunCapacity, AlwaysContiguousDataStreamBufferImpl)
     ->Range(32 * 1024, 32 * 1024)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OverrunCapacity, ChunkedDataStreamBufferImpl)
+    ->Range(1024, 32 * 1024)
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_TEMPLATE(BM_LargeGap, LazyContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
@@ -262,6 +379,9 @@ BENCHMARK_TEMPLATE(BM_LargeGap, LazyContiguousDataStreamBufferImpl)
 BENCHMARK_TEMPLATE(BM_LargeGap, AlwaysContiguousDataStreamBufferImpl)
     ->Range(32 * 1024, 32 * 1024)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LargeGap, ChunkedDataStreamBufferImpl)
+    ->Range(1024, 32 * 1024)
+    ->Unit(benchmark::kMillisecond);
 
 BENCHMARK_TEMPLATE(BM_RemovePrefix, LazyContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
@@ -269,3 +389,32 @@ BENCHMARK_TEMPLATE(BM_RemovePrefix, LazyContiguousDataStreamBufferImpl)
 BENCHMARK_TEMPLATE(BM_RemovePrefix, AlwaysContiguousDataStreamBufferImpl)
     ->Range(1024, 32 * 1024)
     ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_RemovePrefix, ChunkedDataStreamBufferImpl)
+    ->Range(1024, 32 * 1024)
+    ->Unit(benchmark::kMillisecond);
+
+// Args are {frame size, reorder window}.
+BENCHMARK_TEMPLATE(BM_LargeStreamFrames, LazyContiguousDataStreamBufferImpl)
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 8})
+    ->Args({1024 * 1024, 0})
+    ->Args({1024 * 1024, 8})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LargeStreamFrames, AlwaysContiguousDataStreamBufferImpl)
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 8})
+    ->Args({1024 * 1024, 0})
+    ->Args({1024 * 1024, 8})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LargeStreamFrames, ChunkedDataStreamBufferImpl)
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 8})
+    ->Args({1024 * 1024, 0})
+    ->Args({1024 * 1024, 8})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LargeStreamFrames, ChunkedDataStreamBufferImpl, true)
+    ->Args({16 * 1024, 0})
+    ->Args({16 * 1024, 8})
+    ->Args({1024 * 1024, 0})
+    ->Args({1024 * 1024, 8})
+    ->Unit(benchmark::kMillisecond);
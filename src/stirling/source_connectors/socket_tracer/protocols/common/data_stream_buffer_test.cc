@@ -18,24 +18,41 @@
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/data_stream_buffer.h"
 
+#include <absl/strings/str_join.h>
+
 #include "src/common/testing/testing.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/common/chunked_data_stream_buffer_impl.h"
 
 namespace px {
 namespace stirling {
 namespace protocols {
 
-class DataStreamBufferTest : public ::testing::TestWithParam<bool> {
+using ::testing::ElementsAre;
+
+enum class DataStreamBufferImplType {
+  kAlwaysContiguous,
+  kLazyContiguous,
+  kChunked,
+};
+
+class DataStreamBufferTest : public ::testing::TestWithParam<DataStreamBufferImplType> {
  protected:
   void SetUp() override {
-    old_flag_val_ = FLAGS_stirling_data_stream_buffer_always_contiguous_buffer;
-    FLAGS_stirling_data_stream_buffer_always_contiguous_buffer = GetParam();
+    old_always_contiguous_flag_val_ = FLAGS_stirling_data_stream_buffer_always_contiguous_buffer;
+    old_chunked_flag_val_ = FLAGS_stirling_data_stream_buffer_chunked_buffer;
+    FLAGS_stirling_data_stream_buffer_always_contiguous_buffer =
+        GetParam() == DataStreamBufferImplType::kAlwaysContiguous;
+    FLAGS_stirling_data_stream_buffer_chunked_buffer =
+        GetParam() == DataStreamBufferImplType::kChunked;
   }
   void TearDown() override {
-    FLAGS_stirling_data_stream_buffer_always_contiguous_buffer = old_flag_val_;
+    FLAGS_stirling_data_stream_buffer_always_contiguous_buffer = old_always_contiguous_flag_val_;
+    FLAGS_stirling_data_stream_buffer_chunked_buffer = old_chunked_flag_val_;
   }
 
  private:
-  bool old_flag_val_;
+  bool old_always_contiguous_flag_val_;
+  bool old_chunked_flag_val_;
 };
 
 TEST_P(DataStreamBufferTest, AddAndGet) {
@@ -200,7 +217,7 @@ TEST_P(DataStreamBufferTest, SizeAndGetPos) {
   // size() is different between the two current implementations (the new impl does not
   // include the gap in size, the old one does).
   // TODO(james): remove one of the two checks when we settle on an implementation.
-  if (FLAGS_stirling_data_stream_buffer_always_contiguous_buffer) {
+  if (GetParam() == DataStreamBufferImplType::kAlwaysContiguous) {
     EXPECT_EQ(stream_buffer.size(), 10);
   } else {
     EXPECT_EQ(stream_buffer.size(), 6);
@@ -253,7 +270,7 @@ TEST_P(DataStreamBufferTest, LargeGap) {
   // These tests only apply to the old implementation, the new implementation will keep all of this
   // data in its buffer, since it doesn't allocate gaps.
   // TODO(james): remove when we settle on an implementation.
-  if (FLAGS_stirling_data_stream_buffer_always_contiguous_buffer) {
+  if (GetParam() == DataStreamBufferImplType::kAlwaysContiguous) {
     EXPECT_EQ(stream_buffer.size(), 4 + kAllowBeforeGapSize);
 
     // Add event more than allow_before_gap_size before the last event. This event should not be
@@ -268,16 +285,78 @@ TEST_P(DataStreamBufferTest, LargeGap) {
   }
 }
 
+TEST_P(DataStreamBufferTest, HeadChunks) {
+  DataStreamBuffer stream_buffer(15, 15, 15);
+
+  EXPECT_TRUE(stream_buffer.HeadChunks().empty());
+
+  stream_buffer.Add(0, "0123", 0);
+  stream_buffer.Add(6, "67", 6);
+  stream_buffer.Add(4, "45", 4);
+  stream_buffer.Add(10, "ab", 10);
+  EXPECT_EQ(absl::StrJoin(stream_buffer.HeadChunks(), ""), "01234567");
+
+  stream_buffer.RemovePrefix(3);
+  EXPECT_EQ(absl::StrJoin(stream_buffer.HeadChunks(), ""), "34567");
+  EXPECT_EQ(stream_buffer.Head(), "34567");
+  EXPECT_EQ(absl::StrJoin(stream_buffer.HeadChunks(), ""), "34567");
+}
+
 INSTANTIATE_TEST_SUITE_P(DataStreamBufferImplTest, DataStreamBufferTest,
-                         ::testing::Values(true, false),
+                         ::testing::Values(DataStreamBufferImplType::kAlwaysContiguous,
+                                           DataStreamBufferImplType::kLazyContiguous,
+                                           DataStreamBufferImplType::kChunked),
                          [](const ::testing::TestParamInfo<DataStreamBufferTest::ParamType>& info) {
-                           if (info.param) {
-                             return "AlwaysContiguousImpl";
-                           } else {
-                             return "LazyContiguousImpl";
+                           switch (info.param) {
+                             case DataStreamBufferImplType::kAlwaysContiguous:
+                               return "AlwaysContiguousImpl";
+                             case DataStreamBufferImplType::kLazyContiguous:
+                               return "LazyContiguousImpl";
+                             case DataStreamBufferImplType::kChunked:
+                               return "ChunkedImpl";
                            }
+                           return "Unknown";
                          });
 
+// The chunked impl only makes the head contiguous when Head() is called, and never copies the data
+// for HeadChunks() or RemovePrefix().
+TEST(ChunkedDataStreamBufferImplTest, CoalesceOnlyOnHead) {
+  ChunkedDataStreamBufferImpl stream_buffer(1024);
+
+  stream_buffer.Add(4, "4567", 4);
+  stream_buffer.Add(0, "0123", 0);
+  stream_buffer.Add(8, "89", 8);
+  EXPECT_THAT(stream_buffer.HeadChunks(), ElementsAre("0123", "4567", "89"));
+  EXPECT_EQ(stream_buffer.num_chunks(), 3);
+
+  stream_buffer.RemovePrefix(5);
+  EXPECT_THAT(stream_buffer.HeadChunks(), ElementsAre("567", "89"));
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(5), 4);
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(8), 8);
+
+  EXPECT_EQ(stream_buffer.Head(), "56789");
+  EXPECT_EQ(stream_buffer.num_chunks(), 1);
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(7), 4);
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(9), 8);
+}
+
+// Overlapping events only fill the gaps around the data that is already in the buffer.
+TEST(ChunkedDataStreamBufferImplTest, OverlappingEvents) {
+  ChunkedDataStreamBufferImpl stream_buffer(1024);
+
+  stream_buffer.Add(2, "23", 2);
+  stream_buffer.Add(6, "67", 6);
+  stream_buffer.Add(0, "0123456789", 0);
+  EXPECT_THAT(stream_buffer.HeadChunks(), ElementsAre("01", "23", "45", "67", "89"));
+  EXPECT_EQ(stream_buffer.size(), 10);
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(3), 2);
+  EXPECT_OK_AND_EQ(stream_buffer.GetTimestamp(4), 0);
+
+  stream_buffer.ShrinkToFit();
+  EXPECT_EQ(stream_buffer.capacity(), 10);
+  EXPECT_EQ(stream_buffer.Head(), "0123456789");
+}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
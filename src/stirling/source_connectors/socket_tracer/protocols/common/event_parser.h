@@ -100,6 +100,16 @@ template <typename TFrameType, typename TStateType = NoState>
 ParseResult ParseFrames(message_type_t type, DataStreamBuffer* data_stream_buffer,
                         std::deque<TFrameType>* frames, bool resync = false,
                         TStateType* state = nullptr) {
+  if (!resync &&
+      FrameNeedsMoreData<TFrameType, TStateType>(type, data_stream_buffer->HeadChunks(), state)) {
+    ParseResult result;
+    result.end_position = 0;
+    result.state = ParseState::kNeedsMoreData;
+    result.invalid_frames = 0;
+    result.frame_bytes = 0;
+    return result;
+  }
+
   std::string_view buf = data_stream_buffer->Head();
 
   size_t start_pos = 0;
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -73,6 +74,7 @@ struct NoState {
 };
 
 // NOTE: FindFrameBoundary(), ParseFrame(), and StitchFrames() must be implemented per protocol.
+// FrameNeedsMoreData() is optional.
 
 /**
  * Attempt to find the next frame boundary.
@@ -103,6 +105,29 @@ template <typename TFrameType, typename TStateType = NoState>
 ParseState ParseFrame(message_type_t type, std::string_view* buf, TFrameType* frame,
                       TStateType* state = nullptr);
 
+/**
+ * Checks from a bounded prefix of the contiguous data at the head of a stream whether the first
+ * frame is still incomplete, so that ParseFrames() can skip making the head contiguous (see
+ * DataStreamBuffer::Head()) every time another part of a large frame arrives.
+ *
+ * The default never skips. Protocols may specialize it; the specialization must be declared next
+ * to the protocol's ProtocolTraits (in its types.h), so that it is visible wherever ParseFrames()
+ * is instantiated.
+ *
+ * @tparam TFrameType Type of frame to parse.
+ * @param type Whether to process frame as a request or response.
+ * @param head_chunks The contiguous data at the head of the stream, see
+ * DataStreamBuffer::HeadChunks().
+ *
+ * @return true only if ParseFrame() would return kNeedsMoreData for the first frame.
+ */
+template <typename TFrameType, typename TStateType = NoState>
+bool FrameNeedsMoreData(message_type_t /*type*/,
+                        const std::vector<std::string_view>& /*head_chunks*/,
+                        TStateType* /*state*/ = nullptr) {
+  return false;
+}
+
 /**
  * StitchFrames is the entry point of stitcher for all protocols. It loops through the responses,
  * matches them with the corresponding requests, and returns stitched request & response pairs.
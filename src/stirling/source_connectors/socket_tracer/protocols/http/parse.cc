@@ -18,16 +18,23 @@
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/parse.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/body_decoder.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/picohttpparser_sse42.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/simd_search.h"
 
 #include <picohttpparser.h>
 
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 DEFINE_int32(http_body_limit_bytes, 1024,
              "The amount of an HTTP body that will be returned on a parse");
 
+// FrameNeedsMoreData() parses the headers from at most this many bytes at the head of the stream.
+// Messages with larger headers are always parsed from the contiguous head.
+constexpr size_t kMaxHeadersPeekBytes = 16 * 1024;
+
 namespace px {
 namespace stirling {
 namespace protocols {
@@ -51,6 +58,13 @@ struct HTTPRequest {
 };
 
 int ParseRequest(std::string_view buf, HTTPRequest* result) {
+#if defined(__x86_64__)
+  if (UseSSE42()) {
+    return phr_sse42_parse_request(buf.data(), buf.size(), &result->method, &result->method_len,
+                                   &result->path, &result->path_len, &result->minor_version,
+                                   result->headers, &result->num_headers, /*last_len*/ 0);
+  }
+#endif
   return phr_parse_request(buf.data(), buf.size(), &result->method, &result->method_len,
                            &result->path, &result->path_len, &result->minor_version,
                            result->headers, &result->num_headers, /*last_len*/ 0);
@@ -69,6 +83,13 @@ struct HTTPResponse {
 };
 
 int ParseResponse(std::string_view buf, HTTPResponse* result) {
+#if defined(__x86_64__)
+  if (UseSSE42()) {
+    return phr_sse42_parse_response(buf.data(), buf.size(), &result->minor_version,
+                                    &result->status, &result->msg, &result->msg_len,
+                                    result->headers, &result->num_headers, /*last_len*/ 0);
+  }
+#endif
   return phr_parse_response(buf.data(), buf.size(), &result->minor_version, &result->status,
                             &result->msg, &result->msg_len, result->headers, &result->num_headers,
                             /*last_len*/ 0);
@@ -323,7 +344,7 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
   // Note that we don't search forwards for HTTP/1.1 directly, because it could result in matches
   // inside the request/response body.
   while (true) {
-    size_t marker_pos = buf.find(kBoundaryMarker, start_pos);
+    size_t marker_pos = FindSubstr(buf, kBoundaryMarker, start_pos);
 
     if (marker_pos == std::string::npos) {
       return std::string::npos;
@@ -331,17 +352,9 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
 
     std::string_view buf_substr = buf.substr(start_pos, marker_pos - start_pos);
 
-    size_t substr_pos = std::string::npos;
-    for (auto& start_pattern : *start_patterns) {
-      size_t current_substr_pos = buf_substr.rfind(start_pattern);
-      if (current_substr_pos != std::string::npos) {
-        // Found a match. Check if it is closer to the marker than our previous match.
-        // We want to return the match that is closest to the marker, so we aren't
-        // matching to something in a previous message's body.
-        substr_pos = (substr_pos == std::string::npos) ? current_substr_pos
-                                                       : std::max(substr_pos, current_substr_pos);
-      }
-    }
+    // Find the match that is closest to the marker, so we aren't matching to something in a
+    // previous message's body.
+    size_t substr_pos = RFindAny(buf_substr, *start_patterns);
 
     if (substr_pos != std::string::npos) {
       return start_pos + substr_pos;
@@ -352,6 +365,88 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
   }
 }
 
+bool FrameNeedsMoreData(message_type_t type, const std::vector<std::string_view>& head_chunks,
+                        const State& state) {
+  if (head_chunks.empty()) {
+    return false;
+  }
+  size_t head_size = 0;
+  for (std::string_view chunk : head_chunks) {
+    head_size += chunk.size();
+  }
+
+  // Parse the headers from the first chunk if it's large enough, and otherwise from a copy of a
+  // bounded prefix of the head.
+  std::string_view prefix = head_chunks.front();
+  std::string prefix_copy;
+  if (prefix.size() < std::min(head_size, kMaxHeadersPeekBytes)) {
+    prefix_copy.reserve(std::min(head_size, kMaxHeadersPeekBytes));
+    for (std::string_view chunk : head_chunks) {
+      size_t n = std::min(chunk.size(), kMaxHeadersPeekBytes - prefix_copy.size());
+      prefix_copy.append(chunk.substr(0, n));
+      if (prefix_copy.size() == kMaxHeadersPeekBytes) {
+        break;
+      }
+    }
+    prefix = prefix_copy;
+  }
+
+  int retval;
+  HeadersMap headers;
+  switch (type) {
+    case message_type_t::kRequest: {
+      pico_wrapper::HTTPRequest req;
+      retval = pico_wrapper::ParseRequest(prefix, &req);
+      if (retval >= 0) {
+        headers = pico_wrapper::GetHTTPHeadersMap(req.headers, req.num_headers);
+      }
+    } break;
+    case message_type_t::kResponse: {
+      pico_wrapper::HTTPResponse resp;
+      retval = pico_wrapper::ParseResponse(prefix, &resp);
+      if (retval >= 0) {
+        headers = pico_wrapper::GetHTTPHeadersMap(resp.headers, resp.num_headers);
+      }
+    } break;
+    default:
+      return false;
+  }
+
+  if (retval == -2) {
+    // The headers are incomplete. Unless they're cut off by the prefix, so is the message.
+    return prefix.size() == head_size;
+  }
+  if (retval < 0) {
+    return false;
+  }
+
+  const auto content_length_iter = headers.find(kContentLength);
+  size_t content_length;
+  if (content_length_iter == headers.end() ||
+      !absl::SimpleAtoi(content_length_iter->second, &content_length)) {
+    return false;
+  }
+  if (retval + content_length <= head_size) {
+    return false;
+  }
+
+  if (type == message_type_t::kResponse) {
+    // ParseResponseBody() takes a response that is followed by another one, or by the close of
+    // the connection, as a response to a HEAD request, without a body.
+    if (state.conn_closed) {
+      return false;
+    }
+    std::string_view rest = prefix.substr(retval);
+    if (rest.size() < 4 && prefix.size() < head_size) {
+      return false;
+    }
+    if (absl::StartsWith(rest, "HTTP")) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace http
 
 template <>
@@ -366,6 +461,13 @@ size_t FindFrameBoundary<http::Message>(message_type_t type, std::string_view bu
   return http::FindFrameBoundary(type, buf, start_pos);
 }
 
+template <>
+bool FrameNeedsMoreData<http::Message>(message_type_t type,
+                                       const std::vector<std::string_view>& head_chunks,
+                                       http::StateWrapper* state) {
+  return http::FrameNeedsMoreData(type, head_chunks, state->global);
+}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
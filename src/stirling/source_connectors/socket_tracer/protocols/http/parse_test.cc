@@ -333,6 +333,34 @@ TEST_F(HTTPParserTest, PartialBody) {
   EXPECT_THAT(parsed_messages, IsEmpty());
 }
 
+TEST_F(HTTPParserTest, FrameNeedsMoreData) {
+  StateWrapper state{};
+  auto needs_more_data = [&state](message_type_t type, std::vector<std::string_view> chunks) {
+    return protocols::FrameNeedsMoreData<Message>(type, chunks, &state);
+  };
+
+  // Partial body, with the headers split across chunks.
+  EXPECT_TRUE(needs_more_data(message_type_t::kResponse,
+                              {"HTTP/1.1 200 OK\r\nContent-Len", "gth: 40\r\n\r\n", "Foo"}));
+  EXPECT_TRUE(needs_more_data(message_type_t::kRequest,
+                              {"POST /foo HTTP/1.1\r\nContent-Length: 4\r\n\r\n", "abc"}));
+  // Partial headers.
+  EXPECT_TRUE(needs_more_data(message_type_t::kResponse, {"HTTP/1.1 200 OK\r\n", "Content-"}));
+
+  // Complete messages.
+  EXPECT_FALSE(needs_more_data(message_type_t::kResponse,
+                               {"HTTP/1.1 200 OK\r\nContent-Length: 3\r\n\r\n", "Foo"}));
+  EXPECT_FALSE(needs_more_data(message_type_t::kRequest, {kHTTPGetReq0}));
+  // The body length isn't known from the headers.
+  EXPECT_FALSE(needs_more_data(message_type_t::kResponse, {HTTPRespWithChunkedBody({"b"})}));
+  // Response to a HEAD request, followed by the next response.
+  EXPECT_FALSE(needs_more_data(message_type_t::kResponse,
+                               {"HTTP/1.1 200 OK\r\nContent-Length: 40\r\n\r\n", "HTTP/1.1"}));
+  state.global.conn_closed = true;
+  EXPECT_FALSE(needs_more_data(message_type_t::kResponse,
+                               {"HTTP/1.1 200 OK\r\nContent-Length: 40\r\n\r\n", "Foo"}));
+}
+
 TEST_F(HTTPParserTest, Status101) {
   StateWrapper state{};
   std::string switch_protocol_msg =
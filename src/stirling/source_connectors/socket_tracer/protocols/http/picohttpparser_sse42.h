@@ -0,0 +1,34 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <picohttpparser.h>
+
+#if defined(__x86_64__)
+// picohttpparser built a second time with SSE4.2 and phr_sse42_ symbol names, see
+// bazel/external/picohttpparser.BUILD. Only call these if UseSSE42() is true.
+extern "C" {
+int phr_sse42_parse_request(const char* buf, size_t len, const char** method, size_t* method_len,
+                            const char** path, size_t* path_len, int* minor_version,
+                            struct phr_header* headers, size_t* num_headers, size_t last_len);
+int phr_sse42_parse_response(const char* buf, size_t len, int* minor_version, int* status,
+                             const char** msg, size_t* msg_len, struct phr_header* headers,
+                             size_t* num_headers, size_t last_len);
+}
+#endif
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/picohttpparser_sse42.h"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+namespace px {
+namespace stirling {
+namespace protocols {
+namespace http {
+
+#if defined(__x86_64__)
+
+constexpr size_t kMaxNumHeaders = 50;
+
+// Links both builds of picohttpparser into one binary, which fails if the phr_sse42_ renames
+// missed a symbol, and checks that they parse the same way.
+TEST(PicoHTTPParserSSE42Test, ParseRequestMatchesBaseline) {
+  if (!__builtin_cpu_supports("sse4.2")) {
+    GTEST_SKIP() << "The CPU doesn't support SSE4.2";
+  }
+  // Long enough header values for the SSE4.2 tokenizer to take 16 byte strides.
+  constexpr std::string_view kReq =
+      "GET /api/v1/objects?limit=100 HTTP/1.1\r\n"
+      "Host: www.pixielabs.ai\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36\r\n"
+      "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+      "\r\n";
+
+  const char* method[2];
+  size_t method_len[2];
+  const char* path[2];
+  size_t path_len[2];
+  int minor_version[2];
+  struct phr_header headers[2][kMaxNumHeaders];
+  size_t num_headers[2] = {kMaxNumHeaders, kMaxNumHeaders};
+
+  int retval = phr_parse_request(kReq.data(), kReq.size(), &method[0], &method_len[0], &path[0],
+                                 &path_len[0], &minor_version[0], headers[0], &num_headers[0],
+                                 /*last_len*/ 0);
+  int sse42_retval = phr_sse42_parse_request(kReq.data(), kReq.size(), &method[1], &method_len[1],
+                                             &path[1], &path_len[1], &minor_version[1], headers[1],
+                                             &num_headers[1], /*last_len*/ 0);
+
+  EXPECT_EQ(retval, kReq.size());
+  EXPECT_EQ(sse42_retval, retval);
+  EXPECT_EQ(std::string_view(path[1], path_len[1]), "/api/v1/objects?limit=100");
+  ASSERT_EQ(num_headers[1], 3);
+  ASSERT_EQ(num_headers[0], num_headers[1]);
+  for (size_t i = 0; i < num_headers[0]; ++i) {
+    EXPECT_EQ(std::string_view(headers[1][i].name, headers[1][i].name_len),
+              std::string_view(headers[0][i].name, headers[0][i].name_len));
+    EXPECT_EQ(std::string_view(headers[1][i].value, headers[1][i].value_len),
+              std::string_view(headers[0][i].value, headers[0][i].value_len));
+  }
+}
+
+TEST(PicoHTTPParserSSE42Test, ParseResponseMatchesBaseline) {
+  if (!__builtin_cpu_supports("sse4.2")) {
+    GTEST_SKIP() << "The CPU doesn't support SSE4.2";
+  }
+  constexpr std::string_view kResp =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: application/json; charset=utf-8\r\n"
+      "Content-Length: 0\r\n"
+      "\r\n";
+
+  int minor_version[2];
+  int status[2];
+  const char* msg[2];
+  size_t msg_len[2];
+  struct phr_header headers[2][kMaxNumHeaders];
+  size_t num_headers[2] = {kMaxNumHeaders, kMaxNumHeaders};
+
+  int retval = phr_parse_response(kResp.data(), kResp.size(), &minor_version[0], &status[0],
+                                  &msg[0], &msg_len[0], headers[0], &num_headers[0],
+                                  /*last_len*/ 0);
+  int sse42_retval = phr_sse42_parse_response(kResp.data(), kResp.size(), &minor_version[1],
+                                              &status[1], &msg[1], &msg_len[1], headers[1],
+                                              &num_headers[1], /*last_len*/ 0);
+
+  EXPECT_EQ(retval, kResp.size());
+  EXPECT_EQ(sse42_retval, retval);
+  EXPECT_EQ(status[1], 200);
+  EXPECT_EQ(num_headers[1], 2);
+  EXPECT_EQ(std::string_view(headers[1][0].value, headers[1][0].value_len),
+            "application/json; charset=utf-8");
+}
+
+#endif
+
+}  // namespace http
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,267 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/simd_search.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+DEFINE_bool(http_parse_use_simd, true,
+            "If true, the HTTP parser uses its SSE/AVX2 code paths on the CPUs that support them; "
+            "otherwise it only uses the scalar code.");
+
+namespace px {
+namespace stirling {
+namespace protocols {
+namespace http {
+
+namespace {
+
+SIMDLevel max_simd_level = SIMDLevel::kAVX2;
+
+size_t ScalarRFindAny(std::string_view buf, ArrayView<std::string_view> patterns) {
+  size_t res = std::string_view::npos;
+  for (const auto& pattern : patterns) {
+    size_t pos = buf.rfind(pattern);
+    if (pos != std::string_view::npos && (res == std::string_view::npos || pos > res)) {
+      res = pos;
+    }
+  }
+  return res;
+}
+
+}  // namespace
+
+void SetMaxSIMDLevelForTesting(SIMDLevel level) { max_simd_level = level; }
+
+#if defined(__x86_64__)
+
+namespace {
+
+// The vectorized RFindAny keeps two registers per pattern.
+constexpr size_t kMaxVectorizedPatterns = 16;
+
+bool MatchesAnyAt(std::string_view buf, size_t pos, ArrayView<std::string_view> patterns) {
+  for (const auto& pattern : patterns) {
+    if (pattern.size() <= buf.size() - pos &&
+        memcmp(buf.data() + pos, pattern.data(), pattern.size()) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The vectorized searches filter candidate positions on 2 bytes of each pattern.
+bool VectorizablePatterns(ArrayView<std::string_view> patterns) {
+  if (patterns.size() == 0 || patterns.size() > kMaxVectorizedPatterns) {
+    return false;
+  }
+  for (const auto& pattern : patterns) {
+    if (pattern.size() < 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool UseAVX2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported && FLAGS_http_parse_use_simd;
+}
+
+bool UseSSE42() {
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported && FLAGS_http_parse_use_simd;
+}
+
+SIMDLevel ActiveSIMDLevel() {
+  if (!FLAGS_http_parse_use_simd) {
+    return SIMDLevel::kScalar;
+  }
+  // Every x86-64 CPU supports SSE2.
+  return std::min(UseAVX2() ? SIMDLevel::kAVX2 : SIMDLevel::kSSE2, max_simd_level);
+}
+
+// The searches are written once, in terms of a register type Vec of kLanes bytes and a few
+// operations on it, and are defined for AVX2 and for SSE2, which every x86-64 CPU supports.
+//
+// FindSubstr compares each block of buf with the first and the last byte of the needle, and only
+// compares the whole needle where both match. RFindAny compares each block with the first two
+// bytes of every pattern, and walks the blocks backwards, so that the first full match is the last
+// one in buf.
+#define PX_SIMD_SEARCH_FUNCTIONS(_attr_)                                                          \
+  _attr_ size_t FindSubstr(std::string_view buf, std::string_view needle, size_t pos) {         \
+    const size_t n = needle.size();                                                             \
+    const Vec first = Set1(needle.front());                                                     \
+    const Vec last = Set1(needle.back());                                                       \
+    size_t i = pos;                                                                             \
+    for (; i + n - 1 + kLanes <= buf.size(); i += kLanes) {                                     \
+      const char* p = buf.data() + i;                                                           \
+      uint32_t mask = MoveMask(And(CmpEq(first, Load(p)), CmpEq(last, Load(p + n - 1))));       \
+      while (mask != 0) {                                                                       \
+        size_t offset = __builtin_ctz(mask);                                                    \
+        if (memcmp(p + offset + 1, needle.data() + 1, n - 2) == 0) {                            \
+          return i + offset;                                                                    \
+        }                                                                                       \
+        mask &= mask - 1;                                                                       \
+      }                                                                                         \
+    }                                                                                           \
+    return buf.find(needle, i);                                                                 \
+  }                                                                                             \
+                                                                                                \
+  _attr_ size_t RFindAny(std::string_view buf, ArrayView<std::string_view> patterns) {          \
+    Vec firsts[kMaxVectorizedPatterns];                                                         \
+    Vec seconds[kMaxVectorizedPatterns];                                                        \
+    for (size_t k = 0; k < patterns.size(); ++k) {                                              \
+      firsts[k] = Set1(patterns[k][0]);                                                         \
+      seconds[k] = Set1(patterns[k][1]);                                                        \
+    }                                                                                           \
+    /* A pattern can't start at the last byte, so the candidates are [0, buf.size() - 1). */    \
+    size_t end = buf.empty() ? 0 : buf.size() - 1;                                              \
+    /* The last block starts at 0 and may overlap the one before it; its candidates at or */    \
+    /* after end were already checked. Only a buf of at most kLanes bytes is left to the */     \
+    /* scalar loop below. */                                                                    \
+    while (end > 0 && buf.size() > kLanes) {                                                    \
+      size_t begin = end >= kLanes ? end - kLanes : 0;                                          \
+      const char* p = buf.data() + begin;                                                       \
+      const Vec v0 = Load(p);                                                                   \
+      const Vec v1 = Load(p + 1);                                                               \
+      Vec matches = And(CmpEq(v0, firsts[0]), CmpEq(v1, seconds[0]));                           \
+      for (size_t k = 1; k < patterns.size(); ++k) {                                            \
+        matches = Or(matches, And(CmpEq(v0, firsts[k]), CmpEq(v1, seconds[k])));               \
+      }                                                                                         \
+      uint32_t mask = MoveMask(matches);                                                        \
+      if (end - begin < kLanes) {                                                               \
+        mask &= (1u << (end - begin)) - 1;                                                      \
+      }                                                                                         \
+      while (mask != 0) {                                                                       \
+        size_t offset = 31 - __builtin_clz(mask);                                               \
+        if (MatchesAnyAt(buf, begin + offset, patterns)) {                                      \
+          return begin + offset;                                                                \
+        }                                                                                       \
+        mask &= ~(1u << offset);                                                                \
+      }                                                                                         \
+      end = begin;                                                                              \
+    }                                                                                           \
+    for (size_t i = end; i > 0; --i) {                                                          \
+      if (MatchesAnyAt(buf, i - 1, patterns)) {                                                 \
+        return i - 1;                                                                           \
+      }                                                                                         \
+    }                                                                                           \
+    return std::string_view::npos;                                                              \
+  }
+
+namespace avx2 {
+
+// The functions in this namespace are compiled for AVX2 regardless of the target of the rest of
+// the build, so that a single binary can still run on older CPUs.
+#define PX_AVX2 __attribute__((target("avx2")))
+
+using Vec = __m256i;
+constexpr size_t kLanes = 32;
+
+PX_AVX2 inline Vec Set1(char c) { return _mm256_set1_epi8(c); }
+PX_AVX2 inline Vec Load(const char* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+PX_AVX2 inline Vec CmpEq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+PX_AVX2 inline Vec And(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+PX_AVX2 inline Vec Or(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+PX_AVX2 inline uint32_t MoveMask(Vec v) { return _mm256_movemask_epi8(v); }
+
+PX_SIMD_SEARCH_FUNCTIONS(PX_AVX2)
+
+#undef PX_AVX2
+
+}  // namespace avx2
+
+namespace sse2 {
+
+using Vec = __m128i;
+constexpr size_t kLanes = 16;
+
+inline Vec Set1(char c) { return _mm_set1_epi8(c); }
+inline Vec Load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline Vec CmpEq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+inline Vec And(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline Vec Or(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline uint32_t MoveMask(Vec v) { return _mm_movemask_epi8(v); }
+
+PX_SIMD_SEARCH_FUNCTIONS()
+
+}  // namespace sse2
+
+#undef PX_SIMD_SEARCH_FUNCTIONS
+
+size_t FindSubstr(std::string_view buf, std::string_view needle, size_t pos) {
+  if (needle.size() < 2 || pos > buf.size()) {
+    return buf.find(needle, pos);
+  }
+  switch (ActiveSIMDLevel()) {
+    case SIMDLevel::kAVX2:
+      return avx2::FindSubstr(buf, needle, pos);
+    case SIMDLevel::kSSE2:
+      return sse2::FindSubstr(buf, needle, pos);
+    case SIMDLevel::kScalar:
+      break;
+  }
+  return buf.find(needle, pos);
+}
+
+size_t RFindAny(std::string_view buf, ArrayView<std::string_view> patterns) {
+  if (!VectorizablePatterns(patterns)) {
+    return ScalarRFindAny(buf, patterns);
+  }
+  switch (ActiveSIMDLevel()) {
+    case SIMDLevel::kAVX2:
+      return avx2::RFindAny(buf, patterns);
+    case SIMDLevel::kSSE2:
+      return sse2::RFindAny(buf, patterns);
+    case SIMDLevel::kScalar:
+      break;
+  }
+  return ScalarRFindAny(buf, patterns);
+}
+
+#else
+
+bool UseAVX2() { return false; }
+bool UseSSE42() { return false; }
+SIMDLevel ActiveSIMDLevel() { return SIMDLevel::kScalar; }
+
+size_t FindSubstr(std::string_view buf, std::string_view needle, size_t pos) {
+  return buf.find(needle, pos);
+}
+
+size_t RFindAny(std::string_view buf, ArrayView<std::string_view> patterns) {
+  return ScalarRFindAny(buf, patterns);
+}
+
+#endif
+
+}  // namespace http
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <gflags/gflags.h>
+
+#include <string_view>
+
+#include "src/common/base/base.h"
+
+DECLARE_bool(http_parse_use_simd);
+
+namespace px {
+namespace stirling {
+namespace protocols {
+namespace http {
+
+/**
+ * Whether the CPU supports the instruction sets of the vectorized HTTP parsing paths. Always
+ * false on non-x86 CPUs, and if --http_parse_use_simd is false.
+ */
+bool UseAVX2();
+bool UseSSE42();
+
+/**
+ * The code paths of FindSubstr and RFindAny, from the least to the most vectorized.
+ */
+enum class SIMDLevel {
+  kScalar,
+  kSSE2,
+  kAVX2,
+};
+
+/**
+ * Returns the code path that FindSubstr and RFindAny take on this CPU.
+ */
+SIMDLevel ActiveSIMDLevel();
+
+/**
+ * Test only: caps the code path of FindSubstr and RFindAny, eg. to test the SSE2 path on a CPU
+ * with AVX2. Must not be called while searches are running.
+ */
+void SetMaxSIMDLevelForTesting(SIMDLevel level);
+
+/**
+ * Returns the position of the first occurrence of needle in buf, at or after pos, or npos.
+ * Same as buf.find(needle, pos), but vectorized for needles of at least 2 bytes.
+ */
+size_t FindSubstr(std::string_view buf, std::string_view needle, size_t pos = 0);
+
+/**
+ * Returns the position of the last occurrence in buf of any of the patterns, or npos if none of
+ * them occurs. Same as the max of buf.rfind(pattern) over the patterns, but makes a single
+ * vectorized pass over buf, instead of one pass per pattern.
+ */
+size_t RFindAny(std::string_view buf, ArrayView<std::string_view> patterns);
+
+}  // namespace http
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/simd_search.h"
+
+#include <random>
+#include <string>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+namespace protocols {
+namespace http {
+
+constexpr std::string_view kMethods[] = {"GET ", "HEAD ", "POST ", "PUT ", "DELETE "};
+
+class SIMDSearchTest : public ::testing::TestWithParam<SIMDLevel> {
+ protected:
+  void SetUp() override {
+    SetMaxSIMDLevelForTesting(GetParam());
+    if (ActiveSIMDLevel() != GetParam()) {
+      GTEST_SKIP() << "The CPU doesn't support the code path.";
+    }
+  }
+  void TearDown() override { SetMaxSIMDLevelForTesting(SIMDLevel::kAVX2); }
+};
+
+TEST(SIMDSearchFlagTest, FlagDisablesSIMD) {
+  bool old_flag_val = FLAGS_http_parse_use_simd;
+  FLAGS_http_parse_use_simd = false;
+  EXPECT_EQ(ActiveSIMDLevel(), SIMDLevel::kScalar);
+  EXPECT_FALSE(UseAVX2());
+  EXPECT_FALSE(UseSSE42());
+  FLAGS_http_parse_use_simd = old_flag_val;
+}
+
+TEST_P(SIMDSearchTest, FindSubstr) {
+  std::string buf = std::string(100, 'x') + "\r\n\r\n" + std::string(3, 'y') + "\r\n\r\n";
+
+  EXPECT_EQ(FindSubstr(buf, "\r\n\r\n"), 100);
+  EXPECT_EQ(FindSubstr(buf, "\r\n\r\n", 101), 107);
+  EXPECT_EQ(FindSubstr(buf, "\r\n\r\n", 108), std::string_view::npos);
+  EXPECT_EQ(FindSubstr(buf, "\r\n\r\n", 1000), std::string_view::npos);
+  EXPECT_EQ(FindSubstr(buf, "xx"), 0);
+  EXPECT_EQ(FindSubstr("", "\r\n"), std::string_view::npos);
+}
+
+TEST_P(SIMDSearchTest, RFindAny) {
+  std::string buf = "POST /a GET /b" + std::string(100, 'x') + "PUT /c DELETE" + "HEAD /d";
+
+  EXPECT_EQ(RFindAny(buf, kMethods), buf.size() - 7);
+  EXPECT_EQ(RFindAny(buf.substr(0, buf.size() - 7), kMethods), 114);
+  EXPECT_EQ(RFindAny(buf.substr(0, 110), kMethods), 8);
+  EXPECT_EQ(RFindAny("POST", kMethods), std::string_view::npos);
+  EXPECT_EQ(RFindAny("", kMethods), std::string_view::npos);
+}
+
+// Compare the searches with std::string_view on random buffers, where the needles and patterns
+// occur at every alignment.
+TEST_P(SIMDSearchTest, MatchesStringView) {
+  std::default_random_engine rng(37);
+  const std::string_view kAlphabet = "\r\nGETPOSHADU /";
+  std::uniform_int_distribution<size_t> char_dist(0, kAlphabet.size() - 1);
+
+  for (int i = 0; i < 1000; ++i) {
+    std::string buf(rng() % 300, '\0');
+    for (char& c : buf) {
+      c = kAlphabet[char_dist(rng)];
+    }
+    std::string_view view = buf;
+
+    size_t pos = rng() % (buf.size() + 2);
+    ASSERT_EQ(FindSubstr(view, "\r\n\r\n", pos), view.find("\r\n\r\n", pos));
+    ASSERT_EQ(FindSubstr(view, "GET", pos), view.find("GET", pos));
+
+    size_t expected = std::string_view::npos;
+    for (std::string_view method : kMethods) {
+      size_t method_pos = view.rfind(method);
+      if (method_pos != std::string_view::npos &&
+          (expected == std::string_view::npos || method_pos > expected)) {
+        expected = method_pos;
+      }
+    }
+    ASSERT_EQ(RFindAny(view, kMethods), expected);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(SIMDSearch, SIMDSearchTest,
+                         ::testing::Values(SIMDLevel::kAVX2, SIMDLevel::kSSE2, SIMDLevel::kScalar),
+                         [](const ::testing::TestParamInfo<SIMDSearchTest::ParamType>& info) {
+                           switch (info.param) {
+                             case SIMDLevel::kAVX2:
+                               return "AVX2";
+                             case SIMDLevel::kSSE2:
+                               return "SSE2";
+                             case SIMDLevel::kScalar:
+                               return "Scalar";
+                           }
+                           return "Unknown";
+                         });
+
+}  // namespace http
+}  // namespace protocols
+}  // namespace stirling
+}  // namespace px
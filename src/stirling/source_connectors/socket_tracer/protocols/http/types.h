@@ -20,6 +20,8 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "src/common/base/utils.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/event_parser.h"  // For FrameBase
@@ -117,6 +119,15 @@ struct ProtocolTraits : public BaseProtocolTraits<Record> {
 };
 
 }  // namespace http
+
+// Declared with the protocol's traits, so that ParseFrames() sees it wherever it is instantiated.
+// Returns true if the head holds the headers of an HTTP message with a Content-Length, but not yet
+// all of its body. Only parses the headers from a bounded prefix of the head. Defined in
+// http/parse.cc.
+template <>
+bool FrameNeedsMoreData<http::Message>(message_type_t type,
+                                       const std::vector<std::string_view>& head_chunks,
+                                       http::StateWrapper* state);
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
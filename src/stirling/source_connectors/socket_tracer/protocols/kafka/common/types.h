@@ -24,6 +24,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -400,6 +401,13 @@ struct ProtocolTraits : public BaseProtocolTraits<Record> {
 };
 
 }  // namespace kafka
+
+// Declared with the protocol's traits, so that ParseFrames() sees it wherever it is instantiated.
+// Defined in kafka/parse.cc.
+template <>
+bool FrameNeedsMoreData<kafka::Packet, kafka::StateWrapper>(
+    message_type_t type, const std::vector<std::string_view>& head_chunks,
+    kafka::StateWrapper* state);
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -23,6 +23,7 @@
 #include <deque>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "src/common/base/byte_utils.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/kafka/common/types.h"
@@ -38,36 +39,40 @@ namespace kafka {
   PL_ASSIGN_OR(expr, val_or, return ParseState::kInvalid)
 
 // Kafka request/response format: https://kafka.apache.org/protocol.html#protocol_messages
-ParseState ParseFrame(message_type_t type, std::string_view* buf, Packet* result, State* state) {
-  DCHECK(type == message_type_t::kRequest || type == message_type_t::kResponse);
-
+namespace {
+
+// Checks the length prefix and header of the packet at the head of the decoder's buffer. Used by
+// ParseFrame() on a contiguous buffer and by FrameNeedsMoreData() on chunks, so that they agree
+// on which packets are incomplete.
+template <typename TDecoder>
+ParseState ParseHeader(message_type_t type, TDecoder* decoder, int32_t* payload_length,
+                       int32_t* correlation_id) {
   int min_packet_length =
       type == message_type_t::kRequest ? kafka::kMinReqPacketLength : kafka::kMinRespPacketLength;
 
-  if (buf->size() < static_cast<size_t>(min_packet_length)) {
+  size_t buf_size = decoder->BufSize();
+  if (buf_size < static_cast<size_t>(min_packet_length)) {
     return ParseState::kNeedsMoreData;
   }
 
-  BinaryDecoder binary_decoder(*buf);
-
-  PL_ASSIGN_OR_RETURN_INVALID(int32_t payload_length, binary_decoder.ExtractInt<int32_t>());
+  PL_ASSIGN_OR_RETURN_INVALID(*payload_length, decoder->template ExtractInt<int32_t>());
 
-  if (payload_length + kafka::kMessageLengthBytes <= min_packet_length) {
+  if (*payload_length + kafka::kMessageLengthBytes <= min_packet_length) {
     return ParseState::kInvalid;
   }
 
   // TODO(chengruizhe): Add Length checks for each command x version. Automatic parsing of the
   // kafka doc will help.
-  APIKey request_api_key;
-  int16_t request_api_version;
   if (type == message_type_t::kRequest) {
-    PL_ASSIGN_OR_RETURN_INVALID(int16_t request_api_key_int, binary_decoder.ExtractInt<int16_t>());
+    PL_ASSIGN_OR_RETURN_INVALID(int16_t request_api_key_int,
+                                decoder->template ExtractInt<int16_t>());
     if (!IsValidAPIKey(request_api_key_int)) {
       return ParseState::kInvalid;
     }
-    request_api_key = static_cast<APIKey>(request_api_key_int);
+    auto request_api_key = static_cast<APIKey>(request_api_key_int);
 
-    PL_ASSIGN_OR_RETURN_INVALID(request_api_version, binary_decoder.ExtractInt<int16_t>());
+    PL_ASSIGN_OR_RETURN_INVALID(int16_t request_api_version,
+                                decoder->template ExtractInt<int16_t>());
 
     if (!IsSupportedAPIVersion(request_api_key, request_api_version)) {
       return ParseState::kInvalid;
@@ -75,15 +80,30 @@ ParseState ParseFrame(message_type_t type, std::string_view* buf, Packet* result
     // TODO(chengruizhe): Add length range checks for each api key x version.
   }
 
-  PL_ASSIGN_OR_RETURN_INVALID(int32_t correlation_id, binary_decoder.ExtractInt<int32_t>());
-  if (correlation_id < 0) {
+  PL_ASSIGN_OR_RETURN_INVALID(*correlation_id, decoder->template ExtractInt<int32_t>());
+  if (*correlation_id < 0) {
     return ParseState::kInvalid;
   }
 
   // Putting this check at the end, to avoid invalid packet classified as NeedsMoreData.
-  if (buf->size() - kMessageLengthBytes < (size_t)payload_length) {
+  if (buf_size - kMessageLengthBytes < static_cast<size_t>(*payload_length)) {
     return ParseState::kNeedsMoreData;
   }
+  return ParseState::kSuccess;
+}
+
+}  // namespace
+
+ParseState ParseFrame(message_type_t type, std::string_view* buf, Packet* result, State* state) {
+  DCHECK(type == message_type_t::kRequest || type == message_type_t::kResponse);
+
+  BinaryDecoder binary_decoder(*buf);
+  int32_t payload_length = 0;
+  int32_t correlation_id = 0;
+  ParseState header_state = ParseHeader(type, &binary_decoder, &payload_length, &correlation_id);
+  if (header_state != ParseState::kSuccess) {
+    return header_state;
+  }
 
   // Update seen_correlation_ids of requests for more robust response frame parsing.
   if (type == message_type_t::kRequest) {
@@ -99,6 +119,15 @@ ParseState ParseFrame(message_type_t type, std::string_view* buf, Packet* result
   return ParseState::kSuccess;
 }
 
+bool FrameNeedsMoreData(message_type_t type, const std::vector<std::string_view>& head_chunks) {
+  // Only the header is read, in place unless it straddles two chunks.
+  ChunkedBinaryDecoder decoder(head_chunks);
+  int32_t payload_length = 0;
+  int32_t correlation_id = 0;
+  return ParseHeader(type, &decoder, &payload_length, &correlation_id) ==
+         ParseState::kNeedsMoreData;
+}
+
 #define PL_ASSIGN_OR_RETURN_NPOS(expr, val_or) PL_ASSIGN_OR(expr, val_or, return std::string::npos)
 
 // FindFrameBoundary currently looks for a proper packet length and valid Kafka api key and version
@@ -165,6 +194,13 @@ ParseState ParseFrame<kafka::Packet, kafka::StateWrapper>(message_type_t type,
   return kafka::ParseFrame(type, buf, packet, &state->global);
 }
 
+template <>
+bool FrameNeedsMoreData<kafka::Packet, kafka::StateWrapper>(
+    message_type_t type, const std::vector<std::string_view>& head_chunks,
+    kafka::StateWrapper* /*state*/) {
+  return kafka::FrameNeedsMoreData(type, head_chunks);
+}
+
 template <>
 size_t FindFrameBoundary<kafka::Packet, kafka::StateWrapper>(message_type_t type,
                                                              std::string_view buf, size_t start_pos,
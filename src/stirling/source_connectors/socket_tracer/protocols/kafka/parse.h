@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/interface.h"
@@ -32,6 +33,12 @@ namespace kafka {
 ParseState ParseFrame(message_type_t type, std::string_view* buf, Packet* result, State* state);
 
 size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start_pos, State* state);
+
+/**
+ * Returns true if the head holds a valid packet header, but not yet the whole packet. Reads the
+ * header from the chunks in place, so a large packet isn't made contiguous until it is complete.
+ */
+bool FrameNeedsMoreData(message_type_t type, const std::vector<std::string_view>& head_chunks);
 }  // namespace kafka
 
 template <>
@@ -22,6 +22,9 @@
 #include <algorithm>
 #include <deque>
 #include <random>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "src/common/base/types.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/kafka/parse.h"
@@ -125,6 +128,24 @@ TEST(KafkaParserTest, ParseIncompleteRequest) {
   EXPECT_TRUE(state.global.seen_correlation_ids.empty());
 }
 
+TEST(KafkaParserTest, FrameNeedsMoreDataFromChunks) {
+  auto produce_frame_view =
+      CreateStringView<char>(CharArrayStringView<uint8_t>(testdata::kProduceRequest));
+
+  // The length prefix and header straddle the chunk boundaries.
+  auto chunks_of = [&](std::string_view frame) {
+    return std::vector<std::string_view>{frame.substr(0, 2), frame.substr(2, 5), frame.substr(7)};
+  };
+  auto truncated_frame = produce_frame_view.substr(0, produce_frame_view.size() - 1);
+  EXPECT_TRUE(FrameNeedsMoreData(message_type_t::kRequest, chunks_of(truncated_frame)));
+  EXPECT_FALSE(FrameNeedsMoreData(message_type_t::kRequest, chunks_of(produce_frame_view)));
+
+  // A short head needs more data, but an invalid header doesn't: ParseFrame() has to reject it.
+  EXPECT_TRUE(FrameNeedsMoreData(message_type_t::kRequest, {produce_frame_view.substr(0, 3)}));
+  std::string invalid_frame("\x00\x00\x18\x00\x03SELECT name FROM users;", 28);
+  EXPECT_FALSE(FrameNeedsMoreData(message_type_t::kRequest, chunks_of(invalid_frame)));
+}
+
 TEST(KafkaParserTest, ParseInvalidInput) {
   std::string msg1("\x00\x00\x18\x00\x03SELECT name FROM users;", 28);
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/socket_data_event_pool.h"
+
+#include <utility>
+
+namespace px {
+namespace stirling {
+
+void SocketDataEventPool::Releaser::operator()(OwnedSocketDataEvent* event) const {
+  if (pool_ != nullptr) {
+    pool_->Release(event);
+  } else {
+    delete event;
+  }
+}
+
+SocketDataEventPool::Ptr SocketDataEventPool::Copy(const SocketDataEvent& event) {
+  std::unique_ptr<OwnedSocketDataEvent> owned;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      owned = std::move(free_.back());
+      free_.pop_back();
+    }
+  }
+  if (owned == nullptr) {
+    owned = std::make_unique<OwnedSocketDataEvent>();
+  }
+
+  owned->event.attr = event.attr;
+  owned->payload.assign(event.msg.data(), event.msg.size());
+  owned->event.msg = owned->payload;
+  return Ptr(owned.release(), Releaser(this));
+}
+
+void SocketDataEventPool::Release(OwnedSocketDataEvent* event) {
+  std::unique_ptr<OwnedSocketDataEvent> owned(event);
+  if (owned->payload.capacity() > kMaxRecycledPayloadBytes) {
+    return;
+  }
+  owned->event.msg = {};
+  owned->payload.clear();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_.size() < kMaxFreeEvents) {
+    free_.push_back(std::move(owned));
+  }
+}
+
+}  // namespace stirling
+}  // namespace px
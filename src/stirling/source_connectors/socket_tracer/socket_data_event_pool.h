@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+
+namespace px {
+namespace stirling {
+
+/**
+ * A SocketDataEvent that owns the bytes of its msg.
+ */
+struct OwnedSocketDataEvent {
+  SocketDataEvent event;
+  std::string payload;
+};
+
+/**
+ * SocketDataEventPool holds copies of SocketDataEvents that must outlive the BPF buffer they were
+ * decoded from, for example while they wait in a queue. Released events return to the pool with
+ * their payload buffer, so in the steady state, copying an event does not allocate.
+ *
+ * Events can be acquired and released from different threads.
+ */
+class SocketDataEventPool {
+ public:
+  class Releaser {
+   public:
+    explicit Releaser(SocketDataEventPool* pool = nullptr) : pool_(pool) {}
+    void operator()(OwnedSocketDataEvent* event) const;
+
+   private:
+    SocketDataEventPool* pool_;
+  };
+  using Ptr = std::unique_ptr<OwnedSocketDataEvent, Releaser>;
+
+  /**
+   * Returns a copy of the event, whose msg points into its own payload.
+   */
+  Ptr Copy(const SocketDataEvent& event);
+
+  size_t num_free() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+  }
+
+ private:
+  // Bounds the memory held by the pool: events beyond this count, or with a payload buffer beyond
+  // this size (e.g. large filler events), are freed instead of recycled.
+  static constexpr size_t kMaxFreeEvents = 16 * 1024;
+  static constexpr size_t kMaxRecycledPayloadBytes = 64 * 1024;
+
+  void Release(OwnedSocketDataEvent* event);
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<OwnedSocketDataEvent>> free_;
+};
+
+}  // namespace stirling
+}  // namespace px
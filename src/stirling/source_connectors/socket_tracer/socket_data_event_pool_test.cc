@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/socket_data_event_pool.h"
+
+#include <string>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+TEST(SocketDataEventPoolTest, CopyOwnsPayload) {
+  SocketDataEventPool pool;
+
+  std::string msg = "GET / HTTP/1.1\r\n\r\n";
+  SocketDataEvent event;
+  event.attr.pos = 10;
+  event.attr.msg_size = msg.size();
+  event.msg = msg;
+
+  SocketDataEventPool::Ptr copy = pool.Copy(event);
+  msg.assign(msg.size(), 'x');
+
+  EXPECT_EQ(copy->event.attr.pos, 10);
+  EXPECT_EQ(copy->event.msg, "GET / HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(copy->event.msg.data(), copy->payload.data());
+}
+
+TEST(SocketDataEventPoolTest, RecyclesReleasedEvents) {
+  SocketDataEventPool pool;
+
+  SocketDataEvent event;
+  event.msg = "abc";
+
+  SocketDataEventPool::Ptr copy = pool.Copy(event);
+  const OwnedSocketDataEvent* first = copy.get();
+  copy.reset();
+  EXPECT_EQ(pool.num_free(), 1);
+
+  copy = pool.Copy(event);
+  EXPECT_EQ(copy.get(), first);
+  EXPECT_EQ(pool.num_free(), 0);
+  EXPECT_EQ(copy->event.msg, "abc");
+}
+
+TEST(SocketDataEventPoolTest, DoesNotRecycleLargePayloads) {
+  SocketDataEventPool pool;
+
+  std::string msg(1024 * 1024, 'a');
+  SocketDataEvent event;
+  event.msg = msg;
+
+  pool.Copy(event).reset();
+  EXPECT_EQ(pool.num_free(), 0);
+}
+
+}  // namespace stirling
+}  // namespace px
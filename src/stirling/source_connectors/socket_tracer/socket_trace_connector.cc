@@ -24,9 +24,12 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <numeric>
+#include <tuple>
 #include <utility>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
 #include <absl/strings/match.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/delimited_message_util.h>
@@ -35,6 +38,7 @@
 #include "src/common/base/base.h"
 #include "src/common/base/utils.h"
 #include "src/common/json/json.h"
+#include "src/common/system/config.h"
 #include "src/common/system/socket_info.h"
 #include "src/shared/metadata/metadata.h"
 #include "src/stirling/bpf_tools/macros.h"
@@ -42,6 +46,7 @@
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/go_grpc_types.hpp"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
+#include "src/stirling/source_connectors/socket_tracer/metrics.h"
 #include "src/stirling/source_connectors/socket_tracer/proto/sock_event.pb.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/utils.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http2/grpc.h"
@@ -126,6 +131,11 @@ DEFINE_double(stirling_socket_tracer_max_total_bw_overprovision_factor, 1,
               "Factor to overprovision maximum total bandwidth, to account for the fact that "
               "traffic won't be exactly evenly distributed over all cpus.");
 
+DEFINE_bool(stirling_socket_tracer_use_ringbuf,
+            gflags::BoolFromEnv("PL_STIRLING_SOCKET_TRACER_USE_RINGBUF", true),
+            "If true, and the kernel supports it (5.8+), socket data and control events are sent "
+            "through BPF ring buffers shared by all CPUs, instead of per-CPU perf buffers.");
+
 DEFINE_uint32(messages_expiry_duration_secs, 1 * 60,
               "The duration after which a parsed message is erased.");
 DEFINE_uint32(messages_size_limit_bytes, 1024 * 1024,
@@ -382,6 +392,24 @@ auto SocketTraceConnector::InitPerfBufferSpecs() {
   return specs;
 }
 
+namespace {
+
+// The perf buffers that are replaced by ring buffers when ring buffers are in use.
+bool HasRingBuffer(std::string_view perf_buffer_name) {
+  return perf_buffer_name == "socket_data_events" || perf_buffer_name == "socket_control_events";
+}
+
+// A ring buffer is shared by all CPUs, so it gets the total size of the per-CPU perf buffers it
+// replaces. Returns the number of pages, which must be a power of 2. Rounding down keeps the ring
+// within the memory of those perf buffers, at the cost of up to half of it.
+int64_t RingBufferPages(const bpf_tools::PerfBufferSpec& spec) {
+  const int64_t kPageSizeBytes = system::Config::GetInstance().PageSizeBytes();
+  const int64_t kNCPUs = get_nprocs_conf();
+  return IntRoundDownToPow2(IntRoundUpDivide(spec.size_bytes * kNCPUs, kPageSizeBytes));
+}
+
+}  // namespace
+
 Status SocketTraceConnector::InitBPF() {
   // PROTOCOL_LIST: Requires update on new protocols.
   std::vector<std::string> defines = {
@@ -398,15 +426,55 @@ Status SocketTraceConnector::InitBPF() {
       absl::StrCat("-DENABLE_AMQP_TRACING=", FLAGS_stirling_enable_amqp_tracing),
       absl::StrCat("-DENABLE_MONGO_TRACING=", "true"),
   };
+
+  const auto kPerfBufferSpecs = InitPerfBufferSpecs();
+
+  // Data and control events go through ring buffers when the kernel supports them, and through
+  // perf buffers otherwise.
+  use_ringbuf_ = FLAGS_stirling_socket_tracer_use_ringbuf && SupportsRingBuffers();
+  defines.push_back(absl::StrCat("-DUSE_RINGBUF=", use_ringbuf_));
+  if (use_ringbuf_) {
+    for (const auto& spec : kPerfBufferSpecs) {
+      if (spec.name == "socket_data_events") {
+        defines.push_back(
+            absl::StrCat("-DSOCKET_DATA_EVENTS_RINGBUF_PAGES=", RingBufferPages(spec)));
+      } else if (spec.name == "socket_control_events") {
+        defines.push_back(
+            absl::StrCat("-DSOCKET_CONTROL_EVENTS_RINGBUF_PAGES=", RingBufferPages(spec)));
+      }
+    }
+  }
   PL_RETURN_IF_ERROR(InitBPFProgram(socket_trace_bcc_script, defines));
 
   PL_RETURN_IF_ERROR(AttachKProbes(kProbeSpecs));
   LOG(INFO) << absl::Substitute("Number of kprobes deployed = $0", kProbeSpecs.size());
   LOG(INFO) << "Probes successfully deployed.";
 
-  const auto kPerfBufferSpecs = InitPerfBufferSpecs();
-  PL_RETURN_IF_ERROR(OpenPerfBuffers(kPerfBufferSpecs, this));
-  LOG(INFO) << absl::Substitute("Number of perf buffers opened = $0", kPerfBufferSpecs.size());
+  for (const auto& spec : kPerfBufferSpecs) {
+    if (!HasRingBuffer(spec.name)) {
+      common_perf_buffers_.push_back(spec.name);
+    } else if (!use_ringbuf_) {
+      ingest_perf_buffers_.push_back(spec.name);
+    }
+  }
+
+  if (use_ringbuf_) {
+    std::vector<bpf_tools::PerfBufferSpec> perf_buffer_specs;
+    for (const auto& spec : kPerfBufferSpecs) {
+      if (HasRingBuffer(spec.name)) {
+        PL_RETURN_IF_ERROR(OpenRingBuffer({spec.name, spec.probe_output_fn}, this));
+      } else {
+        perf_buffer_specs.push_back(spec);
+      }
+    }
+    PL_RETURN_IF_ERROR(OpenPerfBuffers(perf_buffer_specs, this));
+    LOG(INFO) << absl::Substitute("Number of perf buffers opened = $0, ring buffers opened = $1",
+                                  perf_buffer_specs.size(),
+                                  kPerfBufferSpecs.size() - perf_buffer_specs.size());
+  } else {
+    PL_RETURN_IF_ERROR(OpenPerfBuffers(kPerfBufferSpecs, this));
+    LOG(INFO) << absl::Substitute("Number of perf buffers opened = $0", kPerfBufferSpecs.size());
+  }
 
   // Set trace role to BPF probes.
   for (const auto& p : magic_enum::enum_values<traffic_protocol_t>()) {
@@ -474,6 +542,10 @@ Status SocketTraceConnector::InitImpl() {
   uprobe_mgr_.Init(protocol_transfer_specs_[kProtocolHTTP2].enabled,
                    FLAGS_stirling_disable_self_tracing);
 
+  if (FLAGS_stirling_ingest_worker_threads > 0) {
+    StartIngestPipeline();
+  }
+
   return Status::OK();
 }
 
@@ -492,6 +564,7 @@ Status SocketTraceConnector::StopImpl() {
   }
 
   // Wait for all threads to finish.
+  StopIngestPipeline();
   while (uprobe_mgr_.ThreadsRunning()) {
   }
 
@@ -565,18 +638,33 @@ std::string BPFMapsInfo(bpf_tools::BCCWrapper* bcc) {
 }  // namespace
 
 void SocketTraceConnector::UpdateCommonState(ConnectorContext* ctx) {
-  // Since events may be pushed into the perf buffer while reading it,
-  // we establish a cutoff time before draining the perf buffer.
-  // Note: We use AdjustedSteadyClockNowNS() instead of CurrentTimeNS()
-  // to maintain consistency with how BPF generates timestamps on its events.
-  perf_buffer_drain_time_ = AdjustedSteadyClockNowNS();
-
-  // This drains all perf buffers, and causes Handle() callback functions to get called.
-  // Note that it drains *all* perf buffers, not just those that are required for this table,
-  // so raw data will be pushed to connection trackers more aggressively.
-  // No data is lost, but this is a side-effect of sorts that affects timing of transfers.
-  // It may be worth noting during debug.
-  PollPerfBuffers();
+  if (ingest_workers_ != nullptr) {
+    // The data and control events are drained by the drain thread. Take the cutoff time of its
+    // last completed drain *before* applying the queues, so that every event older than the
+    // cutoff is applied.
+    perf_buffer_drain_time_ = ingest_drain_time_;
+    ApplyIngestQueues();
+    for (const auto& name : common_perf_buffers_) {
+      PollPerfBuffer(name);
+    }
+  } else {
+    // Since events may be pushed into the perf buffer while reading it,
+    // we establish a cutoff time before draining the perf buffer.
+    // Note: We use AdjustedSteadyClockNowNS() instead of CurrentTimeNS()
+    // to maintain consistency with how BPF generates timestamps on its events.
+    perf_buffer_drain_time_ = AdjustedSteadyClockNowNS();
+
+    // This drains all perf buffers, and causes Handle() callback functions to get called.
+    // Note that it drains *all* perf buffers, not just those that are required for this table,
+    // so raw data will be pushed to connection trackers more aggressively.
+    // No data is lost, but this is a side-effect of sorts that affects timing of transfers.
+    // It may be worth noting during debug.
+    PollPerfBuffers();
+    if (use_ringbuf_) {
+      PollRingBuffers();
+      ReadRingBufferLosses();
+    }
+  }
 
   // Set-up current state for connection inference purposes.
   if (socket_info_mgr_ != nullptr) {
@@ -604,6 +692,89 @@ void SocketTraceConnector::UpdateCommonState(ConnectorContext* ctx) {
   }
 }
 
+void SocketTraceConnector::StartIngestPipeline() {
+  // Events queued by a shard of a full queue are dropped, rather than stalling the drain thread,
+  // which would only move the loss into the BPF buffers.
+  constexpr size_t kIngestQueueCapacity = 64 * 1024;
+
+  // Create the protocol metrics upfront, as their lazy creation is not thread-safe.
+  for (auto protocol : magic_enum::enum_values<traffic_protocol_t>()) {
+    SocketTracerMetrics::GetProtocolMetrics(protocol);
+  }
+
+  auto* metrics = &IngestStageMetrics::GetStageMetrics("socket_tracer_events");
+  for (int i = 0; i < FLAGS_stirling_ingest_worker_threads; ++i) {
+    ingest_queues_.push_back(
+        std::make_unique<BoundedQueue<IngestEvent>>(kIngestQueueCapacity, metrics));
+  }
+  ingest_workers_ = std::make_unique<WorkerPool>(FLAGS_stirling_ingest_worker_threads);
+
+  ingest_drain_time_ = AdjustedSteadyClockNowNS();
+  ingest_drain_enabled_ = true;
+  ingest_drain_thread_ = std::thread(&SocketTraceConnector::IngestDrainLoop, this);
+  LOG(INFO) << absl::Substitute("Pipelined ingest started with $0 worker threads.",
+                                FLAGS_stirling_ingest_worker_threads);
+}
+
+void SocketTraceConnector::StopIngestPipeline() {
+  if (!ingest_drain_thread_.joinable()) {
+    return;
+  }
+  ingest_drain_enabled_ = false;
+  ingest_drain_thread_.join();
+  for (auto& queue : ingest_queues_) {
+    queue->Close();
+  }
+  ingest_workers_.reset();
+}
+
+void SocketTraceConnector::IngestDrainLoop() {
+  // Much shorter than kSamplingPeriod, so that the BPF buffers are drained even while the main
+  // thread is busy parsing.
+  constexpr auto kIngestDrainPeriod = std::chrono::milliseconds{10};
+
+  while (ingest_drain_enabled_) {
+    uint64_t drain_time = AdjustedSteadyClockNowNS();
+    DrainIngestBuffers();
+    ingest_drain_time_ = drain_time;
+    std::this_thread::sleep_for(kIngestDrainPeriod);
+  }
+}
+
+void SocketTraceConnector::DrainIngestBuffers() {
+  if (use_ringbuf_) {
+    PollRingBuffers();
+    ReadRingBufferLosses();
+  } else {
+    for (const auto& name : ingest_perf_buffers_) {
+      PollPerfBuffer(name);
+    }
+  }
+}
+
+void SocketTraceConnector::ApplyIngestQueues() {
+  for (auto& queue : ingest_queues_) {
+    for (auto& event : queue->PopAll()) {
+      if (auto* data_event = std::get_if<SocketDataEventPool::Ptr>(&event)) {
+        ConnTracker& tracker = GetOrCreateConnTracker((*data_event)->event.attr.conn_id);
+        tracker.AddDataEvent((*data_event)->event);
+      } else {
+        const auto& control_event = std::get<socket_control_event_t>(event);
+        ConnTracker& tracker = GetOrCreateConnTracker(control_event.conn_id);
+        tracker.AddControlEvent(control_event);
+      }
+    }
+  }
+}
+
+size_t SocketTraceConnector::IngestShard(const struct conn_id_t& conn_id) const {
+  // All the events and the tracker of a connection map to the same shard, which keeps the events
+  // of a connection in order.
+  size_t hash = absl::Hash<std::tuple<uint32_t, uint64_t, int32_t, uint64_t>>()(std::make_tuple(
+      conn_id.upid.tgid, conn_id.upid.start_time_ticks, conn_id.fd, conn_id.tsid));
+  return hash % ingest_queues_.size();
+}
+
 void SocketTraceConnector::UpdateTrackerTraceLevel(ConnTracker* tracker) {
   if (pids_to_trace_.contains(tracker->conn_id().upid.pid)) {
     tracker->SetDebugTrace(2);
@@ -652,43 +823,81 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     }
   }
 
-  for (const auto& conn_tracker : conn_trackers_mgr_.active_trackers()) {
-    const auto& transfer_spec = protocol_transfer_specs_[conn_tracker->protocol()];
-
-    DataTable* data_table = nullptr;
-    if (transfer_spec.enabled) {
-      data_table = data_tables[transfer_spec.table_num];
+  if (ingest_workers_ != nullptr) {
+    TransferTrackersInParallel(ctx, data_tables, cluster_cidrs);
+  } else {
+    for (const auto& conn_tracker : conn_trackers_mgr_.active_trackers()) {
+      PrepareTracker(ctx, cluster_cidrs, conn_tracker);
+      TransferTracker(ctx, data_tables, conn_tracker);
+      conn_tracker->IterationPostTick();
     }
+  }
+
+  // Once we've cleared all the debug trace levels for this pid, we can remove it from the list.
+  pids_to_trace_disable_.clear();
+}
 
-    UpdateTrackerTraceLevel(conn_tracker);
+void SocketTraceConnector::PrepareTracker(ConnectorContext* ctx,
+                                          const std::vector<CIDRBlock>& cluster_cidrs,
+                                          ConnTracker* conn_tracker) {
+  UpdateTrackerTraceLevel(conn_tracker);
 
-    // Once a known UPID, always a known UPID.
-    if (!conn_tracker->is_tracked_upid()) {
-      md::UPID upid(ctx->GetASID(), conn_tracker->conn_id().upid.pid,
-                    conn_tracker->conn_id().upid.start_time_ticks);
-      if (ctx->GetUPIDs().contains(upid)) {
-        conn_tracker->set_is_tracked_upid();
-      }
+  // Once a known UPID, always a known UPID.
+  if (!conn_tracker->is_tracked_upid()) {
+    md::UPID upid(ctx->GetASID(), conn_tracker->conn_id().upid.pid,
+                  conn_tracker->conn_id().upid.start_time_ticks);
+    if (ctx->GetUPIDs().contains(upid)) {
+      conn_tracker->set_is_tracked_upid();
     }
+  }
 
-    conn_tracker->IterationPreTick(iteration_time_, cluster_cidrs, proc_parser_.get(),
-                                   socket_info_mgr_.get());
+  conn_tracker->IterationPreTick(iteration_time_, cluster_cidrs, proc_parser_.get(),
+                                 socket_info_mgr_.get());
+}
 
-    if (transfer_spec.transfer_fn != nullptr) {
-      transfer_spec.transfer_fn(*this, ctx, conn_tracker, data_table);
-    } else {
-      // If there's no transfer function, then the tracker should not be holding any data.
-      // http::ProtocolTraits is used as a placeholder; the frames deque is expected to be
-      // std::monotstate.
-      ECHECK(conn_tracker->send_data().Empty<protocols::http::Message>());
-      ECHECK(conn_tracker->recv_data().Empty<protocols::http::Message>());
-    }
+void SocketTraceConnector::TransferTracker(ConnectorContext* ctx,
+                                           const std::vector<DataTable*>& data_tables,
+                                           ConnTracker* conn_tracker) {
+  const auto& transfer_spec = protocol_transfer_specs_[conn_tracker->protocol()];
 
-    conn_tracker->IterationPostTick();
+  DataTable* data_table = nullptr;
+  if (transfer_spec.enabled) {
+    data_table = data_tables[transfer_spec.table_num];
   }
 
-  // Once we've cleared all the debug trace levels for this pid, we can remove it from the list.
-  pids_to_trace_disable_.clear();
+  if (transfer_spec.transfer_fn != nullptr) {
+    transfer_spec.transfer_fn(*this, ctx, conn_tracker, data_table);
+  } else {
+    // If there's no transfer function, then the tracker should not be holding any data.
+    // http::ProtocolTraits is used as a placeholder; the frames deque is expected to be
+    // std::monotstate.
+    ECHECK(conn_tracker->send_data().Empty<protocols::http::Message>());
+    ECHECK(conn_tracker->recv_data().Empty<protocols::http::Message>());
+  }
+}
+
+void SocketTraceConnector::TransferTrackersInParallel(ConnectorContext* ctx,
+                                                      const std::vector<DataTable*>& data_tables,
+                                                      const std::vector<CIDRBlock>& cluster_cidrs) {
+  // The pre-tick infers roles from the socket info manager and /proc, which are not thread-safe,
+  // so only the parsing and the transfer of the trackers runs on the workers.
+  std::vector<std::vector<ConnTracker*>> shards(ingest_workers_->num_threads());
+  for (const auto& conn_tracker : conn_trackers_mgr_.active_trackers()) {
+    PrepareTracker(ctx, cluster_cidrs, conn_tracker);
+    shards[IngestShard(conn_tracker->conn_id())].push_back(conn_tracker);
+  }
+
+  ingest_workers_->RunShards([&](int shard) {
+    for (ConnTracker* conn_tracker : shards[shard]) {
+      TransferTracker(ctx, data_tables, conn_tracker);
+    }
+  });
+
+  for (const auto& shard : shards) {
+    for (ConnTracker* conn_tracker : shard) {
+      conn_tracker->IterationPostTick();
+    }
+  }
 }
 
 Status SocketTraceConnector::UpdateBPFProtocolTraceRole(traffic_protocol_t protocol,
@@ -728,28 +937,55 @@ void SocketTraceConnector::HandleDataEvent(void* cb_cookie, void* data, int data
   auto* connector = static_cast<SocketTraceConnector*>(cb_cookie);
   connector->stats_.Increment(StatKey::kPollSocketDataEventSize, data_size);
 
-  std::unique_ptr<SocketDataEvent> data_event_ptr = std::make_unique<SocketDataEvent>(data);
+  // The events are decoded on the stack, and their msg points into the BPF buffer, so that the
+  // bytes are copied only once, into the DataStreamBuffer of the connection.
+  SocketDataEvent data_event(data);
 
   // The servers of certain protocols (e.g. Kafka) read the length headers of frames separately
   // from the payload. In these cases, the protocol inference misses the header of the first frame.
   // This header is encoded in the attributes instead.
   // We account for this with a separate header event.
-  std::unique_ptr<SocketDataEvent> header_event_ptr = data_event_ptr->ExtractHeaderEvent();
+  SocketDataEvent header_event;
+  bool has_header_event = data_event.ExtractHeaderEvent(&header_event);
 
   // In some scenarios when we are unable to trace the data (notably including sendfile syscalls),
   // we create a filler event instead. This is important to Kafka, for example,
   // where the sendfile data is in the payload and the protocol parser can still succeed
   // as long as it is properly accounted for.
-  std::unique_ptr<SocketDataEvent> filler_event_ptr = data_event_ptr->ExtractFillerEvent();
+  SocketDataEvent filler_event;
+  bool has_filler_event = data_event.ExtractFillerEvent(&filler_event);
 
-  if (header_event_ptr) {
-    connector->AcceptDataEvent(std::move(header_event_ptr));
+  if (has_header_event) {
+    connector->AcceptDataEvent(header_event);
   }
-  if (data_event_ptr && !data_event_ptr->msg.empty()) {
-    connector->AcceptDataEvent(std::move(data_event_ptr));
+  if (!data_event.msg.empty()) {
+    connector->AcceptDataEvent(data_event);
   }
-  if (filler_event_ptr) {
-    connector->AcceptDataEvent(std::move(filler_event_ptr));
+  if (has_filler_event) {
+    connector->AcceptDataEvent(filler_event);
+  }
+}
+
+void SocketTraceConnector::ReadRingBufferLosses() {
+  // The BPF side counts the events that didn't fit in the ring buffers. Report the new ones through
+  // the same loss handlers as the perf buffers.
+  auto loss_counts = GetPerCPUArrayTable<uint64_t>("ringbuf_loss_counts");
+  for (int idx = 0; idx < kNumRingBufLossCounters; ++idx) {
+    std::vector<uint64_t> per_cpu_counts;
+    if (!loss_counts.get_value(idx, per_cpu_counts).ok()) {
+      continue;
+    }
+    uint64_t total = std::accumulate(per_cpu_counts.begin(), per_cpu_counts.end(), uint64_t{0});
+    uint64_t lost = total - ringbuf_loss_counts_[idx];
+    ringbuf_loss_counts_[idx] = total;
+    if (lost == 0) {
+      continue;
+    }
+    if (idx == kSocketDataEventsLossIdx) {
+      HandleDataEventLoss(this, lost);
+    } else {
+      HandleControlEventLoss(this, lost);
+    }
   }
 }
 
@@ -904,20 +1140,31 @@ ConnTracker& SocketTraceConnector::GetOrCreateConnTracker(struct conn_id_t conn_
   return tracker;
 }
 
-void SocketTraceConnector::AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) {
+void SocketTraceConnector::AcceptDataEvent(const SocketDataEvent& event) {
   if (perf_buffer_events_output_stream_ != nullptr) {
-    WriteDataEvent(*event);
+    WriteDataEvent(event);
   }
 
   stats_.Increment(StatKey::kPollSocketDataEventCount);
-  stats_.Increment(StatKey::kPollSocketDataEventAttrSize, sizeof(event->attr));
-  stats_.Increment(StatKey::kPollSocketDataEventDataSize, event->msg.size());
+  stats_.Increment(StatKey::kPollSocketDataEventAttrSize, sizeof(event.attr));
+  stats_.Increment(StatKey::kPollSocketDataEventDataSize, event.msg.size());
 
-  ConnTracker& tracker = GetOrCreateConnTracker(event->attr.conn_id);
-  tracker.AddDataEvent(std::move(event));
+  if (!ingest_queues_.empty()) {
+    // The event is applied after the BPF buffer is released, so it needs a copy of its msg.
+    ingest_queues_[IngestShard(event.attr.conn_id)]->TryPush(ingest_event_pool_.Copy(event));
+    return;
+  }
+
+  ConnTracker& tracker = GetOrCreateConnTracker(event.attr.conn_id);
+  tracker.AddDataEvent(event);
 }
 
 void SocketTraceConnector::AcceptControlEvent(socket_control_event_t event) {
+  if (!ingest_queues_.empty()) {
+    ingest_queues_[IngestShard(event.conn_id)]->TryPush(event);
+    return;
+  }
+
   ConnTracker& tracker = GetOrCreateConnTracker(event.conn_id);
   tracker.AddControlEvent(event);
 }
@@ -1513,6 +1760,15 @@ void SocketTraceConnector::TransferStream(ConnectorContext* ctx, ConnTracker* tr
     for (auto& record : records) {
       TProtocolTraits::ConvertTimestamps(
           &record, [&](uint64_t mono_time) { return ConvertToRealTime(mono_time); });
+    }
+
+    // With the pipelined ingest, the trackers of a table are transferred by several workers.
+    std::unique_lock<std::mutex> lock;
+    if (ingest_workers_ != nullptr) {
+      lock = std::unique_lock<std::mutex>(
+          data_table_mutexes_[protocol_transfer_specs_[tracker->protocol()].table_num]);
+    }
+    for (auto& record : records) {
       AppendMessage(ctx, *tracker, std::move(record), data_table);
     }
   }
@@ -18,13 +18,18 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
@@ -36,12 +41,14 @@
 #include "src/stirling/obj_tools/dwarf_reader.h"
 #include "src/stirling/obj_tools/elf_reader.h"
 
+#include "src/stirling/core/ingest_pipeline.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/grpc_c.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_tracker.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
+#include "src/stirling/source_connectors/socket_tracer/socket_data_event_pool.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_bpf_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/uprobe_manager.h"
@@ -68,6 +75,7 @@ DECLARE_string(stirling_role_to_trace);
 
 DECLARE_uint32(stirling_socket_tracer_target_data_bw_percpu);
 DECLARE_uint32(stirling_socket_tracer_target_control_bw_percpu);
+DECLARE_bool(stirling_socket_tracer_use_ringbuf);
 
 DECLARE_uint32(messages_expiry_duration_secs);
 DECLARE_uint32(messages_size_limit_bytes);
@@ -151,6 +159,9 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
     return conn_trackers_mgr_.GetConnTracker(pid, fd);
   }
 
+  // Whether data and control events are read from BPF ring buffers rather than perf buffers.
+  bool uses_ringbuf() const { return use_ringbuf_; }
+
   void test_only_set_now_fn(std::function<std::chrono::steady_clock::time_point()> now_fn) {
     now_fn_ = now_fn;
   }
@@ -179,12 +190,28 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   Status InitBPF();
   auto InitPerfBufferSpecs();
+  // Reports the events dropped by the BPF ring buffers since the last call.
+  void ReadRingBufferLosses();
+
+  // Pipelined ingest, enabled by --stirling_ingest_worker_threads.
+  // A drain thread polls the data and control event buffers, and queues the events by connection,
+  // in one queue per worker. TransferDataImpl() then applies the queued events to the
+  // ConnTrackers, and the workers parse and transfer the ConnTrackers of their shard in parallel.
+  using IngestEvent = std::variant<SocketDataEventPool::Ptr, socket_control_event_t>;
+  void StartIngestPipeline();
+  void StopIngestPipeline();
+  void IngestDrainLoop();
+  void DrainIngestBuffers();
+  void ApplyIngestQueues();
+  size_t IngestShard(const struct conn_id_t& conn_id) const;
   void InitProtocolTransferSpecs();
 
   ConnTracker& GetOrCreateConnTracker(struct conn_id_t conn_id);
 
   // Events from BPF.
-  void AcceptDataEvent(std::unique_ptr<SocketDataEvent> event);
+  // The msg of a data event may point into the BPF buffer, so it is only valid during the call.
+  void AcceptDataEvent(const SocketDataEvent& event);
+  void AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) { AcceptDataEvent(*event); }
   void AcceptControlEvent(socket_control_event_t event);
   void AcceptConnStatsEvent(conn_stats_event_t event);
   void AcceptHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> event);
@@ -212,6 +239,15 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   void UpdateTrackerTraceLevel(ConnTracker* tracker);
 
+  // The per-tracker steps of TransferDataImpl(). PrepareTracker() must run on the main thread,
+  // while TransferTracker() may run on the ingest workers.
+  void PrepareTracker(ConnectorContext* ctx, const std::vector<CIDRBlock>& cluster_cidrs,
+                      ConnTracker* conn_tracker);
+  void TransferTracker(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables,
+                       ConnTracker* conn_tracker);
+  void TransferTrackersInParallel(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables,
+                                  const std::vector<CIDRBlock>& cluster_cidrs);
+
   template <typename TRecordType>
   static void AppendMessage(ConnectorContext* ctx, const ConnTracker& conn_tracker,
                             TRecordType record, DataTable* data_table);
@@ -265,6 +301,30 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   //   Example: data_table->SetConsumeRecordsCutoffTime(perf_buffer_drain_time_);
   uint64_t perf_buffer_drain_time_ = 0;
 
+  // Set by InitBPF(), if the data and control events are sent through BPF ring buffers.
+  bool use_ringbuf_ = false;
+  // The ring buffer losses reported so far, by ringbuf_loss_idx_t.
+  std::array<uint64_t, kNumRingBufLossCounters> ringbuf_loss_counts_ = {};
+
+  // The perf buffers drained by the ingest drain thread, if the pipelined ingest is on, and the
+  // ones drained by UpdateCommonState().
+  std::vector<std::string> ingest_perf_buffers_;
+  std::vector<std::string> common_perf_buffers_;
+
+  // The state of the pipelined ingest. Only set up if --stirling_ingest_worker_threads > 0.
+  // The queued data events are copied out of the BPF buffers into pooled events, which must
+  // outlive the queues.
+  SocketDataEventPool ingest_event_pool_;
+  std::vector<std::unique_ptr<BoundedQueue<IngestEvent>>> ingest_queues_;
+  std::unique_ptr<WorkerPool> ingest_workers_;
+  std::thread ingest_drain_thread_;
+  std::atomic<bool> ingest_drain_enabled_ = false;
+  // The time before the start of the last completed drain; the counterpart of
+  // perf_buffer_drain_time_ for the drain thread.
+  std::atomic<uint64_t> ingest_drain_time_ = 0;
+  // Serialize the appends of the ingest workers to each data table.
+  std::array<std::mutex, kTables.size()> data_table_mutexes_;
+
   // If not a nullptr, writes the events received from perf buffers to this stream.
   std::unique_ptr<std::ofstream> perf_buffer_events_output_stream_;
   enum class OutputFormat {
@@ -298,7 +358,8 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
     kPollSocketDataEventSize,
   };
 
-  utils::StatCounter<StatKey> stats_;
+  // Updated by the drain thread of the pipelined ingest, and printed by TransferDataImpl().
+  utils::AtomicStatCounter<StatKey> stats_;
 
   friend class SocketTraceConnectorFriend;
   friend class SocketTraceBPFTest;
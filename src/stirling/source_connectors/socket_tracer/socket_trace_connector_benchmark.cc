@@ -17,6 +17,13 @@
  */
 
 #include <gflags/gflags.h>
+#include <unistd.h>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 #include <absl/container/flat_hash_set.h>
 #include <absl/strings/str_split.h>
@@ -25,6 +32,7 @@
 
 #include "src/common/perf/memory_tracker.h"
 #include "src/common/perf/tcmalloc.h"
+#include "src/common/system/tcp_socket.h"
 #include "src/stirling/core/connector_context.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
 #include "src/stirling/source_connectors/socket_tracer/testing/benchmark_data_gen/data_gen.h"
@@ -53,6 +61,7 @@ using ::px::stirling::testing::MySQLExecuteReqRespGen;
 using ::px::stirling::testing::NATSMSGGen;
 using ::px::stirling::testing::NoGapsPosGenerator;
 using ::px::stirling::testing::PostgresSelectReqRespGen;
+using ::px::system::TCPSocket;
 
 namespace {
 
@@ -396,3 +405,197 @@ BENCHMARK_CAPTURE(BM_SocketTraceConnector, http1_intra_iter_gaps,
                           },
                   })
     ->Unit(benchmark::kMillisecond);
+
+// Benchmark of the per-event cost of the data event path, from the BPF buffer to the
+// DataStreamBuffer of the connection. Events are small HTTP requests and responses, spread over
+// many connections, and TransferData() runs every 200K events, as it would at 1M events/sec with
+// the 200ms sampling period. Unlike the benchmarks above, events are replayed from a single
+// buffer, so that 1M events per iteration fit in memory.
+
+// NOLINTNEXTLINE: runtime/references.
+static void BM_SocketTraceConnectorEventRate(benchmark::State& state) {
+  constexpr int kNumConns = 1000;
+  constexpr int kNumEvents = 1000 * 1000;
+  constexpr int kEventsPerPoll = kNumEvents / 5;
+  constexpr std::string_view kReq = "GET /index.html HTTP/1.1\r\nHost: pixie\r\n\r\n";
+  constexpr std::string_view kResp = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+
+  auto display_stat_categories = GetDisplayStatCategories().ConsumeValueOrDie();
+
+  // socket_data_event_t holds the largest possible payload, so keep a single one of each.
+  auto req_event = std::make_unique<socket_data_event_t>();
+  auto resp_event = std::make_unique<socket_data_event_t>();
+  for (auto [event, msg, direction] : {std::make_tuple(req_event.get(), kReq, kIngress),
+                                       std::make_tuple(resp_event.get(), kResp, kEgress)}) {
+    event->attr.direction = direction;
+    event->attr.protocol = kProtocolHTTP;
+    event->attr.role = kRoleServer;
+    event->attr.conn_id.upid.pid = 12345;
+    event->attr.conn_id.upid.start_time_ticks = 1;
+    event->attr.msg_size = msg.size();
+    event->attr.msg_buf_size = msg.size();
+    msg.copy(event->msg, msg.size());
+  }
+
+  MemoryStats mem_stats;
+  SystemWideStandaloneContext ctx;
+  bool is_first_iter = true;
+  for (auto _ : state) {
+    state.PauseTiming();
+    {
+      auto source_connector = SocketTraceConnectorFriend::Create("socket_trace_connector");
+      auto socket_trace_connector =
+          static_cast<SocketTraceConnectorFriend*>(source_connector.get());
+      DataTables tables(SocketTraceConnector::kTables);
+
+      uint64_t ts = 1;
+      for (int fd = 0; fd < kNumConns; ++fd) {
+        socket_control_event_t open_event = {};
+        open_event.type = kConnOpen;
+        open_event.timestamp_ns = ts++;
+        open_event.conn_id = req_event->attr.conn_id;
+        open_event.conn_id.fd = fd;
+        open_event.open.addr.sa.sa_family = AF_INET;
+        open_event.open.role = kRoleServer;
+        socket_trace_connector->HandleControlEvent(&open_event, sizeof(open_event));
+      }
+      source_connector->TransferData(&ctx, tables.tables());
+      std::vector<uint64_t> req_pos(kNumConns, 0);
+      std::vector<uint64_t> resp_pos(kNumConns, 0);
+      uint64_t output_records = 0;
+      uint64_t output_bytes = 0;
+
+      MemoryTracker mem_tracker(is_first_iter);
+      if (is_first_iter) {
+        mem_tracker.Start();
+      }
+      state.ResumeTiming();
+
+      // START timed part of benchmark.
+
+      for (int i = 0; i < kNumEvents; ++i) {
+        // Each connection alternates between a request and its response.
+        int fd = (i / 2) % kNumConns;
+        bool is_req = i % 2 == 0;
+        socket_data_event_t* event = is_req ? req_event.get() : resp_event.get();
+        uint64_t* pos = is_req ? &req_pos[fd] : &resp_pos[fd];
+        event->attr.conn_id.fd = fd;
+        event->attr.timestamp_ns = ts++;
+        event->attr.pos = *pos;
+        *pos += event->attr.msg_size;
+        socket_trace_connector->HandleDataEvent(
+            event, sizeof(socket_data_event_t::attr) + event->attr.msg_size);
+
+        if ((i + 1) % kEventsPerPoll == 0) {
+          source_connector->TransferData(&ctx, tables.tables());
+          CountOutput(&tables, &output_records, &output_bytes);
+        }
+      }
+
+      // END timed part of benchmark.
+
+      state.PauseTiming();
+      if (is_first_iter) {
+        mem_stats = mem_tracker.End();
+      }
+    }
+    px::ReleaseFreeMemory();
+    is_first_iter = false;
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kNumEvents);
+  state.counters["EventsPerSec"] = Counter(state.iterations() * kNumEvents, Counter::kIsRate);
+  if (display_stat_categories.contains(DisplayStatCategory::AllocPeak)) {
+    state.counters["AllocPeak"] = Counter(mem_stats.max.allocated - mem_stats.start.allocated,
+                                          Counter::kDefaults, Counter::OneK::kIs1024);
+  }
+}
+
+BENCHMARK(BM_SocketTraceConnectorEventRate)->Unit(benchmark::kMillisecond);
+
+// Benchmark of the transport of socket data events from BPF to user-space: per-CPU perf buffers
+// vs. a single BPF ring buffer shared by all CPUs. Unlike the benchmarks above, this one deploys
+// the BPF probes and traces real loopback traffic, so it has to run as root. Each iteration writes
+// a burst of HTTP requests without polling in between, so the loss rate shows how much of a burst
+// each transport can absorb.
+
+// NOLINTNEXTLINE: runtime/references.
+static void BM_SocketTraceTransport(benchmark::State& state, bool use_ringbuf) {
+  const int num_msgs_per_burst = state.range(0);
+  constexpr int kMsgSize = 1024;
+
+  FLAGS_stirling_socket_tracer_use_ringbuf = use_ringbuf;
+  FLAGS_stirling_disable_self_tracing = false;
+
+  auto source_connector = SocketTraceConnectorFriend::Create("socket_trace_connector");
+  auto socket_trace_connector = static_cast<SocketTraceConnectorFriend*>(source_connector.get());
+  auto s = socket_trace_connector->Init();
+  if (!s.ok()) {
+    state.SkipWithError(s.ToString().c_str());
+    return;
+  }
+  if (socket_trace_connector->uses_ringbuf() != use_ringbuf) {
+    PL_CHECK_OK(socket_trace_connector->Stop());
+    state.SkipWithError("BPF ring buffers are not supported by the kernel.");
+    return;
+  }
+  FLAGS_test_only_socket_trace_target_pid = getpid();
+  PL_CHECK_OK(socket_trace_connector->TestOnlySetTargetPID());
+
+  TCPSocket server;
+  server.BindAndListen();
+  TCPSocket client;
+  client.Connect(server);
+  auto conn = server.Accept();
+  std::thread reader([&conn]() {
+    std::string data;
+    while (conn->Read(&data)) {
+      data.clear();
+    }
+  });
+
+  std::string msg = "GET /index.html HTTP/1.1\r\nHost: pixie\r\n\r\n";
+  msg.resize(kMsgSize, 'x');
+
+  SystemWideStandaloneContext ctx;
+  int64_t num_events = 0;
+  int64_t num_lost = 0;
+  for (auto _ : state) {
+    int64_t start_events = socket_trace_connector->NumDataEvents();
+    int64_t start_lost = socket_trace_connector->NumLostDataEvents();
+
+    for (int i = 0; i < num_msgs_per_burst; ++i) {
+      client.Write(msg);
+    }
+    // Drain the buffers, until a poll yields neither events nor losses.
+    int64_t prev_total = -1;
+    int64_t total = 0;
+    while (total != prev_total) {
+      prev_total = total;
+      socket_trace_connector->PollBPFEvents(&ctx);
+      total = socket_trace_connector->NumDataEvents() + socket_trace_connector->NumLostDataEvents();
+    }
+
+    num_events += socket_trace_connector->NumDataEvents() - start_events;
+    num_lost += socket_trace_connector->NumLostDataEvents() - start_lost;
+  }
+
+  client.Close();
+  reader.join();
+  PL_CHECK_OK(socket_trace_connector->Stop());
+
+  state.counters["EventsPerSec"] = Counter(num_events, Counter::kIsRate);
+  state.counters["LossRate"] = Counter(num_events + num_lost == 0
+                                           ? 0.0
+                                           : static_cast<double>(num_lost) / (num_events + num_lost));
+}
+
+BENCHMARK_CAPTURE(BM_SocketTraceTransport, perf_buffer, /*use_ringbuf*/ false)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SocketTraceTransport, ring_buffer, /*use_ringbuf*/ true)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16)
+    ->Unit(benchmark::kMillisecond);
@@ -18,7 +18,10 @@
 
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
 
+#include <cstring>
 #include <memory>
+#include <string_view>
+#include <vector>
 
 #include <absl/functional/bind_front.h>
 #include <gmock/gmock.h>
@@ -222,6 +225,38 @@ TEST_F(SocketTraceConnectorTest, Basic) {
   EXPECT_THAT(ToStringVector(records[kHTTPRespBodyIdx]), ElementsAre("foo"));
 }
 
+TEST_F(SocketTraceConnectorTest, QueuedEventsOwnTheirPayload) {
+  source_->InitIngestQueues(2);
+
+  struct socket_control_event_t conn = event_gen_.InitConn();
+  std::unique_ptr<SocketDataEvent> event0_req = event_gen_.InitSendEvent<kProtocolHTTP>(kReq3);
+  std::unique_ptr<SocketDataEvent> event0_resp_json =
+      event_gen_.InitRecvEvent<kProtocolHTTP>(kJSONResp);
+  struct socket_control_event_t close_event = event_gen_.InitClose();
+
+  // The msg of each event points into its BPF event, like it would into the BPF buffer.
+  std::vector<std::string_view> bpf_msgs = {event0_req->msg, event0_resp_json->msg};
+  source_->AcceptControlEvent(conn);
+  source_->AcceptDataEvent(std::move(event0_req));
+  source_->AcceptDataEvent(std::move(event0_resp_json));
+  source_->AcceptControlEvent(close_event);
+
+  // The BPF buffer is reused as soon as the callbacks return.
+  for (std::string_view msg : bpf_msgs) {
+    std::memset(const_cast<char*>(msg.data()), 'x', msg.size());
+  }
+
+  source_->ApplyIngestQueues();
+  connector_->TransferData(ctx_.get(), data_tables_.tables());
+
+  std::vector<TaggedRecordBatch> tablets = http_table_->ConsumeRecords();
+  ASSERT_NOT_EMPTY_AND_GET_RECORDS(RecordBatch & records, tablets);
+
+  ASSERT_THAT(records, RecordBatchSizeIs(1));
+  EXPECT_THAT(ToStringVector(records[kHTTPReqBodyIdx]), ElementsAre("I have a message body"));
+  EXPECT_THAT(ToStringVector(records[kHTTPRespBodyIdx]), ElementsAre("foo"));
+}
+
 TEST_F(SocketTraceConnectorTest, HTTPDelayedRespBody) {
   struct socket_control_event_t conn = event_gen_.InitConn();
   std::unique_ptr<SocketDataEvent> event0_req = event_gen_.InitSendEvent<kProtocolHTTP>(kReq4);
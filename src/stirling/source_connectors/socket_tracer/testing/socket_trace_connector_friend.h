@@ -69,6 +69,21 @@ class SocketTraceConnectorFriend : public SocketTraceConnector {
   void HandleHTTP2Data(go_grpc_data_event_t* data, int data_size) {
     SocketTraceConnector::HandleHTTP2Event(this, data, data_size);
   }
+
+  // Creates the queues of the pipelined ingest, without its threads, so that the accepted events
+  // are queued until ApplyIngestQueues() is called.
+  void InitIngestQueues(int num_queues) {
+    auto* metrics = &IngestStageMetrics::GetStageMetrics("socket_tracer_events");
+    for (int i = 0; i < num_queues; ++i) {
+      ingest_queues_.push_back(std::make_unique<BoundedQueue<IngestEvent>>(1024, metrics));
+    }
+  }
+  void ApplyIngestQueues() { SocketTraceConnector::ApplyIngestQueues(); }
+
+  // Polls the BPF buffers, as TransferData would, without transferring any records out.
+  void PollBPFEvents(ConnectorContext* ctx) { SocketTraceConnector::UpdateCommonState(ctx); }
+  int64_t NumDataEvents() const { return stats_.Get(StatKey::kPollSocketDataEventCount); }
+  int64_t NumLostDataEvents() const { return stats_.Get(StatKey::kLossSocketDataEvent); }
 };
 
 }  // namespace stirling
@@ -23,6 +23,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
@@ -37,6 +38,7 @@
 
 #include "src/stirling/bpf_tools/probe_cleaner.h"
 #include "src/stirling/core/data_table.h"
+#include "src/stirling/core/ingest_pipeline.h"
 #include "src/stirling/core/pub_sub_manager.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/core/source_registry.h"
@@ -243,6 +245,24 @@ class StirlingImpl final : public Stirling {
   // Wait for Stirling to stop its main loop.
   void WaitForStop();
 
+  // The push stage of the pipelined ingest (--stirling_ingest_worker_threads > 0): RunCore()
+  // queues the record batches, and the push thread hands them to data_push_callback_, so that a
+  // slow table store does not delay the next TransferData().
+  struct PushBatch {
+    uint32_t table_id;
+    types::TabletID tablet_id;
+    std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch;
+  };
+  void StartPushThread();
+  void StopPushThread();
+  void PushLoop();
+  Status QueuePushBatch(uint32_t table_id, types::TabletID tablet_id,
+                        std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch);
+
+  std::unique_ptr<BoundedQueue<PushBatch>> push_queue_;
+  std::thread push_thread_;
+  std::atomic<bool> push_enable_ = false;
+
   // Main thread used to spawn off RunThread().
   std::thread run_thread_;
 
@@ -812,6 +832,13 @@ void StirlingImpl::RunCore() {
   }
   // TODO(oazizi): We need to call InitContext on dynamic sources too. Fix.
 
+  DataPushCallback push_callback = data_push_callback_;
+  if (FLAGS_stirling_ingest_worker_threads > 0) {
+    StartPushThread();
+    push_callback = std::bind(&StirlingImpl::QueuePushBatch, this, std::placeholders::_1,
+                              std::placeholders::_2, std::placeholders::_3);
+  }
+
   // Indicates completion of initialization, and start of data collection.
   LOG(INFO) << "Stirling is running.";
 
@@ -838,7 +865,7 @@ void StirlingImpl::RunCore() {
         }
         // Phase 2: Push Data upstream.
         if (source->push_freq_mgr().Expired() || DataExceedsThreshold(output.data_tables)) {
-          source->PushData(data_push_callback_, output.data_tables);
+          source->PushData(push_callback, output.data_tables);
         }
       }
 
@@ -848,9 +875,54 @@ void StirlingImpl::RunCore() {
 
     SleepForDuration(sleep_duration);
   }
+  StopPushThread();
   running_ = false;
 }
 
+void StirlingImpl::StartPushThread() {
+  // Each batch holds up to a push period's worth of records of one table.
+  constexpr size_t kPushQueueCapacity = 1024;
+
+  push_queue_ = std::make_unique<BoundedQueue<PushBatch>>(
+      kPushQueueCapacity, &IngestStageMetrics::GetStageMetrics("push"));
+  push_enable_ = true;
+  push_thread_ = std::thread(&StirlingImpl::PushLoop, this);
+}
+
+void StirlingImpl::StopPushThread() {
+  if (!push_thread_.joinable()) {
+    return;
+  }
+  // The push thread flushes the queued batches before exiting.
+  push_enable_ = false;
+  push_queue_->Close();
+  push_thread_.join();
+}
+
+void StirlingImpl::PushLoop() {
+  constexpr auto kPopTimeout = std::chrono::milliseconds{100};
+
+  while (push_enable_ || push_queue_->size() > 0) {
+    std::optional<PushBatch> batch = push_queue_->Pop(kPopTimeout);
+    if (!batch.has_value()) {
+      continue;
+    }
+    Status s = data_push_callback_(batch->table_id, batch->tablet_id,
+                                   std::move(batch->record_batch));
+    LOG_IF(DFATAL, !s.ok()) << absl::Substitute("Failed to push data. Message = $0", s.msg());
+  }
+}
+
+Status StirlingImpl::QueuePushBatch(uint32_t table_id, types::TabletID tablet_id,
+                                    std::unique_ptr<types::ColumnWrapperRecordBatch> record_batch) {
+  // A full queue means the table store is not keeping up. Wait for it rather than dropping the
+  // batch, as the serial ingest would have waited on data_push_callback_ anyway.
+  if (!push_queue_->Push(PushBatch{table_id, tablet_id, std::move(record_batch)})) {
+    return error::Cancelled("Stirling is stopping, dropped a batch of table $0", table_id);
+  }
+  return Status::OK();
+}
+
 bool StirlingImpl::IsRunning() const { return running_; }
 
 Status StirlingImpl::WaitUntilRunning(std::chrono::milliseconds timeout) const {
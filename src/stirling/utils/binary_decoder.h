@@ -18,7 +18,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "src/common/base/base.h"
 
@@ -116,5 +122,134 @@ class BinaryDecoder {
   std::string_view buf_;
 };
 
+/**
+ * A BinaryDecoder over a buffer that is split into chunks, e.g. the result of
+ * DataStreamBuffer::HeadChunks(). Only the bytes of a value that straddles a chunk boundary are
+ * copied to make them contiguous; everything else is read in place.
+ */
+class ChunkedBinaryDecoder {
+ public:
+  explicit ChunkedBinaryDecoder(std::vector<std::string_view> chunks) : chunks_(std::move(chunks)) {
+    for (std::string_view chunk : chunks_) {
+      buf_size_ += chunk.size();
+    }
+    SkipConsumedChunks();
+  }
+
+  bool eof() const { return buf_size_ == 0; }
+  size_t BufSize() const { return buf_size_; }
+
+  template <typename TCharType = char>
+  StatusOr<TCharType> ExtractChar() {
+    static_assert(sizeof(TCharType) == 1);
+    if (buf_size_ < sizeof(TCharType)) {
+      return error::ResourceUnavailable("Insufficient number of bytes.");
+    }
+    TCharType res = CurrentChunk().front();
+    Advance(1);
+    return res;
+  }
+
+  template <typename TIntType>
+  StatusOr<TIntType> ExtractInt() {
+    if (buf_size_ < sizeof(TIntType)) {
+      return error::ResourceUnavailable("Insufficient number of bytes.");
+    }
+    std::string_view chunk = CurrentChunk();
+    if (chunk.size() >= sizeof(TIntType)) {
+      TIntType val = ::px::utils::BEndianBytesToInt<TIntType>(chunk);
+      Advance(sizeof(TIntType));
+      return val;
+    }
+    char bytes[sizeof(TIntType)];
+    CopyAndAdvance(bytes, sizeof(TIntType));
+    return ::px::utils::BEndianBytesToInt<TIntType>(std::string_view(bytes, sizeof(TIntType)));
+  }
+
+  // The returned view points into the chunk if the string fits in one; otherwise the string is
+  // copied into storage owned by the decoder, and the view is valid as long as the decoder is.
+  template <typename TCharType = char>
+  StatusOr<std::basic_string_view<TCharType>> ExtractString(size_t len) {
+    static_assert(sizeof(TCharType) == 1);
+    if (buf_size_ < len) {
+      return error::ResourceUnavailable("Insufficient number of bytes.");
+    }
+    std::string_view chunk = CurrentChunk();
+    if (chunk.size() < len) {
+      std::string& str = coalesced_.emplace_back(len, '\0');
+      CopyAndAdvance(str.data(), len);
+      return CreateStringView<TCharType>(std::string_view(str));
+    }
+    Advance(len);
+    return CreateStringView<TCharType>(chunk.substr(0, len));
+  }
+
+  // Extract len bytes as views into the chunks, without copying them. Meant for frame bodies,
+  // which are usually much larger than a chunk.
+  StatusOr<std::vector<std::string_view>> ExtractChunks(size_t len) {
+    if (buf_size_ < len) {
+      return error::ResourceUnavailable("Insufficient number of bytes.");
+    }
+    std::vector<std::string_view> res;
+    while (len > 0) {
+      std::string_view chunk = CurrentChunk().substr(0, len);
+      res.push_back(chunk);
+      Advance(chunk.size());
+      len -= chunk.size();
+    }
+    return res;
+  }
+
+  Status ExtractBufIgnore(uint64_t num_bytes) {
+    if (buf_size_ < num_bytes) {
+      return error::ResourceUnavailable("Insufficient number of bytes.");
+    }
+    Advance(num_bytes);
+    return Status::OK();
+  }
+
+ private:
+  std::string_view CurrentChunk() const { return chunks_[chunk_idx_].substr(chunk_offset_); }
+
+  // Move past the consumed chunks, so that CurrentChunk() is non-empty unless at eof.
+  void SkipConsumedChunks() {
+    while (chunk_idx_ < chunks_.size() && chunk_offset_ == chunks_[chunk_idx_].size()) {
+      ++chunk_idx_;
+      chunk_offset_ = 0;
+    }
+  }
+
+  // Advance by n bytes, which must be available.
+  void Advance(size_t n) {
+    while (n > 0) {
+      size_t step = std::min(n, chunks_[chunk_idx_].size() - chunk_offset_);
+      chunk_offset_ += step;
+      buf_size_ -= step;
+      n -= step;
+      SkipConsumedChunks();
+    }
+  }
+
+  // Copy the next n bytes, which must be available, to dst, and advance past them.
+  void CopyAndAdvance(char* dst, size_t n) {
+    while (n > 0) {
+      std::string_view chunk = CurrentChunk().substr(0, n);
+      memcpy(dst, chunk.data(), chunk.size());
+      dst += chunk.size();
+      n -= chunk.size();
+      Advance(chunk.size());
+    }
+  }
+
+  std::vector<std::string_view> chunks_;
+  size_t chunk_idx_ = 0;
+  size_t chunk_offset_ = 0;
+  size_t buf_size_ = 0;
+
+  // Strings that straddled a chunk boundary. A deque doesn't move its elements as it grows, so
+  // the views returned by ExtractString() stay valid.
+  std::deque<std::string> coalesced_;
+};
+
 }  // namespace stirling
 }  // namespace px
@@ -19,6 +19,7 @@
 #include "src/stirling/utils/binary_decoder.h"
 
 #include <string>
+#include <vector>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -28,6 +29,7 @@
 namespace px {
 namespace stirling {
 
+using ::testing::ElementsAre;
 using ::testing::StrEq;
 
 TEST(BinaryDecoderTest, ExtractChar) {
@@ -108,5 +110,41 @@ TEST(BinaryDecoderTest, TooShortText) {
   }
 }
 
+TEST(ChunkedBinaryDecoderTest, ExtractIntAcrossChunks) {
+  ChunkedBinaryDecoder bin_decoder({"\x01", "", "\x01\x01", "\x01\x01\x01"});
+
+  EXPECT_EQ(6, bin_decoder.BufSize());
+  ASSERT_OK_AND_EQ(bin_decoder.ExtractInt<int8_t>(), 1);
+  ASSERT_OK_AND_EQ(bin_decoder.ExtractInt<int32_t>(), 16843009);
+  EXPECT_NOT_OK(bin_decoder.ExtractInt<int16_t>());
+  ASSERT_OK_AND_EQ(bin_decoder.ExtractChar<uint8_t>(), 1);
+  EXPECT_TRUE(bin_decoder.eof());
+}
+
+TEST(ChunkedBinaryDecoderTest, ExtractString) {
+  std::string_view first("abc1");
+  ChunkedBinaryDecoder bin_decoder({first, "23def"});
+
+  // A string within a chunk is not copied.
+  ASSERT_OK_AND_ASSIGN(std::string_view abc, bin_decoder.ExtractString(3));
+  EXPECT_EQ(abc, "abc");
+  EXPECT_EQ(abc.data(), first.data());
+
+  ASSERT_OK_AND_EQ(bin_decoder.ExtractString(3), "123");
+  EXPECT_NOT_OK(bin_decoder.ExtractString(4));
+  ASSERT_OK(bin_decoder.ExtractBufIgnore(1));
+  ASSERT_OK_AND_EQ(bin_decoder.ExtractString(2), "ef");
+  EXPECT_TRUE(bin_decoder.eof());
+}
+
+TEST(ChunkedBinaryDecoderTest, ExtractChunks) {
+  ChunkedBinaryDecoder bin_decoder({ConstStringView("\x00\x05ab"), "cd", "ef"});
+
+  ASSERT_OK_AND_ASSIGN(uint16_t len, bin_decoder.ExtractInt<uint16_t>());
+  ASSERT_OK_AND_ASSIGN(std::vector<std::string_view> body, bin_decoder.ExtractChunks(len));
+  EXPECT_THAT(body, ElementsAre("ab", "cd", "e"));
+  EXPECT_EQ(1, bin_decoder.BufSize());
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -55,6 +57,35 @@ class StatCounter {
   std::vector<int64_t> counts_ = std::vector<int64_t>(magic_enum::enum_count<TKeyType>(), 0);
 };
 
+/**
+ * Same as StatCounter, but safe to update and read from multiple threads. The counters are
+ * independent of each other, so Print() is not a consistent snapshot of all of them.
+ */
+template <typename TKeyType>
+class AtomicStatCounter {
+ public:
+  void Increment(TKeyType key, int count = 1) {
+    counts_[static_cast<int>(key)].fetch_add(count, std::memory_order_relaxed);
+  }
+  void Decrement(TKeyType key, int count = 1) {
+    counts_[static_cast<int>(key)].fetch_sub(count, std::memory_order_relaxed);
+  }
+  void Reset(TKeyType key) { counts_[static_cast<int>(key)].store(0, std::memory_order_relaxed); }
+  int64_t Get(TKeyType key) const {
+    return counts_[static_cast<int>(key)].load(std::memory_order_relaxed);
+  }
+  std::string Print() const {
+    std::string out;
+    for (auto key : magic_enum::enum_values<TKeyType>()) {
+      absl::StrAppend(&out, absl::Substitute("$0=$1 ", magic_enum::enum_name(key), Get(key)));
+    }
+    return out;
+  }
+
+ private:
+  std::array<std::atomic<int64_t>, magic_enum::enum_count<TKeyType>()> counts_ = {};
+};
+
 }  // namespace utils
 }  // namespace stirling
 }  // namespace px
@@ -18,6 +18,9 @@
 
 #include "src/stirling/utils/stat_counter.h"
 
+#include <thread>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -56,6 +59,28 @@ TEST(StatCounterTest, CheckValuesAndPrint) {
   EXPECT_THAT(counter.Print(), StrEq("kFirst=-1 kSecond=0 "));
 }
 
+// Tests that AtomicStatCounter doesn't lose the increments of concurrent threads.
+TEST(AtomicStatCounterTest, ConcurrentIncrements) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumIncrements = 10000;
+  AtomicStatCounter<Key> counter;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&counter]() {
+      for (int j = 0; j < kNumIncrements; ++j) {
+        counter.Increment(Key::kSecond);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(counter.Get(Key::kSecond), kNumThreads * kNumIncrements);
+  EXPECT_THAT(counter.Print(), StrEq("kFirst=0 kSecond=40000 "));
+}
+
 }  // namespace utils
 }  // namespace stirling
 }  // namespace px
@@ -18,13 +18,19 @@
 
 #include <arrow/array.h>
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
 #include <absl/strings/str_format.h>
+#include <absl/strings/str_join.h>
 #include "src/common/base/base.h"
 #include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/schema/row_batch.h"
 
@@ -58,6 +64,9 @@ std::string RowBatch::DebugString() const {
     return "RowBatch: <empty>";
   }
   std::string debug_string = absl::StrFormat("RowBatch(eow=%d, eos=%d):\n", eow_, eos_);
+  if (selection_ != nullptr) {
+    debug_string += absl::StrFormat("  selection=[%s]\n", absl::StrJoin(*selection_, ", "));
+  }
   for (const auto& col : columns_) {
     debug_string += absl::StrFormat("  %s\n", col->ToString());
   }
@@ -120,24 +129,52 @@ constexpr const auto& GetPBDataColumn(const table_store::schemapb::Column& data_
 }
 
 template <DataType T>
-void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array* input_column) {
+void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array* input_column,
+                      const RowBatch& rb) {
   CHECK_NOTNULL(input_column);
   CHECK_NOTNULL(output_column);
 
-  size_t col_length = input_column->length();
+  int64_t num_rows = rb.num_selected_rows();
   auto casted_output_data = GetMutablePBDataColumn<T>(output_column);
-  for (size_t i = 0; i < col_length; ++i) {
+  for (int64_t i = 0; i < num_rows; ++i) {
+    auto row_idx = rb.selected_row(i);
     if constexpr (T == DataType::UINT128) {
       auto out_datum = casted_output_data->add_data();
-      auto val = types::GetValueFromArrowArray<DataType::UINT128>(input_column, i);
+      auto val = types::GetValueFromArrowArray<DataType::UINT128>(input_column, row_idx);
       out_datum->set_high(absl::Uint128High64(val));
       out_datum->set_low(absl::Uint128Low64(val));
     } else {
-      casted_output_data->add_data(types::GetValueFromArrowArray<T>(input_column, i));
+      casted_output_data->add_data(types::GetValueFromArrowArray<T>(input_column, row_idx));
     }
   }
 }
 
+template <DataType T>
+Status CopySelectedRows(const arrow::Array* input_col, const RowBatch::SelectionVector& selection,
+                        RowBatch* output_rb) {
+  auto output_col_builder_generic = MakeArrowBuilder(T, arrow::default_memory_pool());
+  auto* output_col_builder = static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(
+      output_col_builder_generic.get());
+  PL_RETURN_IF_ERROR(output_col_builder->Reserve(selection.size()));
+  if constexpr (T == DataType::STRING) {
+    int64_t total_size = 0;
+    for (auto row_idx : selection) {
+      total_size += types::GetStringViewFromArrowArray(input_col, row_idx).size();
+    }
+    PL_RETURN_IF_ERROR(output_col_builder->ReserveData(total_size));
+    for (auto row_idx : selection) {
+      output_col_builder->UnsafeAppend(types::GetStringViewFromArrowArray(input_col, row_idx));
+    }
+  } else {
+    for (auto row_idx : selection) {
+      output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, row_idx));
+    }
+  }
+  std::shared_ptr<arrow::Array> output_array;
+  PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
+  return output_rb->AddColumn(output_array);
+}
+
 template <DataType T>
 Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
                        const table_store::schemapb::Column& input_column) {
@@ -159,7 +196,7 @@ Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
 }
 
 Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
-  proto->set_num_rows(num_rows_);
+  proto->set_num_rows(num_selected_rows());
   proto->set_eow(eow_);
   proto->set_eos(eos_);
 
@@ -168,7 +205,7 @@ Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
     auto output_col_data = proto->add_cols();
     auto dt = desc_.type(col_idx);
 
-#define TYPE_CASE(_dt_) CopyIntoOutputPB<_dt_>(output_col_data, input_col);
+#define TYPE_CASE(_dt_) CopyIntoOutputPB<_dt_>(output_col_data, input_col, *this);
     PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
 #undef TYPE_CASE
   }
@@ -223,6 +260,340 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
   return output_rb;
 }
 
+// Serialize/deserialize from the columnar protobuf format.
+
+namespace {
+
+using table_store::schemapb::ColumnarColumn;
+
+// A string column is only dictionary encoded if it has at most this fraction of distinct values.
+constexpr double kMaxDictionaryRatio = 0.5;
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::string_view* buf, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && !buf->empty(); shift += 7) {
+    auto byte = static_cast<uint8_t>(buf->front());
+    buf->remove_prefix(1);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t ZigZagEncode(uint64_t value) {
+  return (value << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63);
+}
+
+uint64_t ZigZagDecode(uint64_t value) { return (value >> 1) ^ (~(value & 1) + 1); }
+
+template <typename TNative>
+void AppendFixedWidth(const TNative& value, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(TNative));
+}
+
+// Dictionary encodes the selected rows of the string column. Returns false, leaving the output
+// column untouched, if the column has too many distinct values for it to pay off.
+bool DictionaryEncodeStrings(const arrow::Array* input_col, const RowBatch& rb,
+                             ColumnarColumn* output_col) {
+  int64_t num_rows = rb.num_selected_rows();
+  auto max_entries = static_cast<int64_t>(num_rows * kMaxDictionaryRatio);
+  absl::flat_hash_map<std::string_view, uint64_t> dictionary;
+  std::string indices;
+  indices.reserve(num_rows);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    auto value = types::GetStringViewFromArrowArray(input_col, rb.selected_row(i));
+    auto [it, inserted] = dictionary.try_emplace(value, dictionary.size());
+    if (inserted && static_cast<int64_t>(dictionary.size()) > max_entries) {
+      return false;
+    }
+    AppendVarint(it->second, &indices);
+  }
+
+  std::vector<std::string_view> entries(dictionary.size());
+  for (const auto& [value, idx] : dictionary) {
+    entries[idx] = value;
+  }
+  auto* lengths = output_col->mutable_lengths();
+  auto* data = output_col->mutable_dictionary();
+  for (const auto& entry : entries) {
+    AppendVarint(entry.size(), lengths);
+    data->append(entry);
+  }
+  *output_col->mutable_data() = std::move(indices);
+  output_col->set_encoding(ColumnarColumn::DICTIONARY);
+  return true;
+}
+
+// PL_CARNOT_UPDATE_FOR_NEW_TYPES
+template <DataType T>
+void CopyIntoColumnarPB(ColumnarColumn* output_col, const arrow::Array* input_col,
+                        const RowBatch& rb, const RowBatch::ColumnarEncodingOptions& opts) {
+  using native_type = typename types::DataTypeTraits<T>::native_type;
+  int64_t num_rows = rb.num_selected_rows();
+  output_col->set_data_type(T);
+  output_col->set_encoding(ColumnarColumn::PLAIN);
+  auto* data = output_col->mutable_data();
+
+  if constexpr (T == DataType::INT64 || T == DataType::TIME64NS) {
+    if (opts.compress) {
+      output_col->set_encoding(ColumnarColumn::DELTA_VARINT);
+      data->reserve(num_rows * 2);
+      uint64_t prev = 0;
+      for (int64_t i = 0; i < num_rows; ++i) {
+        auto value = static_cast<uint64_t>(
+            types::GetValueFromArrowArray<T>(input_col, rb.selected_row(i)));
+        AppendVarint(ZigZagEncode(value - prev), data);
+        prev = value;
+      }
+      return;
+    }
+  }
+  if constexpr (T == DataType::INT64 || T == DataType::TIME64NS || T == DataType::FLOAT64) {
+    using arrow_array_type = typename types::DataTypeTraits<T>::arrow_array_type;
+    if (!rb.HasSelection()) {
+      // The values are already contiguous, copy them in one go.
+      const auto* values = static_cast<const arrow_array_type*>(input_col)->raw_values();
+      data->assign(reinterpret_cast<const char*>(values), num_rows * sizeof(native_type));
+      return;
+    }
+    data->reserve(num_rows * sizeof(native_type));
+    for (int64_t i = 0; i < num_rows; ++i) {
+      AppendFixedWidth(types::GetValueFromArrowArray<T>(input_col, rb.selected_row(i)), data);
+    }
+  } else if constexpr (T == DataType::UINT128) {
+    data->reserve(num_rows * 2 * sizeof(uint64_t));
+    for (int64_t i = 0; i < num_rows; ++i) {
+      auto value = types::GetValueFromArrowArray<T>(input_col, rb.selected_row(i));
+      AppendFixedWidth(absl::Uint128Low64(value), data);
+      AppendFixedWidth(absl::Uint128High64(value), data);
+    }
+  } else if constexpr (T == DataType::BOOLEAN) {
+    data->resize(num_rows);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      (*data)[i] = types::GetValueFromArrowArray<T>(input_col, rb.selected_row(i)) ? 1 : 0;
+    }
+  } else if constexpr (T == DataType::STRING) {
+    if (opts.compress && DictionaryEncodeStrings(input_col, rb, output_col)) {
+      return;
+    }
+    auto* lengths = output_col->mutable_lengths();
+    lengths->reserve(num_rows);
+    for (int64_t i = 0; i < num_rows; ++i) {
+      auto value = types::GetStringViewFromArrowArray(input_col, rb.selected_row(i));
+      AppendVarint(value.size(), lengths);
+      data->append(value);
+    }
+  } else {
+    static_assert(sizeof(T) != 0, "Unsupported data type");
+  }
+}
+
+// Reads the varint encoded string sizes of a STRING column.
+Status ReadStringLengths(const std::string& buf, int64_t expected_total_size,
+                         std::vector<uint64_t>* lengths) {
+  std::string_view remaining(buf);
+  uint64_t total_size = 0;
+  while (!remaining.empty()) {
+    uint64_t length;
+    if (!ReadVarint(&remaining, &length)) {
+      return error::InvalidArgument("Truncated string lengths in columnar row batch");
+    }
+    total_size += length;
+    lengths->push_back(length);
+  }
+  if (total_size != static_cast<uint64_t>(expected_total_size)) {
+    return error::InvalidArgument("String lengths add up to $0 bytes, but got $1 bytes of data",
+                                  total_size, expected_total_size);
+  }
+  return Status::OK();
+}
+
+template <DataType T>
+Status CopyFromColumnarPB(std::shared_ptr<arrow::Array>* output_column,
+                          const ColumnarColumn& input_column, int64_t num_rows) {
+  using native_type = typename types::DataTypeTraits<T>::native_type;
+  constexpr bool kContiguousValues = T == DataType::INT64 || T == DataType::TIME64NS ||
+                                     T == DataType::FLOAT64 || T == DataType::UINT128;
+  const auto& data = input_column.data();
+
+  auto check_data_size = [&](int64_t value_size) -> Status {
+    if (static_cast<int64_t>(data.size()) != num_rows * value_size) {
+      return error::InvalidArgument("Expected $0 bytes for $1 rows of $2, got $3",
+                                    num_rows * value_size, num_rows, magic_enum::enum_name(T),
+                                    data.size());
+    }
+    return Status::OK();
+  };
+
+  if constexpr (kContiguousValues) {
+    if (input_column.encoding() == ColumnarColumn::PLAIN) {
+      // The values are sent in the layout of an arrow values buffer (UINT128s as their low then
+      // high 64 bits, like absl::uint128 on little endian), so they're copied in one go into a
+      // column that the output array shares.
+      PL_RETURN_IF_ERROR(check_data_size(sizeof(native_type)));
+      auto col = types::ColumnWrapper::Make(T, num_rows);
+      std::memcpy(col->UnsafeRawData(), data.data(), data.size());
+      *output_column = types::ShareAsArrow(col, arrow::default_memory_pool());
+      return Status::OK();
+    }
+  }
+
+  auto builder_generic = MakeArrowBuilder(T, arrow::default_memory_pool());
+  auto* builder = static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(
+      builder_generic.get());
+  PL_RETURN_IF_ERROR(builder->Reserve(num_rows));
+
+  switch (input_column.encoding()) {
+    case ColumnarColumn::PLAIN:
+      if constexpr (T == DataType::BOOLEAN) {
+        PL_RETURN_IF_ERROR(check_data_size(1));
+        // Arrow bit packs the bytes, treating any non-zero byte as true.
+        PL_RETURN_IF_ERROR(
+            builder->AppendValues(reinterpret_cast<const uint8_t*>(data.data()), num_rows));
+      } else if constexpr (T == DataType::STRING) {
+        std::vector<uint64_t> lengths;
+        lengths.reserve(num_rows);
+        PL_RETURN_IF_ERROR(ReadStringLengths(input_column.lengths(), data.size(), &lengths));
+        if (static_cast<int64_t>(lengths.size()) != num_rows) {
+          return error::InvalidArgument("Expected $0 strings, got $1", num_rows, lengths.size());
+        }
+        PL_RETURN_IF_ERROR(builder->ReserveData(data.size()));
+        std::string_view remaining(data);
+        for (auto length : lengths) {
+          builder->UnsafeAppend(remaining.substr(0, length));
+          remaining.remove_prefix(length);
+        }
+      } else if constexpr (!kContiguousValues) {
+        static_assert(sizeof(T) != 0, "Unsupported data type");
+      }
+      break;
+    case ColumnarColumn::DELTA_VARINT:
+      if constexpr (T == DataType::INT64 || T == DataType::TIME64NS) {
+        std::string_view remaining(data);
+        uint64_t value = 0;
+        for (int64_t i = 0; i < num_rows; ++i) {
+          uint64_t delta;
+          if (!ReadVarint(&remaining, &delta)) {
+            return error::InvalidArgument("Expected $0 delta encoded values, got $1", num_rows, i);
+          }
+          value += ZigZagDecode(delta);
+          builder->UnsafeAppend(static_cast<native_type>(value));
+        }
+        break;
+      }
+      return error::InvalidArgument("DELTA_VARINT encoding is not supported for $0",
+                                    magic_enum::enum_name(T));
+    case ColumnarColumn::DICTIONARY:
+      if constexpr (T == DataType::STRING) {
+        const auto& dictionary_data = input_column.dictionary();
+        std::vector<uint64_t> lengths;
+        PL_RETURN_IF_ERROR(
+            ReadStringLengths(input_column.lengths(), dictionary_data.size(), &lengths));
+        std::vector<std::string_view> entries;
+        entries.reserve(lengths.size());
+        std::string_view remaining(dictionary_data);
+        for (auto length : lengths) {
+          entries.push_back(remaining.substr(0, length));
+          remaining.remove_prefix(length);
+        }
+
+        std::vector<uint64_t> indices(num_rows);
+        int64_t total_size = 0;
+        std::string_view remaining_indices(data);
+        for (int64_t i = 0; i < num_rows; ++i) {
+          if (!ReadVarint(&remaining_indices, &indices[i]) || indices[i] >= entries.size()) {
+            return error::InvalidArgument("Invalid dictionary index for row $0", i);
+          }
+          total_size += entries[indices[i]].size();
+        }
+        PL_RETURN_IF_ERROR(builder->ReserveData(total_size));
+        for (auto idx : indices) {
+          builder->UnsafeAppend(entries[idx]);
+        }
+        break;
+      }
+      return error::InvalidArgument("DICTIONARY encoding is not supported for $0",
+                                    magic_enum::enum_name(T));
+    default:
+      return error::InvalidArgument("Unknown columnar encoding $0",
+                                    magic_enum::enum_name(input_column.encoding()));
+  }
+  PL_RETURN_IF_ERROR(builder->Finish(output_column));
+  return Status::OK();
+}
+
+// PL_CARNOT_UPDATE_FOR_NEW_TYPES
+StatusOr<DataType> ColumnarDataType(const ColumnarColumn& proto) {
+  switch (proto.data_type()) {
+    case DataType::BOOLEAN:
+    case DataType::INT64:
+    case DataType::UINT128:
+    case DataType::TIME64NS:
+    case DataType::FLOAT64:
+    case DataType::STRING:
+      return proto.data_type();
+    default:
+      return error::Internal("Received unknown column data type '$0' in ColumnarDataType",
+                             magic_enum::enum_name(proto.data_type()));
+  }
+}
+
+}  // namespace
+
+Status RowBatch::ToColumnarProto(const ColumnarEncodingOptions& opts,
+                                 table_store::schemapb::ColumnarRowBatchData* proto) const {
+  proto->set_num_rows(num_selected_rows());
+  proto->set_eow(eow_);
+  proto->set_eos(eos_);
+
+  for (auto col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    auto input_col = ColumnAt(col_idx).get();
+    auto output_col = proto->add_cols();
+
+#define TYPE_CASE(_dt_) CopyIntoColumnarPB<_dt_>(output_col, input_col, *this, opts);
+    PL_SWITCH_FOREACH_DATATYPE(desc_.type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnarProto(
+    const table_store::schemapb::ColumnarRowBatchData& proto) {
+  std::vector<DataType> types(proto.cols_size());
+  std::vector<std::shared_ptr<arrow::Array>> data_columns(proto.cols_size());
+
+  for (auto i = 0; i < proto.cols_size(); ++i) {
+    PL_ASSIGN_OR_RETURN(types[i], ColumnarDataType(proto.cols(i)));
+
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopyFromColumnarPB<_dt_>(&data_columns[i], proto.cols(i), proto.num_rows()));
+    PL_SWITCH_FOREACH_DATATYPE(types[i], TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  RowDescriptor desc(types);
+  std::unique_ptr<RowBatch> output_rb = std::make_unique<RowBatch>(desc, proto.num_rows());
+  output_rb->set_eow(proto.eow());
+  output_rb->set_eos(proto.eos());
+
+  for (auto i = 0; i < proto.cols_size(); ++i) {
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(data_columns[i]));
+  }
+
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnBuilders(
     const RowDescriptor& desc, bool eow, bool eos,
     std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders) {
@@ -252,7 +623,51 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::WithZeroRows(const RowDescriptor&
   return RowBatch::FromColumnBuilders(desc, eow, eos, &builders);
 }
 
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::Materialize() const {
+  auto output_rb = std::make_unique<RowBatch>(desc_, num_selected_rows());
+  output_rb->set_eow(eow_);
+  output_rb->set_eos(eos_);
+  for (int64_t col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    if (selection_ == nullptr) {
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(ColumnAt(col_idx)));
+      continue;
+    }
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopySelectedRows<_dt_>(ColumnAt(col_idx).get(), *selection_, output_rb.get()));
+    PL_SWITCH_FOREACH_DATATYPE(desc_.type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return output_rb;
+}
+
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::Materialize(
+    const std::vector<int64_t>& col_idxs) const {
+  if (selection_ == nullptr) {
+    return Materialize();
+  }
+  std::vector<bool> gather(num_columns(), false);
+  for (auto col_idx : col_idxs) {
+    DCHECK_LT(col_idx, num_columns());
+    gather[col_idx] = true;
+  }
+  auto output_rb = std::make_unique<RowBatch>(desc_, num_selected_rows());
+  output_rb->set_eow(eow_);
+  output_rb->set_eos(eos_);
+  for (int64_t col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    if (!gather[col_idx]) {
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(ColumnAt(col_idx)->Slice(0, num_selected_rows())));
+      continue;
+    }
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopySelectedRows<_dt_>(ColumnAt(col_idx).get(), *selection_, output_rb.get()));
+    PL_SWITCH_FOREACH_DATATYPE(desc_.type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::Slice(int64_t offset, int64_t length) const {
+  DCHECK(selection_ == nullptr) << "Slice of a row batch with a selection vector";
   if (offset + length > num_rows() || offset < 0) {
     return error::InvalidArgument("Slice(offset=$0, length=$1) on rowbatch of length $2 is invalid",
                                   offset, length, num_rows());
@@ -36,9 +36,23 @@ namespace schema {
 /**
  * A RowBatch is a table-like structure which consists of equal-length arrays
  * that match the schema described by the RowDescriptor.
+ *
+ * A RowBatch can also carry a selection vector, the ordered list of rows of its arrays that are
+ * part of the batch. Operators such as FilterNode set one instead of copying the rows that pass
+ * into new arrays, and the rows are only copied once a consumer needs compact arrays (see
+ * Materialize). num_rows() and the array lengths always describe the arrays, consumers that
+ * accept selection vectors must only read the rows given by selected_row().
  */
 class RowBatch {
  public:
+  using SelectionVector = std::vector<int64_t>;
+
+  struct ColumnarEncodingOptions {
+    // Delta-varint encode INT64/TIME64NS columns and dictionary encode STRING columns with few
+    // distinct values. Costs some CPU on both ends in exchange for fewer bytes on the wire.
+    bool compress = false;
+  };
+
   /**
    * Creates a row batch.
    *
@@ -53,6 +67,16 @@ class RowBatch {
   static StatusOr<std::unique_ptr<RowBatch>> FromProto(
       const table_store::schemapb::RowBatchData& row_batch_proto);
 
+  /**
+   * Serializes the (selected rows of the) row batch into the columnar format, which copies whole
+   * buffers instead of adding every value to the proto on its own. Used to transfer row batches
+   * between agents.
+   */
+  Status ToColumnarProto(const ColumnarEncodingOptions& opts,
+                         table_store::schemapb::ColumnarRowBatchData* row_batch_proto) const;
+  static StatusOr<std::unique_ptr<RowBatch>> FromColumnarProto(
+      const table_store::schemapb::ColumnarRowBatchData& row_batch_proto);
+
   static StatusOr<std::unique_ptr<RowBatch>> FromColumnBuilders(
       const RowDescriptor& desc, bool eow, bool eos,
       std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders);
@@ -67,7 +91,7 @@ class RowBatch {
    * @brief Returns a slice of the specified `length` starting at the `offset` from the RowBatch.
    *
    * RowBatch Slice has the same columns as this rowbatch, just of length `length` and starting at
-   * `offset`. Does not set eow and eos.
+   * `offset`. Does not set eow and eos. The row batch must not have a selection vector.
    *
    *
    * @param offset The starting position of the slice.
@@ -99,6 +123,45 @@ class RowBatch {
    */
   int64_t num_rows() const { return num_rows_; }
 
+  /**
+   * Sets the selection vector of the row batch.
+   * @param selection the indexes of the selected rows, in increasing order.
+   */
+  void SetSelection(std::shared_ptr<const SelectionVector> selection) {
+    selection_ = std::move(selection);
+  }
+  bool HasSelection() const { return selection_ != nullptr; }
+  const std::shared_ptr<const SelectionVector>& selection() const { return selection_; }
+
+  /**
+   * @ return the number of rows that are part of the batch, ie. the number of selected rows if
+   * the batch has a selection vector.
+   */
+  int64_t num_selected_rows() const {
+    return selection_ == nullptr ? num_rows_ : static_cast<int64_t>(selection_->size());
+  }
+
+  /**
+   * @ param i the index of the row in the batch, between 0 and num_selected_rows().
+   * @ return the index of the row in the batch's arrays.
+   */
+  int64_t selected_row(int64_t i) const { return selection_ == nullptr ? i : (*selection_)[i]; }
+
+  /**
+   * @brief Returns a row batch that holds only the selected rows, without a selection vector.
+   * If the batch has no selection vector, the arrays are shared rather than copied. Sets the same
+   * eow and eos as this row batch.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> Materialize() const;
+
+  /**
+   * @brief Like Materialize(), but only copies the selected rows of the given columns. The other
+   * columns are zero-copy slices of this batch's arrays, which have the right length and type but
+   * hold arbitrary rows, so the result must only be read at col_idxs. Used to evaluate expressions
+   * on the selected rows without gathering the columns they don't read.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> Materialize(const std::vector<int64_t>& col_idxs) const;
+
   /**
    * @ return the number of columns which the row batch should contain.
    */
@@ -126,6 +189,8 @@ class RowBatch {
   bool eow_ = false;
   bool eos_ = false;
   std::vector<std::shared_ptr<arrow::Array>> columns_;
+  // Shared since batches are copied when they are queued or passed to multiple consumers.
+  std::shared_ptr<const SelectionVector> selection_;
 };
 
 // Append a scalar value to an arrow::Array.
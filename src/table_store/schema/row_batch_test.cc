@@ -179,6 +179,60 @@ TEST_F(RowBatchTest, to_from_proto) {
   EXPECT_TRUE(differ.Compare(input_proto, output_proto));
 }
 
+TEST_F(RowBatchTest, to_from_columnar_proto) {
+  table_store::schemapb::RowBatchData input_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kTestRowBatchProto, &input_proto));
+  auto rb = RowBatch::FromProto(input_proto).ConsumeValueOrDie();
+
+  for (bool compress : {false, true}) {
+    RowBatch::ColumnarEncodingOptions opts;
+    opts.compress = compress;
+    table_store::schemapb::ColumnarRowBatchData columnar_proto;
+    EXPECT_OK(rb->ToColumnarProto(opts, &columnar_proto));
+    EXPECT_EQ(compress ? schemapb::ColumnarColumn::DELTA_VARINT : schemapb::ColumnarColumn::PLAIN,
+              columnar_proto.cols(1).encoding());
+
+    ASSERT_OK_AND_ASSIGN(auto output_rb, RowBatch::FromColumnarProto(columnar_proto));
+    EXPECT_EQ(rb->desc(), output_rb->desc());
+    table_store::schemapb::RowBatchData output_proto;
+    EXPECT_OK(output_rb->ToProto(&output_proto));
+    google::protobuf::util::MessageDifferencer differ;
+    EXPECT_TRUE(differ.Compare(input_proto, output_proto));
+  }
+}
+
+TEST_F(RowBatchTest, columnar_proto_compression) {
+  std::vector<types::Time64NSValue> times = {1000, 999, 5000000000, -20, 0, 7};
+  std::vector<types::StringValue> strs = {"GET", "POST", "GET", "GET", "POST", "GET"};
+  std::vector<types::BoolValue> bools = {true, false, false, true, true, false};
+  RowBatch rb(RowDescriptor({types::DataType::TIME64NS, types::DataType::STRING,
+                             types::DataType::BOOLEAN}),
+              times.size());
+  EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+  EXPECT_OK(rb.AddColumn(types::ToArrow(strs, arrow::default_memory_pool())));
+  EXPECT_OK(rb.AddColumn(types::ToArrow(bools, arrow::default_memory_pool())));
+  rb.SetSelection(
+      std::make_shared<RowBatch::SelectionVector>(RowBatch::SelectionVector{0, 1, 3, 4, 5}));
+  rb.set_eos(true);
+
+  RowBatch::ColumnarEncodingOptions opts;
+  opts.compress = true;
+  table_store::schemapb::ColumnarRowBatchData columnar_proto;
+  EXPECT_OK(rb.ToColumnarProto(opts, &columnar_proto));
+  EXPECT_EQ(5, columnar_proto.num_rows());
+  EXPECT_EQ(schemapb::ColumnarColumn::DICTIONARY, columnar_proto.cols(1).encoding());
+  EXPECT_EQ("GETPOST", columnar_proto.cols(1).dictionary());
+
+  ASSERT_OK_AND_ASSIGN(auto output_rb, RowBatch::FromColumnarProto(columnar_proto));
+  ASSERT_OK_AND_ASSIGN(auto materialized_rb, rb.Materialize());
+  EXPECT_TRUE(output_rb->eos());
+  EXPECT_EQ(materialized_rb->DebugString(), output_rb->DebugString());
+
+  // Malformed batches are rejected rather than read out of bounds.
+  columnar_proto.mutable_cols(1)->set_data("\x05");
+  EXPECT_NOT_OK(RowBatch::FromColumnarProto(columnar_proto));
+}
+
 TEST_F(RowBatchTest, with_zero_rows) {
   bool eow = true;
   bool eos = false;
@@ -190,6 +244,49 @@ TEST_F(RowBatchTest, with_zero_rows) {
   EXPECT_EQ(eos, rb->eos());
 }
 
+TEST_F(RowBatchTest, materialize_selection) {
+  rb_->SetSelection(std::make_shared<RowBatch::SelectionVector>(RowBatch::SelectionVector{0, 2}));
+  rb_->set_eow(true);
+  EXPECT_EQ(3, rb_->num_rows());
+  EXPECT_EQ(2, rb_->num_selected_rows());
+  EXPECT_EQ(2, rb_->selected_row(1));
+
+  ASSERT_OK_AND_ASSIGN(auto output_rb, rb_->Materialize());
+  EXPECT_FALSE(output_rb->HasSelection());
+  EXPECT_EQ(2, output_rb->num_rows());
+  EXPECT_TRUE(output_rb->eow());
+  EXPECT_EQ(
+      "RowBatch(eow=1, eos=0):\n  [\n  true,\n  true\n]\n  [\n  3,\n  5\n]\n  [\n  "
+      "3.3,\n  5.6\n]\n",
+      output_rb->DebugString());
+
+  // Serializing the batch only includes the selected rows.
+  table_store::schemapb::RowBatchData selected_proto;
+  EXPECT_OK(rb_->ToProto(&selected_proto));
+  table_store::schemapb::RowBatchData materialized_proto;
+  EXPECT_OK(output_rb->ToProto(&materialized_proto));
+  google::protobuf::util::MessageDifferencer differ;
+  EXPECT_TRUE(differ.Compare(materialized_proto, selected_proto));
+}
+
+TEST_F(RowBatchTest, materialize_selected_columns) {
+  rb_->SetSelection(std::make_shared<RowBatch::SelectionVector>(RowBatch::SelectionVector{0, 2}));
+
+  ASSERT_OK_AND_ASSIGN(auto output_rb, rb_->Materialize(std::vector<int64_t>{1}));
+  EXPECT_FALSE(output_rb->HasSelection());
+  EXPECT_EQ(2, output_rb->num_rows());
+  EXPECT_TRUE(output_rb->ColumnAt(1)->Equals(
+      types::ToArrow(std::vector<types::Int64Value>{3, 5}, arrow::default_memory_pool())));
+  // The other columns aren't copied: they share the input's buffers.
+  for (int64_t col_idx : {0, 2}) {
+    EXPECT_EQ(2, output_rb->ColumnAt(col_idx)->length());
+    EXPECT_EQ(rb_->ColumnAt(col_idx)->data()->buffers[1]->data(),
+              output_rb->ColumnAt(col_idx)->data()->buffers[1]->data());
+  }
+  EXPECT_NE(rb_->ColumnAt(1)->data()->buffers[1]->data(),
+            output_rb->ColumnAt(1)->data()->buffers[1]->data());
+}
+
 TEST_F(RowBatchTest, slice) {
   EXPECT_EQ(3, rb_->num_rows());
 
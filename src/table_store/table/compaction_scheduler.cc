@@ -0,0 +1,107 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/compaction_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace px {
+namespace table_store {
+
+CompactionScheduler::CompactionScheduler(size_t num_workers) {
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&CompactionScheduler::WorkerLoop, this);
+  }
+}
+
+CompactionScheduler::~CompactionScheduler() {
+  {
+    absl::MutexLock lock(&mu_);
+    stopped_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void CompactionScheduler::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(this, &CompactionScheduler::HasWorkOrStopped));
+      if (tasks_.empty()) {
+        // Stopped, and there is no work left.
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+Status CompactionScheduler::Run(std::vector<std::shared_ptr<Table>> tables,
+                                arrow::MemoryPool* mem_pool) {
+  // Start the tables with the most data to compact first, so that they don't hold up the end of
+  // the run.
+  std::vector<std::pair<int64_t, std::shared_ptr<Table>>> tables_by_hot_bytes;
+  tables_by_hot_bytes.reserve(tables.size());
+  for (auto& table : tables) {
+    tables_by_hot_bytes.emplace_back(table->HotBytes(), std::move(table));
+  }
+  std::stable_sort(tables_by_hot_bytes.begin(), tables_by_hot_bytes.end(),
+                   [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  if (workers_.empty()) {
+    Status first_error;
+    for (const auto& [hot_bytes, table] : tables_by_hot_bytes) {
+      auto s = table->CompactHotToCold(mem_pool);
+      if (!s.ok() && first_error.ok()) {
+        first_error = s;
+      }
+    }
+    return first_error;
+  }
+
+  absl::Mutex run_mu;
+  size_t remaining = tables_by_hot_bytes.size();
+  Status first_error;
+  {
+    absl::MutexLock lock(&mu_);
+    for (const auto& [hot_bytes, table] : tables_by_hot_bytes) {
+      tasks_.emplace_back([&, table = table]() {
+        auto s = table->CompactHotToCold(mem_pool);
+        absl::MutexLock run_lock(&run_mu);
+        if (!s.ok() && first_error.ok()) {
+          first_error = s;
+        }
+        --remaining;
+      });
+    }
+  }
+
+  absl::MutexLock run_lock(&run_mu);
+  run_mu.Await(absl::Condition(+[](size_t* remaining) { return *remaining == 0; }, &remaining));
+  return first_error;
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+#include "src/common/base/base.h"
+#include "src/table_store/table/table.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * CompactionScheduler runs table compactions on a small pool of worker threads, so that
+ * compacting a large table doesn't delay the compaction of the other tables. Each table is
+ * compacted by a single worker at a time, and tables with the most uncompacted (hot) data are
+ * scheduled first.
+ */
+class CompactionScheduler : public NotCopyable {
+ public:
+  /**
+   * @param num_workers the number of worker threads. With 0 workers, compactions run on the
+   * calling thread.
+   */
+  explicit CompactionScheduler(size_t num_workers);
+  ~CompactionScheduler();
+
+  /**
+   * Compacts the hot data of all the given tables, blocking until all compactions are done.
+   * @param tables the tables to compact.
+   * @param mem_pool arrow MemoryPool to be used for creating new cold batches.
+   * @return the first error encountered, compactions of other tables still run to completion.
+   */
+  Status Run(std::vector<std::shared_ptr<Table>> tables, arrow::MemoryPool* mem_pool);
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+  bool HasWorkOrStopped() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return stopped_ || !tasks_.empty();
+  }
+
+  absl::Mutex mu_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mu_);
+  bool stopped_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace table_store
+}  // namespace px
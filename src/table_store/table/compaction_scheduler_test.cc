@@ -0,0 +1,117 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/compaction_scheduler.h"
+
+namespace px {
+namespace table_store {
+
+class CompactionSchedulerTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  std::shared_ptr<Table> MakeFilledTable(int64_t num_batches) {
+    schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "col"});
+    int64_t rows_per_batch = 16;
+    int64_t batch_bytes = rows_per_batch * (sizeof(int64_t) + sizeof(int64_t));
+    auto table = std::make_shared<Table>("test_table", rel, 1024 * 1024, batch_bytes);
+    for (int64_t batch = 0; batch < num_batches; ++batch) {
+      std::vector<types::Time64NSValue> times;
+      std::vector<types::Int64Value> vals;
+      for (int64_t i = 0; i < rows_per_batch; ++i) {
+        times.push_back(batch * rows_per_batch + i);
+        vals.push_back(i);
+      }
+      schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), rows_per_batch);
+      EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+      EXPECT_OK(rb.AddColumn(types::ToArrow(vals, arrow::default_memory_pool())));
+      EXPECT_OK(table->WriteRowBatch(rb));
+    }
+    return table;
+  }
+};
+
+TEST_P(CompactionSchedulerTest, CompactsAllTables) {
+  CompactionScheduler scheduler(GetParam());
+  EXPECT_EQ(GetParam(), scheduler.num_workers());
+
+  std::vector<std::shared_ptr<Table>> tables;
+  for (int64_t i = 1; i <= 8; ++i) {
+    tables.push_back(MakeFilledTable(i * 4));
+  }
+  // Run twice to check that the workers are reused.
+  for (int run = 0; run < 2; ++run) {
+    ASSERT_OK(scheduler.Run(tables, arrow::default_memory_pool()));
+    for (const auto& [i, table] : Enumerate(tables)) {
+      auto stats = table->GetTableStats();
+      EXPECT_EQ(0, stats.hot_bytes);
+      EXPECT_EQ(static_cast<int64_t>(i + 1) * 4, stats.compacted_batches);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(NumWorkers, CompactionSchedulerTest, ::testing::Values(0, 1, 4));
+
+TEST(CompactionSchedulerConcurrencyTest, CompactWhileWriting) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "col"});
+  int64_t rows_per_batch = 8;
+  int64_t batch_bytes = rows_per_batch * (sizeof(int64_t) + sizeof(int64_t));
+  auto table = std::make_shared<Table>("test_table", rel, 1024 * 1024, 4 * batch_bytes);
+  CompactionScheduler scheduler(2);
+
+  int64_t num_batches = 200;
+  std::thread writer([&]() {
+    for (int64_t batch = 0; batch < num_batches; ++batch) {
+      std::vector<types::Time64NSValue> times;
+      std::vector<types::Int64Value> vals;
+      for (int64_t i = 0; i < rows_per_batch; ++i) {
+        times.push_back(batch * rows_per_batch + i);
+        vals.push_back(batch * rows_per_batch + i);
+      }
+      schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), rows_per_batch);
+      EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+      EXPECT_OK(rb.AddColumn(types::ToArrow(vals, arrow::default_memory_pool())));
+      EXPECT_OK(table->WriteRowBatch(rb));
+    }
+  });
+  for (int i = 0; i < 50; ++i) {
+    ASSERT_OK(scheduler.Run({table}, arrow::default_memory_pool()));
+  }
+  writer.join();
+  ASSERT_OK(scheduler.Run({table}, arrow::default_memory_pool()));
+
+  // Every row is read exactly once, in order.
+  Table::Cursor cursor(table.get());
+  int64_t expected = 0;
+  while (!cursor.Done()) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({1}));
+    for (int64_t i = 0; i < rb->num_rows(); ++i) {
+      EXPECT_EQ(expected++,
+                types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(0).get(), i));
+    }
+  }
+  EXPECT_EQ(num_batches * rows_per_batch, expected);
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -15,17 +15,22 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <utility>
 #include <vector>
 
 #include "src/table_store/table/internal/arrow_array_compactor.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
 
 namespace px {
 namespace table_store {
 namespace internal {
 
-ArrowArrayCompactor::ArrowArrayCompactor(const schema::Relation& rel, arrow::MemoryPool* mem_pool)
-    : rel_(rel) {
+ArrowArrayCompactor::ArrowArrayCompactor(const schema::Relation& rel, arrow::MemoryPool* mem_pool,
+                                         double dictionary_max_distinct_ratio)
+    : rel_(rel),
+      mem_pool_(mem_pool),
+      dictionary_max_distinct_ratio_(dictionary_max_distinct_ratio) {
   for (const auto& type : rel_.col_types()) {
     builders_.push_back(types::MakeTypeErasedArrowBuilder(type, mem_pool));
   }
@@ -52,9 +57,22 @@ void ArrowArrayCompactor::UnsafeAppendBatchSlice(const RecordOrRowBatch& batch,
 
 StatusOr<std::vector<ArrowArrayPtr>> ArrowArrayCompactor::Finish() {
   std::vector<ArrowArrayPtr> out_columns;
+  encoded_bytes_saved_ = 0;
   for (const auto& [col_idx, builder] : Enumerate(builders_)) {
     out_columns.emplace_back();
     PL_RETURN_IF_ERROR(builder->Finish(&out_columns.back()));
+    if (dictionary_max_distinct_ratio_ <= 0.0 ||
+        rel_.col_types()[col_idx] != types::DataType::STRING) {
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(auto encoded, DictionaryEncodeStringArray(out_columns.back().get(),
+                                                                  dictionary_max_distinct_ratio_,
+                                                                  mem_pool_));
+    if (encoded != nullptr) {
+      encoded_bytes_saved_ +=
+          StringArrayBytes(out_columns.back().get()) - StringArrayBytes(encoded.get());
+      out_columns.back() = std::move(encoded);
+    }
   }
   return out_columns;
 }
@@ -45,7 +45,15 @@ namespace internal {
  */
 class ArrowArrayCompactor {
  public:
-  ArrowArrayCompactor(const schema::Relation& rel, arrow::MemoryPool* mem_pool);
+  ArrowArrayCompactor(const schema::Relation& rel, arrow::MemoryPool* mem_pool)
+      : ArrowArrayCompactor(rel, mem_pool, 0.0) {}
+  /**
+   * @param dictionary_max_distinct_ratio, string columns with a ratio of distinct values to rows
+   * less than or equal to this value are output as dictionary encoded arrays
+   * (arrow::DictionaryArray with int32 indices). A value of 0 disables dictionary encoding.
+   */
+  ArrowArrayCompactor(const schema::Relation& rel, arrow::MemoryPool* mem_pool,
+                      double dictionary_max_distinct_ratio);
   /**
    * Reserve space for the given number of rows, and in the case of binary column types (eg. string
    * columns) reserve space for columns data given by col_size_bytes.
@@ -74,10 +82,19 @@ class ArrowArrayCompactor {
    * @return compacted arrow::Array's per column in the batch.
    */
   StatusOr<std::vector<ArrowArrayPtr>> Finish();
+  /**
+   * Return the number of bytes saved by dictionary encoding in the last call to `Finish`, according
+   * to the accounting used by BatchSizeAccountant.
+   * @return bytes saved by encoding.
+   */
+  uint64_t EncodedBytesSaved() const { return encoded_bytes_saved_; }
 
  private:
   const schema::Relation& rel_;
+  arrow::MemoryPool* mem_pool_;
+  const double dictionary_max_distinct_ratio_;
   std::vector<std::unique_ptr<types::TypeErasedArrowBuilder>> builders_;
+  uint64_t encoded_bytes_saved_ = 0;
 };
 
 }  // namespace internal
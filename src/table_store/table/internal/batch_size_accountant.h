@@ -133,7 +133,15 @@ class BatchSizeAccountant {
    * @return Number of rows to remove from the front of the hot store, since those rows were moved
    * into the cold store via CompactedBatchSpec.
    */
-  uint64_t FinishCompactedBatch();
+  uint64_t FinishCompactedBatch() { return FinishCompactedBatch(0); }
+  /**
+   * FinishCompactedBatch is the same as above, but accounts for the compacted batch being stored
+   * in `encoded_bytes_saved` fewer bytes than the hot slices it was made from (eg. because string
+   * columns were dictionary encoded).
+   * @param encoded_bytes_saved, number of bytes saved by encoding the compacted batch.
+   * @return Number of rows to remove from the front of the hot store.
+   */
+  uint64_t FinishCompactedBatch(uint64_t encoded_bytes_saved);
   /**
    * @return the number of bytes stored in the hot store.
    */
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <utility>
+#include <vector>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+ColdBatch::ColdBatch(std::vector<ArrowArrayPtr> columns)
+    : columns_(std::move(columns)), compressed_(columns_.size()) {
+  if (!columns_.empty()) {
+    length_ = columns_[0]->length();
+  }
+}
+
+namespace {
+
+int64_t PlainColumnBytes(types::DataType data_type, const arrow::Array* arr) {
+  if (data_type == types::DataType::STRING) {
+    return StringArrayBytes(arr);
+  }
+  // Only 64 bit integer columns are compressed besides strings.
+  return arr->length() * static_cast<int64_t>(sizeof(int64_t));
+}
+
+}  // namespace
+
+int64_t ColdBatch::Compress(const schema::Relation& rel) {
+  for (const auto& [col_idx, data_type] : Enumerate(rel.col_types())) {
+    if (IsColumnCompressed(col_idx)) {
+      continue;
+    }
+    auto compressed = CompressedColumn::Compress(data_type, columns_[col_idx].get());
+    if (compressed == nullptr) {
+      continue;
+    }
+    auto saved = PlainColumnBytes(data_type, columns_[col_idx].get()) - compressed->Bytes();
+    if (saved <= 0) {
+      continue;
+    }
+    compression_bytes_saved_ += saved;
+    compressed_[col_idx] = std::move(compressed);
+    columns_[col_idx].reset();
+  }
+  return compression_bytes_saved_;
+}
+
+StatusOr<ArrowArrayPtr> ColdBatch::Column(size_t col_idx, arrow::MemoryPool* mem_pool) const {
+  if (IsColumnCompressed(col_idx)) {
+    return compressed_[col_idx]->Decompress(mem_pool);
+  }
+  return columns_[col_idx];
+}
+
+StatusOr<ArrowArrayPtr> ColdBatch::ColumnSlice(size_t col_idx, int64_t offset, int64_t length,
+                                               arrow::MemoryPool* mem_pool) const {
+  if (IsColumnCompressed(col_idx)) {
+    return compressed_[col_idx]->Decompress(offset, length, mem_pool);
+  }
+  return columns_[col_idx]->Slice(offset, length);
+}
+
+int64_t ColdBatch::FindTimeFirstGreaterThanOrEqual(int64_t time_col_idx, Time time) const {
+  if (IsColumnCompressed(time_col_idx)) {
+    return compressed_[time_col_idx]->FindFirstGreaterThanOrEqual(time);
+  }
+  return types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(
+      columns_[time_col_idx].get(), time);
+}
+
+int64_t ColdBatch::FindTimeFirstGreaterThan(int64_t time_col_idx, Time time) const {
+  if (IsColumnCompressed(time_col_idx)) {
+    return compressed_[time_col_idx]->FindFirstGreaterThan(time);
+  }
+  return types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(
+             columns_[time_col_idx].get(), time) +
+         1;
+}
+
+Time ColdBatch::GetTimeValue(int64_t time_col_idx, int64_t row_idx) const {
+  if (IsColumnCompressed(time_col_idx)) {
+    return compressed_[time_col_idx]->GetInt64(row_idx);
+  }
+  return types::GetValueFromArrowArray<types::DataType::TIME64NS>(columns_[time_col_idx].get(),
+                                                                  row_idx);
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
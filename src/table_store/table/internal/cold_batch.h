@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/column_compression.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * ColdBatch is a compacted batch in the cold store. Each column is stored either as a plain arrow
+ * array, or, after a call to Compress(), as a CompressedColumn (see column_compression.h).
+ * Compressed columns are decompressed on read.
+ */
+class ColdBatch {
+ public:
+  explicit ColdBatch(std::vector<ArrowArrayPtr> columns);
+
+  /**
+   * Compress the columns of this batch that benefit from compression. Columns that can't be
+   * compressed are left as plain arrow arrays.
+   * @param rel, the relation of the table this batch belongs to.
+   * @return the number of bytes saved by compression.
+   */
+  int64_t Compress(const schema::Relation& rel);
+
+  /**
+   * Column returns the arrow array for the given column, decompressing it if necessary.
+   */
+  StatusOr<ArrowArrayPtr> Column(size_t col_idx, arrow::MemoryPool* mem_pool) const;
+
+  /**
+   * ColumnSlice returns `length` rows of the given column, starting at `offset`. Compressed columns
+   * only decompress the rows of the slice.
+   */
+  StatusOr<ArrowArrayPtr> ColumnSlice(size_t col_idx, int64_t offset, int64_t length,
+                                      arrow::MemoryPool* mem_pool) const;
+
+  /**
+   * PlainColumn returns the arrow array for the given column. Only valid for uncompressed columns.
+   */
+  const ArrowArrayPtr& PlainColumn(size_t col_idx) const {
+    DCHECK(!IsColumnCompressed(col_idx));
+    return columns_[col_idx];
+  }
+
+  bool IsColumnCompressed(size_t col_idx) const { return compressed_[col_idx] != nullptr; }
+
+  // Time column accessors. These work directly on compressed time columns, without
+  // decompressing the whole column.
+  int64_t FindTimeFirstGreaterThanOrEqual(int64_t time_col_idx, Time time) const;
+  int64_t FindTimeFirstGreaterThan(int64_t time_col_idx, Time time) const;
+  Time GetTimeValue(int64_t time_col_idx, int64_t row_idx) const;
+
+  int64_t Length() const { return length_; }
+  size_t NumColumns() const { return columns_.size(); }
+  int64_t CompressionBytesSaved() const { return compression_bytes_saved_; }
+
+ private:
+  // Plain columns, set to nullptr once a column is compressed.
+  std::vector<ArrowArrayPtr> columns_;
+  std::vector<std::unique_ptr<CompressedColumn>> compressed_;
+  int64_t length_ = 0;
+  int64_t compression_bytes_saved_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
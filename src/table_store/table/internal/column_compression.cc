@@ -0,0 +1,260 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arrow/builder.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/column_compression.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+BitPackedVector::BitPackedVector(uint8_t bit_width, size_t num_values)
+    : bit_width_(bit_width), words_((bit_width * num_values + 63) / 64, 0) {
+  DCHECK_LE(bit_width, 64);
+}
+
+void BitPackedVector::Set(size_t idx, uint64_t val) {
+  if (bit_width_ == 0) {
+    return;
+  }
+  size_t bit_pos = idx * bit_width_;
+  size_t word = bit_pos / 64;
+  size_t offset = bit_pos % 64;
+  words_[word] |= val << offset;
+  if (offset + bit_width_ > 64) {
+    words_[word + 1] |= val >> (64 - offset);
+  }
+}
+
+uint64_t BitPackedVector::Get(size_t idx) const {
+  if (bit_width_ == 0) {
+    return 0;
+  }
+  size_t bit_pos = idx * bit_width_;
+  size_t word = bit_pos / 64;
+  size_t offset = bit_pos % 64;
+  uint64_t val = words_[word] >> offset;
+  if (offset + bit_width_ > 64) {
+    val |= words_[word + 1] << (64 - offset);
+  }
+  uint64_t mask = (bit_width_ == 64) ? std::numeric_limits<uint64_t>::max()
+                                     : ((1ULL << bit_width_) - 1);
+  return val & mask;
+}
+
+uint8_t BitPackedVector::BitWidth(uint64_t max_val) {
+  if (max_val == 0) {
+    return 0;
+  }
+  return 64 - __builtin_clzll(max_val);
+}
+
+namespace {
+
+// Deltas are computed with unsigned (wrapping) arithmetic so that any pair of int64 values has a
+// well defined delta.
+inline int64_t Delta(int64_t prev, int64_t curr) {
+  return static_cast<int64_t>(static_cast<uint64_t>(curr) - static_cast<uint64_t>(prev));
+}
+
+inline int64_t ApplyDelta(int64_t prev, uint64_t packed, int64_t min_delta) {
+  return static_cast<int64_t>(static_cast<uint64_t>(prev) + packed +
+                              static_cast<uint64_t>(min_delta));
+}
+
+template <types::DataType T>
+StatusOr<ArrowArrayPtr> BuildInt64Array(const std::vector<int64_t>& values,
+                                        arrow::MemoryPool* mem_pool) {
+  auto builder = types::MakeArrowBuilder(T, mem_pool);
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(values.size()));
+  for (auto val : values) {
+    typed_builder->UnsafeAppend(val);
+  }
+  ArrowArrayPtr out;
+  PL_RETURN_IF_ERROR(typed_builder->Finish(&out));
+  return out;
+}
+
+}  // namespace
+
+std::unique_ptr<CompressedColumn> CompressedColumn::Compress(types::DataType data_type,
+                                                             const arrow::Array* arr) {
+  int64_t length = arr->length();
+  if (length == 0 || arr->null_count() > 0) {
+    return nullptr;
+  }
+
+  if (data_type == types::DataType::INT64 || data_type == types::DataType::TIME64NS) {
+    const int64_t* values = arr->data()->GetValues<int64_t>(1);
+    int64_t min_delta = 0;
+    int64_t max_delta = 0;
+    for (int64_t i = 1; i < length; ++i) {
+      auto delta = Delta(values[i - 1], values[i]);
+      if (i == 1 || delta < min_delta) {
+        min_delta = delta;
+      }
+      if (i == 1 || delta > max_delta) {
+        max_delta = delta;
+      }
+    }
+    uint64_t range = static_cast<uint64_t>(max_delta) - static_cast<uint64_t>(min_delta);
+
+    std::unique_ptr<CompressedColumn> col(
+        new CompressedColumn(Encoding::kDeltaFrameOfReference, data_type, length));
+    col->min_delta_ = min_delta;
+    for (int64_t i = 0; i < length; i += kCheckpointInterval) {
+      col->checkpoints_.push_back(values[i]);
+    }
+    col->packed_ = BitPackedVector(BitPackedVector::BitWidth(range), length - 1);
+    for (int64_t i = 1; i < length; ++i) {
+      col->packed_.Set(i - 1, static_cast<uint64_t>(Delta(values[i - 1], values[i])) -
+                                  static_cast<uint64_t>(min_delta));
+    }
+    if (col->Bytes() >= length * static_cast<int64_t>(sizeof(int64_t))) {
+      return nullptr;
+    }
+    return col;
+  }
+
+  if (data_type == types::DataType::STRING && arr->type_id() == arrow::Type::DICTIONARY) {
+    const auto* dict_arr = static_cast<const arrow::DictionaryArray*>(arr);
+    const auto* indices = static_cast<const arrow::Int32Array*>(dict_arr->indices().get());
+    const auto& dictionary = dict_arr->dictionary();
+    if (dictionary->length() == 0) {
+      return nullptr;
+    }
+
+    std::unique_ptr<CompressedColumn> col(
+        new CompressedColumn(Encoding::kDictionaryIndices, data_type, length));
+    col->dictionary_ = dictionary;
+    col->packed_ = BitPackedVector(BitPackedVector::BitWidth(dictionary->length() - 1), length);
+    for (int64_t i = 0; i < length; ++i) {
+      col->packed_.Set(i, static_cast<uint64_t>(indices->Value(i)));
+    }
+    if (col->Bytes() >= StringArrayBytes(arr)) {
+      return nullptr;
+    }
+    return col;
+  }
+
+  return nullptr;
+}
+
+StatusOr<ArrowArrayPtr> CompressedColumn::Decompress(int64_t offset, int64_t length,
+                                                     arrow::MemoryPool* mem_pool) const {
+  DCHECK_GE(offset, 0);
+  DCHECK_LE(offset + length, length_);
+  switch (encoding_) {
+    case Encoding::kDeltaFrameOfReference: {
+      std::vector<int64_t> values(length);
+      // Decode from the last checkpoint at or before the start of the range.
+      int64_t val = 0;
+      for (int64_t i = offset / kCheckpointInterval * kCheckpointInterval; i < offset + length;
+           ++i) {
+        val = i % kCheckpointInterval == 0 ? checkpoints_[i / kCheckpointInterval]
+                                           : ApplyDelta(val, packed_.Get(i - 1), min_delta_);
+        if (i >= offset) {
+          values[i - offset] = val;
+        }
+      }
+      if (data_type_ == types::DataType::TIME64NS) {
+        return BuildInt64Array<types::DataType::TIME64NS>(values, mem_pool);
+      }
+      return BuildInt64Array<types::DataType::INT64>(values, mem_pool);
+    }
+    case Encoding::kDictionaryIndices: {
+      arrow::Int32Builder indices_builder(mem_pool);
+      PL_RETURN_IF_ERROR(indices_builder.Reserve(length));
+      for (int64_t i = offset; i < offset + length; ++i) {
+        indices_builder.UnsafeAppend(static_cast<int32_t>(packed_.Get(i)));
+      }
+      ArrowArrayPtr indices;
+      PL_RETURN_IF_ERROR(indices_builder.Finish(&indices));
+      return ArrowArrayPtr(std::make_shared<arrow::DictionaryArray>(
+          arrow::dictionary(arrow::int32(), arrow::utf8()), indices, dictionary_));
+    }
+  }
+  return error::Internal("Unknown cold column encoding");
+}
+
+int64_t CompressedColumn::GetInt64(int64_t idx) const {
+  DCHECK(encoding_ == Encoding::kDeltaFrameOfReference);
+  DCHECK_LT(idx, length_);
+  int64_t checkpoint = idx / kCheckpointInterval;
+  int64_t val = checkpoints_[checkpoint];
+  for (int64_t i = checkpoint * kCheckpointInterval + 1; i <= idx; ++i) {
+    val = ApplyDelta(val, packed_.Get(i - 1), min_delta_);
+  }
+  return val;
+}
+
+template <typename TPred>
+int64_t CompressedColumn::FindFirst(TPred pred) const {
+  DCHECK(encoding_ == Encoding::kDeltaFrameOfReference);
+  // Binary search the checkpoints for the first one that matches. The first matching value is
+  // either in the interval before that checkpoint, or the checkpoint itself.
+  auto it = std::partition_point(checkpoints_.begin(), checkpoints_.end(),
+                                 [&pred](int64_t val) { return !pred(val); });
+  int64_t checkpoint = std::distance(checkpoints_.begin(), it);
+  if (checkpoint == 0) {
+    return 0;
+  }
+  int64_t end = std::min(checkpoint * kCheckpointInterval, length_);
+  int64_t val = checkpoints_[checkpoint - 1];
+  for (int64_t i = (checkpoint - 1) * kCheckpointInterval + 1; i < end; ++i) {
+    val = ApplyDelta(val, packed_.Get(i - 1), min_delta_);
+    if (pred(val)) {
+      return i;
+    }
+  }
+  return end;
+}
+
+int64_t CompressedColumn::FindFirstGreaterThanOrEqual(int64_t target) const {
+  int64_t idx = FindFirst([target](int64_t val) { return val >= target; });
+  return idx == length_ ? -1 : idx;
+}
+
+int64_t CompressedColumn::FindFirstGreaterThan(int64_t target) const {
+  return FindFirst([target](int64_t val) { return val > target; });
+}
+
+int64_t CompressedColumn::Bytes() const {
+  switch (encoding_) {
+    case Encoding::kDeltaFrameOfReference:
+      return packed_.Bytes() + checkpoints_.size() * sizeof(int64_t) + sizeof(min_delta_);
+    case Encoding::kDictionaryIndices:
+      return packed_.Bytes() + StringArrayBytes(dictionary_.get());
+  }
+  return packed_.Bytes();
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * BitPackedVector stores a sequence of unsigned integers using a fixed number of bits per value.
+ */
+class BitPackedVector {
+ public:
+  BitPackedVector() = default;
+  BitPackedVector(uint8_t bit_width, size_t num_values);
+
+  void Set(size_t idx, uint64_t val);
+  uint64_t Get(size_t idx) const;
+
+  uint8_t bit_width() const { return bit_width_; }
+  int64_t Bytes() const { return words_.size() * sizeof(uint64_t); }
+
+  /**
+   * BitWidth returns the number of bits required to store the given value.
+   */
+  static uint8_t BitWidth(uint64_t max_val);
+
+ private:
+  uint8_t bit_width_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * CompressedColumn is a lightweight compressed representation of a single cold batch column.
+ * Two encodings are supported:
+ *  - kDeltaFrameOfReference, for INT64 and TIME64NS columns. Values are stored as the bit packed
+ *    deltas between consecutive values, offset by the minimum delta, plus a checkpoint of the
+ *    plain value every kCheckpointInterval values. Time columns are monotonic, so their deltas
+ *    typically fit in a small number of bits. The checkpoints allow binary searches and random
+ *    access that only decode a single interval.
+ *  - kDictionaryIndices, for dictionary encoded STRING columns (see dictionary_encoding.h). The
+ *    dictionary is kept as is, and the int32 indices are bit packed to the width of the
+ *    dictionary size.
+ * Columns with nulls are not compressed.
+ */
+class CompressedColumn {
+ public:
+  enum class Encoding {
+    kDeltaFrameOfReference,
+    kDictionaryIndices,
+  };
+
+  /**
+   * Compress the given column.
+   * @param data_type, the DataType of the column.
+   * @param arr, the column to compress.
+   * @return the compressed column, or nullptr if the column can't be compressed or compression
+   * wouldn't make it smaller.
+   */
+  static std::unique_ptr<CompressedColumn> Compress(types::DataType data_type,
+                                                    const arrow::Array* arr);
+
+  /**
+   * Decompress the column back to its original arrow representation.
+   */
+  StatusOr<ArrowArrayPtr> Decompress(arrow::MemoryPool* mem_pool) const {
+    return Decompress(0, length_, mem_pool);
+  }
+
+  /**
+   * Decompress `length` values of the column, starting at `offset`. Only the values in the range
+   * (and at most kCheckpointInterval values before it) are decoded.
+   */
+  StatusOr<ArrowArrayPtr> Decompress(int64_t offset, int64_t length,
+                                     arrow::MemoryPool* mem_pool) const;
+
+  /**
+   * Return the value at the given index of a kDeltaFrameOfReference column. This decodes at most
+   * kCheckpointInterval values.
+   */
+  int64_t GetInt64(int64_t idx) const;
+
+  /**
+   * Return the index of the first value greater than or equal to `val` in a sorted
+   * kDeltaFrameOfReference column, or -1 if no such value exists.
+   */
+  int64_t FindFirstGreaterThanOrEqual(int64_t val) const;
+
+  /**
+   * Return the index of the first value greater than `val` in a sorted kDeltaFrameOfReference
+   * column, or length() if no such value exists.
+   */
+  int64_t FindFirstGreaterThan(int64_t val) const;
+
+  Encoding encoding() const { return encoding_; }
+  int64_t length() const { return length_; }
+  /**
+   * Bytes returns the number of bytes used by the compressed column.
+   */
+  int64_t Bytes() const;
+
+  // Number of values between two checkpoints of a kDeltaFrameOfReference column.
+  static constexpr int64_t kCheckpointInterval = 128;
+
+ private:
+  CompressedColumn(Encoding encoding, types::DataType data_type, int64_t length)
+      : encoding_(encoding), data_type_(data_type), length_(length) {}
+
+  Encoding encoding_;
+  types::DataType data_type_;
+  int64_t length_;
+  // Return the index of the first value of a kDeltaFrameOfReference column for which `pred` is
+  // true, or length() if there is none. `pred` must be false for a prefix of the values, and true
+  // for the rest.
+  template <typename TPred>
+  int64_t FindFirst(TPred pred) const;
+
+  // kDeltaFrameOfReference state. checkpoints_[i] is the value at index i * kCheckpointInterval.
+  std::vector<int64_t> checkpoints_;
+  int64_t min_delta_ = 0;
+  // kDictionaryIndices state.
+  ArrowArrayPtr dictionary_;
+
+  BitPackedVector packed_;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/column_compression.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+TEST(BitPackedVectorTest, SetGet) {
+  // 13 bit values straddle word boundaries.
+  BitPackedVector packed(13, 100);
+  for (size_t i = 0; i < 100; ++i) {
+    packed.Set(i, (i * 97) % (1 << 13));
+  }
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_EQ((i * 97) % (1 << 13), packed.Get(i));
+  }
+  EXPECT_EQ(((13 * 100) + 63) / 64 * 8, packed.Bytes());
+
+  EXPECT_EQ(0, BitPackedVector::BitWidth(0));
+  EXPECT_EQ(1, BitPackedVector::BitWidth(1));
+  EXPECT_EQ(13, BitPackedVector::BitWidth(4096));
+  EXPECT_EQ(64, BitPackedVector::BitWidth(~0ULL));
+}
+
+TEST(CompressedColumnTest, DeltaTimeRoundTrip) {
+  std::vector<types::Time64NSValue> times;
+  for (int64_t i = 0; i < 1000; ++i) {
+    times.push_back(1600000000000000000 + i * 1000 + (i % 7));
+  }
+  auto arr = types::ToArrow(times, arrow::default_memory_pool());
+
+  auto compressed = CompressedColumn::Compress(types::DataType::TIME64NS, arr.get());
+  ASSERT_NE(nullptr, compressed);
+  EXPECT_EQ(CompressedColumn::Encoding::kDeltaFrameOfReference, compressed->encoding());
+  EXPECT_EQ(1000, compressed->length());
+  EXPECT_LT(compressed->Bytes(), 1000 * static_cast<int64_t>(sizeof(int64_t)));
+
+  ASSERT_OK_AND_ASSIGN(auto decompressed, compressed->Decompress(arrow::default_memory_pool()));
+  EXPECT_TRUE(decompressed->Equals(arr));
+
+  EXPECT_EQ(times[500].val, compressed->GetInt64(500));
+  EXPECT_EQ(0, compressed->FindFirstGreaterThanOrEqual(0));
+  EXPECT_EQ(500, compressed->FindFirstGreaterThanOrEqual(times[500].val));
+  EXPECT_EQ(501, compressed->FindFirstGreaterThan(times[500].val));
+  EXPECT_EQ(-1, compressed->FindFirstGreaterThanOrEqual(times[999].val + 1));
+  EXPECT_EQ(1000, compressed->FindFirstGreaterThan(times[999].val));
+}
+
+TEST(CompressedColumnTest, DeltaSearchAcrossCheckpoints) {
+  // Repeated values make the first match of a search land anywhere in an interval, including right
+  // after a checkpoint and on the checkpoint itself.
+  std::vector<types::Time64NSValue> times;
+  for (int64_t i = 0; i < 1000; ++i) {
+    times.push_back(10 * (i / 3));
+  }
+  auto arr = types::ToArrow(times, arrow::default_memory_pool());
+  auto compressed = CompressedColumn::Compress(types::DataType::TIME64NS, arr.get());
+  ASSERT_NE(nullptr, compressed);
+
+  for (int64_t i = 0; i < 1000; ++i) {
+    int64_t first_equal = (i / 3) * 3;
+    int64_t first_greater = std::min<int64_t>(first_equal + 3, 1000);
+    EXPECT_EQ(times[i].val, compressed->GetInt64(i));
+    EXPECT_EQ(first_equal, compressed->FindFirstGreaterThanOrEqual(times[i].val));
+    EXPECT_EQ(first_equal, compressed->FindFirstGreaterThanOrEqual(times[i].val - 5));
+    EXPECT_EQ(first_greater, compressed->FindFirstGreaterThan(times[i].val));
+  }
+  EXPECT_EQ(-1, compressed->FindFirstGreaterThanOrEqual(times[999].val + 1));
+}
+
+TEST(CompressedColumnTest, DecompressSlice) {
+  std::vector<types::Int64Value> vals;
+  for (int64_t i = 0; i < 1000; ++i) {
+    vals.push_back(i * i);
+  }
+  auto arr = types::ToArrow(vals, arrow::default_memory_pool());
+  auto compressed = CompressedColumn::Compress(types::DataType::INT64, arr.get());
+  ASSERT_NE(nullptr, compressed);
+
+  for (auto [offset, length] : std::vector<std::pair<int64_t, int64_t>>{
+           {0, 1}, {0, 1000}, {127, 2}, {128, 128}, {300, 700}, {999, 1}, {500, 0}}) {
+    ASSERT_OK_AND_ASSIGN(auto slice,
+                         compressed->Decompress(offset, length, arrow::default_memory_pool()));
+    EXPECT_TRUE(slice->Equals(arr->Slice(offset, length))) << offset << " " << length;
+  }
+}
+
+TEST(CompressedColumnTest, DeltaNegativeAndExtremeValues) {
+  std::vector<types::Int64Value> vals = {0, std::numeric_limits<int64_t>::max(),
+                                         std::numeric_limits<int64_t>::min(), -5, 3};
+  auto arr = types::ToArrow(vals, arrow::default_memory_pool());
+  // Wide deltas don't compress, so the column is left alone.
+  EXPECT_EQ(nullptr, CompressedColumn::Compress(types::DataType::INT64, arr.get()));
+
+  std::vector<types::Int64Value> decreasing;
+  for (int64_t i = 0; i < 100; ++i) {
+    decreasing.push_back(-3 * i);
+  }
+  arr = types::ToArrow(decreasing, arrow::default_memory_pool());
+  auto compressed = CompressedColumn::Compress(types::DataType::INT64, arr.get());
+  ASSERT_NE(nullptr, compressed);
+  ASSERT_OK_AND_ASSIGN(auto decompressed, compressed->Decompress(arrow::default_memory_pool()));
+  EXPECT_TRUE(decompressed->Equals(arr));
+}
+
+TEST(CompressedColumnTest, DictionaryIndicesRoundTrip) {
+  std::vector<types::StringValue> strings;
+  for (int i = 0; i < 200; ++i) {
+    strings.push_back(i % 4 == 0 ? "GET" : "POST");
+  }
+  auto arr = types::ToArrow(strings, arrow::default_memory_pool());
+  ASSERT_OK_AND_ASSIGN(auto encoded,
+                       DictionaryEncodeStringArray(arr.get(), 0.1, arrow::default_memory_pool()));
+  ASSERT_NE(nullptr, encoded);
+
+  // Plain string columns aren't compressed.
+  EXPECT_EQ(nullptr, CompressedColumn::Compress(types::DataType::STRING, arr.get()));
+
+  auto compressed = CompressedColumn::Compress(types::DataType::STRING, encoded.get());
+  ASSERT_NE(nullptr, compressed);
+  EXPECT_EQ(CompressedColumn::Encoding::kDictionaryIndices, compressed->encoding());
+  EXPECT_LT(compressed->Bytes(), StringArrayBytes(encoded.get()));
+
+  ASSERT_OK_AND_ASSIGN(auto decompressed, compressed->Decompress(arrow::default_memory_pool()));
+  ASSERT_OK_AND_ASSIGN(auto decoded, DecodeDictionaryStringArray(decompressed.get(),
+                                                                 arrow::default_memory_pool()));
+  EXPECT_TRUE(decoded->Equals(arr));
+}
+
+TEST(CompressedColumnTest, NullsNotCompressed) {
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(builder.Append(i).ok());
+  }
+  EXPECT_TRUE(builder.AppendNull().ok());
+  std::shared_ptr<arrow::Array> arr;
+  EXPECT_TRUE(builder.Finish(&arr).ok());
+  EXPECT_EQ(nullptr, CompressedColumn::Compress(types::DataType::INT64, arr.get()));
+}
+
+TEST(ColdBatchTest, CompressAndRead) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::FLOAT64},
+                       {"time_", "float"});
+  std::vector<types::Time64NSValue> times;
+  std::vector<types::Float64Value> floats;
+  for (int64_t i = 0; i < 256; ++i) {
+    times.push_back(100 + 2 * i);
+    floats.push_back(0.5 * i);
+  }
+  auto time_arr = types::ToArrow(times, arrow::default_memory_pool());
+  auto float_arr = types::ToArrow(floats, arrow::default_memory_pool());
+  ColdBatch batch(std::vector<ArrowArrayPtr>{time_arr, float_arr});
+
+  EXPECT_GT(batch.Compress(rel), 0);
+  EXPECT_TRUE(batch.IsColumnCompressed(0));
+  EXPECT_FALSE(batch.IsColumnCompressed(1));
+  EXPECT_EQ(256, batch.Length());
+
+  ASSERT_OK_AND_ASSIGN(auto col0, batch.Column(0, arrow::default_memory_pool()));
+  EXPECT_TRUE(col0->Equals(time_arr));
+  ASSERT_OK_AND_ASSIGN(auto col1, batch.Column(1, arrow::default_memory_pool()));
+  EXPECT_TRUE(col1->Equals(float_arr));
+  ASSERT_OK_AND_ASSIGN(auto slice0, batch.ColumnSlice(0, 100, 50, arrow::default_memory_pool()));
+  EXPECT_TRUE(slice0->Equals(time_arr->Slice(100, 50)));
+
+  EXPECT_EQ(110, batch.GetTimeValue(0, 5));
+  EXPECT_EQ(5, batch.FindTimeFirstGreaterThanOrEqual(0, 109));
+  EXPECT_EQ(6, batch.FindTimeFirstGreaterThan(0, 110));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
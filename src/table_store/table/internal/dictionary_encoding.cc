@@ -0,0 +1,121 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arrow/builder.h>
+
+#include <string_view>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+StatusOr<ArrowArrayPtr> DictionaryEncodeStringArray(const arrow::Array* arr,
+                                                    double max_distinct_ratio,
+                                                    arrow::MemoryPool* mem_pool) {
+  DCHECK(arr->type_id() == arrow::Type::STRING);
+  int64_t num_rows = arr->length();
+  if (num_rows == 0 || arr->null_count() > 0) {
+    return ArrowArrayPtr(nullptr);
+  }
+  int64_t max_distinct = static_cast<int64_t>(max_distinct_ratio * num_rows);
+
+  // The string views point into arr's data buffer, which outlives this map.
+  absl::flat_hash_map<std::string_view, int32_t> dict_indices;
+  arrow::Int32Builder indices_builder(mem_pool);
+  PL_RETURN_IF_ERROR(indices_builder.Reserve(num_rows));
+  for (int64_t i = 0; i < num_rows; ++i) {
+    auto [it, inserted] = dict_indices.try_emplace(types::GetStringViewFromArrowArray(arr, i),
+                                                   static_cast<int32_t>(dict_indices.size()));
+    if (inserted && static_cast<int64_t>(dict_indices.size()) > max_distinct) {
+      return ArrowArrayPtr(nullptr);
+    }
+    indices_builder.UnsafeAppend(it->second);
+  }
+
+  // Write the dictionary in index order.
+  std::vector<std::string_view> dict_values(dict_indices.size());
+  int64_t dict_data_bytes = 0;
+  for (const auto& [val, idx] : dict_indices) {
+    dict_values[idx] = val;
+    dict_data_bytes += val.size();
+  }
+  arrow::StringBuilder dict_builder(mem_pool);
+  PL_RETURN_IF_ERROR(dict_builder.Reserve(dict_values.size()));
+  PL_RETURN_IF_ERROR(dict_builder.ReserveData(dict_data_bytes));
+  for (const auto& val : dict_values) {
+    dict_builder.UnsafeAppend(val.data(), val.size());
+  }
+
+  ArrowArrayPtr indices;
+  ArrowArrayPtr dictionary;
+  PL_RETURN_IF_ERROR(indices_builder.Finish(&indices));
+  PL_RETURN_IF_ERROR(dict_builder.Finish(&dictionary));
+  ArrowArrayPtr encoded = std::make_shared<arrow::DictionaryArray>(
+      arrow::dictionary(arrow::int32(), arrow::utf8()), indices, dictionary);
+
+  if (StringArrayBytes(encoded.get()) >= StringArrayBytes(arr)) {
+    return ArrowArrayPtr(nullptr);
+  }
+  return encoded;
+}
+
+StatusOr<ArrowArrayPtr> DecodeDictionaryStringArray(const arrow::Array* arr,
+                                                    arrow::MemoryPool* mem_pool) {
+  DCHECK(arr->type_id() == arrow::Type::DICTIONARY);
+  const auto* dict_arr = static_cast<const arrow::DictionaryArray*>(arr);
+  const auto* indices = static_cast<const arrow::Int32Array*>(dict_arr->indices().get());
+  const auto* dictionary = dict_arr->dictionary().get();
+
+  int64_t data_bytes = 0;
+  for (int64_t i = 0; i < indices->length(); ++i) {
+    data_bytes += types::GetStringViewFromArrowArray(dictionary, indices->Value(i)).size();
+  }
+
+  arrow::StringBuilder builder(mem_pool);
+  PL_RETURN_IF_ERROR(builder.Reserve(indices->length()));
+  PL_RETURN_IF_ERROR(builder.ReserveData(data_bytes));
+  for (int64_t i = 0; i < indices->length(); ++i) {
+    auto val = types::GetStringViewFromArrowArray(dictionary, indices->Value(i));
+    builder.UnsafeAppend(val.data(), val.size());
+  }
+  ArrowArrayPtr out;
+  PL_RETURN_IF_ERROR(builder.Finish(&out));
+  return out;
+}
+
+int64_t StringArrayBytes(const arrow::Array* arr) {
+  if (arr->type_id() == arrow::Type::DICTIONARY) {
+    const auto* dict_arr = static_cast<const arrow::DictionaryArray*>(arr);
+    return arr->length() * sizeof(int32_t) + StringArrayBytes(dict_arr->dictionary().get());
+  }
+  const auto* str_arr = static_cast<const arrow::StringArray*>(arr);
+  int64_t data_bytes = 0;
+  if (str_arr->length() > 0) {
+    data_bytes = str_arr->value_offset(str_arr->length()) - str_arr->value_offset(0);
+  }
+  return arr->length() * sizeof(int32_t) + data_bytes;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
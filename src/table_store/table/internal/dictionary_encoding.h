@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+
+#include <memory>
+
+#include "src/common/base/base.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * DictionaryEncodeStringArray dictionary encodes the given string array, if the ratio of distinct
+ * values to rows is at most `max_distinct_ratio` and the encoding makes the array smaller.
+ * @param arr, the arrow::StringArray to encode.
+ * @param max_distinct_ratio, the maximum ratio of distinct values to rows to encode the array.
+ * @param mem_pool, the memory pool to allocate the encoded array from.
+ * @return an arrow::DictionaryArray with int32 indices, or nullptr if the array should not be
+ * encoded.
+ */
+StatusOr<ArrowArrayPtr> DictionaryEncodeStringArray(const arrow::Array* arr,
+                                                    double max_distinct_ratio,
+                                                    arrow::MemoryPool* mem_pool);
+
+/**
+ * DecodeDictionaryStringArray materializes a dictionary encoded string array (or a slice of one)
+ * into a plain arrow::StringArray.
+ * @param arr, the arrow::DictionaryArray to decode.
+ * @param mem_pool, the memory pool to allocate the decoded array from.
+ * @return the decoded arrow::StringArray.
+ */
+StatusOr<ArrowArrayPtr> DecodeDictionaryStringArray(const arrow::Array* arr,
+                                                    arrow::MemoryPool* mem_pool);
+
+/**
+ * StringArrayBytes returns the number of bytes used by a (possibly dictionary encoded) string
+ * array, using the same accounting as BatchSizeAccountant.
+ */
+int64_t StringArrayBytes(const arrow::Array* arr);
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <absl/strings/str_cat.h>
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/arrow_array_compactor.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+#include "src/table_store/table/internal/test_utils.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+TEST(DictionaryEncodingTest, EncodeDecodeRoundTrip) {
+  std::vector<types::StringValue> strings;
+  for (int i = 0; i < 100; ++i) {
+    strings.push_back(i % 3 == 0 ? "GET" : "/api/v1/some/long/path");
+  }
+  auto arr = types::ToArrow(strings, arrow::default_memory_pool());
+
+  ASSERT_OK_AND_ASSIGN(auto encoded,
+                       DictionaryEncodeStringArray(arr.get(), 0.1, arrow::default_memory_pool()));
+  ASSERT_NE(nullptr, encoded);
+  EXPECT_EQ(arrow::Type::DICTIONARY, encoded->type_id());
+  EXPECT_EQ(100, encoded->length());
+  EXPECT_LT(StringArrayBytes(encoded.get()), StringArrayBytes(arr.get()));
+
+  ASSERT_OK_AND_ASSIGN(auto decoded,
+                       DecodeDictionaryStringArray(encoded.get(), arrow::default_memory_pool()));
+  EXPECT_TRUE(decoded->Equals(arr));
+
+  // Decoding a slice only materializes the slice.
+  ASSERT_OK_AND_ASSIGN(auto decoded_slice, DecodeDictionaryStringArray(
+                                               encoded->Slice(10, 5).get(),
+                                               arrow::default_memory_pool()));
+  EXPECT_TRUE(decoded_slice->Equals(arr->Slice(10, 5)));
+}
+
+TEST(DictionaryEncodingTest, HighCardinalityNotEncoded) {
+  std::vector<types::StringValue> strings;
+  for (int i = 0; i < 100; ++i) {
+    strings.push_back(absl::StrCat("value", i));
+  }
+  auto arr = types::ToArrow(strings, arrow::default_memory_pool());
+
+  ASSERT_OK_AND_ASSIGN(auto encoded,
+                       DictionaryEncodeStringArray(arr.get(), 0.1, arrow::default_memory_pool()));
+  EXPECT_EQ(nullptr, encoded);
+}
+
+class DictionaryCompactionTest : public RecordOrRowBatchParamTest {};
+
+TEST_P(DictionaryCompactionTest, CompactorEncodesLowCardinalityStrings) {
+  ArrowArrayCompactor compactor(*rel_, arrow::default_memory_pool(), 0.5);
+
+  std::vector<types::Time64NSValue> times = {1, 2, 3, 4};
+  std::vector<types::BoolValue> bools = {true, false, true, false};
+  std::vector<types::StringValue> strings = {"a long repeated string", "a long repeated string",
+                                             "a long repeated string", "a long repeated string"};
+  std::unique_ptr<RecordOrRowBatch> batch;
+  ColSizes col_sizes;
+  std::tie(batch, col_sizes) = MakeRecordOrRowBatch(times, bools, strings);
+
+  ASSERT_OK(compactor.Reserve(times.size(), col_sizes));
+  compactor.UnsafeAppendBatchSlice(*batch, 0, times.size());
+  ASSERT_OK_AND_ASSIGN(auto out_columns, compactor.Finish());
+
+  EXPECT_EQ(arrow::Type::DICTIONARY, out_columns[2]->type_id());
+  EXPECT_GT(compactor.EncodedBytesSaved(), 0);
+  ASSERT_OK_AND_ASSIGN(auto decoded, DecodeDictionaryStringArray(out_columns[2].get(),
+                                                                 arrow::default_memory_pool()));
+  EXPECT_TRUE(decoded->Equals(types::ToArrow(strings, arrow::default_memory_pool())));
+}
+
+INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(DictionaryCompaction, DictionaryCompactionTest,
+                                          /*include_mixed*/ false);
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,332 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "src/table_store/table/internal/hot_store.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+HotStore::Entry::Entry(BatchID id, RowID first_row, RecordOrRowBatch&& hot_batch, Time min_time,
+                       Time max_time)
+    : batch_id(id),
+      batch_first_row_id(first_row),
+      last_row_id(first_row + hot_batch.Length() - 1),
+      last_time(max_time),
+      batch(std::move(hot_batch)),
+      first_row_id(first_row),
+      first_time(min_time) {}
+
+HotStore::Ring::Ring(size_t capacity)
+    : mask(capacity - 1), slots(new std::atomic<Entry*>[capacity]) {
+  DCHECK_EQ(capacity & mask, 0U) << "Ring capacity must be a power of 2";
+  for (size_t i = 0; i < capacity; ++i) {
+    slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+HotStore::EpochGuard::EpochGuard(const HotStore* store) : store_(store) {
+  while (true) {
+    epoch_ = store_->epoch_.load();
+    store_->active_reads_[epoch_ & 1].fetch_add(1);
+    // If the epoch advanced before the read was registered, the reclaimer may not have seen it.
+    if (store_->epoch_.load() == epoch_) {
+      return;
+    }
+    store_->active_reads_[epoch_ & 1].fetch_sub(1);
+  }
+}
+
+HotStore::EpochGuard::~EpochGuard() { store_->active_reads_[epoch_ & 1].fetch_sub(1); }
+
+HotStore::HotStore(const schema::Relation& rel, int64_t time_col_idx)
+    : rel_(rel), time_col_idx_(time_col_idx), ring_(new Ring(kInitialCapacity)) {}
+
+HotStore::~HotStore() {
+  auto* ring = ring_.load();
+  for (auto batch_id = head_.load(); batch_id < tail_.load(); ++batch_id) {
+    delete ring->slots[batch_id & ring->mask].load();
+  }
+  delete ring;
+}
+
+HotStore::Snapshot HotStore::TakeSnapshot() const {
+  Snapshot snapshot;
+  // The tail must be loaded before the ring, so that the ring contains every published batch.
+  snapshot.tail = tail_.load(std::memory_order_acquire);
+  snapshot.head = std::min(head_.load(std::memory_order_acquire), snapshot.tail);
+  snapshot.ring = ring_.load(std::memory_order_acquire);
+  return snapshot;
+}
+
+const HotStore::Entry* HotStore::EntryAt(const Snapshot& snapshot, BatchID batch_id) {
+  const auto* entry =
+      snapshot.ring->slots[batch_id & snapshot.ring->mask].load(std::memory_order_acquire);
+  if (entry == nullptr || entry->batch_id != batch_id) {
+    return nullptr;
+  }
+  return entry;
+}
+
+template <typename TPred>
+BatchID HotStore::PartitionPoint(const Snapshot& snapshot, TPred pred) {
+  BatchID lo = snapshot.head;
+  BatchID hi = snapshot.tail;
+  while (lo < hi) {
+    BatchID mid = lo + (hi - lo) / 2;
+    const auto* entry = EntryAt(snapshot, mid);
+    if (entry == nullptr || pred(*entry)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+StatusOr<std::unique_ptr<schema::RowBatch>> HotStore::GetNextRowBatch(
+    RowID* last_read_row_id, BatchHints* hints, std::optional<RowID> stop_row_id,
+    const std::vector<int64_t>& cols) const {
+  EpochGuard guard(this);
+  auto snapshot = TakeSnapshot();
+  auto start_row_id = *last_read_row_id + 1;
+  if (DCHECK_IS_ON() && stop_row_id.has_value()) {
+    DCHECK_LT(start_row_id, stop_row_id.value());
+  }
+
+  const Entry* entry = nullptr;
+  if (hints != nullptr && hints->hint_type == StoreType::Hot && hints->batch_id >= snapshot.head &&
+      hints->batch_id < snapshot.tail) {
+    entry = EntryAt(snapshot, hints->batch_id);
+    if (entry != nullptr && (start_row_id < entry->first_row_id.load(std::memory_order_acquire) ||
+                             start_row_id > entry->last_row_id)) {
+      entry = nullptr;
+    }
+  }
+  if (entry == nullptr) {
+    auto batch_id = PartitionPoint(
+        snapshot, [start_row_id](const Entry& e) { return e.last_row_id < start_row_id; });
+    if (batch_id == snapshot.tail) {
+      return std::unique_ptr<schema::RowBatch>(nullptr);
+    }
+    entry = EntryAt(snapshot, batch_id);
+    if (entry == nullptr || start_row_id < entry->first_row_id.load(std::memory_order_acquire)) {
+      return std::unique_ptr<schema::RowBatch>(nullptr);
+    }
+  }
+
+  size_t row_offset = start_row_id - entry->batch_first_row_id;
+  size_t batch_size = entry->last_row_id - start_row_id + 1;
+  if (stop_row_id.has_value() && entry->last_row_id >= stop_row_id.value()) {
+    // Reduce batch size if the batch extends past the given stop row.
+    batch_size -= (entry->last_row_id - stop_row_id.value()) + 1;
+  }
+
+  std::vector<types::DataType> col_types;
+  for (int64_t col_idx : cols) {
+    DCHECK(static_cast<size_t>(col_idx) < rel_.NumColumns());
+    col_types.push_back(rel_.col_types()[col_idx]);
+  }
+  auto output_rb = std::make_unique<schema::RowBatch>(schema::RowDescriptor(col_types), batch_size);
+  PL_RETURN_IF_ERROR(
+      entry->batch.AddBatchSliceToRowBatch(row_offset, batch_size, cols, output_rb.get()));
+
+  *last_read_row_id = start_row_id + batch_size - 1;
+  if (hints != nullptr) {
+    hints->batch_id = entry->batch_id + 1;
+    hints->hint_type = StoreType::Hot;
+  }
+  return output_rb;
+}
+
+std::optional<RowID> HotStore::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
+  if (time_col_idx_ == -1) {
+    return std::nullopt;
+  }
+  EpochGuard guard(this);
+  auto snapshot = TakeSnapshot();
+  auto batch_id = PartitionPoint(snapshot, [time](const Entry& e) { return e.last_time < time; });
+  const auto* entry = batch_id == snapshot.tail ? nullptr : EntryAt(snapshot, batch_id);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  auto row_idx = entry->batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
+  DCHECK_GE(row_idx, 0);
+  // Rows removed by RemovePrefix are no longer in the store.
+  return std::max(entry->batch_first_row_id + row_idx,
+                  entry->first_row_id.load(std::memory_order_acquire));
+}
+
+std::optional<RowID> HotStore::FindRowIDFromTimeFirstGreaterThan(Time time) const {
+  if (time_col_idx_ == -1) {
+    return std::nullopt;
+  }
+  EpochGuard guard(this);
+  auto snapshot = TakeSnapshot();
+  auto batch_id = PartitionPoint(snapshot, [time](const Entry& e) { return e.last_time <= time; });
+  const auto* entry = batch_id == snapshot.tail ? nullptr : EntryAt(snapshot, batch_id);
+  if (entry == nullptr) {
+    return std::nullopt;
+  }
+  auto row_idx = entry->batch.FindTimeFirstGreaterThan(time_col_idx_, time);
+  DCHECK_GE(row_idx, 0);
+  return std::max(entry->batch_first_row_id + row_idx,
+                  entry->first_row_id.load(std::memory_order_acquire));
+}
+
+size_t HotStore::Size() const {
+  auto snapshot = TakeSnapshot();
+  return snapshot.tail - snapshot.head;
+}
+
+std::optional<RowID> HotStore::FirstRowID() const {
+  EpochGuard guard(this);
+  while (true) {
+    auto snapshot = TakeSnapshot();
+    if (snapshot.head == snapshot.tail) {
+      return std::nullopt;
+    }
+    // The entry is only missing if it was popped after the snapshot, in which case we retry.
+    const auto* entry = EntryAt(snapshot, snapshot.head);
+    if (entry != nullptr) {
+      return entry->first_row_id.load(std::memory_order_acquire);
+    }
+  }
+}
+
+std::optional<RowID> HotStore::LastRowID() const {
+  EpochGuard guard(this);
+  while (true) {
+    auto snapshot = TakeSnapshot();
+    if (snapshot.head == snapshot.tail) {
+      return std::nullopt;
+    }
+    const auto* entry = EntryAt(snapshot, snapshot.tail - 1);
+    if (entry != nullptr) {
+      return entry->last_row_id;
+    }
+  }
+}
+
+Time HotStore::MinTime() const {
+  if (time_col_idx_ == -1) {
+    return -1;
+  }
+  EpochGuard guard(this);
+  while (true) {
+    auto snapshot = TakeSnapshot();
+    if (snapshot.head == snapshot.tail) {
+      return -1;
+    }
+    const auto* entry = EntryAt(snapshot, snapshot.head);
+    if (entry != nullptr) {
+      return entry->first_time.load(std::memory_order_acquire);
+    }
+  }
+}
+
+void HotStore::EmplaceBack(RowID first_row_id, RecordOrRowBatch&& batch) {
+  auto head = head_.load(std::memory_order_relaxed);
+  auto tail = tail_.load(std::memory_order_relaxed);
+  auto* ring = ring_.load(std::memory_order_relaxed);
+  if (static_cast<size_t>(tail - head) == ring->capacity()) {
+    auto new_ring = std::make_unique<Ring>(2 * ring->capacity());
+    for (auto batch_id = head; batch_id < tail; ++batch_id) {
+      new_ring->slots[batch_id & new_ring->mask].store(
+          ring->slots[batch_id & ring->mask].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    ring_.store(new_ring.get(), std::memory_order_release);
+    Retire(std::unique_ptr<Ring>(ring));
+    ring = new_ring.release();
+  }
+
+  Time first_time = -1;
+  Time last_time = -1;
+  if (time_col_idx_ != -1) {
+    first_time = batch.GetTimeValue(time_col_idx_, 0);
+    last_time = batch.GetTimeValue(time_col_idx_, batch.Length() - 1);
+  }
+  auto* entry = new Entry(tail, first_row_id, std::move(batch), first_time, last_time);
+  ring->slots[tail & ring->mask].store(entry, std::memory_order_release);
+  tail_.store(tail + 1, std::memory_order_release);
+  TryReclaim();
+}
+
+void HotStore::PopFront() {
+  auto head = head_.load(std::memory_order_relaxed);
+  DCHECK_LT(head, tail_.load(std::memory_order_relaxed));
+  auto* ring = ring_.load(std::memory_order_relaxed);
+  auto* entry = ring->slots[head & ring->mask].load(std::memory_order_relaxed);
+  head_.store(head + 1, std::memory_order_release);
+  ring->slots[head & ring->mask].store(nullptr, std::memory_order_release);
+  Retire(std::unique_ptr<Entry>(entry));
+  TryReclaim();
+}
+
+void HotStore::RemovePrefix(size_t num_rows) {
+  auto head = head_.load(std::memory_order_relaxed);
+  DCHECK_LT(head, tail_.load(std::memory_order_relaxed));
+  auto* ring = ring_.load(std::memory_order_relaxed);
+  auto* entry = ring->slots[head & ring->mask].load(std::memory_order_relaxed);
+  auto first_row_id = entry->first_row_id.load(std::memory_order_relaxed) + num_rows;
+  DCHECK_LE(first_row_id, entry->last_row_id);
+  if (time_col_idx_ != -1) {
+    entry->first_time.store(
+        entry->batch.GetTimeValue(time_col_idx_, first_row_id - entry->batch_first_row_id),
+        std::memory_order_release);
+  }
+  entry->first_row_id.store(first_row_id, std::memory_order_release);
+}
+
+const RecordOrRowBatch& HotStore::at(size_t batch_offset, size_t* removed_rows) const {
+  auto batch_id = head_.load(std::memory_order_relaxed) + batch_offset;
+  DCHECK_LT(batch_id, tail_.load(std::memory_order_relaxed));
+  auto* ring = ring_.load(std::memory_order_relaxed);
+  const auto* entry = ring->slots[batch_id & ring->mask].load(std::memory_order_relaxed);
+  *removed_rows = entry->first_row_id.load(std::memory_order_relaxed) - entry->batch_first_row_id;
+  return entry->batch;
+}
+
+void HotStore::Retire(std::unique_ptr<Entry> entry) {
+  retired_entries_[epoch_.load() & 1].push_back(std::move(entry));
+}
+
+void HotStore::Retire(std::unique_ptr<Ring> ring) {
+  retired_rings_[epoch_.load() & 1].push_back(std::move(ring));
+}
+
+void HotStore::TryReclaim() {
+  auto next_epoch = epoch_.load() + 1;
+  // Reads from the previous epoch have the same parity as the next epoch. Once they are done,
+  // nothing retired during the previous epoch can still be referenced: every read since then
+  // started after those objects were removed from the store.
+  if (active_reads_[next_epoch & 1].load() != 0) {
+    return;
+  }
+  retired_entries_[next_epoch & 1].clear();
+  retired_rings_[next_epoch & 1].clear();
+  epoch_.store(next_epoch);
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
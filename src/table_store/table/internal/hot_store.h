@@ -0,0 +1,195 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/internal/record_or_row_batch.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * HotStore holds the hot batches of a Table. It has the same row and time accounting as
+ * `StoreWithRowTimeAccounting<StoreType::Hot>`, but allows reads to proceed concurrently with
+ * writes without any locks:
+ *
+ *  - Mutations (EmplaceBack, PopFront, RemovePrefix) must be serialized by the caller, ie. there
+ *    is a single producer at a time. The Table serializes them with its hot lock.
+ *  - All const methods are lock-free and can be called from any number of threads concurrently
+ *    with each other and with mutations.
+ *
+ * Batches are stored in a ring of atomic entry pointers, indexed by BatchID. A new entry is
+ * published by storing its pointer and then advancing `tail_` with release semantics, so readers
+ * that observe the new tail also observe the entry. When the ring fills up it is replaced by a
+ * ring of twice the size. Batches are never modified after they are published: RemovePrefix only
+ * advances the entry's first RowID, so readers never see a batch change under them.
+ *
+ * Entries removed by PopFront, and rings replaced by growth, are reclaimed with a simple epoch
+ * scheme. Each read runs inside an epoch, and a removed object is only freed once all reads that
+ * started before it was removed have finished. Reads never hold an epoch across calls, so
+ * reclamation is only ever delayed by reads that are in flight.
+ */
+class HotStore : public NotCopyable {
+ public:
+  HotStore(const schema::Relation& rel, int64_t time_col_idx);
+  ~HotStore();
+
+  /**
+   * GetNextRowBatch returns the next row batch in this store after the given unique row id. See
+   * `StoreWithRowTimeAccounting::GetNextRowBatch` for the semantics of the arguments.
+   * @return the next RowBatch, or nullptr if the next row isn't in this store.
+   */
+  StatusOr<std::unique_ptr<schema::RowBatch>> GetNextRowBatch(
+      RowID* last_read_row_id, BatchHints* hints, std::optional<RowID> stop_row_id,
+      const std::vector<int64_t>& cols) const;
+
+  std::optional<RowID> FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const;
+  std::optional<RowID> FindRowIDFromTimeFirstGreaterThan(Time time) const;
+
+  /**
+   * @return the number of batches in the store.
+   */
+  size_t Size() const;
+  /**
+   * @return the RowID of the first row in the store, or std::nullopt if the store is empty.
+   */
+  std::optional<RowID> FirstRowID() const;
+  /**
+   * @return the RowID of the last row in the store, or std::nullopt if the store is empty.
+   */
+  std::optional<RowID> LastRowID() const;
+  /**
+   * @return the time of the first row in the store, or -1 if the store is empty or there is no
+   * time column.
+   */
+  Time MinTime() const;
+
+  /**
+   * EmplaceBack publishes the given batch at the back of the store. Must not be called
+   * concurrently with other mutations.
+   * @param first_row_id, unique RowID to use as the first RowID for the batch.
+   * @param batch, the batch to add.
+   */
+  void EmplaceBack(RowID first_row_id, RecordOrRowBatch&& batch);
+
+  /**
+   * PopFront removes the first batch in the store. Must not be called concurrently with other
+   * mutations.
+   */
+  void PopFront();
+
+  /**
+   * RemovePrefix removes the given number of rows from the first batch in the store. Must not be
+   * called concurrently with other mutations.
+   */
+  void RemovePrefix(size_t num_rows);
+
+  /**
+   * at returns the batch at the given offset from the front of the store, along with the number
+   * of rows that have been removed from the front of that batch by RemovePrefix. The rows of the
+   * batch before `*removed_rows` are no longer part of the store. The reference is valid until the
+   * next call to PopFront, so it must only be used by the thread performing mutations.
+   */
+  const RecordOrRowBatch& at(size_t batch_offset, size_t* removed_rows) const;
+
+ private:
+  struct Entry {
+    Entry(BatchID id, RowID first_row, RecordOrRowBatch&& hot_batch, Time min_time,
+          Time max_time);
+
+    const BatchID batch_id;
+    // RowID of row 0 of `batch`.
+    const RowID batch_first_row_id;
+    const RowID last_row_id;
+    const Time last_time;
+    const RecordOrRowBatch batch;
+    // RowID and time of the first row of the batch still in the store.
+    std::atomic<RowID> first_row_id;
+    std::atomic<Time> first_time;
+  };
+
+  struct Ring {
+    explicit Ring(size_t capacity);
+    size_t capacity() const { return mask + 1; }
+
+    const size_t mask;
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+  };
+
+  // Consistent view of the store for the duration of a read.
+  struct Snapshot {
+    BatchID head;
+    BatchID tail;
+    const Ring* ring;
+  };
+
+  // EpochGuard marks a read as in flight for its lifetime.
+  class EpochGuard {
+   public:
+    explicit EpochGuard(const HotStore* store);
+    ~EpochGuard();
+
+   private:
+    const HotStore* store_;
+    uint64_t epoch_;
+  };
+
+  static constexpr size_t kInitialCapacity = 64;
+
+  Snapshot TakeSnapshot() const;
+  // Returns the entry with the given batch id, or nullptr if it was removed from the store after
+  // the snapshot was taken.
+  static const Entry* EntryAt(const Snapshot& snapshot, BatchID batch_id);
+  // Returns the first batch in the snapshot for which `pred` is false, assuming that `pred` is
+  // true for a prefix of the batches. Batches that were removed after the snapshot count as true.
+  template <typename TPred>
+  static BatchID PartitionPoint(const Snapshot& snapshot, TPred pred);
+
+  void Retire(std::unique_ptr<Entry> entry);
+  void Retire(std::unique_ptr<Ring> ring);
+  // Frees objects retired two epochs ago if no reads from that epoch are still in flight.
+  void TryReclaim();
+
+  const schema::Relation& rel_;
+  const int64_t time_col_idx_;
+
+  std::atomic<Ring*> ring_;
+  std::atomic<BatchID> head_ = 0;
+  std::atomic<BatchID> tail_ = 0;
+
+  mutable std::atomic<uint64_t> epoch_ = 0;
+  mutable std::array<std::atomic<int64_t>, 2> active_reads_ = {0, 0};
+  // Objects removed during the epoch with the same parity. Only accessed by mutations.
+  std::array<std::vector<std::unique_ptr<Entry>>, 2> retired_entries_;
+  std::array<std::vector<std::unique_ptr<Ring>>, 2> retired_rings_;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
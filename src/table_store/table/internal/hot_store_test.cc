@@ -0,0 +1,240 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/table_store/table/internal/hot_store.h"
+#include "src/table_store/table/internal/test_utils.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class HotStoreTest : public RecordOrRowBatchParamTest {
+ protected:
+  void SetUp() override {
+    RecordOrRowBatchParamTest::SetUp();
+    store_ = std::make_unique<HotStore>(*rel_, 0);
+  }
+  std::unique_ptr<HotStore> store_;
+};
+
+TEST_P(HotStoreTest, PushRowBatchesCheckProperties) {
+  std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
+  std::vector<types::BoolValue> bools = {true, false, true, false};
+  std::vector<types::StringValue> strings = {"ab", "cd", "ef", "gh"};
+  auto [rb0, _] = MakeRecordOrRowBatch(times, bools, strings);
+
+  EXPECT_EQ(0, store_->Size());
+  EXPECT_FALSE(store_->FirstRowID().has_value());
+  EXPECT_FALSE(store_->LastRowID().has_value());
+  EXPECT_EQ(-1, store_->MinTime());
+
+  store_->EmplaceBack(0, std::move(*rb0));
+  auto next_row_id = 4;
+  EXPECT_EQ(1, store_->Size());
+
+  EXPECT_EQ(0, store_->FirstRowID());
+  EXPECT_EQ(3, store_->LastRowID());
+
+  auto optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(1);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(0, optional_row_id.value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(12);
+  ASSERT_FALSE(optional_row_id.has_value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThan(1);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(2, optional_row_id.value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThan(11);
+  ASSERT_FALSE(optional_row_id.has_value());
+
+  EXPECT_EQ(1, store_->MinTime());
+
+  times = {20, 20, 21};
+  bools = {false, false, false};
+  strings = {"", "", ""};
+  auto [rb1, __] = MakeRecordOrRowBatch(times, bools, strings);
+
+  store_->EmplaceBack(next_row_id, std::move(*rb1));
+  EXPECT_EQ(2, store_->Size());
+
+  EXPECT_EQ(0, store_->FirstRowID());
+  EXPECT_EQ(6, store_->LastRowID());
+
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(12);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(4, optional_row_id.value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThan(20);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(6, optional_row_id.value());
+
+  store_->PopFront();
+
+  EXPECT_EQ(1, store_->Size());
+  EXPECT_EQ(4, store_->FirstRowID());
+  EXPECT_EQ(6, store_->LastRowID());
+  EXPECT_EQ(20, store_->MinTime());
+
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(1);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(4, optional_row_id.value());
+}
+
+TEST_P(HotStoreTest, RemovePrefix) {
+  std::vector<types::Time64NSValue> times = {1, 1, 10, 11};
+  std::vector<types::BoolValue> bools = {true, false, true, false};
+  std::vector<types::StringValue> strings = {"ab", "cd", "ef", "gh"};
+  auto [rb0, _] = MakeRecordOrRowBatch(times, bools, strings);
+  store_->EmplaceBack(0, std::move(*rb0));
+
+  store_->RemovePrefix(2);
+  EXPECT_EQ(1, store_->Size());
+  EXPECT_EQ(2, store_->FirstRowID());
+  EXPECT_EQ(3, store_->LastRowID());
+  EXPECT_EQ(10, store_->MinTime());
+
+  auto optional_row_id = store_->FindRowIDFromTimeFirstGreaterThanOrEqual(1);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(2, optional_row_id.value());
+  optional_row_id = store_->FindRowIDFromTimeFirstGreaterThan(1);
+  ASSERT_TRUE(optional_row_id.has_value());
+  EXPECT_EQ(2, optional_row_id.value());
+
+  // The removed rows can't be read, and the batch is read from its new first row.
+  RowID last_read_row_id = 0;
+  BatchHints hints{};
+  ASSERT_OK_AND_ASSIGN(auto rb, store_->GetNextRowBatch(&last_read_row_id, &hints, std::nullopt,
+                                                        {0, 2}));
+  EXPECT_EQ(nullptr, rb);
+  last_read_row_id = 1;
+  ASSERT_OK_AND_ASSIGN(rb, store_->GetNextRowBatch(&last_read_row_id, &hints, std::nullopt,
+                                                   {0, 2}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(3, last_read_row_id);
+  EXPECT_TRUE(rb->ColumnAt(0)->Equals(types::ToArrow(std::vector<types::Time64NSValue>{10, 11},
+                                                     arrow::default_memory_pool())));
+  EXPECT_TRUE(rb->ColumnAt(1)->Equals(types::ToArrow(std::vector<types::StringValue>{"ef", "gh"},
+                                                     arrow::default_memory_pool())));
+
+  // The compactor reads the batch through `at`, relative to the removed rows.
+  size_t removed_rows = 0;
+  const auto& batch = store_->at(0, &removed_rows);
+  EXPECT_EQ(2, removed_rows);
+  EXPECT_EQ(4, batch.Length());
+}
+
+TEST_P(HotStoreTest, GrowsPastInitialCapacity) {
+  RowID next_row_id = 0;
+  int64_t num_batches = 1000;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    auto [rb, _] = MakeRecordOrRowBatch({2 * i, 2 * i + 1}, {true, false}, {"a", "b"});
+    store_->EmplaceBack(next_row_id, std::move(*rb));
+    next_row_id += 2;
+    // Pop some of the batches, so that the ring wraps around before it grows.
+    if (i % 3 == 0) {
+      store_->PopFront();
+    }
+  }
+  auto num_popped = (num_batches + 2) / 3;
+  EXPECT_EQ(num_batches - num_popped, store_->Size());
+  EXPECT_EQ(2 * num_popped, store_->FirstRowID());
+  EXPECT_EQ(next_row_id - 1, store_->LastRowID());
+  EXPECT_EQ(2 * num_popped, store_->MinTime());
+
+  // Read everything back, with and without hints.
+  for (bool use_hints : {true, false}) {
+    RowID last_read_row_id = store_->FirstRowID().value() - 1;
+    BatchHints hints{};
+    while (last_read_row_id < next_row_id - 1) {
+      auto expected_row_id = last_read_row_id + 1;
+      ASSERT_OK_AND_ASSIGN(auto rb, store_->GetNextRowBatch(&last_read_row_id,
+                                                            use_hints ? &hints : nullptr,
+                                                            std::nullopt, {0}));
+      ASSERT_NE(nullptr, rb);
+      EXPECT_EQ(expected_row_id, types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+                                     rb->ColumnAt(0).get(), 0));
+    }
+  }
+}
+
+TEST_P(HotStoreTest, ConcurrentReadsAndWrites) {
+  int64_t num_batches = 2000;
+  int64_t rows_per_batch = 4;
+  std::vector<std::unique_ptr<RecordOrRowBatch>> batches;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    std::vector<types::Time64NSValue> times;
+    for (int64_t j = 0; j < rows_per_batch; ++j) {
+      times.push_back(i * rows_per_batch + j);
+    }
+    batches.push_back(MakeRecordOrRowBatch(times, {true, false, true, false},
+                                           {"a", "b", "c", "d"})
+                          .first);
+  }
+
+  std::atomic<bool> done = false;
+  auto reader = [&]() {
+    RowID last_read_row_id = -1;
+    BatchHints hints{};
+    while (!done.load() || last_read_row_id < num_batches * rows_per_batch - 1) {
+      auto rb_or_s = store_->GetNextRowBatch(&last_read_row_id, &hints, std::nullopt, {0, 1, 2});
+      ASSERT_OK(rb_or_s);
+      auto rb = rb_or_s.ConsumeValueOrDie();
+      if (rb == nullptr) {
+        // Either the reader caught up with the writer, or its next row was popped.
+        auto first_row_id = store_->FirstRowID();
+        if (first_row_id.has_value() && last_read_row_id + 1 < first_row_id.value()) {
+          last_read_row_id = first_row_id.value() - 1;
+        }
+        continue;
+      }
+      // Each row's time is its RowID.
+      auto first_row_id = last_read_row_id - rb->num_rows() + 1;
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        ASSERT_EQ(first_row_id + i, types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+                                        rb->ColumnAt(0).get(), i));
+      }
+    }
+  };
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back(reader);
+  }
+  for (int64_t i = 0; i < num_batches; ++i) {
+    store_->EmplaceBack(i * rows_per_batch, std::move(*batches[i]));
+    if (store_->Size() > 100) {
+      store_->RemovePrefix(1);
+      store_->PopFront();
+    }
+  }
+  done.store(true);
+  for (auto& reader_thread : readers) {
+    reader_thread.join();
+  }
+  EXPECT_EQ(100, store_->Size());
+}
+
+INSTANTIATE_RECORD_OR_ROW_BATCH_TESTSUITE(HotStore, HotStoreTest, /*include_mixed*/ true);
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
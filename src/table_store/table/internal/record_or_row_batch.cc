@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <memory>
 #include <vector>
 
 #include "src/common/base/utils.h"
@@ -114,16 +115,20 @@ Status RecordOrRowBatch::AddBatchSliceToRowBatch(size_t row_start, size_t batch_
           [row_start, batch_size, cols,
            output_rb](const RecordBatchWithCache& record_batch_w_cache) {
             for (auto col_idx : cols) {
-              if (!record_batch_w_cache.cache_validity[col_idx]) {
-                // Arrow array wasn't in cache, convert it to arrow and then add
-                // to cache.
-                auto arr = (*record_batch_w_cache.record_batch)[col_idx]->ConvertToArrow(
-                    arrow::default_memory_pool());
-                record_batch_w_cache.arrow_cache[col_idx] = arr;
-                record_batch_w_cache.cache_validity[col_idx] = true;
+              auto* cache_entry = &record_batch_w_cache.arrow_cache[col_idx];
+              auto cached = std::atomic_load(cache_entry);
+              if (cached == nullptr) {
+                // Arrow array wasn't in cache, convert it to arrow and then add to cache. If
+                // another reader filled the cache in the meantime, use its array instead. Hot
+                // batches are never modified, so fixed size columns can share their memory with
+                // the arrow array instead of being copied.
+                auto arr = types::ShareAsArrow((*record_batch_w_cache.record_batch)[col_idx],
+                                               arrow::default_memory_pool());
+                if (std::atomic_compare_exchange_strong(cache_entry, &cached, arr)) {
+                  cached = arr;
+                }
               }
-              auto arr = record_batch_w_cache.arrow_cache[col_idx]->Slice(row_start, batch_size);
-              PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+              PL_RETURN_IF_ERROR(output_rb->AddColumn(cached->Slice(row_start, batch_size)));
             }
             return Status::OK();
           },
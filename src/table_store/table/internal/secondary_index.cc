@@ -0,0 +1,209 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <farmhash.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+#include "src/table_store/table/internal/secondary_index.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+uint64_t HashInt64(int64_t val) {
+  return ::util::Hash64(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+// Returns the hash of each row of the column, or std::nullopt for null rows.
+std::vector<std::optional<uint64_t>> HashColumn(types::DataType data_type,
+                                                const arrow::Array* arr) {
+  std::vector<std::optional<uint64_t>> hashes(arr->length());
+  if (data_type == types::DataType::STRING) {
+    if (arr->type_id() == arrow::Type::DICTIONARY) {
+      // Hash each distinct value once, and look up the hashes by dictionary index.
+      auto dict_arr = static_cast<const arrow::DictionaryArray*>(arr);
+      auto dict = dict_arr->dictionary();
+      std::vector<uint64_t> dict_hashes(dict->length());
+      for (int64_t i = 0; i < dict->length(); ++i) {
+        dict_hashes[i] =
+            ZoneMapBloomFilter::Hash(types::GetStringViewFromArrowArray(dict.get(), i));
+      }
+      auto indices = std::static_pointer_cast<arrow::Int32Array>(dict_arr->indices());
+      for (int64_t i = 0; i < arr->length(); ++i) {
+        if (!arr->IsNull(i)) {
+          hashes[i] = dict_hashes[indices->Value(i)];
+        }
+      }
+      return hashes;
+    }
+    for (int64_t i = 0; i < arr->length(); ++i) {
+      if (!arr->IsNull(i)) {
+        hashes[i] = ZoneMapBloomFilter::Hash(types::GetStringViewFromArrowArray(arr, i));
+      }
+    }
+    return hashes;
+  }
+  for (int64_t i = 0; i < arr->length(); ++i) {
+    if (arr->IsNull(i)) {
+      continue;
+    }
+    switch (data_type) {
+      case types::DataType::UINT128:
+        hashes[i] = ZoneMapBloomFilter::Hash(
+            types::GetValueFromArrowArray<types::DataType::UINT128>(arr, i));
+        break;
+      case types::DataType::INT64:
+        hashes[i] = HashInt64(types::GetValueFromArrowArray<types::DataType::INT64>(arr, i));
+        break;
+      default:
+        DCHECK(false) << "Unsupported secondary index type " << types::ToString(data_type);
+    }
+  }
+  return hashes;
+}
+
+}  // namespace
+
+bool SecondaryIndex::SupportsType(types::DataType data_type) {
+  return data_type == types::DataType::STRING || data_type == types::DataType::UINT128 ||
+         data_type == types::DataType::INT64;
+}
+
+std::optional<uint64_t> SecondaryIndex::HashLiteral(const PredicateLiteral& literal) const {
+  switch (data_type_) {
+    case types::DataType::STRING:
+      if (std::holds_alternative<std::string>(literal)) {
+        return ZoneMapBloomFilter::Hash(std::string_view(std::get<std::string>(literal)));
+      }
+      break;
+    case types::DataType::UINT128:
+      if (std::holds_alternative<absl::uint128>(literal)) {
+        return ZoneMapBloomFilter::Hash(std::get<absl::uint128>(literal));
+      }
+      break;
+    case types::DataType::INT64:
+      if (std::holds_alternative<int64_t>(literal)) {
+        return HashInt64(std::get<int64_t>(literal));
+      }
+      break;
+    default:
+      break;
+  }
+  return std::nullopt;
+}
+
+SecondaryIndex::BatchRuns SecondaryIndex::ComputeRuns(RowID first_row_id,
+                                                      const arrow::Array* arr) const {
+  BatchRuns batch_runs;
+  batch_runs.first_row_id = first_row_id;
+  batch_runs.last_row_id = first_row_id + arr->length() - 1;
+  auto hashes = HashColumn(data_type_, arr);
+  for (const auto& [row_idx, hash] : Enumerate(hashes)) {
+    if (!hash.has_value()) {
+      continue;
+    }
+    RowID row_id = first_row_id + row_idx;
+    auto& runs = batch_runs.runs;
+    if (!runs.empty() && runs.back().first == hash.value() &&
+        runs.back().second.second == row_id - 1) {
+      runs.back().second.second = row_id;
+      continue;
+    }
+    runs.emplace_back(hash.value(), RowIDInterval(row_id, row_id));
+  }
+  return batch_runs;
+}
+
+void SecondaryIndex::AddBatch(BatchRuns batch_runs) {
+  DCHECK(batches_.empty() || batches_.back().last_row_id < batch_runs.first_row_id);
+  IndexedBatch batch;
+  batch.last_row_id = batch_runs.last_row_id;
+  for (const auto& [hash, run] : batch_runs.runs) {
+    auto& ranges = postings_[hash];
+    if (ranges.empty()) {
+      bytes_ += kBytesPerKey;
+    }
+    if (ranges.empty() || ranges.back().second < batch_runs.first_row_id) {
+      // First occurrence of the key in this batch. Runs never span batches, so that they can be
+      // expired along with their batch.
+      batch.keys.push_back(hash);
+    }
+    ranges.push_back(run);
+  }
+  bytes_ += batch_runs.runs.size() * kBytesPerRun + batch.keys.size() * sizeof(uint64_t);
+  batches_.push_back(std::move(batch));
+}
+
+void SecondaryIndex::ExpireBatch() {
+  DCHECK(!batches_.empty());
+  const auto& batch = batches_.front();
+  for (auto key : batch.keys) {
+    auto it = postings_.find(key);
+    DCHECK(it != postings_.end());
+    auto& ranges = it->second;
+    while (!ranges.empty() && ranges.front().second <= batch.last_row_id) {
+      ranges.pop_front();
+      bytes_ -= kBytesPerRun;
+    }
+    if (ranges.empty()) {
+      postings_.erase(it);
+      bytes_ -= kBytesPerKey;
+    }
+  }
+  bytes_ -= batch.keys.size() * sizeof(uint64_t);
+  batches_.pop_front();
+}
+
+std::optional<RowIDInterval> SecondaryIndex::NextMatchingRange(const PredicateLiteral& literal,
+                                                               RowID start_row_id) const {
+  auto hash = HashLiteral(literal);
+  if (!hash.has_value()) {
+    return std::nullopt;
+  }
+  auto it = postings_.find(hash.value());
+  if (it == postings_.end()) {
+    return std::nullopt;
+  }
+  const auto& ranges = it->second;
+  auto range_it = std::lower_bound(
+      ranges.begin(), ranges.end(), start_row_id,
+      [](const RowIDInterval& range, RowID row_id) { return range.second < row_id; });
+  if (range_it == ranges.end()) {
+    return std::nullopt;
+  }
+  RowIDInterval range(std::max(range_it->first, start_row_id), range_it->second);
+  for (++range_it; range_it != ranges.end(); ++range_it) {
+    if (range_it->first - range.second > kMaxCoalesceGapRows) {
+      break;
+    }
+    range.second = range_it->second;
+  }
+  return range;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
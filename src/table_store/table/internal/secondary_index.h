@@ -0,0 +1,152 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include "src/shared/types/types.h"
+#include "src/table_store/table/internal/types.h"
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * SecondaryIndex maps each value of a single column of the cold store (eg. `upid` or `service`)
+ * to the ranges of consecutive rows holding that value. It lets a cursor with an equality
+ * predicate on the column jump straight to the matching rows, instead of reading every batch.
+ *
+ * Values are indexed by their 64-bit hash, so a lookup can return rows with a different value
+ * when hashes collide. Like zone maps, the index only prunes rows, and callers still have to
+ * filter the rows they read.
+ *
+ * Batches are added in RowID order as they are compacted, and removed from the front as they
+ * expire. SecondaryIndex is not thread-safe, the Table synchronizes access to it with the cold
+ * store lock.
+ */
+class SecondaryIndex {
+ public:
+  SecondaryIndex(int64_t col_idx, types::DataType data_type)
+      : col_idx_(col_idx), data_type_(data_type) {}
+
+  /**
+   * @return whether columns of the given type can be indexed.
+   */
+  static bool SupportsType(types::DataType data_type);
+
+  /**
+   * BatchRuns holds the runs of consecutive equal values in the indexed column of a single batch.
+   */
+  struct BatchRuns {
+    RowID first_row_id = 0;
+    RowID last_row_id = -1;
+    // Key hash and inclusive RowID range of each run, in RowID order.
+    std::vector<std::pair<uint64_t, RowIDInterval>> runs;
+  };
+
+  /**
+   * ComputeRuns hashes the indexed column of a batch, without modifying the index. It only reads
+   * immutable state, so it can be called without synchronization, eg. before taking the lock that
+   * guards AddBatch.
+   * @param first_row_id, the unique RowID of the first row of the batch.
+   * @param arr, the uncompressed indexed column of the batch.
+   */
+  BatchRuns ComputeRuns(RowID first_row_id, const arrow::Array* arr) const;
+
+  /**
+   * AddBatch adds the runs of a new cold batch to the index. Batches must be added in RowID order.
+   */
+  void AddBatch(BatchRuns batch_runs);
+  void AddBatch(RowID first_row_id, const arrow::Array* arr) {
+    AddBatch(ComputeRuns(first_row_id, arr));
+  }
+
+  /**
+   * ExpireBatch removes the oldest batch from the index, along with the postings of its rows.
+   */
+  void ExpireBatch();
+
+  // Matching ranges separated by at most this many rows are returned as a single range, so that
+  // a value interleaved with others (eg. a upid in a busy table) doesn't turn into a read per row.
+  static constexpr RowID kMaxCoalesceGapRows = 256;
+
+  /**
+   * NextMatchingRange returns the first range of rows at or after `start_row_id` whose rows may
+   * be equal to the given literal. Nearby ranges are coalesced (see kMaxCoalesceGapRows), so the
+   * range can contain rows that don't match.
+   * @param literal, the value to look up. Must hold the native type of the column.
+   * @param start_row_id, the RowID to start searching from.
+   * @return an inclusive range of RowIDs, or std::nullopt if no indexed row at or after
+   * `start_row_id` can match.
+   */
+  std::optional<RowIDInterval> NextMatchingRange(const PredicateLiteral& literal,
+                                                 RowID start_row_id) const;
+
+  /**
+   * @return whether the literal holds the native type of the indexed column, ie. whether
+   * NextMatchingRange can be used to look it up.
+   */
+  bool SupportsLiteral(const PredicateLiteral& literal) const {
+    return HashLiteral(literal).has_value();
+  }
+
+  int64_t col_idx() const { return col_idx_; }
+  /**
+   * @return the number of distinct (hashed) values in the index.
+   */
+  size_t NumKeys() const { return postings_.size(); }
+  /**
+   * @return the approximate number of heap bytes used by the index.
+   */
+  int64_t Bytes() const { return bytes_; }
+
+  // The approximate heap bytes used by each key of postings_: its hash map slot, plus the first
+  // block and the block map that std::deque allocates (512 and 64 bytes in libstdc++).
+  static constexpr int64_t kBytesPerKey =
+      sizeof(std::pair<const uint64_t, std::deque<RowIDInterval>>) + 1 + 512 + 64;
+  // The heap bytes used by each run of each batch.
+  static constexpr int64_t kBytesPerRun = sizeof(RowIDInterval);
+
+ private:
+  std::optional<uint64_t> HashLiteral(const PredicateLiteral& literal) const;
+
+  struct IndexedBatch {
+    RowID last_row_id;
+    // The distinct keys in the batch.
+    std::vector<uint64_t> keys;
+  };
+
+  const int64_t col_idx_;
+  const types::DataType data_type_;
+  // Key hash to the (sorted, non-overlapping) ranges of rows holding the key.
+  absl::flat_hash_map<uint64_t, std::deque<RowIDInterval>> postings_;
+  std::deque<IndexedBatch> batches_;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/internal/secondary_index.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+ArrowArrayPtr StringColumn(const std::vector<types::StringValue>& vals) {
+  return types::ToArrow(vals, arrow::default_memory_pool());
+}
+
+}  // namespace
+
+TEST(SecondaryIndexTest, SupportsType) {
+  EXPECT_TRUE(SecondaryIndex::SupportsType(types::DataType::STRING));
+  EXPECT_TRUE(SecondaryIndex::SupportsType(types::DataType::UINT128));
+  EXPECT_TRUE(SecondaryIndex::SupportsType(types::DataType::INT64));
+  EXPECT_FALSE(SecondaryIndex::SupportsType(types::DataType::FLOAT64));
+  EXPECT_FALSE(SecondaryIndex::SupportsType(types::DataType::TIME64NS));
+}
+
+TEST(SecondaryIndexTest, StringRuns) {
+  SecondaryIndex index(0, types::DataType::STRING);
+  index.AddBatch(0, StringColumn({"a", "a", "b", "b", "b", "a"}).get());
+  index.AddBatch(6, StringColumn({"a", "c"}).get());
+  EXPECT_EQ(3, index.NumKeys());
+
+  // "a" has runs [0, 1], [5, 5] and [6, 6], which are close enough to coalesce.
+  EXPECT_EQ(RowIDInterval(0, 6), index.NextMatchingRange(std::string("a"), 0));
+  EXPECT_EQ(RowIDInterval(1, 6), index.NextMatchingRange(std::string("a"), 1));
+  EXPECT_EQ(RowIDInterval(5, 6), index.NextMatchingRange(std::string("a"), 2));
+  EXPECT_EQ(RowIDInterval(2, 4), index.NextMatchingRange(std::string("b"), 0));
+  EXPECT_EQ(std::nullopt, index.NextMatchingRange(std::string("b"), 5));
+  EXPECT_EQ(RowIDInterval(7, 7), index.NextMatchingRange(std::string("c"), 0));
+  EXPECT_EQ(std::nullopt, index.NextMatchingRange(std::string("d"), 0));
+}
+
+TEST(SecondaryIndexTest, DistantRunsNotCoalesced) {
+  SecondaryIndex index(0, types::DataType::INT64);
+  std::vector<types::Int64Value> vals(2 * SecondaryIndex::kMaxCoalesceGapRows, 0);
+  vals.front() = 1;
+  vals.back() = 1;
+  index.AddBatch(100, types::ToArrow(vals, arrow::default_memory_pool()).get());
+
+  RowID last_row_id = 100 + static_cast<RowID>(vals.size()) - 1;
+  EXPECT_EQ(RowIDInterval(100, 100), index.NextMatchingRange(int64_t{1}, 0));
+  EXPECT_EQ(RowIDInterval(last_row_id, last_row_id), index.NextMatchingRange(int64_t{1}, 101));
+  EXPECT_EQ(RowIDInterval(101, last_row_id - 1), index.NextMatchingRange(int64_t{0}, 0));
+}
+
+TEST(SecondaryIndexTest, DictionaryColumn) {
+  SecondaryIndex index(0, types::DataType::STRING);
+  auto dictionary = StringColumn({"svc-a", "svc-b"});
+  arrow::Int32Builder indices_builder;
+  PL_CHECK_OK(indices_builder.AppendValues({1, 1, 0, 1}));
+  std::shared_ptr<arrow::Array> indices;
+  PL_CHECK_OK(indices_builder.Finish(&indices));
+  auto dict_arr = std::make_shared<arrow::DictionaryArray>(
+      arrow::dictionary(arrow::int32(), arrow::utf8()), indices, dictionary);
+  index.AddBatch(0, dict_arr.get());
+
+  EXPECT_EQ(RowIDInterval(2, 2), index.NextMatchingRange(std::string("svc-a"), 0));
+  EXPECT_EQ(RowIDInterval(0, 3), index.NextMatchingRange(std::string("svc-b"), 0));
+}
+
+TEST(SecondaryIndexTest, UInt128Column) {
+  SecondaryIndex index(0, types::DataType::UINT128);
+  std::vector<types::UInt128Value> upids = {types::UInt128Value(1, 2), types::UInt128Value(3, 4)};
+  index.AddBatch(0, types::ToArrow(upids, arrow::default_memory_pool()).get());
+
+  EXPECT_EQ(RowIDInterval(1, 1), index.NextMatchingRange(absl::MakeUint128(3, 4), 0));
+  // Literals of the wrong type can't be looked up.
+  EXPECT_FALSE(index.SupportsLiteral(std::string("a")));
+  EXPECT_TRUE(index.SupportsLiteral(absl::MakeUint128(3, 4)));
+}
+
+TEST(SecondaryIndexTest, ExpireBatch) {
+  SecondaryIndex index(0, types::DataType::STRING);
+  index.AddBatch(0, StringColumn({"a", "b"}).get());
+  index.AddBatch(2, StringColumn({"b", "c"}).get());
+  EXPECT_EQ(3, index.NumKeys());
+  // Each batch has two runs of distinct keys.
+  int64_t batch_bytes = 2 * (SecondaryIndex::kBytesPerRun + sizeof(uint64_t));
+  EXPECT_EQ(3 * SecondaryIndex::kBytesPerKey + 2 * batch_bytes, index.Bytes());
+
+  index.ExpireBatch();
+  EXPECT_EQ(2, index.NumKeys());
+  EXPECT_EQ(2 * SecondaryIndex::kBytesPerKey + batch_bytes, index.Bytes());
+  EXPECT_EQ(std::nullopt, index.NextMatchingRange(std::string("a"), 0));
+  EXPECT_EQ(RowIDInterval(2, 2), index.NextMatchingRange(std::string("b"), 0));
+
+  index.ExpireBatch();
+  EXPECT_EQ(0, index.NumKeys());
+  EXPECT_EQ(0, index.Bytes());
+  EXPECT_EQ(std::nullopt, index.NextMatchingRange(std::string("c"), 0));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
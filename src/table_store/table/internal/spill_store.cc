@@ -0,0 +1,401 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
+#include "src/table_store/table/internal/spill_store.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+namespace {
+
+template <typename T>
+inline T ReadValue(const uint8_t* data) {
+  T val;
+  std::memcpy(&val, data, sizeof(T));
+  return val;
+}
+
+template <typename T>
+inline void WriteValue(uint8_t* data, const T& val) {
+  std::memcpy(data, &val, sizeof(T));
+}
+
+template <types::DataType T>
+int64_t SerializedColumnBytes(const arrow::Array* arr, int64_t row_offset, int64_t num_rows) {
+  if constexpr (T == types::DataType::STRING) {
+    const auto* str_arr = static_cast<const arrow::StringArray*>(arr);
+    return (num_rows + 1) * sizeof(uint32_t) +
+           (str_arr->value_offset(row_offset + num_rows) - str_arr->value_offset(row_offset));
+  } else {
+    return num_rows * sizeof(typename types::DataTypeTraits<T>::native_type);
+  }
+}
+
+template <types::DataType T>
+void SerializeColumn(const arrow::Array* arr, int64_t row_offset, int64_t num_rows, uint8_t* out) {
+  if constexpr (T == types::DataType::STRING) {
+    uint8_t* str_data = out + (num_rows + 1) * sizeof(uint32_t);
+    uint32_t offset = 0;
+    for (int64_t i = 0; i < num_rows; ++i) {
+      WriteValue(out + i * sizeof(uint32_t), offset);
+      auto val = types::GetStringViewFromArrowArray(arr, row_offset + i);
+      std::memcpy(str_data + offset, val.data(), val.size());
+      offset += val.size();
+    }
+    WriteValue(out + num_rows * sizeof(uint32_t), offset);
+  } else {
+    using TNative = typename types::DataTypeTraits<T>::native_type;
+    for (int64_t i = 0; i < num_rows; ++i) {
+      TNative val = types::GetValueFromArrowArray<T>(arr, row_offset + i);
+      WriteValue(out + i * sizeof(TNative), val);
+    }
+  }
+}
+
+template <types::DataType T>
+StatusOr<ArrowArrayPtr> DeserializeColumnSlice(const uint8_t* col_data, int64_t num_rows,
+                                               int64_t row_offset, int64_t length) {
+  auto builder = types::MakeArrowBuilder(T, arrow::default_memory_pool());
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(length));
+  if constexpr (T == types::DataType::STRING) {
+    const auto* str_data =
+        reinterpret_cast<const char*>(col_data + (num_rows + 1) * sizeof(uint32_t));
+    auto start = ReadValue<uint32_t>(col_data + row_offset * sizeof(uint32_t));
+    auto end = ReadValue<uint32_t>(col_data + (row_offset + length) * sizeof(uint32_t));
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(end - start));
+    for (int64_t i = row_offset; i < row_offset + length; ++i) {
+      auto val_start = ReadValue<uint32_t>(col_data + i * sizeof(uint32_t));
+      auto val_end = ReadValue<uint32_t>(col_data + (i + 1) * sizeof(uint32_t));
+      typed_builder->UnsafeAppend(str_data + val_start, val_end - val_start);
+    }
+  } else {
+    using TNative = typename types::DataTypeTraits<T>::native_type;
+    for (int64_t i = row_offset; i < row_offset + length; ++i) {
+      typed_builder->UnsafeAppend(ReadValue<TNative>(col_data + i * sizeof(TNative)));
+    }
+  }
+  ArrowArrayPtr out;
+  PL_RETURN_IF_ERROR(typed_builder->Finish(&out));
+  return out;
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<SpillStore>> SpillStore::Create(const std::filesystem::path& path,
+                                                         int64_t capacity_bytes,
+                                                         const schema::Relation& rel,
+                                                         int64_t time_col_idx) {
+  if (capacity_bytes <= 0) {
+    return error::InvalidArgument("Spill store capacity must be positive, got $0", capacity_bytes);
+  }
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    return error::Internal("Failed to open spill file $0: $1", path.string(), strerror(errno));
+  }
+  // Allocate the file's blocks upfront, since running out of disk space while writing to the
+  // mapping would raise SIGBUS.
+  int err = posix_fallocate(fd, 0, capacity_bytes);
+  if (err != 0) {
+    close(fd);
+    return error::Internal("Failed to allocate $0 bytes for spill file $1: $2", capacity_bytes,
+                           path.string(), strerror(err));
+  }
+  void* data = mmap(nullptr, capacity_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    close(fd);
+    return error::Internal("Failed to mmap spill file $0: $1", path.string(), strerror(errno));
+  }
+  return std::unique_ptr<SpillStore>(new SpillStore(path, capacity_bytes, rel, time_col_idx, fd,
+                                                    static_cast<uint8_t*>(data)));
+}
+
+SpillStore::~SpillStore() {
+  munmap(data_, capacity_bytes_);
+  close(fd_);
+  std::error_code ec;
+  std::filesystem::remove(path_, ec);
+}
+
+void SpillStore::ReleasePages(int64_t offset, int64_t bytes) const {
+  // Dropping the pages from the mapping keeps spilled data out of the process' RSS. The data is
+  // still in the file (and the page cache), so it's paged back in on the next read.
+  static const int64_t kPageSize = sysconf(_SC_PAGESIZE);
+  int64_t start = offset / kPageSize * kPageSize;
+  int64_t end = std::min(capacity_bytes_, offset + bytes);
+  madvise(data_ + start, end - start, MADV_DONTNEED);
+}
+
+int64_t SpillStore::Reserve(int64_t bytes) {
+  auto pop_front = [this]() {
+    bytes_ -= records_.front().bytes;
+    records_.pop_front();
+  };
+  if (records_.empty()) {
+    return 0;
+  }
+  int64_t offset = records_.back().offset + records_.back().bytes;
+  if (offset + bytes > capacity_bytes_) {
+    // Wrap around to the start of the file. Any records past the end of the last record are the
+    // oldest in the store, and are evicted first so that the records stay in ring order.
+    while (!records_.empty() && records_.front().offset >= offset) {
+      pop_front();
+    }
+    offset = 0;
+  }
+  while (!records_.empty() && records_.front().offset < offset + bytes &&
+         records_.front().offset + records_.front().bytes > offset) {
+    pop_front();
+  }
+  return offset;
+}
+
+int64_t SpillStore::RecordBytes(const std::vector<ArrowArrayPtr>& columns, int64_t row_offset,
+                                int64_t num_rows) const {
+  int64_t record_bytes = sizeof(RecordHeader) + columns.size() * sizeof(uint64_t);
+  for (size_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+#define TYPE_CASE(_dt_) \
+  record_bytes += SerializedColumnBytes<_dt_>(columns[col_idx].get(), row_offset, num_rows);
+    PL_SWITCH_FOREACH_DATATYPE(rel_.col_types()[col_idx], TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return record_bytes;
+}
+
+Status SpillStore::SplitIntoRecords(const std::vector<ArrowArrayPtr>& columns, int64_t row_offset,
+                                    int64_t num_rows,
+                                    std::vector<std::pair<int64_t, int64_t>>* ranges) const {
+  auto record_bytes = RecordBytes(columns, row_offset, num_rows);
+  if (record_bytes <= capacity_bytes_) {
+    ranges->emplace_back(row_offset, num_rows);
+    return Status::OK();
+  }
+  if (num_rows == 1) {
+    return error::ResourceUnavailable("Row of $0 bytes is larger than the spill file ($1 bytes)",
+                                    record_bytes, capacity_bytes_);
+  }
+  int64_t half = num_rows / 2;
+  PL_RETURN_IF_ERROR(SplitIntoRecords(columns, row_offset, half, ranges));
+  return SplitIntoRecords(columns, row_offset + half, num_rows - half, ranges);
+}
+
+Status SpillStore::Append(RowID first_row_id, const ColdBatch& batch) {
+  int64_t num_rows = batch.Length();
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+  size_t num_cols = rel_.NumColumns();
+  std::vector<ArrowArrayPtr> columns(num_cols);
+  for (size_t col_idx = 0; col_idx < num_cols; ++col_idx) {
+    PL_ASSIGN_OR_RETURN(auto arr, batch.Column(col_idx, arrow::default_memory_pool()));
+    if (arr->type_id() == arrow::Type::DICTIONARY) {
+      PL_ASSIGN_OR_RETURN(arr,
+                          DecodeDictionaryStringArray(arr.get(), arrow::default_memory_pool()));
+    }
+    columns[col_idx] = std::move(arr);
+  }
+  // The batch is split up front, so that a batch that can't be spilled leaves no partial records.
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  PL_RETURN_IF_ERROR(SplitIntoRecords(columns, 0, num_rows, &ranges));
+  for (const auto& [row_offset, length] : ranges) {
+    WriteRecord(first_row_id + row_offset, columns, row_offset, length);
+  }
+  return Status::OK();
+}
+
+void SpillStore::WriteRecord(RowID first_row_id, const std::vector<ArrowArrayPtr>& columns,
+                             int64_t row_offset, int64_t num_rows) {
+  size_t num_cols = columns.size();
+  Time first_time = -1;
+  Time last_time = -1;
+  if (time_col_idx_ != -1) {
+    const auto* time_col = columns[time_col_idx_].get();
+    first_time = types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col, row_offset);
+    last_time = types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+        time_col, row_offset + num_rows - 1);
+  }
+
+  int64_t record_bytes = RecordBytes(columns, row_offset, num_rows);
+  auto offset = Reserve(record_bytes);
+  uint8_t* record_data = data_ + offset;
+  RecordHeader header;
+  header.magic = kRecordMagic;
+  header.record_bytes = record_bytes;
+  header.first_row_id = first_row_id;
+  header.num_rows = num_rows;
+  header.first_time = first_time;
+  header.last_time = last_time;
+  header.num_cols = num_cols;
+  WriteValue(record_data, header);
+  uint64_t col_offset = sizeof(RecordHeader) + num_cols * sizeof(uint64_t);
+  for (size_t col_idx = 0; col_idx < num_cols; ++col_idx) {
+    const auto* arr = columns[col_idx].get();
+    WriteValue(record_data + sizeof(RecordHeader) + col_idx * sizeof(uint64_t), col_offset);
+#define TYPE_CASE(_dt_)                                                          \
+  SerializeColumn<_dt_>(arr, row_offset, num_rows, record_data + col_offset); \
+  col_offset += SerializedColumnBytes<_dt_>(arr, row_offset, num_rows);
+    PL_SWITCH_FOREACH_DATATYPE(rel_.col_types()[col_idx], TYPE_CASE);
+#undef TYPE_CASE
+  }
+  ReleasePages(offset, record_bytes);
+
+  records_.push_back(Record{offset, record_bytes, first_row_id, first_row_id + num_rows - 1,
+                            first_time, last_time});
+  bytes_ += record_bytes;
+}
+
+StatusOr<std::unique_ptr<schema::RowBatch>> SpillStore::GetNextRowBatch(
+    RowID* last_read_row_id, std::optional<RowID> stop_row_id,
+    const std::vector<int64_t>& cols) const {
+  auto start_row_id = *last_read_row_id + 1;
+  if (records_.empty() || start_row_id < FirstRowID() || start_row_id > LastRowID()) {
+    return std::unique_ptr<schema::RowBatch>(nullptr);
+  }
+  const auto& record = records_[FindRecordFromRowID(start_row_id)];
+  DCHECK_EQ(kRecordMagic, ReadValue<RecordHeader>(data_ + record.offset).magic);
+  if (start_row_id < record.first_row_id) {
+    // The rows before this record failed to spill and were dropped, so skip over them.
+    start_row_id = record.first_row_id;
+  }
+  int64_t num_rows = record.last_row_id - record.first_row_id + 1;
+  int64_t row_offset = start_row_id - record.first_row_id;
+  int64_t batch_size = record.last_row_id - start_row_id + 1;
+  if (stop_row_id.has_value() && record.last_row_id >= stop_row_id.value()) {
+    // Reduce batch size if the record extends past the given stop row. The stop row may fall in
+    // the dropped rows before the record, in which case nothing is read.
+    batch_size -= (record.last_row_id - stop_row_id.value()) + 1;
+    batch_size = std::max<int64_t>(batch_size, 0);
+  }
+
+  std::vector<types::DataType> col_types;
+  for (int64_t col_idx : cols) {
+    DCHECK(static_cast<size_t>(col_idx) < rel_.NumColumns());
+    col_types.push_back(rel_.col_types()[col_idx]);
+  }
+  auto output_rb =
+      std::make_unique<schema::RowBatch>(schema::RowDescriptor(col_types), batch_size);
+  for (int64_t col_idx : cols) {
+    const uint8_t* col_data = ColumnData(record, col_idx);
+    ArrowArrayPtr arr;
+#define TYPE_CASE(_dt_)                                                                  \
+  PL_ASSIGN_OR_RETURN(arr,                                                               \
+                      DeserializeColumnSlice<_dt_>(col_data, num_rows, row_offset, batch_size));
+    PL_SWITCH_FOREACH_DATATYPE(rel_.col_types()[col_idx], TYPE_CASE);
+#undef TYPE_CASE
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+  }
+  ReleasePages(record.offset, record.bytes);
+
+  *last_read_row_id = start_row_id + batch_size - 1;
+  return output_rb;
+}
+
+const uint8_t* SpillStore::ColumnData(const Record& record, int64_t col_idx) const {
+  const uint8_t* record_data = data_ + record.offset;
+  auto col_offset =
+      ReadValue<uint64_t>(record_data + sizeof(RecordHeader) + col_idx * sizeof(uint64_t));
+  return record_data + col_offset;
+}
+
+Time SpillStore::GetTimeValue(const Record& record, int64_t row_idx) const {
+  return ReadValue<Time>(ColumnData(record, time_col_idx_) + row_idx * sizeof(Time));
+}
+
+template <typename TPred>
+int64_t SpillStore::PartitionPoint(const Record& record, TPred pred) const {
+  int64_t lo = 0;
+  int64_t hi = record.last_row_id - record.first_row_id + 1;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (pred(GetTimeValue(record, mid))) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+std::optional<RowID> SpillStore::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
+  if (time_col_idx_ == -1) {
+    return std::nullopt;
+  }
+  auto it = std::lower_bound(records_.begin(), records_.end(), time,
+                             [](const Record& record, Time t) { return record.last_time < t; });
+  if (it == records_.end()) {
+    return std::nullopt;
+  }
+  return it->first_row_id + PartitionPoint(*it, [time](Time t) { return t >= time; });
+}
+
+std::optional<RowID> SpillStore::FindRowIDFromTimeFirstGreaterThan(Time time) const {
+  if (time_col_idx_ == -1) {
+    return std::nullopt;
+  }
+  auto it = std::upper_bound(records_.begin(), records_.end(), time,
+                             [](Time t, const Record& record) { return t < record.last_time; });
+  if (it == records_.end()) {
+    return std::nullopt;
+  }
+  return it->first_row_id + PartitionPoint(*it, [time](Time t) { return t > time; });
+}
+
+RowID SpillStore::FirstRowID() const {
+  DCHECK(!records_.empty());
+  return records_.front().first_row_id;
+}
+
+RowID SpillStore::LastRowID() const {
+  DCHECK(!records_.empty());
+  return records_.back().last_row_id;
+}
+
+Time SpillStore::MinTime() const {
+  if (time_col_idx_ == -1 || records_.empty()) {
+    return -1;
+  }
+  return records_.front().first_time;
+}
+
+size_t SpillStore::FindRecordFromRowID(RowID row_id) const {
+  auto it =
+      std::lower_bound(records_.begin(), records_.end(), row_id,
+                       [](const Record& record, RowID id) { return record.last_row_id < id; });
+  DCHECK(it != records_.end());
+  return std::distance(records_.begin(), it);
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
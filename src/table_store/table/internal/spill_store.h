@@ -0,0 +1,181 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * SpillStore is the third tier of a Table, below the hot and cold stores. Cold batches that are
+ * expired from memory are serialized into a fixed size, mmap-backed ring file on local disk, so
+ * that a table can retain more history than fits in its memory budget. When the file is full, the
+ * oldest spilled batches are overwritten.
+ *
+ * Each spilled batch is stored as one or more records:
+ *   RecordHeader | column offsets (uint64 per column) | column data...
+ * Fixed size columns are stored as contiguous native values. String columns are stored as
+ * (num_rows + 1) uint32 offsets followed by the string bytes. The record headers hold the RowID
+ * and time range of each record and form the on-disk time index. An in-memory copy of the index is
+ * kept for lookups, so that only the records being read are paged in.
+ *
+ * SpillStore is not thread-safe, the Table synchronizes access to it.
+ */
+class SpillStore : public NotCopyable {
+ public:
+  /**
+   * Create a spill store backed by a new file at the given path. Any existing file at the path is
+   * truncated.
+   * @param path, the path of the ring file.
+   * @param capacity_bytes, the size of the ring file.
+   * @param rel, the relation of the table.
+   * @param time_col_idx, the index of the time column, or -1 if the table has no time column.
+   */
+  static StatusOr<std::unique_ptr<SpillStore>> Create(const std::filesystem::path& path,
+                                                      int64_t capacity_bytes,
+                                                      const schema::Relation& rel,
+                                                      int64_t time_col_idx);
+  ~SpillStore();
+
+  /**
+   * Append serializes the given cold batch to the ring file, overwriting the oldest records if
+   * there isn't enough space. Batches larger than the capacity of the file are split into several
+   * records, of which only the newest are kept if the batch doesn't fit. A batch holding a single
+   * row larger than the file can't be spilled, so an error is returned and nothing is written.
+   * @param first_row_id, the unique RowID of the first row of the batch.
+   * @param batch, the batch to spill.
+   */
+  Status Append(RowID first_row_id, const ColdBatch& batch);
+
+  /**
+   * GetNextRowBatch returns the next row batch in the spill store after the given unique row id.
+   * See StoreWithRowTimeAccounting::GetNextRowBatch for the semantics of the arguments.
+   * @return the next RowBatch, or nullptr if the next row isn't in the spill store.
+   */
+  StatusOr<std::unique_ptr<schema::RowBatch>> GetNextRowBatch(
+      RowID* last_read_row_id, std::optional<RowID> stop_row_id,
+      const std::vector<int64_t>& cols) const;
+
+  std::optional<RowID> FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const;
+  std::optional<RowID> FindRowIDFromTimeFirstGreaterThan(Time time) const;
+
+  /**
+   * @return the RowID of the first row in the store. Only valid if Size() > 0.
+   */
+  RowID FirstRowID() const;
+  /**
+   * @return the RowID of the last row in the store. Only valid if Size() > 0.
+   */
+  RowID LastRowID() const;
+  /**
+   * @return the time of the first row in the store, or -1 if the store is empty or there is no
+   * time column.
+   */
+  Time MinTime() const;
+
+  /**
+   * @return the number of records in the store.
+   */
+  size_t Size() const { return records_.size(); }
+  /**
+   * @return the number of bytes of the ring file used by live records.
+   */
+  int64_t Bytes() const { return bytes_; }
+  int64_t capacity_bytes() const { return capacity_bytes_; }
+
+ private:
+  struct RecordHeader {
+    uint64_t magic;
+    uint64_t record_bytes;
+    RowID first_row_id;
+    int64_t num_rows;
+    Time first_time;
+    Time last_time;
+    uint64_t num_cols;
+  };
+  static constexpr uint64_t kRecordMagic = 0x706c5370696c6c31;  // "plSpill1"
+
+  // In-memory copy of a record header, along with the record's offset in the ring file.
+  struct Record {
+    int64_t offset;
+    int64_t bytes;
+    RowID first_row_id;
+    RowID last_row_id;
+    Time first_time;
+    Time last_time;
+  };
+
+  SpillStore(std::filesystem::path path, int64_t capacity_bytes, const schema::Relation& rel,
+             int64_t time_col_idx, int fd, uint8_t* data)
+      : path_(std::move(path)),
+        capacity_bytes_(capacity_bytes),
+        rel_(rel),
+        time_col_idx_(time_col_idx),
+        fd_(fd),
+        data_(data) {}
+
+  // Returns the size of the record holding `num_rows` rows of the columns from `row_offset` on.
+  int64_t RecordBytes(const std::vector<ArrowArrayPtr>& columns, int64_t row_offset,
+                      int64_t num_rows) const;
+  // Splits the given rows of the columns into ranges of rows that each fit in a record, appending
+  // them as (row_offset, num_rows) pairs to `ranges`.
+  Status SplitIntoRecords(const std::vector<ArrowArrayPtr>& columns, int64_t row_offset,
+                          int64_t num_rows,
+                          std::vector<std::pair<int64_t, int64_t>>* ranges) const;
+  void WriteRecord(RowID first_row_id, const std::vector<ArrowArrayPtr>& columns,
+                   int64_t row_offset, int64_t num_rows);
+  // Finds space for a record of the given size, evicting the oldest records as needed, and returns
+  // its offset in the ring file.
+  int64_t Reserve(int64_t bytes);
+  void ReleasePages(int64_t offset, int64_t bytes) const;
+  size_t FindRecordFromRowID(RowID row_id) const;
+  const uint8_t* ColumnData(const Record& record, int64_t col_idx) const;
+  Time GetTimeValue(const Record& record, int64_t row_idx) const;
+  // Returns the index of the first row in the record for which `pred(time)` is true. The predicate
+  // must be monotonic over the (sorted) time column.
+  template <typename TPred>
+  int64_t PartitionPoint(const Record& record, TPred pred) const;
+
+  const std::filesystem::path path_;
+  const int64_t capacity_bytes_;
+  const schema::Relation rel_;
+  const int64_t time_col_idx_;
+  int fd_;
+  uint8_t* data_;
+
+  std::deque<Record> records_;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/spill_store.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+class SpillStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::BOOLEAN,
+                                     types::DataType::STRING},
+        std::vector<std::string>{"time_", "bool", "string"});
+  }
+
+  ColdBatch MakeBatch(const std::vector<types::Time64NSValue>& times,
+                      const std::vector<types::BoolValue>& bools,
+                      const std::vector<types::StringValue>& strings) {
+    return ColdBatch(std::vector<ArrowArrayPtr>{
+        types::ToArrow(times, arrow::default_memory_pool()),
+        types::ToArrow(bools, arrow::default_memory_pool()),
+        types::ToArrow(strings, arrow::default_memory_pool()),
+    });
+  }
+
+  std::unique_ptr<SpillStore> MakeStore(int64_t capacity_bytes) {
+    auto store_or_s = SpillStore::Create(temp_dir_.path() / "table.spill", capacity_bytes, *rel_,
+                                         /* time_col_idx */ 0);
+    EXPECT_OK(store_or_s);
+    return store_or_s.ConsumeValueOrDie();
+  }
+
+  px::testing::TempDir temp_dir_;
+  std::unique_ptr<schema::Relation> rel_;
+};
+
+TEST_F(SpillStoreTest, AppendAndRead) {
+  auto store = MakeStore(1024 * 1024);
+  ASSERT_OK(store->Append(0, MakeBatch({1, 2, 3}, {true, false, true}, {"a", "bc", ""})));
+  ASSERT_OK(store->Append(3, MakeBatch({5, 5, 8}, {false, false, true}, {"def", "g", "hi"})));
+
+  EXPECT_EQ(2, store->Size());
+  EXPECT_EQ(0, store->FirstRowID());
+  EXPECT_EQ(5, store->LastRowID());
+  EXPECT_EQ(1, store->MinTime());
+
+  EXPECT_EQ(3, store->FindRowIDFromTimeFirstGreaterThanOrEqual(4));
+  EXPECT_EQ(5, store->FindRowIDFromTimeFirstGreaterThan(5));
+  EXPECT_EQ(std::nullopt, store->FindRowIDFromTimeFirstGreaterThan(8));
+
+  RowID last_read_row_id = 0;
+  ASSERT_OK_AND_ASSIGN(auto rb, store->GetNextRowBatch(&last_read_row_id, std::nullopt, {0, 2}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(2, last_read_row_id);
+  std::vector<types::Time64NSValue> expected_times = {2, 3};
+  std::vector<types::StringValue> expected_strings = {"bc", ""};
+  EXPECT_TRUE(
+      rb->ColumnAt(0)->Equals(types::ToArrow(expected_times, arrow::default_memory_pool())));
+  EXPECT_TRUE(
+      rb->ColumnAt(1)->Equals(types::ToArrow(expected_strings, arrow::default_memory_pool())));
+
+  // The stop row cuts the second batch short.
+  ASSERT_OK_AND_ASSIGN(rb, store->GetNextRowBatch(&last_read_row_id, 5, {1}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(4, last_read_row_id);
+  std::vector<types::BoolValue> expected_bools = {false, false};
+  EXPECT_TRUE(
+      rb->ColumnAt(0)->Equals(types::ToArrow(expected_bools, arrow::default_memory_pool())));
+
+  last_read_row_id = 5;
+  ASSERT_OK_AND_ASSIGN(rb, store->GetNextRowBatch(&last_read_row_id, std::nullopt, {0}));
+  EXPECT_EQ(nullptr, rb);
+}
+
+TEST_F(SpillStoreTest, RingEvictsOldest) {
+  std::vector<types::Time64NSValue> times(100);
+  std::vector<types::BoolValue> bools(100, true);
+  std::vector<types::StringValue> strings(100, "abcdefgh");
+
+  // Each record is a few KB, so only a few fit at a time.
+  auto store = MakeStore(8 * 1024);
+  RowID next_row_id = 0;
+  for (int batch = 0; batch < 20; ++batch) {
+    for (size_t i = 0; i < times.size(); ++i) {
+      times[i] = next_row_id + i;
+    }
+    ASSERT_OK(store->Append(next_row_id, MakeBatch(times, bools, strings)));
+    next_row_id += times.size();
+
+    EXPECT_LE(store->Bytes(), store->capacity_bytes());
+    EXPECT_EQ(next_row_id - 1, store->LastRowID());
+    EXPECT_EQ(static_cast<int64_t>(store->Size() * times.size()),
+              store->LastRowID() - store->FirstRowID() + 1);
+  }
+  EXPECT_GT(store->FirstRowID(), 0);
+
+  // All remaining records are intact.
+  RowID last_read_row_id = store->FirstRowID() - 1;
+  while (last_read_row_id < store->LastRowID()) {
+    auto first_row = last_read_row_id + 1;
+    ASSERT_OK_AND_ASSIGN(auto rb, store->GetNextRowBatch(&last_read_row_id, std::nullopt, {0, 2}));
+    ASSERT_NE(nullptr, rb);
+    EXPECT_EQ(first_row, types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+                             rb->ColumnAt(0).get(), 0));
+    EXPECT_EQ("abcdefgh", types::GetValueFromArrowArray<types::DataType::STRING>(
+                              rb->ColumnAt(1).get(), 99));
+  }
+}
+
+TEST_F(SpillStoreTest, BatchLargerThanCapacitySplit) {
+  std::vector<types::Time64NSValue> times(1000);
+  std::vector<types::BoolValue> bools(1000, true);
+  std::vector<types::StringValue> strings(1000, "abcdefgh");
+  for (size_t i = 0; i < times.size(); ++i) {
+    times[i] = i;
+  }
+
+  // The batch is ~21KB, so it's split into records small enough to fit, and the newest are kept.
+  auto store = MakeStore(8 * 1024);
+  ASSERT_OK(store->Append(0, MakeBatch(times, bools, strings)));
+  EXPECT_GT(store->Size(), 0);
+  EXPECT_LE(store->Bytes(), store->capacity_bytes());
+  EXPECT_GT(store->FirstRowID(), 0);
+  EXPECT_EQ(999, store->LastRowID());
+  EXPECT_EQ(store->FirstRowID(), store->FindRowIDFromTimeFirstGreaterThanOrEqual(0));
+
+  RowID last_read_row_id = store->FirstRowID() - 1;
+  while (last_read_row_id < store->LastRowID()) {
+    auto first_row = last_read_row_id + 1;
+    ASSERT_OK_AND_ASSIGN(auto rb, store->GetNextRowBatch(&last_read_row_id, std::nullopt, {0, 2}));
+    ASSERT_NE(nullptr, rb);
+    EXPECT_EQ(first_row, types::GetValueFromArrowArray<types::DataType::TIME64NS>(
+                             rb->ColumnAt(0).get(), 0));
+    EXPECT_EQ("abcdefgh", types::GetValueFromArrowArray<types::DataType::STRING>(
+                              rb->ColumnAt(1).get(), rb->num_rows() - 1));
+  }
+}
+
+TEST_F(SpillStoreTest, RowLargerThanCapacityRejected) {
+  auto store = MakeStore(64);
+  auto s = store->Append(0, MakeBatch({1, 2, 3}, {true, false, true}, {"a", "bc", ""}));
+  EXPECT_NOT_OK(s);
+  EXPECT_EQ(statuspb::RESOURCE_UNAVAILABLE, s.code());
+  EXPECT_EQ(0, store->Size());
+}
+
+TEST_F(SpillStoreTest, ReadAcrossRowsThatFailedToSpill) {
+  auto store = MakeStore(1024);
+  ASSERT_OK(store->Append(0, MakeBatch({1, 2, 3}, {true, false, true}, {"a", "bc", ""})));
+  // Rows 3 to 5 fail to spill, so the table drops them and the row IDs in the store have a gap.
+  std::string large_row(2048, 'x');
+  EXPECT_NOT_OK(store->Append(3, MakeBatch({4, 5, 6}, {true, true, true}, {"d", large_row, ""})));
+  ASSERT_OK(store->Append(6, MakeBatch({7, 8, 9}, {false, true, false}, {"g", "hi", "j"})));
+  EXPECT_EQ(2, store->Size());
+
+  RowID last_read_row_id = 2;
+  ASSERT_OK_AND_ASSIGN(auto rb, store->GetNextRowBatch(&last_read_row_id, std::nullopt, {0, 2}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(8, last_read_row_id);
+  std::vector<types::Time64NSValue> expected_times = {7, 8, 9};
+  std::vector<types::StringValue> expected_strings = {"g", "hi", "j"};
+  EXPECT_TRUE(
+      rb->ColumnAt(0)->Equals(types::ToArrow(expected_times, arrow::default_memory_pool())));
+  EXPECT_TRUE(
+      rb->ColumnAt(1)->Equals(types::ToArrow(expected_strings, arrow::default_memory_pool())));
+
+  // A stop row inside the gap reads nothing, but moves the cursor past the stop row.
+  last_read_row_id = 2;
+  ASSERT_OK_AND_ASSIGN(rb, store->GetNextRowBatch(&last_read_row_id, 5, {0}));
+  ASSERT_NE(nullptr, rb);
+  EXPECT_EQ(0, rb->num_rows());
+  EXPECT_GE(last_read_row_id + 1, 5);
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
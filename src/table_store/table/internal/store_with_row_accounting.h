@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -28,7 +30,10 @@
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/dictionary_encoding.h"
 #include "src/table_store/table/internal/types.h"
+#include "src/table_store/table/internal/zone_map.h"
 
 namespace px {
 namespace table_store {
@@ -164,6 +169,7 @@ class StoreWithRowTimeAccounting {
 
     row_ids_.pop_front();
     if (time_col_idx_ != -1) times_.pop_front();
+    if constexpr (TStoreType == StoreType::Cold) zone_maps_.pop_front();
 
     auto&& front = std::move(batches_.front());
     batches_.pop_front();
@@ -179,16 +185,84 @@ class StoreWithRowTimeAccounting {
   template <typename... Args>
   TBatch& EmplaceBack(RowID first_row_id, Args... args) {
     auto& batch = batches_.emplace_back(std::forward<Args>(args)...);
-
-    row_ids_.emplace_back(first_row_id, first_row_id + BatchLength(batch) - 1);
-    if (time_col_idx_ != -1) {
-      auto first_time = GetTimeValue(batch, 0);
-      auto last_time = GetTimeValue(batch, BatchLength(batch) - 1);
-      times_.emplace_back(first_time, last_time);
+    AddBatchAccounting(first_row_id, batch);
+    if constexpr (TStoreType == StoreType::Cold) {
+      zone_maps_.push_back(BatchZoneMap::Create(rel_, batch));
     }
     return batch;
   }
 
+  /**
+   * PushBackWithZoneMap moves the given batch to the back of the store, along with its precomputed
+   * zone map. This allows the zone map to be computed (and the batch to be compressed) without
+   * holding the store's lock. This method is only valid for the `Cold` store.
+   * @param first_row_id, unique RowID to use as the first RowID for the batch.
+   * @param batch, the batch to add to the store.
+   * @param zone_map, the zone map of the batch, computed before the batch was compressed.
+   * @return lvalue reference to the added batch.
+   */
+  TBatch& PushBackWithZoneMap(RowID first_row_id, TBatch&& batch, BatchZoneMap zone_map) {
+    if constexpr (TStoreType != StoreType::Cold) {
+      constexpr_else_static_assert_false();
+    }
+    auto& added_batch = batches_.emplace_back(std::move(batch));
+    AddBatchAccounting(first_row_id, added_batch);
+    zone_maps_.push_back(std::move(zone_map));
+    return added_batch;
+  }
+
+  /**
+   * at returns the batch at the given offset from the front of the store.
+   * @param batch_offset, number of batches from the front of the store.
+   * @return const reference to the batch.
+   */
+  const TBatch& at(size_t batch_offset) const {
+    DCHECK_LT(batch_offset, batches_.size());
+    return batches_[batch_offset];
+  }
+
+  /**
+   * SkipBatchesNotMatching advances the given last read RowID past any batches (starting from the
+   * batch containing the next row to read) whose zone maps show that they cannot contain a row
+   * matching all of the given predicates. This method is only valid for the `Cold` store, since
+   * zone maps are only maintained for compacted batches.
+   * @param last_read_row_id, pointer to the unique RowID of the last read row. Updated to point to
+   * the last row of the last skipped batch (or to `stop_row_id - 1` if the skipped batch extends
+   * past the stop row).
+   * @param stop_row_id, an optional unique RowID to stop skipping at.
+   * @param predicates, conjunction of predicates that rows must match.
+   * @return the number of batches skipped.
+   */
+  int64_t SkipBatchesNotMatching(RowID* last_read_row_id, std::optional<RowID> stop_row_id,
+                                 const std::vector<ColumnPredicate>& predicates) const {
+    if constexpr (TStoreType != StoreType::Cold) {
+      constexpr_else_static_assert_false();
+    }
+    int64_t num_skipped = 0;
+    if (predicates.empty()) {
+      return num_skipped;
+    }
+    auto start_row_id = *last_read_row_id + 1;
+    if (batches_.empty() || start_row_id < FirstRowID() || start_row_id > LastRowID()) {
+      return num_skipped;
+    }
+    for (auto batch_id = FindBatchIDFromRowID(start_row_id); batch_id <= LastBatchID();
+         ++batch_id) {
+      if (stop_row_id.has_value() && *last_read_row_id + 1 >= stop_row_id.value()) {
+        break;
+      }
+      if (zone_maps_[batch_id - first_batch_id_].MayMatch(predicates)) {
+        break;
+      }
+      *last_read_row_id = BatchLastRowID(batch_id);
+      if (stop_row_id.has_value()) {
+        *last_read_row_id = std::min(*last_read_row_id, stop_row_id.value() - 1);
+      }
+      ++num_skipped;
+    }
+    return num_skipped;
+  }
+
   /**
    * FirstRowID returns the RowID of the first row in the store.
    * @return RowID of the first row in the store.
@@ -284,9 +358,25 @@ class StoreWithRowTimeAccounting {
     return times_.front().first;
   }
 
+  /**
+   * DecompressionNS returns the total time spent decompressing compressed columns on reads from
+   * this store. Always 0 for the `Hot` store.
+   * @return cumulative decompression time in nanoseconds.
+   */
+  int64_t DecompressionNS() const { return decompression_ns_; }
+
  private:
   BatchID LastBatchID() const { return first_batch_id_ + batches_.size() - 1; }
 
+  void AddBatchAccounting(RowID first_row_id, const TBatch& batch) {
+    row_ids_.emplace_back(first_row_id, first_row_id + BatchLength(batch) - 1);
+    if (time_col_idx_ != -1) {
+      auto first_time = GetTimeValue(batch, 0);
+      auto last_time = GetTimeValue(batch, BatchLength(batch) - 1);
+      times_.emplace_back(first_time, last_time);
+    }
+  }
+
   RowID BatchFirstRowID(BatchID batch_id) const {
     DCHECK_GE(batch_id, first_batch_id_);
     DCHECK_LT(batch_id, first_batch_id_ + batches_.size());
@@ -330,7 +420,7 @@ class StoreWithRowTimeAccounting {
 
   size_t BatchLength(const TBatch& batch) const {
     if constexpr (std::is_same_v<ColdBatch, TBatch>) {
-      return batch[0]->length();
+      return batch.Length();
     } else if constexpr (std::is_same_v<HotBatch, TBatch>) {
       return batch.Length();
     } else {
@@ -340,8 +430,7 @@ class StoreWithRowTimeAccounting {
 
   size_t FindTimeFirstGreaterThanOrEqual(const TBatch& batch, Time time) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(
-          batch[time_col_idx_].get(), time);
+      return batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
     } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
       return batch.FindTimeFirstGreaterThanOrEqual(time_col_idx_, time);
     } else {
@@ -351,9 +440,7 @@ class StoreWithRowTimeAccounting {
 
   size_t FindTimeFirstGreaterThan(const TBatch& batch, Time time) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(
-                 batch[time_col_idx_].get(), time) +
-             1;
+      return batch.FindTimeFirstGreaterThan(time_col_idx_, time);
     } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
       return batch.FindTimeFirstGreaterThan(time_col_idx_, time);
     } else {
@@ -363,8 +450,7 @@ class StoreWithRowTimeAccounting {
 
   Time GetTimeValue(const TBatch& batch, int64_t row_idx) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
-      return types::GetValueFromArrowArray<types::DataType::TIME64NS>(batch[time_col_idx_].get(),
-                                                                      row_idx);
+      return batch.GetTimeValue(time_col_idx_, row_idx);
     } else if constexpr (std::is_same_v<TBatch, HotBatch>) {
       return batch.GetTimeValue(time_col_idx_, row_idx);
     } else {
@@ -377,7 +463,24 @@ class StoreWithRowTimeAccounting {
                                  schema::RowBatch* output_rb) const {
     if constexpr (std::is_same_v<TBatch, ColdBatch>) {
       for (auto col_idx : cols) {
-        auto arr = batch[col_idx]->Slice(row_offset, batch_size);
+        ArrowArrayPtr arr;
+        if (batch.IsColumnCompressed(col_idx)) {
+          // Only the rows of the slice are decompressed, so reading a batch in several slices
+          // decodes each row once.
+          auto start = std::chrono::steady_clock::now();
+          PL_ASSIGN_OR_RETURN(arr, batch.ColumnSlice(col_idx, row_offset, batch_size,
+                                                     arrow::default_memory_pool()));
+          decompression_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        } else {
+          arr = batch.PlainColumn(col_idx)->Slice(row_offset, batch_size);
+        }
+        if (arr->type_id() == arrow::Type::DICTIONARY) {
+          // Dictionary encoded string columns are decoded lazily, only for the slice being read.
+          PL_ASSIGN_OR_RETURN(arr, DecodeDictionaryStringArray(arr.get(),
+                                                               arrow::default_memory_pool()));
+        }
         PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
       }
       return Status::OK();
@@ -394,6 +497,9 @@ class StoreWithRowTimeAccounting {
   std::deque<TBatch> batches_;
   std::deque<RowIDInterval> row_ids_;
   std::deque<TimeInterval> times_;
+  // Only populated for the Cold store.
+  std::deque<BatchZoneMap> zone_maps_;
+  mutable int64_t decompression_ns_ = 0;
 };
 
 }  // namespace internal
@@ -81,7 +81,6 @@ class RecordOrRowBatchParamTest : public ::testing::TestWithParam<std::vector<bo
     auto rb_w_cache = std::make_unique<RecordBatchWithCache>();
     rb_w_cache->record_batch = std::move(record_batch);
     size_t num_cols = 3;
-    rb_w_cache->cache_validity = std::vector<bool>(num_cols, false);
     rb_w_cache->arrow_cache = std::vector<ArrowArrayPtr>(num_cols, nullptr);
     return rb_w_cache;
   }
@@ -46,8 +46,9 @@ struct RecordBatchWithCache {
   RecordBatchPtr record_batch;
   // Whenever we have to convert a hot batch to an arrow array, we store the arrow array in
   // this cache. Compaction will eventually take these arrow arrays and move them into cold.
+  // Hot batches are read concurrently without locks, so entries must only be accessed with
+  // std::atomic_load/std::atomic_compare_exchange_strong. A nullptr entry hasn't been converted.
   mutable std::vector<ArrowArrayPtr> arrow_cache;
-  mutable std::vector<bool> cache_validity;
 };
 
 enum StoreType {
@@ -62,7 +63,7 @@ struct BatchHints {
 
 class RecordOrRowBatch;
 
-using ColdBatch = std::vector<ArrowArrayPtr>;
+class ColdBatch;
 
 template <StoreType type>
 struct StoreTypeTraits {};
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <farmhash.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+void ZoneMapBloomFilter::Insert(uint64_t hash) {
+  // Double hashing: derive kNumHashes bit positions from a single 64-bit hash.
+  uint64_t h1 = hash;
+  uint64_t h2 = (hash >> 32) | 1;
+  for (size_t i = 0; i < kNumHashes; ++i) {
+    size_t bit = (h1 + i * h2) % kNumBits;
+    bits_[bit / 64] |= (1ULL << (bit % 64));
+  }
+}
+
+bool ZoneMapBloomFilter::MayContain(uint64_t hash) const {
+  uint64_t h1 = hash;
+  uint64_t h2 = (hash >> 32) | 1;
+  for (size_t i = 0; i < kNumHashes; ++i) {
+    size_t bit = (h1 + i * h2) % kNumBits;
+    if ((bits_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t ZoneMapBloomFilter::Hash(std::string_view val) {
+  return ::util::Hash64(val.data(), val.size());
+}
+
+uint64_t ZoneMapBloomFilter::Hash(absl::uint128 val) {
+  uint64_t words[2] = {absl::Uint128High64(val), absl::Uint128Low64(val)};
+  return ::util::Hash64(reinterpret_cast<const char*>(words), sizeof(words));
+}
+
+template <types::DataType T>
+void ColumnZoneMap::Build(const arrow::Array* arr) {
+  using TNative = typename types::DataTypeTraits<T>::native_type;
+
+  if constexpr (T == types::DataType::STRING || T == types::DataType::UINT128) {
+    bloom_filter_ = std::make_unique<ZoneMapBloomFilter>();
+  }
+
+  if constexpr (T == types::DataType::STRING) {
+    // Strings only keep a bloom filter, storing min/max strings per batch isn't worth the memory
+    // since string predicates are almost always equality checks.
+    const arrow::Array* values = arr;
+    if (arr->type_id() == arrow::Type::DICTIONARY) {
+      // The dictionary holds exactly the distinct values in the column, so only it needs hashing.
+      values = static_cast<const arrow::DictionaryArray*>(arr)->dictionary().get();
+    }
+    for (int64_t i = 0; i < values->length(); ++i) {
+      if (values->IsNull(i)) {
+        continue;
+      }
+      bloom_filter_->Insert(
+          ZoneMapBloomFilter::Hash(types::GetStringViewFromArrowArray(values, i)));
+    }
+  } else {
+    bool found_value = false;
+    bool found_nan = false;
+    TNative min_val{};
+    TNative max_val{};
+    for (int64_t i = 0; i < arr->length(); ++i) {
+      if (arr->IsNull(i)) {
+        continue;
+      }
+      TNative val = types::GetValueFromArrowArray<T>(arr, i);
+      if constexpr (T == types::DataType::UINT128) {
+        bloom_filter_->Insert(ZoneMapBloomFilter::Hash(val));
+      }
+      if constexpr (T == types::DataType::FLOAT64) {
+        if (std::isnan(val)) {
+          found_nan = true;
+          continue;
+        }
+      }
+      if (!found_value) {
+        min_val = val;
+        max_val = val;
+        found_value = true;
+        continue;
+      }
+      if (val < min_val) {
+        min_val = val;
+      }
+      if (max_val < val) {
+        max_val = val;
+      }
+    }
+    // NaNs don't compare, so we can't safely prune columns containing them.
+    has_min_max_ = found_value && !found_nan;
+    if (has_min_max_) {
+      min_ = min_val;
+      max_ = max_val;
+    }
+  }
+}
+
+template <types::DataType T>
+bool ColumnZoneMap::MayMatchTyped(const ColumnPredicate& pred) const {
+  using TNative = typename types::DataTypeTraits<T>::native_type;
+
+  if (!std::holds_alternative<TNative>(pred.literal)) {
+    // The literal doesn't match the column type, so we can't reason about the predicate.
+    return true;
+  }
+  const auto& literal = std::get<TNative>(pred.literal);
+
+  if constexpr (T == types::DataType::STRING) {
+    if (pred.op == ColumnPredicate::Op::kEqual) {
+      return bloom_filter_->MayContain(ZoneMapBloomFilter::Hash(std::string_view(literal)));
+    }
+    return true;
+  } else {
+    if (!has_min_max_) {
+      return true;
+    }
+    const auto& min_val = std::get<TNative>(min_);
+    const auto& max_val = std::get<TNative>(max_);
+    switch (pred.op) {
+      case ColumnPredicate::Op::kEqual:
+        if (literal < min_val || max_val < literal) {
+          return false;
+        }
+        if constexpr (T == types::DataType::UINT128) {
+          return bloom_filter_->MayContain(ZoneMapBloomFilter::Hash(literal));
+        }
+        return true;
+      case ColumnPredicate::Op::kNotEqual:
+        return !(min_val == literal && max_val == literal);
+      case ColumnPredicate::Op::kLessThan:
+        return min_val < literal;
+      case ColumnPredicate::Op::kLessThanEqual:
+        return !(literal < min_val);
+      case ColumnPredicate::Op::kGreaterThan:
+        return literal < max_val;
+      case ColumnPredicate::Op::kGreaterThanEqual:
+        return !(max_val < literal);
+    }
+    return true;
+  }
+}
+
+ColumnZoneMap ColumnZoneMap::Create(types::DataType data_type, const arrow::Array* arr) {
+  ColumnZoneMap zone_map;
+  zone_map.data_type_ = data_type;
+  zone_map.num_rows_ = arr->length();
+  zone_map.null_count_ = arr->null_count();
+#define TYPE_CASE(_dt_) zone_map.Build<_dt_>(arr);
+  PL_SWITCH_FOREACH_DATATYPE(data_type, TYPE_CASE);
+#undef TYPE_CASE
+  return zone_map;
+}
+
+bool ColumnZoneMap::MayMatch(const ColumnPredicate& pred) const {
+#define TYPE_CASE(_dt_) return MayMatchTyped<_dt_>(pred);
+  PL_SWITCH_FOREACH_DATATYPE(data_type_, TYPE_CASE);
+#undef TYPE_CASE
+  return true;
+}
+
+BatchZoneMap BatchZoneMap::Create(const schema::Relation& rel, const ColdBatch& batch) {
+  BatchZoneMap zone_map;
+  zone_map.columns_.reserve(batch.NumColumns());
+  for (size_t col_idx = 0; col_idx < batch.NumColumns(); ++col_idx) {
+    // Zone maps are built when the batch is added to the cold store, before it is compressed.
+    zone_map.columns_.push_back(
+        ColumnZoneMap::Create(rel.col_types()[col_idx], batch.PlainColumn(col_idx).get()));
+  }
+  return zone_map;
+}
+
+bool BatchZoneMap::MayMatch(const std::vector<ColumnPredicate>& predicates) const {
+  for (const auto& pred : predicates) {
+    DCHECK_GE(pred.col_idx, 0);
+    DCHECK_LT(pred.col_idx, static_cast<int64_t>(columns_.size()));
+    if (pred.col_idx < 0 || pred.col_idx >= static_cast<int64_t>(columns_.size())) {
+      continue;
+    }
+    if (!columns_[pred.col_idx].MayMatch(pred)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
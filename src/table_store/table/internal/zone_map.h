@@ -0,0 +1,146 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <absl/numeric/int128.h>
+#include "src/shared/types/types.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/types.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+/**
+ * PredicateLiteral holds the literal side of a ColumnPredicate. The alternative used must match
+ * the native type of the column being compared (eg. int64_t for INT64 and TIME64NS columns,
+ * absl::uint128 for UINT128 columns, and std::string for STRING columns).
+ */
+using PredicateLiteral = std::variant<bool, int64_t, absl::uint128, double, std::string>;
+
+/**
+ * ColumnPredicate is a comparison of a single column against a literal, eg. `resp_status >= 500`.
+ * A list of ColumnPredicates is interpreted as a conjunction.
+ */
+struct ColumnPredicate {
+  enum class Op {
+    kEqual,
+    kNotEqual,
+    kLessThan,
+    kLessThanEqual,
+    kGreaterThan,
+    kGreaterThanEqual,
+  };
+  int64_t col_idx = -1;
+  Op op = Op::kEqual;
+  PredicateLiteral literal;
+};
+
+/**
+ * ZoneMapBloomFilter is a small fixed size bloom filter used to rule out equality predicates on
+ * high cardinality columns (eg. upid or req_path), where min/max pruning is ineffective.
+ */
+class ZoneMapBloomFilter {
+ public:
+  static constexpr size_t kNumBits = 2048;
+  static constexpr size_t kNumHashes = 3;
+
+  void Insert(uint64_t hash);
+  bool MayContain(uint64_t hash) const;
+
+  static uint64_t Hash(std::string_view val);
+  static uint64_t Hash(absl::uint128 val);
+
+ private:
+  std::array<uint64_t, kNumBits / 64> bits_{};
+};
+
+/**
+ * ColumnZoneMap stores summary statistics for a single column of a cold batch: the min and max
+ * values (for fixed size columns), the number of nulls, and for STRING and UINT128 columns a bloom
+ * filter of the values in the column. The zone map is used to determine whether a batch could
+ * possibly contain a row matching a given predicate, without reading the batch itself.
+ */
+class ColumnZoneMap {
+ public:
+  /**
+   * Create computes the zone map for the given arrow array.
+   * @param data_type, the DataType of the column.
+   * @param arr, the arrow array to compute statistics for.
+   * @return the zone map for the column.
+   */
+  static ColumnZoneMap Create(types::DataType data_type, const arrow::Array* arr);
+
+  /**
+   * MayMatch returns false only if no row in the column can satisfy the given predicate. A return
+   * value of true does not guarantee that any row matches.
+   * @param pred, the predicate to check. pred.col_idx is ignored.
+   * @return whether any row in the column could match the predicate.
+   */
+  bool MayMatch(const ColumnPredicate& pred) const;
+
+  int64_t null_count() const { return null_count_; }
+  int64_t num_rows() const { return num_rows_; }
+
+ private:
+  template <types::DataType T>
+  void Build(const arrow::Array* arr);
+  template <types::DataType T>
+  bool MayMatchTyped(const ColumnPredicate& pred) const;
+
+  types::DataType data_type_ = types::DataType::DATA_TYPE_UNKNOWN;
+  int64_t num_rows_ = 0;
+  int64_t null_count_ = 0;
+  bool has_min_max_ = false;
+  PredicateLiteral min_;
+  PredicateLiteral max_;
+  std::unique_ptr<ZoneMapBloomFilter> bloom_filter_;
+};
+
+/**
+ * BatchZoneMap holds a ColumnZoneMap for each column of a cold batch.
+ */
+class BatchZoneMap {
+ public:
+  static BatchZoneMap Create(const schema::Relation& rel, const ColdBatch& batch);
+
+  /**
+   * MayMatch returns false if the batch cannot contain any row satisfying all of the given
+   * predicates.
+   */
+  bool MayMatch(const std::vector<ColumnPredicate>& predicates) const;
+
+  const ColumnZoneMap& column(size_t col_idx) const { return columns_[col_idx]; }
+
+ private:
+  std::vector<ColumnZoneMap> columns_;
+};
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/internal/cold_batch.h"
+#include "src/table_store/table/internal/zone_map.h"
+
+namespace px {
+namespace table_store {
+namespace internal {
+
+using Op = ColumnPredicate::Op;
+
+class ZoneMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rel_ = std::make_unique<schema::Relation>(
+        std::vector<types::DataType>{types::DataType::TIME64NS, types::DataType::INT64,
+                                     types::DataType::UINT128, types::DataType::STRING},
+        std::vector<std::string>{"time_", "resp_status", "upid", "req_path"});
+
+    std::vector<types::Time64NSValue> times = {10, 11, 12, 13};
+    std::vector<types::Int64Value> statuses = {200, 404, 200, 301};
+    std::vector<types::UInt128Value> upids = {types::UInt128Value(1, 2), types::UInt128Value(1, 2),
+                                              types::UInt128Value(3, 4), types::UInt128Value(3, 4)};
+    std::vector<types::StringValue> paths = {"/healthz", "/api/v1", "/healthz", "/login"};
+    ColdBatch batch(std::vector<ArrowArrayPtr>{
+        types::ToArrow(times, arrow::default_memory_pool()),
+        types::ToArrow(statuses, arrow::default_memory_pool()),
+        types::ToArrow(upids, arrow::default_memory_pool()),
+        types::ToArrow(paths, arrow::default_memory_pool()),
+    });
+    zone_map_ = std::make_unique<BatchZoneMap>(BatchZoneMap::Create(*rel_, batch));
+  }
+
+  bool MayMatch(std::vector<ColumnPredicate> preds) { return zone_map_->MayMatch(preds); }
+
+  std::unique_ptr<schema::Relation> rel_;
+  std::unique_ptr<BatchZoneMap> zone_map_;
+};
+
+TEST_F(ZoneMapTest, Stats) {
+  EXPECT_EQ(4, zone_map_->column(1).num_rows());
+  EXPECT_EQ(0, zone_map_->column(1).null_count());
+}
+
+TEST_F(ZoneMapTest, MinMaxPruning) {
+  EXPECT_TRUE(MayMatch({{1, Op::kEqual, int64_t{404}}}));
+  EXPECT_FALSE(MayMatch({{1, Op::kEqual, int64_t{500}}}));
+  EXPECT_FALSE(MayMatch({{1, Op::kGreaterThanEqual, int64_t{500}}}));
+  EXPECT_TRUE(MayMatch({{1, Op::kGreaterThanEqual, int64_t{404}}}));
+  EXPECT_FALSE(MayMatch({{1, Op::kGreaterThan, int64_t{404}}}));
+  EXPECT_FALSE(MayMatch({{1, Op::kLessThan, int64_t{200}}}));
+  EXPECT_TRUE(MayMatch({{1, Op::kLessThanEqual, int64_t{200}}}));
+  EXPECT_TRUE(MayMatch({{1, Op::kNotEqual, int64_t{200}}}));
+  EXPECT_FALSE(MayMatch({{0, Op::kGreaterThan, int64_t{13}}}));
+  EXPECT_TRUE(MayMatch({{0, Op::kGreaterThan, int64_t{12}}}));
+}
+
+TEST_F(ZoneMapTest, BloomFilterPruning) {
+  EXPECT_TRUE(MayMatch({{3, Op::kEqual, std::string("/healthz")}}));
+  EXPECT_TRUE(MayMatch({{3, Op::kEqual, std::string("/login")}}));
+  EXPECT_FALSE(MayMatch({{3, Op::kEqual, std::string("/not_a_path")}}));
+  // Only equality can be answered by the bloom filter.
+  EXPECT_TRUE(MayMatch({{3, Op::kNotEqual, std::string("/not_a_path")}}));
+
+  EXPECT_TRUE(MayMatch({{2, Op::kEqual, absl::MakeUint128(3, 4)}}));
+  EXPECT_FALSE(MayMatch({{2, Op::kEqual, absl::MakeUint128(2, 0)}}));
+}
+
+TEST_F(ZoneMapTest, Conjunction) {
+  EXPECT_TRUE(
+      MayMatch({{1, Op::kEqual, int64_t{200}}, {3, Op::kEqual, std::string("/healthz")}}));
+  EXPECT_FALSE(
+      MayMatch({{1, Op::kEqual, int64_t{200}}, {3, Op::kEqual, std::string("/not_a_path")}}));
+}
+
+TEST_F(ZoneMapTest, MismatchedLiteralTypeIsConservative) {
+  EXPECT_TRUE(MayMatch({{1, Op::kEqual, std::string("500")}}));
+}
+
+}  // namespace internal
+}  // namespace table_store
+}  // namespace px
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
@@ -35,6 +36,7 @@
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/table/internal/batch_size_accountant.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
+#include "src/table_store/table/internal/spill_store.h"
 #include "src/table_store/table/internal/types.h"
 #include "src/table_store/table/table.h"
 
@@ -45,11 +47,22 @@ DEFINE_int32(table_store_table_size_limit,
              "The maximal size a table allows. When the size grows beyond this limit, "
              "old data will be discarded.");
 
+DEFINE_double(table_store_dictionary_encoding_max_distinct_ratio,
+              gflags::DoubleFromEnv("PL_TABLE_STORE_DICTIONARY_ENCODING_MAX_DISTINCT_RATIO", 0.1),
+              "String columns in compacted (cold) batches with a ratio of distinct values to rows "
+              "at or below this value are dictionary encoded. Set to 0 to disable.");
+
+DEFINE_bool(table_store_compress_cold_batches,
+            gflags::BoolFromEnv("PL_TABLE_STORE_COMPRESS_COLD_BATCHES", false),
+            "Compress compacted (cold) batches. Integer and time columns are delta encoded, and "
+            "dictionary encoded string columns have their indices bit packed.");
+
 namespace px {
 namespace table_store {
 
-Table::Cursor::Cursor(const Table* table, StartSpec start, StopSpec stop)
-    : table_(table), hints_(internal::BatchHints{}) {
+Table::Cursor::Cursor(const Table* table, StartSpec start, StopSpec stop,
+                      std::vector<ColumnPredicate> predicates)
+    : table_(table), hints_(internal::BatchHints{}), predicates_(std::move(predicates)) {
   AdvanceToStart(start);
   StopStateFromSpec(std::move(stop));
 }
@@ -124,19 +137,25 @@ std::optional<internal::RowID> Table::Cursor::StopRowID() const {
   return stop_.stop_row_id;
 }
 
+const std::vector<Table::ColumnPredicate>& Table::Cursor::Predicates() const {
+  return predicates_;
+}
+
 StatusOr<std::unique_ptr<schema::RowBatch>> Table::Cursor::GetNextRowBatch(
     const std::vector<int64_t>& cols) {
   return table_->GetNextRowBatch(this, cols);
 }
 
 Table::Table(std::string_view table_name, const schema::Relation& relation, size_t max_table_size,
-             size_t compacted_batch_size)
+             size_t compacted_batch_size, bool compress_cold_batches)
     : metrics_(&(GetMetricsRegistry()), std::string(table_name)),
       rel_(relation),
       max_table_size_(max_table_size),
       compacted_batch_size_(compacted_batch_size),
+      compress_cold_batches_(compress_cold_batches),
       // TODO(james): move mem_pool into constructor.
-      compactor_(rel_, arrow::default_memory_pool()) {
+      compactor_(rel_, arrow::default_memory_pool(),
+                 FLAGS_table_store_dictionary_encoding_max_distinct_ratio) {
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   for (const auto& [i, col_name] : Enumerate(rel_.col_names())) {
@@ -145,12 +164,47 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
     }
   }
   batch_size_accountant_ = internal::BatchSizeAccountant::Create(rel_, compacted_batch_size_);
-  hot_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>>(
-      rel_, time_col_idx_);
+  hot_store_ = std::make_unique<internal::HotStore>(rel_, time_col_idx_);
   cold_store_ = std::make_unique<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>>(
       rel_, time_col_idx_);
 }
 
+Status Table::EnableSpill(const std::filesystem::path& path, int64_t capacity_bytes) {
+  absl::MutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr) {
+    return error::AlreadyExists("Spill is already enabled for this table");
+  }
+  PL_ASSIGN_OR_RETURN(spill_store_,
+                      internal::SpillStore::Create(path, capacity_bytes, rel_, time_col_idx_));
+  return Status::OK();
+}
+
+Status Table::EnableSecondaryIndex(std::string_view col_name) {
+  absl::MutexLock compaction_lock(&compaction_lock_);
+  absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+  std::string col(col_name);
+  if (!rel_.HasColumn(col)) {
+    return error::InvalidArgument("Table has no column named '$0'", col);
+  }
+  auto col_idx = rel_.GetColumnIndex(col);
+  auto data_type = rel_.GetColumnType(col_idx);
+  if (!internal::SecondaryIndex::SupportsType(data_type)) {
+    return error::InvalidArgument("Columns of type $0 can't have a secondary index",
+                                  types::ToString(data_type));
+  }
+  if (cold_store_->Size() > 0) {
+    return error::FailedPrecondition(
+        "Secondary indexes must be enabled before any data is compacted");
+  }
+  for (const auto& index : secondary_indexes_) {
+    if (index->col_idx() == col_idx) {
+      return error::AlreadyExists("Column '$0' already has a secondary index", col);
+    }
+  }
+  secondary_indexes_.push_back(std::make_unique<internal::SecondaryIndex>(col_idx, data_type));
+  return Status::OK();
+}
+
 Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
   CHECK(table_proto != nullptr);
   std::vector<int64_t> col_selector;
@@ -174,18 +228,81 @@ Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
 StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetNextRowBatch(
     Cursor* cursor, const std::vector<int64_t>& cols) const {
   DCHECK(!cursor->Done()) << "Calling GetNextRowBatch on an exhausted Cursor";
+  auto zero_row_batch = [this, &cols]() {
+    std::vector<types::DataType> col_types;
+    for (int64_t col_idx : cols) {
+      col_types.push_back(rel_.col_types()[col_idx]);
+    }
+    return schema::RowBatch::WithZeroRows(schema::RowDescriptor(col_types), /* eow */ false,
+                                          /* eos */ false);
+  };
+
+  absl::ReaderMutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr && spill_store_->Size() > 0) {
+    if (*cursor->LastReadRowID() + 1 < spill_store_->FirstRowID()) {
+      // The cursor points to data that was evicted from the spill store, so skip ahead to the
+      // oldest data still available.
+      *cursor->LastReadRowID() = spill_store_->FirstRowID() - 1;
+      if (cursor->Done()) {
+        return zero_row_batch();
+      }
+    }
+    PL_ASSIGN_OR_RETURN(auto rb, spill_store_->GetNextRowBatch(cursor->LastReadRowID(),
+                                                               cursor->StopRowID(), cols));
+    if (rb != nullptr) {
+      metrics_.spill_read_batches_counter.Increment();
+      return rb;
+    }
+  }
+
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+  if (cold_store_->Size() > 0 && *cursor->LastReadRowID() + 1 < cold_store_->FirstRowID()) {
+    // The cursor points to rows that are no longer in the table, because they were expired without
+    // spilling or couldn't be spilled. Skip ahead to the oldest cold data rather than to the hot
+    // store, which would skip over the cold store as well.
+    *cursor->LastReadRowID() = cold_store_->FirstRowID() - 1;
+    if (cursor->Done()) {
+      return zero_row_batch();
+    }
+  }
+  int64_t num_skipped = 0;
+  if (!cursor->Predicates().empty()) {
+    num_skipped = cold_store_->SkipBatchesNotMatching(cursor->LastReadRowID(), cursor->StopRowID(),
+                                                      cursor->Predicates());
+    if (num_skipped > 0) {
+      metrics_.zone_map_skipped_batches_counter.Increment(num_skipped);
+    }
+    if (cursor->Done()) {
+      return zero_row_batch();
+    }
+  }
+  // The cold read is stopped at the end of the range of rows found by the secondary index, if any.
+  std::optional<internal::RowID> cold_stop_row_id = cursor->StopRowID();
+  int64_t index_skipped_rows = SeekWithSecondaryIndex(cursor, &cold_stop_row_id);
+  if (index_skipped_rows > 0) {
+    metrics_.secondary_index_skipped_rows_counter.Increment(index_skipped_rows);
+    if (cursor->Done()) {
+      return zero_row_batch();
+    }
+  }
+  auto decompression_ns = cold_store_->DecompressionNS();
   PL_ASSIGN_OR_RETURN(auto rb,
                       cold_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
-                                                   cursor->StopRowID(), cols));
+                                                   cold_stop_row_id, cols));
+  decompression_ns = cold_store_->DecompressionNS() - decompression_ns;
+  if (decompression_ns > 0) {
+    metrics_.cold_decompression_ns_counter.Increment(decompression_ns);
+  }
   if (rb == nullptr) {
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    // The hot store is read without the hot lock. Holding the cold lock is still required, so that
+    // compaction can't move the next rows from hot to cold while they're being looked up.
     PL_ASSIGN_OR_RETURN(rb, hot_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
                                                         cursor->StopRowID(), cols));
-    if (rb == nullptr && hot_store_->Size() > 0) {
+    auto hot_first_row_id = rb == nullptr ? hot_store_->FirstRowID() : std::nullopt;
+    if (hot_first_row_id.has_value()) {
       // If the cursor was pointing to an expired row batch, update the cursor to point to the start
       // of the table, then try to get the next row batch.
-      *cursor->LastReadRowID() = hot_store_->FirstRowID() - 1;
+      *cursor->LastReadRowID() = hot_first_row_id.value() - 1;
       if (!cursor->Done()) {
         PL_ASSIGN_OR_RETURN(rb,
                             hot_store_->GetNextRowBatch(cursor->LastReadRowID(), cursor->Hints(),
@@ -194,11 +311,54 @@ StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetNextRowBatch(
     }
   }
   if (rb == nullptr) {
+    if (num_skipped > 0 || index_skipped_rows > 0) {
+      // All of the data currently after the cursor was skipped by the cursor's predicates.
+      return zero_row_batch();
+    }
     return error::InvalidArgument("Data after Cursor is not in the table.");
   }
   return rb;
 }
 
+int64_t Table::SeekWithSecondaryIndex(Cursor* cursor,
+                                      std::optional<internal::RowID>* cold_stop_row_id) const {
+  if (secondary_indexes_.empty() || cold_store_->Size() == 0) {
+    return 0;
+  }
+  auto start_row_id = *cursor->LastReadRowID() + 1;
+  if (start_row_id < cold_store_->FirstRowID() || start_row_id > cold_store_->LastRowID()) {
+    return 0;
+  }
+  for (const auto& pred : cursor->Predicates()) {
+    if (pred.op != ColumnPredicate::Op::kEqual) {
+      continue;
+    }
+    for (const auto& index : secondary_indexes_) {
+      if (index->col_idx() != pred.col_idx || !index->SupportsLiteral(pred.literal)) {
+        continue;
+      }
+      // Rows after the cold store aren't indexed yet, so if there is no matching range in the cold
+      // store skip to the end of it and let the hot store be read as usual.
+      auto cold_end_row_id = cold_store_->LastRowID() + 1;
+      auto range = index->NextMatchingRange(pred.literal, start_row_id);
+      auto seek_row_id = cold_end_row_id;
+      if (range.has_value() && range->first < cold_end_row_id) {
+        seek_row_id = range->first;
+        auto range_stop_row_id = range->second + 1;
+        if (!cold_stop_row_id->has_value() || range_stop_row_id < cold_stop_row_id->value()) {
+          *cold_stop_row_id = range_stop_row_id;
+        }
+      }
+      if (cursor->StopRowID().has_value()) {
+        seek_row_id = std::min(seek_row_id, cursor->StopRowID().value());
+      }
+      *cursor->LastReadRowID() = seek_row_id - 1;
+      return seek_row_id - start_row_id;
+    }
+  }
+  return 0;
+}
+
 Status Table::ExpireRowBatches(int64_t row_batch_size) {
   if (row_batch_size > max_table_size_) {
     return error::InvalidArgument("RowBatch size ($0) is bigger than maximum table size ($1).",
@@ -207,13 +367,13 @@ Status Table::ExpireRowBatches(int64_t row_batch_size) {
   int64_t bytes;
   {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
+    bytes = StoredBytes();
   }
   while (bytes + row_batch_size > max_table_size_) {
     PL_RETURN_IF_ERROR(ExpireBatch());
     {
       absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-      bytes = batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes();
+      bytes = StoredBytes();
     }
     {
       absl::base_internal::SpinLockHolder lock(&stats_lock_);
@@ -224,6 +384,18 @@ Status Table::ExpireRowBatches(int64_t row_batch_size) {
   return Status::OK();
 }
 
+int64_t Table::StoredBytes() const {
+  return batch_size_accountant_->HotBytes() + batch_size_accountant_->ColdBytes() +
+         secondary_index_bytes_;
+}
+
+void Table::UpdateSecondaryIndexBytes() {
+  secondary_index_bytes_ = 0;
+  for (const auto& index : secondary_indexes_) {
+    secondary_index_bytes_ += index->Bytes();
+  }
+}
+
 Status Table::WriteRowBatch(const schema::RowBatch& rb) {
   // Don't write empty row batches.
   if (rb.num_columns() == 0 || rb.ColumnAt(0)->length() == 0) {
@@ -246,7 +418,6 @@ Status Table::TransferRecordBatch(
   auto record_batch_w_cache = internal::RecordBatchWithCache{
       std::move(record_batch),
       std::vector<ArrowArrayPtr>(rel_.NumColumns()),
-      std::vector<bool>(rel_.NumColumns(), false),
   };
   internal::RecordOrRowBatch record_or_row_batch(std::move(record_batch_w_cache));
 
@@ -265,9 +436,10 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
   {
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     auto batch_length = record_or_row_batch.Length();
+    auto first_row_id = next_row_id_.load();
     batch_size_accountant_->NewHotBatch(std::move(batch_stats));
-    hot_store_->EmplaceBack(next_row_id_, std::move(record_or_row_batch));
-    next_row_id_ += batch_length;
+    hot_store_->EmplaceBack(first_row_id, std::move(record_or_row_batch));
+    next_row_id_.store(first_row_id + batch_length);
   }
 
   {
@@ -284,36 +456,52 @@ Status Table::WriteHot(internal::RecordOrRowBatch&& record_or_row_batch) {
 }
 
 Table::RowID Table::FirstRowID() const {
+  absl::ReaderMutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr && spill_store_->Size() > 0) {
+    return spill_store_->FirstRowID();
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   if (cold_store_->Size() > 0) {
     return cold_store_->FirstRowID();
   }
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-  if (hot_store_->Size() > 0) {
-    return hot_store_->FirstRowID();
-  }
-  return -1;
+  return hot_store_->FirstRowID().value_or(-1);
 }
 
 Table::RowID Table::LastRowID() const {
+  // The hot store holds the newest rows, and can be read without locks. This keeps streaming
+  // cursors polling for new data (see Cursor::NextBatchReady) off of the table locks.
+  auto hot_last_row_id = hot_store_->LastRowID();
+  if (hot_last_row_id.has_value()) {
+    return hot_last_row_id.value();
+  }
+  absl::ReaderMutexLock spill_lock(&spill_lock_);
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-  if (hot_store_->Size() > 0) {
-    return hot_store_->LastRowID();
+  hot_last_row_id = hot_store_->LastRowID();
+  if (hot_last_row_id.has_value()) {
+    return hot_last_row_id.value();
   }
   if (cold_store_->Size() > 0) {
     return cold_store_->LastRowID();
   }
+  if (spill_store_ != nullptr && spill_store_->Size() > 0) {
+    return spill_store_->LastRowID();
+  }
   return -1;
 }
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
+  absl::ReaderMutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr) {
+    auto optional_row_id = spill_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   optional_row_id = hot_store_->FindRowIDFromTimeFirstGreaterThanOrEqual(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
@@ -322,12 +510,18 @@ Table::RowID Table::FindRowIDFromTimeFirstGreaterThanOrEqual(Time time) const {
 }
 
 Table::RowID Table::FindRowIDFromTimeFirstGreaterThan(Time time) const {
+  absl::ReaderMutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr) {
+    auto optional_row_id = spill_store_->FindRowIDFromTimeFirstGreaterThan(time);
+    if (optional_row_id.has_value()) {
+      return optional_row_id.value();
+    }
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   auto optional_row_id = cold_store_->FindRowIDFromTimeFirstGreaterThan(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
   }
-  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   optional_row_id = hot_store_->FindRowIDFromTimeFirstGreaterThan(time);
   if (optional_row_id.has_value()) {
     return optional_row_id.value();
@@ -343,17 +537,57 @@ TableStats Table::GetTableStats() const {
   int64_t num_batches = 0;
   int64_t hot_bytes = 0;
   int64_t cold_bytes = 0;
+  int64_t secondary_index_bytes = 0;
+  int64_t cold_bytes_saved = 0;
+  int64_t decompression_time_ns = 0;
+  int64_t spill_bytes = 0;
+  int64_t spill_batches = 0;
+  // RowIDs are assigned consecutively, and the stores hold consecutive ranges of them, so the
+  // number of rows follows from the first and last RowIDs over all of the stores.
+  std::optional<internal::RowID> first_row_id;
+  std::optional<internal::RowID> last_row_id;
+  absl::flat_hash_map<std::string, int64_t> column_ndv;
   {
+    absl::ReaderMutexLock spill_lock(&spill_lock_);
+    if (spill_store_ != nullptr) {
+      min_time = spill_store_->MinTime();
+      spill_bytes = spill_store_->Bytes();
+      spill_batches = spill_store_->Size();
+      if (spill_store_->Size() > 0) {
+        first_row_id = spill_store_->FirstRowID();
+        last_row_id = spill_store_->LastRowID();
+      }
+    }
     absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-    min_time = cold_store_->MinTime();
+    if (min_time == -1) {
+      min_time = cold_store_->MinTime();
+    }
     num_batches += cold_store_->Size();
+    cold_bytes_saved = cold_bytes_saved_;
+    decompression_time_ns = cold_store_->DecompressionNS();
+    if (cold_store_->Size() > 0) {
+      if (!first_row_id.has_value()) {
+        first_row_id = cold_store_->FirstRowID();
+      }
+      last_row_id = cold_store_->LastRowID();
+    }
+    for (const auto& index : secondary_indexes_) {
+      column_ndv[rel_.GetColumnName(index->col_idx())] = static_cast<int64_t>(index->NumKeys());
+    }
     absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
     num_batches += hot_store_->Size();
     hot_bytes = batch_size_accountant_->HotBytes();
     cold_bytes = batch_size_accountant_->ColdBytes();
+    secondary_index_bytes = secondary_index_bytes_;
     if (min_time == -1) {
       min_time = hot_store_->MinTime();
     }
+    if (hot_store_->Size() > 0) {
+      if (!first_row_id.has_value()) {
+        first_row_id = hot_store_->FirstRowID();
+      }
+      last_row_id = hot_store_->LastRowID();
+    }
   }
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
 
@@ -361,41 +595,98 @@ TableStats Table::GetTableStats() const {
   info.batches_expired = batches_expired_;
   info.bytes_added = bytes_added_;
   info.num_batches = num_batches;
-  info.bytes = hot_bytes + cold_bytes;
+  info.bytes = hot_bytes + cold_bytes + secondary_index_bytes;
   info.hot_bytes = hot_bytes;
   info.cold_bytes = cold_bytes;
   info.compacted_batches = compacted_batches_;
   info.max_table_size = max_table_size_;
   info.min_time = min_time;
+  info.compression_ratio =
+      cold_bytes > 0 ? static_cast<double>(cold_bytes + cold_bytes_saved) / cold_bytes
+                     : 1.0;
+  info.decompression_time_ns = decompression_time_ns;
+  info.spill_bytes = spill_bytes;
+  info.spill_batches = spill_batches;
+  info.secondary_index_bytes = secondary_index_bytes;
+  info.num_rows = first_row_id.has_value() ? *last_row_id - *first_row_id + 1 : 0;
+  info.column_ndv = std::move(column_ndv);
 
   return info;
 }
 
-Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
-  const auto& compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
-
-  PL_RETURN_IF_ERROR(
-      compactor_.Reserve(compaction_spec.num_rows, compaction_spec.variable_col_bytes));
-
+StatusOr<bool> Table::CompactSingleBatch(arrow::MemoryPool*) {
+  auto start = std::chrono::steady_clock::now();
   RowID first_row_id = -1;
-  for (auto hot_slice : compaction_spec.hot_slices) {
-    if (first_row_id == -1) {
-      first_row_id = hot_store_->FirstRowID() + hot_slice.start_row;
+  RowID hot_first_row_id = -1;
+  {
+    // Copy the rows of the next compacted batch out of the hot store. The hot batches stay in the
+    // hot store until the cold batch is ready, so that readers never miss rows in between.
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (!batch_size_accountant_->CompactedBatchReady()) {
+      return false;
     }
-
-    compactor_.UnsafeAppendBatchSlice(hot_store_->front(), hot_slice.start_row, hot_slice.end_row);
-    if (hot_slice.last_slice_for_batch) {
-      hot_store_->PopFront();
+    const auto& compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
+    PL_RETURN_IF_ERROR(
+        compactor_.Reserve(compaction_spec.num_rows, compaction_spec.variable_col_bytes));
+
+    hot_first_row_id = hot_store_->FirstRowID().value();
+    first_row_id = hot_first_row_id + compaction_spec.hot_slices.front().start_row;
+    // Each slice of the spec comes from the next batch in the hot store. Slice rows are relative
+    // to the rows of the batch still in the hot store.
+    for (const auto& [batch_offset, hot_slice] : Enumerate(compaction_spec.hot_slices)) {
+      size_t removed_rows = 0;
+      const auto& hot_batch = hot_store_->at(batch_offset, &removed_rows);
+      compactor_.UnsafeAppendBatchSlice(hot_batch, removed_rows + hot_slice.start_row,
+                                        removed_rows + hot_slice.end_row);
     }
   }
 
+  // Build the cold batch without holding the hot or cold locks.
   PL_ASSIGN_OR_RETURN(std::vector<ArrowArrayPtr> out_columns, compactor_.Finish());
+  internal::ColdBatch cold_batch(std::move(out_columns));
+  auto zone_map = internal::BatchZoneMap::Create(rel_, cold_batch);
+  // Indexes are only added while holding compaction_lock_, so the list can be read here without
+  // the cold lock. The indexed columns are hashed before the batch is compressed.
+  const auto& secondary_indexes = ABSL_TS_UNCHECKED_READ(secondary_indexes_);
+  std::vector<internal::SecondaryIndex::BatchRuns> index_runs;
+  for (const auto& index : secondary_indexes) {
+    index_runs.push_back(
+        index->ComputeRuns(first_row_id, cold_batch.PlainColumn(index->col_idx()).get()));
+  }
+  int64_t compression_bytes_saved = 0;
+  if (compress_cold_batches_) {
+    compression_bytes_saved = cold_batch.Compress(rel_);
+  }
 
-  cold_store_->EmplaceBack(first_row_id, out_columns);
+  {
+    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+    if (!batch_size_accountant_->CompactedBatchReady() ||
+        hot_store_->FirstRowID() != hot_first_row_id) {
+      // Hot batches were expired while the cold batch was being built, so the batch is stale.
+      // Drop it, the caller will retry with the updated spec.
+      return true;
+    }
+    const auto& compaction_spec = batch_size_accountant_->GetNextCompactedBatchSpec();
+    for (const auto& hot_slice : compaction_spec.hot_slices) {
+      if (hot_slice.last_slice_for_batch) {
+        hot_store_->PopFront();
+      }
+    }
 
-  auto num_rows_to_remove = batch_size_accountant_->FinishCompactedBatch();
-  if (num_rows_to_remove > 0) {
-    hot_store_->RemovePrefix(num_rows_to_remove);
+    cold_store_->PushBackWithZoneMap(first_row_id, std::move(cold_batch), std::move(zone_map));
+    for (size_t i = 0; i < secondary_indexes_.size(); ++i) {
+      secondary_indexes_[i]->AddBatch(std::move(index_runs[i]));
+    }
+    UpdateSecondaryIndexBytes();
+    int64_t bytes_saved = compactor_.EncodedBytesSaved() + compression_bytes_saved;
+    cold_batch_bytes_saved_.push_back(bytes_saved);
+    cold_bytes_saved_ += bytes_saved;
+
+    auto num_rows_to_remove = batch_size_accountant_->FinishCompactedBatch(bytes_saved);
+    if (num_rows_to_remove > 0) {
+      hot_store_->RemovePrefix(num_rows_to_remove);
+    }
   }
 
   {
@@ -403,37 +694,65 @@ Status Table::CompactSingleBatchUnlocked(arrow::MemoryPool*) {
     compacted_batches_++;
     metrics_.compacted_batches_counter.Increment();
   }
-  return Status::OK();
+  metrics_.compaction_latency_ms_histogram.Observe(
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  return true;
 }
 
 Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
-  bool next_ready = false;
-  {
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    next_ready = batch_size_accountant_->CompactedBatchReady();
-  }
-  while (next_ready) {
-    absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
-    absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
-    // We have to check CompactedBatchReady() again, in case hot batches were expired since the last
-    // check.
-    if (!batch_size_accountant_->CompactedBatchReady()) {
+  absl::MutexLock compaction_lock(&compaction_lock_);
+  while (true) {
+    PL_ASSIGN_OR_RETURN(bool compacted, CompactSingleBatch(mem_pool));
+    if (!compacted) {
       break;
     }
-    PL_RETURN_IF_ERROR(CompactSingleBatchUnlocked(mem_pool));
-    next_ready = batch_size_accountant_->CompactedBatchReady();
   }
-  return Status::OK();
+  // The secondary indexes grow with each compacted batch, which can push the table over its size.
+  return ExpireRowBatches(0);
+}
+
+int64_t Table::HotBytes() const {
+  absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
+  return batch_size_accountant_->HotBytes();
 }
 
 StatusOr<bool> Table::ExpireCold() {
+  absl::MutexLock spill_lock(&spill_lock_);
+  if (spill_store_ != nullptr) {
+    internal::RowID first_row_id;
+    const internal::ColdBatch* batch;
+    {
+      absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
+      if (cold_store_->Size() == 0) {
+        return false;
+      }
+      first_row_id = cold_store_->FirstRowID();
+      batch = &cold_store_->front();
+    }
+    // The batch is written without holding the cold lock, so that the spill file I/O doesn't stall
+    // writers and readers of the in-memory stores. Holding spill_lock_ prevents any other expiry,
+    // so the batch can't be popped while it's being written.
+    auto s = spill_store_->Append(first_row_id, *batch);
+    if (!s.ok()) {
+      // The batch is still expired, to keep the table within its memory limit. Readers skip over
+      // the missing rows.
+      metrics_.spill_dropped_rows_counter.Increment(batch->Length());
+      LOG_EVERY_N(WARNING, 100) << absl::Substitute("Failed to spill batch: $0", s.msg());
+    }
+  }
   absl::base_internal::SpinLockHolder cold_lock(&cold_lock_);
   if (cold_store_->Size() == 0) {
     return false;
   }
   cold_store_->PopFront();
+  for (const auto& index : secondary_indexes_) {
+    index->ExpireBatch();
+  }
+  cold_bytes_saved_ -= cold_batch_bytes_saved_.front();
+  cold_batch_bytes_saved_.pop_front();
   absl::base_internal::SpinLockHolder hot_lock(&hot_lock_);
   batch_size_accountant_->ExpireColdBatch();
+  UpdateSecondaryIndexBytes();
   return true;
 }
 
@@ -465,6 +784,8 @@ Status Table::UpdateTableMetricGauges() {
   metrics_.hot_bytes_gauge.Set(stats.hot_bytes);
   metrics_.num_batches_gauge.Set(stats.num_batches);
   metrics_.max_table_size_gauge.Set(stats.max_table_size);
+  metrics_.cold_compression_ratio_gauge.Set(stats.compression_ratio);
+  metrics_.spill_bytes_gauge.Set(stats.spill_bytes);
   // Compute retention gauge
   int64_t current_retention_ns = 0;
   // If min_time is 0, there is no data in the table.
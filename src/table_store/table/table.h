@@ -22,16 +22,20 @@
 #include <arrow/array.h>
 #include <arrow/record_batch.h>
 #include <algorithm>
+#include <atomic>
 #include <deque>
+#include <filesystem>
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
 
 #include <absl/base/internal/spinlock.h>
+#include <absl/container/flat_hash_map.h>
 #include <absl/strings/str_format.h>
 #include "src/common/base/base.h"
 #include "src/common/metrics/metrics.h"
@@ -43,12 +47,18 @@
 #include "src/table_store/schemapb/schema.pb.h"
 #include "src/table_store/table/internal/arrow_array_compactor.h"
 #include "src/table_store/table/internal/batch_size_accountant.h"
+#include "src/table_store/table/internal/hot_store.h"
 #include "src/table_store/table/internal/record_or_row_batch.h"
+#include "src/table_store/table/internal/secondary_index.h"
+#include "src/table_store/table/internal/spill_store.h"
 #include "src/table_store/table/internal/store_with_row_accounting.h"
 #include "src/table_store/table/internal/types.h"
+#include "src/table_store/table/internal/zone_map.h"
 #include "src/table_store/table/table_metrics.h"
 
 DECLARE_int32(table_store_table_size_limit);
+DECLARE_double(table_store_dictionary_encoding_max_distinct_ratio);
+DECLARE_bool(table_store_compress_cold_batches);
 
 namespace px {
 namespace table_store {
@@ -66,6 +76,19 @@ struct TableStats {
   int64_t compacted_batches;
   int64_t max_table_size;
   int64_t min_time;
+  // Ratio of the uncompressed to the compressed size of the cold store (1.0 if uncompressed).
+  double compression_ratio;
+  int64_t decompression_time_ns;
+  // Bytes and batches in the on-disk spill store (0 if spilling is disabled).
+  int64_t spill_bytes;
+  int64_t spill_batches;
+  // Heap bytes of the secondary indexes over the cold store, which are included in `bytes`.
+  int64_t secondary_index_bytes;
+  // Number of rows in the table, including the spill store.
+  int64_t num_rows;
+  // Estimated number of distinct values of the columns with a secondary index, by column name.
+  // The estimate only covers the cold store.
+  absl::flat_hash_map<std::string, int64_t> column_ndv;
 };
 
 /**
@@ -73,12 +96,14 @@ struct TableStats {
  * perspective of writes, in other words data is first written to the hot partitiion, and then later
  * moved to the cold partition. Reads can hit both hot and cold data. Hot data can be written in
  * RecordBatch format (i.e. for writes from stirling) or schema::RowBatch format (i.e. for writes
- * from MemorySinkNodes, which are not currently used). Both stores use a wrapper around std::deque
- * to store the data while keeping track of row and time indexes (see `StoreWithRowTimeAccounting`
- * and `Time and Row Indexing` below).
+ * from MemorySinkNodes, which are not currently used). Both stores keep track of row and time
+ * indexes for their batches (see `StoreWithRowTimeAccounting`, `HotStore` and `Time and Row
+ * Indexing` below).
  *
  * Synchronization Scheme:
- * The hot and cold partitions are synchronized separately with spinlocks.
+ * The cold partition is synchronized with a spinlock. Mutations of the hot partition are
+ * serialized with a separate spinlock, but reads of the hot partition are lock-free (see
+ * `HotStore`), so a streaming cursor polling for new data never blocks the writer.
  *
  * Compaction Scheme:
  * Hot batches are compacted into batches of size roughly `compacted_batch_size_` +/- the size of a
@@ -116,6 +141,8 @@ class Table : public NotCopyable {
  public:
   static inline constexpr int64_t kMaxBatchesPerCompactionCall = 256;
   using StopPosition = int64_t;
+  using ColumnPredicate = internal::ColumnPredicate;
+  using PredicateLiteral = internal::PredicateLiteral;
   static inline std::shared_ptr<Table> Create(std::string_view table_name,
                                               const schema::Relation& relation) {
     // Create naked pointer, because std::make_shared() cannot access the private ctor.
@@ -163,7 +190,16 @@ class Table : public NotCopyable {
     };
 
     explicit Cursor(const Table* table) : Cursor(table, StartSpec{}, StopSpec{}) {}
-    Cursor(const Table* table, StartSpec start, StopSpec stop);
+    Cursor(const Table* table, StartSpec start, StopSpec stop)
+        : Cursor(table, start, stop, std::vector<ColumnPredicate>{}) {}
+    /**
+     * Construct a Cursor with pushed down predicates. The predicates are a conjunction, and are
+     * used to skip cold batches whose zone maps show that none of their rows can match. Batches
+     * that may match are returned in full, so the caller is still responsible for filtering rows.
+     * When batches are skipped, GetNextRowBatch may return a batch with zero rows.
+     */
+    Cursor(const Table* table, StartSpec start, StopSpec stop,
+           std::vector<ColumnPredicate> predicates);
 
     // In the case of StopType == Infinite or StopType == StopAtTime, this returns whether the table
     // has the next batch ready. In the case of StopType == CurrentEndOfTable, this returns !Done().
@@ -186,6 +222,7 @@ class Table : public NotCopyable {
     internal::RowID* LastReadRowID();
     internal::BatchHints* Hints();
     std::optional<internal::RowID> StopRowID() const;
+    const std::vector<ColumnPredicate>& Predicates() const;
 
     struct StopState {
       StopSpec spec;
@@ -195,6 +232,7 @@ class Table : public NotCopyable {
     internal::BatchHints hints_;
     RowID last_read_row_id_;
     StopState stop_;
+    std::vector<ColumnPredicate> predicates_;
 
     friend class Table;
   };
@@ -212,7 +250,16 @@ class Table : public NotCopyable {
       : Table(table_name, relation, max_table_size, kDefaultColdBatchMinSize) {}
 
   Table(std::string_view table_name, const schema::Relation& relation, size_t max_table_size,
-        size_t compacted_batch_size_);
+        size_t compacted_batch_size)
+      : Table(table_name, relation, max_table_size, compacted_batch_size,
+              FLAGS_table_store_compress_cold_batches) {}
+
+  /**
+   * @param compress_cold_batches whether compacted batches should be compressed (see
+   * internal::ColdBatch::Compress).
+   */
+  Table(std::string_view table_name, const schema::Relation& relation, size_t max_table_size,
+        size_t compacted_batch_size, bool compress_cold_batches);
 
   /**
    * Get a RowBatch of data corresponding to the next data after the given cursor.
@@ -286,6 +333,28 @@ class Table : public NotCopyable {
    */
   Status CompactHotToCold(arrow::MemoryPool* mem_pool);
 
+  /**
+   * @return the number of bytes in the hot store, ie. the amount of data waiting to be compacted.
+   */
+  int64_t HotBytes() const;
+
+  /**
+   * Enables spilling to disk. Once enabled, cold batches expired from memory are written to a ring
+   * file of the given size at `path` (see internal::SpillStore), and remain readable by cursors
+   * until they are overwritten.
+   * @param path the path of the spill file to create.
+   * @param capacity_bytes the size of the spill file.
+   */
+  Status EnableSpill(const std::filesystem::path& path, int64_t capacity_bytes);
+
+  /**
+   * Enables a secondary index on the given column (see internal::SecondaryIndex). Cursors with an
+   * equality predicate on an indexed column seek directly to the cold rows that may match, rather
+   * than reading every cold batch. Must be called before any data is compacted into the table.
+   * @param col_name the name of the column to index. Must be a STRING, UINT128 or INT64 column.
+   */
+  Status EnableSecondaryIndex(std::string_view col_name);
+
  private:
   TableMetrics metrics_;
 
@@ -298,18 +367,35 @@ class Table : public NotCopyable {
   int64_t compacted_batches_ ABSL_GUARDED_BY(stats_lock_) = 0;
   int64_t max_table_size_ = 0;
   const int64_t compacted_batch_size_;
+  // Lock ordering is spill_lock_ -> cold_lock_ -> hot_lock_. spill_lock_ is a mutex rather than a
+  // spinlock, since it's held while the spill file is written and read. Batches are spilled with
+  // spill_lock_ held exclusively before they're popped from the cold store, so readers holding it
+  // shared see each row in either the spill store or the cold store.
+  mutable absl::Mutex spill_lock_;
+  std::unique_ptr<internal::SpillStore> spill_store_ ABSL_GUARDED_BY(spill_lock_);
+
+  // hot_lock_ serializes mutations of the hot store (writes, compaction and expiry). Reads of the
+  // hot store are lock-free, so cursors never contend with the writer for the hot store.
   mutable absl::base_internal::SpinLock hot_lock_;
-  std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Hot>> hot_store_
-      ABSL_GUARDED_BY(hot_lock_);
+  std::unique_ptr<internal::HotStore> hot_store_;
 
   mutable absl::base_internal::SpinLock cold_lock_;
   std::unique_ptr<internal::StoreWithRowTimeAccounting<internal::StoreType::Cold>> cold_store_
       ABSL_GUARDED_BY(cold_lock_);
   std::deque<int64_t> cold_batch_bytes_ ABSL_GUARDED_BY(cold_lock_);
+  const bool compress_cold_batches_;
+  // Bytes saved by dictionary encoding and compression for each cold batch, and the total over all
+  // cold batches.
+  std::deque<int64_t> cold_batch_bytes_saved_ ABSL_GUARDED_BY(cold_lock_);
+  int64_t cold_bytes_saved_ ABSL_GUARDED_BY(cold_lock_) = 0;
+  // Secondary indexes over the cold store. Indexes are only added while holding both
+  // compaction_lock_ and cold_lock_, so compaction may read the list holding either.
+  std::vector<std::unique_ptr<internal::SecondaryIndex>> secondary_indexes_
+      ABSL_GUARDED_BY(cold_lock_);
 
-  // Counter to assign a unique row ID to each row. Synchronized by hot_lock_ since its only
-  // accessed on a hot write.
-  int64_t next_row_id_ ABSL_GUARDED_BY(hot_lock_) = 0;
+  // Counter to assign a unique row ID to each row. Only written on a hot write, under hot_lock_,
+  // but read without locks.
+  std::atomic<int64_t> next_row_id_ = 0;
   int64_t time_col_idx_ = -1;
 
   Status WriteHot(internal::RecordOrRowBatch&& record_or_row_batch);
@@ -318,13 +404,29 @@ class Table : public NotCopyable {
   Status ExpireHot();
   StatusOr<bool> ExpireCold();
   Status ExpireRowBatches(int64_t row_batch_size);
-  Status CompactSingleBatchUnlocked(arrow::MemoryPool* mem_pool)
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_) ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
+  // The bytes that count towards max_table_size_.
+  int64_t StoredBytes() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
+  void UpdateSecondaryIndexBytes() ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_, hot_lock_);
+  // Compacts the next compacted batch, if one is ready. Returns whether any work was done.
+  StatusOr<bool> CompactSingleBatch(arrow::MemoryPool* mem_pool)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(compaction_lock_);
   Status UpdateTableMetricGauges();
+  // Advances the cursor past cold rows that a secondary index shows can't match the cursor's
+  // predicates, and lowers `*cold_stop_row_id` to the end of the next matching range. Returns the
+  // number of rows skipped.
+  int64_t SeekWithSecondaryIndex(Cursor* cursor,
+                                 std::optional<internal::RowID>* cold_stop_row_id) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_);
 
   std::unique_ptr<internal::BatchSizeAccountant> batch_size_accountant_ ABSL_GUARDED_BY(hot_lock_);
-
-  internal::ArrowArrayCompactor compactor_;
+  // Heap bytes of the secondary indexes, which count towards max_table_size_. Like the cold bytes
+  // of batch_size_accountant_, it's updated holding both cold_lock_ and hot_lock_.
+  int64_t secondary_index_bytes_ ABSL_GUARDED_BY(hot_lock_) = 0;
+
+  // Serializes compactions of this table. Compaction only holds the hot and cold locks briefly,
+  // while copying rows out of the hot store and while adding the finished batch to the cold store.
+  absl::Mutex compaction_lock_;
+  internal::ArrowArrayCompactor compactor_ ABSL_GUARDED_BY(compaction_lock_);
 
   friend class Cursor;
 };
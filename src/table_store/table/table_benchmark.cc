@@ -19,22 +19,28 @@
 #include <absl/synchronization/barrier.h>
 #include <absl/synchronization/notification.h>
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <numeric>
 #include <random>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "src/shared/types/types.h"
 #include "src/table_store/table/table.h"
 
 namespace px::table_store {
 
-static inline std::unique_ptr<Table> MakeTable(int64_t max_size, int64_t compaction_size) {
+static inline std::unique_ptr<Table> MakeTable(int64_t max_size, int64_t compaction_size,
+                                               bool compress_cold_batches = false) {
   schema::Relation rel(
       std::vector<types::DataType>({types::DataType::TIME64NS, types::DataType::FLOAT64}),
       std::vector<std::string>({"time_", "float"}));
-  return std::make_unique<Table>("test_table", rel, max_size, compaction_size);
+  return std::make_unique<Table>("test_table", rel, max_size, compaction_size,
+                                 compress_cold_batches);
 }
 
 static inline std::unique_ptr<types::ColumnWrapperRecordBatch> MakeHotBatch(int64_t batch_size,
@@ -82,9 +88,53 @@ static inline int64_t FillTableCold(Table* table, int64_t table_size, int64_t ba
   return time_counter;
 }
 
-static inline void ReadFullTable(Table::Cursor* cursor) {
+// A table with a column for each cold batch encoding: a time column and a narrow-range INT64
+// column (delta frame of reference), and a low-cardinality STRING column (dictionary).
+static inline std::unique_ptr<Table> MakeMixedTable(int64_t max_size, int64_t compaction_size) {
+  schema::Relation rel(
+      std::vector<types::DataType>({types::DataType::TIME64NS, types::DataType::FLOAT64,
+                                    types::DataType::INT64, types::DataType::STRING}),
+      std::vector<std::string>({"time_", "float", "resp_status", "service"}));
+  return std::make_unique<Table>("test_table", rel, max_size, compaction_size,
+                                 /* compress_cold_batches */ true);
+}
+
+static inline std::unique_ptr<types::ColumnWrapperRecordBatch> MakeMixedHotBatch(
+    int64_t batch_length, int64_t* time_counter, std::mt19937* rng) {
+  const std::vector<int64_t> statuses = {200, 201, 204, 400, 404, 500};
+  const std::vector<std::string> services = {"px-sock-shop/carts",    "px-sock-shop/catalogue",
+                                             "px-sock-shop/front-end", "px-sock-shop/orders",
+                                             "px-sock-shop/payment",  "px-sock-shop/shipping",
+                                             "px-sock-shop/user",     "px-sock-shop/queue-master"};
+  std::uniform_int_distribution<size_t> status_dist(0, statuses.size() - 1);
+  std::uniform_int_distribution<size_t> service_dist(0, services.size() - 1);
+
+  auto batch = MakeHotBatch(batch_length, time_counter);
+  auto status_col = std::make_shared<types::Int64ValueColumnWrapper>(0);
+  auto service_col = std::make_shared<types::StringValueColumnWrapper>(0);
+  for (int64_t i = 0; i < batch_length; ++i) {
+    status_col->Append(statuses[status_dist(*rng)]);
+    service_col->Append(services[service_dist(*rng)]);
+  }
+  batch->push_back(status_col);
+  batch->push_back(service_col);
+  return batch;
+}
+
+static inline void FillMixedTableCold(Table* table, int64_t table_size, int64_t batch_length) {
+  // Fill the table with about twice its size in uncompressed rows, so that it's full after
+  // compression.
+  int64_t time_counter = 0;
+  std::mt19937 rng(37);
+  while (table->GetTableStats().bytes_added < 2 * table_size) {
+    PL_CHECK_OK(table->TransferRecordBatch(MakeMixedHotBatch(batch_length, &time_counter, &rng)));
+    PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+  }
+}
+
+static inline void ReadFullTable(Table::Cursor* cursor, const std::vector<int64_t>& cols = {0, 1}) {
   while (!cursor->Done()) {
-    benchmark::DoNotOptimize(cursor->GetNextRowBatch({0, 1}));
+    benchmark::DoNotOptimize(cursor->GetNextRowBatch(cols));
   }
 }
 
@@ -133,6 +183,30 @@ static void BM_TableReadAllCold(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * table_size);
 }
 
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableReadAllColdCompressed(benchmark::State& state) {
+  int64_t table_size = 4 * 1024 * 1024;
+  int64_t compaction_size = 64 * 1024;
+  int64_t batch_length = 256;
+  auto table = MakeMixedTable(table_size, compaction_size);
+  FillMixedTableCold(table.get(), table_size, batch_length);
+  // Compression frees up space in the table, so more data is retained than in BM_TableReadAllCold.
+  auto stats = table->GetTableStats();
+  int64_t uncompressed_bytes = stats.hot_bytes + stats.cold_bytes * stats.compression_ratio;
+  Table::Cursor cursor(table.get());
+
+  for (auto _ : state) {
+    ReadFullTable(&cursor, {0, 1, 2, 3});
+
+    state.PauseTiming();
+    cursor = Table::Cursor(table.get());
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(state.iterations() * uncompressed_bytes);
+  state.counters["compression_ratio"] = stats.compression_ratio;
+}
+
 Table::Cursor GetLastBatchCursor(Table* table, int64_t last_time, int64_t batch_length,
                                  const std::vector<int64_t>& cols) {
   Table::Cursor cursor(table,
@@ -360,13 +434,66 @@ static void BM_TableThreaded(benchmark::State& state) {
   state.counters["Write"] = benchmark::Counter(write_average_time);
 }
 
+// Measures write latency while N streaming cursors (args) poll the table for new hot data.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableWriteContended(benchmark::State& state) {
+  int64_t num_readers = state.range(0);
+  int64_t table_size = 16 * 1024 * 1024;
+  int64_t compaction_size = 64 * 1024;
+  int64_t batch_length = 256;
+  auto table = MakeTable(table_size, compaction_size);
+
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int64_t i = 0; i < num_readers; ++i) {
+    readers.emplace_back([&table, &done]() {
+      Table::Cursor cursor(table.get(), Table::Cursor::StartSpec{},
+                           Table::Cursor::StopSpec{Table::Cursor::StopSpec::StopType::Infinite});
+      // Readers back off exponentially while no data is ready, like a streaming query polling for
+      // new rows, so that the writer measured here isn't competing with spinning threads for CPU.
+      constexpr auto kMaxBackoff = std::chrono::microseconds(100);
+      auto backoff = std::chrono::microseconds(1);
+      while (!done.load()) {
+        if (!cursor.NextBatchReady()) {
+          std::this_thread::sleep_for(backoff);
+          backoff = std::min(2 * backoff, kMaxBackoff);
+          continue;
+        }
+        backoff = std::chrono::microseconds(1);
+        benchmark::DoNotOptimize(cursor.GetNextRowBatch({0, 1}));
+      }
+    });
+  }
+
+  int64_t time_counter = 0;
+  std::vector<double> write_latencies_us;
+  for (auto _ : state) {
+    auto batch = MakeHotBatch(batch_length, &time_counter);
+    auto start = std::chrono::high_resolution_clock::now();
+    PL_CHECK_OK(table->TransferRecordBatch(std::move(batch)));
+    auto end = std::chrono::high_resolution_clock::now();
+    write_latencies_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  std::sort(write_latencies_us.begin(), write_latencies_us.end());
+  state.counters["p50_write_us"] = write_latencies_us[write_latencies_us.size() / 2];
+  state.counters["p99_write_us"] = write_latencies_us[write_latencies_us.size() * 99 / 100];
+  state.SetBytesProcessed(state.iterations() * batch_length * (sizeof(int64_t) + sizeof(double)));
+}
+
 BENCHMARK(BM_TableReadAllHot);
 BENCHMARK(BM_TableReadAllCold);
+BENCHMARK(BM_TableReadAllColdCompressed);
 BENCHMARK(BM_TableReadLastBatchAllHot)->Iterations(1000);
 BENCHMARK(BM_TableReadLastBatchAllCold)->Iterations(1000);
 BENCHMARK(BM_TableWriteEmpty);
 BENCHMARK(BM_TableWriteFull);
 BENCHMARK(BM_TableCompaction);
 BENCHMARK(BM_TableThreaded)->UseManualTime()->Iterations(1);
+BENCHMARK(BM_TableWriteContended)->Arg(0)->Arg(1)->Arg(4)->Arg(8);
 
 }  // namespace px::table_store
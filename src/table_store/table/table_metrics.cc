@@ -18,6 +18,7 @@
 
 #include "src/table_store/table/table_metrics.h"
 #include <prometheus/counter.h>
+#include <prometheus/histogram.h>
 #include <string>
 
 TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_name)
@@ -58,6 +59,54 @@ TableMetrics::TableMetrics(prometheus::Registry* registry, std::string table_nam
               .Help("Total batches compacted in the table in the table's lifetime")
               .Register(*registry)
               .Add({{"name", table_name}})),
+      zone_map_skipped_batches_counter(
+          prometheus::BuildCounter()
+              .Name("table_zone_map_skipped_batches")
+              .Help("Total cold batches skipped by cursor predicates using per-batch zone maps")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      secondary_index_skipped_rows_counter(
+          prometheus::BuildCounter()
+              .Name("table_secondary_index_skipped_rows")
+              .Help("Total cold rows skipped by cursor predicates using a secondary index")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      cold_compression_ratio_gauge(
+          prometheus::BuildGauge()
+              .Name("table_cold_compression_ratio")
+              .Help("Ratio of uncompressed to compressed bytes of the table's cold batches")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      cold_decompression_ns_counter(
+          prometheus::BuildCounter()
+              .Name("table_cold_decompression_ns")
+              .Help("Total time spent decompressing cold batch columns on reads, in nanoseconds")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      spill_bytes_gauge(prometheus::BuildGauge()
+                            .Name("table_spill_bytes")
+                            .Help("Current bytes of the table spilled to disk")
+                            .Register(*registry)
+                            .Add({{"name", table_name}})),
+      spill_read_batches_counter(
+          prometheus::BuildCounter()
+              .Name("table_spill_read_batches")
+              .Help("Total batches read from the table's on-disk spill store")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      spill_dropped_rows_counter(
+          prometheus::BuildCounter()
+              .Name("table_spill_dropped_rows")
+              .Help("Total rows expired from memory that couldn't be written to the spill store")
+              .Register(*registry)
+              .Add({{"name", table_name}})),
+      compaction_latency_ms_histogram(
+          prometheus::BuildHistogram()
+              .Name("table_compaction_latency_ms")
+              .Help("Time taken to compact a single cold batch, in milliseconds")
+              .Register(*registry)
+              .Add({{"name", table_name}},
+                   prometheus::Histogram::BucketBoundaries{0.1, 0.5, 1, 5, 10, 50, 100, 500})),
       max_table_size_gauge(prometheus::BuildGauge()
                                .Name("table_max_table_size")
                                .Help("The cap on the table size")
@@ -17,6 +17,7 @@
  */
 
 #pragma once
+#include <prometheus/histogram.h>
 #include <prometheus/registry.h>
 #include <string>
 
@@ -32,6 +33,14 @@ struct TableMetrics {
   prometheus::Counter& batches_added_counter;
   prometheus::Counter& batches_expired_counter;
   prometheus::Counter& compacted_batches_counter;
+  prometheus::Counter& zone_map_skipped_batches_counter;
+  prometheus::Counter& secondary_index_skipped_rows_counter;
+  prometheus::Gauge& cold_compression_ratio_gauge;
+  prometheus::Counter& cold_decompression_ns_counter;
+  prometheus::Gauge& spill_bytes_gauge;
+  prometheus::Counter& spill_read_batches_counter;
+  prometheus::Counter& spill_dropped_rows_counter;
+  prometheus::Histogram& compaction_latency_ms_histogram;
   prometheus::Gauge& max_table_size_gauge;
   prometheus::Gauge& retention_ns_gauge;
 };
@@ -17,16 +17,23 @@
  */
 
 #include <algorithm>
+#include <mutex>
 #include <utility>
 #include <vector>
 
 #include "src/table_store/table/table_store.h"
 
+DEFINE_int32(table_store_compaction_threads,
+             gflags::Int32FromEnv("PL_TABLE_STORE_COMPACTION_THREADS", 2),
+             "Number of worker threads used to compact tables in parallel. If 0, tables are "
+             "compacted serially on the calling thread.");
+
 namespace px {
 namespace table_store {
 
 std::unique_ptr<std::unordered_map<std::string, schema::Relation>> TableStore::GetRelationMap() {
   auto map = std::make_unique<RelationMap>();
+  absl::ReaderMutexLock lock(&tables_lock_);
   map->reserve(name_to_relation_map_.size());
   for (auto& [table_name, relation] : name_to_relation_map_) {
     map->emplace(table_name, relation);
@@ -35,6 +42,13 @@ std::unique_ptr<std::unordered_map<std::string, schema::Relation>> TableStore::G
 }
 
 StatusOr<Table*> TableStore::CreateNewTablet(uint64_t table_id, const types::TabletID& tablet_id) {
+  absl::MutexLock lock(&tables_lock_);
+  // Another thread may have created the tablet since the caller's lookup.
+  auto id_to_table_iter = id_to_table_map_.find(TableIDTablet{table_id, tablet_id});
+  if (id_to_table_iter != id_to_table_map_.end()) {
+    return id_to_table_iter->second.get();
+  }
+
   auto id_to_table_info_map_iter = id_to_table_info_map_.find(table_id);
   if (id_to_table_info_map_iter == id_to_table_info_map_.end()) {
     return error::InvalidArgument("Table_id $0 doesn't exist.", table_id);
@@ -67,6 +81,7 @@ Status TableStore::AppendData(uint64_t table_id, types::TabletID tablet_id,
 
 table_store::Table* TableStore::GetTable(const std::string& table_name,
                                          const types::TabletID& tablet_id) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   auto name_to_table_iter = name_to_table_map_.find(NameTablet{table_name, tablet_id});
   if (name_to_table_iter == name_to_table_map_.end()) {
     return nullptr;
@@ -76,6 +91,7 @@ table_store::Table* TableStore::GetTable(const std::string& table_name,
 
 table_store::Table* TableStore::GetTable(uint64_t table_id,
                                          const types::TabletID& tablet_id) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   auto id_to_table_iter = id_to_table_map_.find(TableIDTablet{table_id, tablet_id});
   if (id_to_table_iter == id_to_table_map_.end()) {
     return nullptr;
@@ -115,6 +131,7 @@ void TableStore::RegisterTableID(uint64_t table_id, TableInfo table_info,
 void TableStore::AddTable(std::shared_ptr<table_store::Table> table, const std::string& table_name,
                           std::optional<uint64_t> table_id, const types::TabletID& tablet_id) {
   const auto& table_relation = table->GetRelation();
+  absl::MutexLock lock(&tables_lock_);
 
   // Register the table by name.
   RegisterTableName(table_name, tablet_id, table_relation, table);
@@ -126,6 +143,7 @@ void TableStore::AddTable(std::shared_ptr<table_store::Table> table, const std::
 }
 
 Status TableStore::AddTableAlias(uint64_t table_id, const std::string& table_name) {
+  absl::MutexLock lock(&tables_lock_);
   auto table_iter = name_to_table_map_.find({table_name, ""});
   if (table_iter == name_to_table_map_.end()) {
     return error::Internal(
@@ -147,11 +165,13 @@ Status TableStore::AddTableAlias(uint64_t table_id, const std::string& table_nam
 }
 
 Status TableStore::SchemaAsProto(schemapb::Schema* schema) const {
+  absl::ReaderMutexLock lock(&tables_lock_);
   return schema::Schema::ToProto(schema, name_to_relation_map_);
 }
 
 std::vector<uint64_t> TableStore::GetTableIDs() const {
   std::vector<uint64_t> ids;
+  absl::ReaderMutexLock lock(&tables_lock_);
   for (const auto& it : id_to_table_map_) {
     ids.emplace_back(it.first.table_id_);
   }
@@ -159,10 +179,19 @@ std::vector<uint64_t> TableStore::GetTableIDs() const {
 }
 
 Status TableStore::RunCompaction(arrow::MemoryPool* mem_pool) {
-  for (const auto& it : name_to_table_map_) {
-    PL_RETURN_IF_ERROR(it.second->CompactHotToCold(mem_pool));
+  std::call_once(compaction_scheduler_once_, [this]() {
+    compaction_scheduler_ =
+        std::make_unique<CompactionScheduler>(FLAGS_table_store_compaction_threads);
+  });
+  std::vector<std::shared_ptr<Table>> tables;
+  {
+    absl::ReaderMutexLock lock(&tables_lock_);
+    tables.reserve(name_to_table_map_.size());
+    for (const auto& it : name_to_table_map_) {
+      tables.push_back(it.second);
+    }
   }
-  return Status::OK();
+  return compaction_scheduler_->Run(std::move(tables), mem_pool);
 }
 
 }  // namespace table_store
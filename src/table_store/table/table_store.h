@@ -19,21 +19,26 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
 
 #include "src/common/base/base.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/hash_utils.h"
 #include "src/table_store/schema/relation.h"
 #include "src/table_store/schema/schema.h"
+#include "src/table_store/table/compaction_scheduler.h"
 #include "src/table_store/table/table.h"
 #include "src/table_store/table/tablets_group.h"
 
+DECLARE_int32(table_store_compaction_threads);
+
 namespace px {
 namespace table_store {
 
@@ -74,7 +79,9 @@ struct TableInfo {
 };
 
 /**
- * TableStore keeps track of the tables in our system.
+ * TableStore keeps track of the tables in our system. It is thread-safe: tablets are created from
+ * the data push thread while queries and the agent heartbeat look tables up. Tables are never
+ * removed, so the returned Table pointers stay valid after the lookup.
  */
 class TableStore {
  public:
@@ -158,6 +165,7 @@ class TableStore {
    * GetTableName returns the table name if the ID is found, else empty string.
    */
   std::string GetTableName(uint64_t id) const {
+    absl::ReaderMutexLock lock(&tables_lock_);
     const auto& it = id_to_table_info_map_.find(id);
     if (it != id_to_table_info_map_.end()) {
       return it->second.table_name;
@@ -165,15 +173,21 @@ class TableStore {
     return "";
   }
 
+  /**
+   * Compacts the hot data of every table into cold batches. Tables are compacted in parallel on
+   * the compaction scheduler's worker pool (see --table_store_compaction_threads).
+   */
   Status RunCompaction(arrow::MemoryPool* mem_pool);
 
  private:
   void RegisterTableName(const std::string& table_name, const types::TabletID& tablet_id,
                          const schema::Relation& table_relation,
-                         std::shared_ptr<table_store::Table> table);
+                         std::shared_ptr<table_store::Table> table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(tables_lock_);
 
   void RegisterTableID(uint64_t table_id, TableInfo table_info, const types::TabletID& tablet_id,
-                       std::shared_ptr<table_store::Table> table);
+                       std::shared_ptr<table_store::Table> table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(tables_lock_);
 
   /**
    * Create a new tablet inside of the table with table_id
@@ -186,17 +200,27 @@ class TableStore {
 
   // The default value for tablets, when tablet is not specified.
   inline static types::TabletID kDefaultTablet = "";
+  // Guards the maps below.
+  mutable absl::Mutex tables_lock_;
   // Map a name to a table.
-  absl::flat_hash_map<NameTablet, std::shared_ptr<Table>> name_to_table_map_;
+  absl::flat_hash_map<NameTablet, std::shared_ptr<Table>> name_to_table_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Map an id to a table.
-  absl::flat_hash_map<TableIDTablet, std::shared_ptr<Table>> id_to_table_map_;
+  absl::flat_hash_map<TableIDTablet, std::shared_ptr<Table>> id_to_table_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Mapping from name to relation for adding new tablets.
   // TODO(oazizi): value should likely be shared_ptr<schema::Relation> because the
   //               same information is in id_to_table_info_map_ TableInfo.
   //               Can avoid this copy.
-  absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_;
+  absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_
+      ABSL_GUARDED_BY(tables_lock_);
   // Mapping from id to name and relation pair for adding new tablets.
-  absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_;
+  absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_ ABSL_GUARDED_BY(tables_lock_);
+  // Created on the first call to RunCompaction, so that table stores that never compact don't
+  // start worker threads. RunCompaction may be called concurrently, so creation is guarded by
+  // compaction_scheduler_once_.
+  std::once_flag compaction_scheduler_once_;
+  std::unique_ptr<CompactionScheduler> compaction_scheduler_;
 };
 
 }  // namespace table_store
@@ -143,6 +143,7 @@ TEST(TableTest, bytes_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size + rb3_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 8);
 }
 
 TEST(TableTest, bytes_test_w_compaction) {
@@ -244,6 +245,8 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb3));
   EXPECT_EQ(table.GetTableStats().bytes, rb2_size + rb3_size);
+  // rb1 expired, so only the rows of rb2 and rb3 are left.
+  EXPECT_EQ(table.GetTableStats().num_rows, 4);
 
   std::vector<types::Int64Value> time_hot_col1 = {1};
   std::vector<types::StringValue> time_hot_col2 = {"a"};
@@ -891,6 +894,297 @@ TEST(TableTest, NextBatch_generation_bug) {
   EXPECT_NOT_OK(cursor.GetNextRowBatch({0, 1}));
 }
 
+TEST(TableTest, cursor_predicates_skip_cold_batches) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64},
+                       {"time_", "resp_status"});
+  auto write_batch = [&rel](Table* table, const std::vector<types::Time64NSValue>& times,
+                            const std::vector<types::Int64Value>& statuses) {
+    schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), times.size());
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(statuses, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+  };
+  int64_t compacted_size = 3 * (sizeof(int64_t) + sizeof(int64_t));
+  Table table("test_table", rel, 128 * 1024, compacted_size);
+
+  write_batch(&table, {1, 2, 3}, {200, 200, 200});
+  write_batch(&table, {4, 5, 6}, {500, 503, 200});
+  write_batch(&table, {7, 8, 9}, {200, 201, 204});
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  // This batch stays in the hot store, which doesn't have zone maps.
+  write_batch(&table, {10}, {500});
+
+  Table::Cursor cursor(&table, Table::Cursor::StartSpec{}, Table::Cursor::StopSpec{},
+                       {{1, Table::ColumnPredicate::Op::kGreaterThanEqual, int64_t{500}}});
+
+  // The first cold batch is skipped.
+  ASSERT_OK_AND_ASSIGN(auto rb1, cursor.GetNextRowBatch({0, 1}));
+  std::vector<types::Int64Value> expected_rb1 = {500, 503, 200};
+  EXPECT_TRUE(rb1->ColumnAt(1)->Equals(types::ToArrow(expected_rb1, arrow::default_memory_pool())));
+
+  // The last cold batch is skipped, and the hot batch is returned.
+  ASSERT_FALSE(cursor.Done());
+  ASSERT_OK_AND_ASSIGN(auto rb2, cursor.GetNextRowBatch({0, 1}));
+  std::vector<types::Int64Value> expected_rb2 = {500};
+  EXPECT_TRUE(rb2->ColumnAt(1)->Equals(types::ToArrow(expected_rb2, arrow::default_memory_pool())));
+  EXPECT_TRUE(cursor.Done());
+}
+
+TEST(TableTest, secondary_index_seeks_to_matching_rows) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "svc"});
+  auto write_batch = [&rel](Table* table, const std::vector<types::Time64NSValue>& times,
+                            const std::vector<types::Int64Value>& svcs) {
+    schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), times.size());
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(svcs, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+  };
+  int64_t compacted_size = 3 * (sizeof(int64_t) + sizeof(int64_t));
+  Table table("test_table", rel, 128 * 1024, compacted_size);
+  EXPECT_NOT_OK(table.EnableSecondaryIndex("missing"));
+  EXPECT_NOT_OK(table.EnableSecondaryIndex("time_"));
+  ASSERT_OK(table.EnableSecondaryIndex("svc"));
+  EXPECT_NOT_OK(table.EnableSecondaryIndex("svc"));
+
+  write_batch(&table, {1, 2, 3}, {1, 2, 2});
+  write_batch(&table, {4, 5, 6}, {1, 1, 1});
+  write_batch(&table, {7, 8, 9}, {3, 3, 2});
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  // This batch stays in the hot store, which isn't indexed.
+  write_batch(&table, {10}, {2});
+  EXPECT_NOT_OK(table.EnableSecondaryIndex("svc"));
+  EXPECT_EQ(table.GetTableStats().num_rows, 10);
+  EXPECT_THAT(table.GetTableStats().column_ndv,
+              ::testing::UnorderedElementsAre(::testing::Pair("svc", 3)));
+
+  auto read_all = [&table](int64_t svc) {
+    Table::Cursor cursor(&table, Table::Cursor::StartSpec{}, Table::Cursor::StopSpec{},
+                         {{1, Table::ColumnPredicate::Op::kEqual, svc}});
+    std::vector<std::vector<int64_t>> times_read;
+    while (!cursor.Done()) {
+      auto rb_or_s = cursor.GetNextRowBatch({0});
+      EXPECT_OK(rb_or_s);
+      auto rb = rb_or_s.ConsumeValueOrDie();
+      std::vector<int64_t> times;
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        times.push_back(
+            types::GetValueFromArrowArray<types::DataType::TIME64NS>(rb->ColumnAt(0).get(), i));
+      }
+      times_read.push_back(times);
+    }
+    return times_read;
+  };
+
+  // Each cold read starts at the next matching row, and rows before it are never read.
+  EXPECT_THAT(read_all(2), ::testing::ElementsAre(::testing::ElementsAre(2, 3),
+                                                  ::testing::ElementsAre(9),
+                                                  ::testing::ElementsAre(10)));
+  // No cold row matches, so only the hot batch is returned.
+  EXPECT_THAT(read_all(4), ::testing::ElementsAre(::testing::ElementsAre(10)));
+}
+
+TEST(TableTest, secondary_index_bytes_count_towards_table_size) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "svc"});
+  int64_t num_rows = 3;
+  int64_t compacted_size = num_rows * (sizeof(int64_t) + sizeof(int64_t));
+  int64_t max_table_size = 4 * internal::SecondaryIndex::kBytesPerKey;
+  Table table("test_table", rel, max_table_size, compacted_size);
+  ASSERT_OK(table.EnableSecondaryIndex("svc"));
+
+  // Every row has a distinct svc, so the index outgrows the rows it indexes.
+  for (int64_t batch = 0; batch < 4; ++batch) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> svcs;
+    for (int64_t i = 0; i < num_rows; ++i) {
+      times.push_back(batch * num_rows + i);
+      svcs.push_back(batch * num_rows + i);
+    }
+    schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), num_rows);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(svcs, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+  }
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  // Compaction expires the oldest batches, with their index entries, to fit the index in the
+  // table size.
+  auto stats = table.GetTableStats();
+  EXPECT_LE(stats.bytes, max_table_size);
+  EXPECT_EQ(stats.bytes, stats.hot_bytes + stats.cold_bytes + stats.secondary_index_bytes);
+  EXPECT_GT(stats.batches_expired, 0);
+  ASSERT_EQ(1, stats.column_ndv.size());
+  EXPECT_EQ(stats.num_rows, stats.column_ndv["svc"]);
+  EXPECT_GE(stats.secondary_index_bytes,
+            stats.column_ndv["svc"] * internal::SecondaryIndex::kBytesPerKey);
+}
+
+TEST(TableTest, compressed_cold_batches) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64},
+                       {"time_", "resp_status"});
+  int64_t num_rows = 128;
+  int64_t compacted_size = num_rows * (sizeof(int64_t) + sizeof(int64_t));
+  Table table("test_table", rel, 128 * 1024, compacted_size, /* compress_cold_batches */ true);
+
+  std::vector<types::Time64NSValue> times;
+  std::vector<types::Int64Value> statuses;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times.push_back(1000 + 10 * i);
+    statuses.push_back(200);
+  }
+  schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), num_rows);
+  EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+  EXPECT_OK(rb.AddColumn(types::ToArrow(statuses, arrow::default_memory_pool())));
+  EXPECT_OK(table.WriteRowBatch(rb));
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(0, stats.hot_bytes);
+  EXPECT_LT(stats.cold_bytes, compacted_size);
+  EXPECT_GT(stats.compression_ratio, 1.0);
+
+  // Time lookups work on the compressed time column.
+  EXPECT_EQ(50, table.FindRowIDFromTimeFirstGreaterThanOrEqual(1495));
+  EXPECT_EQ(51, table.FindRowIDFromTimeFirstGreaterThan(1500));
+
+  Table::Cursor cursor(&table);
+  ASSERT_OK_AND_ASSIGN(auto out_rb, cursor.GetNextRowBatch({0, 1}));
+  EXPECT_TRUE(out_rb->ColumnAt(0)->Equals(types::ToArrow(times, arrow::default_memory_pool())));
+  EXPECT_TRUE(
+      out_rb->ColumnAt(1)->Equals(types::ToArrow(statuses, arrow::default_memory_pool())));
+  EXPECT_TRUE(cursor.Done());
+}
+
+TEST(TableTest, compression_ratio_counts_dictionary_encoding) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::STRING}, {"time_", "method"});
+  int64_t num_rows = 128;
+  Table table("test_table", rel, 128 * 1024, num_rows * sizeof(int64_t),
+              /* compress_cold_batches */ false);
+
+  std::vector<types::Time64NSValue> times;
+  std::vector<types::StringValue> methods;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    times.push_back(1000 + 10 * i);
+    methods.push_back(i % 2 == 0 ? "GET" : "POST");
+  }
+  schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), num_rows);
+  EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+  EXPECT_OK(rb.AddColumn(types::ToArrow(methods, arrow::default_memory_pool())));
+  EXPECT_OK(table.WriteRowBatch(rb));
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+
+  // The batches aren't compressed, but the string column is dictionary encoded.
+  auto stats = table.GetTableStats();
+  EXPECT_GT(stats.cold_bytes, 0);
+  EXPECT_GT(stats.compression_ratio, 1.0);
+}
+
+TEST(TableTest, spill_expired_cold_batches) {
+  px::testing::TempDir temp_dir;
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64},
+                       {"time_", "resp_status"});
+  int64_t rows_per_batch = 4;
+  int64_t batch_bytes = rows_per_batch * (sizeof(int64_t) + sizeof(int64_t));
+  // The table only holds 2 batches in memory.
+  Table table("test_table", rel, 2 * batch_bytes, batch_bytes);
+  ASSERT_OK(table.EnableSpill(temp_dir.path() / "test_table.spill", 1024 * 1024));
+
+  for (int64_t batch = 0; batch < 5; ++batch) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> statuses;
+    for (int64_t i = 0; i < rows_per_batch; ++i) {
+      times.push_back(10 * (batch * rows_per_batch + i));
+      statuses.push_back(batch);
+    }
+    schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), rows_per_batch);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(statuses, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+    EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  auto stats = table.GetTableStats();
+  EXPECT_LE(stats.bytes, 2 * batch_bytes);
+  EXPECT_GT(stats.spill_batches, 0);
+  EXPECT_GT(stats.spill_bytes, 0);
+  EXPECT_EQ(0, stats.min_time);
+  EXPECT_EQ(0, table.FirstRowID());
+
+  // A cursor starting before the in-memory window reads through the spilled batches.
+  Table::Cursor::StartSpec start_spec;
+  start_spec.type = Table::Cursor::StartSpec::StartType::StartAtTime;
+  start_spec.start_time = 45;
+  Table::Cursor cursor(&table, start_spec, Table::Cursor::StopSpec{});
+  std::vector<int64_t> statuses_read;
+  while (!cursor.Done()) {
+    ASSERT_OK_AND_ASSIGN(auto rb, cursor.GetNextRowBatch({1}));
+    for (int64_t i = 0; i < rb->num_rows(); ++i) {
+      statuses_read.push_back(
+          types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(0).get(), i));
+    }
+  }
+  EXPECT_THAT(statuses_read, ::testing::ElementsAre(1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4));
+}
+
+TEST(TableTest, cursor_skips_rows_that_failed_to_spill) {
+  px::testing::TempDir temp_dir;
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64},
+                       {"time_", "resp_status"});
+  int64_t rows_per_batch = 4;
+  int64_t batch_bytes = rows_per_batch * (sizeof(int64_t) + sizeof(int64_t));
+  Table table("test_table", rel, 2 * batch_bytes, batch_bytes);
+  // The spill file is too small to hold a single row, so all expired rows are dropped.
+  ASSERT_OK(table.EnableSpill(temp_dir.path() / "test_table.spill", 64));
+
+  auto write_batch = [&](int64_t batch) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> statuses;
+    for (int64_t i = 0; i < rows_per_batch; ++i) {
+      times.push_back(10 * (batch * rows_per_batch + i));
+      statuses.push_back(batch);
+    }
+    schema::RowBatch rb(schema::RowDescriptor(rel.col_types()), rows_per_batch);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(statuses, arrow::default_memory_pool())));
+    EXPECT_OK(table.WriteRowBatch(rb));
+  };
+  auto read_all = [](Table::Cursor* cursor) {
+    std::vector<int64_t> statuses_read;
+    while (cursor->NextBatchReady()) {
+      auto rb_or_s = cursor->GetNextRowBatch({1});
+      EXPECT_OK(rb_or_s);
+      if (!rb_or_s.ok()) {
+        break;
+      }
+      auto rb = rb_or_s.ConsumeValueOrDie();
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        statuses_read.push_back(
+            types::GetValueFromArrowArray<types::DataType::INT64>(rb->ColumnAt(0).get(), i));
+      }
+    }
+    return statuses_read;
+  };
+
+  Table::Cursor::StopSpec stop_spec;
+  stop_spec.type = Table::Cursor::StopSpec::StopType::Infinite;
+  write_batch(0);
+  Table::Cursor stale_cursor(&table, Table::Cursor::StartSpec{}, stop_spec);
+  for (int64_t batch = 0; batch < 4; ++batch) {
+    if (batch > 0) {
+      write_batch(batch);
+    }
+    EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  }
+  write_batch(4);
+  EXPECT_EQ(0, table.GetTableStats().spill_batches);
+
+  // The cursor skips the dropped rows, but still reads the cold batches before the hot batch.
+  Table::Cursor fresh_cursor(&table, Table::Cursor::StartSpec{}, stop_spec);
+  auto expected = read_all(&fresh_cursor);
+  ASSERT_FALSE(expected.empty());
+  EXPECT_LT(expected.front(), 4);
+  EXPECT_EQ(expected, read_all(&stale_cursor));
+}
+
 TEST(TableTest, GetNextRowBatch_after_expiry) {
   schema::Relation rel({types::DataType::BOOLEAN, types::DataType::INT64}, {"col1", "col2"});
 
@@ -18,6 +18,7 @@
 
 #include "src/vizier/services/agent/manager/heartbeat.h"
 
+#include <absl/container/flat_hash_set.h>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -34,12 +35,14 @@ using ::px::shared::k8s::metadatapb::ResourceUpdate;
 HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
                                                  px::md::AgentMetadataStateManager* mds_manager,
                                                  RelationInfoManager* relation_info_manager,
+                                                 const table_store::TableStore* table_store,
                                                  Info* agent_info,
                                                  Manager::VizierNATSConnector* nats_conn)
     : MessageHandler(d, agent_info, nats_conn),
       time_source_(dispatcher()->GetTimeSource()),
       mds_manager_(mds_manager),
       relation_info_manager_(relation_info_manager),
+      table_store_(table_store),
       heartbeat_send_timer_(
           dispatcher()->CreateTimer(std::bind(&HeartbeatMessageHandler::SendHeartbeat, this))),
       heartbeat_watchdog_timer_(
@@ -50,6 +53,7 @@ HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
 void HeartbeatMessageHandler::DisableHeartbeats() {
   last_metadata_epoch_id_ = 0;
   sent_schema_ = false;
+  last_table_stats_time_.reset();
   heartbeat_send_timer_->DisableTimer();
   heartbeat_watchdog_timer_->DisableTimer();
 }
@@ -103,13 +107,22 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
     relation_info_manager_->AddSchemaToUpdateInfo(update_info);
   }
 
-  // We skip sending the metadata update when there have been no changes.
+  // The metadata info and the table stats are sent independently: the metadata info only when its
+  // epoch changed, and the table stats when they are older than kTableStatsInterval. The metadata
+  // service keeps the previously sent value of whichever one is missing from the data info.
   auto current_epoch = mds_manager_->metadata_filter()->epoch_id();
   if (last_metadata_epoch_id_ == 0 || last_metadata_epoch_id_ != current_epoch) {
-    auto metadata_filter = update_info->mutable_data()->mutable_metadata_info();
-    *metadata_filter = mds_manager_->metadata_filter()->ToProto();
+    *update_info->mutable_data()->mutable_metadata_info() =
+        mds_manager_->metadata_filter()->ToProto();
     last_metadata_epoch_id_ = current_epoch;
   }
+  bool reports_table_stats = table_store_ != nullptr && agent_info()->capabilities.collects_data();
+  if (reports_table_stats &&
+      (!last_table_stats_time_.has_value() ||
+       time_source_.MonotonicTime() - *last_table_stats_time_ >= kTableStatsInterval)) {
+    AddTableStatsToDataInfo(update_info->mutable_data());
+    last_table_stats_time_ = time_source_.MonotonicTime();
+  }
 
   VLOG(1) << "Sending heartbeat message: " << req.DebugString();
   heartbeat_info_.last_heartbeat_send_time_ = time_source_.MonotonicTime();
@@ -117,6 +130,28 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
   return nats_conn()->Publish(req);
 }
 
+void HeartbeatMessageHandler::AddTableStatsToDataInfo(messages::AgentDataInfo* data_info) {
+  // Tabletized tables have an entry per tablet, but their stats are reported once per table.
+  absl::flat_hash_set<uint64_t> table_ids;
+  for (uint64_t table_id : table_store_->GetTableIDs()) {
+    if (!table_ids.insert(table_id).second) {
+      continue;
+    }
+    const table_store::Table* table = table_store_->GetTable(table_id);
+    if (table == nullptr) {
+      continue;
+    }
+    auto stats = table->GetTableStats();
+    auto table_stats = data_info->add_table_stats();
+    table_stats->set_table(table_store_->GetTableName(table_id));
+    table_stats->set_num_rows(stats.num_rows);
+    table_stats->set_num_bytes(stats.bytes);
+    for (const auto& [col_name, ndv] : stats.column_ndv) {
+      (*table_stats->mutable_column_ndv())[col_name] = ndv;
+    }
+  }
+}
+
 void HeartbeatMessageHandler::HeartbeatWatchdog() {
   if (heartbeat_info_.last_ackd_seq_num < heartbeat_info_.last_sent_seq_num) {
     auto diff = time_source_.MonotonicTime() - heartbeat_info_.last_heartbeat_send_time_;
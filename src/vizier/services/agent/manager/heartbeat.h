@@ -19,7 +19,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
+#include "src/table_store/table/table_store.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
 namespace px {
@@ -31,7 +33,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   HeartbeatMessageHandler() = delete;
   HeartbeatMessageHandler(px::event::Dispatcher* dispatcher,
                           px::md::AgentMetadataStateManager* mds_manager,
-                          RelationInfoManager* relation_info_manager, Info* agent_info,
+                          RelationInfoManager* relation_info_manager,
+                          const table_store::TableStore* table_store, Info* agent_info,
                           Manager::VizierNATSConnector* nats_conn);
 
   ~HeartbeatMessageHandler() override = default;
@@ -47,6 +50,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
 
   void ProcessPIDTerminatedEvent(const px::md::PIDTerminatedEvent& ev,
                                  messages::AgentUpdateInfo* update_info);
+  // Adds the statistics of every table in the table store, which the planner uses to cost plans.
+  void AddTableStatsToDataInfo(messages::AgentDataInfo* data_info);
 
   void DoHeartbeats();
 
@@ -64,11 +69,14 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   std::unique_ptr<px::vizier::messages::VizierMessage> last_sent_hb_;
   int64_t last_metadata_epoch_id_ = 0;
   bool sent_schema_ = false;
+  std::optional<std::chrono::steady_clock::time_point> last_table_stats_time_;
 
   HeartbeatInfo heartbeat_info_;
   const px::event::TimeSource& time_source_;
   px::md::AgentMetadataStateManager* mds_manager_;
   RelationInfoManager* relation_info_manager_;
+  // Optional, table stats are only reported if the table store is set.
+  const table_store::TableStore* table_store_;
   std::chrono::duration<double> heartbeat_latency_moving_average_{0};
 
   px::event::TimerUPtr heartbeat_send_timer_;
@@ -77,6 +85,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   static constexpr double kHbLatencyDecay = 0.25;
 
   static constexpr std::chrono::seconds kAgentHeartbeatInterval{5};
+  // Table stats only need to be roughly up to date, so they are sent less often than heartbeats.
+  static constexpr std::chrono::seconds kTableStatsInterval{60};
   static constexpr int kHeartbeatRetryCount = 5;
   // The amount of time to wait for a heartbeat ack.
   static constexpr std::chrono::milliseconds kHeartbeatWaitMillis{5000};
@@ -28,6 +28,7 @@
 #include "src/common/testing/event/simulated_time_system.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/metadatapb/metadata.pb.h"
+#include "src/shared/types/arrow_adapter.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/heartbeat.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -128,12 +129,23 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
       EXPECT_OK(relation_info_manager_->AddRelationInfo(relation_info));
     }
 
+    // Table with some data, so that the heartbeat has table stats to report.
+    table_store_ = std::make_unique<table_store::TableStore>();
+    auto table = table_store::Table::Create("relation0", relation0);
+    table_store::schema::RowBatch rb(table_store::schema::RowDescriptor(relation0.col_types()), 3);
+    std::vector<types::Time64NSValue> times = {1, 2, 3};
+    std::vector<types::Int64Value> counts = {10, 20, 30};
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(counts, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+    table_store_->AddTable(table, "relation0", /* table_id */ 0);
+
     agent_info_ = agent::Info{};
     agent_info_.capabilities.set_collects_data(true);
 
     heartbeat_handler_ = std::make_unique<HeartbeatMessageHandler>(
-        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), &agent_info_,
-        nats_conn_.get());
+        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), table_store_.get(),
+        &agent_info_, nats_conn_.get());
   }
 
   void CheckFilterElements(const messages::AgentDataInfo& data_info,
@@ -155,6 +167,7 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
   std::unique_ptr<event::Dispatcher> dispatcher_;
   std::unique_ptr<FakeAgentMetadataStateManager> mds_manager_;
   std::unique_ptr<RelationInfoManager> relation_info_manager_;
+  std::unique_ptr<table_store::TableStore> table_store_;
   std::unique_ptr<HeartbeatMessageHandler> heartbeat_handler_;
   std::unique_ptr<FakeNATSConnector<px::vizier::messages::VizierMessage>> nats_conn_;
   agent::Info agent_info_;
@@ -211,6 +224,31 @@ TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeat) {
   EXPECT_FALSE(hb.update_info().data().has_metadata_info());
 }
 
+TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatTableStats) {
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(1, nats_conn_->published_msgs().size());
+  auto hb = nats_conn_->published_msgs()[0].heartbeat();
+  ASSERT_EQ(1, hb.update_info().data().table_stats_size());
+  const auto& table_stats = hb.update_info().data().table_stats(0);
+  EXPECT_EQ("relation0", table_stats.table());
+  EXPECT_EQ(3, table_stats.num_rows());
+  // 3 rows of two 8 byte columns.
+  EXPECT_EQ(48, table_stats.num_bytes());
+
+  auto hb_ack = std::make_unique<messages::VizierMessage>();
+  hb_ack->mutable_heartbeat_ack()->set_sequence_number(0);
+  EXPECT_OK(heartbeat_handler_->HandleMessage(std::move(hb_ack)));
+
+  // The stats are resent once they are stale, without the unchanged metadata info.
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::seconds(61));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(2, nats_conn_->published_msgs().size());
+  hb = nats_conn_->published_msgs()[1].heartbeat();
+  EXPECT_EQ(1, hb.sequence_number());
+  EXPECT_EQ(1, hb.update_info().data().table_stats_size());
+  EXPECT_FALSE(hb.update_info().data().has_metadata_info());
+}
+
 TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatMetadataChange) {
   // Tthe metadata info should be resent when it changes.
   dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
@@ -236,8 +236,8 @@ Status Manager::RegisterBackgroundHelpers() {
 
   // Add Heartbeat and execute query handlers.
   heartbeat_handler_ = std::make_shared<HeartbeatMessageHandler>(
-      dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), &info_,
-      agent_nats_connector_.get());
+      dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), table_store_.get(),
+      &info_, agent_nats_connector_.get());
 
   auto heartbeat_nack_handler = std::make_shared<HeartbeatNackMessageHandler>(
       dispatcher_.get(), &info_, agent_nats_connector_.get(),
@@ -18,6 +18,11 @@
 
 #include "src/vizier/services/agent/pem/pem_manager.h"
 
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+#include <absl/strings/str_split.h>
 #include "src/common/system/config.h"
 #include "src/vizier/services/agent/manager/exec.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -43,6 +48,21 @@ DEFINE_int32(table_store_proc_exit_events_limit_bytes,
              gflags::Int32FromEnv("PL_TABLE_STORE_PROC_EXIT_EVENTS_LIMIT_BYTES", 10 * 1024 * 1024),
              "The maximum amount of data to store in the proc_exit_events table.");
 
+DEFINE_string(table_store_spill_dir, gflags::StringFromEnv("PL_TABLE_STORE_SPILL_DIR", ""),
+              "Directory to spill table store data expired from memory to. Each table gets a "
+              "memory-mapped ring file in this directory. Spilling is disabled if empty.");
+
+DEFINE_int32(table_store_spill_limit_mb,
+             gflags::Int32FromEnv("PL_TABLE_STORE_SPILL_LIMIT_MB", 8 * 1024),
+             "The maximum amount of disk space used for spilled table store data across all "
+             "tables. Each table gets the same share of this limit as of the memory limit.");
+
+DEFINE_string(table_store_secondary_index_columns,
+              gflags::StringFromEnv("PL_TABLE_STORE_SECONDARY_INDEX_COLUMNS", ""),
+              "Comma separated list of <table>.<column> to build secondary indexes on, eg. "
+              "'http_events.upid,conn_stats.upid'. Queries with an equality filter on an indexed "
+              "column only read the matching rows of the table.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -124,6 +144,35 @@ Status PEMManager::InitSchemas() {
                                                        other_table_size);
     }
 
+    if (!FLAGS_table_store_spill_dir.empty()) {
+      // Each table gets the same share of the spill limit as it has of the memory limit. The share
+      // is computed as a fraction, since multiplying the limits in bytes overflows.
+      double table_fraction =
+          static_cast<double>(table_ptr->GetTableStats().max_table_size) / memory_limit;
+      auto spill_size = static_cast<int64_t>(
+          table_fraction * static_cast<int64_t>(FLAGS_table_store_spill_limit_mb) * 1024 * 1024);
+      auto s = table_ptr->EnableSpill(std::filesystem::path(FLAGS_table_store_spill_dir) /
+                                          absl::StrCat(relation_info.name, ".spill"),
+                                      spill_size);
+      if (!s.ok()) {
+        LOG(ERROR) << absl::Substitute("Failed to enable spilling for table $0: $1",
+                                       relation_info.name, s.msg());
+      }
+    }
+
+    for (std::string_view index_col : absl::StrSplit(FLAGS_table_store_secondary_index_columns,
+                                                     ',', absl::SkipWhitespace())) {
+      std::pair<std::string_view, std::string_view> table_col = absl::StrSplit(index_col, '.');
+      if (table_col.first != relation_info.name) {
+        continue;
+      }
+      auto s = table_ptr->EnableSecondaryIndex(table_col.second);
+      if (!s.ok()) {
+        LOG(ERROR) << absl::Substitute("Failed to enable secondary index on $0: $1", index_col,
+                                       s.msg());
+      }
+    }
+
     table_store()->AddTable(std::move(table_ptr), relation_info.name, relation_info.id);
     PL_RETURN_IF_ERROR(relation_info_manager()->AddRelationInfo(relation_info));
   }
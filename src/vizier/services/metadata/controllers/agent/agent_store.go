@@ -317,7 +317,30 @@ func (a *Datastore) GetAgentsDataInfo() (map[uuid.UUID]*messagespb.AgentDataInfo
 }
 
 // UpdateAgentDataInfo updates the information about data tables that a particular agent has.
+// Agents send their metadata info and table stats independently, so whichever of the two is
+// missing from the update is kept from the previously stored data info.
 func (a *Datastore) UpdateAgentDataInfo(agentID uuid.UUID, dataInfo *messagespb.AgentDataInfo) error {
+	if dataInfo.MetadataInfo == nil || len(dataInfo.TableStats) == 0 {
+		prev, err := a.ds.Get(getAgentDataInfoKey(agentID))
+		if err != nil {
+			return err
+		}
+		if prev != nil {
+			prevPb := &messagespb.AgentDataInfo{}
+			if err := proto.Unmarshal(prev, prevPb); err != nil {
+				return err
+			}
+			merged := *dataInfo
+			if merged.MetadataInfo == nil {
+				merged.MetadataInfo = prevPb.MetadataInfo
+			}
+			if len(merged.TableStats) == 0 {
+				merged.TableStats = prevPb.TableStats
+			}
+			dataInfo = &merged
+		}
+	}
+
 	i, err := dataInfo.Marshal()
 	if err != nil {
 		return errors.New("Unable to marshal agent data info protobuf: " + err.Error())
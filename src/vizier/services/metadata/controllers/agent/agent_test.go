@@ -423,6 +423,56 @@ func TestApplyUpdates(t *testing.T) {
 	assert.Equal(t, dataInfo, expectedDataInfo)
 }
 
+func TestApplyUpdatesPartialDataInfo(t *testing.T) {
+	ads, agtMgr, _, cleanup := setupManager(t)
+	defer cleanup()
+
+	u, err := uuid.FromString(testutils.ExistingAgentUUID)
+	if err != nil {
+		t.Fatal("Could not parse UUID from string.")
+	}
+
+	metadataInfo := &distributedpb.MetadataInfo{
+		MetadataFields: []metadatapb.MetadataType{
+			metadatapb.POD_NAME,
+		},
+	}
+	tableStats := []*distributedpb.TableStatsInfo{
+		{
+			Table:     "http_events",
+			NumRows:   1000,
+			NumBytes:  64000,
+			ColumnNDV: map[string]int64{"req_path": 12},
+		},
+	}
+
+	// The agent sends its metadata info and table stats in separate heartbeats, the stored data
+	// info should hold both.
+	err = agtMgr.ApplyAgentUpdate(&agent.Update{
+		AgentID: u,
+		UpdateInfo: &messagespb.AgentUpdateInfo{
+			Data: &messagespb.AgentDataInfo{MetadataInfo: metadataInfo},
+		},
+	})
+	require.NoError(t, err)
+	err = agtMgr.ApplyAgentUpdate(&agent.Update{
+		AgentID: u,
+		UpdateInfo: &messagespb.AgentUpdateInfo{
+			Data: &messagespb.AgentDataInfo{TableStats: tableStats},
+		},
+	})
+	require.NoError(t, err)
+
+	dataInfos, err := ads.GetAgentsDataInfo()
+	require.NoError(t, err)
+	dataInfo, present := dataInfos[u]
+	require.True(t, present)
+	assert.Equal(t, &messagespb.AgentDataInfo{
+		MetadataInfo: metadataInfo,
+		TableStats:   tableStats,
+	}, dataInfo)
+}
+
 func TestApplyUpdatesDeleted(t *testing.T) {
 	ads, agtMgr, _, cleanup := setupManager(t)
 	defer cleanup()
@@ -38,6 +38,16 @@ var defaultQueryFlags = map[string]interface{}{
 	"explain":                   false,
 	"analyze":                   false,
 	"max_output_rows_per_table": 10000,
+	// The number of Kelvins to spread grouped aggregates and joins over. If 0, the planner picks it
+	// from the agents' table stats.
+	"num_kelvins": 0,
+	// The number of threads each agent runs the filters and maps below a source on, before an
+	// aggregate or join. 0 or 1 runs the query on a single thread.
+	"exec_threads": 1,
+	// Send row batches between agents column by column, and optionally compressed. See
+	// PlanOptions for details.
+	"columnar_transfer": false,
+	"compress_transfer": false,
 }
 
 // QueryFlags represents a set of Pixie configuration flags.
@@ -122,6 +132,10 @@ func (f *QueryFlags) GetPlanOptions() *planpb.PlanOptions {
 		Explain:               f.GetBool("explain"),
 		Analyze:               f.GetBool("analyze"),
 		MaxOutputRowsPerTable: f.GetInt64("max_output_rows_per_table"),
+		ColumnarTransfer:      f.GetBool("columnar_transfer"),
+		CompressTransfer:      f.GetBool("compress_transfer"),
+		NumKelvins:            int32(f.GetInt64("num_kelvins")),
+		ExecThreads:           int32(f.GetInt64("exec_threads")),
 	}
 }
 
@@ -32,6 +32,9 @@ import px
 
 #px:set analyze=true
 #px:set max_output_rows_per_table=9999
+#px:set num_kelvins=3
+#px:set exec_threads=4
+#px:set columnar_transfer=true
 
 df = px.DataFrame(table='process_stats', start_time='-5s')
 `
@@ -84,6 +87,8 @@ func TestParseQueryFlags_NoFlag(t *testing.T) {
 
 	rows := qf.GetInt64("max_output_rows_per_table")
 	assert.Equal(t, int64(10000), rows)
+
+	assert.Equal(t, int32(1), qf.GetPlanOptions().ExecThreads)
 }
 
 func TestParseQueryFlags_InvalidFlag(t *testing.T) {
@@ -109,4 +114,8 @@ func TestParseQueryFlags_PlanOptions(t *testing.T) {
 	options := qf.GetPlanOptions()
 	assert.Equal(t, options.Explain, false)
 	assert.Equal(t, options.Analyze, true)
+	assert.Equal(t, options.NumKelvins, int32(3))
+	assert.Equal(t, options.ExecThreads, int32(4))
+	assert.Equal(t, options.ColumnarTransfer, true)
+	assert.Equal(t, options.CompressTransfer, false)
 }
@@ -120,11 +120,13 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 
 			if agent.Info.Capabilities == nil || agent.Info.Capabilities.CollectsData {
 				var metadataInfo *distributedpb.MetadataInfo
+				var tableStats []*distributedpb.TableStatsInfo
 				if carnotInfo, present := carnotInfoMap[agentUUID]; present {
 					metadataInfo = carnotInfo.MetadataInfo
+					tableStats = carnotInfo.TableStats
 				}
 				// this is a PEM
-				carnotInfoMap[agentUUID] = makeAgentCarnotInfo(agentUUID, agent.ASID, metadataInfo)
+				carnotInfoMap[agentUUID] = makeAgentCarnotInfo(agentUUID, agent.ASID, metadataInfo, tableStats)
 			} else {
 				// this is a Kelvin
 				kelvinGRPCAddress := agent.Info.IPAddress
@@ -143,9 +145,14 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 			if carnotInfo == nil {
 				return fmt.Errorf("Carnot info is nil for agent %s, but received agent data info", agentUUID.String())
 			}
+			// Agents send their metadata info and table stats independently, so a data info update only
+			// replaces the fields it holds.
 			if dataInfo.MetadataInfo != nil {
 				carnotInfo.MetadataInfo = dataInfo.MetadataInfo
 			}
+			if len(dataInfo.TableStats) > 0 {
+				carnotInfo.TableStats = dataInfo.TableStats
+			}
 		}
 		// case 3: agent deleted
 		if agentUpdate.GetDeleted() {
@@ -184,7 +191,8 @@ func (a *AgentsInfoImpl) DistributedState() distributedpb.DistributedState {
 	return a.ds
 }
 
-func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distributedpb.MetadataInfo) *distributedpb.CarnotInfo {
+func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distributedpb.MetadataInfo,
+	tableStats []*distributedpb.TableStatsInfo) *distributedpb.CarnotInfo {
 	return &distributedpb.CarnotInfo{
 		QueryBrokerAddress:   agentID.String(),
 		AgentID:              utils.ProtoFromUUID(agentID),
@@ -194,6 +202,7 @@ func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distribu
 		ProcessesData:        true,
 		AcceptsRemoteSources: false,
 		MetadataInfo:         agentMetadata,
+		TableStats:           tableStats,
 	}
 }
 
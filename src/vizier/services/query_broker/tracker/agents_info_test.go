@@ -350,3 +350,50 @@ func TestAgentsInfo_UpdateAgentsInfo(t *testing.T) {
 	require.NoError(t, err)
 	assert.Equal(t, 0, len(agentsInfo.DistributedState().SchemaInfo))
 }
+
+func TestAgentsInfo_UpdateAgentsInfoTableStats(t *testing.T) {
+	uuidpbs := makeTestAgentIDs(t)
+	agents := makeTestAgents(t)
+	agentDataInfos := makeTestAgentDataInfo()
+	tableStats := []*distributedpb.TableStatsInfo{
+		{
+			Table:     "table1",
+			NumRows:   1000,
+			NumBytes:  64000,
+			ColumnNDV: map[string]int64{"service": 12},
+		},
+	}
+
+	agentsInfo := tracker.NewAgentsInfo()
+	// The metadata info and the table stats arrive in separate data info updates, and both should
+	// survive a later update of the agent itself.
+	err := agentsInfo.UpdateAgentsInfo(&metadatapb.AgentUpdatesResponse{
+		AgentUpdates: []*metadatapb.AgentUpdate{
+			{
+				AgentID: uuidpbs[0],
+				Update:  &metadatapb.AgentUpdate_Agent{Agent: agents[0]},
+			},
+			{
+				AgentID: uuidpbs[0],
+				Update:  &metadatapb.AgentUpdate_DataInfo{DataInfo: agentDataInfos[0]},
+			},
+			{
+				AgentID: uuidpbs[0],
+				Update: &metadatapb.AgentUpdate_DataInfo{
+					DataInfo: &messagespb.AgentDataInfo{TableStats: tableStats},
+				},
+			},
+			{
+				AgentID: uuidpbs[0],
+				Update:  &metadatapb.AgentUpdate_Agent{Agent: agents[0]},
+			},
+		},
+		EndOfVersion: true,
+	})
+	require.NoError(t, err)
+
+	carnotInfos := agentsInfo.DistributedState().CarnotInfo
+	require.Equal(t, 1, len(carnotInfos))
+	assert.Equal(t, agentDataInfos[0].MetadataInfo, carnotInfos[0].MetadataInfo)
+	assert.Equal(t, tableStats, carnotInfos[0].TableStats)
+}